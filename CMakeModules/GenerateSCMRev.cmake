@@ -82,6 +82,8 @@ set(HASH_FILES
     "${VIDEO_CORE}/regs_texturing.h"
     "${VIDEO_CORE}/regs.cpp"
     "${VIDEO_CORE}/regs.h"
+    "${SRC_DIR}/src/common/hash.cpp"
+    "${SRC_DIR}/src/common/hash.h"
 )
 set(COMBINED "")
 foreach (F IN LISTS HASH_FILES)
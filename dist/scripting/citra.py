@@ -5,11 +5,15 @@ import socket
 
 CURRENT_REQUEST_VERSION = 1
 MAX_REQUEST_DATA_SIZE = 32
-MAX_PACKET_SIZE = 48
+MAX_PACKET_SIZE = 1040
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    ReadMemoryRanges = 5,
+    FrameAdvance = 8,
+    SaveTrace = 9,
+    ReadMemoryUsage = 10
 
 CITRA_PORT = 45987
 
@@ -59,6 +63,29 @@ class Citra:
 
         return result
 
+    def read_memory_ranges(self, ranges):
+        """
+        Reads several (address, size) ranges with a single request
+        >>> c.read_memory_ranges([(0x100000, 4), (0x100000, 2)])
+        [b'\\x07\\x00\\x00\\xeb', b'\\x07\\x00']
+        """
+        request_data = b"".join(struct.pack("II", address, size) for address, size in ranges)
+        request, request_id = self._generate_header(RequestType.ReadMemoryRanges, len(request_data))
+        request += request_data
+        self.socket.sendto(request, (self.address, CITRA_PORT))
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id,
+                                                    RequestType.ReadMemoryRanges)
+        if not reply_data:
+            return None
+
+        result = []
+        for _, size in ranges:
+            result.append(reply_data[:size])
+            reply_data = reply_data[size:]
+        return result
+
     def write_memory(self, write_address, write_contents):
         """
         >>> c.write_memory(0x100000, b"\\xff\\xff\\xff\\xff")
@@ -90,6 +117,66 @@ class Citra:
                 return False
         return True
 
+    def frame_advance(self, frames=1):
+        """
+        Runs the emulation for the given number of frames and pauses it at the end of the last one,
+        returning the number of that frame. Zero frames resumes the emulation.
+        """
+        request_data = struct.pack("I", frames)
+        request, request_id = self._generate_header(RequestType.FrameAdvance, len(request_data))
+        request += request_data
+        self.socket.sendto(request, (self.address, CITRA_PORT))
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.FrameAdvance)
+        if reply_data is None:
+            return None
+        return struct.unpack("I", reply_data)[0] if reply_data else 0
+
+    def save_trace(self):
+        """
+        Writes the recent events of the trace recorder to a Chrome trace in the log directory of
+        Citra, returning the path of the file. None is returned if it couldn't be written.
+        """
+        request, request_id = self._generate_header(RequestType.SaveTrace, 0)
+        self.socket.sendto(request, (self.address, CITRA_PORT))
+
+        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.SaveTrace)
+        if not reply_data:
+            return None
+        return reply_data.decode("utf-8")
+
+    def read_memory_usage(self):
+        """
+        Returns the memory held by the subsystems of Citra, as a dictionary from the name of each
+        counter to its (bytes, peak bytes, count, peak count). None is returned on failure.
+        """
+        entry_format = "40sQQII"
+        entry_size = struct.calcsize(entry_format)
+        max_entries = (MAX_PACKET_SIZE - 4*4) // entry_size
+        result = {}
+        first_index = 0
+        while True:
+            request_data = struct.pack("I", first_index)
+            request, request_id = self._generate_header(RequestType.ReadMemoryUsage,
+                                                        len(request_data))
+            request += request_data
+            self.socket.sendto(request, (self.address, CITRA_PORT))
+
+            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+            reply_data = self._read_and_validate_header(raw_reply, request_id,
+                                                        RequestType.ReadMemoryUsage)
+            if reply_data is None:
+                return None
+            num_entries = len(reply_data) // entry_size
+            for i in range(num_entries):
+                name, *usage = struct.unpack_from(entry_format, reply_data, i * entry_size)
+                result[name.rstrip(b"\0").decode("utf-8")] = tuple(usage)
+            first_index += num_entries
+            if num_entries < max_entries:
+                return result
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
@@ -208,6 +208,11 @@ public final class NativeLibrary {
      **/
     public static native double[] GetPerfStats();
 
+    /**
+     * Returns the load of every CPU core since the previous call, from 0 to 1
+     **/
+    public static native float[] GetCoreLoads();
+
     /**
      * Notifies the core emulation that the orientation has changed.
      */
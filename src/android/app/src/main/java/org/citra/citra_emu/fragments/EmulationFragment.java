@@ -197,8 +197,14 @@ public final class EmulationFragment extends Fragment implements SurfaceHolder.C
             {
                 final double[] perfStats = NativeLibrary.GetPerfStats();
                 if (perfStats[FPS] > 0) {
-                    mPerfStats.setText(String.format("FPS: %d Speed: %d%%", (int) (perfStats[FPS] + 0.5),
-                            (int) (perfStats[SPEED] * 100.0 + 0.5)));
+                    // The busiest core shows whether the emulation thread is the bottleneck
+                    float maxCoreLoad = 0;
+                    for (float load : NativeLibrary.GetCoreLoads()) {
+                        maxCoreLoad = Math.max(maxCoreLoad, load);
+                    }
+                    mPerfStats.setText(String.format("FPS: %d Speed: %d%% CPU: %d%%",
+                            (int) (perfStats[FPS] + 0.5), (int) (perfStats[SPEED] * 100.0 + 0.5),
+                            (int) (maxCoreLoad * 100.0 + 0.5)));
                 }
 
                 perfStatsUpdateHandler.postDelayed(perfStatsUpdater, 3000);
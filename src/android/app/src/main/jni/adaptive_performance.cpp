@@ -0,0 +1,335 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/hw/gpu.h"
+#include "jni/adaptive_performance.h"
+
+namespace AdaptivePerformance {
+
+namespace {
+
+// The APIs are newer than the minimum API level, so they are loaded at runtime
+struct AThermalManager;
+struct APerformanceHintManager;
+struct APerformanceHintSession;
+
+using AcquireThermalManagerFunc = AThermalManager* (*)();
+using ReleaseThermalManagerFunc = void (*)(AThermalManager*);
+using GetThermalStatusFunc = int (*)(AThermalManager*);
+using GetThermalHeadroomFunc = float (*)(AThermalManager*, int);
+using GetHintManagerFunc = APerformanceHintManager* (*)();
+using CreateHintSessionFunc = APerformanceHintSession* (*)(APerformanceHintManager*,
+                                                           const int32_t*, size_t, int64_t);
+using UpdateTargetDurationFunc = int (*)(APerformanceHintSession*, int64_t);
+using ReportActualDurationFunc = int (*)(APerformanceHintSession*, int64_t);
+using CloseHintSessionFunc = void (*)(APerformanceHintSession*);
+
+/// The values of AThermalStatus
+constexpr int ThermalStatusLight = 1;
+constexpr int ThermalStatusModerate = 2;
+
+/// Frames between evaluations of the thermal state, about two seconds
+constexpr u32 EvaluationFrames = 120;
+/// Evaluations the device has to stay cool for before a step is undone
+constexpr u32 RecoveryEvaluations = 5;
+/// Seconds the thermal headroom is forecast for
+constexpr int HeadroomForecast = 10;
+/// Headroom from which the device is expected to throttle soon, at 1 it throttles
+constexpr float HotHeadroom = 0.9f;
+/// Headroom below which the device is cool enough to undo a step
+constexpr float CoolHeadroom = 0.7f;
+
+struct Adaptation {
+    void* library = nullptr;
+    ReleaseThermalManagerFunc release_thermal_manager = nullptr;
+    GetThermalStatusFunc get_thermal_status = nullptr;
+    GetThermalHeadroomFunc get_thermal_headroom = nullptr;
+    UpdateTargetDurationFunc update_target_duration = nullptr;
+    ReportActualDurationFunc report_actual_duration = nullptr;
+    CloseHintSessionFunc close_hint_session = nullptr;
+
+    AThermalManager* thermal_manager = nullptr;
+    APerformanceHintSession* hint_session = nullptr;
+    s64 target_duration = 0;
+
+    /// The settings the title was started with
+    u16 resolution_factor = 1;
+    bool resolution_factor_global = true;
+    u32 vertex_shader_threads = 0;
+
+    /// The number of steps taken, and the maximum
+    u32 level = 0;
+    u32 max_level = 0;
+    bool level_changed = false;
+
+    u32 frames = 0;
+    u32 cool_evaluations = 0;
+};
+
+/// Only used on the emulation thread
+std::unique_ptr<Adaptation> adaptation;
+
+std::mutex core_loads_mutex;
+std::vector<u64> previous_busy_time;
+std::vector<u64> previous_total_time;
+
+template <typename Func>
+Func LoadFunction(void* library, const char* name) {
+    return reinterpret_cast<Func>(dlsym(library, name));
+}
+
+/// The frame time needed to run at the frame limit
+s64 GetTargetDuration() {
+    const u16 frame_limit = Settings::values.frame_limit.GetValue();
+    const double speed = frame_limit == 0 ? 1.0 : frame_limit / 100.0;
+    return static_cast<s64>(1e9 / (GPU::SCREEN_REFRESH_RATE * speed));
+}
+
+u32 GetResolutionSteps() {
+    // The automatic resolution follows the window and can't be lowered in steps
+    return adaptation->resolution_factor > 1 ? adaptation->resolution_factor - 1u : 0u;
+}
+
+u32 GetWorkerThreads() {
+    const u32 threads = adaptation->vertex_shader_threads;
+    return threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1U);
+}
+
+void OnFrame(const Core::PerfStats::FrameSample& sample) {
+    if (!adaptation) {
+        return;
+    }
+    Adaptation& state = *adaptation;
+
+    if (state.hint_session) {
+        state.report_actual_duration(
+            state.hint_session,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(sample.frametime).count());
+    }
+    if (++state.frames < EvaluationFrames) {
+        return;
+    }
+    state.frames = 0;
+
+    if (state.hint_session) {
+        const s64 target_duration = GetTargetDuration();
+        if (target_duration != state.target_duration) {
+            state.update_target_duration(state.hint_session, target_duration);
+            state.target_duration = target_duration;
+        }
+    }
+    if (!state.thermal_manager) {
+        return;
+    }
+
+    const int status = state.get_thermal_status(state.thermal_manager);
+    // NaN if the device doesn't support forecasts, which fails both comparisons
+    const float headroom = state.get_thermal_headroom
+                               ? state.get_thermal_headroom(state.thermal_manager, HeadroomForecast)
+                               : NAN;
+    if (status >= ThermalStatusModerate || headroom >= HotHeadroom) {
+        state.cool_evaluations = 0;
+        if (state.level < state.max_level) {
+            state.level++;
+            state.level_changed = true;
+            LOG_INFO(Frontend, "Thermal status {}, headroom {:.2f}: stepping down to level {}",
+                     status, headroom, state.level);
+        }
+    } else if (status <= ThermalStatusLight && !(headroom >= CoolHeadroom)) {
+        if (state.level > 0 && ++state.cool_evaluations >= RecoveryEvaluations) {
+            state.cool_evaluations = 0;
+            state.level--;
+            state.level_changed = true;
+            LOG_INFO(Frontend, "Thermal status {}, headroom {:.2f}: stepping up to level {}",
+                     status, headroom, state.level);
+        }
+    } else {
+        state.cool_evaluations = 0;
+    }
+}
+
+/// Sets the settings of the level, taking the resolution steps before the thread steps
+void SetLevelSettings(u32 level) {
+    const u32 resolution_steps = GetResolutionSteps();
+    const u32 resolution_level = std::min(level, resolution_steps);
+    const u32 thread_level = level - resolution_level;
+
+    auto& resolution_factor = Settings::values.resolution_factor;
+    resolution_factor.SetGlobal(false);
+    resolution_factor.SetValue(static_cast<u16>(adaptation->resolution_factor - resolution_level));
+    if (level == 0) {
+        resolution_factor.SetGlobal(adaptation->resolution_factor_global);
+    }
+    Settings::values.vertex_shader_threads =
+        thread_level == 0 ? adaptation->vertex_shader_threads
+                          : std::max(GetWorkerThreads() >> thread_level, 1U);
+}
+
+} // Anonymous namespace
+
+void Start() {
+    adaptation.reset();
+    if (!Settings::values.adaptive_performance) {
+        return;
+    }
+
+    adaptation = std::make_unique<Adaptation>();
+    Adaptation& state = *adaptation;
+    state.resolution_factor = Settings::values.resolution_factor.GetValue();
+    state.resolution_factor_global = Settings::values.resolution_factor.UsingGlobal();
+    state.vertex_shader_threads = Settings::values.vertex_shader_threads.GetValue();
+    state.max_level = GetResolutionSteps() + std::bit_width(GetWorkerThreads()) - 1;
+
+    state.library = dlopen("libandroid.so", RTLD_NOW);
+    if (!state.library) {
+        LOG_WARNING(Frontend, "Adaptive performance is unavailable, libandroid can't be loaded");
+        return;
+    }
+
+    // Android 11
+    const auto acquire_thermal_manager =
+        LoadFunction<AcquireThermalManagerFunc>(state.library, "AThermal_acquireManager");
+    state.release_thermal_manager =
+        LoadFunction<ReleaseThermalManagerFunc>(state.library, "AThermal_releaseManager");
+    state.get_thermal_status =
+        LoadFunction<GetThermalStatusFunc>(state.library, "AThermal_getCurrentThermalStatus");
+    if (acquire_thermal_manager && state.release_thermal_manager && state.get_thermal_status) {
+        state.thermal_manager = acquire_thermal_manager();
+    }
+    // Android 12
+    state.get_thermal_headroom =
+        LoadFunction<GetThermalHeadroomFunc>(state.library, "AThermal_getThermalHeadroom");
+
+    // Android 13
+    const auto get_hint_manager =
+        LoadFunction<GetHintManagerFunc>(state.library, "APerformanceHint_getManager");
+    const auto create_hint_session =
+        LoadFunction<CreateHintSessionFunc>(state.library, "APerformanceHint_createSession");
+    state.update_target_duration = LoadFunction<UpdateTargetDurationFunc>(
+        state.library, "APerformanceHint_updateTargetWorkDuration");
+    state.report_actual_duration = LoadFunction<ReportActualDurationFunc>(
+        state.library, "APerformanceHint_reportActualWorkDuration");
+    state.close_hint_session =
+        LoadFunction<CloseHintSessionFunc>(state.library, "APerformanceHint_closeSession");
+    if (get_hint_manager && create_hint_session && state.update_target_duration &&
+        state.report_actual_duration && state.close_hint_session) {
+        if (APerformanceHintManager* hint_manager = get_hint_manager()) {
+            // The emulation thread also renders, so it covers the work of a frame
+            const int32_t thread_id = gettid();
+            state.target_duration = GetTargetDuration();
+            state.hint_session =
+                create_hint_session(hint_manager, &thread_id, 1, state.target_duration);
+        }
+    }
+
+    LOG_INFO(Frontend, "Adaptive performance: thermal status {}, performance hints {}",
+             state.thermal_manager ? "available" : "unavailable",
+             state.hint_session ? "available" : "unavailable");
+    Core::System::GetInstance().RegisterFrameObserver(OnFrame);
+}
+
+void Update() {
+    if (!adaptation || !adaptation->level_changed) {
+        return;
+    }
+    adaptation->level_changed = false;
+    SetLevelSettings(adaptation->level);
+    Settings::Apply();
+    LOG_INFO(Frontend, "Adapted to resolution {}x and {} vertex shader threads",
+             Settings::values.resolution_factor.GetValue(),
+             Settings::values.vertex_shader_threads.GetValue());
+}
+
+void Stop() {
+    if (!adaptation) {
+        return;
+    }
+    Core::System::GetInstance().RegisterFrameObserver(nullptr);
+    if (adaptation->level != 0) {
+        SetLevelSettings(0);
+    }
+    if (adaptation->hint_session) {
+        adaptation->close_hint_session(adaptation->hint_session);
+    }
+    if (adaptation->thermal_manager) {
+        adaptation->release_thermal_manager(adaptation->thermal_manager);
+    }
+    if (adaptation->library) {
+        dlclose(adaptation->library);
+    }
+    adaptation.reset();
+}
+
+std::vector<float> GetCoreLoads() {
+    const u32 num_cores = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<float> loads(num_cores, 0.0f);
+
+    std::string stat;
+    FileUtil::ReadFileToString(true, "/proc/stat", stat);
+    if (stat.empty()) {
+        // Apps can't read /proc/stat since Android 8, the clock relative to the maximum clock of
+        // each core is close enough while the governor follows the load
+        for (u32 core = 0; core < num_cores; core++) {
+            const std::string cpufreq =
+                fmt::format("/sys/devices/system/cpu/cpu{}/cpufreq/", core);
+            std::string current, maximum;
+            FileUtil::ReadFileToString(true, cpufreq + "scaling_cur_freq", current);
+            FileUtil::ReadFileToString(true, cpufreq + "cpuinfo_max_freq", maximum);
+            const double max_frequency = std::strtod(maximum.c_str(), nullptr);
+            if (max_frequency > 0.0) {
+                loads[core] = static_cast<float>(
+                    std::clamp(std::strtod(current.c_str(), nullptr) / max_frequency, 0.0, 1.0));
+            }
+        }
+        return loads;
+    }
+
+    std::scoped_lock lock{core_loads_mutex};
+    previous_busy_time.resize(num_cores);
+    previous_total_time.resize(num_cores);
+    std::istringstream lines{stat};
+    std::string line;
+    while (std::getline(lines, line)) {
+        u32 core{};
+        u64 user{}, nice{}, system{}, idle{}, iowait{}, irq{}, softirq{}, steal{};
+        if (std::sscanf(line.c_str(),
+                        "cpu%u %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64
+                        " %" SCNu64 " %" SCNu64 " %" SCNu64,
+                        &core, &user, &nice, &system, &idle, &iowait, &irq, &softirq,
+                        &steal) != 9 ||
+            core >= num_cores) {
+            continue;
+        }
+        const u64 busy = user + nice + system + irq + softirq + steal;
+        const u64 total = busy + idle + iowait;
+        const u64 total_delta = total - previous_total_time[core];
+        if (total_delta != 0) {
+            loads[core] = static_cast<float>(busy - previous_busy_time[core]) /
+                          static_cast<float>(total_delta);
+        }
+        previous_busy_time[core] = busy;
+        previous_total_time[core] = total;
+    }
+    return loads;
+}
+
+} // namespace AdaptivePerformance
@@ -0,0 +1,30 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <vector>
+
+/**
+ * Adapts the emulation to the thermal state of the device, through the thermal and performance
+ * hint APIs of Android 11 and 12. While the device heats up, the resolution is lowered step by step
+ * to native, then the vertex shader threads are halved. The steps are undone once it cooled down.
+ * The frame times are reported to a performance hint session, so that the system clocks the CPU
+ * for the frame rate instead of reacting to load spikes.
+ */
+namespace AdaptivePerformance {
+
+/// Starts adapting the title about to be loaded, on the emulation thread, if it's enabled
+void Start();
+
+/// Applies the adaptation decided since the last call, between runs of the emulation loop
+void Update();
+
+/// Restores the settings the title was started with
+void Stop();
+
+/// Returns the load of every CPU core since the previous call, from 0 to 1
+std::vector<float> GetCoreLoads();
+
+} // namespace AdaptivePerformance
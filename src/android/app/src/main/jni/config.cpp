@@ -106,6 +106,10 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
+    Settings::values.use_fastmem = sdl2_config->GetBoolean("Core", "use_fastmem", true);
+    Settings::values.use_huge_pages = sdl2_config->GetBoolean("Core", "use_huge_pages", false);
+    Settings::values.use_multi_core = sdl2_config->GetBoolean("Core", "use_multi_core", false);
+    Settings::values.skip_idle_loops = sdl2_config->GetBoolean("Core", "skip_idle_loops", true);
     Settings::values.cpu_clock_percentage =
         static_cast<int>(sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100));
 
@@ -120,10 +124,20 @@ void Config::ReadValues() {
     Settings::values.shaders_accurate_mul =
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_mul", false);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
+    Settings::values.vertex_shader_threads =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "vertex_shader_threads", 0));
+    Settings::values.async_shader_compilation =
+        sdl2_config->GetBoolean("Renderer", "async_shader_compilation", false);
+    Settings::values.use_gpu_texture_decode =
+        sdl2_config->GetBoolean("Renderer", "use_gpu_texture_decode", false);
+    Settings::values.present_mode = static_cast<Settings::PresentMode>(
+        sdl2_config->GetInteger("Renderer", "present_mode", 0));
     Settings::values.resolution_factor =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "resolution_factor", 1));
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
+    Settings::values.adaptive_performance =
+        sdl2_config->GetBoolean("Renderer", "adaptive_performance", false);
     Settings::values.use_vsync_new = sdl2_config->GetBoolean("Renderer", "use_vsync_new", true);
 
     // Work around to map Android setting for enabling the frame limiter to the format Citra expects
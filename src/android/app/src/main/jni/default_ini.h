@@ -91,6 +91,24 @@ udp_pad_index=
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether the JIT accesses guest memory directly through a host mapping of the address space
+# Only takes effect on hosts with 4 KiB pages. 0: Off, 1 (default): On
+use_fastmem =
+
+# Whether to back the guest memory with transparent huge pages, which reduces TLB misses.
+# Needs a kernel with transparent huge pages enabled for shared memory. 0 (default): Off, 1: On
+use_huge_pages =
+
+# Whether to run each emulated CPU core on its own host thread. Requires the JIT.
+# Faster on multi-core hosts, but emulation is no longer deterministic (e.g. for movies).
+# 0 (default): Off, 1: On
+use_multi_core =
+
+# Whether to fast-forward to the next event when a thread spins polling the kernel
+# (e.g. svcWaitSynchronization with a zero timeout or svcSleepThread(0)). Reduces host CPU usage.
+# 0: Off, 1 (default): On
+skip_idle_loops =
+
 # Change the Clock Frequency of the emulated 3DS CPU.
 # Underclocking can increase the performance of the game at the risk of freezing.
 # Overclocking may fix lag that happens on console, but also comes with the risk of freezing.
@@ -126,6 +144,26 @@ use_asynchronous_gpu_emulation =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Number of threads used to run vertex shaders on the CPU, when hardware shaders are not in use
+# 0 (default): Auto (one per CPU core), 1: Single threaded, 2 or more: Number of threads
+vertex_shader_threads =
+
+# Whether to build fragment shaders in the background, rendering with a generic shader meanwhile
+# Has no effect on OpenGL ES, which always builds them synchronously
+# 0 (default): Off, 1: On
+async_shader_compilation =
+
+# Whether to decode ETC1 textures on the GPU instead of the CPU
+# Ignored while textures are being dumped or replaced
+# 0 (default): Off, 1: On
+use_gpu_texture_decode =
+
+# How rendered frames are handed over to the display
+# 0 (default): Mailbox, presents the latest frame and drops older ones
+# 1: FIFO, presents every frame in order, emulation waits when the display falls behind
+# 2: Immediate, like Mailbox but without waiting for VSync
+present_mode =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
@@ -140,6 +178,11 @@ use_disk_shader_cache =
 # factor for the 3DS resolution
 resolution_factor =
 
+# Whether to lower the resolution and the vertex shader threads while the device heats up, and to
+# tell the system the frame time needed for full speed. Needs Android 11 or later.
+# 0 (default): Off, 1: On
+adaptive_performance =
+
 # Whether to enable V-Sync (caps the framerate at 60FPS) or not.
 # 0 (default): Off, 1: On
 vsync_enabled =
@@ -169,6 +212,7 @@ factor_3d =
 # The name of the post processing shader to apply.
 # Loaded from shaders if render_3d is off or side by side.
 # Loaded from shaders/anaglyph if render_3d is anaglyph
+# A <name>.preset file in shaders chains several shaders, and can run passes at a reduced scale
 pp_shader_name =
 
 # Whether to enable linear filtering or not
@@ -223,13 +267,10 @@ custom_textures =
 preload_textures =
 
 [Audio]
-# Whether or not to enable DSP LLE
-# 0 (default): No, 1: Yes
-enable_dsp_lle =
-
-# Whether or not to run DSP LLE on a different thread
-# 0 (default): No, 1: Yes
-enable_dsp_lle_thread =
+# Which audio emulation to use
+# 0 (default): HLE, 1: LLE, 2: LLE on a separate thread,
+# 3: HLE mixing on a separate thread, one frame behind the emulated DSP
+audio_emulation =
 
 # Which audio output engine to use.
 # auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available)
@@ -66,6 +66,13 @@ void SharedContext_Android::DoneCurrent() {
     eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
 }
 
+static EGLint GetSwapInterval() {
+    if (Settings::values.present_mode.GetValue() == Settings::PresentMode::Immediate) {
+        return 0;
+    }
+    return Settings::values.use_vsync_new ? 1 : 0;
+}
+
 static bool IsPortraitMode() {
     return JNI_FALSE != IDCache::GetEnvForThread()->CallStaticBooleanMethod(
                             IDCache::GetNativeLibraryClass(), IDCache::GetIsPortraitMode());
@@ -164,7 +171,7 @@ EmuWindow_Android::EmuWindow_Android(ANativeWindow* surface) {
         LOG_CRITICAL(Frontend, "gladLoadGLES2Loader() failed");
         return;
     }
-    if (!eglSwapInterval(egl_display, Settings::values.use_vsync_new ? 1 : 0)) {
+    if (!eglSwapInterval(egl_display, GetSwapInterval())) {
         LOG_CRITICAL(Frontend, "eglSwapInterval() failed");
         return;
     }
@@ -245,7 +252,7 @@ void EmuWindow_Android::TryPresenting() {
             return;
         }
     }
-    eglSwapInterval(egl_display, Settings::values.use_vsync_new ? 1 : 0);
+    eglSwapInterval(egl_display, GetSwapInterval());
     if (VideoCore::g_renderer) {
         VideoCore::g_renderer->TryPresent(0);
         eglSwapBuffers(egl_display, egl_surface);
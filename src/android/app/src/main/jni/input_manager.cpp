@@ -34,6 +34,10 @@ public:
         return status.load();
     }
 
+    const std::atomic<bool>* GetStatusFlag() const override {
+        return &status;
+    }
+
     friend class ButtonList;
 
 private:
@@ -19,6 +19,7 @@
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/frontend/applets/default_applets.h"
 #include "core/frontend/camera/factory.h"
@@ -27,6 +28,7 @@
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/nfc/nfc.h"
 #include "core/savestate.h"
+#include "jni/adaptive_performance.h"
 #include "jni/android_common/android_common.h"
 #include "jni/applets/mii_selector.h"
 #include "jni/applets/swkbd.h"
@@ -141,6 +143,7 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
     LOG_INFO(Frontend, "Citra starting...");
 
     MicroProfileOnThreadCreate("EmuThread");
+    Common::Trace::SetCurrentThreadName("EmuThread");
 
     if (filepath.empty()) {
         LOG_CRITICAL(Frontend, "Failed to load ROM: No ROM specified");
@@ -204,6 +207,9 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
 
     SCOPE_EXIT({ TryShutdown(); });
 
+    AdaptivePerformance::Start();
+    SCOPE_EXIT({ AdaptivePerformance::Stop(); });
+
     // Audio stretching on Android is only useful with lower framerates, disable it when fullspeed
     Core::TimingEventType* audio_stretching_event{};
     const s64 audio_stretching_ticks{msToCycles(500)};
@@ -224,6 +230,7 @@ static Core::System::ResultStatus RunCitra(const std::string& filepath) {
         if (!pause_emulation) {
             const auto result = system.RunLoop();
             if (result == Core::System::ResultStatus::Success) {
+                AdaptivePerformance::Update();
                 continue;
             }
             if (result == Core::System::ResultStatus::ShutdownRequested) {
@@ -577,6 +584,14 @@ jdoubleArray Java_org_citra_citra_1emu_NativeLibrary_GetPerfStats(JNIEnv* env,
     return j_stats;
 }
 
+jfloatArray Java_org_citra_citra_1emu_NativeLibrary_GetCoreLoads(JNIEnv* env,
+                                                                 [[maybe_unused]] jclass clazz) {
+    const std::vector<float> loads = AdaptivePerformance::GetCoreLoads();
+    jfloatArray j_loads = env->NewFloatArray(static_cast<jsize>(loads.size()));
+    env->SetFloatArrayRegion(j_loads, 0, static_cast<jsize>(loads.size()), loads.data());
+    return j_loads;
+}
+
 void Java_org_citra_citra_1emu_utils_DirectoryInitialization_SetSysDirectory(
     JNIEnv* env, [[maybe_unused]] jclass clazz, jstring j_path) {
     std::string_view path = env->GetStringUTFChars(j_path, 0);
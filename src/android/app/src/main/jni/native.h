@@ -131,6 +131,9 @@ JNIEXPORT jstring JNICALL Java_org_citra_citra_1emu_NativeLibrary_GetUserSetting
 JNIEXPORT jdoubleArray JNICALL Java_org_citra_citra_1emu_NativeLibrary_GetPerfStats(JNIEnv* env,
                                                                                     jclass clazz);
 
+JNIEXPORT jfloatArray JNICALL Java_org_citra_citra_1emu_NativeLibrary_GetCoreLoads(JNIEnv* env,
+                                                                                  jclass clazz);
+
 JNIEXPORT jobjectArray JNICALL
 Java_org_citra_citra_1emu_NativeLibrary_GetTextureFilterNames(JNIEnv* env, jclass clazz);
 
@@ -89,14 +89,16 @@ StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
 
     StereoBuffer16 ret(sample_count);
 
+    // Deque iterators are walked rather than indexed, which would recompute the block every sample
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i].fill(decode_sample(data[i]));
-        }
+        std::transform(data, data + sample_count, ret.begin(), [&](u8 sample) {
+            const s16 decoded = decode_sample(sample);
+            return std::array<s16, 2>{decoded, decoded};
+        });
     } else {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i][0] = decode_sample(data[i * 2 + 0]);
-            ret[i][1] = decode_sample(data[i * 2 + 1]);
+        auto it = ret.begin();
+        for (std::size_t i = 0; i < sample_count; i++, ++it) {
+            *it = {decode_sample(data[i * 2 + 0]), decode_sample(data[i * 2 + 1])};
         }
     }
 
@@ -109,15 +111,16 @@ StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
 
     StereoBuffer16 ret(sample_count);
 
+    auto it = ret.begin();
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
+        for (std::size_t i = 0; i < sample_count; i++, ++it) {
             s16 sample;
             std::memcpy(&sample, data + i * sizeof(s16), sizeof(s16));
-            ret[i].fill(sample);
+            it->fill(sample);
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; ++i) {
-            std::memcpy(&ret[i], data + i * sizeof(s16) * 2, 2 * sizeof(s16));
+        for (std::size_t i = 0; i < sample_count; ++i, ++it) {
+            std::memcpy(it->data(), data + i * sizeof(s16) * 2, 2 * sizeof(s16));
         }
     }
 
@@ -2,22 +2,42 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <utility>
 #include <vector>
 #include <cubeb/cubeb.h>
 #include "audio_core/cubeb_input.h"
 #include "common/logging/log.h"
+#include "common/ring_buffer.h"
 
 namespace AudioCore {
 
-using SampleQueue = Common::SPSCQueue<Frontend::Mic::Samples>;
+/// About a second of 16-bit samples at the highest sample rate
+constexpr std::size_t ring_size = 0x10000;
 
 struct CubebInput::Impl {
     cubeb* ctx = nullptr;
     cubeb_stream* stream = nullptr;
 
-    std::unique_ptr<SampleQueue> sample_queue{};
+    /// Samples in the format requested by the application, filled by the capture thread
+    Common::RingBuffer<u8, ring_size> samples;
     u8 sample_size_in_bytes = 0;
+    bool sample_unsigned = false;
+
+    /// Rate the host stream was opened with
+    u32 stream_rate = 0;
+    /// Rate the application samples at, which can change while the stream is running
+    std::atomic<u32> sample_rate = 0;
+
+    // Resampler state, only accessed by the capture thread. The position is in 32.32 fixed point,
+    // where 0 is the last sample of the previous callback.
+    u64 position = 0;
+    s16 previous_sample = 0;
+
+    /// Resamples and converts the captured samples, and pushes them into the ring
+    void Capture(const s16* input, std::size_t num_frames);
 
     static long DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
                              void* output_buffer, long num_frames);
@@ -30,7 +50,6 @@ CubebInput::CubebInput(std::string device_id)
         LOG_ERROR(Audio, "cubeb_init failed! Mic will not work properly");
         return;
     }
-    impl->sample_queue = std::make_unique<SampleQueue>();
 }
 
 CubebInput::~CubebInput() {
@@ -49,14 +68,21 @@ CubebInput::~CubebInput() {
 }
 
 void CubebInput::StartSampling(const Frontend::Mic::Parameters& params) {
-    // Cubeb apparently only supports signed 16 bit PCM (and float32 which the 3ds doesn't support)
-    // TODO resample the input stream
-    if (params.sign == Frontend::Mic::Signedness::Unsigned) {
-        LOG_ERROR(Audio,
-                  "Application requested unsupported unsigned pcm format. Falling back to signed");
-    }
-
+    // Cubeb only captures signed 16 bit PCM (and float32 which the 3ds doesn't support), the
+    // capture thread converts it to the requested format
     impl->sample_size_in_bytes = params.sample_size / 8;
+    impl->sample_unsigned = params.sign == Frontend::Mic::Signedness::Unsigned;
+    impl->sample_rate = params.sample_rate;
+    impl->position = 0;
+    impl->previous_sample = 0;
+    impl->samples.Discard(impl->samples.Size());
+
+    // Capture at the native rate of the device if possible, to leave the resampling to the
+    // capture thread rather than to cubeb
+    if (cubeb_get_preferred_sample_rate(impl->ctx, &impl->stream_rate) != CUBEB_OK ||
+        impl->stream_rate == 0) {
+        impl->stream_rate = params.sample_rate;
+    }
 
     parameters = params;
     is_sampling = true;
@@ -84,7 +110,7 @@ void CubebInput::StartSampling(const Frontend::Mic::Parameters& params) {
     input_params.layout = CUBEB_LAYOUT_UNDEFINED;
     input_params.prefs = CUBEB_STREAM_PREF_NONE;
     input_params.format = CUBEB_SAMPLE_S16LE;
-    input_params.rate = params.sample_rate;
+    input_params.rate = impl->stream_rate;
 
     u32 latency_frames = 512; // Firefox default
     if (cubeb_get_min_latency(impl->ctx, &input_params, &latency_frames) != CUBEB_OK) {
@@ -118,17 +144,46 @@ void CubebInput::StopSampling() {
 }
 
 void CubebInput::AdjustSampleRate(u32 sample_rate) {
-    // TODO This should restart the stream with the new sample rate
-    LOG_ERROR(Audio, "AdjustSampleRate unimplemented!");
+    // The capture thread picks up the new rate on its next callback
+    impl->sample_rate = sample_rate;
+    parameters.sample_rate = sample_rate;
+}
+
+std::size_t CubebInput::Read(u8* buffer, std::size_t max_size) {
+    return impl->samples.Pop(buffer, max_size);
 }
 
-Frontend::Mic::Samples CubebInput::Read() {
-    Frontend::Mic::Samples samples{};
-    Frontend::Mic::Samples queue;
-    while (impl->sample_queue->Pop(queue)) {
-        samples.insert(samples.end(), queue.begin(), queue.end());
+void CubebInput::Impl::Capture(const s16* input, std::size_t num_frames) {
+    const u64 step = (static_cast<u64>(stream_rate) << 32) / sample_rate.load();
+    const u16 sign_flip = sample_unsigned ? 0x8000 : 0;
+
+    std::array<u8, 1024> output;
+    std::size_t output_size = 0;
+    for (; (position >> 32) < num_frames; position += step) {
+        const std::size_t index = static_cast<std::size_t>(position >> 32);
+        const s64 fraction = static_cast<s64>(position & 0xFFFFFFFF);
+        const s64 x0 = index == 0 ? previous_sample : input[index - 1];
+        const s64 x1 = input[index];
+        const auto sample = static_cast<s16>(x0 + (((x1 - x0) * fraction) >> 32));
+
+        const u16 value = static_cast<u16>(sample) ^ sign_flip;
+        if (sample_size_in_bytes == 1) {
+            output[output_size++] = static_cast<u8>(value >> 8);
+        } else {
+            output[output_size++] = static_cast<u8>(value);
+            output[output_size++] = static_cast<u8>(value >> 8);
+        }
+        if (output_size == output.size()) {
+            samples.Push(output.data(), output_size);
+            output_size = 0;
+        }
     }
-    return samples;
+    // Samples that don't fit are dropped. Both sides only ever move whole samples, so the ring
+    // never ends up holding part of one.
+    samples.Push(output.data(), output_size);
+
+    position -= static_cast<u64>(num_frames) << 32;
+    previous_sample = input[num_frames - 1];
 }
 
 long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const void* input_buffer,
@@ -138,25 +193,10 @@ long CubebInput::Impl::DataCallback(cubeb_stream* stream, void* user_data, const
         return 0;
     }
 
-    constexpr auto resample_s16_s8 = [](s16 sample) {
-        return static_cast<u8>(static_cast<u16>(sample) >> 8);
-    };
-
-    std::vector<u8> samples{};
-    samples.reserve(num_frames * impl->sample_size_in_bytes);
-    if (impl->sample_size_in_bytes == 1) {
-        // If the sample format is 8bit, then resample back to 8bit before passing back to core
-        for (std::size_t i = 0; i < static_cast<std::size_t>(num_frames); i++) {
-            s16 data;
-            std::memcpy(&data, static_cast<const u8*>(input_buffer) + i * 2, 2);
-            samples.push_back(resample_s16_s8(data));
-        }
-    } else {
-        // Otherwise copy all of the samples to the buffer (which will be treated as s16 by core)
-        const u8* data = reinterpret_cast<const u8*>(input_buffer);
-        samples.insert(samples.begin(), data, data + num_frames * impl->sample_size_in_bytes);
+    if (num_frames > 0) {
+        impl->Capture(static_cast<const s16*>(input_buffer),
+                      static_cast<std::size_t>(num_frames));
     }
-    impl->sample_queue->Push(samples);
 
     // returning less than num_frames here signals cubeb to stop sampling
     return num_frames;
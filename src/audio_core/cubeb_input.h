@@ -21,7 +21,7 @@ public:
 
     void AdjustSampleRate(u32 sample_rate) override;
 
-    Frontend::Mic::Samples Read() override;
+    std::size_t Read(u8* buffer, std::size_t max_size) override;
 
 private:
     struct Impl;
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/sink.h"
@@ -13,7 +14,24 @@
 
 namespace AudioCore {
 
-DspInterface::DspInterface() = default;
+// The target latency starts low and grows with every underrun, it decays again after a while
+// without any. Queued audio that stays well above the target for several callbacks is dropped, so
+// that a burst of frames doesn't raise the latency for good.
+constexpr std::size_t min_target_latency = samples_per_frame * 2;
+constexpr std::size_t initial_target_latency = samples_per_frame * 4;
+constexpr std::size_t max_target_latency = samples_per_frame * 32;
+constexpr std::size_t target_latency_step = samples_per_frame;
+constexpr u32 target_latency_decay_callbacks = 1000;
+constexpr u32 overrun_callbacks = 32;
+
+static u32 FramesToMilliseconds(std::size_t frames) {
+    return static_cast<u32>(frames * 1000 / native_sample_rate);
+}
+
+DspInterface::DspInterface() : target_latency{initial_target_latency} {
+    stretcher_input.resize(fifo.Capacity() * 2);
+}
+
 DspInterface::~DspInterface() = default;
 
 void DspInterface::SetSink(std::string_view sink_id, std::string_view audio_device) {
@@ -39,11 +57,22 @@ void DspInterface::EnableStretching(bool enable) {
     perform_time_stretching = enable;
 }
 
+AudioOutputStats DspInterface::GetOutputStats() const {
+    return {
+        .underruns = underruns.load(std::memory_order_relaxed),
+        .dropped_frames = dropped_frames.load(std::memory_order_relaxed),
+        .latency_ms = FramesToMilliseconds(queued_frames.load(std::memory_order_relaxed)),
+        .target_latency_ms = FramesToMilliseconds(target_latency.load(std::memory_order_relaxed)),
+    };
+}
+
 void DspInterface::OutputFrame(StereoFrame16 frame) {
     if (!sink)
         return;
 
-    fifo.Push(frame.data(), frame.size());
+    const std::size_t pushed = fifo.Push(frame.data(), frame.size());
+    dropped_frames.fetch_add(frame.size() - pushed, std::memory_order_relaxed);
+    UpdateEmulationSpeed();
 
     if (Core::System::GetInstance().VideoDumper().IsDumping()) {
         Core::System::GetInstance().VideoDumper().AddAudioFrame(std::move(frame));
@@ -54,19 +83,34 @@ void DspInterface::OutputSample(std::array<s16, 2> sample) {
     if (!sink)
         return;
 
-    fifo.Push(&sample, 1);
+    if (fifo.Push(&sample, 1) == 0) {
+        dropped_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (++samples_since_speed_update >= samples_per_frame) {
+        samples_since_speed_update = 0;
+        UpdateEmulationSpeed();
+    }
 
     if (Core::System::GetInstance().VideoDumper().IsDumping()) {
         Core::System::GetInstance().VideoDumper().AddAudioSample(std::move(sample));
     }
 }
 
+void DspInterface::UpdateEmulationSpeed() {
+    if (!perform_time_stretching) {
+        return;
+    }
+    const auto& perf_stats = Core::System::GetInstance().perf_stats;
+    const double time_scale = perf_stats ? perf_stats->GetLastFrameTimeScale() : 0.0;
+    time_stretcher.SetEmulationSpeed(time_scale > 0 ? 1.0 / time_scale : 0.0);
+}
+
 void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
     std::size_t frames_written;
     if (perform_time_stretching) {
-        const std::vector<s16> in{fifo.Pop()};
-        const std::size_t num_in{in.size() / 2};
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
+        const std::size_t num_in = fifo.Pop(stretcher_input.data(), fifo.Capacity());
+        frames_written =
+            time_stretcher.Process(stretcher_input.data(), num_in, buffer, num_frames);
     } else if (flushing_time_stretcher) {
         time_stretcher.Flush();
         frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
@@ -74,6 +118,7 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
         flushing_time_stretcher = false;
     } else {
         frames_written = fifo.Pop(buffer, num_frames);
+        UpdateOutputLatency(num_frames, frames_written);
     }
 
     if (frames_written > 0) {
@@ -97,4 +142,42 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
     }
 }
 
+void DspInterface::UpdateOutputLatency(std::size_t num_frames, std::size_t frames_written) {
+    // The sink consumes num_frames at once, so less than that can't be sustained
+    const std::size_t min_target = std::max(min_target_latency, num_frames);
+    const std::size_t max_target = std::max(max_target_latency, min_target);
+    std::size_t target =
+        std::clamp(target_latency.load(std::memory_order_relaxed), min_target, max_target);
+
+    const bool starved = frames_written < num_frames;
+    if (starved) {
+        // Only the start of a starvation counts, so that pausing doesn't max out the target
+        if (!was_starved) {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            target = std::min(target + target_latency_step, max_target);
+        }
+        callbacks_without_underrun = 0;
+        callbacks_above_target = 0;
+    } else if (++callbacks_without_underrun >= target_latency_decay_callbacks) {
+        target = std::max(target - target_latency_step, min_target);
+        callbacks_without_underrun = 0;
+    }
+
+    std::size_t queued = fifo.Size();
+    if (queued > target * 2) {
+        if (++callbacks_above_target >= overrun_callbacks) {
+            const std::size_t dropped = fifo.Discard(queued - target);
+            dropped_frames.fetch_add(dropped, std::memory_order_relaxed);
+            queued -= dropped;
+            callbacks_above_target = 0;
+        }
+    } else {
+        callbacks_above_target = 0;
+    }
+
+    was_starved = starved;
+    target_latency.store(target, std::memory_order_relaxed);
+    queued_frames.store(queued, std::memory_order_relaxed);
+}
+
 } // namespace AudioCore
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <boost/serialization/access.hpp>
@@ -21,6 +22,14 @@ namespace AudioCore {
 
 class Sink;
 
+/// Statistics of the audio output, which can be read from any thread
+struct AudioOutputStats {
+    u64 underruns;         ///< Number of times the sink ran out of samples
+    u64 dropped_frames;    ///< Frames dropped because of a full buffer or to catch up to the target
+    u32 latency_ms;        ///< Audio queued for the sink after its last callback
+    u32 target_latency_ms; ///< Latency that the output currently aims for
+};
+
 class DspInterface {
 public:
     DspInterface();
@@ -99,6 +108,8 @@ public:
     Sink& GetSink();
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
+    /// Get the statistics of the audio output
+    AudioOutputStats GetOutputStats() const;
 
 protected:
     void OutputFrame(StereoFrame16 frame);
@@ -107,11 +118,27 @@ protected:
 private:
     void FlushResidualStretcherAudio();
     void OutputCallback(s16* buffer, std::size_t num_frames);
+    /// Adapts the target latency to the underruns of the sink and drops the queued audio that
+    /// stays above it. Only called from the sink callback.
+    void UpdateOutputLatency(std::size_t num_frames, std::size_t frames_written);
+    /// Passes the latest emulation speed on to the time stretcher
+    void UpdateEmulationSpeed();
 
     std::atomic<bool> perform_time_stretching = false;
     std::atomic<bool> flushing_time_stretcher = false;
     Common::RingBuffer<s16, 0x2000, 2> fifo;
+    std::vector<s16> stretcher_input;
+    std::size_t samples_since_speed_update = 0;
     std::array<s16, 2> last_frame{};
+
+    // Adaptive latency, in frames at the native sample rate
+    std::atomic<std::size_t> target_latency;
+    std::atomic<std::size_t> queued_frames = 0;
+    bool was_starved = false;
+    u32 callbacks_without_underrun = 0;
+    u32 callbacks_above_target = 0;
+    std::atomic<u64> underruns = 0;
+    std::atomic<u64> dropped_frames = 0;
     TimeStretcher time_stretcher;
     std::unique_ptr<Sink> sink;
 
@@ -32,6 +32,14 @@ DecoderSampleRate GetSampleRateEnum(u32 sample_rate) {
     }
 }
 
+u8* GetFCRAMRange(Memory::MemorySystem& memory, PAddr address, std::size_t size) {
+    if (address < Memory::FCRAM_PADDR ||
+        static_cast<u64>(address) + size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+        return nullptr;
+    }
+    return memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR);
+}
+
 DecoderBase::~DecoderBase(){};
 
 NullDecoder::NullDecoder() = default;
@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <array>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <vector>
+#include "common/assert.h"
 #include "common/common_types.h"
+#include "common/logging/log.h"
 #include "common/swap.h"
 #include "core/core.h"
 
@@ -68,6 +72,54 @@ static_assert(sizeof(BinaryResponse) == 32, "Unexpected struct size for BinaryRe
 
 enum_le<DecoderSampleRate> GetSampleRateEnum(u32 sample_rate);
 
+/// Returns a pointer to size bytes of FCRAM at the physical address, or nullptr if the range is
+/// out of bounds
+u8* GetFCRAMRange(Memory::MemorySystem& memory, PAddr address, std::size_t size);
+
+/**
+ * Writes the decoded s16 PCM of a decode request straight into its per-channel buffers in FCRAM,
+ * appending to what was written before.
+ */
+class DecodedPCMWriter {
+public:
+    DecodedPCMWriter(Memory::MemorySystem& memory, const BinaryRequest& request)
+        : memory{memory}, dst_addr{request.dst_addr_ch0, request.dst_addr_ch1} {}
+
+    /**
+     * Appends num_samples samples to the first num_channels buffers, sample(i, channel) returning
+     * sample i of the channel. Returns false if a buffer is out of bounds.
+     */
+    template <typename SampleFunc>
+    bool Write(std::size_t num_samples, std::size_t num_channels, SampleFunc&& sample) {
+        ASSERT(num_channels <= dst_addr.size());
+        const std::size_t offset = samples_written * sizeof(s16);
+        for (std::size_t channel = 0; channel < num_channels; channel++) {
+            u8* const dst = GetFCRAMRange(memory, static_cast<PAddr>(dst_addr[channel] + offset),
+                                          num_samples * sizeof(s16));
+            if (!dst) {
+                LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch{} {:08x}", channel,
+                          dst_addr[channel]);
+                return false;
+            }
+            for (std::size_t i = 0; i < num_samples; i++) {
+                const s16 value = sample(i, channel);
+                std::memcpy(dst + i * sizeof(s16), &value, sizeof(s16));
+            }
+        }
+        samples_written += num_samples;
+        return true;
+    }
+
+    std::size_t SamplesWritten() const {
+        return samples_written;
+    }
+
+private:
+    Memory::MemorySystem& memory;
+    std::array<u32, 2> dst_addr;
+    std::size_t samples_written = 0;
+};
+
 class DecoderBase {
 public:
     virtual ~DecoderBase();
@@ -130,14 +130,14 @@ std::optional<BinaryResponse> FDKDecoder::Impl::Decode(const BinaryRequest& requ
         return response;
     }
 
-    if (request.src_addr < Memory::FCRAM_PADDR ||
-        request.src_addr + request.size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+    // fdk_aac reads the ADTS stream in place and the PCM is written straight into the output
+    u8* data = GetFCRAMRange(memory, request.src_addr, request.size);
+    if (!data) {
         LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}", request.src_addr);
         return {};
     }
-    u8* data = memory.GetFCRAMPointer(request.src_addr - Memory::FCRAM_PADDR);
 
-    std::array<std::vector<s16>, 2> out_streams;
+    DecodedPCMWriter output{memory, request};
 
     std::size_t data_size = request.size;
 
@@ -169,13 +169,15 @@ std::optional<BinaryResponse> FDKDecoder::Impl::Decode(const BinaryRequest& requ
             // fill the stream information for binary response
             response.sample_rate = GetSampleRateEnum(stream_info->sampleRate);
             response.num_channels = stream_info->aacNumChannels;
-            response.num_samples = stream_info->frameSize;
-            // fill the output
-            // the sample size = frame_size * channel_counts
-            for (int sample = 0; sample < (stream_info->frameSize * 2); sample++) {
-                for (int ch = 0; ch < stream_info->aacNumChannels; ch++) {
-                    out_streams[ch].push_back(decoder_output[(sample * 2) + 1]);
-                }
+            response.num_samples += stream_info->frameSize;
+            // the output is interleaved, frame_size * channel_counts samples
+            const auto num_channels = static_cast<std::size_t>(stream_info->numChannels);
+            const auto deinterleave = [&decoder_output, num_channels](std::size_t i,
+                                                                      std::size_t channel) {
+                return decoder_output[i * num_channels + channel];
+            };
+            if (!output.Write(stream_info->frameSize, num_channels, deinterleave)) {
+                return std::nullopt;
             }
         } else if (result == AAC_DEC_TRANSPORT_SYNC_ERROR) {
             // decoder has some synchronization problems, try again with new samples,
@@ -186,28 +188,6 @@ std::optional<BinaryResponse> FDKDecoder::Impl::Decode(const BinaryRequest& requ
             return std::nullopt;
         }
     }
-    // transfer the decoded buffer from vector to the FCRAM
-    if (out_streams[0].size() != 0) {
-        if (request.dst_addr_ch0 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch0 + out_streams[0].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch0 {:08x}", request.dst_addr_ch0);
-            return {};
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch0 - Memory::FCRAM_PADDR),
-                    out_streams[0].data(), out_streams[0].size());
-    }
-
-    if (out_streams[1].size() != 0) {
-        if (request.dst_addr_ch1 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch1 + out_streams[1].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch1 {:08x}", request.dst_addr_ch1);
-            return {};
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch1 - Memory::FCRAM_PADDR),
-                    out_streams[1].data(), out_streams[1].size());
-    }
     return response;
 }
 
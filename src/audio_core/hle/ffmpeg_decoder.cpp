@@ -19,8 +19,6 @@ public:
 private:
     std::optional<BinaryResponse> Initalize(const BinaryRequest& request);
 
-    void Clear();
-
     std::optional<BinaryResponse> Decode(const BinaryRequest& request);
 
     struct AVPacketDeleter {
@@ -91,10 +89,6 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::ProcessRequest(const BinaryRe
 }
 
 std::optional<BinaryResponse> FFMPEGDecoder::Impl::Initalize(const BinaryRequest& request) {
-    if (initalized) {
-        Clear();
-    }
-
     BinaryResponse response;
     std::memcpy(&response, &request, sizeof(response));
     response.unknown1 = 0x0;
@@ -103,6 +97,18 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Initalize(const BinaryRequest
         return response;
     }
 
+    if (initalized) {
+        // Applications initialize the decoder for every stream they play, so keep the opened
+        // codec context and only drop its state. The parser can't be flushed, but is cheap.
+        avcodec_flush_buffers_dl(av_context.get());
+        parser.reset(av_parser_init_dl(codec->id));
+        if (!parser) {
+            LOG_ERROR(Audio_DSP, "Parser not found\n");
+            initalized = false;
+        }
+        return response;
+    }
+
     av_packet.reset(av_packet_alloc_dl());
 
     codec = avcodec_find_decoder_dl(AV_CODEC_ID_AAC);
@@ -132,17 +138,6 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Initalize(const BinaryRequest
     return response;
 }
 
-void FFMPEGDecoder::Impl::Clear() {
-    if (!have_ffmpeg_dl) {
-        return;
-    }
-
-    av_context.reset();
-    parser.reset();
-    decoded_frame.reset();
-    av_packet.reset();
-}
-
 std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& request) {
     BinaryResponse response;
     response.codec = request.codec;
@@ -157,14 +152,14 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
         return response;
     }
 
-    if (request.src_addr < Memory::FCRAM_PADDR ||
-        request.src_addr + request.size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+    // The ADTS stream is parsed in place and the PCM is written straight into the output buffers
+    u8* data = GetFCRAMRange(memory, request.src_addr, request.size);
+    if (!data) {
         LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}", request.src_addr);
         return {};
     }
-    u8* data = memory.GetFCRAMPointer(request.src_addr - Memory::FCRAM_PADDR);
 
-    std::array<std::vector<u8>, 2> out_streams;
+    DecodedPCMWriter output{memory, request};
 
     std::size_t data_size = request.size;
     while (data_size > 0) {
@@ -207,53 +202,27 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
                     return {};
                 }
 
-                ASSERT(decoded_frame->channels <= out_streams.size());
-
-                std::size_t size = bytes_per_sample * (decoded_frame->nb_samples);
-
-                response.sample_rate = GetSampleRateEnum(decoded_frame->sample_rate);
-                response.num_channels = decoded_frame->channels;
-                response.num_samples += decoded_frame->nb_samples;
+                const AVFrame* frame = decoded_frame.get();
+                response.sample_rate = GetSampleRateEnum(frame->sample_rate);
+                response.num_channels = frame->channels;
+                response.num_samples += frame->nb_samples;
 
                 // FFmpeg converts to 32 signed floating point PCM, we need s16 PCM so we need to
                 // convert it
-                f32 val_float;
-                for (std::size_t current_pos(0); current_pos < size;) {
-                    for (std::size_t channel(0); channel < decoded_frame->channels; channel++) {
-                        std::memcpy(&val_float, decoded_frame->data[channel] + current_pos,
-                                    sizeof(val_float));
-                        val_float = std::clamp(val_float, -1.0f, 1.0f);
-                        s16 val = static_cast<s16>(0x7FFF * val_float);
-                        out_streams[channel].push_back(val & 0xFF);
-                        out_streams[channel].push_back(val >> 8);
-                    }
-                    current_pos += sizeof(val_float);
+                const auto convert = [frame](std::size_t i, std::size_t channel) {
+                    f32 val_float;
+                    std::memcpy(&val_float, frame->data[channel] + i * sizeof(val_float),
+                                sizeof(val_float));
+                    val_float = std::clamp(val_float, -1.0f, 1.0f);
+                    return static_cast<s16>(0x7FFF * val_float);
+                };
+                if (!output.Write(frame->nb_samples, frame->channels, convert)) {
+                    return {};
                 }
             }
         }
     }
 
-    if (out_streams[0].size() != 0) {
-        if (request.dst_addr_ch0 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch0 + out_streams[0].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch0 {:08x}", request.dst_addr_ch0);
-            return {};
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch0 - Memory::FCRAM_PADDR),
-                    out_streams[0].data(), out_streams[0].size());
-    }
-
-    if (out_streams[1].size() != 0) {
-        if (request.dst_addr_ch1 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch1 + out_streams[1].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch1 {:08x}", request.dst_addr_ch1);
-            return {};
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch1 - Memory::FCRAM_PADDR),
-                    out_streams[1].data(), out_streams[1].size());
-    }
     return response;
 }
 
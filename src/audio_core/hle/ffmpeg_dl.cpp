@@ -30,6 +30,7 @@ FuncDL<AVFrame*(void)> av_frame_alloc_dl;
 FuncDL<void(AVFrame**)> av_frame_free_dl;
 FuncDL<AVCodecContext*(const AVCodec*)> avcodec_alloc_context3_dl;
 FuncDL<void(AVCodecContext**)> avcodec_free_context_dl;
+FuncDL<void(AVCodecContext*)> avcodec_flush_buffers_dl;
 FuncDL<int(AVCodecContext*, const AVCodec*, AVDictionary**)> avcodec_open2_dl;
 FuncDL<AVPacket*(void)> av_packet_alloc_dl;
 FuncDL<void(AVPacket**)> av_packet_free_dl;
@@ -172,6 +173,13 @@ bool InitFFmpegDL() {
         return false;
     }
 
+    avcodec_flush_buffers_dl =
+        FuncDL<void(AVCodecContext*)>(dll_codec.get(), "avcodec_flush_buffers");
+    if (!avcodec_flush_buffers_dl) {
+        LOG_ERROR(Audio_DSP, "Can not load function avcodec_flush_buffers");
+        return false;
+    }
+
     return true;
 }
 
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <atomic>
+#include <thread>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -28,6 +30,7 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 
@@ -38,7 +41,9 @@ using Service::DSP::DSP_DSP;
 
 namespace AudioCore {
 
-DspHle::DspHle() : DspHle(Core::System::GetInstance().Memory()) {}
+DspHle::DspHle()
+    : DspHle(Core::System::GetInstance().Memory(), Core::System::GetInstance().CoreTiming(),
+             false) {}
 
 template <class Archive>
 void DspHle::serialize(Archive& ar, const unsigned int) {
@@ -56,7 +61,8 @@ static constexpr u64 audio_frame_ticks = samples_per_frame * 4096 * 2ull; ///< U
 
 struct DspHle::Impl final {
 public:
-    explicit Impl(DspHle& parent, Memory::MemorySystem& memory);
+    explicit Impl(DspHle& parent, Memory::MemorySystem& memory, Core::Timing& timing,
+                  bool multithread, bool headless);
     ~Impl();
 
     DspState GetDspState() const;
@@ -80,10 +86,16 @@ private:
     HLE::SharedMemory& ReadRegion();
     HLE::SharedMemory& WriteRegion();
 
-    StereoFrame16 GenerateCurrentFrame();
+    StereoFrame16 GenerateCurrentFrame(HLE::SharedMemory& read, HLE::SharedMemory& write);
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
 
+    /// Publishes the frame mixed since the previous tick and starts mixing the next one
+    void PipelineFrame();
+    /// Waits for the audio thread to finish mixing the frame in flight, if any
+    void WaitForFrame();
+    void AudioThreadLoop();
+
     DspState dsp_state = DspState::Off;
     std::array<std::vector<u8>, num_dsp_pipe> pipe_data{};
 
@@ -98,14 +110,34 @@ private:
     HLE::Mixers mixers{};
 
     DspHle& parent;
+    Core::Timing& timing;
     Core::TimingEventType* tick_event{};
 
     std::unique_ptr<HLE::DecoderBase> decoder{};
 
     std::weak_ptr<DSP_DSP> dsp_dsp{};
 
+    /// When set, frames are mixed on the audio thread from a snapshot of the read region taken at
+    /// each tick, and their results are published a tick later.
+    const bool multithread;
+    std::thread audio_thread;
+    Common::Event frame_requested;
+    Common::Event frame_mixed;
+    std::atomic<bool> stop_audio_thread = false;
+    bool is_frame_in_flight = false;
+    bool has_pending_frame = false;
+    HLE::SharedMemory frame_read;
+    HLE::SharedMemory frame_write;
+    StereoFrame16 frame_output{};
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        // The sources and mixers belong to the audio thread while a frame is in flight. A frame
+        // that hasn't been published yet is dropped when loading.
+        WaitForFrame();
+        if (Archive::is_loading::value) {
+            has_pending_frame = false;
+        }
         ar& dsp_state;
         ar& pipe_data;
         ar& dsp_memory.raw_memory;
@@ -116,11 +148,14 @@ private:
     friend class boost::serialization::access;
 };
 
-DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory) : parent(parent_) {
+DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory, Core::Timing& timing_,
+                   bool multithread_, bool headless)
+    : parent(parent_), timing(timing_), multithread(multithread_) {
     dsp_memory.raw_memory.fill(0);
 
     for (auto& source : sources) {
         source.SetMemory(memory);
+        source.SetHeadless(headless);
     }
 
 #if defined(HAVE_MF) && defined(HAVE_FFMPEG)
@@ -148,17 +183,25 @@ DspHle::Impl::Impl(DspHle& parent_, Memory::MemorySystem& memory) : parent(paren
         decoder = std::make_unique<HLE::NullDecoder>();
     }
 
-    Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     tick_event =
         timing.RegisterEvent("AudioCore::DspHle::tick_event", [this](u64, s64 cycles_late) {
             this->AudioTickCallback(cycles_late);
         });
     timing.ScheduleEvent(audio_frame_ticks, tick_event);
+
+    if (multithread) {
+        audio_thread = std::thread(&Impl::AudioThreadLoop, this);
+    }
 }
 
 DspHle::Impl::~Impl() {
-    Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     timing.UnscheduleEvent(tick_event, 0);
+
+    if (audio_thread.joinable()) {
+        stop_audio_thread = true;
+        frame_requested.Set();
+        audio_thread.join();
+    }
 }
 
 DspState DspHle::Impl::GetDspState() const {
@@ -398,10 +441,8 @@ HLE::SharedMemory& DspHle::Impl::WriteRegion() {
     return CurrentRegionIndex() != 0 ? dsp_memory.region_0 : dsp_memory.region_1;
 }
 
-StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
-    HLE::SharedMemory& read = ReadRegion();
-    HLE::SharedMemory& write = WriteRegion();
-
+StereoFrame16 DspHle::Impl::GenerateCurrentFrame(HLE::SharedMemory& read,
+                                                  HLE::SharedMemory& write) {
     std::array<QuadFrame32, 3> intermediate_mixes = {};
 
     // Generate intermediate mixes
@@ -430,17 +471,75 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
 }
 
 bool DspHle::Impl::Tick() {
-    StereoFrame16 current_frame = {};
-
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
-    current_frame = GenerateCurrentFrame();
+    if (multithread) {
+        PipelineFrame();
+        return true;
+    }
+
+    StereoFrame16 current_frame = GenerateCurrentFrame(ReadRegion(), WriteRegion());
 
     parent.OutputFrame(std::move(current_frame));
 
     return true;
 }
 
+void DspHle::Impl::PipelineFrame() {
+    WaitForFrame();
+
+    // The results of the previous frame land in the region the application now expects them in
+    if (has_pending_frame) {
+        has_pending_frame = false;
+        HLE::SharedMemory& write = WriteRegion();
+        write.source_statuses = frame_write.source_statuses;
+        write.dsp_status = frame_write.dsp_status;
+        write.intermediate_mix_samples = frame_write.intermediate_mix_samples;
+        write.final_samples = frame_write.final_samples;
+        parent.OutputFrame(std::move(frame_output));
+    }
+
+    // Snapshot the configuration, acknowledging its dirty flags as the sources and mixers would
+    HLE::SharedMemory& read = ReadRegion();
+    frame_read = read;
+    for (auto& config : read.source_configurations.config) {
+        if (config.dirty_raw) {
+            if (config.buffer_queue_dirty) {
+                config.buffers_dirty = 0;
+            }
+            config.dirty_raw = 0;
+        }
+    }
+    read.dsp_configuration.dirty_raw = 0;
+
+    // Disabled auxiliary mixers leave their send buffers untouched
+    frame_write.intermediate_mix_samples = WriteRegion().intermediate_mix_samples;
+
+    is_frame_in_flight = true;
+    frame_requested.Set();
+}
+
+void DspHle::Impl::WaitForFrame() {
+    if (!is_frame_in_flight) {
+        return;
+    }
+    frame_mixed.Wait();
+    is_frame_in_flight = false;
+    has_pending_frame = true;
+}
+
+void DspHle::Impl::AudioThreadLoop() {
+    Common::SetCurrentThreadName("DspHle");
+    while (true) {
+        frame_requested.Wait();
+        if (stop_audio_thread) {
+            break;
+        }
+        frame_output = GenerateCurrentFrame(frame_read, frame_write);
+        frame_mixed.Set();
+    }
+}
+
 void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     if (Tick()) {
         // TODO(merry): Signal all the other interrupts as appropriate.
@@ -452,11 +551,12 @@ void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     }
 
     // Reschedule recurrent event
-    Core::Timing& timing = Core::System::GetInstance().CoreTiming();
     timing.ScheduleEvent(audio_frame_ticks - cycles_late, tick_event);
 }
 
-DspHle::DspHle(Memory::MemorySystem& memory) : impl(std::make_unique<Impl>(*this, memory)) {}
+DspHle::DspHle(Memory::MemorySystem& memory, Core::Timing& timing, bool multithread,
+               bool headless)
+    : impl(std::make_unique<Impl>(*this, memory, timing, multithread, headless)) {}
 DspHle::~DspHle() = default;
 
 u16 DspHle::RecvData(u32 register_number) {
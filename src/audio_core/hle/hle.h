@@ -14,6 +14,10 @@
 #include "core/hle/service/dsp/dsp_dsp.h"
 #include "core/memory.h"
 
+namespace Core {
+class Timing;
+}
+
 namespace Memory {
 class MemorySystem;
 }
@@ -22,7 +26,13 @@ namespace AudioCore {
 
 class DspHle final : public DspInterface {
 public:
-    explicit DspHle(Memory::MemorySystem& memory);
+    /**
+     * @param multithread Mix the audio frames on a dedicated thread, a frame behind the ticks
+     * @param headless Only emulate what the application can observe, skipping the decoding,
+     * interpolation and mixing of the sources. The output is silent.
+     */
+    DspHle(Memory::MemorySystem& memory, Core::Timing& timing, bool multithread,
+           bool headless = false);
     ~DspHle();
 
     u16 RecvData(u32 register_number) override;
@@ -6,6 +6,7 @@
 #include <media/NdkMediaError.h>
 #include <media/NdkMediaFormat.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -129,13 +130,12 @@ std::optional<BinaryResponse> MediaNDKDecoder::Impl::Decode(const BinaryRequest&
     response.size = request.size;
     response.num_samples = 1024;
 
-    if (request.src_addr < Memory::FCRAM_PADDR ||
-        request.src_addr + request.size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+    const u8* data = GetFCRAMRange(mMemory, request.src_addr, request.size);
+    if (!data) {
         LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}", request.src_addr);
         return response;
     }
 
-    u8* data = mMemory.GetFCRAMPointer(request.src_addr - Memory::FCRAM_PADDR);
     ADTSData adts_data = ParseADTS(reinterpret_cast<const char*>(data));
     SetMediaType(adts_data);
     response.sample_rate = GetSampleRateEnum(adts_data.samplerate);
@@ -169,7 +169,6 @@ std::optional<BinaryResponse> MediaNDKDecoder::Impl::Decode(const BinaryRequest&
 
     // output
     AMediaCodecBufferInfo info;
-    std::array<std::vector<u16>, 2> out_streams;
     buffer_index = AMediaCodec_dequeueOutputBuffer(mDecoder.get(), &info, timeout);
     switch (buffer_index) {
     case AMEDIACODEC_INFO_TRY_AGAIN_LATER:
@@ -185,42 +184,25 @@ std::optional<BinaryResponse> MediaNDKDecoder::Impl::Decode(const BinaryRequest&
         buffer_index = AMediaCodec_dequeueOutputBuffer(mDecoder.get(), &info, timeout);
     }
     default: {
-        int offset = info.offset;
+        // deinterleave the PCM straight into the output buffers
         buffer = AMediaCodec_getOutputBuffer(mDecoder.get(), buffer_index, &buffer_size);
-        while (offset < info.size) {
-            for (int channel = 0; channel < response.num_channels; channel++) {
-                u16 pcm_data;
-                std::memcpy(&pcm_data, buffer + offset, sizeof(pcm_data));
-                out_streams[channel].push_back(pcm_data);
-                offset += sizeof(pcm_data);
-            }
+        const u8* pcm = buffer + info.offset;
+        const auto num_channels = static_cast<std::size_t>(response.num_channels);
+        if (num_channels != 0) {
+            const std::size_t num_samples = info.size / (num_channels * sizeof(s16));
+            const auto deinterleave = [pcm, num_channels](std::size_t i, std::size_t channel) {
+                s16 pcm_data;
+                std::memcpy(&pcm_data, pcm + (i * num_channels + channel) * sizeof(pcm_data),
+                            sizeof(pcm_data));
+                return pcm_data;
+            };
+            DecodedPCMWriter output{mMemory, request};
+            output.Write(num_samples, std::min<std::size_t>(num_channels, 2), deinterleave);
         }
         AMediaCodec_releaseOutputBuffer(mDecoder.get(), buffer_index, info.size != 0);
     }
     }
 
-    // transfer the decoded buffer from vector to the FCRAM
-    size_t stream0_size = out_streams[0].size() * sizeof(u16);
-    if (stream0_size != 0) {
-        if (request.dst_addr_ch0 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch0 + stream0_size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch0 {:08x}", request.dst_addr_ch0);
-            return response;
-        }
-        std::memcpy(mMemory.GetFCRAMPointer(request.dst_addr_ch0 - Memory::FCRAM_PADDR),
-                    out_streams[0].data(), stream0_size);
-    }
-
-    size_t stream1_size = out_streams[1].size() * sizeof(u16);
-    if (stream1_size != 0) {
-        if (request.dst_addr_ch1 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch1 + stream1_size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch1 {:08x}", request.dst_addr_ch1);
-            return response;
-        }
-        std::memcpy(mMemory.GetFCRAMPointer(request.dst_addr_ch1 - Memory::FCRAM_PADDR),
-                    out_streams[1].data(), stream1_size);
-    }
     return response;
 }
 
@@ -5,9 +5,16 @@
 #include <algorithm>
 #include <cstddef>
 #include "audio_core/hle/mixers.h"
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace AudioCore::HLE {
 
 void Mixers::Reset() {
@@ -117,6 +124,38 @@ void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& sample
         // fallthrough
 
     case OutputFormat::Stereo:
+#if CITRA_ARCH(x86_64)
+        // Two quadraphonic samples are downmixed at a time, the saturating packs and adds match
+        // ClampToS16 and AddAndClampToS16
+        for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+            const __m128 scale = _mm_set1_ps(gain);
+            const auto* in = reinterpret_cast<const __m128i*>(samples[samplei].data());
+            const __m128 first = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in)), scale);
+            const __m128 second = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in + 1)), scale);
+            const __m128 stereo = _mm_add_ps(_mm_movelh_ps(first, second),
+                                             _mm_movehl_ps(second, first));
+            const __m128i downmixed = _mm_cvttps_epi32(stereo);
+
+            auto* out = reinterpret_cast<__m128i*>(current_frame[samplei].data());
+            const __m128i mixed =
+                _mm_adds_epi16(_mm_loadl_epi64(out), _mm_packs_epi32(downmixed, downmixed));
+            _mm_storel_epi64(out, mixed);
+        }
+#elif CITRA_ARCH(arm64)
+        for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+            const float32x4_t first =
+                vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(samples[samplei].data())), gain);
+            const float32x4_t second =
+                vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(samples[samplei + 1].data())), gain);
+            const float32x4_t front = vcombine_f32(vget_low_f32(first), vget_low_f32(second));
+            const float32x4_t back = vcombine_f32(vget_high_f32(first), vget_high_f32(second));
+            const float32x4_t stereo = vaddq_f32(front, back);
+            const int16x4_t downmixed = vqmovn_s32(vcvtq_s32_f32(stereo));
+
+            s16* out = current_frame[samplei].data();
+            vst1_s16(out, vqadd_s16(vld1_s16(out), downmixed));
+        }
+#else
         std::transform(
             current_frame.begin(), current_frame.end(), samples.begin(), current_frame.begin(),
             [gain](const std::array<s16, 2>& accumulator,
@@ -127,6 +166,7 @@ void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& sample
                 // Mix into current frame
                 return AddAndClampToS16(accumulator, {left, right});
             });
+#endif
         return;
     }
 
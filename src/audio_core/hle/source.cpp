@@ -4,14 +4,22 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
 #include "audio_core/interpolate.h"
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/memory.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace AudioCore::HLE {
 
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
@@ -26,17 +34,47 @@ SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
 }
 
 void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
-    if (!state.enabled)
+    if (!state.enabled || headless)
         return;
 
     const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
+
+    // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here. The vector paths
+    // widen each (L, R) pair to (L, R, L, R) and truncate the products like the scalar one.
+#if CITRA_ARCH(x86_64)
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+        const __m128i samples =
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(current_frame[samplei].data()));
+        const __m128i doubled = _mm_unpacklo_epi32(samples, samples);
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(doubled, doubled), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(doubled, doubled), 16);
+
+        auto* out = reinterpret_cast<__m128i*>(dest[samplei].data());
+        const __m128i mixed_lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), gain));
+        const __m128i mixed_hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), gain));
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), mixed_lo));
+        _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), mixed_hi));
+    }
+#elif CITRA_ARCH(arm64)
+    const float32x4_t gain = vld1q_f32(gains.data());
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        s32 pair;
+        std::memcpy(&pair, current_frame[samplei].data(), sizeof(pair));
+        const int32x4_t sample = vmovl_s16(vreinterpret_s16_s32(vdup_n_s32(pair)));
+
+        s32* out = dest[samplei].data();
+        const int32x4_t mixed = vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(sample), gain));
+        vst1q_s32(out, vaddq_s32(vld1q_s32(out), mixed));
+    }
+#else
     for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
-        // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
         dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
         dest[samplei][1] += static_cast<s32>(gains[1] * current_frame[samplei][1]);
         dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
         dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
     }
+#endif
 }
 
 void Source::Reset() {
@@ -48,6 +86,10 @@ void Source::SetMemory(Memory::MemorySystem& memory) {
     memory_system = &memory;
 }
 
+void Source::SetHeadless(bool headless_) {
+    headless = headless_;
+}
+
 void Source::ParseConfig(SourceConfiguration::Configuration& config,
                          const s16_le (&adpcm_coeffs)[16]) {
     if (!config.dirty_raw) {
@@ -185,7 +227,20 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
 
         // TODO(xperia64): This could potentially be optimized by only decoding the new data and
         // appending that to the buffer.
-        if (memory) {
+        if (memory && headless) {
+            // Only the length matters, with the same handling of the sample number as below
+            if (state.format == Format::PCM16) {
+                if (config.length < state.current_sample_number) {
+                    state.current_sample_number = 0;
+                    state.headless_buffer_size = config.length;
+                } else {
+                    state.headless_buffer_size = config.length - state.current_sample_number;
+                }
+            } else {
+                UNIMPLEMENTED_MSG("{} not handled for partial buffer updates",
+                                  state.format == Format::PCM8 ? "PCM8" : "ADPCM");
+            }
+        } else if (memory) {
             const unsigned num_channels = state.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
             bool valid = false;
             switch (state.format) {
@@ -319,7 +374,7 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
 void Source::GenerateFrame() {
     current_frame.fill({});
 
-    if (state.current_buffer.empty() && !DequeueBuffer()) {
+    if (IsCurrentBufferEmpty() && !DequeueBuffer()) {
         state.enabled = false;
         state.buffer_update = true;
         state.current_buffer_id = 0;
@@ -330,10 +385,16 @@ void Source::GenerateFrame() {
 
     state.current_sample_number = state.next_sample_number;
     while (frame_position < current_frame.size()) {
-        if (state.current_buffer.empty() && !DequeueBuffer()) {
+        if (IsCurrentBufferEmpty() && !DequeueBuffer()) {
             break;
         }
 
+        if (headless) {
+            AudioInterp::Skip(state.interp_state, state.headless_buffer_size,
+                              state.rate_multiplier, frame_position);
+            continue;
+        }
+
         switch (state.interpolation_mode) {
         case InterpolationMode::None:
             AudioInterp::None(state.interp_state, state.current_buffer, state.rate_multiplier,
@@ -344,9 +405,8 @@ void Source::GenerateFrame() {
                                 current_frame, frame_position);
             break;
         case InterpolationMode::Polyphase:
-            // TODO(merry): Implement polyphase interpolation
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            AudioInterp::Polyphase(state.interp_state, state.current_buffer,
+                                   state.rate_multiplier, current_frame, frame_position);
             break;
         default:
             UNIMPLEMENTED();
@@ -357,12 +417,17 @@ void Source::GenerateFrame() {
     // over time
     state.next_sample_number += static_cast<u32>(frame_position * state.rate_multiplier);
 
-    state.filters.ProcessFrame(current_frame);
+    if (!headless) {
+        state.filters.ProcessFrame(current_frame);
+    }
+}
+
+bool Source::IsCurrentBufferEmpty() const {
+    return headless ? state.headless_buffer_size == 0 : state.current_buffer.empty();
 }
 
 bool Source::DequeueBuffer() {
-    ASSERT_MSG(state.current_buffer.empty(),
-               "Shouldn't dequeue; we still have data in current_buffer");
+    ASSERT_MSG(IsCurrentBufferEmpty(), "Shouldn't dequeue; we still have data in current_buffer");
 
     if (state.input_queue.empty())
         return false;
@@ -378,7 +443,11 @@ bool Source::DequeueBuffer() {
     // This physical address masking occurs due to how the DSP DMA hardware is configured by the
     // firmware.
     const u8* const memory = memory_system->GetPhysicalPointer(buf.physical_address & 0xFFFFFFFC);
-    if (memory) {
+    if (memory && headless) {
+        // The ADPCM decoder always outputs an even number of samples
+        state.headless_buffer_size =
+            buf.format == Format::ADPCM ? (buf.length + 1) & ~1u : buf.length;
+    } else if (memory) {
         const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
         switch (buf.format) {
         case Format::PCM8:
@@ -401,6 +470,7 @@ bool Source::DequeueBuffer() {
                     "source_id={} buffer_id={} length={}: Invalid physical address {:#010x}",
                     source_id, buf.buffer_id, buf.length, buf.physical_address);
         state.current_buffer.clear();
+        state.headless_buffer_size = 0;
         return true;
     }
 
@@ -7,9 +7,11 @@
 #include <array>
 #include <vector>
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/binary_object.hpp>
 #include <boost/serialization/deque.hpp>
 #include <boost/serialization/priority_queue.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include <queue>
 #include "audio_core/audio_types.h"
 #include "audio_core/codec.h"
@@ -45,6 +47,13 @@ public:
     /// Sets the memory system to read data from
     void SetMemory(Memory::MemorySystem& memory);
 
+    /**
+     * Sets whether the output of this source is unused. A headless source consumes its buffers at
+     * the pace it would play them at and reports the same status, but never decodes them and only
+     * outputs silence.
+     */
+    void SetHeadless(bool headless);
+
     /**
      * This is called once every audio frame. This performs per-source processing every frame.
      * @param config The new configuration we've got for this Source from the application.
@@ -68,6 +77,7 @@ private:
     const std::size_t source_id;
     Memory::MemorySystem* memory_system;
     StereoFrame16 current_frame;
+    bool headless = false;
 
     using Format = SourceConfiguration::Configuration::Format;
     using InterpolationMode = SourceConfiguration::Configuration::InterpolationMode;
@@ -139,6 +149,8 @@ private:
         u32 next_sample_number = 0;
         PAddr current_buffer_physical_address = 0;
         AudioInterp::StereoBuffer16 current_buffer = {};
+        /// Number of samples left in the current buffer when headless, as it isn't decoded
+        std::size_t headless_buffer_size = 0;
 
         // buffer_id state
 
@@ -161,6 +173,7 @@ private:
         SourceFilters filters = {};
 
     private:
+        /// Layout of version 0 sources, see Source::serialize
         template <class Archive>
         void serialize(Archive& ar, const unsigned int) {
             ar& enabled;
@@ -189,17 +202,57 @@ private:
     void ParseConfig(SourceConfiguration::Configuration& config, const s16_le (&adpcm_coeffs)[16]);
     /// INTERNAL: Generate the current audio output for this frame based on our internal state.
     void GenerateFrame();
+    /// INTERNAL: Returns whether all samples of the current buffer have been consumed.
+    bool IsCurrentBufferEmpty() const;
     /// INTERNAL: Dequeues a buffer and does preprocessing on it (decoding, resampling). Puts it
     /// into current_buffer.
     bool DequeueBuffer();
     /// INTERNAL: Generates a SourceStatus::Status based on our internal state.
     SourceStatus::Status GetCurrentStatus();
 
+    /// The decoded samples are written as one block rather than element by element
+    template <class Archive>
+    static void SerializeBuffer(Archive& ar, AudioInterp::StereoBuffer16& buffer) {
+        std::vector<std::array<s16, 2>> samples;
+        u32 num_samples{};
+        if (Archive::is_saving::value) {
+            samples.assign(buffer.begin(), buffer.end());
+            num_samples = static_cast<u32>(samples.size());
+        }
+        ar& num_samples;
+        samples.resize(num_samples);
+        ar& boost::serialization::make_binary_object(samples.data(),
+                                                     samples.size() * sizeof(samples[0]));
+        if (Archive::is_loading::value) {
+            buffer.assign(samples.begin(), samples.end());
+        }
+    }
+
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int) {
-        ar& state;
+    void serialize(Archive& ar, const unsigned int file_version) {
+        if (file_version == 0) {
+            ar& state;
+            return;
+        }
+        ar& state.enabled;
+        ar& state.sync;
+        ar& state.gain;
+        ar& state.input_queue;
+        ar& state.mono_or_stereo;
+        ar& state.format;
+        ar& state.current_sample_number;
+        ar& state.next_sample_number;
+        ar& state.current_buffer_physical_address;
+        SerializeBuffer(ar, state.current_buffer);
+        ar& state.buffer_update;
+        ar& state.current_buffer_id;
+        ar& state.adpcm_coeffs;
+        ar& state.rate_multiplier;
+        ar& state.interpolation_mode;
     }
     friend class boost::serialization::access;
 };
 
 } // namespace AudioCore::HLE
+
+BOOST_CLASS_VERSION(AudioCore::HLE::Source, 1)
@@ -23,7 +23,7 @@ private:
 
     std::optional<BinaryResponse> Decode(const BinaryRequest& request);
 
-    MFOutputState DecodingLoop(ADTSData adts_header, std::array<std::vector<u8>, 2>& out_streams);
+    MFOutputState DecodingLoop(ADTSData adts_header, DecodedPCMWriter& pcm_output);
 
     bool transform_initialized = false;
     bool format_selected = false;
@@ -136,8 +136,7 @@ std::optional<BinaryResponse> WMFDecoder::Impl::Initalize(const BinaryRequest& r
     return response;
 }
 
-MFOutputState WMFDecoder::Impl::DecodingLoop(ADTSData adts_header,
-                                             std::array<std::vector<u8>, 2>& out_streams) {
+MFOutputState WMFDecoder::Impl::DecodingLoop(ADTSData adts_header, DecodedPCMWriter& pcm_output) {
     MFOutputState output_status = MFOutputState::OK;
     std::optional<std::vector<f32>> output_buffer;
     unique_mfptr<IMFSample> output;
@@ -150,15 +149,17 @@ MFOutputState WMFDecoder::Impl::DecodingLoop(ADTSData adts_header,
             output_buffer = CopySampleToBuffer(output.get());
 
             // the following was taken from ffmpeg version of the decoder
-            f32 val_f32;
-            for (std::size_t i = 0; i < output_buffer->size();) {
-                for (std::size_t channel = 0; channel < adts_header.channels; channel++) {
-                    val_f32 = std::clamp(output_buffer->at(i), -1.0f, 1.0f);
-                    s16 val = static_cast<s16>(0x7FFF * val_f32);
-                    out_streams[channel].push_back(val & 0xFF);
-                    out_streams[channel].push_back(val >> 8);
-                    // i is incremented on per channel basis
-                    i++;
+            if (output_buffer && adts_header.channels != 0) {
+                const auto& buffer = *output_buffer;
+                const std::size_t num_channels = adts_header.channels;
+                const auto convert = [&buffer, num_channels](std::size_t i, std::size_t channel) {
+                    const f32 val_f32 =
+                        std::clamp(buffer[i * num_channels + channel], -1.0f, 1.0f);
+                    return static_cast<s16>(0x7FFF * val_f32);
+                };
+                if (!pcm_output.Write(buffer.size() / num_channels,
+                                      std::min<std::size_t>(num_channels, 2), convert)) {
+                    return MFOutputState::FatalError;
                 }
             }
         }
@@ -202,14 +203,13 @@ std::optional<BinaryResponse> WMFDecoder::Impl::Decode(const BinaryRequest& requ
         return response;
     }
 
-    if (request.src_addr < Memory::FCRAM_PADDR ||
-        request.src_addr + request.size > Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+    u8* data = GetFCRAMRange(memory, request.src_addr, request.size);
+    if (!data) {
         LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}", request.src_addr);
         return std::nullopt;
     }
-    u8* data = memory.GetFCRAMPointer(request.src_addr - Memory::FCRAM_PADDR);
 
-    std::array<std::vector<u8>, 2> out_streams;
+    DecodedPCMWriter output{memory, request};
     unique_mfptr<IMFSample> sample;
     MFInputState input_status = MFInputState::OK;
     MFOutputState output_status = MFOutputState::OK;
@@ -241,7 +241,7 @@ std::optional<BinaryResponse> WMFDecoder::Impl::Decode(const BinaryRequest& requ
 
     while (true) {
         input_status = SendSample(transform.get(), in_stream_id, sample.get());
-        output_status = DecodingLoop(adts_meta->ADTSHeader, out_streams);
+        output_status = DecodingLoop(adts_meta->ADTSHeader, output);
 
         if (output_status == MFOutputState::FatalError) {
             // if the decode issues are caused by MFT not accepting new samples, try again
@@ -264,28 +264,6 @@ std::optional<BinaryResponse> WMFDecoder::Impl::Decode(const BinaryRequest& requ
         break; // jump out of the loop if at least we don't have obvious issues
     }
 
-    if (out_streams[0].size() != 0) {
-        if (request.dst_addr_ch0 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch0 + out_streams[0].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch0 {:08x}", request.dst_addr_ch0);
-            return std::nullopt;
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch0 - Memory::FCRAM_PADDR),
-                    out_streams[0].data(), out_streams[0].size());
-    }
-
-    if (out_streams[1].size() != 0) {
-        if (request.dst_addr_ch1 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch1 + out_streams[1].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch1 {:08x}", request.dst_addr_ch1);
-            return std::nullopt;
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch1 - Memory::FCRAM_PADDR),
-                    out_streams[1].data(), out_streams[1].size());
-    }
-
     return response;
 }
 
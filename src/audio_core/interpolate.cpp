@@ -3,9 +3,19 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <vector>
 #include "audio_core/interpolate.h"
+#include "common/arch.h"
 #include "common/assert.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace AudioCore::AudioInterp {
 
 // Calculations are done in fixed point with 24 fractional bits.
@@ -29,6 +39,22 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     u64 fposition = state.fposition;
     std::size_t inputi = 0;
 
+    // At unity rate without a fractional offset every step lands on a sample and both
+    // interpolators reduce to x0, so the samples are copied over in bulk. The generic loop below
+    // then only runs to find where stepping stops.
+    if (step_size == scale_factor && (fposition & scale_mask) == 0) {
+        const std::size_t start = static_cast<std::size_t>(fposition / scale_factor);
+        if (start + 2 < input.size() && outputi < output.size()) {
+            const std::size_t count =
+                std::min(output.size() - outputi, input.size() - 2 - start);
+            std::copy_n(std::next(input.begin(), start), count,
+                        std::next(output.begin(), outputi));
+            outputi += count;
+            fposition += count * scale_factor;
+            inputi = start + count - 1;
+        }
+    }
+
     while (outputi < output.size()) {
         inputi = static_cast<std::size_t>(fposition / scale_factor);
 
@@ -73,4 +99,203 @@ void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& outp
                     });
 }
 
+namespace {
+
+constexpr std::size_t polyphase_taps = 8;
+constexpr std::size_t polyphase_phase_bits = 7;
+constexpr std::size_t polyphase_phases = 1 << polyphase_phase_bits;
+/// Coefficients are fixed point with 14 fractional bits.
+constexpr int polyphase_coeff_bits = 14;
+
+using PolyphaseTable = std::array<std::array<s16, polyphase_taps>, polyphase_phases>;
+
+constexpr double pi = 3.14159265358979323846;
+
+/// Sine that can be evaluated at compile time, accurate enough for the filter coefficients.
+constexpr double Sine(double x) {
+    while (x > pi) {
+        x -= 2 * pi;
+    }
+    while (x < -pi) {
+        x += 2 * pi;
+    }
+    double term = x;
+    double sum = x;
+    for (int i = 1; i < 16; i++) {
+        term *= -x * x / ((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double Cosine(double x) {
+    return Sine(x + pi / 2);
+}
+
+/// Builds one low-pass filter per phase, each normalized to unity gain. Taps 3 and 4 surround the
+/// output position, so every phase reads the four samples on either side of it.
+constexpr PolyphaseTable GeneratePolyphaseTable() {
+    constexpr double half_width = polyphase_taps / 2;
+    PolyphaseTable table{};
+    for (std::size_t phase = 0; phase < polyphase_phases; phase++) {
+        const double fraction = static_cast<double>(phase) / polyphase_phases;
+        std::array<double, polyphase_taps> kernel{};
+        double sum = 0;
+        for (std::size_t tap = 0; tap < polyphase_taps; tap++) {
+            const double t = static_cast<double>(tap) - (half_width - 1) - fraction;
+            const double sinc = t == 0 ? 1.0 : Sine(pi * t) / (pi * t);
+            const double w = t / half_width;
+            const double window = 0.42 + 0.5 * Cosine(pi * w) + 0.08 * Cosine(2 * pi * w);
+            kernel[tap] = sinc * window;
+            sum += kernel[tap];
+        }
+
+        int total = 0;
+        std::size_t largest = 0;
+        for (std::size_t tap = 0; tap < polyphase_taps; tap++) {
+            const double value = kernel[tap] / sum * (1 << polyphase_coeff_bits);
+            table[phase][tap] = static_cast<s16>(value >= 0 ? value + 0.5 : value - 0.5);
+            total += table[phase][tap];
+            if (table[phase][tap] > table[phase][largest]) {
+                largest = tap;
+            }
+        }
+        // Rounding must not change the DC gain
+        table[phase][largest] += static_cast<s16>((1 << polyphase_coeff_bits) - total);
+    }
+    return table;
+}
+
+constexpr PolyphaseTable polyphase_table = GeneratePolyphaseTable();
+
+static_assert(polyphase_table[0][3] == 1 << polyphase_coeff_bits,
+              "The first phase must reproduce the input");
+
+/// Applies the filter of a phase to eight consecutive stereo samples
+std::array<s16, 2> PolyphaseFilter(const std::array<s16, 2>* samples,
+                                   const std::array<s16, polyphase_taps>& coeffs) {
+    constexpr s32 rounding = 1 << (polyphase_coeff_bits - 1);
+#if CITRA_ARCH(x86_64)
+    // Deinterleave pairs of samples to (L, L, R, R) to match coefficient pairs in the multiply-add
+    const auto load = [samples](std::size_t i) {
+        const __m128i pairs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        const __m128i lo = _mm_shufflelo_epi16(pairs, _MM_SHUFFLE(3, 1, 2, 0));
+        return _mm_shufflehi_epi16(lo, _MM_SHUFFLE(3, 1, 2, 0));
+    };
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(coeffs.data()));
+    const __m128i sum = _mm_add_epi32(_mm_madd_epi16(load(0), _mm_unpacklo_epi32(c, c)),
+                                      _mm_madd_epi16(load(4), _mm_unpackhi_epi32(c, c)));
+    __m128i result = _mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum));
+    result = _mm_srai_epi32(_mm_add_epi32(result, _mm_set1_epi32(rounding)), polyphase_coeff_bits);
+    result = _mm_packs_epi32(result, result);
+
+    std::array<s16, 2> output;
+    const s32 packed = _mm_cvtsi128_si32(result);
+    std::memcpy(output.data(), &packed, sizeof(packed));
+    return output;
+#elif CITRA_ARCH(arm64)
+    const int16x4x2_t lo = vld2_s16(samples[0].data());
+    const int16x4x2_t hi = vld2_s16(samples[4].data());
+    const int16x4_t c_lo = vld1_s16(coeffs.data());
+    const int16x4_t c_hi = vld1_s16(coeffs.data() + 4);
+    const int32x4_t left = vmlal_s16(vmull_s16(lo.val[0], c_lo), hi.val[0], c_hi);
+    const int32x4_t right = vmlal_s16(vmull_s16(lo.val[1], c_lo), hi.val[1], c_hi);
+    const int32x2_t sum = vpadd_s32(vpadd_s32(vget_low_s32(left), vget_high_s32(left)),
+                                    vpadd_s32(vget_low_s32(right), vget_high_s32(right)));
+    const int16x4_t result = vqrshrn_n_s32(vcombine_s32(sum, sum), polyphase_coeff_bits);
+    return {vget_lane_s16(result, 0), vget_lane_s16(result, 1)};
+#else
+    std::array<s32, 2> sum{rounding, rounding};
+    for (std::size_t tap = 0; tap < polyphase_taps; tap++) {
+        sum[0] += coeffs[tap] * samples[tap][0];
+        sum[1] += coeffs[tap] * samples[tap][1];
+    }
+    return {static_cast<s16>(std::clamp(sum[0] >> polyphase_coeff_bits, -32768, 32767)),
+            static_cast<s16>(std::clamp(sum[1] >> polyphase_coeff_bits, -32768, 32767))};
+#endif
+}
+
+} // Anonymous namespace
+
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi) {
+    ASSERT(rate > 0);
+
+    if (input.empty())
+        return;
+
+    // Positions count from x[n-2] like in StepOverSamples, the filter additionally reads the five
+    // samples before it. Only the part of the input that can be reached is copied.
+    constexpr std::size_t history_size = std::tuple_size_v<decltype(state.history)>;
+    const u64 step_size = static_cast<u64>(rate * scale_factor);
+    u64 fposition = state.fposition;
+    const u64 last_position = fposition + (output.size() - outputi) * step_size;
+    const std::size_t reachable =
+        std::min(input.size(), static_cast<std::size_t>(last_position / scale_factor) + 1);
+
+    thread_local std::vector<std::array<s16, 2>> window;
+    window.clear();
+    window.insert(window.end(), state.history.begin(), state.history.end());
+    window.push_back(state.xn2);
+    window.push_back(state.xn1);
+    window.insert(window.end(), input.begin(), std::next(input.begin(), reachable));
+    const std::size_t window_size = window.size() - history_size;
+
+    std::size_t inputi = 0;
+    while (outputi < output.size()) {
+        inputi = static_cast<std::size_t>(fposition / scale_factor);
+
+        if (inputi + 2 >= window_size) {
+            inputi = window_size - 2;
+            break;
+        }
+
+        const std::size_t phase = (fposition & scale_mask) >> (24 - polyphase_phase_bits);
+        output[outputi++] = PolyphaseFilter(&window[inputi], polyphase_table[phase]);
+
+        fposition += step_size;
+    }
+
+    std::copy_n(std::next(window.begin(), inputi), history_size, state.history.begin());
+    state.xn2 = window[inputi + history_size];
+    state.xn1 = window[inputi + history_size + 1];
+    state.fposition = fposition - inputi * scale_factor;
+
+    input.erase(input.begin(), std::next(input.begin(), inputi));
+}
+
+void Skip(State& state, std::size_t& input_size, float rate, std::size_t& outputi) {
+    ASSERT(rate > 0);
+
+    if (input_size == 0)
+        return;
+
+    // Stepping stops at the first position that doesn't have two samples after it, which is the
+    // end of the input as positions count from x[n-2]
+    const u64 step_size = static_cast<u64>(rate * scale_factor);
+    const u64 end = input_size * scale_factor;
+    const u64 fposition = state.fposition;
+    const std::size_t remaining = samples_per_frame - outputi;
+    std::size_t steps = 0;
+    if (fposition < end) {
+        steps = step_size == 0 ? remaining
+                               : static_cast<std::size_t>((end - fposition - 1) / step_size + 1);
+    }
+
+    std::size_t inputi;
+    if (steps >= remaining) {
+        // The frame fills up, the input is consumed up to the last position stepped on
+        steps = remaining;
+        inputi = steps == 0 ? 0
+                            : static_cast<std::size_t>((fposition + (steps - 1) * step_size) /
+                                                       scale_factor);
+    } else {
+        inputi = input_size;
+    }
+
+    outputi += steps;
+    state.fposition = fposition + steps * step_size - inputi * scale_factor;
+    input_size -= inputi;
+}
+
 } // namespace AudioCore::AudioInterp
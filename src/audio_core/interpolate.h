@@ -18,6 +18,8 @@ struct State {
     /// Two historical samples.
     std::array<s16, 2> xn1 = {}; ///< x[n-1]
     std::array<s16, 2> xn2 = {}; ///< x[n-2]
+    /// Older historical samples, only used by the polyphase filter. x[n-7] to x[n-3].
+    std::array<std::array<s16, 2>, 5> history = {};
     /// Current fractional position.
     u64 fposition = 0;
 };
@@ -46,4 +48,28 @@ void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output
 void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
             std::size_t& outputi);
 
+/**
+ * Polyphase interpolation with an 8-tap Blackman-windowed sinc filter. There is a four-sample
+ * predelay.
+ * @param state Interpolation state.
+ * @param input Input buffer.
+ * @param rate Stretch factor. Must be a positive non-zero value.
+ *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
+ * @param output The resampled audio buffer.
+ * @param outputi The index of output to start writing to.
+ */
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi);
+
+/**
+ * Steps over the input exactly like the interpolators above, without reading or producing any
+ * samples. This keeps the position in the input when the output isn't needed. The historical
+ * samples in the state are left untouched.
+ * @param state Interpolation state.
+ * @param input_size Number of samples in the input buffer, reduced by the number consumed.
+ * @param rate Stretch factor. Must be a positive non-zero value.
+ * @param outputi The index of the output frame to start stepping from.
+ */
+void Skip(State& state, std::size_t& input_size, float rate, std::size_t& outputi);
+
 } // namespace AudioCore::AudioInterp
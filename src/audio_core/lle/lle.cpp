@@ -4,13 +4,14 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <teakra/teakra.h>
 #include "audio_core/lle/lle.h"
 #include "common/assert.h"
 #include "common/bit_field.h"
 #include "common/swap.h"
-#include "common/thread.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/lock.h"
@@ -121,7 +122,8 @@ static u8 PipeIndexToSlotIndex(u8 pipe_index, PipeDirection direction) {
 }
 
 struct DspLle::Impl final {
-    Impl(bool multithread) : multithread(multithread) {
+    Impl(bool multithread, u32 max_run_ahead)
+        : multithread(multithread), max_run_ahead(max_run_ahead) {
         teakra_slice_event = Core::System::GetInstance().CoreTiming().RegisterEvent(
             "DSP slice", [this](u64, int late) { TeakraSliceEvent(static_cast<u64>(late)); });
     }
@@ -141,42 +143,96 @@ struct DspLle::Impl final {
 
     const bool multithread;
     std::thread teakra_thread;
-    Common::Barrier teakra_slice_barrier{2};
     std::atomic<bool> stop_signal = false;
-    std::size_t stop_generation;
+
+    /**
+     * The CPU grants the DSP thread one slice every time it reaches a slice boundary and the DSP
+     * thread may run up to max_run_ahead slices past the granted ones. The CPU only waits for the
+     * DSP to catch up with the slices granted before the current one, so with no run-ahead both
+     * threads run in lockstep, as with a barrier.
+     */
+    const u32 max_run_ahead;
+    std::atomic<u64> slices_granted = 0;
+    std::atomic<u64> slices_run = 0;
+    /// The DSP thread runs in lockstep until this many slices are granted
+    std::atomic<u64> lockstep_until = 0;
+    std::mutex slice_mutex;
+    std::condition_variable slice_cv;
 
     static constexpr u32 DspDataOffset = 0x40000;
     static constexpr u32 TeakraSlice = 16384;
+    // The threads meet every slice, sleeping right away would cost a context switch each time
+    static constexpr u32 SliceSpinCount = 1024;
+
+    template <typename Predicate>
+    void WaitForSlices(Predicate&& predicate) {
+        for (u32 i = 0; i < SliceSpinCount; ++i) {
+            if (predicate()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        std::unique_lock lock{slice_mutex};
+        slice_cv.wait(lock, predicate);
+    }
+
+    void NotifySlices() {
+        // Taking the mutex orders the counter update before a waiter that is about to sleep
+        { std::scoped_lock lock{slice_mutex}; }
+        slice_cv.notify_all();
+    }
+
+    bool CanRunSlice() const {
+        const u64 granted = slices_granted.load();
+        const u64 run_ahead = granted < lockstep_until.load() ? 0 : max_run_ahead;
+        return slices_run.load() < granted + run_ahead;
+    }
 
     void TeakraThread() {
         while (true) {
-            teakra.Run(TeakraSlice);
-            teakra_slice_barrier.Sync();
+            WaitForSlices([this] { return stop_signal || CanRunSlice(); });
             if (stop_signal) {
-                if (stop_generation == teakra_slice_barrier.Generation())
-                    break;
+                break;
             }
+            teakra.Run(TeakraSlice);
+            ++slices_run;
+            NotifySlices();
         }
-        stop_signal = false;
     }
 
     void StopTeakraThread() {
         if (teakra_thread.joinable()) {
-            stop_generation = teakra_slice_barrier.Generation() + 1;
             stop_signal = true;
-            teakra_slice_barrier.Sync();
+            NotifySlices();
             teakra_thread.join();
+            stop_signal = false;
+            slices_granted = 0;
+            slices_run = 0;
+            lockstep_until = 0;
         }
     }
 
     void RunTeakraSlice() {
         if (multithread) {
-            teakra_slice_barrier.Sync();
+            const u64 granted = ++slices_granted;
+            NotifySlices();
+            WaitForSlices([this, granted] { return slices_run + 1 >= granted; });
         } else {
             teakra.Run(TeakraSlice);
         }
     }
 
+    /**
+     * Called when the CPU talks to the DSP. Keeps the DSP thread from running further ahead until
+     * the CPU catches up with it, then runs both in lockstep for a while, as the DSP is likely to
+     * respond to the CPU.
+     */
+    void SyncTeakra() {
+        if (multithread && max_run_ahead != 0) {
+            lockstep_until = slices_granted + max_run_ahead;
+        }
+    }
+
     void TeakraSliceEvent(u64 late) {
         RunTeakraSlice();
         u64 next = TeakraSlice * 2; // DSP runs at clock rate half of the CPU rate
@@ -250,6 +306,7 @@ struct DspLle::Impl final {
         }
         if (need_update) {
             UpdatePipeStatus(pipe_status);
+            SyncTeakra();
             while (!teakra.SendDataIsEmpty(2))
                 RunTeakraSlice();
             teakra.SendData(2, pipe_status.slot_index);
@@ -287,6 +344,7 @@ struct DspLle::Impl final {
         }
         if (need_update) {
             UpdatePipeStatus(pipe_status);
+            SyncTeakra();
             while (!teakra.SendDataIsEmpty(2))
                 RunTeakraSlice();
             teakra.SendData(2, pipe_status.slot_index);
@@ -359,6 +417,7 @@ struct DspLle::Impl final {
 
         // Send finalization signal via command/reply register 2
         constexpr u16 FinalizeSignal = 0x8000;
+        SyncTeakra();
         while (!teakra.SendDataIsEmpty(2))
             RunTeakraSlice();
 
@@ -376,6 +435,7 @@ struct DspLle::Impl final {
 };
 
 u16 DspLle::RecvData(u32 register_number) {
+    impl->SyncTeakra();
     while (!impl->teakra.RecvDataIsReady(register_number)) {
         impl->RunTeakraSlice();
     }
@@ -387,6 +447,7 @@ bool DspLle::RecvDataIsReady(u32 register_number) const {
 }
 
 void DspLle::SetSemaphore(u16 semaphore_value) {
+    impl->SyncTeakra();
     impl->teakra.SetSemaphore(semaphore_value);
 }
 
@@ -473,8 +534,8 @@ void DspLle::UnloadComponent() {
     impl->UnloadComponent();
 }
 
-DspLle::DspLle(Memory::MemorySystem& memory, bool multithread)
-    : impl(std::make_unique<Impl>(multithread)) {
+DspLle::DspLle(Memory::MemorySystem& memory, bool multithread, u32 max_run_ahead)
+    : impl(std::make_unique<Impl>(multithread, max_run_ahead)) {
     Teakra::AHBMCallback ahbm;
     ahbm.read8 = [&memory](u32 address) -> u8 {
         return *memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR);
@@ -10,7 +10,12 @@ namespace AudioCore {
 
 class DspLle final : public DspInterface {
 public:
-    explicit DspLle(Memory::MemorySystem& memory, bool multithread);
+    /**
+     * @param multithread whether to run the DSP on a separate thread
+     * @param max_run_ahead number of slices the DSP thread may run ahead of the emulated CPU
+     * between their interactions, 0 keeps both in lockstep
+     */
+    explicit DspLle(Memory::MemorySystem& memory, bool multithread, u32 max_run_ahead = 0);
     ~DspLle() override;
 
     u16 RecvData(u32 register_number) override;
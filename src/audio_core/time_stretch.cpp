@@ -19,6 +19,13 @@ TimeStretcher::TimeStretcher()
     sound_touch->setSampleRate(native_sample_rate);
     sound_touch->setPitch(1.0);
     sound_touch->setTempo(1.0);
+
+    // Stretching only has to cover small speed deviations. A quick seek over short, fixed
+    // windows costs a fraction of the default exhaustive search with tempo-dependent windows.
+    sound_touch->setSetting(SETTING_USE_QUICKSEEK, 1);
+    sound_touch->setSetting(SETTING_SEQUENCE_MS, 40);
+    sound_touch->setSetting(SETTING_SEEKWINDOW_MS, 15);
+    sound_touch->setSetting(SETTING_OVERLAP_MS, 8);
 }
 
 TimeStretcher::~TimeStretcher() = default;
@@ -28,10 +35,18 @@ void TimeStretcher::SetOutputSampleRate(unsigned int sample_rate) {
     sample_rate = native_sample_rate;
 }
 
+void TimeStretcher::SetEmulationSpeed(double speed) {
+    emulation_speed.store(speed, std::memory_order_relaxed);
+}
+
 std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
                                    std::size_t num_out) {
     const double time_delta = static_cast<double>(num_out) / sample_rate; // seconds
-    double current_ratio = static_cast<double>(num_in) / static_cast<double>(num_out);
+    // The input arrives at the emulation speed. When it is known, it is followed directly rather
+    // than the bursty ratio of input to output in each callback.
+    const double speed = emulation_speed.load(std::memory_order_relaxed);
+    double current_ratio =
+        speed > 0 ? speed : static_cast<double>(num_in) / static_cast<double>(num_out);
 
     const double max_latency = 0.25; // seconds
     const double max_backlog = sample_rate * max_latency;
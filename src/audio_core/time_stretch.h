@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include "common/common_types.h"
@@ -22,6 +23,10 @@ public:
 
     void SetOutputSampleRate(unsigned int sample_rate);
 
+    /// Sets the speed of the emulation relative to the console, which the stretch ratio follows.
+    /// May be called from any thread, a speed of 0 falls back to measuring the input rate.
+    void SetEmulationSpeed(double speed);
+
     /// @param in       Input sample buffer
     /// @param num_in   Number of input frames in `in`
     /// @param out      Output sample buffer
@@ -37,6 +42,7 @@ private:
     unsigned int sample_rate;
     std::unique_ptr<soundtouch::SoundTouch> sound_touch;
     double stretch_ratio = 1.0;
+    std::atomic<double> emulation_speed = 0.0;
 };
 
 } // namespace AudioCore
@@ -0,0 +1,187 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/scm_rev.h"
+#include "video_core/renderer_opengl/gl_shader_cache_package.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " <command> [options] <files>\n"
+                 "Builds, merges and installs packages of the transferable OpenGL shader caches\n"
+                 "of many titles. Installed caches are compiled on the next boot of each title.\n\n"
+                 "Commands:\n"
+                 "genkey <private key> <public key>   Generate a key pair to sign packages\n"
+                 "export <package>                    Package the installed caches\n"
+                 "merge <package> <packages>...       Merge packages into a new package\n"
+                 "import <packages>...                Install the caches of packages\n\n"
+                 "-k, --key           The private key to sign exported and merged packages with,\n"
+                 "                    or the public key imported packages must be signed with\n"
+                 "-t, --title         Export the cache of this title id only, can be repeated\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra shader cache tool " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+static std::optional<std::vector<u8>> ReadKey(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    std::vector<u8> key(file.GetSize());
+    if (!file.IsOpen() || key.empty() || file.ReadBytes(key.data(), key.size()) != key.size()) {
+        std::cout << "Failed to read the key " << path << "\n";
+        return std::nullopt;
+    }
+    return key;
+}
+
+static bool WriteKey(const std::string& path, const std::vector<u8>& key) {
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen() || file.WriteBytes(key.data(), key.size()) != key.size()) {
+        std::cout << "Failed to write the key " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    std::string key_path;
+    std::vector<u64> program_ids;
+
+    static struct option long_options[] = {
+        {"key", required_argument, 0, 'k'},
+        {"title", required_argument, 0, 't'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    std::vector<std::string> arguments;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "k:t:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'k':
+                key_path = optarg;
+                break;
+            case 't':
+                program_ids.push_back(std::strtoull(optarg, &endarg, 16));
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            arguments.emplace_back(argv[optind]);
+            optind++;
+        }
+    }
+
+    if (arguments.size() < 2) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    const std::string& command = arguments[0];
+    const std::vector<std::string> files(arguments.begin() + 1, arguments.end());
+
+    Log::Filter log_filter(Log::Level::Info);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    std::vector<u8> key;
+    if (!key_path.empty()) {
+        auto read_key = ReadKey(key_path);
+        if (!read_key) {
+            return -1;
+        }
+        key = std::move(*read_key);
+    }
+
+    if (command == "genkey") {
+        if (files.size() != 2) {
+            PrintHelp(argv[0]);
+            return -1;
+        }
+        const auto [private_key, public_key] = OpenGL::ShaderCachePackage::GenerateKeys();
+        return WriteKey(files[0], private_key) && WriteKey(files[1], public_key) ? 0 : -1;
+    }
+
+    if (command == "export") {
+        if (files.size() != 1) {
+            PrintHelp(argv[0]);
+            return -1;
+        }
+        OpenGL::ShaderCachePackage package;
+        const std::size_t num_titles = package.AddInstalled(program_ids);
+        if (!package.Save(files[0], key)) {
+            return -1;
+        }
+        std::cout << fmt::format("Exported the shader caches of {} titles\n", num_titles);
+        return 0;
+    }
+
+    if (command == "merge") {
+        if (files.size() < 2) {
+            PrintHelp(argv[0]);
+            return -1;
+        }
+        // The packages to merge are checked again when they're imported, so any key is accepted
+        OpenGL::ShaderCachePackage merged;
+        for (auto path = files.begin() + 1; path != files.end(); ++path) {
+            const auto package = OpenGL::ShaderCachePackage::Load(*path);
+            if (!package || !merged.Merge(*package)) {
+                std::cout << "Failed to merge " << *path << "\n";
+                return -1;
+            }
+        }
+        if (!merged.Save(files[0], key)) {
+            return -1;
+        }
+        std::cout << fmt::format("Merged the shader caches of {} titles\n",
+                                 merged.GetTitles().size());
+        return 0;
+    }
+
+    if (command == "import") {
+        std::size_t num_titles = 0;
+        for (const std::string& path : files) {
+            const auto package = OpenGL::ShaderCachePackage::Load(path, key);
+            if (!package) {
+                std::cout << "Failed to import " << path << "\n";
+                return -1;
+            }
+            num_titles += package->Install();
+        }
+        std::cout << fmt::format("Installed the shader caches of {} titles\n", num_titles);
+        return 0;
+    }
+
+    PrintHelp(argv[0]);
+    return -1;
+}
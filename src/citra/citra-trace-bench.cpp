@@ -0,0 +1,395 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <glad/glad.h>
+#include "citra/emu_window/emu_window_sdl2.h"
+#include "common/benchmark_report.h"
+#include "common/common_types.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/scm_rev.h"
+#include "common/settings.h"
+#include "core/hw/gpu.h"
+#include "core/hw/hw.h"
+#include "core/memory.h"
+#include "core/tracer/reader.h"
+#include "video_core/command_processor.h"
+#include "video_core/pica.h"
+#include "video_core/pica_state.h"
+#include "video_core/renderer_base.h"
+#include "video_core/renderer_opengl/gl_vars.h"
+#include "video_core/video_core.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <trace.ctf>\n"
+                 "Replays a CiTrace recording offscreen and measures how the rasterizer keeps\n"
+                 "up. The command lists are processed as recorded, memory fills and display\n"
+                 "transfers are only replayed when the rasterizer accelerates them. The first\n"
+                 "pass starts with empty caches, the following passes reuse them.\n\n"
+                 "--software          Replay with the software rasterizer instead of OpenGL\n"
+                 "--passes            The number of times the trace is replayed\n"
+                 "--scale             The resolution scale factor of the OpenGL rasterizer\n"
+                 "--json              Writes the frame times to a JSON file for citra-bench\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra trace benchmark " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+namespace {
+
+/// Renderer that only provides the rasterizer, the replayed frames aren't presented
+class ReplayRenderer final : public RendererBase {
+public:
+    explicit ReplayRenderer(Frontend::EmuWindow& window) : RendererBase{window, nullptr} {
+        RefreshRasterizerSetting();
+    }
+
+    VideoCore::ResultStatus Init() override {
+        return VideoCore::ResultStatus::Success;
+    }
+    void ShutDown() override {}
+    void SwapBuffers() override {}
+    void TryPresent(int timeout_ms, bool is_secondary) override {}
+    void PrepareVideoDumping() override {}
+    void CleanupVideoDumping() override {}
+};
+
+/// Physical address of the GPU registers, as the recorder stores their writes
+constexpr PAddr GpuRegistersPAddr =
+    static_cast<PAddr>(HW::VADDR_GPU) - Memory::IO_AREA_VADDR + Memory::IO_AREA_PADDR;
+
+struct PassResult {
+    std::vector<u64> frame_times_ns;
+    u64 skipped_operations = 0;
+    VideoCore::RasterizerStatistics statistics;
+};
+
+template <typename T>
+void CopyWords(T& destination, const std::vector<u32>& words) {
+    std::memcpy(&destination, words.data(), std::min(sizeof(T), words.size() * sizeof(u32)));
+}
+
+/// Decodes float24 values stored with four words per vector, of which the first three are used
+template <std::size_t N>
+void CopyFloat24(Common::Vec4<Pica::float24> (&destination)[N], const std::vector<u32>& words) {
+    for (std::size_t i = 0; i < std::min(N, words.size() / 4); i++) {
+        for (std::size_t comp = 0; comp < 3; comp++) {
+            destination[i][comp] = Pica::float24::FromRaw(words[4 * i + comp]);
+        }
+    }
+}
+
+void RestoreInitialState(const CiTrace::Recorder::InitialState& state) {
+    CopyWords(GPU::g_regs, state.gpu_registers);
+    CopyWords(Pica::g_state.regs, state.pica_registers);
+    CopyFloat24(Pica::g_state.input_default_attributes.attr, state.default_attributes);
+
+    auto& vs = Pica::g_state.vs;
+    std::copy_n(state.vs_program_binary.begin(),
+                std::min(state.vs_program_binary.size(), vs.program_code.size()),
+                vs.program_code.begin());
+    std::copy_n(state.vs_swizzle_data.begin(),
+                std::min(state.vs_swizzle_data.size(), vs.swizzle_data.size()),
+                vs.swizzle_data.begin());
+    vs.MarkProgramCodeDirty();
+    vs.MarkSwizzleDataDirty();
+    CopyFloat24(vs.uniforms.f, state.vs_float_uniforms);
+
+    VideoCore::g_renderer->Rasterizer()->SyncEntireState();
+}
+
+/// Applies a recorded GPU register write, returns false if it triggered an operation that
+/// couldn't be replayed
+bool WriteGpuRegister(const CiTrace::CTRegisterWrite& write) {
+    if (write.size != CiTrace::CTRegisterWrite::SIZE_32 || write.physical_address < GpuRegistersPAddr) {
+        // Only the GPU registers written as words affect the rendering
+        return true;
+    }
+    const u32 index = (write.physical_address - GpuRegistersPAddr) / sizeof(u32);
+    if (index >= GPU::Regs::NumIds()) {
+        return true;
+    }
+    GPU::g_regs[index] = static_cast<u32>(write.value);
+
+    auto* rasterizer = VideoCore::g_renderer->Rasterizer();
+    switch (index) {
+    case GPU_REG_INDEX(memory_fill_config[0].trigger):
+    case GPU_REG_INDEX(memory_fill_config[1].trigger): {
+        const bool is_second_filler = index != GPU_REG_INDEX(memory_fill_config[0].trigger);
+        auto& config = GPU::g_regs.memory_fill_config[is_second_filler];
+        if (!config.trigger) {
+            return true;
+        }
+        config.trigger.Assign(0);
+        config.finished.Assign(1);
+        return rasterizer->AccelerateFill(config);
+    }
+    case GPU_REG_INDEX(display_transfer_config.trigger): {
+        auto& config = GPU::g_regs.display_transfer_config;
+        if (!(config.trigger & 1)) {
+            return true;
+        }
+        config.trigger = 0;
+        return config.is_texture_copy ? rasterizer->AccelerateTextureCopy(config)
+                                      : rasterizer->AccelerateDisplayTransfer(config);
+    }
+    case GPU_REG_INDEX(command_processor_config.trigger): {
+        auto& config = GPU::g_regs.command_processor_config;
+        if (config.trigger & 1) {
+            Pica::CommandProcessor::ProcessCommandList(config.GetPhysicalAddress(), config.size);
+            config.trigger = 0;
+        }
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+PassResult ReplayTrace(const CiTrace::Trace& trace, Memory::MemorySystem& memory, bool opengl) {
+    PassResult result;
+    auto* rasterizer = VideoCore::g_renderer->Rasterizer();
+    const VideoCore::RasterizerStatistics statistics_before = rasterizer->GetStatistics();
+    RestoreInitialState(trace.GetInitialState());
+
+    auto frame_start = Clock::now();
+    for (const auto& element : trace.GetElements()) {
+        switch (element.data.type) {
+        case CiTrace::MemoryLoad: {
+            // Only contents that changed are written, as the guest's writes would invalidate the
+            // caches
+            const PAddr address = element.data.memory_load.physical_address;
+            auto destination = memory.GetPhysicalRef(address);
+            if (!destination || destination.GetSize() < element.memory.size()) {
+                break;
+            }
+            if (std::memcmp(destination.GetPtr(), element.memory.data(), element.memory.size()) !=
+                0) {
+                std::memcpy(destination.GetPtr(), element.memory.data(), element.memory.size());
+                rasterizer->InvalidateRegion(address, static_cast<u32>(element.memory.size()));
+            }
+            break;
+        }
+        case CiTrace::RegisterWrite:
+            if (!WriteGpuRegister(element.data.register_write)) {
+                result.skipped_operations++;
+            }
+            break;
+        case CiTrace::FrameMarker: {
+            rasterizer->SubmitBatchedDraws();
+            if (opengl) {
+                // Include the time the GPU takes to render the frame
+                glFinish();
+            }
+            const auto frame_end = Clock::now();
+            result.frame_times_ns.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(frame_end - frame_start)
+                    .count());
+            frame_start = frame_end;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    const VideoCore::RasterizerStatistics statistics = rasterizer->GetStatistics();
+    result.statistics.draws = statistics.draws - statistics_before.draws;
+    result.statistics.surface_hits = statistics.surface_hits - statistics_before.surface_hits;
+    result.statistics.surface_misses =
+        statistics.surface_misses - statistics_before.surface_misses;
+    result.statistics.readback_bytes =
+        statistics.readback_bytes - statistics_before.readback_bytes;
+    result.statistics.shaders = statistics.shaders - statistics_before.shaders;
+    result.statistics.state_changes = statistics.state_changes - statistics_before.state_changes;
+    result.statistics.state_unchanged =
+        statistics.state_unchanged - statistics_before.state_unchanged;
+    result.statistics.frame_bytes = statistics.frame_bytes - statistics_before.frame_bytes;
+    result.statistics.frame_peak_bytes = statistics.frame_peak_bytes;
+    return result;
+}
+
+double Percentile(const std::vector<u64>& sorted_ns, double percentile) {
+    if (sorted_ns.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(percentile / 100.0 * (sorted_ns.size() - 1));
+    return sorted_ns[index] / 1e6;
+}
+
+void PrintPass(u32 pass, PassResult& result) {
+    std::vector<u64>& times = result.frame_times_ns;
+    u64 total_ns = 0;
+    for (const u64 time : times) {
+        total_ns += time;
+    }
+    std::sort(times.begin(), times.end());
+    const auto& statistics = result.statistics;
+    std::cout << fmt::format("Pass {}: {} frames, {} draws, {} shaders built\n", pass,
+                             times.size(), statistics.draws, statistics.shaders);
+    std::cout << fmt::format("  Frame time: avg {:.2f} ms, p50 {:.2f} ms, p99 {:.2f} ms, "
+                             "max {:.2f} ms\n",
+                             times.empty() ? 0.0 : total_ns / 1e6 / times.size(),
+                             Percentile(times, 50), Percentile(times, 99),
+                             Percentile(times, 100));
+    std::cout << fmt::format("  Surfaces: {} cache hits, {} created\n", statistics.surface_hits,
+                             statistics.surface_misses);
+    std::cout << fmt::format("  Readbacks: {:.1f} KiB from the GPU to guest memory\n",
+                             statistics.readback_bytes / 1024.0);
+    std::cout << fmt::format("  GL state: {} blocks changed, {} already set\n",
+                             statistics.state_changes, statistics.state_unchanged);
+    std::cout << fmt::format("  Frame data: {:.1f} KiB per frame, peak {:.1f} KiB\n",
+                             times.empty() ? 0.0 : statistics.frame_bytes / 1024.0 / times.size(),
+                             statistics.frame_peak_bytes / 1024.0);
+    if (result.skipped_operations != 0) {
+        std::cout << fmt::format("  {} memory fills and display transfers weren't replayed\n",
+                                 result.skipped_operations);
+    }
+}
+
+void ReportPass(u32 pass, const PassResult& result, Common::BenchmarkReport& report) {
+    const std::string metric = fmt::format("pass{}/frame_time", pass);
+    for (const u64 time : result.frame_times_ns) {
+        report.AddSample(metric, "ms", Common::BenchmarkReport::Better::Lower, time / 1e6);
+    }
+    report.AddSample(fmt::format("pass{}/readback", pass), "KiB",
+                     Common::BenchmarkReport::Better::Lower,
+                     result.statistics.readback_bytes / 1024.0);
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    bool software = false;
+    u32 passes = 2;
+    u32 scale = 1;
+    std::string json_path;
+
+    static struct option long_options[] = {
+        {"software", no_argument, 0, 's'},
+        {"passes", required_argument, 0, 'p'},
+        {"scale", required_argument, 0, 'r'},
+        {"json", required_argument, 0, 'j'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    std::string filepath;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "sp:r:j:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 's':
+                software = true;
+                break;
+            case 'p':
+                passes = strtoul(optarg, &endarg, 0);
+                break;
+            case 'r':
+                scale = strtoul(optarg, &endarg, 0);
+                break;
+            case 'j':
+                json_path = optarg;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            filepath = argv[optind];
+            optind++;
+        }
+    }
+
+    if (filepath.empty()) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (passes == 0 || scale == 0 || scale > 10) {
+        std::cout << "passes needs to be at least 1 and scale in the range 1 - 10!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    Log::Filter log_filter(Log::Level::Warning);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    const auto trace = CiTrace::Trace::Load(filepath);
+    if (!trace) {
+        std::cout << "Failed to load the trace!\n";
+        return -1;
+    }
+
+    // The caches shared with other runs would hide the shader compilations
+    Settings::values.use_hw_renderer = !software;
+    Settings::values.use_disk_shader_cache = false;
+    Settings::values.use_async_gpu_emulation = false;
+    Settings::values.resolution_factor = static_cast<u16>(scale);
+    Settings::Apply();
+
+    Common::BenchmarkReport report{"citra-trace-bench"};
+    report.AddConfig("trace", filepath);
+    report.AddConfig("rasterizer", software ? "software" : "opengl");
+    report.AddConfig("scale", std::to_string(scale));
+
+    EmuWindow_SDL2::InitializeSDL2(true);
+    {
+        EmuWindow_SDL2 emu_window{false, false, true};
+        emu_window.MakeCurrent();
+        OpenGL::GLES = Settings::values.use_gles.GetValue();
+
+        Memory::MemorySystem memory;
+        VideoCore::g_memory = &memory;
+        Pica::Init();
+        VideoCore::g_renderer = std::make_unique<ReplayRenderer>(emu_window);
+
+        std::cout << fmt::format("Replaying {} stream elements with the {} rasterizer...\n",
+                                 trace->GetElements().size(), software ? "software" : "OpenGL");
+        for (u32 pass = 1; pass <= passes; pass++) {
+            PassResult result = ReplayTrace(*trace, memory, !software);
+            ReportPass(pass, result, report);
+            PrintPass(pass, result);
+        }
+
+        Pica::Shutdown();
+        VideoCore::g_renderer.reset();
+        VideoCore::g_memory = nullptr;
+        emu_window.DoneCurrent();
+    }
+
+    if (!json_path.empty() && !report.Save(json_path)) {
+        return -1;
+    }
+    return 0;
+}
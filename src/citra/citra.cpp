@@ -24,6 +24,7 @@
 #include "common/scope_exit.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/dumping/backend.h"
 #include "core/file_sys/cia_container.h"
@@ -35,6 +36,7 @@
 #include "core/hle/service/cfg/cfg.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/telemetry_session.h"
 #include "input_common/main.h"
 #include "network/network.h"
 #include "video_core/renderer_base.h"
@@ -69,6 +71,11 @@ static void PrintHelp(const char* argv0) {
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
                  "-d, --dump-video=[file]    Dumps audio and video to the given video file\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
+                 "--headless           Run without showing a window or limiting the frame rate\n"
+                 "--frames=NUMBER      Exit after NUMBER frames have been emulated\n"
+                 "--virtual-time       Advance the 3DS clock only with the emulation, starting at\n"
+                 "                     init_time, and run as fast as possible\n"
+                 "--deterministic      Only depend on the emulated time, for reproducible runs\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
 }
@@ -215,6 +222,10 @@ int main(int argc, char** argv) {
 
     bool use_multiplayer = false;
     bool fullscreen = false;
+    bool headless = false;
+    bool use_virtual_time = false;
+    bool deterministic = false;
+    u64 frame_count = 0;
     std::string nickname{};
     std::string password{};
     std::string address{};
@@ -229,6 +240,10 @@ int main(int argc, char** argv) {
         {"movie-play", required_argument, 0, 'p'},
         {"dump-video", required_argument, 0, 'd'},
         {"fullscreen", no_argument, 0, 'f'},
+        {"headless", no_argument, 0, 'n'},
+        {"frames", required_argument, 0, 'c'},
+        {"virtual-time", no_argument, 0, 't'},
+        {"deterministic", no_argument, 0, 'e'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -308,6 +323,25 @@ int main(int argc, char** argv) {
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
                 break;
+            case 'n':
+                headless = true;
+                break;
+            case 't':
+                use_virtual_time = true;
+                break;
+            case 'e':
+                deterministic = true;
+                break;
+            case 'c':
+                errno = 0;
+                frame_count = strtoull(optarg, &endarg, 0);
+                if (endarg == optarg)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--frames");
+                    exit(1);
+                }
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -330,6 +364,8 @@ int main(int argc, char** argv) {
 #endif
 
     MicroProfileOnThreadCreate("EmuThread");
+    // Only the trace track is named, the name of the main thread is the name of the process
+    Common::Trace::SetCurrentThreadName("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
 
     if (filepath.empty()) {
@@ -352,6 +388,18 @@ int main(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (headless) {
+        // Nothing presents the frames, so the renderer mustn't wait for them to be consumed, and
+        // the emulation runs as fast as the host allows
+        Settings::values.frame_limit.SetValue(0);
+        Settings::values.present_mode = Settings::PresentMode::Mailbox;
+    }
+    if (use_virtual_time) {
+        Settings::values.use_virtual_time = true;
+    }
+    if (deterministic) {
+        Settings::values.deterministic = true;
+    }
     Settings::Apply();
 
     // Register frontend applets
@@ -360,13 +408,13 @@ int main(int argc, char** argv) {
     // Register generic image interface
     Core::System::GetInstance().RegisterImageInterface(std::make_shared<LodePNGImageInterface>());
 
-    EmuWindow_SDL2::InitializeSDL2();
+    EmuWindow_SDL2::InitializeSDL2(headless);
 
-    const auto emu_window{std::make_unique<EmuWindow_SDL2>(fullscreen, false)};
+    const auto emu_window{std::make_unique<EmuWindow_SDL2>(fullscreen, false, headless)};
     const bool use_secondary_window{Settings::values.layout_option.GetValue() ==
                                     Settings::LayoutOption::SeparateWindows};
     const auto secondary_window =
-        use_secondary_window ? std::make_unique<EmuWindow_SDL2>(false, true) : nullptr;
+        use_secondary_window ? std::make_unique<EmuWindow_SDL2>(false, true, headless) : nullptr;
 
     Frontend::ScopeAcquireContext scope(*emu_window);
 
@@ -444,9 +492,13 @@ int main(int argc, char** argv) {
         system.VideoDumper().StartDumping(dump_video, layout);
     }
 
-    std::thread main_render_thread([&emu_window] { emu_window->Present(); });
-    std::thread secondary_render_thread([&secondary_window] {
-        if (secondary_window) {
+    std::thread main_render_thread([&emu_window, headless] {
+        if (!headless) {
+            emu_window->Present();
+        }
+    });
+    std::thread secondary_render_thread([&secondary_window, headless] {
+        if (secondary_window && !headless) {
             secondary_window->Present();
         }
     });
@@ -475,6 +527,14 @@ int main(int argc, char** argv) {
             LOG_ERROR(Frontend, "Error in main run loop: {}", result, system.GetStatusDetails());
             break;
         }
+
+        // The frame count only advances with the emulated time, so a run stops at the same point
+        // regardless of the host speed
+        if (frame_count != 0 &&
+            static_cast<u64>(system.Renderer().GetCurrentFrame()) >= frame_count) {
+            LOG_INFO(Frontend, "Emulated {} frames, exiting", frame_count);
+            emu_window->RequestClose();
+        }
     }
     emu_window->RequestClose();
     if (secondary_window) {
@@ -493,6 +553,7 @@ int main(int argc, char** argv) {
 
     system.Shutdown();
 
+    Core::ShutdownWebService();
     detached_tasks.WaitForAllTasks();
     return 0;
 }
@@ -102,11 +102,26 @@ void Config::ReadValues() {
     Settings::values.current_input_profile.udp_input_port =
         static_cast<u16>(sdl2_config->GetInteger("Controls", "udp_input_port",
                                                  InputCommon::CemuhookUDP::DEFAULT_PORT));
+    Settings::values.input_polling_rate =
+        static_cast<u32>(sdl2_config->GetInteger("Controls", "input_polling_rate", 0));
 
     // Core
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
+    Settings::values.use_fastmem = sdl2_config->GetBoolean("Core", "use_fastmem", true);
+    Settings::values.use_huge_pages = sdl2_config->GetBoolean("Core", "use_huge_pages", false);
+    Settings::values.use_multi_core = sdl2_config->GetBoolean("Core", "use_multi_core", false);
+    Settings::values.skip_idle_loops = sdl2_config->GetBoolean("Core", "skip_idle_loops", true);
     Settings::values.cpu_clock_percentage =
         sdl2_config->GetInteger("Core", "cpu_clock_percentage", 100);
+    Settings::values.rewind_interval =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "rewind_interval", 0));
+    Settings::values.rewind_buffer_size =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "rewind_buffer_size", 256));
+    Settings::values.boot_snapshot_time =
+        static_cast<u32>(sdl2_config->GetInteger("Core", "boot_snapshot_time", 0));
+    Settings::values.use_perf_profiles =
+        sdl2_config->GetBoolean("Core", "use_perf_profiles", true);
+    Settings::values.tune_performance = sdl2_config->GetBoolean("Core", "tune_performance", false);
 
     // Renderer
     Settings::values.use_gles = sdl2_config->GetBoolean("Renderer", "use_gles", false);
@@ -122,12 +137,26 @@ void Config::ReadValues() {
     Settings::values.shaders_accurate_mul =
         sdl2_config->GetBoolean("Renderer", "shaders_accurate_mul", true);
     Settings::values.use_shader_jit = sdl2_config->GetBoolean("Renderer", "use_shader_jit", true);
+    Settings::values.use_async_gpu_emulation =
+        sdl2_config->GetBoolean("Renderer", "use_async_gpu_emulation", false);
+    Settings::values.sw_rasterizer_threads =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "sw_rasterizer_threads", 1));
+    Settings::values.vertex_shader_threads =
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "vertex_shader_threads", 1));
+    Settings::values.async_shader_compilation =
+        sdl2_config->GetBoolean("Renderer", "async_shader_compilation", false);
+    Settings::values.use_gpu_texture_decode =
+        sdl2_config->GetBoolean("Renderer", "use_gpu_texture_decode", false);
+    Settings::values.present_mode = static_cast<Settings::PresentMode>(
+        sdl2_config->GetInteger("Renderer", "present_mode", 0));
     Settings::values.resolution_factor =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "resolution_factor", 1));
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
     Settings::values.frame_limit =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit", 100));
+    Settings::values.frame_skip =
+        static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_skip", 0));
     Settings::values.use_vsync_new =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "use_vsync_new", 1));
     Settings::values.texture_filter_name =
@@ -183,10 +212,19 @@ void Config::ReadValues() {
     Settings::values.custom_textures = sdl2_config->GetBoolean("Utility", "custom_textures", false);
     Settings::values.preload_textures =
         sdl2_config->GetBoolean("Utility", "preload_textures", false);
+    Settings::values.async_custom_loading =
+        sdl2_config->GetBoolean("Utility", "async_custom_loading", true);
+    Settings::values.custom_textures_cache_size =
+        static_cast<u32>(sdl2_config->GetInteger("Utility", "custom_textures_cache_size", 1024));
+    Settings::values.share_custom_textures =
+        sdl2_config->GetBoolean("Utility", "share_custom_textures", false);
 
     // Audio
     Settings::values.audio_emulation = static_cast<Settings::AudioEmulation>(
         sdl2_config->GetInteger("Audio", "audio_emulation", 0));
+    Settings::values.lle_dsp_run_ahead =
+        static_cast<u32>(sdl2_config->GetInteger("Audio", "lle_dsp_run_ahead", 0));
+    Settings::values.headless_dsp = sdl2_config->GetBoolean("Audio", "headless_dsp", false);
     Settings::values.sink_id = sdl2_config->GetString("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
@@ -217,6 +255,9 @@ void Config::ReadValues() {
         sdl2_config->GetInteger("System", "region_value", Settings::REGION_VALUE_AUTO_SELECT);
     Settings::values.init_clock =
         static_cast<Settings::InitClock>(sdl2_config->GetInteger("System", "init_clock", 1));
+    Settings::values.use_virtual_time =
+        sdl2_config->GetBoolean("System", "use_virtual_time", false);
+    Settings::values.deterministic = sdl2_config->GetBoolean("System", "deterministic", false);
     {
         std::tm t;
         t.tm_sec = 1;
@@ -353,6 +394,12 @@ void Config::ReadValues() {
         sdl2_config->GetString("Video Dumping", "video_encoder_options", default_video_options);
     Settings::values.video_bitrate =
         sdl2_config->GetInteger("Video Dumping", "video_bitrate", 2500000);
+    Settings::values.video_gpu_conversion =
+        sdl2_config->GetBoolean("Video Dumping", "video_gpu_conversion", true);
+    Settings::values.video_drop_frames =
+        sdl2_config->GetBoolean("Video Dumping", "video_drop_frames", false);
+    Settings::values.video_separate_screens =
+        sdl2_config->GetBoolean("Video Dumping", "video_separate_screens", false);
 
     Settings::values.audio_encoder =
         sdl2_config->GetString("Video Dumping", "audio_encoder", "libvorbis");
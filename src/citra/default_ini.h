@@ -86,17 +86,67 @@ udp_input_port=
 # The pad to request data on. Should be between 0 (Pad 1) and 3 (Pad 4). (Default 0)
 udp_pad_index=
 
+# Rate, in Hz, at which the input devices are sampled on a dedicated thread. Higher rates lower
+# the input latency, as the emulated HID module always reads the most recent sample.
+# 0 (default): Sample the devices on the emulation thread, 1000: Recommended when enabled
+input_polling_rate=
+
 [Core]
 # Whether to use the Just-In-Time (JIT) compiler for CPU emulation
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether the JIT accesses guest memory directly through a host mapping of the address space
+# Only takes effect on hosts with 4 KiB pages. 0: Off, 1 (default): On
+use_fastmem =
+
+# Whether to back the guest memory with huge pages of the host, which reduces TLB misses.
+# Linux needs transparent huge pages enabled for shared memory (shmem_enabled), Windows needs the
+# Lock Pages in Memory privilege. Falls back to normal pages. 0 (default): Off, 1: On
+use_huge_pages =
+
+# Whether to run each emulated CPU core on its own host thread. Requires the JIT.
+# Faster on multi-core hosts, but emulation is no longer deterministic (e.g. for movies).
+# 0 (default): Off, 1: On
+use_multi_core =
+
+# Whether to fast-forward to the next event when a thread spins polling the kernel
+# (e.g. svcWaitSynchronization with a zero timeout or svcSleepThread(0)). Reduces host CPU usage.
+# 0: Off, 1 (default): On
+skip_idle_loops =
+
 # Change the Clock Frequency of the emulated 3DS CPU.
 # Underclocking can increase the performance of the game at the risk of freezing.
 # Overclocking may fix lag that happens on console, but also comes with the risk of freezing.
 # Range is any positive integer (but we suspect 25 - 400 is a good idea) Default is 100
 cpu_clock_percentage =
 
+# How often a snapshot for rewinding is taken, in milliseconds of emulated time.
+# Rewinding keeps a copy of the emulated memory in addition to the snapshots.
+# 0 (default): Rewinding disabled
+rewind_interval =
+
+# The memory used by the older rewind snapshots in MiB, the oldest ones are dropped when it is full
+# Default is 256
+rewind_buffer_size =
+
+# Takes a snapshot of each title this many milliseconds of emulated time after it booted, later
+# boots of the title resume from it instead. The snapshot is taken again when the ROM file, the
+# emulator version or the settings affecting the boot change. Not supported with LLE audio.
+# 0 (default): Boot snapshots disabled
+boot_snapshot_time =
+
+# Applies the settings measured as the fastest for a title, from the perf_profiles folder of the
+# config directory. Settings configured for a title take precedence.
+# 0: Disabled, 1 (default): Enabled
+use_perf_profiles =
+
+# Measures the speed of candidate settings while a title runs, and saves the fastest ones that
+# don't slow the game down as its performance profile. Stay in one scene while it runs, or play a
+# movie. Settings lowering accuracy or resolution are only used if the title is too slow otherwise.
+# 0 (default): Disabled, 1: Enabled
+tune_performance =
+
 [Renderer]
 # Whether to render using GLES or OpenGL
 # 0 (default): OpenGL, 1: GLES
@@ -122,6 +172,34 @@ shaders_accurate_mul =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Whether to process GPU commands on a dedicated thread, overlapping CPU and GPU emulation
+# 0 (default): Off, 1: On
+use_async_gpu_emulation =
+
+# Number of threads used by the software renderer to rasterize triangles
+# 0: Auto (one per host CPU), 1 (default): Single threaded, 2 or more: Number of threads
+sw_rasterizer_threads =
+
+# Number of threads used to run vertex shaders on the CPU, when hardware shaders are not in use
+# 0: Auto (one per host CPU), 1 (default): Single threaded, 2 or more: Number of threads
+vertex_shader_threads =
+
+# Whether to build fragment shaders in the background, rendering with a generic shader meanwhile
+# Only takes effect with separable shaders (desktop OpenGL)
+# 0 (default): Off, 1: On
+async_shader_compilation =
+
+# Whether to decode ETC1 textures on the GPU instead of the CPU
+# Ignored while textures are being dumped or replaced
+# 0 (default): Off, 1: On
+use_gpu_texture_decode =
+
+# How rendered frames are handed over to the display
+# 0 (default): Mailbox, presents the latest frame and drops older ones
+# 1: FIFO, presents every frame in order, emulation waits when the display falls behind
+# 2: Immediate, like Mailbox but without waiting for VSync
+present_mode =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
@@ -144,6 +222,11 @@ texture_filter_name =
 # 5 - 995: Speed limit as a percentage of target game speed. 0 for unthrottled. 100 (default)
 frame_limit =
 
+# Number of frames whose presentation is skipped between two presented ones while unthrottled.
+# The skipped frames are still emulated, only drawing them to the screen is left out.
+# 0 (default): Present every frame, N: Present one out of every N + 1 frames
+frame_skip =
+
 # Overrides the frame limiter to use frame_limit_alternate instead of frame_limit.
 # 0: Off (default), 1: On
 use_frame_limit_alternate =
@@ -173,6 +256,7 @@ mono_render_option =
 # The name of the post processing shader to apply.
 # Loaded from shaders if render_3d is off or side by side.
 # Loaded from shaders/anaglyph if render_3d is anaglyph
+# A <name>.preset file in shaders chains several shaders, and can run passes at a reduced scale
 pp_shader_name =
 
 # Whether to enable linear filtering or not
@@ -225,14 +309,36 @@ custom_textures =
 # 0 (default): Off, 1: On
 preload_textures =
 
-[Audio]
-# Whether or not to enable DSP LLE
-# 0 (default): No, 1: Yes
-enable_dsp_lle =
+# Decodes custom textures in the background, the original texture is shown until it is ready.
+# 0: Off, 1 (default): On
+async_custom_loading =
 
-# Whether or not to run DSP LLE on a different thread
-# 0 (default): No, 1: Yes
-enable_dsp_lle_thread =
+# Memory budget in MiB for decoded custom textures that were not preloaded.
+# The least recently used textures are freed first. 1024 (default)
+custom_textures_cache_size =
+
+# Stores decoded custom textures in custom_textures/[Title ID]/ of the cache directory and maps
+# them from there, so that instances running at the same time share their memory.
+# Uses 4 bytes of disk space per texel.
+# 0 (default): Off, 1: On
+share_custom_textures =
+
+[Audio]
+# Which audio emulation to use
+# 0 (default): HLE, 1: LLE, 2: LLE on a separate thread,
+# 3: HLE mixing on a separate thread, one frame behind the emulated DSP
+audio_emulation =
+
+# How many DSP slices (about 0.12ms each) LLE on a separate thread may run ahead of the emulated CPU
+# between their interactions. Higher values let both threads run without waiting for each other,
+# at the cost of timing accuracy.
+# 0 (default): Lockstep, up to 64
+lle_dsp_run_ahead =
+
+# Whether HLE only emulates the DSP state visible to the application, skipping the decoding and
+# mixing of the audio. There is no sound, but it saves CPU time when the audio isn't needed.
+# 0 (default): Off, 1: On
+headless_dsp =
 
 
 # Which audio output engine to use.
@@ -288,6 +394,17 @@ init_clock =
 # Note: 3DS can only handle times later then Jan 1 2000
 init_time =
 
+# Whether the clock of the 3DS only advances with the emulation, starting at init_time, and the
+# emulation runs as fast as possible. Makes runs independent of the speed of the host.
+# 0 (default): Off, 1: On
+use_virtual_time =
+
+# Whether the emulation only depends on the emulated time, for reproducible runs. Turns on
+# use_virtual_time and off the options running emulation work on other threads, e.g. multi core
+# and async GPU emulation, and warns about the inputs that remain nondeterministic.
+# 0 (default): Off, 1: On
+deterministic =
+
 [Camera]
 # Which camera engine to use for the right outer camera
 # blank (default): a dummy camera that always returns black image
@@ -351,6 +468,19 @@ video_encoder_options =
 # Video bitrate, default: 2500000
 video_bitrate =
 
+# Converts the frames to the pixel format of the video encoder on the GPU, when it is YUV420P
+# 0: Off (convert on the CPU), 1 (default): On
+video_gpu_conversion =
+
+# What to do when the video encoder falls behind
+# 0 (default): Slow down the emulation, 1: Drop frames, keeping the video in sync with the audio
+video_drop_frames =
+
+# Dumps the top and bottom screens as separate video streams at the internal resolution,
+# regardless of the screen layout
+# 0 (default): Off, 1: On
+video_separate_screens =
+
 # Audio encoder used, default: libvorbis
 audio_encoder =
 
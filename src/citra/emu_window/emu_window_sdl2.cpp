@@ -135,7 +135,8 @@ void EmuWindow_SDL2::Fullscreen() {
     SDL_MaximizeWindow(render_window);
 }
 
-EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool is_secondary) : EmuWindow(is_secondary) {
+EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool is_secondary, bool headless)
+    : EmuWindow(is_secondary) {
     // Initialize the window
     if (Settings::values.use_gles) {
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
@@ -155,8 +156,13 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool is_secondary) : EmuWindow(i
     // Enable context sharing for the shared context
     SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
     // Enable vsync
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(
+        Settings::values.present_mode.GetValue() != Settings::PresentMode::Immediate ? 1 : 0);
 
+    // A headless window is never shown, the frames stay in the renderer's framebuffers
+    const u32 window_flags = headless ? SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN
+                                      : SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE |
+                                            SDL_WINDOW_ALLOW_HIGHDPI;
     std::string window_title = fmt::format("Citra {} | {}-{}", Common::g_build_fullname,
                                            Common::g_scm_branch, Common::g_scm_desc);
     render_window =
@@ -164,7 +170,7 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool is_secondary) : EmuWindow(i
                          SDL_WINDOWPOS_UNDEFINED, // x position
                          SDL_WINDOWPOS_UNDEFINED, // y position
                          Core::kScreenTopWidth, Core::kScreenTopHeight + Core::kScreenBottomHeight,
-                         SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+                         window_flags);
 
     if (render_window == nullptr) {
         LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
@@ -174,7 +180,7 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool is_secondary) : EmuWindow(i
     dummy_window = SDL_CreateWindow(NULL, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 0, 0,
                                     SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL);
 
-    if (fullscreen) {
+    if (fullscreen && !headless) {
         Fullscreen();
     }
 
@@ -210,7 +216,12 @@ EmuWindow_SDL2::~EmuWindow_SDL2() {
     SDL_Quit();
 }
 
-void EmuWindow_SDL2::InitializeSDL2() {
+void EmuWindow_SDL2::InitializeSDL2(bool headless) {
+    if (headless) {
+        // The offscreen driver renders to EGL pbuffers, which don't need an X11 or Wayland
+        // display. Set through the environment, as the hint is only read by newer SDL versions.
+        SDL_setenv("SDL_VIDEODRIVER", "offscreen", 1);
+    }
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0) {
         LOG_CRITICAL(Frontend, "Failed to initialize SDL2: {}! Exiting...", SDL_GetError());
         exit(1);
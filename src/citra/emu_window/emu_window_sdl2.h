@@ -29,10 +29,12 @@ private:
 
 class EmuWindow_SDL2 : public Frontend::EmuWindow {
 public:
-    explicit EmuWindow_SDL2(bool fullscreen, bool is_secondary);
+    explicit EmuWindow_SDL2(bool fullscreen, bool is_secondary, bool headless);
     ~EmuWindow_SDL2();
 
-    static void InitializeSDL2();
+    /// Initializes SDL2, using the offscreen video driver when headless so that no display is
+    /// needed
+    static void InitializeSDL2(bool headless);
 
     void Present();
 
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <QApplication>
 #include <QDragEnterEvent>
 #include <QHBoxLayout>
@@ -16,6 +17,7 @@
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
+#include "common/thread.h"
 #include "core/3ds.h"
 #include "core/core.h"
 #include "core/frontend/scope_acquire_context.h"
@@ -44,6 +46,7 @@ static GMainWindow* GetMainWindow() {
 
 void EmuThread::run() {
     MicroProfileOnThreadCreate("EmuThread");
+    Common::SetCurrentThreadName("EmuThread");
     Frontend::ScopeAcquireContext scope(core_context);
 
     emit LoadProgress(VideoCore::LoadCallbackStage::Prepare, 0, 0);
@@ -113,6 +116,63 @@ void EmuThread::run() {
 #endif
 }
 
+PresentThread::PresentThread(OpenGLWindow& window, QOpenGLContext& context, bool is_secondary)
+    : window{window}, context{context}, is_secondary{is_secondary} {}
+
+PresentThread::~PresentThread() {
+    Stop();
+}
+
+void PresentThread::run() {
+    MicroProfileOnThreadCreate("PresentThread");
+    Common::SetCurrentThreadName(is_secondary ? "PresentThread2" : "PresentThread");
+
+    while (true) {
+        {
+            std::unique_lock lock{mutex};
+            cv.wait(lock, [this] { return exposed || stop_run; });
+            if (!VideoCore::g_renderer) {
+                // Nothing is emulated, so only the background is drawn now and then
+                cv.wait_for(lock, std::chrono::milliseconds(100), [this] { return stop_run; });
+            }
+            if (stop_run) {
+                break;
+            }
+        }
+
+        context.makeCurrent(&window);
+        if (VideoCore::g_renderer) {
+            VideoCore::g_renderer->TryPresent(100, is_secondary);
+        }
+        context.swapBuffers(&window);
+        auto f = context.versionFunctions<QOpenGLFunctions_4_3_Core>();
+        f->glFinish();
+    }
+
+    // Hand the context back to the UI thread, which destroys it
+    context.doneCurrent();
+    context.moveToThread(QCoreApplication::instance()->thread());
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+void PresentThread::SetExposed(bool exposed_) {
+    std::scoped_lock lock{mutex};
+    exposed = exposed_;
+    cv.notify_all();
+}
+
+void PresentThread::Stop() {
+    {
+        std::scoped_lock lock{mutex};
+        stop_run = true;
+        cv.notify_all();
+    }
+    wait();
+}
+
 OpenGLWindow::OpenGLWindow(QWindow* parent, QWidget* event_handler, QOpenGLContext* shared_context,
                            bool is_secondary)
     : QWindow(parent), context(std::make_unique<QOpenGLContext>(shared_context->parent())),
@@ -120,7 +180,9 @@ OpenGLWindow::OpenGLWindow(QWindow* parent, QWidget* event_handler, QOpenGLConte
 
     // disable vsync for any shared contexts
     auto format = shared_context->format();
-    format.setSwapInterval(Settings::values.use_vsync_new ? 1 : 0);
+    const bool vsync = Settings::values.use_vsync_new.GetValue() &&
+                       Settings::values.present_mode.GetValue() != Settings::PresentMode::Immediate;
+    format.setSwapInterval(vsync ? 1 : 0);
     this->setFormat(format);
 
     context->setShareContext(shared_context);
@@ -130,16 +192,26 @@ OpenGLWindow::OpenGLWindow(QWindow* parent, QWidget* event_handler, QOpenGLConte
 
     setSurfaceType(QWindow::OpenGLSurface);
 
+    if (QOpenGLContext::supportsThreadedOpenGL()) {
+        present_thread = std::make_unique<PresentThread>(*this, *context, is_secondary);
+        context->moveToThread(present_thread.get());
+        present_thread->start();
+    }
+
     // TODO: One of these flags might be interesting: WA_OpaquePaintEvent, WA_NoBackground,
     // WA_DontShowOnScreen, WA_DeleteOnClose
 }
 
 OpenGLWindow::~OpenGLWindow() {
-    context->doneCurrent();
+    if (present_thread) {
+        present_thread->Stop();
+    } else {
+        context->doneCurrent();
+    }
 }
 
 void OpenGLWindow::Present() {
-    if (!isExposed())
+    if (present_thread || !isExposed())
         return;
 
     context->makeCurrent(this);
@@ -152,6 +224,12 @@ void OpenGLWindow::Present() {
     QWindow::requestUpdate();
 }
 
+void OpenGLWindow::StopPresenting() {
+    if (present_thread) {
+        present_thread->Stop();
+    }
+}
+
 bool OpenGLWindow::event(QEvent* event) {
     switch (event->type()) {
     case QEvent::UpdateRequest:
@@ -193,7 +271,11 @@ bool OpenGLWindow::event(QEvent* event) {
 }
 
 void OpenGLWindow::exposeEvent(QExposeEvent* event) {
-    QWindow::requestUpdate();
+    if (present_thread) {
+        present_thread->SetExposed(isExposed());
+    } else {
+        QWindow::requestUpdate();
+    }
     QWindow::exposeEvent(event);
 }
 
@@ -420,6 +502,7 @@ void GRenderWindow::ReleaseRenderTarget() {
         layout()->removeWidget(child_widget);
         delete child_widget;
         child_widget = nullptr;
+        child_window = nullptr;
     }
 }
 
@@ -713,6 +796,10 @@ void GRenderWindow::OnEmulationStarting(EmuThread* emu_thread) {
 
 void GRenderWindow::OnEmulationStopping() {
     emu_thread = nullptr;
+    // The renderer is destroyed with the emulation, so it can't be presented from anymore
+    if (child_window) {
+        child_window->StopPresenting();
+    }
 }
 
 void GRenderWindow::showEvent(QShowEvent* event) {
@@ -22,6 +22,7 @@ class QOpenGLContext;
 
 class GMainWindow;
 class GRenderWindow;
+class OpenGLWindow;
 
 namespace VideoCore {
 enum class LoadCallbackStage;
@@ -126,6 +127,36 @@ signals:
     void HideLoadingScreen();
 };
 
+/**
+ * Presents the frames of the renderer to a window from its own thread, so that the stalls of the Qt
+ * event loop, e.g. while opening a dialog or refreshing the game list, hold up neither the
+ * presentation nor, waiting on free frames, the emulation.
+ */
+class PresentThread final : public QThread {
+public:
+    explicit PresentThread(OpenGLWindow& window, QOpenGLContext& context, bool is_secondary);
+    ~PresentThread() override;
+
+    void run() override;
+
+    /// Sets whether the window is exposed, presentation pauses while it isn't
+    /// @note This function is thread-safe
+    void SetExposed(bool exposed);
+
+    /// Stops presenting and waits for the thread to exit
+    void Stop();
+
+private:
+    OpenGLWindow& window;
+    QOpenGLContext& context;
+    bool is_secondary;
+
+    bool exposed = false;
+    bool stop_run = false;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
 class OpenGLWindow : public QWindow {
     Q_OBJECT
 public:
@@ -136,12 +167,17 @@ public:
 
     void Present();
 
+    /// Stops the presentation thread, before the renderer is destroyed
+    void StopPresenting();
+
 protected:
     bool event(QEvent* event) override;
     void exposeEvent(QExposeEvent* event) override;
 
 private:
     std::unique_ptr<QOpenGLContext> context;
+    /// Presents instead of the UI thread, if the platform supports threaded OpenGL
+    std::unique_ptr<PresentThread> present_thread;
     QWidget* event_handler;
     bool is_secondary;
 };
@@ -227,7 +263,7 @@ private:
     QByteArray geometry;
 
     /// Native window handle that backs this presentation widget
-    QWindow* child_window = nullptr;
+    OpenGLWindow* child_window = nullptr;
 
     /// In order to embed the window into GRenderWindow, you need to use createWindowContainer to
     /// put the child_window into a widget then add it to the layout. This child_widget can be
@@ -56,7 +56,7 @@ const std::array<std::array<int, 5>, Settings::NativeAnalog::NumAnalogs> Config:
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 24> default_hotkeys{
+const std::array<UISettings::Shortcut, 26> default_hotkeys{
     {{QStringLiteral("Advance Frame"),            QStringLiteral("Main Window"), {QStringLiteral("\\"), Qt::ApplicationShortcut}},
      {QStringLiteral("Capture Screenshot"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+P"), Qt::ApplicationShortcut}},
      {QStringLiteral("Continue/Pause Emulation"), QStringLiteral("Main Window"), {QStringLiteral("F4"), Qt::WindowShortcut}},
@@ -71,7 +71,9 @@ const std::array<UISettings::Shortcut, 24> default_hotkeys{
      {QStringLiteral("Mute Audio"),               QStringLiteral("Main Window"), {QStringLiteral("Ctrl+M"), Qt::WindowShortcut}},
      {QStringLiteral("Remove Amiibo"),            QStringLiteral("Main Window"), {QStringLiteral("F3"), Qt::ApplicationShortcut}},
      {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"), Qt::WindowShortcut}},
+     {QStringLiteral("Rewind"),                   QStringLiteral("Main Window"), {QStringLiteral("Ctrl+R"), Qt::WindowShortcut}},
      {QStringLiteral("Rotate Screens Upright"),   QStringLiteral("Main Window"), {QStringLiteral("F8"), Qt::WindowShortcut}},
+     {QStringLiteral("Save Trace"),               QStringLiteral("Main Window"), {QStringLiteral("Ctrl+T"), Qt::ApplicationShortcut}},
      {QStringLiteral("Save to Oldest Slot"),      QStringLiteral("Main Window"), {QStringLiteral("Ctrl+C"), Qt::WindowShortcut}},
      {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"), Qt::WindowShortcut}},
      {QStringLiteral("Swap Screens"),             QStringLiteral("Main Window"), {QStringLiteral("F9"), Qt::WindowShortcut}},
@@ -244,6 +246,8 @@ void Config::ReadAudioValues() {
     qt_config->beginGroup(QStringLiteral("Audio"));
 
     ReadGlobalSetting(Settings::values.audio_emulation);
+    ReadBasicSetting(Settings::values.lle_dsp_run_ahead);
+    ReadBasicSetting(Settings::values.headless_dsp);
     ReadGlobalSetting(Settings::values.enable_audio_stretching);
     ReadGlobalSetting(Settings::values.volume);
 
@@ -403,6 +407,8 @@ void Config::ReadControlValues() {
 
     Settings::LoadProfile(Settings::values.current_input_profile_index);
 
+    ReadBasicSetting(Settings::values.input_polling_rate);
+
     qt_config->endGroup();
 }
 
@@ -412,6 +418,9 @@ void Config::ReadUtilityValues() {
     ReadBasicSetting(Settings::values.dump_textures);
     ReadBasicSetting(Settings::values.custom_textures);
     ReadBasicSetting(Settings::values.preload_textures);
+    ReadBasicSetting(Settings::values.async_custom_loading);
+    ReadBasicSetting(Settings::values.custom_textures_cache_size);
+    ReadBasicSetting(Settings::values.share_custom_textures);
 
     qt_config->endGroup();
 }
@@ -423,6 +432,15 @@ void Config::ReadCoreValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.use_cpu_jit);
+        ReadBasicSetting(Settings::values.use_fastmem);
+        ReadBasicSetting(Settings::values.use_huge_pages);
+        ReadBasicSetting(Settings::values.use_multi_core);
+        ReadBasicSetting(Settings::values.skip_idle_loops);
+        ReadBasicSetting(Settings::values.rewind_interval);
+        ReadBasicSetting(Settings::values.rewind_buffer_size);
+        ReadBasicSetting(Settings::values.boot_snapshot_time);
+        ReadBasicSetting(Settings::values.use_perf_profiles);
+        ReadBasicSetting(Settings::values.tune_performance);
     }
 
     qt_config->endGroup();
@@ -614,6 +632,7 @@ void Config::ReadRendererValues() {
     ReadGlobalSetting(Settings::values.use_vsync_new);
     ReadGlobalSetting(Settings::values.resolution_factor);
     ReadGlobalSetting(Settings::values.frame_limit);
+    ReadBasicSetting(Settings::values.frame_skip);
 
     ReadGlobalSetting(Settings::values.bg_red);
     ReadGlobalSetting(Settings::values.bg_green);
@@ -623,6 +642,12 @@ void Config::ReadRendererValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.use_shader_jit);
+        ReadBasicSetting(Settings::values.use_async_gpu_emulation);
+        ReadBasicSetting(Settings::values.sw_rasterizer_threads);
+        ReadBasicSetting(Settings::values.vertex_shader_threads);
+        ReadBasicSetting(Settings::values.async_shader_compilation);
+        ReadBasicSetting(Settings::values.use_gpu_texture_decode);
+        ReadBasicSetting(Settings::values.present_mode);
     }
 
     qt_config->endGroup();
@@ -692,6 +717,12 @@ void Config::ReadVideoDumpingValues() {
 
     Settings::values.video_bitrate =
         ReadSetting(QStringLiteral("video_bitrate"), 2500000).toULongLong();
+    Settings::values.video_gpu_conversion =
+        ReadSetting(QStringLiteral("video_gpu_conversion"), true).toBool();
+    Settings::values.video_drop_frames =
+        ReadSetting(QStringLiteral("video_drop_frames"), false).toBool();
+    Settings::values.video_separate_screens =
+        ReadSetting(QStringLiteral("video_separate_screens"), false).toBool();
 
     Settings::values.audio_encoder =
         ReadSetting(QStringLiteral("audio_encoder"), QStringLiteral("libvorbis"))
@@ -819,6 +850,8 @@ void Config::SaveAudioValues() {
     qt_config->beginGroup(QStringLiteral("Audio"));
 
     WriteGlobalSetting(Settings::values.audio_emulation);
+    WriteBasicSetting(Settings::values.lle_dsp_run_ahead);
+    WriteBasicSetting(Settings::values.headless_dsp);
     WriteGlobalSetting(Settings::values.enable_audio_stretching);
     WriteGlobalSetting(Settings::values.volume);
 
@@ -918,6 +951,8 @@ void Config::SaveControlValues() {
     }
     qt_config->endArray();
 
+    WriteBasicSetting(Settings::values.input_polling_rate);
+
     qt_config->endGroup();
 }
 
@@ -927,6 +962,9 @@ void Config::SaveUtilityValues() {
     WriteBasicSetting(Settings::values.dump_textures);
     WriteBasicSetting(Settings::values.custom_textures);
     WriteBasicSetting(Settings::values.preload_textures);
+    WriteBasicSetting(Settings::values.async_custom_loading);
+    WriteBasicSetting(Settings::values.custom_textures_cache_size);
+    WriteBasicSetting(Settings::values.share_custom_textures);
 
     qt_config->endGroup();
 }
@@ -938,6 +976,15 @@ void Config::SaveCoreValues() {
 
     if (global) {
         WriteBasicSetting(Settings::values.use_cpu_jit);
+        WriteBasicSetting(Settings::values.use_fastmem);
+        WriteBasicSetting(Settings::values.use_huge_pages);
+        WriteBasicSetting(Settings::values.use_multi_core);
+        WriteBasicSetting(Settings::values.skip_idle_loops);
+        WriteBasicSetting(Settings::values.rewind_interval);
+        WriteBasicSetting(Settings::values.rewind_buffer_size);
+        WriteBasicSetting(Settings::values.boot_snapshot_time);
+        WriteBasicSetting(Settings::values.use_perf_profiles);
+        WriteBasicSetting(Settings::values.tune_performance);
     }
 
     qt_config->endGroup();
@@ -1089,6 +1136,7 @@ void Config::SaveRendererValues() {
     WriteGlobalSetting(Settings::values.use_vsync_new);
     WriteGlobalSetting(Settings::values.resolution_factor);
     WriteGlobalSetting(Settings::values.frame_limit);
+    WriteBasicSetting(Settings::values.frame_skip);
 
     WriteGlobalSetting(Settings::values.bg_red);
     WriteGlobalSetting(Settings::values.bg_green);
@@ -1099,6 +1147,12 @@ void Config::SaveRendererValues() {
     if (global) {
         WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit.GetValue(),
                      true);
+        WriteBasicSetting(Settings::values.use_async_gpu_emulation);
+        WriteBasicSetting(Settings::values.sw_rasterizer_threads);
+        WriteBasicSetting(Settings::values.vertex_shader_threads);
+        WriteBasicSetting(Settings::values.async_shader_compilation);
+        WriteBasicSetting(Settings::values.use_gpu_texture_decode);
+        WriteBasicSetting(Settings::values.present_mode);
     }
 
     qt_config->endGroup();
@@ -1155,6 +1209,11 @@ void Config::SaveVideoDumpingValues() {
                  DEFAULT_VIDEO_ENCODER_OPTIONS);
     WriteSetting(QStringLiteral("video_bitrate"),
                  static_cast<unsigned long long>(Settings::values.video_bitrate), 2500000);
+    WriteSetting(QStringLiteral("video_gpu_conversion"), Settings::values.video_gpu_conversion,
+                 true);
+    WriteSetting(QStringLiteral("video_drop_frames"), Settings::values.video_drop_frames, false);
+    WriteSetting(QStringLiteral("video_separate_screens"), Settings::values.video_separate_screens,
+                 false);
     WriteSetting(QStringLiteral("audio_encoder"),
                  QString::fromStdString(Settings::values.audio_encoder),
                  QStringLiteral("libvorbis"));
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <QListView>
 #include "citra_qt/debugger/graphics/graphics.h"
 #include "citra_qt/util/util.h"
@@ -23,7 +24,7 @@ QVariant GPUCommandStreamItemModel::data(const QModelIndex& index, int role) con
         return QVariant();
 
     int command_index = index.row();
-    const Service::GSP::Command& command = GetDebugger()->ReadGXCommandHistory(command_index);
+    const Service::GSP::Command command = GetDebugger()->ReadGXCommandHistory(command_index);
     if (role == Qt::DisplayRole) {
         std::map<Service::GSP::CommandId, const char*> command_names = {
             {Service::GSP::CommandId::REQUEST_DMA, "REQUEST_DMA"},
@@ -51,10 +52,17 @@ QVariant GPUCommandStreamItemModel::data(const QModelIndex& index, int role) con
 }
 
 void GPUCommandStreamItemModel::GXCommandProcessed(int total_command_count) {
-    emit GXCommandFinished(total_command_count);
+    // Games submit thousands of commands per second, so the commands processed until the UI thread
+    // gets to the pending update are added to the list together
+    latest_command_count = total_command_count;
+    if (!update_pending.exchange(true)) {
+        emit GXCommandFinished(total_command_count);
+    }
 }
 
 void GPUCommandStreamItemModel::OnGXCommandFinishedInternal(int total_command_count) {
+    update_pending = false;
+    total_command_count = std::max(total_command_count, latest_command_count.load());
     if (total_command_count == 0)
         return;
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <QAbstractListModel>
 #include <QDockWidget>
 #include "video_core/gpu_debugger.h"
@@ -29,6 +30,11 @@ signals:
 
 private:
     int command_count;
+
+    /// The command count of the latest GX command, read by the UI thread when it updates
+    std::atomic<int> latest_command_count{0};
+    /// Whether an update was signaled that the UI thread hasn't processed yet
+    std::atomic_bool update_pending{false};
 };
 
 class GPUCommandStreamWidget : public QDockWidget {
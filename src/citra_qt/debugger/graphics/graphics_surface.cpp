@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <QBoxLayout>
 #include <QComboBox>
 #include <QDebug>
@@ -578,10 +580,23 @@ void GraphicsSurfaceWidget::OnUpdate() {
         info.format = static_cast<Pica::TexturingRegs::TextureFormat>(surface_format);
         info.SetDefaultStride();
 
-        for (unsigned int y = 0; y < surface_height; ++y) {
-            for (unsigned int x = 0; x < surface_width; ++x) {
-                Common::Vec4<u8> color = Pica::Texture::LookupTexture(buffer, x, y, info, true);
-                decoded_image.setPixel(x, y, qRgba(color.r(), color.g(), color.b(), color.a()));
+        // Decode a tile at a time, which shares the per-block work of the compressed formats
+        const std::size_t tile_size = Pica::Texture::CalculateTileSize(info.format);
+        std::array<Common::Vec4<u8>, 8 * 8> texels;
+        for (unsigned int tile_y = 0; tile_y < surface_height; tile_y += 8) {
+            for (unsigned int tile_x = 0; tile_x < surface_width; tile_x += 8) {
+                const u8* tile = buffer + (tile_y / 8) * info.stride + (tile_x / 8) * tile_size;
+                Pica::Texture::DecodeTile(tile, info, texels.data(), true);
+
+                const unsigned int height = std::min(8U, surface_height - tile_y);
+                const unsigned int width = std::min(8U, surface_width - tile_x);
+                for (unsigned int y = 0; y < height; ++y) {
+                    auto* line = reinterpret_cast<QRgb*>(decoded_image.scanLine(tile_y + y));
+                    for (unsigned int x = 0; x < width; ++x) {
+                        const Common::Vec4<u8>& color = texels[y * 8 + x];
+                        line[tile_x + x] = qRgba(color.r(), color.g(), color.b(), color.a());
+                    }
+                }
             }
         }
     } else {
@@ -16,6 +16,11 @@
 #include "core/hle/service/sm/sm.h"
 #include "ui_recorder.h"
 
+namespace {
+/// The most records that are kept, the oldest ones are removed when more are recorded
+constexpr std::size_t MaxRecords = 10000;
+} // Anonymous namespace
+
 IPCRecorderWidget::IPCRecorderWidget(QWidget* parent)
     : QDockWidget(parent), ui(std::make_unique<Ui::IPCRecorder>()) {
 
@@ -27,7 +32,7 @@ IPCRecorderWidget::IPCRecorderWidget(QWidget* parent)
     connect(ui->clearButton, &QPushButton::clicked, this, &IPCRecorderWidget::Clear);
     connect(ui->filter, &QLineEdit::textChanged, this, &IPCRecorderWidget::ApplyFilterToAll);
     connect(ui->main, &QTreeWidget::itemDoubleClicked, this, &IPCRecorderWidget::OpenRecordDialog);
-    connect(this, &IPCRecorderWidget::EntryUpdated, this, &IPCRecorderWidget::OnEntryUpdated);
+    connect(this, &IPCRecorderWidget::EntriesPending, this, &IPCRecorderWidget::OnEntriesPending);
 }
 
 IPCRecorderWidget::~IPCRecorderWidget() = default;
@@ -61,6 +66,23 @@ QString IPCRecorderWidget::GetStatusStr(const IPCDebugger::RequestRecord& record
     }
 }
 
+void IPCRecorderWidget::OnEntriesPending() {
+    std::vector<IPCDebugger::RequestRecord> updates;
+    {
+        std::scoped_lock lock{pending_mutex};
+        updates.swap(pending_records);
+    }
+
+    ui->main->setUpdatesEnabled(false);
+    for (auto& record : updates) {
+        OnEntryUpdated(std::move(record));
+    }
+    if (records.size() > MaxRecords) {
+        RemoveOldestRecords();
+    }
+    ui->main->setUpdatesEnabled(true);
+}
+
 void IPCRecorderWidget::OnEntryUpdated(IPCDebugger::RequestRecord record) {
     if (record.id < id_offset) { // The record has already been deleted by 'Clear'
         return;
@@ -108,13 +130,31 @@ void IPCRecorderWidget::SetEnabled(bool enabled) {
     ipc_recorder.SetEnabled(enabled);
 
     if (enabled) {
-        handle = ipc_recorder.BindCallback(
-            [this](const IPCDebugger::RequestRecord& record) { emit EntryUpdated(record); });
+        // Services are called thousands of times per second, so the updates are collected and the
+        // UI thread is only signaled when it has shown all the previous ones
+        handle = ipc_recorder.BindCallback([this](const IPCDebugger::RequestRecord& record) {
+            std::scoped_lock lock{pending_mutex};
+            pending_records.push_back(record);
+            if (pending_records.size() == 1) {
+                emit EntriesPending();
+            }
+        });
     } else if (handle) {
         ipc_recorder.UnbindCallback(handle);
     }
 }
 
+void IPCRecorderWidget::RemoveOldestRecords() {
+    // Remove a quarter at once, so that this doesn't happen for every new record
+    const std::size_t count = records.size() - MaxRecords * 3 / 4;
+    id_offset += static_cast<int>(count);
+
+    records.erase(records.begin(), records.begin() + count);
+    for (std::size_t i = 0; i < count; ++i) {
+        delete ui->main->invisibleRootItem()->takeChild(0);
+    }
+}
+
 void IPCRecorderWidget::Clear() {
     id_offset += static_cast<int>(records.size());
 
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include <QDockWidget>
 #include "core/hle/kernel/ipc_debugger/recorder.h"
 
@@ -26,11 +29,13 @@ public:
     void OnEmulationStarting();
 
 signals:
-    void EntryUpdated(IPCDebugger::RequestRecord record);
+    void EntriesPending();
 
 private:
     QString GetStatusStr(const IPCDebugger::RequestRecord& record) const;
+    void OnEntriesPending();
     void OnEntryUpdated(IPCDebugger::RequestRecord record);
+    void RemoveOldestRecords();
     void SetEnabled(bool enabled);
     void Clear();
     void ApplyFilter(int index);
@@ -46,7 +51,11 @@ private:
     // continuously and only the 'Clear' action can be performed, this is enough.
     // The initial value is 1, which means record 1 = row 0.
     int id_offset = 1;
-    std::vector<IPCDebugger::RequestRecord> records;
+    std::deque<IPCDebugger::RequestRecord> records;
+
+    /// The updates of the records made by the emulation thread that aren't shown yet
+    std::vector<IPCDebugger::RequestRecord> pending_records;
+    std::mutex pending_mutex;
 };
 
 Q_DECLARE_METATYPE(IPCDebugger::RequestRecord);
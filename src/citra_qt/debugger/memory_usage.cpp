@@ -0,0 +1,71 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <QHeaderView>
+#include <QTimer>
+#include <QTreeWidget>
+#include "citra_qt/debugger/memory_usage.h"
+#include "citra_qt/util/util.h"
+#include "common/memory_usage.h"
+
+namespace {
+
+constexpr int RefreshIntervalMs = 1000;
+
+enum Column { Name, Size, PeakSize, Count, PeakCount, NumColumns };
+
+} // Anonymous namespace
+
+MemoryUsageWidget::MemoryUsageWidget(QWidget* parent) : QDockWidget(tr("Memory Usage"), parent) {
+    setObjectName(QStringLiteral("MemoryUsageWidget"));
+
+    tree = new QTreeWidget(this);
+    tree->setColumnCount(NumColumns);
+    tree->setHeaderLabels({tr("Name"), tr("Size"), tr("Peak Size"), tr("Objects"),
+                           tr("Peak Objects")});
+    tree->setRootIsDecorated(false);
+    tree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    setWidget(tree);
+
+    // The counters only change while emulating, but reading them is cheap enough to not track it
+    update_timer = new QTimer(this);
+    update_timer->setInterval(RefreshIntervalMs);
+    connect(update_timer, &QTimer::timeout, this, &MemoryUsageWidget::Refresh);
+}
+
+MemoryUsageWidget::~MemoryUsageWidget() = default;
+
+void MemoryUsageWidget::showEvent(QShowEvent* event) {
+    QDockWidget::showEvent(event);
+    Refresh();
+    update_timer->start();
+}
+
+void MemoryUsageWidget::hideEvent(QHideEvent* event) {
+    update_timer->stop();
+    QDockWidget::hideEvent(event);
+}
+
+void MemoryUsageWidget::Refresh() {
+    const auto usages = Common::MemoryUsage::GetUsages();
+    // Counters are never removed, so the rows only need to be added once
+    while (tree->topLevelItemCount() < static_cast<int>(usages.size())) {
+        auto* item = new QTreeWidgetItem(tree);
+        for (int column = Size; column < NumColumns; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight);
+        }
+    }
+
+    for (std::size_t i = 0; i < usages.size(); ++i) {
+        const auto& usage = usages[i];
+        QTreeWidgetItem* item = tree->topLevelItem(static_cast<int>(i));
+        const QString name = QString::fromUtf8(usage.group) + QStringLiteral(" / ") +
+                             QString::fromUtf8(usage.name);
+        item->setText(Name, name);
+        item->setText(Size, ReadableByteSize(usage.bytes));
+        item->setText(PeakSize, ReadableByteSize(usage.peak_bytes));
+        item->setText(Count, QString::number(usage.count));
+        item->setText(PeakCount, QString::number(usage.peak_count));
+    }
+}
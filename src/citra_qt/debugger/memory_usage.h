@@ -0,0 +1,29 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QDockWidget>
+
+class QTimer;
+class QTreeWidget;
+
+/// Shows the memory held by the subsystems, as counted by Common::MemoryUsage
+class MemoryUsageWidget : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit MemoryUsageWidget(QWidget* parent = nullptr);
+    ~MemoryUsageWidget();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    void Refresh();
+
+    QTreeWidget* tree = nullptr;
+    QTimer* update_timer = nullptr;
+};
@@ -445,17 +445,28 @@ WaitTreeWidget::WaitTreeWidget(QWidget* parent) : QDockWidget(tr("Wait Tree"), p
     view->setHeaderHidden(true);
     setWidget(view);
     setEnabled(false);
+
+    connect(this, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible && refresh_pending) {
+            OnDebugModeEntered();
+        }
+    });
 }
 
 void WaitTreeWidget::OnDebugModeEntered() {
     if (!Core::System::GetInstance().IsPoweredOn())
         return;
+    // The emulation thread waits for this, so walking the threads is left for when it's shown
+    refresh_pending = !isVisible();
+    if (refresh_pending)
+        return;
     model->InitItems();
     view->setModel(model);
     setEnabled(true);
 }
 
 void WaitTreeWidget::OnDebugModeLeft() {
+    refresh_pending = false;
     setEnabled(false);
     view->setModel(nullptr);
     model->ClearItems();
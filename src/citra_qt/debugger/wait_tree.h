@@ -187,4 +187,6 @@ public slots:
 private:
     QTreeView* view;
     WaitTreeModel* model;
+    /// Whether the emulation paused while the widget was hidden, so the items are out of date
+    bool refresh_pending = false;
 };
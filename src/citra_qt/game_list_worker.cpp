@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -15,8 +17,10 @@
 #include "citra_qt/uisettings.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/thread_pool.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/fs/archive.h"
+#include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 
 namespace {
@@ -24,6 +28,16 @@ bool HasSupportedFileExtension(const std::string& file_name) {
     const QFileInfo file = QFileInfo(QString::fromStdString(file_name));
     return GameList::supported_file_extensions.contains(file.suffix(), Qt::CaseInsensitive);
 }
+
+constexpr u32 MetadataCacheMagic = 0x43474C43; // CGLC
+constexpr u32 MetadataCacheVersion = 1;
+
+/// The files are parsed in batches, so that the list fills up while the scan goes on
+constexpr std::size_t ScanBatchSize = 256;
+
+std::string GetMetadataCachePath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "game_list" DIR_SEP "metadata.bin";
+}
 } // Anonymous namespace
 
 GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
@@ -32,11 +46,121 @@ GameListWorker::GameListWorker(QVector<UISettings::GameDir>& game_dirs,
 
 GameListWorker::~GameListWorker() = default;
 
-void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
-                                             GameListDir* parent_dir) {
-    const auto callback = [this, recursion, parent_dir](u64* num_entries_out,
-                                                        const std::string& directory,
-                                                        const std::string& virtual_name) -> bool {
+GameListWorker::FileMetadata GameListWorker::GetFileMetadata(const std::string& path) {
+    FileMetadata metadata;
+    metadata.size = FileUtil::GetSize(path);
+    metadata.modification_time = FileUtil::GetModificationTime(path);
+    {
+        std::scoped_lock lock{cache_mutex};
+        const auto it = metadata_cache.find(path);
+        if (it != metadata_cache.end() && it->second.size == metadata.size &&
+            it->second.modification_time == metadata.modification_time) {
+            scanned_metadata.insert_or_assign(path, it->second);
+            return it->second;
+        }
+    }
+
+    if (std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(path)) {
+        bool executable = false;
+        const auto res = loader->IsExecutable(executable);
+        metadata.is_title = executable || res == Loader::ResultStatus::ErrorEncrypted;
+        loader->ReadProgramId(metadata.program_id);
+        loader->ReadExtdataId(metadata.extdata_id);
+        loader->ReadIcon(metadata.smdh);
+        metadata.file_type = static_cast<u32>(loader->GetFileType());
+    }
+
+    std::scoped_lock lock{cache_mutex};
+    scanned_metadata.insert_or_assign(path, metadata);
+    return metadata;
+}
+
+void GameListWorker::LoadMetadataCache() {
+    metadata_cache.clear();
+    scanned_metadata.clear();
+
+    FileUtil::IOFile file(GetMetadataCachePath(), "rb");
+    if (!file) {
+        return;
+    }
+    std::array<u32, 3> header{};
+    if (file.ReadArray(header.data(), header.size()) != header.size() ||
+        header[0] != MetadataCacheMagic || header[1] != MetadataCacheVersion) {
+        return;
+    }
+    const auto read = [&file](auto& value) {
+        return file.ReadBytes(&value, sizeof(value)) == sizeof(value);
+    };
+    for (u32 i = 0; i < header[2]; i++) {
+        u32 path_size;
+        if (!read(path_size) || path_size > 0x10000) {
+            break;
+        }
+        std::string path(path_size, '\0');
+        FileMetadata metadata;
+        u8 is_title;
+        u32 smdh_size;
+        if (file.ReadBytes(path.data(), path.size()) != path.size() || !read(metadata.size) ||
+            !read(metadata.modification_time) || !read(is_title) || !read(metadata.program_id) ||
+            !read(metadata.extdata_id) || !read(metadata.file_type) || !read(smdh_size) ||
+            smdh_size > sizeof(Loader::SMDH)) {
+            break;
+        }
+        metadata.is_title = is_title != 0;
+        metadata.smdh.resize(smdh_size);
+        if (file.ReadBytes(metadata.smdh.data(), smdh_size) != smdh_size) {
+            break;
+        }
+        metadata_cache.emplace(std::move(path), std::move(metadata));
+    }
+}
+
+void GameListWorker::SaveMetadataCache() {
+    // The cache is replaced at once, so that a failed write leaves the old one intact
+    const std::string path = GetMetadataCachePath();
+    const std::string temp_path = path + ".tmp";
+    if (!FileUtil::CreateFullPath(path)) {
+        return;
+    }
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file) {
+            return;
+        }
+        const std::array<u32, 3> header{MetadataCacheMagic, MetadataCacheVersion,
+                                        static_cast<u32>(scanned_metadata.size())};
+        bool success = file.WriteArray(header.data(), header.size()) == header.size();
+        for (const auto& [file_path, metadata] : scanned_metadata) {
+            const u32 path_size = static_cast<u32>(file_path.size());
+            const u8 is_title = metadata.is_title;
+            const u32 smdh_size = static_cast<u32>(metadata.smdh.size());
+            success &= file.WriteObject(path_size) == 1 &&
+                       file.WriteBytes(file_path.data(), file_path.size()) == file_path.size() &&
+                       file.WriteObject(metadata.size) == 1 &&
+                       file.WriteObject(metadata.modification_time) == 1 &&
+                       file.WriteObject(is_title) == 1 &&
+                       file.WriteObject(metadata.program_id) == 1 &&
+                       file.WriteObject(metadata.extdata_id) == 1 &&
+                       file.WriteObject(metadata.file_type) == 1 &&
+                       file.WriteObject(smdh_size) == 1 &&
+                       file.WriteBytes(metadata.smdh.data(), smdh_size) == smdh_size;
+        }
+        if (!success || !file.Close()) {
+            FileUtil::Delete(temp_path);
+            return;
+        }
+    }
+    if (FileUtil::Exists(path)) {
+        FileUtil::Delete(path);
+    }
+    FileUtil::Rename(temp_path, path);
+}
+
+void GameListWorker::CollectFiles(const std::string& dir_path, unsigned int recursion,
+                                  std::vector<std::string>& files) {
+    const auto callback = [this, recursion, &files](u64* num_entries_out,
+                                                    const std::string& directory,
+                                                    const std::string& virtual_name) -> bool {
         if (stop_processing) {
             // Breaks the callback loop.
             return false;
@@ -45,22 +169,45 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         const bool is_dir = FileUtil::IsDirectory(physical_name);
         if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader) {
-                return true;
-            }
+            files.push_back(physical_name);
+        } else if (is_dir && recursion > 0) {
+            watch_list.append(QString::fromStdString(physical_name));
+            CollectFiles(physical_name, recursion - 1, files);
+        }
 
-            bool executable = false;
-            const auto res = loader->IsExecutable(executable);
-            if (!executable && res != Loader::ResultStatus::ErrorEncrypted) {
-                return true;
-            }
+        return true;
+    };
 
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
+    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+}
 
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
+void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
+                                             GameListDir* parent_dir) {
+    std::vector<std::string> files;
+    CollectFiles(dir_path, recursion, files);
+
+    for (std::size_t batch = 0; batch < files.size() && !stop_processing;
+         batch += ScanBatchSize) {
+        const std::size_t batch_size = std::min(ScanBatchSize, files.size() - batch);
+        std::vector<FileMetadata> batch_metadata(batch_size);
+        Common::TaskGroup group;
+        group.RunForEach(batch_size, [&](std::size_t i) {
+            if (!stop_processing) {
+                batch_metadata[i] = GetFileMetadata(files[batch + i]);
+            }
+        });
+        group.Wait();
+        if (stop_processing) {
+            break;
+        }
+
+        for (std::size_t i = 0; i < batch_size; i++) {
+            const std::string& physical_name = files[batch + i];
+            const FileMetadata& metadata = batch_metadata[i];
+            if (!metadata.is_title) {
+                continue;
+            }
+            const u64 program_id = metadata.program_id;
 
             std::vector<u8> smdh;
             // Look for an update icon if available
@@ -68,22 +215,18 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
                 std::string update_path = Service::AM::GetTitleContentPath(
                     Service::FS::MediaType::SDMC, program_id | 0x0000000E00000000);
                 if (FileUtil::Exists(update_path)) {
-                    std::unique_ptr<Loader::AppLoader> update_loader =
-                        Loader::GetLoader(update_path);
-                    if (update_loader) {
-                        update_loader->ReadIcon(smdh);
-                    }
+                    smdh = GetFileMetadata(update_path).smdh;
                 }
             }
 
             if (!Loader::IsValidSMDH(smdh)) {
                 // Read the original smdh if there is no valid update smdh
-                loader->ReadIcon(smdh);
+                smdh = metadata.smdh;
             }
 
             if (!Loader::IsValidSMDH(smdh) && UISettings::values.game_list_hide_no_icon) {
                 // Skip this invalid entry
-                return true;
+                continue;
             }
 
             auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
@@ -93,31 +236,28 @@ void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsign
             if (it != compatibility_list.end())
                 compatibility = it->second.first;
 
+            const auto file_type = static_cast<Loader::FileType>(metadata.file_type);
             emit EntryReady(
                 {
                     new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id),
+                                         metadata.extdata_id),
                     new GameListItemCompat(compatibility),
                     new GameListItemRegion(smdh),
                     new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
+                        QString::fromStdString(Loader::GetFileTypeString(file_type))),
+                    new GameListItemSize(metadata.size),
                 },
                 parent_dir);
-
-        } else if (is_dir && recursion > 0) {
-            watch_list.append(QString::fromStdString(physical_name));
-            AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir);
         }
-
-        return true;
-    };
-
-    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+    }
 }
 
 void GameListWorker::run() {
     stop_processing = false;
+    LoadMetadataCache();
+    // The keys are loaded on first use, which has to happen before the files are opened in
+    // parallel
+    HW::AES::InitKeys();
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == QStringLiteral("INSTALLED")) {
             QString games_path =
@@ -154,6 +294,9 @@ void GameListWorker::run() {
         }
     }
 
+    if (!stop_processing) {
+        SaveMetadataCache();
+    }
     emit Finished(watch_list);
 }
 
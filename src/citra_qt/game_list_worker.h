@@ -7,8 +7,10 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <QList>
 #include <QObject>
 #include <QRunnable>
@@ -53,12 +55,40 @@ signals:
     void Finished(QStringList watch_list);
 
 private:
+    /// What the game list shows of a file, cached by its path, size and modification time
+    struct FileMetadata {
+        u64 size = 0;
+        s64 modification_time = 0;
+        /// Whether the file is a title, encrypted ones included
+        bool is_title = false;
+        u64 program_id = 0;
+        u64 extdata_id = 0;
+        u32 file_type = 0;
+        std::vector<u8> smdh;
+    };
+
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir);
 
+    /// Appends the files with a supported extension in the directory tree to the list
+    void CollectFiles(const std::string& dir_path, unsigned int recursion,
+                      std::vector<std::string>& files);
+
+    /// Returns the metadata of the file, only opening it if it isn't cached. Thread-safe.
+    FileMetadata GetFileMetadata(const std::string& path);
+
+    void LoadMetadataCache();
+    void SaveMetadataCache();
+
     QVector<UISettings::GameDir>& game_dirs;
     const CompatibilityList& compatibility_list;
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
+
+    std::mutex cache_mutex;
+    /// The metadata cache as it was on disk
+    std::unordered_map<std::string, FileMetadata> metadata_cache;
+    /// The metadata of the files seen by this scan, which replaces the cache on disk
+    std::unordered_map<std::string, FileMetadata> scanned_metadata;
 };
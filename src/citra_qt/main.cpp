@@ -46,6 +46,7 @@
 #include "citra_qt/debugger/graphics/graphics_vertex_shader.h"
 #include "citra_qt/debugger/ipc/recorder.h"
 #include "citra_qt/debugger/lle_service_modules.h"
+#include "citra_qt/debugger/memory_usage.h"
 #include "citra_qt/debugger/profiler.h"
 #include "citra_qt/debugger/registers.h"
 #include "citra_qt/debugger/wait_tree.h"
@@ -75,6 +76,7 @@
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #if CITRA_ARCH(x86_64)
 #include "common/x64/cpu_detect.h"
 #endif
@@ -91,6 +93,7 @@
 #include "core/loader/loader.h"
 #include "core/movie.h"
 #include "core/savestate.h"
+#include "core/telemetry_session.h"
 #include "game_list_p.h"
 #include "input_common/main.h"
 #include "network/network_settings.h"
@@ -416,6 +419,11 @@ void GMainWindow::InitializeDebugWidgets() {
     debug_menu->addAction(ipcRecorderWidget->toggleViewAction());
     connect(this, &GMainWindow::EmulationStarting, ipcRecorderWidget,
             &IPCRecorderWidget::OnEmulationStarting);
+
+    memoryUsageWidget = new MemoryUsageWidget(this);
+    addDockWidget(Qt::RightDockWidgetArea, memoryUsageWidget);
+    memoryUsageWidget->hide();
+    debug_menu->addAction(memoryUsageWidget->toggleViewAction());
 }
 
 void GMainWindow::InitializeRecentFileMenuActions() {
@@ -622,6 +630,22 @@ void GMainWindow::InitializeHotkeys() {
             &QShortcut::activated, ui->action_Load_from_Newest_Slot, &QAction::trigger);
     connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Save to Oldest Slot"), this),
             &QShortcut::activated, ui->action_Save_to_Oldest_Slot, &QAction::trigger);
+    connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Save Trace"), this),
+            &QShortcut::activated, this, [this] {
+                const std::string path = Common::Trace::SaveTrace();
+                statusBar()->showMessage(path.empty()
+                                             ? tr("Could not save the trace")
+                                             : tr("Saved the trace to %1")
+                                                   .arg(QString::fromStdString(path)),
+                                         5000);
+            });
+    connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Rewind"), this),
+            &QShortcut::activated, this, [this] {
+                if (emulation_running) {
+                    Core::System::GetInstance().SendSignal(Core::System::Signal::Rewind);
+                    Core::System::GetInstance().frame_limiter.AdvanceFrame();
+                }
+            });
     connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Mute Audio"), this),
             &QShortcut::activated, this,
             [] { Settings::values.audio_muted = !Settings::values.audio_muted; });
@@ -1351,7 +1375,9 @@ void GMainWindow::UpdateSaveStates() {
     for (u32 i = 0; i < Core::SaveStateSlotCount; ++i) {
         actions_load_state[i]->setEnabled(false);
         actions_load_state[i]->setText(tr("Slot %1").arg(i + 1));
+        actions_load_state[i]->setIcon(QIcon());
         actions_save_state[i]->setText(tr("Slot %1").arg(i + 1));
+        actions_save_state[i]->setIcon(QIcon());
     }
     for (const auto& savestate : savestates) {
         const auto text = tr("Slot %1 - %2")
@@ -1361,6 +1387,16 @@ void GMainWindow::UpdateSaveStates() {
         actions_load_state[savestate.slot - 1]->setEnabled(true);
         actions_load_state[savestate.slot - 1]->setText(text);
         actions_save_state[savestate.slot - 1]->setText(text);
+        if (!savestate.thumbnail.empty()) {
+            const QImage thumbnail(savestate.thumbnail.data(),
+                                   static_cast<int>(savestate.thumbnail_width),
+                                   static_cast<int>(savestate.thumbnail_height),
+                                   static_cast<int>(savestate.thumbnail_width * 3),
+                                   QImage::Format_RGB888);
+            const QIcon icon(QPixmap::fromImage(thumbnail));
+            actions_load_state[savestate.slot - 1]->setIcon(icon);
+            actions_save_state[savestate.slot - 1]->setIcon(icon);
+        }
 
         ui->action_Load_from_Newest_Slot->setEnabled(true);
 
@@ -2675,6 +2711,7 @@ int main(int argc, char* argv[]) {
                      &GMainWindow::OnAppFocusStateChanged);
 
     int result = app.exec();
+    Core::ShutdownWebService();
     detached_tasks.WaitForAllTasks();
     return result;
 }
@@ -33,6 +33,7 @@ class GRenderWindow;
 class IPCRecorderWidget;
 class LLEServiceModulesWidget;
 class LoadingScreen;
+class MemoryUsageWidget;
 class MicroProfileDialog;
 class MultiplayerState;
 class ProfilerWidget;
@@ -301,6 +302,7 @@ private:
     GraphicsTracingWidget* graphicsTracingWidget;
     IPCRecorderWidget* ipcRecorderWidget;
     LLEServiceModulesWidget* lleServiceModulesWidget;
+    MemoryUsageWidget* memoryUsageWidget;
     WaitTreeWidget* waitTreeWidget;
     Updater* updater;
 
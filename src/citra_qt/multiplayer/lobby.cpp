@@ -75,6 +75,8 @@ Lobby::Lobby(QWidget* parent, QStandardItemModel* list,
     connect(&room_list_watcher, &QFutureWatcher<AnnounceMultiplayerRoom::RoomList>::finished, this,
             &Lobby::OnRefreshLobby);
 
+    ResetModel();
+
     // manually start a refresh when the window is opening
     // TODO(jroweboy): if this refresh is slow for people with bad internet, then don't do it as
     // part of the constructor, but offload the refresh until after the window shown. perhaps emit a
@@ -94,6 +96,20 @@ void Lobby::UpdateGameList(QStandardItemModel* list) {
     }
     if (proxy)
         proxy->UpdateGameList(game_list);
+
+    // The rooms that are already shown keep their rows, update their icons
+    if (model && model->rowCount() > 0) {
+        const auto game_icons = GetGameIcons();
+        for (int i = 0; i < model->rowCount(); i++) {
+            auto game = model->item(i, Column::GAME_NAME);
+            const u64 game_id = game->data(LobbyItemGame::TitleIDRole).toULongLong();
+            if (const auto icon = game_icons.find(game_id); icon != game_icons.end()) {
+                game->setData(icon.value(), LobbyItemGame::GameIconRole);
+            } else {
+                game->setData(QVariant{}, LobbyItemGame::GameIconRole);
+            }
+        }
+    }
 }
 
 void Lobby::RetranslateUi() {
@@ -184,6 +200,7 @@ void Lobby::OnJoinRoom(const QModelIndex& source) {
 }
 
 void Lobby::ResetModel() {
+    shown_rooms.clear();
     model->clear();
     model->insertColumns(0, Column::TOTAL);
     model->setHeaderData(Column::EXPAND, Qt::Horizontal, QString(), Qt::DisplayRole);
@@ -195,7 +212,6 @@ void Lobby::ResetModel() {
 
 void Lobby::RefreshLobby() {
     if (auto session = announce_multiplayer_session.lock()) {
-        ResetModel();
         ui->refresh_list->setEnabled(false);
         ui->refresh_list->setText(tr("Refreshing"));
         room_list_watcher.setFuture(
@@ -205,64 +221,107 @@ void Lobby::RefreshLobby() {
     }
 }
 
+QHash<u64, QPixmap> Lobby::GetGameIcons() const {
+    QHash<u64, QPixmap> game_icons;
+    for (int r = 0; r < game_list->rowCount(); ++r) {
+        auto index = game_list->index(r, 0);
+        auto game_id = game_list->data(index, GameListItemPath::ProgramIdRole).toULongLong();
+        if (game_id != 0) {
+            game_icons.insert(game_id, game_list->data(index, Qt::DecorationRole).value<QPixmap>());
+        }
+    }
+    return game_icons;
+}
+
+QStandardItem* Lobby::AddRoom(const AnnounceMultiplayerRoom::Room& room,
+                              const QHash<u64, QPixmap>& game_icons) {
+    // find the icon for the game if this person owns that game.
+    const QPixmap smdh_icon = game_icons.value(room.preferred_game_id);
+
+    QList<QVariant> members;
+    for (auto member : room.members) {
+        QVariant var;
+        var.setValue(LobbyMember{QString::fromStdString(member.username),
+                                 QString::fromStdString(member.nickname), member.game_id,
+                                 QString::fromStdString(member.game_name)});
+        members.append(var);
+    }
+
+    auto first_item = new LobbyItem();
+    auto row = QList<QStandardItem*>({
+        first_item,
+        new LobbyItemName(room.has_password, QString::fromStdString(room.name)),
+        new LobbyItemGame(room.preferred_game_id, QString::fromStdString(room.preferred_game),
+                          smdh_icon),
+        new LobbyItemHost(QString::fromStdString(room.owner), QString::fromStdString(room.ip),
+                          room.port, QString::fromStdString(room.verify_UID)),
+        new LobbyItemMemberList(members, room.max_player),
+    });
+    model->appendRow(row);
+    // To make the rows expandable, add the member data as a child of the first column of the
+    // rows with people in them and have qt set them to colspan after the model is finished
+    // resetting
+    if (!room.description.empty()) {
+        first_item->appendRow(new LobbyItemDescription(QString::fromStdString(room.description)));
+    }
+    if (!room.members.empty()) {
+        first_item->appendRow(new LobbyItemExpandedMemberList(members));
+    }
+    return first_item;
+}
+
 void Lobby::OnRefreshLobby() {
     AnnounceMultiplayerRoom::RoomList new_room_list = room_list_watcher.result();
-    for (auto room : new_room_list) {
-        // find the icon for the game if this person owns that game.
-        QPixmap smdh_icon;
-        for (int r = 0; r < game_list->rowCount(); ++r) {
-            auto index = game_list->index(r, 0);
-            auto game_id = game_list->data(index, GameListItemPath::ProgramIdRole).toULongLong();
-            if (game_id != 0 && room.preferred_game_id == game_id) {
-                smdh_icon = game_list->data(index, Qt::DecorationRole).value<QPixmap>();
-            }
-        }
 
-        QList<QVariant> members;
-        for (auto member : room.members) {
-            QVariant var;
-            var.setValue(LobbyMember{QString::fromStdString(member.username),
-                                     QString::fromStdString(member.nickname), member.game_id,
-                                     QString::fromStdString(member.game_name)});
-            members.append(var);
+    std::unordered_map<std::string, AnnounceMultiplayerRoom::Room> new_rooms;
+    std::vector<const AnnounceMultiplayerRoom::Room*> added_rooms;
+    for (auto& room : new_room_list) {
+        const auto shown = shown_rooms.find(room.verify_UID);
+        if (shown == shown_rooms.end() || shown->second != room) {
+            added_rooms.push_back(&room);
         }
+        new_rooms.emplace(room.verify_UID, room);
+    }
 
-        auto first_item = new LobbyItem();
-        auto row = QList<QStandardItem*>({
-            first_item,
-            new LobbyItemName(room.has_password, QString::fromStdString(room.name)),
-            new LobbyItemGame(room.preferred_game_id, QString::fromStdString(room.preferred_game),
-                              smdh_icon),
-            new LobbyItemHost(QString::fromStdString(room.owner), QString::fromStdString(room.ip),
-                              room.port, QString::fromStdString(room.verify_UID)),
-            new LobbyItemMemberList(members, room.max_player),
-        });
-        model->appendRow(row);
-        // To make the rows expandable, add the member data as a child of the first column of the
-        // rows with people in them and have qt set them to colspan after the model is finished
-        // resetting
-        if (!room.description.empty()) {
-            first_item->appendRow(
-                new LobbyItemDescription(QString::fromStdString(room.description)));
+    // Only the rooms that changed are rebuilt, with thousands of rooms doing them all would freeze
+    // the UI on every refresh
+    proxy->setDynamicSortFilter(false);
+    for (int i = model->rowCount() - 1; i >= 0; i--) {
+        const std::string verify_uid = model->item(i, Column::HOST)
+                                           ->data(LobbyItemHost::HostVerifyUIDRole)
+                                           .toString()
+                                           .toStdString();
+        const auto room = new_rooms.find(verify_uid);
+        if (room == new_rooms.end() || room->second != shown_rooms.at(verify_uid)) {
+            model->removeRow(i);
         }
-        if (!room.members.empty()) {
-            first_item->appendRow(new LobbyItemExpandedMemberList(members));
+    }
+    std::vector<QStandardItem*> added_items;
+    if (!added_rooms.empty()) {
+        const auto game_icons = GetGameIcons();
+        for (const auto* room : added_rooms) {
+            added_items.push_back(AddRoom(*room, game_icons));
         }
     }
+    shown_rooms = std::move(new_rooms);
+    proxy->setDynamicSortFilter(true);
 
     // Reenable the refresh button and resize the columns
     ui->refresh_list->setEnabled(true);
     ui->refresh_list->setText(tr("Refresh List"));
+    if (added_items.empty()) {
+        return;
+    }
     ui->room_list->header()->stretchLastSection();
     for (int i = 0; i < Column::TOTAL - 1; ++i) {
         ui->room_list->resizeColumnToContents(i);
     }
 
-    // Set the member list child items to span all columns
-    for (int i = 0; i < proxy->rowCount(); i++) {
-        auto parent = model->item(i, 0);
-        for (int j = 0; j < parent->rowCount(); j++) {
-            ui->room_list->setFirstColumnSpanned(j, proxy->index(i, 0), true);
+    // Set the member list child items of the new rooms to span all columns
+    for (auto* item : added_items) {
+        const QModelIndex index = proxy->mapFromSource(item->index());
+        for (int j = 0; j < item->rowCount(); j++) {
+            ui->room_list->setFirstColumnSpanned(j, index, true);
         }
     }
 }
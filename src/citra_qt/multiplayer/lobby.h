@@ -5,7 +5,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <QDialog>
+#include <QHash>
 #include <QFutureWatcher>
 #include <QSortFilterProxyModel>
 #include <QStandardItemModel>
@@ -49,7 +52,8 @@ public slots:
 
 private slots:
     /**
-     * Pulls the list of rooms from network and fills out the lobby model with the results
+     * Pulls the list of rooms from network and updates the lobby model with the rooms that
+     * changed
      */
     void OnRefreshLobby();
 
@@ -78,6 +82,13 @@ private:
      */
     void ResetModel();
 
+    /// Returns the icons of the games in the game list by their title id
+    QHash<u64, QPixmap> GetGameIcons() const;
+
+    /// Appends the rows of the room to the model, returning its first item
+    QStandardItem* AddRoom(const AnnounceMultiplayerRoom::Room& room,
+                           const QHash<u64, QPixmap>& game_icons);
+
     /**
      * Prompts for a password. Returns an empty QString if the user either did not provide a
      * password or if the user closed the window.
@@ -91,6 +102,8 @@ private:
     LobbyFilterProxyModel* proxy{};
 
     QFutureWatcher<AnnounceMultiplayerRoom::RoomList> room_list_watcher;
+    /// The rooms in the model by their verify UID, to only update the ones that changed
+    std::unordered_map<std::string, AnnounceMultiplayerRoom::Room> shown_rooms;
     std::weak_ptr<Network::AnnounceMultiplayerSession> announce_multiplayer_session;
     QFutureWatcher<void>* watcher;
     Validation validation;
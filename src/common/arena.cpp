@@ -0,0 +1,59 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/alignment.h"
+#include "common/arena.h"
+
+namespace Common {
+
+LinearArena::LinearArena(std::size_t block_size_, std::size_t max_retained_size_)
+    : block_size{block_size_}, max_retained_size{max_retained_size_} {}
+
+LinearArena::~LinearArena() = default;
+
+void* LinearArena::Allocate(std::size_t size, std::size_t alignment) {
+    statistics.bytes += size;
+    statistics.total_bytes += size;
+    statistics.allocations++;
+
+    if (!blocks.empty()) {
+        Block& block = blocks.back();
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const std::size_t aligned = AlignUp(base + offset, alignment) - base;
+        if (aligned + size <= block.size) {
+            offset = aligned + size;
+            return block.data.get() + aligned;
+        }
+    }
+
+    // The allocations of the previous blocks stay valid, the next block takes all new ones
+    const std::size_t new_size = std::max(block_size, size + alignment);
+    Block& block = blocks.emplace_back(Block{std::unique_ptr<u8[]>(new u8[new_size]), new_size});
+    statistics.block_allocations++;
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+    const std::size_t aligned = AlignUp(base, alignment) - base;
+    offset = aligned + size;
+    return block.data.get() + aligned;
+}
+
+void LinearArena::Reset() {
+    statistics.peak_bytes = std::max(statistics.peak_bytes, statistics.bytes);
+    statistics.bytes = 0;
+    statistics.resets++;
+    offset = 0;
+
+    if (blocks.size() > 1) {
+        // The next use gets a single block large enough for everything this one needed
+        std::size_t used_size = 0;
+        for (const Block& block : blocks) {
+            used_size += block.size;
+        }
+        blocks.clear();
+        block_size = std::max(block_size, std::min(used_size, max_retained_size));
+    } else if (!blocks.empty() && blocks.back().size > max_retained_size) {
+        blocks.clear();
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,83 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Linear allocator for short-lived data, e.g. the data of a frame. Allocations are never freed on
+ * their own, all of them are released at once by Reset, which keeps the memory for the next use.
+ * Not thread-safe.
+ */
+class LinearArena {
+public:
+    /// Counters of the memory handed out by the arena
+    struct Statistics {
+        u64 bytes = 0;             ///< Bytes allocated since the last reset
+        u64 peak_bytes = 0;        ///< Most bytes allocated between two resets
+        u64 total_bytes = 0;       ///< Bytes allocated since the arena was created
+        u64 allocations = 0;       ///< Allocations since the arena was created
+        u64 block_allocations = 0; ///< Blocks allocated from the heap for those
+        u64 resets = 0;            ///< Number of resets
+    };
+
+    /**
+     * @param block_size Size of the first block, later blocks are as large as needed
+     * @param max_retained_size Memory kept by a reset at most, the rest is freed
+     */
+    explicit LinearArena(std::size_t block_size, std::size_t max_retained_size);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /// Returns uninitialized memory, which is valid until the next reset
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /// Returns an array of default-initialized values, which is valid until the next reset
+    template <typename T>
+    std::span<T> AllocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "The arena doesn't run destructors");
+        T* const data = static_cast<T*>(
+            Allocate(count * sizeof(T), std::max(alignof(T), alignof(std::max_align_t))));
+        std::uninitialized_default_construct_n(data, count);
+        return {data, count};
+    }
+
+    /// Releases all allocations
+    void Reset();
+
+    /// Returns the number of resets, allocations made since are valid as long as it's the same
+    [[nodiscard]] u64 GetGeneration() const {
+        return statistics.resets;
+    }
+
+    [[nodiscard]] const Statistics& GetStatistics() const {
+        return statistics;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<u8[]> data;
+        std::size_t size;
+    };
+
+    std::size_t block_size;
+    std::size_t max_retained_size;
+    std::vector<Block> blocks;
+    /// Next free byte in the last block
+    std::size_t offset = 0;
+    Statistics statistics;
+};
+
+} // namespace Common
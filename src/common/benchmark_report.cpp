@@ -0,0 +1,83 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/format.h>
+#include "common/benchmark_report.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+
+namespace Common {
+
+namespace {
+
+std::string Quote(std::string_view text) {
+    std::string quoted{'"'};
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            quoted += fmt::format("\\u{:04x}", c);
+        } else {
+            quoted += c;
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+} // Anonymous namespace
+
+BenchmarkReport::BenchmarkReport(std::string tool_) : tool{std::move(tool_)} {}
+
+void BenchmarkReport::AddConfig(std::string key, std::string value) {
+    config.emplace_back(std::move(key), std::move(value));
+}
+
+void BenchmarkReport::AddSample(std::string_view metric, std::string_view unit, Better better,
+                                double value) {
+    auto it = std::find_if(metrics.begin(), metrics.end(),
+                           [metric](const Metric& entry) { return entry.name == metric; });
+    if (it == metrics.end()) {
+        metrics.push_back({std::string{metric}, std::string{unit}, better, {}});
+        it = std::prev(metrics.end());
+    }
+    it->samples.push_back(value);
+}
+
+bool BenchmarkReport::Save(const std::string& path) const {
+    std::string json =
+        fmt::format("{{\n    \"tool\": {},\n    \"version\": {},\n    \"config\": {{",
+                    Quote(tool), Quote(g_scm_desc));
+    for (std::size_t i = 0; i < config.size(); i++) {
+        json += fmt::format("{}\n        {}: {}", i == 0 ? "" : ",", Quote(config[i].first),
+                            Quote(config[i].second));
+    }
+    json += config.empty() ? "},\n    \"metrics\": [" : "\n    },\n    \"metrics\": [";
+    for (std::size_t i = 0; i < metrics.size(); i++) {
+        const Metric& metric = metrics[i];
+        json += fmt::format("{}\n        {{\"name\": {}, \"unit\": {}, \"better\": \"{}\", "
+                            "\"samples\": [",
+                            i == 0 ? "" : ",", Quote(metric.name), Quote(metric.unit),
+                            metric.better == Better::Lower ? "lower" : "higher");
+        for (std::size_t j = 0; j < metric.samples.size(); j++) {
+            // JSON has no representation of infinities and NaNs
+            const double sample = std::isfinite(metric.samples[j]) ? metric.samples[j] : 0.0;
+            json += fmt::format("{}{}", j == 0 ? "" : ", ", sample);
+        }
+        json += "]}";
+    }
+    json += metrics.empty() ? "]\n}\n" : "\n    ]\n}\n";
+
+    if (FileUtil::WriteStringToFile(true, path, json) != json.size()) {
+        LOG_ERROR(Common, "Failed to write the benchmark report {}", path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Common
@@ -0,0 +1,49 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Common {
+
+/**
+ * The results of a benchmark tool, written as JSON for citra-bench to aggregate:
+ *
+ * {"tool": "citra-cpu-bench", "version": "...", "config": {"key": "value", ...},
+ *  "metrics": [{"name": "...", "unit": "...", "better": "lower", "samples": [...]}, ...]}
+ *
+ * A metric has a sample per measurement, e.g. per frame, or a single sample per run.
+ */
+class BenchmarkReport {
+public:
+    enum class Better { Lower, Higher };
+
+    explicit BenchmarkReport(std::string tool);
+
+    /// Records an option the results depend on, e.g. the workload or the resolution
+    void AddConfig(std::string key, std::string value);
+
+    /// Adds a sample of the metric. The metrics are written in the order they were first added.
+    void AddSample(std::string_view metric, std::string_view unit, Better better, double value);
+
+    bool Save(const std::string& path) const;
+
+private:
+    struct Metric {
+        std::string name;
+        std::string unit;
+        Better better;
+        std::vector<double> samples;
+    };
+
+    std::string tool;
+    std::vector<std::pair<std::string, std::string>> config;
+    std::vector<Metric> metrics;
+};
+
+} // namespace Common
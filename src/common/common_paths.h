@@ -58,6 +58,9 @@
 #define DEBUGGER_CONFIG "debugger.ini"
 #define LOGGER_CONFIG "logger.ini"
 
+// Files in the directory returned by GetUserPath(UserPath::CacheDir)
+#define SHARED_FONT_CACHE "shared_font_cache.bin"
+
 // Sys files
 #define SHARED_FONT "shared_font.bin"
 #define AES_KEYS "aes_keys.txt"
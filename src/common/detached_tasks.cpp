@@ -2,9 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <thread>
 #include "common/assert.h"
 #include "common/detached_tasks.h"
+#include "common/thread_pool.h"
 
 namespace Common {
 
@@ -27,14 +27,19 @@ DetachedTasks::~DetachedTasks() {
 }
 
 void DetachedTasks::AddTask(std::function<void()> task) {
-    std::unique_lock lock{instance->mutex};
-    ++instance->count;
-    std::thread([task{std::move(task)}]() {
-        task();
+    {
         std::unique_lock lock{instance->mutex};
-        --instance->count;
-        std::notify_all_at_thread_exit(instance->cv, std::move(lock));
-    }).detach();
+        ++instance->count;
+    }
+    // Nobody waits for the result, the shared pool runs these after the work others wait for
+    ThreadPool::Shared().Submit(
+        [task{std::move(task)}]() {
+            task();
+            std::unique_lock lock{instance->mutex};
+            --instance->count;
+            instance->cv.notify_all();
+        },
+        TaskPriority::Low);
 }
 
 } // namespace Common
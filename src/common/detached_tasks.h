@@ -13,9 +13,10 @@ namespace Common {
  * A background manager which ensures that all detached task is finished before program exits.
  *
  * Some tasks, telemetry submission for example, prefer executing asynchronously and don't care
- * about the result. These tasks are suitable for std::thread::detach(). However, this is unsafe if
- * the task is launched just before the program exits (which is a common case for telemetry), so we
- * need to block on these tasks on program exit.
+ * about the result. These tasks run on the shared thread pool with the lowest priority. However,
+ * the pool is only joined when static variables are destroyed, and the task may be launched just
+ * before the program exits (which is a common case for telemetry), so we need to block on these
+ * tasks on program exit.
  *
  * To make detached task safe, a single DetachedTasks object should be placed in the main(), and
  * call WaitForAllTasks() after all program execution but before global/static variable destruction.
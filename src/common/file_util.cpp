@@ -346,6 +346,21 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+s64 GetModificationTime(const std::string& filename) {
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+    {
+        return static_cast<s64>(buf.st_mtime);
+    }
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 u64 GetSize(const int fd) {
     struct stat buf;
     if (fstat(fd, &buf) != 0) {
@@ -449,7 +464,19 @@ u64 ScanDirectoryTree(const std::string& directory, FSTEntry& parent_entry,
         entry.virtualName = virtual_name;
         entry.physicalName = directory + DIR_SEP + virtual_name;
 
-        if (IsDirectory(entry.physicalName)) {
+        // A single stat tells both the type and the size of the entry
+        struct stat file_info;
+#ifdef _WIN32
+        const int result = _wstat64(Common::UTF8ToUTF16W(entry.physicalName).c_str(), &file_info);
+#else
+        const int result = stat(entry.physicalName.c_str(), &file_info);
+#endif
+        if (result < 0) {
+            LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", entry.physicalName,
+                      GetLastErrorMsg());
+            entry.isDirectory = false;
+            entry.size = 0;
+        } else if (S_ISDIR(file_info.st_mode)) {
             entry.isDirectory = true;
             // is a directory, lets go inside if we didn't recurse to often
             if (recursion > 0) {
@@ -460,7 +487,7 @@ u64 ScanDirectoryTree(const std::string& directory, FSTEntry& parent_entry,
             }
         } else { // is a file
             entry.isDirectory = false;
-            entry.size = GetSize(entry.physicalName);
+            entry.size = static_cast<u64>(file_info.st_size);
         }
         (*num_entries_out)++;
 
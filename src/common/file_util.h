@@ -105,6 +105,9 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds since the epoch, 0 on failure
+[[nodiscard]] s64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -332,6 +335,10 @@ public:
         return nullptr != m_file;
     }
 
+    [[nodiscard]] const std::string& GetFilename() const {
+        return filename;
+    }
+
     // m_good is set to false when a read, write or other function fails
     [[nodiscard]] bool IsGood() const {
         return m_good;
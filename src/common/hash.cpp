@@ -0,0 +1,39 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/hash.h"
+
+namespace Common {
+
+u64 ComputeBulkHash64(const void* data, std::size_t len) noexcept {
+    using detail::HashSecrets;
+    using detail::MultiplyFold;
+    using detail::Read64;
+
+    const auto* bytes = static_cast<const u8*>(data);
+    u64 lane0 = HashSecrets[0] ^ len;
+    u64 lane1 = HashSecrets[1];
+    u64 lane2 = HashSecrets[2];
+
+    // Three independent lanes hide the latency of the multiplications
+    std::size_t offset = 0;
+    for (; len - offset >= 48; offset += 48) {
+        const u8* block = bytes + offset;
+        lane0 = MultiplyFold(Read64(block) ^ HashSecrets[1], Read64(block + 8) ^ lane0);
+        lane1 = MultiplyFold(Read64(block + 16) ^ HashSecrets[2], Read64(block + 24) ^ lane1);
+        lane2 = MultiplyFold(Read64(block + 32) ^ HashSecrets[3], Read64(block + 40) ^ lane2);
+    }
+    u64 hash = lane0 ^ lane1 ^ lane2;
+    for (; len - offset > 16; offset += 16) {
+        hash = MultiplyFold(Read64(bytes + offset) ^ HashSecrets[1],
+                            Read64(bytes + offset + 8) ^ hash);
+    }
+    if (offset != len) {
+        const auto tail = detail::ReadTail128(bytes + offset, len - offset);
+        hash = MultiplyFold(tail[0] ^ HashSecrets[3], tail[1] ^ hash);
+    }
+    return MultiplyFold(hash ^ HashSecrets[0], len ^ HashSecrets[3]);
+}
+
+} // namespace Common
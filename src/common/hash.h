@@ -4,15 +4,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include "common/cityhash.h"
 #include "common/common_types.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace Common {
 
 /**
- * Computes a 64-bit hash over the specified block of data
+ * Computes a 64-bit hash over the specified block of data. The result never changes between
+ * versions, so it is the hash to use for anything written to disk or shared between users, such
+ * as the names of dumped and custom textures.
  * @param data Block of data to compute hash over
  * @param len Length of data (in bytes) to compute hash over
  * @returns 64-bit hash value that was computed over the data block
@@ -21,16 +29,87 @@ static inline u64 ComputeHash64(const void* data, std::size_t len) noexcept {
     return CityHash64(static_cast<const char*>(data), len);
 }
 
+/**
+ * Computes a 64-bit hash over a large block of data, such as the contents of a texture or a shader
+ * program. It is faster than ComputeHash64 on big buffers, but the algorithm may be replaced by a
+ * faster one at any time, so it must only key data that is kept in memory, or on disk behind a
+ * version that covers this file.
+ */
+u64 ComputeBulkHash64(const void* data, std::size_t len) noexcept;
+
+namespace detail {
+
+constexpr std::array<u64, 4> HashSecrets{0xA0761D6478BD642FULL, 0xE7037ED1A0B428DBULL,
+                                         0x8EBC6AF09C88C6E3ULL, 0x589965CC75374CC3ULL};
+
+/// Structs up to this size are hashed inline
+constexpr std::size_t MaxInlineStructHashSize = 512;
+
+/// Multiplies the values to 128 bits and folds the halves together
+inline u64 MultiplyFold(u64 a, u64 b) noexcept {
+#ifdef _MSC_VER
+#ifdef _M_X64
+    u64 high;
+    const u64 low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    return (a * b) ^ __umulh(a, b);
+#endif
+#else
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#endif
+}
+
+inline u64 Read64(const u8* data) noexcept {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// Reads the last bytes of the data, at most 16, zero extended to two words
+inline std::array<u64, 2> ReadTail128(const u8* data, std::size_t len) noexcept {
+    std::array<u64, 2> words{};
+    std::memcpy(words.data(), data, std::min(len, sizeof(words)));
+    return words;
+}
+
+} // namespace detail
+
 /**
  * Computes a 64-bit hash of a struct. In addition to being trivially copyable, it is also critical
  * that either the struct includes no padding, or that any padding is initialized to a known value
  * by memsetting the struct to 0 before filling it in.
+ * Small structs, like the shader configurations that are hashed on every draw, are hashed inline.
+ * Every 16 bytes form an independent product, so that the unrolled loop has no dependency chain.
+ * Like ComputeBulkHash64, the result may change between versions.
  */
 template <typename T>
 static inline u64 ComputeStructHash64(const T& data) noexcept {
     static_assert(std::is_trivially_copyable_v<T>,
                   "Type passed to ComputeStructHash64 must be trivially copyable");
-    return ComputeHash64(&data, sizeof(data));
+    constexpr std::size_t size = sizeof(T);
+    if constexpr (size > detail::MaxInlineStructHashSize) {
+        return ComputeBulkHash64(&data, size);
+    } else {
+        using detail::HashSecrets;
+        using detail::MultiplyFold;
+        using detail::Read64;
+        const auto* bytes = reinterpret_cast<const u8*>(&data);
+        u64 sum = 0;
+        std::size_t offset = 0;
+        for (; offset + 16 <= size; offset += 16) {
+            // The keys differ for every offset, so that moving data around changes the hash
+            const u64 key = HashSecrets[0] * (offset / 16 + 1);
+            sum += MultiplyFold(Read64(bytes + offset) ^ key ^ HashSecrets[1],
+                                Read64(bytes + offset + 8) ^ key ^ HashSecrets[2]);
+        }
+        if constexpr (size % 16 != 0) {
+            const auto tail = detail::ReadTail128(bytes + offset, size - offset);
+            sum += MultiplyFold(tail[0] ^ HashSecrets[3], tail[1] ^ HashSecrets[2]);
+        }
+        return MultiplyFold(sum ^ HashSecrets[1], size ^ HashSecrets[3]);
+    }
 }
 
 /**
@@ -0,0 +1,333 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+
+namespace Common {
+
+#ifdef _WIN32
+namespace {
+
+bool EnableLockMemoryPrivilege() {
+    HANDLE token;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
+    }
+    TOKEN_PRIVILEGES privileges{};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    // AdjustTokenPrivileges succeeds without the privilege being granted, which GetLastError tells
+    const bool enabled =
+        LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+        AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+        GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+    return enabled;
+}
+
+/// Allocates zeroed memory backed by large pages, returns nullptr if they're unavailable
+u8* AllocateLargePages(std::size_t size) {
+    const std::size_t large_page_size = GetLargePageMinimum();
+    if (large_page_size == 0 || !EnableLockMemoryPrivilege()) {
+        return nullptr;
+    }
+    const std::size_t rounded_size =
+        (size + large_page_size - 1) / large_page_size * large_page_size;
+    return static_cast<u8*>(VirtualAlloc(nullptr, rounded_size,
+                                         MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                         PAGE_READWRITE));
+}
+
+} // Anonymous namespace
+#else
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+namespace {
+
+/// Size of the transparent huge pages, which are only used for ranges aligned to it
+constexpr std::size_t HugePageSize = 2 * 1024 * 1024;
+
+/// Reserves the given size of address space aligned to a huge page, returns nullptr on failure
+u8* ReserveHugePageAligned(std::size_t size) {
+    const std::size_t padded_size = size + HugePageSize;
+    void* const pointer =
+        mmap(nullptr, padded_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (pointer == MAP_FAILED) {
+        return nullptr;
+    }
+    u8* const start = static_cast<u8*>(pointer);
+    u8* const aligned = reinterpret_cast<u8*>(
+        (reinterpret_cast<std::uintptr_t>(start) + HugePageSize - 1) & ~(HugePageSize - 1));
+    if (aligned != start) {
+        munmap(start, static_cast<std::size_t>(aligned - start));
+    }
+    munmap(aligned + size, static_cast<std::size_t>(start + padded_size - (aligned + size)));
+    return aligned;
+}
+
+/// Asks the host to back the range with huge pages, returns false if it doesn't support them
+bool AdviseHugePages([[maybe_unused]] void* pointer, [[maybe_unused]] std::size_t size) {
+#ifdef MADV_HUGEPAGE
+    return madvise(pointer, size, MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+}
+
+/// Creates an anonymous shared memory object of the given size, returns -1 on failure
+int CreateSharedMemory(std::size_t size) {
+#if defined(__linux__)
+    // memfd_create isn't exposed by older glibc and bionic versions
+    const int fd = static_cast<int>(syscall(SYS_memfd_create, "HostMemory", 0));
+#else
+    const std::string name = fmt::format("/citra_host_memory.{}", getpid());
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd != -1) {
+        shm_unlink(name.c_str());
+    }
+#endif
+    if (fd == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+} // Anonymous namespace
+#endif
+
+HostMemory::HostMemory(std::size_t backing_size_, bool use_huge_pages)
+    : backing_size{backing_size_} {
+#ifdef _WIN32
+    if (use_huge_pages) {
+        backing_base = AllocateLargePages(backing_size);
+        huge_pages = backing_base != nullptr;
+    }
+    if (backing_base == nullptr) {
+        backing_base = static_cast<u8*>(
+            VirtualAlloc(nullptr, backing_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    }
+#else
+    // The backing replaces the aligned reservation
+    u8* const address = use_huge_pages ? ReserveHugePageAligned(backing_size) : nullptr;
+    const int fixed = address != nullptr ? MAP_FIXED : 0;
+    fd = CreateSharedMemory(backing_size);
+    if (fd != -1) {
+        void* const pointer =
+            mmap(address, backing_size, PROT_READ | PROT_WRITE, MAP_SHARED | fixed, fd, 0);
+        if (pointer != MAP_FAILED) {
+            backing_base = static_cast<u8*>(pointer);
+        } else {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd == -1) {
+        LOG_WARNING(Common_Memory, "Unable to create shared host memory, fastmem is unavailable");
+        void* const pointer = mmap(address, backing_size, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS | fixed, -1, 0);
+        backing_base = pointer != MAP_FAILED ? static_cast<u8*>(pointer) : nullptr;
+    }
+    if (backing_base != nullptr && address != nullptr) {
+        huge_pages = AdviseHugePages(backing_base, backing_size);
+    } else if (backing_base == nullptr && address != nullptr) {
+        munmap(address, backing_size);
+    }
+#endif
+    if (backing_base == nullptr) {
+        throw std::bad_alloc{};
+    }
+    if (use_huge_pages) {
+        if (huge_pages) {
+            LOG_INFO(Common_Memory, "Host memory of size {:#x} is backed by huge pages",
+                     backing_size);
+        } else {
+            LOG_INFO(Common_Memory, "Huge pages are unavailable, using normal pages");
+        }
+    }
+}
+
+HostMemory::~HostMemory() {
+#ifdef _WIN32
+    VirtualFree(backing_base, 0, MEM_RELEASE);
+#else
+    munmap(backing_base, backing_size);
+    if (fd != -1) {
+        close(fd);
+    }
+#endif
+}
+
+void HostMemory::Discard(std::size_t offset, std::size_t length) {
+    ASSERT(offset + length <= backing_size);
+    const std::size_t page_size = PageSize();
+    const std::size_t page_mask = page_size - 1;
+    const std::size_t begin = std::min((offset + page_mask) & ~page_mask, offset + length);
+    const std::size_t end = std::max((offset + length) & ~page_mask, begin);
+
+    // Partial host pages at the edges can only be cleared
+    std::memset(backing_base + offset, 0, begin - offset);
+    std::memset(backing_base + end, 0, offset + length - end);
+    if (begin == end) {
+        return;
+    }
+
+#ifdef _WIN32
+    // Large pages can't be decommitted
+    u8* const pointer = backing_base + begin;
+    if (huge_pages || !VirtualFree(pointer, end - begin, MEM_DECOMMIT) ||
+        !VirtualAlloc(pointer, end - begin, MEM_COMMIT, PAGE_READWRITE)) {
+        std::memset(pointer, 0, end - begin);
+    }
+#else
+    bool discarded = false;
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+    if (fd != -1) {
+        // Punching a hole also clears the aliases of the range in the virtual arenas
+        discarded = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                              static_cast<off_t>(begin), static_cast<off_t>(end - begin)) == 0;
+    }
+#endif
+    if (!discarded && fd == -1) {
+        // Private anonymous pages read as zero after being dropped
+        discarded = madvise(backing_base + begin, end - begin, MADV_DONTNEED) == 0;
+    }
+    if (!discarded) {
+        std::memset(backing_base + begin, 0, end - begin);
+    }
+#endif
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> HostMemory::GetPopulatedRanges(
+    std::size_t offset, std::size_t length) const {
+    ASSERT(offset + length <= backing_size);
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    if (fd != -1) {
+        const auto end = static_cast<off_t>(offset + length);
+        off_t data = static_cast<off_t>(offset);
+        while (data < end) {
+            data = lseek(fd, data, SEEK_DATA);
+            if (data == -1) {
+                // ENXIO means that there is no more data, any other error that the host can't
+                // tell, or that it stopped being able to
+                if (errno != ENXIO) {
+                    ranges.clear();
+                    ranges.emplace_back(offset, length);
+                }
+                return ranges;
+            }
+            if (data >= end) {
+                break;
+            }
+            off_t hole = lseek(fd, data, SEEK_HOLE);
+            if (hole == -1 || hole > end) {
+                hole = end;
+            }
+            ranges.emplace_back(static_cast<std::size_t>(data),
+                                static_cast<std::size_t>(hole - data));
+            data = hole;
+        }
+        return ranges;
+    }
+#endif
+    ranges.emplace_back(offset, length);
+    return ranges;
+}
+
+std::size_t HostMemory::PageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+VirtualArena::VirtualArena(HostMemory& memory_, std::size_t size_) : memory{memory_}, size{size_} {
+#ifndef _WIN32
+    // TODO: Windows requires placeholder views (MapViewOfFile3) to alias the backing in an arena
+    if (!memory.SupportsArenas()) {
+        return;
+    }
+    // Aliases can only use huge pages if the arena is aligned to them as well as the backing
+    if (memory.UsesHugePages()) {
+        base = ReserveHugePageAligned(size);
+    } else {
+        void* const pointer =
+            mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        base = pointer != MAP_FAILED ? static_cast<u8*>(pointer) : nullptr;
+    }
+    if (base == nullptr) {
+        LOG_WARNING(Common_Memory, "Unable to reserve a virtual arena of size {:#x}", size);
+    }
+#endif
+}
+
+VirtualArena::~VirtualArena() {
+#ifndef _WIN32
+    if (base != nullptr) {
+        munmap(base, size);
+    }
+#endif
+}
+
+void VirtualArena::Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length) {
+    if (base == nullptr) {
+        return;
+    }
+    ASSERT(virtual_offset + length <= size && host_offset + length <= memory.backing_size);
+#ifndef _WIN32
+    void* const pointer = mmap(base + virtual_offset, length, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_FIXED, memory.fd, static_cast<off_t>(host_offset));
+    ASSERT_MSG(pointer != MAP_FAILED, "Unable to map {:#x} bytes at arena offset {:#x}", length,
+               virtual_offset);
+    if (memory.huge_pages && length >= HugePageSize) {
+        AdviseHugePages(pointer, length);
+    }
+#endif
+}
+
+void VirtualArena::Unmap(std::size_t virtual_offset, std::size_t length) {
+    if (base == nullptr) {
+        return;
+    }
+    ASSERT(virtual_offset + length <= size);
+#ifndef _WIN32
+    // Replace the range with an inaccessible reservation rather than munmap, so that nothing else
+    // can be allocated inside the arena
+    void* const pointer = mmap(base + virtual_offset, length, PROT_NONE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    ASSERT_MSG(pointer != MAP_FAILED, "Unable to unmap {:#x} bytes at arena offset {:#x}", length,
+               virtual_offset);
+#endif
+}
+
+} // namespace Common
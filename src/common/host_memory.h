@@ -0,0 +1,110 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A zero-initialized block of host memory. When supported by the host, the block is backed by an
+ * anonymous shared memory object so that parts of it can also be mapped into VirtualArenas,
+ * aliasing the same physical pages at a second address.
+ *
+ * The block can be backed by huge pages of the host to reduce TLB misses: transparent huge pages
+ * on Linux, which need to be enabled for shared memory, and large pages on Windows, which need the
+ * privilege to lock pages in memory. Normal pages are used when they're unavailable.
+ */
+class HostMemory {
+public:
+    explicit HostMemory(std::size_t backing_size, bool use_huge_pages = false);
+    ~HostMemory();
+
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    [[nodiscard]] u8* BackingBasePointer() noexcept {
+        return backing_base;
+    }
+
+    [[nodiscard]] const u8* BackingBasePointer() const noexcept {
+        return backing_base;
+    }
+
+    [[nodiscard]] std::size_t BackingSize() const noexcept {
+        return backing_size;
+    }
+
+    /// Returns the granularity of the mappings into virtual arenas
+    [[nodiscard]] static std::size_t PageSize();
+
+    /// Returns true if the backing can be mapped into virtual arenas
+    [[nodiscard]] bool SupportsArenas() const noexcept {
+        return fd != -1;
+    }
+
+    /// Returns true if the backing was asked to use huge pages and the host accepted it
+    [[nodiscard]] bool UsesHugePages() const noexcept {
+        return huge_pages;
+    }
+
+    /// Returns true if the pointer points into the backing memory
+    [[nodiscard]] bool Contains(const u8* pointer) const noexcept {
+        return pointer >= backing_base && pointer < backing_base + backing_size;
+    }
+
+    /// Zeroes a range of the backing memory, returning its pages to the host when possible
+    void Discard(std::size_t offset, std::size_t length);
+
+    /**
+     * Returns the (offset, length) ranges of the given range of the backing memory that may have
+     * been written to. The rest of it reads as zero. When the host can't tell, the whole range
+     * is returned.
+     */
+    [[nodiscard]] std::vector<std::pair<std::size_t, std::size_t>> GetPopulatedRanges(
+        std::size_t offset, std::size_t length) const;
+
+private:
+    friend class VirtualArena;
+
+    std::size_t backing_size;
+    u8* backing_base = nullptr;
+    int fd = -1;
+    bool huge_pages = false;
+};
+
+/**
+ * A range of reserved host address space onto which parts of a HostMemory can be mapped.
+ * Addresses that aren't mapped are inaccessible and fault when accessed.
+ */
+class VirtualArena {
+public:
+    /// Reserves the arena. On failure, BasePointer returns nullptr and mapping is a no-op.
+    VirtualArena(HostMemory& memory, std::size_t size);
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    [[nodiscard]] u8* BasePointer() noexcept {
+        return base;
+    }
+
+    /// Maps the backing memory at host_offset onto the arena at virtual_offset
+    void Map(std::size_t virtual_offset, std::size_t host_offset, std::size_t length);
+
+    /// Makes the given range of the arena inaccessible
+    void Unmap(std::size_t virtual_offset, std::size_t length);
+
+private:
+    HostMemory& memory;
+    std::size_t size;
+    u8* base = nullptr;
+};
+
+} // namespace Common
@@ -3,11 +3,14 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <regex>
 #include <thread>
 #include <vector>
@@ -22,7 +25,6 @@
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
-#include "common/threadsafe_queue.h"
 
 namespace Log {
 
@@ -44,9 +46,32 @@ public:
     const Impl& operator=(Impl const&) = delete;
 
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
-                   const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+                   const char* function, const char* format, const fmt::format_args& args) {
+        using std::chrono::duration_cast;
+        using std::chrono::steady_clock;
+
+        const std::optional<u64> position = ClaimSlot();
+        if (!position) {
+            return;
+        }
+        Slot& slot = slots[*position % slots.size()];
+        Entry& entry = slot.entry;
+        entry.timestamp =
+            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
+        entry.log_class = log_class;
+        entry.log_level = log_level;
+        entry.filename = filename;
+        entry.line_num = line_num;
+        entry.function = function;
+        // The message keeps the buffer of the previous entry of the slot
+        entry.message.clear();
+        fmt::vformat_to(std::back_inserter(entry.message), format, args);
+        slot.sequence.store(*position + 1);
+
+        if (backend_sleeping.load()) {
+            std::scoped_lock lock{wake_mutex};
+            wake_cv.notify_one();
+        }
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -72,62 +97,113 @@ public:
     }
 
 private:
+    /**
+     * A slot of the entry ring. Its sequence is the position it is free for, or that position + 1
+     * once the entry written at it is ready to be written out.
+     */
+    struct Slot {
+        std::atomic<u64> sequence;
+        Entry entry;
+    };
+
     Impl() {
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
         backend_thread = std::thread([&] {
-            Entry entry;
-            auto write_logs = [&](Entry& e) {
+            auto write_logs = [&](const Entry& e) {
                 std::lock_guard lock{writing_mutex};
                 for (const auto& backend : backends) {
                     backend->Write(e);
                 }
             };
-            while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
-                    break;
-                }
-                write_logs(entry);
+            u64 position = 0;
+            while (WaitForSlot(position)) {
+                write_logs(slots[position % slots.size()].entry);
+                ReleaseSlot(position++);
             }
 
             // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a case
             // where a system is repeatedly spamming logs even on close.
             constexpr int MAX_LOGS_TO_WRITE = 100;
             int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
-                write_logs(entry);
+            while (logs_written++ < MAX_LOGS_TO_WRITE && IsSlotReady(position)) {
+                write_logs(slots[position % slots.size()].entry);
+                ReleaseSlot(position++);
             }
         });
     }
 
     ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
+        {
+            std::scoped_lock lock{wake_mutex};
+            stop = true;
+        }
+        wake_cv.notify_one();
         backend_thread.join();
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::steady_clock;
+    /**
+     * Reserves the next free slot, waiting for the backend thread if the ring is full. Messages the
+     * backends log themselves are dropped then, as nothing would free a slot.
+     */
+    std::optional<u64> ClaimSlot() {
+        u64 position = write_position.load(std::memory_order_relaxed);
+        while (true) {
+            const u64 sequence = slots[position % slots.size()].sequence.load();
+            if (sequence == position) {
+                if (write_position.compare_exchange_weak(position, position + 1,
+                                                         std::memory_order_relaxed)) {
+                    return position;
+                }
+            } else if (sequence < position) {
+                // The slot still holds an entry from the previous round of the ring
+                if (std::this_thread::get_id() == backend_thread.get_id()) {
+                    return std::nullopt;
+                }
+                std::this_thread::yield();
+                position = write_position.load(std::memory_order_relaxed);
+            } else {
+                position = write_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
 
-        Entry entry;
-        entry.timestamp =
-            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
-        entry.log_class = log_class;
-        entry.log_level = log_level;
-        entry.filename = filename;
-        entry.line_num = line_nr;
-        entry.function = function;
-        entry.message = std::move(message);
+    bool IsSlotReady(u64 position) const {
+        return slots[position % slots.size()].sequence.load() == position + 1;
+    }
 
-        return entry;
+    void ReleaseSlot(u64 position) {
+        slots[position % slots.size()].sequence.store(position + slots.size());
+    }
+
+    /// Waits until the entry at the position is ready, returns false if logging stopped instead
+    bool WaitForSlot(u64 position) {
+        if (stop.load()) {
+            return false;
+        }
+        if (IsSlotReady(position)) {
+            return true;
+        }
+        std::unique_lock lock{wake_mutex};
+        // Set before checking the slot again, so the thread finishing it knows to wake this one
+        backend_sleeping.store(true);
+        wake_cv.wait(lock, [&] { return stop.load() || IsSlotReady(position); });
+        backend_sleeping.store(false);
+        return !stop.load();
     }
 
     std::mutex writing_mutex;
     std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
-    Common::MPSCQueue<Log::Entry> message_queue;
+
+    /// Fixed ring of entries, whose messages are formatted in place by the logging threads
+    std::array<Slot, 4096> slots;
+    std::atomic<u64> write_position{0};
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::atomic<bool> backend_sleeping{false};
+    std::atomic<bool> stop{false};
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
 };
@@ -300,7 +376,7 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
     auto& instance = Impl::Instance();
-    instance.PushEntry(log_class, log_level, filename, line_num, function,
-                       fmt::vformat(format, args));
+    instance.PushEntry(log_class, log_level, TrimSourcePath(filename), line_num, function, format,
+                       args);
 }
 } // namespace Log
@@ -24,9 +24,8 @@ struct Entry {
     Level log_level;
     const char* filename;
     unsigned int line_num;
-    std::string function;
+    const char* function;
     std::string message;
-    bool final_entry = false;
 
     Entry() = default;
     Entry(Entry&& o) = default;
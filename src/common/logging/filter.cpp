@@ -92,8 +92,4 @@ void Filter::ParseFilterString(std::string_view filter_view) {
     }
 }
 
-bool Filter::CheckMessage(Class log_class, Level level) const {
-    return static_cast<u8>(level) >=
-           static_cast<u8>(class_levels[static_cast<std::size_t>(log_class)]);
-}
 } // namespace Log
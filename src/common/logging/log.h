@@ -147,7 +147,10 @@ public:
     void ParseFilterString(std::string_view filter_view);
 
     /// Matches class/level combination against the filter, returning true if it passed.
-    bool CheckMessage(Class log_class, Level level) const;
+    bool CheckMessage(Class log_class, Level level) const {
+        return static_cast<u8>(level) >=
+               static_cast<u8>(class_levels[static_cast<std::size_t>(log_class)]);
+    }
 
 private:
     std::array<Level, static_cast<std::size_t>(Class::Count)> class_levels;
@@ -156,7 +159,23 @@ extern Filter filter;
 
 void SetGlobalFilter(const Filter& f);
 
-/// Logs a message to the global logger, using fmt
+/**
+ * Messages below this level are compiled out, their arguments aren't even evaluated. It can be set
+ * with the CITRA_LOG_MIN_LEVEL CMake option, by default only debug builds have Trace messages.
+ */
+#ifndef CITRA_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define CITRA_LOG_MIN_LEVEL 0
+#else
+#define CITRA_LOG_MIN_LEVEL 1
+#endif
+#endif
+constexpr Level MinLevel = static_cast<Level>(CITRA_LOG_MIN_LEVEL);
+
+/**
+ * Logs a message to the global logger, using fmt. The filename is trimmed with TrimSourcePath and
+ * the message formatted there, only once the filter passed it.
+ */
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
@@ -164,7 +183,7 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
-    if (!filter.CheckMessage(log_class, log_level))
+    if (log_level < MinLevel || !filter.CheckMessage(log_class, log_level))
         return;
 
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
@@ -175,29 +194,31 @@ void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsig
 
 // Define the fmt lib macros
 #define LOG_GENERIC(log_class, log_level, ...)                                                     \
-    ::Log::FmtLogMessage(log_class, log_level, ::Log::TrimSourcePath(__FILE__), __LINE__,          \
-                         __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(log_class, log_level, __FILE__, __LINE__, __func__, __VA_ARGS__)
 
-#ifdef _DEBUG
+#if CITRA_LOG_MIN_LEVEL <= 0
 #define LOG_TRACE(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Trace,                             \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Trace, __FILE__, __LINE__,         \
+                         __func__, __VA_ARGS__)
 #else
-#define LOG_TRACE(log_class, fmt, ...) (void(0))
+#define LOG_TRACE(log_class, ...) (void(0))
 #endif
-
+#if CITRA_LOG_MIN_LEVEL <= 1
 #define LOG_DEBUG(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Debug,                             \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Debug, __FILE__, __LINE__,         \
+                         __func__, __VA_ARGS__)
+#else
+#define LOG_DEBUG(log_class, ...) (void(0))
+#endif
 #define LOG_INFO(log_class, ...)                                                                   \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Info,                              \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Info, __FILE__, __LINE__,          \
+                         __func__, __VA_ARGS__)
 #define LOG_WARNING(log_class, ...)                                                                \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Warning,                           \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Warning, __FILE__, __LINE__,       \
+                         __func__, __VA_ARGS__)
 #define LOG_ERROR(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Error,                             \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Error, __FILE__, __LINE__,         \
+                         __func__, __VA_ARGS__)
 #define LOG_CRITICAL(log_class, ...)                                                               \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Critical,                          \
-                         ::Log::TrimSourcePath(__FILE__), __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Critical, __FILE__, __LINE__,      \
+                         __func__, __VA_ARGS__)
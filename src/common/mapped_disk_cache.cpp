@@ -0,0 +1,203 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include "common/alignment.h"
+#include "common/logging/log.h"
+#include "common/mapped_disk_cache.h"
+#include "common/mapped_file.h"
+
+namespace Common {
+
+namespace {
+
+constexpr u32 CacheMagic = 0x43444D43; // "CMDC"
+constexpr u32 FormatVersion = 1;
+
+struct Header {
+    u32 magic;
+    u32 format_version;
+    u32 version;
+    u32 reserved;
+};
+static_assert(sizeof(Header) == 16);
+
+struct EntryHeader {
+    u64 key;
+    u64 value_size;
+};
+static_assert(sizeof(EntryHeader) == 16);
+
+constexpr std::size_t EntryAlignment = 8;
+constexpr std::array<u8, EntryAlignment> Padding{};
+
+} // Anonymous namespace
+
+MappedDiskCache::MappedDiskCache() = default;
+
+MappedDiskCache::~MappedDiskCache() {
+    Close();
+}
+
+std::optional<std::size_t> MappedDiskCache::Open(const std::string& path_, u32 version) {
+    Close();
+
+    std::scoped_lock lock{mutex};
+    path = path_;
+    file = FileUtil::IOFile(path, "r+b");
+
+    Header header{};
+    const bool valid = file.IsOpen() && file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+                       header.magic == CacheMagic && header.format_version == FormatVersion &&
+                       header.version == version;
+    if (!valid) {
+        if (file.IsOpen()) {
+            LOG_INFO(Common_Filesystem, "Discarding the outdated cache {}", path);
+        }
+        // Recreate the file
+        const Header new_header{CacheMagic, FormatVersion, version, 0};
+        if (!FileUtil::CreateFullPath(path)) {
+            LOG_ERROR(Common_Filesystem, "Failed to create the directory of the cache {}", path);
+            return std::nullopt;
+        }
+        file = FileUtil::IOFile(path, "w+b");
+        if (!file.IsOpen() || file.WriteObject(new_header) != 1) {
+            LOG_ERROR(Common_Filesystem, "Failed to create the cache {}", path);
+            file.Close();
+            return std::nullopt;
+        }
+        mapped_end = file_end = sizeof(Header);
+        return 0;
+    }
+
+    // Only the entry headers are read, the values are skipped
+    const u64 size = file.GetSize();
+    u64 offset = sizeof(Header);
+    EntryHeader entry{};
+    while (offset + sizeof(EntryHeader) <= size && file.Seek(offset, SEEK_SET) &&
+           file.ReadBytes(&entry, sizeof(entry)) == sizeof(entry)) {
+        const u64 value_offset = offset + sizeof(EntryHeader);
+        if (entry.value_size > size - value_offset) {
+            break;
+        }
+        index.try_emplace(entry.key, Location{value_offset, entry.value_size});
+        offset = AlignUp(value_offset + entry.value_size, EntryAlignment);
+    }
+    offset = std::min(offset, size);
+    if (offset != size) {
+        LOG_WARNING(Common_Filesystem, "Discarding the incomplete entry at the end of the cache {}",
+                    path);
+        file.Resize(offset);
+    }
+    file.Clear();
+    file.Seek(offset, SEEK_SET);
+
+    mapped_end = sizeof(Header);
+    file_end = offset;
+    return index.size();
+}
+
+void MappedDiskCache::Close() {
+    std::scoped_lock lock{mutex};
+    file.Close();
+    index.clear();
+    mappings.clear();
+    mapped_end = file_end = 0;
+}
+
+bool MappedDiskCache::IsOpen() const {
+    std::scoped_lock lock{mutex};
+    return file.IsOpen();
+}
+
+bool MappedDiskCache::Contains(u64 key) const {
+    std::scoped_lock lock{mutex};
+    return index.contains(key);
+}
+
+std::optional<std::span<const u8>> MappedDiskCache::Get(u64 key) {
+    std::scoped_lock lock{mutex};
+    const auto it = index.find(key);
+    if (it == index.end()) {
+        return std::nullopt;
+    }
+    const Location location = it->second;
+    if (location.size == 0) {
+        return std::span<const u8>{};
+    }
+    if (location.offset >= mapped_end && !MapTail()) {
+        return std::nullopt;
+    }
+
+    // Entries never cross mappings, as mappings end at entry boundaries
+    const auto mapping = std::prev(std::upper_bound(
+        mappings.begin(), mappings.end(), location.offset,
+        [](u64 offset, const Mapping& mapping) { return offset < mapping.begin; }));
+    return std::span{mapping->file->Data() + (location.offset - mapping->begin),
+                     static_cast<std::size_t>(location.size)};
+}
+
+std::vector<u64> MappedDiskCache::GetKeys() const {
+    std::scoped_lock lock{mutex};
+    std::vector<u64> keys;
+    keys.reserve(index.size());
+    for (const auto& [key, location] : index) {
+        keys.push_back(key);
+    }
+    return keys;
+}
+
+std::size_t MappedDiskCache::GetNumEntries() const {
+    std::scoped_lock lock{mutex};
+    return index.size();
+}
+
+bool MappedDiskCache::Append(u64 key, std::span<const u8> value) {
+    std::scoped_lock lock{mutex};
+    if (!file.IsOpen() || index.contains(key)) {
+        return false;
+    }
+
+    const EntryHeader entry{key, value.size()};
+    const u64 value_offset = file_end + sizeof(EntryHeader);
+    const u64 end = AlignUp(value_offset + value.size(), EntryAlignment);
+    const std::size_t padding = static_cast<std::size_t>(end - value_offset - value.size());
+    if (file.WriteObject(entry) != 1 ||
+        file.WriteBytes(value.data(), value.size()) != value.size() ||
+        file.WriteBytes(Padding.data(), padding) != padding) {
+        LOG_ERROR(Common_Filesystem, "Failed to append to the cache {}", path);
+        // Drop the partial entry, so that later entries can be found
+        file.Clear();
+        file.Flush();
+        file.Resize(file_end);
+        file.Seek(file_end, SEEK_SET);
+        return false;
+    }
+
+    index.emplace(key, Location{value_offset, value.size()});
+    file_end = end;
+    return true;
+}
+
+void MappedDiskCache::Flush() {
+    std::scoped_lock lock{mutex};
+    file.Flush();
+}
+
+bool MappedDiskCache::MapTail() {
+    // The mapping reads the file, not the buffer of the stream
+    file.Flush();
+    auto mapping = std::make_unique<MappedFile>(path, mapped_end,
+                                                static_cast<std::size_t>(file_end - mapped_end));
+    if (mapping->Data() == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to map the cache {}", path);
+        return false;
+    }
+    mappings.push_back({mapped_end, std::move(mapping)});
+    mapped_end = file_end;
+    return true;
+}
+
+} // namespace Common
@@ -0,0 +1,110 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Common {
+
+class MappedFile;
+
+// On disk format:
+// header{
+// u32 'CMDC';
+// u32 format_version;
+// u32 version;  // given by the owner of the cache
+// u32 reserved;
+//}
+
+// entry{
+// u64 key;
+// u64 value_size;
+// u8 value[value_size];  // padded to 8 bytes
+//}
+
+/**
+ * Persistent key-value store with lazy, random reads. Unlike LinearDiskCache, opening the cache
+ * only reads the entry headers to build the index, the values are memory mapped and paged in
+ * when they're read. Any thread may read and append to the cache.
+ *
+ * Suitable as the storage of caches with many or large entries of which a run only reads a part,
+ * e.g. compiled shaders and textures. A file that was cut off while appending, e.g. by a crash,
+ * loses the incomplete entry only.
+ */
+class MappedDiskCache {
+public:
+    MappedDiskCache();
+    ~MappedDiskCache();
+
+    MappedDiskCache(const MappedDiskCache&) = delete;
+    MappedDiskCache& operator=(const MappedDiskCache&) = delete;
+
+    /**
+     * Opens the cache, creating it if it doesn't exist yet.
+     * @param version the version of the entries, a cache of another version is discarded
+     * @return the number of entries in the cache, or std::nullopt if it couldn't be opened
+     */
+    std::optional<std::size_t> Open(const std::string& path, u32 version);
+
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const;
+
+    [[nodiscard]] bool Contains(u64 key) const;
+
+    /**
+     * Returns the value of the key, or std::nullopt if it isn't in the cache. The value stays
+     * valid until the cache is closed, and can be read without holding on to the cache.
+     */
+    [[nodiscard]] std::optional<std::span<const u8>> Get(u64 key);
+
+    /// Returns the key of every entry, in no particular order
+    [[nodiscard]] std::vector<u64> GetKeys() const;
+
+    [[nodiscard]] std::size_t GetNumEntries() const;
+
+    /**
+     * Appends an entry to the cache.
+     * @return false if the key is already in the cache or the entry couldn't be written
+     */
+    bool Append(u64 key, std::span<const u8> value);
+
+    /// Writes the appended entries through to the file
+    void Flush();
+
+private:
+    struct Location {
+        u64 offset;
+        u64 size;
+    };
+
+    struct Mapping {
+        u64 begin;
+        std::unique_ptr<MappedFile> file;
+    };
+
+    /// Maps the entries appended since the last mapping
+    bool MapTail();
+
+    mutable std::mutex mutex;
+    std::string path;
+    FileUtil::IOFile file;
+    std::unordered_map<u64, Location> index;
+    /// Mappings of consecutive ranges of the file, sorted by offset. They're only dropped on
+    /// close, so that the values read stay valid.
+    std::vector<Mapping> mappings;
+    u64 mapped_end = 0;
+    u64 file_end = 0;
+};
+
+} // namespace Common
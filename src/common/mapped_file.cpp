@@ -0,0 +1,85 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#include "common/string_util.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <limits>
+#include "common/logging/log.h"
+#include "common/mapped_file.h"
+
+namespace Common {
+
+MappedFile::MappedFile(const std::string& path, u64 offset, std::size_t size_) : size{size_} {
+    if (size == 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const u64 view_offset = offset - offset % info.dwAllocationGranularity;
+    view_size = static_cast<std::size_t>(offset - view_offset) + size;
+
+    const HANDLE file =
+        CreateFileW(Common::UTF8ToUTF16W(path).c_str(), GENERIC_READ,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return;
+    }
+    // The view keeps the mapping alive
+    view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(view_offset >> 32),
+                         static_cast<DWORD>(view_offset), view_size);
+    CloseHandle(mapping);
+#else
+    const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 view_offset = offset - offset % page_size;
+    view_size = static_cast<std::size_t>(offset - view_offset) + size;
+    if (view_offset > static_cast<u64>(std::numeric_limits<off_t>::max())) {
+        return;
+    }
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+    // The mapping stays valid after closing the file
+    void* const pointer =
+        mmap(nullptr, view_size, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(view_offset));
+    close(fd);
+    view = pointer != MAP_FAILED ? pointer : nullptr;
+#endif
+
+    if (view == nullptr) {
+        LOG_WARNING(Common_Filesystem, "Unable to map {:#x} bytes of {} at offset {:#x}", size,
+                    path, offset);
+        return;
+    }
+    data = static_cast<const u8*>(view) + (offset - view_offset);
+}
+
+MappedFile::~MappedFile() {
+    if (view == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap(view, view_size);
+#endif
+}
+
+} // namespace Common
@@ -0,0 +1,41 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * A read-only memory mapping of a range of a file. The contents are paged in by the host on
+ * access and share the page cache of the file, instead of being copied to a buffer.
+ */
+class MappedFile {
+public:
+    /// Maps the range of the file. On failure, Data returns nullptr.
+    MappedFile(const std::string& path, u64 offset, std::size_t size);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const u8* Data() const noexcept {
+        return data;
+    }
+
+    [[nodiscard]] std::size_t Size() const noexcept {
+        return size;
+    }
+
+private:
+    const u8* data = nullptr;
+    std::size_t size;
+    void* view = nullptr;       ///< Start of the mapping, aligned to the host granularity
+    std::size_t view_size = 0;
+};
+
+} // namespace Common
@@ -39,6 +39,8 @@ struct Rectangle {
         return Rectangle{left, top, static_cast<T>(left + GetWidth() * s),
                          static_cast<T>(top + GetHeight() * s)};
     }
+
+    [[nodiscard]] constexpr bool operator==(const Rectangle<T>&) const = default;
 };
 
 template <typename T>
@@ -121,6 +121,11 @@ public:
         return MemoryRef(backing_mem, offset + offset_by);
     }
 
+    /// Whether this refers to the same backing memory as `other`, `distance` bytes after it
+    bool Follows(const MemoryRef& other, u64 distance) const {
+        return backing_mem == other.backing_mem && offset == other.offset + distance;
+    }
+
 private:
     std::shared_ptr<BackingMem> backing_mem{};
     u64 offset{};
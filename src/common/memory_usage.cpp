@@ -0,0 +1,52 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <string_view>
+#include "common/logging/log.h"
+#include "common/memory_usage.h"
+
+namespace Common::MemoryUsage {
+
+namespace {
+
+/// Head of the list of registered counters. Constant initialized, so that counters constructed
+/// during static initialization of other translation units can register.
+std::atomic<Counter*> counters{nullptr};
+
+} // Anonymous namespace
+
+Counter::Counter(const char* group_, const char* name_) noexcept : group{group_}, name{name_} {
+    next = counters.load(std::memory_order_relaxed);
+    while (!counters.compare_exchange_weak(next, this, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+}
+
+std::vector<Usage> GetUsages() {
+    std::vector<Usage> usages;
+    for (const Counter* counter = counters.load(std::memory_order_acquire); counter != nullptr;
+         counter = counter->next) {
+        usages.push_back(counter->Get());
+    }
+    std::sort(usages.begin(), usages.end(), [](const Usage& lhs, const Usage& rhs) {
+        const std::string_view lhs_group{lhs.group};
+        const std::string_view rhs_group{rhs.group};
+        if (lhs_group != rhs_group) {
+            return lhs_group < rhs_group;
+        }
+        return std::string_view{lhs.name} < std::string_view{rhs.name};
+    });
+    return usages;
+}
+
+void LogUsages() {
+    for (const Usage& usage : GetUsages()) {
+        LOG_INFO(Common_Memory, "{}/{}: {} KiB in {} objects, peak {} KiB in {} objects",
+                 usage.group, usage.name, usage.bytes / 1024, usage.count,
+                 usage.peak_bytes / 1024, usage.peak_count);
+    }
+}
+
+} // namespace Common::MemoryUsage
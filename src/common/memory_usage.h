@@ -0,0 +1,95 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Registry of the memory held by the subsystems. Every kind of allocation has a counter of the
+ * bytes and objects it currently holds and their peaks, which the debugger, the RPC server and
+ * the log read. The counters are updated from any thread without locking.
+ *
+ * Counters may overlap, e.g. the textures pooled by the rasterizer cache are OpenGL textures too.
+ */
+namespace Common::MemoryUsage {
+
+/// A snapshot of a counter
+struct Usage {
+    const char* group;
+    const char* name;
+    u64 bytes;
+    u64 peak_bytes;
+    u64 count;
+    u64 peak_count;
+};
+
+/**
+ * The memory held by a kind of allocation. Counters are meant to be static, they register
+ * themselves on construction and stay registered. The strings have to outlive the program, e.g.
+ * be literals.
+ */
+class Counter {
+public:
+    Counter(const char* group, const char* name) noexcept;
+
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    void Add(u64 bytes_, u64 count_ = 1) noexcept {
+        UpdatePeak(peak_bytes, bytes.fetch_add(bytes_, std::memory_order_relaxed) + bytes_);
+        UpdatePeak(peak_count, count.fetch_add(count_, std::memory_order_relaxed) + count_);
+    }
+
+    void Remove(u64 bytes_, u64 count_ = 1) noexcept {
+        bytes.fetch_sub(bytes_, std::memory_order_relaxed);
+        count.fetch_sub(count_, std::memory_order_relaxed);
+    }
+
+    /// Replaces the current values, for subsystems that already keep their totals
+    void Set(u64 bytes_, u64 count_) noexcept {
+        bytes.store(bytes_, std::memory_order_relaxed);
+        count.store(count_, std::memory_order_relaxed);
+        UpdatePeak(peak_bytes, bytes_);
+        UpdatePeak(peak_count, count_);
+    }
+
+    Usage Get() const noexcept {
+        return {group,
+                name,
+                bytes.load(std::memory_order_relaxed),
+                peak_bytes.load(std::memory_order_relaxed),
+                count.load(std::memory_order_relaxed),
+                peak_count.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static void UpdatePeak(std::atomic<u64>& peak, u64 value) noexcept {
+        u64 current = peak.load(std::memory_order_relaxed);
+        while (value > current &&
+               !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    friend std::vector<Usage> GetUsages();
+
+    const char* group;
+    const char* name;
+    std::atomic<u64> bytes{0};
+    std::atomic<u64> peak_bytes{0};
+    std::atomic<u64> count{0};
+    std::atomic<u64> peak_count{0};
+    /// The counter registered before this one
+    Counter* next = nullptr;
+};
+
+/// Returns the usage of every counter, sorted by group and name
+std::vector<Usage> GetUsages();
+
+/// Writes the usage of every counter to the log
+void LogUsages();
+
+} // namespace Common::MemoryUsage
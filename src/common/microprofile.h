@@ -11,7 +11,7 @@
 // Customized Citra settings.
 // This file wraps the MicroProfile header so that these are consistent everywhere.
 #define MICROPROFILE_WEBSERVER 0
-#define MICROPROFILE_GPU_TIMERS 0 // TODO: Implement timer queries when we upgrade to OpenGL 3.3
+#define MICROPROFILE_GPU_TIMERS 0 // The trace measures the GPU, see OpenGL::GPUTimer
 #define MICROPROFILE_CONTEXT_SWITCH_TRACE 0
 #define MICROPROFILE_PER_THREAD_BUFFER_SIZE (2048 << 13) // 16 MB
 
@@ -21,5 +21,33 @@ typedef void* HANDLE;
 #endif
 
 #include <microprofile.h>
+#include "common/trace.h"
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
+
+// The scopes are also recorded by the trace recorder, which stays enabled without microprofile
+#undef MICROPROFILE_DECLARE
+#undef MICROPROFILE_DEFINE
+#undef MICROPROFILE_SCOPE
+
+#define CITRA_TRACE_PASTE_IMPL(a, b) a##b
+#define CITRA_TRACE_PASTE(a, b) CITRA_TRACE_PASTE_IMPL(a, b)
+
+#if MICROPROFILE_ENABLED
+#define MICROPROFILE_DECLARE(var)                                                                  \
+    extern MicroProfileToken g_mp_##var;                                                           \
+    extern Common::Trace::Category g_trace_##var
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    MicroProfileToken g_mp_##var =                                                                 \
+        MicroProfileGetToken(group, name, color, MicroProfileTokenTypeCpu);                        \
+    Common::Trace::Category g_trace_##var{group, name}
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    MicroProfileScopeHandler CITRA_TRACE_PASTE(mp_scope_, __LINE__)(g_mp_##var);                  \
+    Common::Trace::Scope CITRA_TRACE_PASTE(trace_scope_, __LINE__)(g_trace_##var)
+#else
+#define MICROPROFILE_DECLARE(var) extern Common::Trace::Category g_trace_##var
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    Common::Trace::Category g_trace_##var{group, name}
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    Common::Trace::Scope CITRA_TRACE_PASTE(trace_scope_, __LINE__)(g_trace_##var)
+#endif
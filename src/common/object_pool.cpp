@@ -0,0 +1,54 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/alignment.h"
+#include "common/object_pool.h"
+
+namespace Common {
+
+FixedSizePool::FixedSizePool(std::size_t block_size_, std::size_t blocks_per_chunk_)
+    : block_size{AlignUp(std::max(block_size_, sizeof(FreeBlock)), alignof(std::max_align_t))},
+      blocks_per_chunk{blocks_per_chunk_} {}
+
+FixedSizePool::~FixedSizePool() = default;
+
+void* FixedSizePool::Allocate() {
+    std::scoped_lock lock{mutex};
+    statistics.allocations++;
+    if (free_list != nullptr) {
+        statistics.reused++;
+        FreeBlock* const block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    // Puts all blocks of the new chunk but the first one on the free list
+    const std::size_t slots_per_block = block_size / sizeof(std::max_align_t);
+    auto& chunk = chunks.emplace_back(new std::max_align_t[slots_per_block * blocks_per_chunk]);
+    statistics.chunk_allocations++;
+    for (std::size_t i = blocks_per_chunk - 1; i > 0; --i) {
+        auto* const block = reinterpret_cast<FreeBlock*>(chunk.get() + i * slots_per_block);
+        block->next = free_list;
+        free_list = block;
+    }
+    return chunk.get();
+}
+
+void FixedSizePool::Free(void* block) {
+    if (block == nullptr) {
+        return;
+    }
+    std::scoped_lock lock{mutex};
+    auto* const free_block = static_cast<FreeBlock*>(block);
+    free_block->next = free_list;
+    free_list = free_block;
+}
+
+FixedSizePool::Statistics FixedSizePool::GetStatistics() const {
+    std::scoped_lock lock{mutex};
+    return statistics;
+}
+
+} // namespace Common
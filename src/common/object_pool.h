@@ -0,0 +1,103 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Allocator of blocks of a fixed size. Freed blocks are kept in a free list for the next
+ * allocations, and the memory is taken from the heap in chunks of many blocks, which is only
+ * released with the pool. Thread-safe.
+ */
+class FixedSizePool {
+public:
+    /// Counters of the blocks handed out by the pool
+    struct Statistics {
+        u64 allocations = 0;       ///< Blocks allocated since the pool was created
+        u64 reused = 0;            ///< Allocations that took a freed block
+        u64 chunk_allocations = 0; ///< Chunks allocated from the heap
+    };
+
+    /**
+     * @param block_size Size of the blocks, rounded up to keep every block aligned for any type
+     * @param blocks_per_chunk Number of blocks allocated from the heap at once
+     */
+    explicit FixedSizePool(std::size_t block_size, std::size_t blocks_per_chunk = 32);
+    ~FixedSizePool();
+
+    FixedSizePool(const FixedSizePool&) = delete;
+    FixedSizePool& operator=(const FixedSizePool&) = delete;
+
+    /// Returns an uninitialized block
+    void* Allocate();
+
+    /// Returns a block from Allocate to the pool
+    void Free(void* block);
+
+    [[nodiscard]] Statistics GetStatistics() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::size_t block_size;
+    std::size_t blocks_per_chunk;
+    mutable std::mutex mutex;
+    FreeBlock* free_list = nullptr;
+    std::vector<std::unique_ptr<std::max_align_t[]>> chunks;
+    Statistics statistics;
+};
+
+/**
+ * Standard allocator taking single objects from a pool per type, e.g. for std::allocate_shared of
+ * the objects that are created and destroyed often. Arrays come from the heap.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t count) {
+        if (count != 1) {
+            return std::allocator<T>{}.allocate(count);
+        }
+        return static_cast<T*>(GetPool().Allocate());
+    }
+
+    void deallocate(T* object, std::size_t count) noexcept {
+        if (count != 1) {
+            std::allocator<T>{}.deallocate(object, count);
+            return;
+        }
+        GetPool().Free(object);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    /// Returns the pool of the objects of the type
+    static FixedSizePool& GetPool() {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Overaligned types are unsupported");
+        // Never destroyed, as objects may be freed by the destructors of other static objects
+        static FixedSizePool& pool = *new FixedSizePool(sizeof(T));
+        return pool;
+    }
+};
+
+} // namespace Common
@@ -0,0 +1,72 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Single writer, multiple reader sequence lock. Readers never block the writer and retry while a
+ * write is in progress, which suits small values that are updated often and read from another
+ * thread, such as input device states.
+ * @tparam T Value type, copied in and out with memcpy
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(std::is_default_constructible_v<T>);
+
+public:
+    SeqLock() {
+        Store(T{});
+    }
+
+    /// Replaces the value, must only be called from the writer thread
+    void Store(const T& value) {
+        std::array<u32, num_words> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const u32 seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < num_words; i++) {
+            data[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Returns a consistent copy of the value
+    T Load() const {
+        std::array<u32, num_words> words;
+        u32 seq_before;
+        u32 seq_after;
+        do {
+            seq_before = sequence.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < num_words; i++) {
+                words[i] = data[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq_after = sequence.load(std::memory_order_relaxed);
+        } while (seq_before != seq_after || (seq_before & 1) != 0);
+
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t num_words = (sizeof(T) + sizeof(u32) - 1) / sizeof(u32);
+
+    /// Odd while a write is in progress
+    std::atomic<u32> sequence{0};
+    std::array<std::atomic<u32>, num_words> data{};
+};
+
+} // namespace Common
@@ -2,9 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <mutex>
 #include <string_view>
 #include <utility>
 #include "audio_core/dsp_interface.h"
+#include "common/seqlock.h"
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -15,7 +17,6 @@
 #include "core/hle/service/ir/ir_user.h"
 #include "core/hle/service/mic_u.h"
 #include "core/hle/service/plgldr/plgldr.h"
-#include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
 namespace Settings {
@@ -23,6 +24,44 @@ namespace Settings {
 Values values = {};
 static bool configuring_global = true;
 
+/// Serializes the writers of the snapshot, as the settings are applied from several threads
+static std::mutex snapshot_mutex;
+static Common::SeqLock<Snapshot> snapshot;
+static u32 snapshot_epoch = 0;
+
+/// Held while the callbacks run, so that a removed callback isn't called anymore
+static std::mutex apply_callbacks_mutex;
+static std::vector<std::pair<std::size_t, ApplyCallback>> apply_callbacks;
+static std::size_t next_apply_callback_id = 0;
+
+static void PublishSnapshot() {
+    std::scoped_lock lock{snapshot_mutex};
+    snapshot.Store({
+        .epoch = ++snapshot_epoch,
+        .resolution_factor = values.resolution_factor.GetValue(),
+        .use_gpu_texture_decode = values.use_gpu_texture_decode.GetValue(),
+        .dump_textures = values.dump_textures.GetValue(),
+        .custom_textures = values.custom_textures.GetValue(),
+        .async_custom_loading = values.async_custom_loading.GetValue(),
+    });
+}
+
+Snapshot GetSnapshot() {
+    return snapshot.Load();
+}
+
+std::size_t AddApplyCallback(ApplyCallback callback) {
+    std::scoped_lock lock{apply_callbacks_mutex};
+    const std::size_t id = next_apply_callback_id++;
+    apply_callbacks.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void RemoveApplyCallback(std::size_t id) {
+    std::scoped_lock lock{apply_callbacks_mutex};
+    std::erase_if(apply_callbacks, [id](const auto& entry) { return entry.first == id; });
+}
+
 void Apply() {
     GDBStub::SetServerPort(values.gdbstub_port.GetValue());
     GDBStub::ToggleServer(values.use_gdbstub.GetValue());
@@ -33,17 +72,11 @@ void Apply() {
     VideoCore::g_separable_shader_enabled = values.separable_shader.GetValue();
     VideoCore::g_hw_shader_accurate_mul = values.shaders_accurate_mul.GetValue();
     VideoCore::g_use_disk_shader_cache = values.use_disk_shader_cache.GetValue();
-
-#ifndef ANDROID
-    if (VideoCore::g_renderer) {
-        VideoCore::g_renderer->UpdateCurrentFramebufferLayout();
-    }
-#endif
+    PublishSnapshot();
 
     VideoCore::g_renderer_bg_color_update_requested = true;
     VideoCore::g_renderer_sampler_update_requested = true;
     VideoCore::g_renderer_shader_update_requested = true;
-    VideoCore::g_texture_filter_update_requested = true;
 
     auto& system = Core::System::GetInstance();
     if (system.IsPoweredOn()) {
@@ -74,6 +107,49 @@ void Apply() {
 
     Service::PLGLDR::PLG_LDR::SetEnabled(values.plugin_loader_enabled.GetValue());
     Service::PLGLDR::PLG_LDR::SetAllowGameChangeState(values.allow_plugin_loader.GetValue());
+
+    const Snapshot applied = GetSnapshot();
+    std::scoped_lock lock{apply_callbacks_mutex};
+    for (const auto& [id, callback] : apply_callbacks) {
+        callback(applied);
+    }
+}
+
+void ApplyDeterministicMode() {
+    if (!values.deterministic) {
+        return;
+    }
+    const auto override_setting = [](auto& setting, const auto& value) {
+        if (setting.GetValue() != value) {
+            LOG_INFO(Config, "Deterministic mode overrides {}", setting.GetLabel());
+            setting.SetValue(value);
+        }
+    };
+    override_setting(values.use_virtual_time, true);
+    override_setting(values.use_multi_core, false);
+    override_setting(values.input_polling_rate, 0u);
+    override_setting(values.use_async_gpu_emulation, false);
+    override_setting(values.async_shader_compilation, false);
+    override_setting(values.lle_dsp_run_ahead, 0u);
+    switch (values.audio_emulation.GetValue()) {
+    case AudioEmulation::HLEMultithreaded:
+        override_setting(values.audio_emulation, AudioEmulation::HLE);
+        break;
+    case AudioEmulation::LLEMultithreaded:
+        override_setting(values.audio_emulation, AudioEmulation::LLE);
+        break;
+    default:
+        break;
+    }
+
+    for (const std::string& name : values.camera_name) {
+        if (!name.empty() && name != "blank" && name != "image") {
+            LOG_WARNING(Config, "Deterministic mode: the {} camera is nondeterministic", name);
+        }
+    }
+    if (values.mic_input_type.GetValue() == MicInputType::Real) {
+        LOG_WARNING(Config, "Deterministic mode: the real microphone is nondeterministic");
+    }
 }
 
 void LogSettings() {
@@ -89,11 +165,23 @@ void LogSettings() {
             return "LLE";
         case AudioEmulation::LLEMultithreaded:
             return "LLE Multithreaded";
+        case AudioEmulation::HLEMultithreaded:
+            return "HLE Multithreaded";
         }
     };
 
     LOG_INFO(Config, "Citra Configuration:");
+    log_setting("Controls_InputPollingRate", values.input_polling_rate.GetValue());
     log_setting("Core_UseCpuJit", values.use_cpu_jit.GetValue());
+    log_setting("Core_UseFastmem", values.use_fastmem.GetValue());
+    log_setting("Core_UseHugePages", values.use_huge_pages.GetValue());
+    log_setting("Core_UseMultiCore", values.use_multi_core.GetValue());
+    log_setting("Core_SkipIdleLoops", values.skip_idle_loops.GetValue());
+    log_setting("Core_RewindInterval", values.rewind_interval.GetValue());
+    log_setting("Core_RewindBufferSize", values.rewind_buffer_size.GetValue());
+    log_setting("Core_BootSnapshotTime", values.boot_snapshot_time.GetValue());
+    log_setting("Core_UsePerfProfiles", values.use_perf_profiles.GetValue());
+    log_setting("Core_TunePerformance", values.tune_performance.GetValue());
     log_setting("Core_CPUClockPercentage", values.cpu_clock_percentage.GetValue());
     log_setting("Renderer_UseGLES", values.use_gles.GetValue());
     log_setting("Renderer_UseHwRenderer", values.use_hw_renderer.GetValue());
@@ -101,8 +189,16 @@ void LogSettings() {
     log_setting("Renderer_SeparableShader", values.separable_shader.GetValue());
     log_setting("Renderer_ShadersAccurateMul", values.shaders_accurate_mul.GetValue());
     log_setting("Renderer_UseShaderJit", values.use_shader_jit.GetValue());
+    log_setting("Renderer_UseAsyncGpuEmulation", values.use_async_gpu_emulation.GetValue());
+    log_setting("Renderer_SwRasterizerThreads", values.sw_rasterizer_threads.GetValue());
+    log_setting("Renderer_VertexShaderThreads", values.vertex_shader_threads.GetValue());
+    log_setting("Renderer_AsyncShaderCompilation", values.async_shader_compilation.GetValue());
+    log_setting("Renderer_UseGpuTextureDecode", values.use_gpu_texture_decode.GetValue());
+    log_setting("Renderer_PresentMode", values.present_mode.GetValue());
     log_setting("Renderer_UseResolutionFactor", values.resolution_factor.GetValue());
     log_setting("Renderer_FrameLimit", values.frame_limit.GetValue());
+    log_setting("Renderer_FrameSkip", values.frame_skip.GetValue());
+    log_setting("Renderer_AdaptivePerformance", values.adaptive_performance.GetValue());
     log_setting("Renderer_VSyncNew", values.use_vsync_new.GetValue());
     log_setting("Renderer_PostProcessingShader", values.pp_shader_name.GetValue());
     log_setting("Renderer_FilterMode", values.filter_mode.GetValue());
@@ -115,8 +211,13 @@ void LogSettings() {
     log_setting("Layout_UprightScreen", values.upright_screen.GetValue());
     log_setting("Utility_DumpTextures", values.dump_textures.GetValue());
     log_setting("Utility_CustomTextures", values.custom_textures.GetValue());
+    log_setting("Utility_AsyncCustomLoading", values.async_custom_loading.GetValue());
+    log_setting("Utility_CustomTexturesCacheSize", values.custom_textures_cache_size.GetValue());
+    log_setting("Utility_ShareCustomTextures", values.share_custom_textures.GetValue());
     log_setting("Utility_UseDiskShaderCache", values.use_disk_shader_cache.GetValue());
     log_setting("Audio_Emulation", to_string(values.audio_emulation.GetValue()));
+    log_setting("Audio_LleDspRunAhead", values.lle_dsp_run_ahead.GetValue());
+    log_setting("Audio_HeadlessDsp", values.headless_dsp.GetValue());
     log_setting("Audio_OutputEngine", values.sink_id.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
     log_setting("Audio_OutputDevice", values.audio_device_id.GetValue());
@@ -140,6 +241,8 @@ void LogSettings() {
     }
     log_setting("System_IsNew3ds", values.is_new_3ds.GetValue());
     log_setting("System_RegionValue", values.region_value.GetValue());
+    log_setting("System_UseVirtualTime", values.use_virtual_time.GetValue());
+    log_setting("System_Deterministic", values.deterministic.GetValue());
     log_setting("System_PluginLoader", values.plugin_loader_enabled.GetValue());
     log_setting("System_PluginLoaderAllowed", values.allow_plugin_loader.GetValue());
     log_setting("Debugging_UseGdbstub", values.use_gdbstub.GetValue());
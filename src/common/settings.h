@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -56,7 +57,14 @@ enum class StereoRenderOption : u32 {
 // implemented
 enum class MonoRenderOption : u32 { LeftEye = 0, RightEye = 1 };
 
-enum class AudioEmulation : u32 { HLE = 0, LLE = 1, LLEMultithreaded = 2 };
+enum class AudioEmulation : u32 { HLE = 0, LLE = 1, LLEMultithreaded = 2, HLEMultithreaded = 3 };
+
+// How rendered frames are handed over to the presentation thread
+enum class PresentMode : u32 {
+    Mailbox = 0,   // Presents the latest frame, older queued frames are dropped
+    Fifo = 1,      // Presents every frame in order, the renderer waits for a free slot
+    Immediate = 2, // Presents the latest frame without waiting for vertical sync
+};
 
 namespace NativeButton {
 
@@ -421,11 +429,25 @@ struct Values {
     int current_input_profile_index;          ///< The current input profile index
     std::vector<InputProfile> input_profiles; ///< The list of input profiles
     std::vector<TouchFromButtonMap> touch_from_button_maps;
+    Setting<u32> input_polling_rate{0, "input_polling_rate"}; ///< In Hz, 0 polls on the CPU thread
 
     // Core
     Setting<bool> use_cpu_jit{true, "use_cpu_jit"};
+    Setting<bool> use_fastmem{true, "use_fastmem"};
+    /// Backs the guest memory with huge pages of the host, falling back to normal pages
+    Setting<bool> use_huge_pages{false, "use_huge_pages"};
+    Setting<bool> use_multi_core{false, "use_multi_core"};
+    Setting<bool> skip_idle_loops{true, "skip_idle_loops"};
     SwitchableSetting<s32, true> cpu_clock_percentage{100, 5, 400, "cpu_clock_percentage"};
     SwitchableSetting<bool> is_new_3ds{true, "is_new_3ds"};
+    Setting<u32> rewind_interval{0, "rewind_interval"}; ///< In emulated ms, 0 disables rewinding
+    Setting<u32> rewind_buffer_size{256, "rewind_buffer_size"}; ///< In MiB
+    /// In emulated ms after booting, 0 disables boot snapshots
+    Setting<u32> boot_snapshot_time{0, "boot_snapshot_time"};
+    /// Applies the performance profile measured for a title, unless its settings override them
+    Setting<bool> use_perf_profiles{true, "use_perf_profiles"};
+    /// Measures candidate settings while a title runs and saves the fastest as its profile
+    Setting<bool> tune_performance{false, "tune_performance"};
 
     // Data Storage
     Setting<bool> use_virtual_sd{true, "use_virtual_sd"};
@@ -436,6 +458,12 @@ struct Values {
     Setting<InitClock> init_clock{InitClock::SystemTime, "init_clock"};
     Setting<u64> init_time{946681277ULL, "init_time"};
     Setting<s64> init_time_offset{0, "init_time_offset"};
+    /// Derives the clock of the guest only from the emulated ticks, starting at init_time, and
+    /// runs as fast as the host allows, so that runs don't depend on the host's speed
+    Setting<bool> use_virtual_time{false, "use_virtual_time"};
+    /// Overrides the settings that let the timing of host threads affect the emulation, see
+    /// ApplyDeterministicMode
+    Setting<bool> deterministic{false, "deterministic"};
     Setting<bool> plugin_loader_enabled{false, "plugin_loader"};
     Setting<bool> allow_plugin_loader{true, "allow_plugin_loader"};
 
@@ -448,8 +476,17 @@ struct Values {
     SwitchableSetting<bool> shaders_accurate_mul{true, "shaders_accurate_mul"};
     SwitchableSetting<bool> use_vsync_new{true, "use_vsync_new"};
     Setting<bool> use_shader_jit{true, "use_shader_jit"};
+    Setting<bool> use_async_gpu_emulation{false, "use_async_gpu_emulation"};
+    Setting<u32> sw_rasterizer_threads{1, "sw_rasterizer_threads"};
+    Setting<u32> vertex_shader_threads{1, "vertex_shader_threads"};
+    Setting<bool> async_shader_compilation{false, "async_shader_compilation"};
+    Setting<bool> use_gpu_texture_decode{false, "use_gpu_texture_decode"};
+    Setting<PresentMode> present_mode{PresentMode::Mailbox, "present_mode"};
     SwitchableSetting<u16, true> resolution_factor{1, 0, 10, "resolution_factor"};
     SwitchableSetting<u16, true> frame_limit{100, 0, 1000, "frame_limit"};
+    Setting<u16> frame_skip{0, "frame_skip"};
+    /// Lowers the resolution and the worker threads while the device throttles, only on Android
+    Setting<bool> adaptive_performance{false, "adaptive_performance"};
     SwitchableSetting<std::string> texture_filter_name{"none", "texture_filter_name"};
 
     SwitchableSetting<LayoutOption> layout_option{LayoutOption::Default, "layout_option"};
@@ -484,10 +521,15 @@ struct Values {
     Setting<bool> dump_textures{false, "dump_textures"};
     Setting<bool> custom_textures{false, "custom_textures"};
     Setting<bool> preload_textures{false, "preload_textures"};
+    Setting<bool> async_custom_loading{true, "async_custom_loading"};
+    Setting<u32> custom_textures_cache_size{1024, "custom_textures_cache_size"};
+    Setting<bool> share_custom_textures{false, "share_custom_textures"};
 
     // Audio
     bool audio_muted;
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
+    Setting<u32, true> lle_dsp_run_ahead{0, 0, 64, "lle_dsp_run_ahead"};
+    Setting<bool> headless_dsp{false, "headless_dsp"};
     Setting<std::string> sink_id{"auto", "output_engine"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
     Setting<std::string> audio_device_id{"auto", "output_device"};
@@ -516,6 +558,9 @@ struct Values {
     std::string video_encoder;
     std::string video_encoder_options;
     u64 video_bitrate;
+    bool video_gpu_conversion;
+    bool video_drop_frames;
+    bool video_separate_screens;
 
     std::string audio_encoder;
     std::string audio_encoder_options;
@@ -532,6 +577,42 @@ float Volume();
 void Apply();
 void LogSettings();
 
+/**
+ * When deterministic is set, makes the emulation only advance at emulated sync points: virtual
+ * time, input polled on the CPU thread, and no GPU, shader, audio or CPU work on other threads
+ * the guest could race with. Logs every setting it overrides, and warns about the inputs that
+ * remain nondeterministic, e.g. a real camera or microphone.
+ */
+void ApplyDeterministicMode();
+
+/**
+ * The settings read by the hot paths, e.g. on every draw. A copy of the values is published on
+ * every Apply, so that reading them costs neither the virtual accessors of the settings nor the
+ * lookup of the game specific values.
+ */
+struct Snapshot {
+    /// Incremented by every Apply, to find out whether the settings changed since the last read
+    u32 epoch;
+    u16 resolution_factor;
+    bool use_gpu_texture_decode;
+    bool dump_textures;
+    bool custom_textures;
+    bool async_custom_loading;
+};
+
+/// Returns the settings as of the last Apply, may be called from any thread
+[[nodiscard]] Snapshot GetSnapshot();
+
+using ApplyCallback = std::function<void(const Snapshot&)>;
+
+/**
+ * Registers a callback that is called after every Apply, on the thread applying the settings, to
+ * update state derived from the settings.
+ * @return the id to remove the callback with
+ */
+std::size_t AddApplyCallback(ApplyCallback callback);
+void RemoveApplyCallback(std::size_t id);
+
 // Restore the global state of all applicable settings in the Values struct
 void RestoreGlobalState(bool is_powered_on);
 
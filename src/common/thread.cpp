@@ -5,6 +5,7 @@
 #include "common/common_funcs.h"
 #include "common/logging/log.h"
 #include "common/thread.h"
+#include "common/trace.h"
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif defined(_WIN32)
@@ -28,12 +29,58 @@
 
 namespace Common {
 
+void SetCurrentThreadPriority(ThreadPriority new_priority) {
+#ifdef _WIN32
+    int windows_priority = THREAD_PRIORITY_NORMAL;
+    switch (new_priority) {
+    case ThreadPriority::Low:
+        windows_priority = THREAD_PRIORITY_BELOW_NORMAL;
+        break;
+    case ThreadPriority::Normal:
+        windows_priority = THREAD_PRIORITY_NORMAL;
+        break;
+    case ThreadPriority::High:
+        windows_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+        break;
+    }
+    SetThreadPriority(GetCurrentThread(), windows_priority);
+#else
+    // Spread the levels over the range of the default policy. Hosts where that range is empty
+    // (e.g. SCHED_OTHER on Linux) keep the current priority.
+    const int min_priority = sched_get_priority_min(SCHED_OTHER);
+    const int max_priority = sched_get_priority_max(SCHED_OTHER);
+    const int level = static_cast<int>(new_priority);
+    sched_param params{};
+    params.sched_priority = min_priority + (max_priority - min_priority) * level / 2;
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &params);
+#endif
+}
+
+void SetCurrentThreadAffinity(u64 mask) {
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(mask));
+#elif defined(__APPLE__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    // These hosts don't let threads be pinned to cores
+    (void)mask;
+#else
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (u32 core = 0; core < 64; ++core) {
+        if ((mask >> core) & 1) {
+            CPU_SET(core, &cpu_set);
+        }
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+}
+
 #ifdef _MSC_VER
 
 // Sets the debugger-visible name of the current thread.
 // Uses trick documented in:
 // https://docs.microsoft.com/en-us/visualstudio/debugger/how-to-set-a-thread-name-in-native-code
 void SetCurrentThreadName(const char* name) {
+    Trace::SetCurrentThreadName(name);
     static const DWORD MS_VC_EXCEPTION = 0x406D1388;
 
 #pragma pack(push, 8)
@@ -61,6 +108,7 @@ void SetCurrentThreadName(const char* name) {
 // MinGW with the POSIX threading model does not support pthread_setname_np
 #if !defined(_WIN32) || defined(_MSC_VER)
 void SetCurrentThreadName(const char* name) {
+    Trace::SetCurrentThreadName(name);
 #ifdef __APPLE__
     pthread_setname_np(name);
 #elif defined(__Bitrig__) || defined(__DragonFly__) || defined(__FreeBSD__) || defined(__OpenBSD__)
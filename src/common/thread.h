@@ -10,6 +10,7 @@
 #include <cstddef>
 #include <mutex>
 #include <thread>
+#include "common/common_types.h"
 
 namespace Common {
 
@@ -62,36 +63,64 @@ private:
 
 class Barrier {
 public:
-    explicit Barrier(std::size_t count_) : count(count_) {}
+    /// @param spin_count Number of times a waiting thread polls the barrier before sleeping, which
+    ///                   avoids a context switch when the others arrive shortly after it
+    explicit Barrier(std::size_t count_, std::size_t spin_count_ = 0)
+        : count(count_), spin_count(spin_count_) {}
 
     /// Blocks until all "count" threads have called Sync()
     void Sync() {
-        std::unique_lock lk{mutex};
-        const std::size_t current_generation = generation;
-
-        if (++waiting == count) {
-            generation++;
-            waiting = 0;
+        const std::size_t current_generation = generation.load(std::memory_order_acquire);
+
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            waiting.store(0, std::memory_order_relaxed);
+            {
+                std::lock_guard lk{mutex};
+                generation.store(current_generation + 1, std::memory_order_release);
+            }
             condvar.notify_all();
-        } else {
-            condvar.wait(lk,
-                         [this, current_generation] { return current_generation != generation; });
+            return;
+        }
+
+        for (std::size_t i = 0; i < spin_count; i++) {
+            if (generation.load(std::memory_order_acquire) != current_generation) {
+                return;
+            }
+            std::this_thread::yield();
         }
+
+        std::unique_lock lk{mutex};
+        condvar.wait(lk, [this, current_generation] {
+            return generation.load(std::memory_order_acquire) != current_generation;
+        });
     }
 
     std::size_t Generation() const {
-        std::unique_lock lk(mutex);
-        return generation;
+        return generation.load(std::memory_order_acquire);
     }
 
 private:
     std::condition_variable condvar;
-    mutable std::mutex mutex;
-    std::size_t count;
-    std::size_t waiting = 0;
-    std::size_t generation = 0; // Incremented once each time the barrier is used
+    std::mutex mutex;
+    const std::size_t count;
+    const std::size_t spin_count;
+    std::atomic<std::size_t> waiting = 0;
+    std::atomic<std::size_t> generation = 0; // Incremented once each time the barrier is used
+};
+
+enum class ThreadPriority : u32 {
+    Low = 0,
+    Normal = 1,
+    High = 2,
 };
 
 void SetCurrentThreadName(const char* name);
 
+/// Changes the scheduling priority of the current thread, as far as the host allows it
+void SetCurrentThreadPriority(ThreadPriority new_priority);
+
+/// Restricts the current thread to the host cores in the mask (bit n for core n), as far as the
+/// host allows it
+void SetCurrentThreadAffinity(u64 mask);
+
 } // namespace Common
@@ -0,0 +1,202 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <fmt/format.h>
+#include "common/thread_pool.h"
+
+namespace Common {
+
+namespace {
+
+/// The pool and the index of the worker running on this thread, if any
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_worker = 0;
+
+} // Anonymous namespace
+
+ThreadPool::ThreadPool(Options options) {
+    const std::size_t num_workers = options.num_workers != 0
+                                        ? options.num_workers
+                                        : std::max(std::thread::hardware_concurrency(), 1u);
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    // The workers are only started once all of them exist, as they steal from each other
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers[i]->thread = std::thread([this, i, options] { WorkerLoop(i, options); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock lock{wake_mutex};
+        stop = true;
+    }
+    wake_cv.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared() {
+    // Background work shouldn't take time from the emulation threads
+    static ThreadPool pool{{.name = "SharedPool", .thread_priority = ThreadPriority::Low}};
+    return pool;
+}
+
+bool ThreadPool::RunPendingTask() {
+    Task task;
+    const std::size_t first =
+        current_pool == this ? current_worker : next_worker.load() % workers.size();
+    if (!TakeTask(first, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::Push(Task task, TaskPriority priority) {
+    // Tasks queued by a worker are likely to use the data it just worked on, so it keeps them
+    const std::size_t index =
+        current_pool == this ? current_worker : next_worker++ % workers.size();
+    Worker& worker = *workers[index];
+    {
+        std::scoped_lock lock{worker.mutex};
+        worker.queues[static_cast<std::size_t>(priority)].push_back(std::move(task));
+    }
+    queued_tasks++;
+    {
+        // Taking the lock orders the count before a sleeping worker checks it
+        std::scoped_lock lock{wake_mutex};
+    }
+    wake_cv.notify_one();
+}
+
+bool ThreadPool::TakeTask(std::size_t first_worker, Task& task) {
+    if (queued_tasks.load() == 0) {
+        return false;
+    }
+    for (std::size_t priority = 0; priority < 3; ++priority) {
+        for (std::size_t offset = 0; offset < workers.size(); ++offset) {
+            Worker& worker = *workers[(first_worker + offset) % workers.size()];
+            std::scoped_lock lock{worker.mutex};
+            auto& queue = worker.queues[priority];
+            if (queue.empty()) {
+                continue;
+            }
+            if (offset == 0) {
+                task = std::move(queue.back());
+                queue.pop_back();
+            } else {
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            queued_tasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(std::size_t index, const Options& options) {
+    SetCurrentThreadName(fmt::format("{}:{}", options.name, index).c_str());
+    SetCurrentThreadPriority(options.thread_priority);
+    if (options.affinity_mask != 0) {
+        SetCurrentThreadAffinity(options.affinity_mask);
+    }
+    current_pool = this;
+    current_worker = index;
+
+    Task task;
+    while (true) {
+        if (TakeTask(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock lock{wake_mutex};
+        wake_cv.wait(lock, [this] { return stop || queued_tasks.load() != 0; });
+        if (stop && queued_tasks.load() == 0) {
+            return;
+        }
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool_, TaskPriority priority_)
+    : pool{pool_}, priority{priority_} {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        Wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::Run(std::function<void()> task) {
+    {
+        std::scoped_lock lock{mutex};
+        ++pending;
+    }
+    pool.Submit(
+        [this, task = std::move(task)] {
+            std::exception_ptr thrown;
+            try {
+                task();
+            } catch (...) {
+                thrown = std::current_exception();
+            }
+            std::scoped_lock lock{mutex};
+            if (thrown && !exception) {
+                exception = thrown;
+            }
+            if (--pending == 0) {
+                done_cv.notify_all();
+            }
+        },
+        priority);
+}
+
+void TaskGroup::RunForEach(std::size_t count, std::function<void(std::size_t)> func) {
+    struct State {
+        std::atomic<std::size_t> next_index{0};
+        std::size_t count;
+        std::function<void(std::size_t)> func;
+    };
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->func = std::move(func);
+
+    const std::size_t num_tasks = std::min(count, pool.GetWorkerCount());
+    for (std::size_t i = 0; i < num_tasks; ++i) {
+        Run([state] {
+            for (std::size_t index = state->next_index++; index < state->count;
+                 index = state->next_index++) {
+                state->func(index);
+            }
+        });
+    }
+}
+
+void TaskGroup::Wait() {
+    std::unique_lock lock{mutex};
+    while (pending != 0) {
+        lock.unlock();
+        const bool ran_task = pool.RunPendingTask();
+        lock.lock();
+        if (!ran_task) {
+            // The remaining tasks are running on the workers. They may queue more tasks, so the
+            // queues are checked again every now and then.
+            done_cv.wait_for(lock, std::chrono::milliseconds{1}, [this] { return pending == 0; });
+        }
+    }
+    if (exception) {
+        std::rethrow_exception(std::exchange(exception, nullptr));
+    }
+}
+
+} // namespace Common
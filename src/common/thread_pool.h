@@ -0,0 +1,139 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread.h"
+
+namespace Common {
+
+/// Queued tasks of a higher class always run before those of a lower one
+enum class TaskPriority : u32 {
+    High = 0,   ///< Work the emulation is waiting for
+    Normal = 1, ///< Work a user is waiting for, e.g. loading caches
+    Low = 2,    ///< Work nobody waits for, e.g. telemetry
+};
+
+/**
+ * A pool of worker threads shared by all subsystems, so that their background work doesn't
+ * oversubscribe the host. Every worker owns a queue per priority: tasks queued from a worker are
+ * taken by it newest first, idle workers steal the oldest tasks of the others.
+ */
+class ThreadPool {
+public:
+    struct Options {
+        /// 0 uses one worker per host core
+        std::size_t num_workers = 0;
+        std::string name = "ThreadPool";
+        ThreadPriority thread_priority = ThreadPriority::Normal;
+        /// Host cores the workers should run on, 0 for any. This is a hint, hosts that can't pin
+        /// threads ignore it.
+        u64 affinity_mask = 0;
+    };
+
+    explicit ThreadPool(Options options);
+    /// Runs the tasks that are still queued and joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Returns the pool shared by the whole program, with one low-priority worker per host core
+    static ThreadPool& Shared();
+
+    /// Queues the function and returns a future for its result, which also carries its exception
+    template <typename Func>
+    auto Submit(Func&& func, TaskPriority priority = TaskPriority::Normal)
+        -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+        using Result = std::invoke_result_t<std::decay_t<Func>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        auto future = task->get_future();
+        Push([task = std::move(task)] { (*task)(); }, priority);
+        return future;
+    }
+
+    /**
+     * Runs one queued task on the calling thread, so that threads waiting for the pool help it
+     * instead of blocking a core.
+     * @return false if no task was queued
+     */
+    bool RunPendingTask();
+
+    [[nodiscard]] std::size_t GetWorkerCount() const {
+        return workers.size();
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker {
+        std::mutex mutex;
+        std::array<std::deque<Task>, 3> queues;
+        std::thread thread;
+    };
+
+    void Push(Task task, TaskPriority priority);
+    bool TakeTask(std::size_t first_worker, Task& task);
+    void WorkerLoop(std::size_t index, const Options& options);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> queued_tasks{0};
+    std::atomic<std::size_t> next_worker{0};
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    bool stop = false;
+};
+
+/**
+ * Runs a set of tasks on a pool and waits for all of them. While waiting, the waiting thread runs
+ * queued tasks itself, so groups can be nested inside tasks without deadlocking the pool.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::Shared(),
+                       TaskPriority priority = TaskPriority::Normal);
+    /// Waits for the tasks, an exception one of them threw is dropped
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void Run(std::function<void()> task);
+
+    /**
+     * Calls func(index) for every index in [0, count), with one task per pool worker that takes
+     * the indices in order. Suited to many tasks of a similar size.
+     */
+    void RunForEach(std::size_t count, std::function<void(std::size_t)> func);
+
+    /// Waits for all tasks that were started and rethrows the first exception one of them threw
+    void Wait();
+
+private:
+    ThreadPool& pool;
+    TaskPriority priority;
+
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    std::size_t pending = 0;
+    std::exception_ptr exception;
+};
+
+} // namespace Common
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <deque>
 #include <boost/serialization/deque.hpp>
 #include <boost/serialization/split_member.hpp>
@@ -23,6 +24,7 @@ struct ThreadQueueList {
 
     // Number of priority levels. (Valid levels are [0..NUM_QUEUES).)
     static constexpr Priority NUM_QUEUES = N;
+    static_assert(NUM_QUEUES <= 64, "The non-empty queues are tracked in a 64-bit mask");
 
     ThreadQueueList() {
         first = nullptr;
@@ -41,54 +43,30 @@ struct ThreadQueueList {
     }
 
     [[nodiscard]] T get_first() const {
-        const Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
+        if (nonempty_mask == 0) {
+            return T();
         }
-
-        return T();
+        return queues[std::countr_zero(nonempty_mask)].data.front();
     }
 
     T pop_first() {
-        Queue* cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
-
-        return T();
+        return pop_from(nonempty_mask);
     }
 
     T pop_first_better(Priority priority) {
-        Queue* cur = first;
-        Queue* stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
-
-        return T();
+        return pop_from(nonempty_mask & ((u64{1} << priority) - 1));
     }
 
     void push_front(Priority priority, const T& thread_id) {
         Queue* cur = &queues[priority];
         cur->data.push_front(thread_id);
+        nonempty_mask |= u64{1} << priority;
     }
 
     void push_back(Priority priority, const T& thread_id) {
         Queue* cur = &queues[priority];
         cur->data.push_back(thread_id);
+        nonempty_mask |= u64{1} << priority;
     }
 
     void move(const T& thread_id, Priority old_priority, Priority new_priority) {
@@ -101,6 +79,9 @@ struct ThreadQueueList {
         Queue* const cur = &queues[priority];
         const auto iter = std::remove(cur->data.begin(), cur->data.end(), thread_id);
         cur->data.erase(iter, cur->data.end());
+        if (cur->data.empty()) {
+            nonempty_mask &= ~(u64{1} << priority);
+        }
     }
 
     void rotate(Priority priority) {
@@ -115,6 +96,7 @@ struct ThreadQueueList {
     void clear() {
         queues.fill(Queue());
         first = nullptr;
+        nonempty_mask = 0;
     }
 
     [[nodiscard]] bool empty(Priority priority) const {
@@ -136,6 +118,21 @@ private:
         std::deque<T> data;
     };
 
+    /// Pops the front of the highest priority non-empty queue among those in the mask
+    T pop_from(u64 mask) {
+        if (mask == 0) {
+            return T();
+        }
+        const auto priority = static_cast<Priority>(std::countr_zero(mask));
+        Queue* const cur = &queues[priority];
+        auto tmp = std::move(cur->data.front());
+        cur->data.pop_front();
+        if (cur->data.empty()) {
+            nonempty_mask &= ~(u64{1} << priority);
+        }
+        return tmp;
+    }
+
     /// Special tag used to mark priority levels that have never been used.
     static Queue* UnlinkedTag() {
         return reinterpret_cast<Queue*>(1);
@@ -158,6 +155,9 @@ private:
 
     // The first queue that's ever been used.
     Queue* first;
+    // Bit i is set when the queue of priority level i isn't empty, so that the highest priority
+    // thread can be found without walking the queues. Not serialized, it is rebuilt on load.
+    u64 nonempty_mask = 0;
     // The priority level queues of thread ids.
     std::array<Queue, NUM_QUEUES> queues;
 
@@ -198,10 +198,14 @@ private:
         s64 idx;
         ar >> idx;
         first = ToPointer(idx);
+        nonempty_mask = 0;
         for (std::size_t i = 0; i < NUM_QUEUES; i++) {
             ar >> idx;
             queues[i].next_nonempty = ToPointer(idx);
             ar >> queues[i].data;
+            if (!queues[i].data.empty()) {
+                nonempty_mask |= u64{1} << i;
+            }
         }
     }
 
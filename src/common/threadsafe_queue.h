@@ -169,4 +169,58 @@ private:
     SPSCQueue<T> spsc_queue;
     std::mutex write_lock;
 };
+
+// a lock-free multiple writer, single reader inbox. Writers never block each other, the reader
+// takes all the pushed elements at once, in the order they were pushed.
+template <typename T>
+class MPSCInbox {
+public:
+    MPSCInbox() = default;
+    ~MPSCInbox() {
+        Drain([](T&&) {});
+    }
+
+    MPSCInbox(const MPSCInbox&) = delete;
+    MPSCInbox& operator=(const MPSCInbox&) = delete;
+
+    [[nodiscard]] bool Empty() const {
+        return head.load(std::memory_order_acquire) == nullptr;
+    }
+
+    template <typename Arg>
+    void Push(Arg&& t) {
+        Node* node = new Node{std::forward<Arg>(t), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    // Calls func for every element pushed so far, in push order. Must only be used by the reader.
+    template <typename Func>
+    void Drain(Func&& func) {
+        // Elements are linked from the most recently pushed one, reverse them first
+        Node* node = head.exchange(nullptr, std::memory_order_acquire);
+        Node* ordered = nullptr;
+        while (node != nullptr) {
+            Node* next = node->next;
+            node->next = ordered;
+            ordered = node;
+            node = next;
+        }
+        while (ordered != nullptr) {
+            Node* next = ordered->next;
+            func(std::move(ordered->value));
+            delete ordered;
+            ordered = next;
+        }
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> head{nullptr};
+};
 } // namespace Common
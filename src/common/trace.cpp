@@ -0,0 +1,199 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/trace.h"
+
+namespace Common::Trace {
+
+class Recorder {
+public:
+    struct Event {
+        const Category* category;
+        u64 begin;
+        u64 end;
+    };
+
+    /// Returns a released track for the current thread, or a new one
+    Track& AcquireTrack() {
+        std::scoped_lock lock{mutex};
+        for (const auto& track : tracks) {
+            if (!track->in_use) {
+                // The events of the previous thread would be attributed to this one
+                track->in_use = true;
+                track->name = "Thread";
+                track->recorded = 0;
+                track->started = 0;
+                return *track;
+            }
+        }
+        return *tracks.emplace_back(std::make_unique<Track>("Thread"));
+    }
+
+    void ReleaseTrack(Track& track) {
+        std::scoped_lock lock{mutex};
+        track.in_use = false;
+    }
+
+    Track& CreateTrack(std::string name) {
+        std::scoped_lock lock{mutex};
+        return *tracks.emplace_back(std::make_unique<Track>(std::move(name)));
+    }
+
+    void SetName(Track& track, const char* name) {
+        std::scoped_lock lock{mutex};
+        track.name = name;
+    }
+
+    bool WriteChromeTrace(const std::string& path) {
+        std::scoped_lock lock{mutex};
+        std::vector<std::vector<Event>> track_events(tracks.size());
+        u64 first_time = ~u64{0};
+        for (std::size_t i = 0; i < tracks.size(); ++i) {
+            track_events[i] = ReadEvents(*tracks[i]);
+            for (const Event& event : track_events[i]) {
+                first_time = std::min(first_time, event.begin);
+            }
+        }
+
+        std::string json = R"({"displayTimeUnit":"ns","traceEvents":[)";
+        json += R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"Citra"}})";
+        for (std::size_t i = 0; i < tracks.size(); ++i) {
+            const std::size_t tid = i + 1;
+            fmt::format_to(std::back_inserter(json),
+                           R"(,{{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+                           R"("args":{{"name":"{}"}}}})",
+                           tid, Escape(tracks[i]->name));
+            for (const Event& event : track_events[i]) {
+                // The times are in microseconds
+                fmt::format_to(std::back_inserter(json),
+                               R"(,{{"name":"{}","cat":"{}","ph":"X","pid":1,"tid":{},)"
+                               R"("ts":{:.3f},"dur":{:.3f}}})",
+                               Escape(event.category->name), Escape(event.category->group), tid,
+                               static_cast<double>(event.begin - first_time) / 1000.0,
+                               static_cast<double>(event.end - event.begin) / 1000.0);
+            }
+        }
+        json += "]}\n";
+
+        const std::string temp_path = path + ".tmp";
+        {
+            FileUtil::IOFile file(temp_path, "wb");
+            if (!file || file.WriteBytes(json.data(), json.size()) != json.size()) {
+                return false;
+            }
+        }
+        return FileUtil::Rename(temp_path, path);
+    }
+
+private:
+    /// Copies the events of the track that aren't being overwritten, from the oldest
+    static std::vector<Event> ReadEvents(const Track& track) {
+        const u64 recorded = track.recorded.load(std::memory_order_acquire);
+        const u64 available = std::min<u64>(recorded, Track::Capacity);
+        std::vector<Event> events;
+        events.reserve(available);
+        for (u64 index = recorded - available; index < recorded; ++index) {
+            const Track::Event& event = track.events[index % Track::Capacity];
+            events.push_back({event.category.load(std::memory_order_relaxed),
+                              event.begin.load(std::memory_order_relaxed),
+                              event.end.load(std::memory_order_relaxed)});
+        }
+        // Events in the slots the owner started writing to since are torn, and dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const u64 started = track.started.load(std::memory_order_relaxed);
+        const u64 first_valid = started > Track::Capacity ? started - Track::Capacity : 0;
+        const u64 first_read = recorded - available;
+        if (first_valid > first_read) {
+            events.erase(events.begin(),
+                         events.begin() + std::min<u64>(first_valid - first_read, events.size()));
+        }
+        return events;
+    }
+
+    static std::string Escape(std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+        }
+        return escaped;
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Track>> tracks;
+};
+
+namespace {
+
+/// Never destroyed, as threads may record events while the program exits
+Recorder& GetRecorder() {
+    static Recorder* recorder = new Recorder;
+    return *recorder;
+}
+
+thread_local Track* current_track = nullptr;
+
+/// Releases the track of the thread when it exits
+struct TrackReleaser {
+    ~TrackReleaser() {
+        GetRecorder().ReleaseTrack(*current_track);
+        current_track = nullptr;
+    }
+};
+
+Track& AcquireCurrentThreadTrack() {
+    current_track = &GetRecorder().AcquireTrack();
+    thread_local TrackReleaser releaser;
+    return *current_track;
+}
+
+} // Anonymous namespace
+
+Track& CurrentThreadTrack() {
+    if (current_track != nullptr) [[likely]] {
+        return *current_track;
+    }
+    return AcquireCurrentThreadTrack();
+}
+
+void SetCurrentThreadName(const char* name) {
+    GetRecorder().SetName(CurrentThreadTrack(), name);
+}
+
+Track& CreateTrack(std::string name) {
+    return GetRecorder().CreateTrack(std::move(name));
+}
+
+bool WriteChromeTrace(const std::string& path) {
+    return GetRecorder().WriteChromeTrace(path);
+}
+
+std::string SaveTrace() {
+    const std::time_t t = std::time(nullptr);
+    const std::string path = fmt::format("{}trace_{:%F-%H-%M-%S}.json",
+                                         FileUtil::GetUserPath(FileUtil::UserPath::LogDir),
+                                         *std::localtime(&t));
+    if (!FileUtil::CreateFullPath(path) || !WriteChromeTrace(path)) {
+        LOG_ERROR(Common, "Could not write the trace to {}", path);
+        return {};
+    }
+    LOG_INFO(Common, "Wrote the trace to {}", path);
+    return path;
+}
+
+} // namespace Common::Trace
@@ -0,0 +1,112 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * Always-on trace recorder. Every thread records the scopes it runs into a ring buffer of its own,
+ * which hold the last moments before a stutter. They are written out on demand as a Chrome trace
+ * (JSON), which chrome://tracing and the Perfetto UI open.
+ *
+ * The scopes come from the MICROPROFILE_SCOPE macros, see common/microprofile.h.
+ */
+namespace Common::Trace {
+
+/// A kind of traced work. The strings have to outlive the program, e.g. be literals.
+struct Category {
+    const char* group;
+    const char* name;
+};
+
+/// Returns the current time of the trace clock in nanoseconds
+inline u64 Now() noexcept {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count());
+}
+
+/**
+ * Ring buffer of the last events of a timeline, usually a thread. Only one thread may record into
+ * a track, the trace can be written from any thread meanwhile.
+ */
+class Track {
+public:
+    static constexpr std::size_t Capacity = 1 << 14;
+
+    explicit Track(std::string name_) : name{std::move(name_)} {}
+
+    void Record(const Category& category, u64 begin, u64 end) noexcept {
+        const u64 index = recorded.load(std::memory_order_relaxed);
+        // Announces the slot being overwritten to the readers, before touching it
+        started.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Event& event = events[index % Capacity];
+        event.category.store(&category, std::memory_order_relaxed);
+        event.begin.store(begin, std::memory_order_relaxed);
+        event.end.store(end, std::memory_order_relaxed);
+        recorded.store(index + 1, std::memory_order_release);
+    }
+
+private:
+    friend class Recorder;
+
+    struct Event {
+        std::atomic<const Category*> category{nullptr};
+        std::atomic<u64> begin{0};
+        std::atomic<u64> end{0};
+    };
+
+    std::string name;
+    /// Whether the thread owning the track is running, tracks of exited threads are reused
+    bool in_use = true;
+    /// Total number of events recorded, and of events started to be recorded
+    std::atomic<u64> recorded{0};
+    std::atomic<u64> started{0};
+    std::array<Event, Capacity> events;
+};
+
+/// Returns the track of the current thread, creating it on the first call
+Track& CurrentThreadTrack();
+
+/// Names the track of the current thread
+void SetCurrentThreadName(const char* name);
+
+/// Creates a track that isn't bound to a thread, e.g. for the work of the host GPU
+Track& CreateTrack(std::string name);
+
+/// Records the time spent in the enclosing scope on the track of the current thread
+class Scope {
+public:
+    explicit Scope(const Category& category_) noexcept : category{category_}, begin{Now()} {}
+    ~Scope() {
+        CurrentThreadTrack().Record(category, begin, Now());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const Category& category;
+    u64 begin;
+};
+
+/**
+ * Writes the events of all tracks as a Chrome trace.
+ * @return false if the file couldn't be written
+ */
+bool WriteChromeTrace(const std::string& path);
+
+/**
+ * Writes the trace to a new file in the log directory.
+ * @return the path of the file, empty if it couldn't be written
+ */
+std::string SaveTrace();
+
+} // namespace Common::Trace
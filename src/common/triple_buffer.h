@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Lock-free exchange of the latest value between one producer and one consumer thread. The
+ * producer fills the write buffer and publishes it, the consumer always reads the most recently
+ * published value. Neither side ever waits for the other.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /// Returns the buffer owned by the producer, to be filled before calling Publish
+    [[nodiscard]] T& WriteBuffer() {
+        return buffers[write_index];
+    }
+
+    /// Makes the contents of the write buffer available to the consumer
+    void Publish() {
+        write_index = middle.exchange(write_index | FRESH_BIT, std::memory_order_acq_rel);
+        write_index &= INDEX_MASK;
+    }
+
+    /// Returns the most recently published value. The reference is valid until the next call.
+    [[nodiscard]] const T& Read() {
+        if (middle.load(std::memory_order_relaxed) & FRESH_BIT) {
+            read_index = middle.exchange(read_index, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return buffers[read_index];
+    }
+
+private:
+    static constexpr u32 INDEX_MASK = 0x3;
+    static constexpr u32 FRESH_BIT = 0x4;
+
+    std::array<T, 3> buffers{};
+    std::atomic<u32> middle{1}; ///< Index of the buffer in between, and whether it is unread
+    u32 write_index = 0;
+    u32 read_index = 2;
+};
+
+} // namespace Common
@@ -17,6 +17,8 @@ struct WebResult {
         HttpError,
         WrongContent,
         NoWebservice,
+        /// The data didn't change since the reply with the ETag given to the request
+        NotModified,
     };
     Code result_code;
     std::string result_string;
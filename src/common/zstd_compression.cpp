@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <zstd.h>
 
 #include "common/assert.h"
@@ -34,8 +35,16 @@ std::vector<u8> CompressDataZSTDDefault(const u8* source, std::size_t source_siz
 }
 
 std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
+    return DecompressFrameZSTD(compressed);
+}
+
+std::vector<u8> DecompressFrameZSTD(std::span<const u8> compressed) {
     const std::size_t decompressed_size =
         ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+    if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
+        return {};
+    }
     std::vector<u8> decompressed(decompressed_size);
 
     const std::size_t uncompressed_result_size = ZSTD_decompress(
@@ -48,4 +57,169 @@ std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
     return decompressed;
 }
 
+bool DecompressFrameZSTD(std::span<const u8> compressed, std::span<u8> destination) {
+    if (ZSTD_getFrameContentSize(compressed.data(), compressed.size()) != destination.size()) {
+        return false;
+    }
+    const std::size_t result_size = ZSTD_decompress(destination.data(), destination.size(),
+                                                    compressed.data(), compressed.size());
+    return !ZSTD_isError(result_size) && result_size == destination.size();
+}
+
+std::vector<std::span<const u8>> SplitFramesZSTD(std::span<const u8> compressed) {
+    std::vector<std::span<const u8>> frames;
+    while (!compressed.empty()) {
+        const std::size_t frame_size =
+            ZSTD_findFrameCompressedSize(compressed.data(), compressed.size());
+        if (ZSTD_isError(frame_size)) {
+            return {};
+        }
+        frames.push_back(compressed.first(frame_size));
+        compressed = compressed.subspan(frame_size);
+    }
+    return frames;
+}
+
+ZSTDCompressionStreamBuffer::ZSTDCompressionStreamBuffer(Sink sink_, s32 compression_level,
+                                                         u32 num_threads)
+    : sink{std::move(sink_)}, context{ZSTD_createCCtx()}, input(ZSTD_CStreamInSize()),
+      output(ZSTD_CStreamOutSize()) {
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel,
+                           std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel()));
+    if (num_threads > 0) {
+        // Fails when zstd was built without threading, in which case the writing thread compresses
+        ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, static_cast<int>(num_threads));
+    }
+    setp(input.data(), input.data() + input.size());
+}
+
+ZSTDCompressionStreamBuffer::~ZSTDCompressionStreamBuffer() {
+    ZSTD_freeCCtx(context);
+}
+
+bool ZSTDCompressionStreamBuffer::Finish() {
+    Compress(pbase(), pptr() - pbase(), true);
+    setp(input.data(), input.data() + input.size());
+    return !failed;
+}
+
+ZSTDCompressionStreamBuffer::int_type ZSTDCompressionStreamBuffer::overflow(int_type ch) {
+    if (!Compress(pbase(), pptr() - pbase(), false)) {
+        return traits_type::eof();
+    }
+    setp(input.data(), input.data() + input.size());
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize ZSTDCompressionStreamBuffer::xsputn(const char_type* data, std::streamsize size) {
+    if (size < epptr() - pptr()) {
+        std::memcpy(pptr(), data, size);
+        pbump(static_cast<int>(size));
+        return size;
+    }
+    // Compress what is buffered, then the written data in place
+    if (!Compress(pbase(), pptr() - pbase(), false) || !Compress(data, size, false)) {
+        return 0;
+    }
+    setp(input.data(), input.data() + input.size());
+    return size;
+}
+
+bool ZSTDCompressionStreamBuffer::Compress(const char_type* data, std::size_t size, bool end) {
+    if (failed) {
+        return false;
+    }
+    ZSTD_inBuffer in{data, size, 0};
+    while (true) {
+        ZSTD_outBuffer out{output.data(), output.size(), 0};
+        const std::size_t remaining =
+            ZSTD_compressStream2(context, &out, &in, end ? ZSTD_e_end : ZSTD_e_continue);
+        if (ZSTD_isError(remaining) || (out.pos > 0 && !sink({output.data(), out.pos}))) {
+            failed = true;
+            return false;
+        }
+        if (end ? remaining == 0 : in.pos == in.size) {
+            return true;
+        }
+    }
+}
+
+ZSTDDecompressionStreamBuffer::ZSTDDecompressionStreamBuffer(Source source_)
+    : source{std::move(source_)}, context{ZSTD_createDCtx()}, input(ZSTD_DStreamInSize()),
+      output(ZSTD_DStreamOutSize()) {
+    setg(output.data(), output.data(), output.data());
+}
+
+ZSTDDecompressionStreamBuffer::~ZSTDDecompressionStreamBuffer() {
+    ZSTD_freeDCtx(context);
+}
+
+ZSTDDecompressionStreamBuffer::int_type ZSTDDecompressionStreamBuffer::underflow() {
+    const std::size_t size = Decompress(output.data(), output.size());
+    if (size == 0) {
+        return traits_type::eof();
+    }
+    setg(output.data(), output.data(), output.data() + size);
+    return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize ZSTDDecompressionStreamBuffer::xsgetn(char_type* data, std::streamsize size) {
+    std::streamsize copied = std::min<std::streamsize>(size, egptr() - gptr());
+    std::memcpy(data, gptr(), copied);
+    gbump(static_cast<int>(copied));
+    while (copied < size) {
+        const auto remaining = static_cast<std::size_t>(size - copied);
+        if (remaining < output.size()) {
+            // Small reads go through the buffer
+            if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                break;
+            }
+            const std::streamsize chunk = std::min<std::streamsize>(remaining, egptr() - gptr());
+            std::memcpy(data + copied, gptr(), chunk);
+            gbump(static_cast<int>(chunk));
+            copied += chunk;
+        } else {
+            const std::size_t decompressed = Decompress(data + copied, remaining);
+            if (decompressed == 0) {
+                break;
+            }
+            copied += decompressed;
+        }
+    }
+    return copied;
+}
+
+std::size_t ZSTDDecompressionStreamBuffer::Decompress(char_type* data, std::size_t size) {
+    ZSTD_outBuffer out{data, size, 0};
+    while (out.pos == 0 && !failed) {
+        if (input_position == input_size && !end_of_input) {
+            input_size = source(input);
+            input_position = 0;
+            end_of_input = input_size == 0;
+        }
+        ZSTD_inBuffer in{input.data(), input_size, input_position};
+        const std::size_t result = ZSTD_decompressStream(context, &out, &in);
+        if (ZSTD_isError(result)) {
+            failed = true;
+            break;
+        }
+        if (result == 0) {
+            in_frame = false;
+        } else if (in.pos != input_position || out.pos > 0) {
+            in_frame = true;
+        }
+        input_position = in.pos;
+        if (end_of_input && out.pos == 0) {
+            // The input must not end in the middle of a frame
+            failed = in_frame;
+            break;
+        }
+    }
+    return out.pos;
+}
+
 } // namespace Common::Compression
@@ -4,10 +4,16 @@
 
 #pragma once
 
+#include <functional>
+#include <span>
+#include <streambuf>
 #include <vector>
 
 #include "common/common_types.h"
 
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
 namespace Common::Compression {
 
 /**
@@ -42,4 +48,108 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed);
 
+/**
+ * Decompresses a single Zstandard frame and returns the uncompressed data in a vector.
+ *
+ * @param compressed the compressed frame.
+ *
+ * @return the decompressed data, or an empty vector on failure.
+ */
+[[nodiscard]] std::vector<u8> DecompressFrameZSTD(std::span<const u8> compressed);
+
+/**
+ * Decompresses a single Zstandard frame into a memory region of the frame's content size.
+ *
+ * @param compressed the compressed frame.
+ * @param destination the memory region receiving the decompressed data.
+ *
+ * @return whether the frame could be decompressed and filled the memory region.
+ */
+[[nodiscard]] bool DecompressFrameZSTD(std::span<const u8> compressed, std::span<u8> destination);
+
+/**
+ * Splits a memory region made of concatenated Zstandard frames into the individual frames, which
+ * can then be decompressed independently.
+ *
+ * @param compressed the compressed source memory region.
+ *
+ * @return the frames, or an empty vector if the region is not a valid sequence of frames.
+ */
+[[nodiscard]] std::vector<std::span<const u8>> SplitFramesZSTD(std::span<const u8> compressed);
+
+/**
+ * Stream buffer that compresses the data written to it into a single Zstandard frame, passing the
+ * compressed data on as it is produced. Large writes are compressed without being copied first.
+ */
+class ZSTDCompressionStreamBuffer final : public std::streambuf {
+public:
+    /// Receives the compressed data, returns whether it could be stored
+    using Sink = std::function<bool(std::span<const u8>)>;
+
+    /**
+     * @param sink the receiver of the compressed data.
+     * @param compression_level the used compression level, 0 for the default level.
+     * @param num_threads the number of threads compressing in the background, 0 to compress on the
+     * writing thread.
+     */
+    ZSTDCompressionStreamBuffer(Sink sink, s32 compression_level, u32 num_threads = 0);
+    ~ZSTDCompressionStreamBuffer() override;
+
+    /**
+     * Compresses the remaining data and ends the frame.
+     *
+     * @return whether all the data was compressed and stored.
+     */
+    [[nodiscard]] bool Finish();
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char_type* data, std::streamsize size) override;
+
+private:
+    bool Compress(const char_type* data, std::size_t size, bool end);
+
+    Sink sink;
+    ZSTD_CCtx_s* context;
+    std::vector<char_type> input;
+    std::vector<u8> output;
+    bool failed = false;
+};
+
+/**
+ * Stream buffer that decompresses Zstandard frames read from a source. Large reads are
+ * decompressed straight into the destination.
+ */
+class ZSTDDecompressionStreamBuffer final : public std::streambuf {
+public:
+    /// Reads compressed data into the buffer, returns the number of bytes read, 0 at the end
+    using Source = std::function<std::size_t(std::span<u8>)>;
+
+    explicit ZSTDDecompressionStreamBuffer(Source source);
+    ~ZSTDDecompressionStreamBuffer() override;
+
+    /// Returns whether the compressed data was invalid or ended in the middle of a frame
+    [[nodiscard]] bool HasFailed() const {
+        return failed;
+    }
+
+protected:
+    int_type underflow() override;
+    std::streamsize xsgetn(char_type* data, std::streamsize size) override;
+
+private:
+    /// Decompresses up to size bytes, returns the number of bytes decompressed, 0 at the end
+    std::size_t Decompress(char_type* data, std::size_t size);
+
+    Source source;
+    ZSTD_DCtx_s* context;
+    std::vector<u8> input;
+    std::size_t input_position = 0;
+    std::size_t input_size = 0;
+    bool end_of_input = false;
+    bool in_frame = false; ///< Whether a frame was started but not finished yet
+    std::vector<char_type> output;
+    bool failed = false;
+};
+
 } // namespace Common::Compression
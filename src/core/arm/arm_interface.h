@@ -231,6 +231,22 @@ public:
 
     virtual void PurgeState() = 0;
 
+    /// Counters of the work done by the backend, for benchmarking
+    struct Statistics {
+        /// Blocks translated since the core was created, not known for the JIT
+        u64 blocks_translated = 0;
+        /// Guest instructions translated since the core was created
+        u64 instructions_translated = 0;
+        /// Exits from the generated code into the memory system or the kernel, only counted by
+        /// the JIT
+        u64 host_calls = 0;
+    };
+
+    /// Returns the counters of the work done by the backend
+    virtual Statistics GetStatistics() const {
+        return {};
+    }
+
     Core::Timing::Timer& GetTimer() {
         return *timer;
     }
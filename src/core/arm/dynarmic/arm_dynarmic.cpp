@@ -3,10 +3,13 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#include <optional>
 #include <dynarmic/interface/A32/a32.h>
 #include <dynarmic/interface/A32/context.h>
 #include <dynarmic/interface/optimization_flags.h>
 #include "common/assert.h"
+#include "common/atomic_ops.h"
+#include "common/memory_usage.h"
 #include "common/microprofile.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
@@ -71,6 +74,8 @@ private:
     u32 fpexc;
 };
 
+// While the cores run in parallel, every callback that may reach the kernel, HLE or MMIO handlers
+// acquires the core context first. Tick accounting only touches the timer of this core.
 class DynarmicUserCallbacks final : public Dynarmic::A32::UserCallbacks {
 public:
     explicit DynarmicUserCallbacks(ARM_Dynarmic& parent)
@@ -78,44 +83,98 @@ public:
     ~DynarmicUserCallbacks() = default;
 
     std::uint8_t MemoryRead8(VAddr vaddr) override {
+        if (const auto pointer = GetDirectPointer<u8>(vaddr)) {
+            return *pointer;
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.Read8(vaddr);
     }
     std::uint16_t MemoryRead16(VAddr vaddr) override {
+        if (const auto pointer = GetDirectPointer<u16>(vaddr)) {
+            return *pointer;
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.Read16(vaddr);
     }
     std::uint32_t MemoryRead32(VAddr vaddr) override {
+        if (const auto pointer = GetDirectPointer<u32>(vaddr)) {
+            return *pointer;
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.Read32(vaddr);
     }
     std::uint64_t MemoryRead64(VAddr vaddr) override {
+        if (const auto pointer = GetDirectPointer<u64>(vaddr)) {
+            return *pointer;
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.Read64(vaddr);
     }
 
     void MemoryWrite8(VAddr vaddr, std::uint8_t value) override {
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         memory.Write8(vaddr, value);
     }
     void MemoryWrite16(VAddr vaddr, std::uint16_t value) override {
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         memory.Write16(vaddr, value);
     }
     void MemoryWrite32(VAddr vaddr, std::uint32_t value) override {
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         memory.Write32(vaddr, value);
     }
     void MemoryWrite64(VAddr vaddr, std::uint64_t value) override {
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         memory.Write64(vaddr, value);
     }
 
     bool MemoryWriteExclusive8(u32 vaddr, u8 value, u8 expected) override {
+        if (const auto pointer = GetDirectPointer<u8>(vaddr)) {
+            return Common::AtomicCompareAndSwap(pointer, value, expected);
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.WriteExclusive8(vaddr, value, expected);
     }
     bool MemoryWriteExclusive16(u32 vaddr, u16 value, u16 expected) override {
+        if (const auto pointer = GetDirectPointer<u16>(vaddr)) {
+            return Common::AtomicCompareAndSwap(pointer, value, expected);
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.WriteExclusive16(vaddr, value, expected);
     }
     bool MemoryWriteExclusive32(u32 vaddr, u32 value, u32 expected) override {
+        if (const auto pointer = GetDirectPointer<u32>(vaddr)) {
+            return Common::AtomicCompareAndSwap(pointer, value, expected);
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.WriteExclusive32(vaddr, value, expected);
     }
     bool MemoryWriteExclusive64(u32 vaddr, u64 value, u64 expected) override {
+        if (const auto pointer = GetDirectPointer<u64>(vaddr)) {
+            return Common::AtomicCompareAndSwap(pointer, value, expected);
+        }
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         return memory.WriteExclusive64(vaddr, value, expected);
     }
 
+    std::optional<std::uint32_t> MemoryReadCode(VAddr vaddr) override {
+        // The JIT reads the guest code through this while translating it
+        parent.statistics.instructions_translated++;
+        return MemoryRead32(vaddr);
+    }
+
     void InterpreterFallback(VAddr pc, std::size_t num_instructions) override {
         // Should never happen.
         UNREACHABLE_MSG("InterpeterFallback reached with pc = 0x{:08x}, code = 0x{:08x}, num = {}",
@@ -123,10 +182,17 @@ public:
     }
 
     void CallSVC(std::uint32_t swi) override {
+        parent.statistics.host_calls++;
+        if (svc_context.CallFastSVC(parent, swi)) {
+            return;
+        }
+        const auto lock = parent.system.AcquireCoreContext(parent);
         svc_context.CallSVC(swi);
     }
 
     void ExceptionRaised(VAddr pc, Dynarmic::A32::Exception exception) override {
+        parent.statistics.host_calls++;
+        const auto lock = parent.system.AcquireCoreContext(parent);
         switch (exception) {
         case Dynarmic::A32::Exception::UndefinedInstruction:
         case Dynarmic::A32::Exception::UnpredictableInstruction:
@@ -166,11 +232,32 @@ public:
         return Core::TicksForInstruction(is_thumb, instruction);
     }
 
+    /**
+     * Returns a pointer to an aligned access to plain memory in the page table of this core, or
+     * nullptr. Such accesses don't depend on the core context, so exclusive accesses through the
+     * callbacks are atomic on the host without serializing the cores.
+     */
+    template <typename T>
+    volatile T* GetDirectPointer(VAddr vaddr) {
+        if (vaddr % sizeof(T) != 0) {
+            return nullptr;
+        }
+        u8* const page_pointer =
+            parent.current_page_table->pointers[vaddr >> Memory::CITRA_PAGE_BITS];
+        if (!page_pointer) {
+            return nullptr;
+        }
+        return reinterpret_cast<volatile T*>(page_pointer + (vaddr & Memory::CITRA_PAGE_MASK));
+    }
+
     ARM_Dynarmic& parent;
     Kernel::SVCContext svc_context;
     Memory::MemorySystem& memory;
 };
 
+/// The code caches are reserved whole when a JIT is created, one per core and page table
+static Common::MemoryUsage::Counter JitUsage{"Dynarmic", "Code caches"};
+
 ARM_Dynarmic::ARM_Dynarmic(Core::System* system_, Memory::MemorySystem& memory_, u32 core_id_,
                            std::shared_ptr<Core::Timing::Timer> timer_,
                            Core::ExclusiveMonitor& exclusive_monitor_)
@@ -180,7 +267,9 @@ ARM_Dynarmic::ARM_Dynarmic(Core::System* system_, Memory::MemorySystem& memory_,
     SetPageTable(memory.GetCurrentPageTable());
 }
 
-ARM_Dynarmic::~ARM_Dynarmic() = default;
+ARM_Dynarmic::~ARM_Dynarmic() {
+    JitUsage.Remove(jit_code_cache_size, jits.size());
+}
 
 MICROPROFILE_DEFINE(ARM_Jit, "ARM JIT", "ARM JIT", MP_RGB(255, 64, 64));
 
@@ -358,6 +447,15 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     Dynarmic::A32::UserConfig config;
     config.callbacks = cb.get();
     config.page_table = &current_page_table->GetPointerArray();
+    // Accesses to pages that are inaccessible in the arena (MMIO, rasterizer-cached and unmapped
+    // memory) fault, and the faulting instruction is recompiled to go through the callbacks.
+    if (current_page_table->fastmem_base) {
+        config.fastmem_pointer = current_page_table->fastmem_base;
+        config.recompile_on_fastmem_failure = true;
+        // Exclusive accesses are then also inlined as host compare-and-swap on the arena
+        config.fastmem_exclusive_access = true;
+        config.recompile_on_exclusive_fastmem_failure = true;
+    }
     config.coprocessors[15] = std::make_shared<DynarmicCP15>(cp15_state);
     config.define_unpredictable_behaviour = true;
 
@@ -365,9 +463,15 @@ std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
     config.processor_id = GetID();
     config.global_monitor = &exclusive_monitor.monitor;
 
+    jit_code_cache_size += config.code_cache_size;
+    JitUsage.Add(config.code_cache_size);
     return std::make_unique<Dynarmic::A32::Jit>(config);
 }
 
 void ARM_Dynarmic::PurgeState() {
     ClearInstructionCache();
 }
+
+ARM_Interface::Statistics ARM_Dynarmic::GetStatistics() const {
+    return statistics;
+}
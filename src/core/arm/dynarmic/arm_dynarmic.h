@@ -58,6 +58,7 @@ public:
     void ClearExclusiveState() override;
     void SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) override;
     void PurgeState() override;
+    Statistics GetStatistics() const override;
 
 protected:
     std::shared_ptr<Memory::PageTable> GetPageTable() const override;
@@ -72,10 +73,13 @@ private:
     std::unique_ptr<Dynarmic::A32::Jit> MakeJit();
 
     u32 fpexc = 0;
+    Statistics statistics;
     CP15State cp15_state;
     Core::DynarmicExclusiveMonitor& exclusive_monitor;
 
     Dynarmic::A32::Jit* jit = nullptr;
     std::shared_ptr<Memory::PageTable> current_page_table = nullptr;
     std::map<std::shared_ptr<Memory::PageTable>, std::unique_ptr<Dynarmic::A32::Jit>> jits;
+    /// Total size of the code caches of the JITs
+    std::size_t jit_code_cache_size = 0;
 };
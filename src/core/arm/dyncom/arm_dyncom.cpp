@@ -87,12 +87,14 @@ void ARM_DynCom::Step() {
 }
 
 void ARM_DynCom::ClearInstructionCache() {
-    state->instruction_cache.clear();
-    trans_cache_buf_top = 0;
+    ResetTranslationCache();
+    state->ClearBlocks();
+    state->trans_cache_generation = trans_cache_generation;
 }
 
-void ARM_DynCom::InvalidateCacheRange(u32, std::size_t) {
-    ClearInstructionCache();
+void ARM_DynCom::InvalidateCacheRange(u32 start_address, std::size_t length) {
+    // The translations stay in the cache until it fills up, only the lookups are dropped
+    state->InvalidateBlocks(start_address, length);
 }
 
 void ARM_DynCom::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) {
@@ -105,6 +107,10 @@ std::shared_ptr<Memory::PageTable> ARM_DynCom::GetPageTable() const {
 
 void ARM_DynCom::PurgeState() {}
 
+ARM_Interface::Statistics ARM_DynCom::GetStatistics() const {
+    return {state->blocks_translated, state->instructions_translated, 0};
+}
+
 void ARM_DynCom::SetPC(u32 pc) {
     state->Reg[15] = pc;
 }
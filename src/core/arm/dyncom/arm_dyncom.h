@@ -52,6 +52,7 @@ public:
     void SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) override;
     void PrepareReschedule() override;
     void PurgeState() override;
+    Statistics GetStatistics() const override;
 
 protected:
     std::shared_ptr<Memory::PageTable> GetPageTable() const override;
@@ -857,6 +857,7 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
     while (ret == TransExtData::NON_BRANCH) {
         u32 inst_size = InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
         phys_addr += inst_size;
+        cpu->instructions_translated++;
 
         if ((phys_addr & 0xfff) == 0) {
             inst_base->br = TransExtData::END_OF_PAGE;
@@ -864,7 +865,7 @@ static int InterpreterTranslateBlock(ARMul_State* cpu, std::size_t& bb_start, u3
         ret = inst_base->br;
     };
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->AddBlock(pc_start, bb_start);
 
     return KEEP_GOING;
 }
@@ -879,12 +880,13 @@ static int InterpreterTranslateSingle(ARMul_State* cpu, std::size_t& bb_start, u
     u32 pc_start = cpu->Reg[15];
 
     InterpreterTranslateInstruction(cpu, phys_addr, inst_base);
+    cpu->instructions_translated++;
 
     if (inst_base->br == TransExtData::NON_BRANCH) {
         inst_base->br = TransExtData::SINGLE_STEP;
     }
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    cpu->AddBlock(pc_start, bb_start);
 
     return KEEP_GOING;
 }
@@ -1640,16 +1642,29 @@ DISPATCH : {
     else
         cpu->Reg[15] &= 0xfffffffc;
 
+    // Another core emptied the translation cache, so our blocks are gone
+    if (cpu->trans_cache_generation != trans_cache_generation) {
+        cpu->ClearBlocks();
+        cpu->trans_cache_generation = trans_cache_generation;
+    }
+
     // Find the cached instruction cream, otherwise translate it...
-    auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-    if (itr != cpu->instruction_cache.end()) {
-        ptr = itr->second;
-    } else if (cpu->NumInstrsToExecute != 1) {
-        if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
-    } else {
-        if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
-            goto END;
+    ptr = cpu->FindBlock(cpu->Reg[15]);
+    if (ptr == static_cast<std::size_t>(-1)) {
+        // Invalidated blocks aren't reclaimed, start over once the cache is nearly full
+        if (TRANS_CACHE_SIZE - trans_cache_buf_top < TRANS_CACHE_BLOCK_RESERVE) {
+            ResetTranslationCache();
+            cpu->ClearBlocks();
+            cpu->trans_cache_generation = trans_cache_generation;
+        }
+
+        if (cpu->NumInstrsToExecute != 1) {
+            if (InterpreterTranslateBlock(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                goto END;
+        } else {
+            if (InterpreterTranslateSingle(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+                goto END;
+        }
     }
 
 #ifndef ANDROID
@@ -496,3 +496,12 @@ extern const std::size_t arm_instruction_trans_len;
 #define TRANS_CACHE_SIZE (64 * 1024 * 2000)
 extern char trans_cache_buf[TRANS_CACHE_SIZE];
 extern std::size_t trans_cache_buf_top;
+
+// Space that must be left in the translation cache before translating a block. Blocks end at page
+// boundaries, so this comfortably fits a page of Thumb instructions with their creams.
+#define TRANS_CACHE_BLOCK_RESERVE (1024 * 1024)
+
+// Incremented whenever the translation cache is emptied, which invalidates the blocks of all cores
+extern u64 trans_cache_generation;
+
+void ResetTranslationCache();
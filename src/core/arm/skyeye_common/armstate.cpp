@@ -126,6 +126,59 @@ void ARMul_State::Reset() {
     Emulate = RUN;
 }
 
+void ARMul_State::AddBlock(u32 pc, std::size_t offset) {
+    instruction_cache[pc] = offset;
+    page_blocks[pc >> Memory::CITRA_PAGE_BITS].push_back(pc);
+    block_cache[(pc >> 1) % block_cache.size()] = {pc, offset};
+    blocks_translated++;
+}
+
+void ARMul_State::ClearBlocks() {
+    instruction_cache.clear();
+    page_blocks.clear();
+    block_cache.fill({});
+}
+
+void ARMul_State::InvalidateBlocks(u32 start_address, std::size_t length) {
+    if (length == 0) {
+        return;
+    }
+    const u32 first_page = start_address >> Memory::CITRA_PAGE_BITS;
+    const u32 last_page =
+        static_cast<u32>((start_address + length - 1) >> Memory::CITRA_PAGE_BITS);
+
+    const auto invalidate_page = [this](std::vector<u32>& blocks) {
+        for (const u32 pc : blocks) {
+            instruction_cache.erase(pc);
+            BlockCacheEntry& entry = block_cache[(pc >> 1) % block_cache.size()];
+            if (entry.pc == pc) {
+                entry = {};
+            }
+        }
+    };
+
+    // Large ranges are cheaper to handle by walking the pages that do have blocks
+    if (last_page - first_page >= page_blocks.size()) {
+        for (auto itr = page_blocks.begin(); itr != page_blocks.end();) {
+            if (itr->first >= first_page && itr->first <= last_page) {
+                invalidate_page(itr->second);
+                itr = page_blocks.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+        return;
+    }
+
+    for (u32 page = first_page; page <= last_page; ++page) {
+        const auto itr = page_blocks.find(page);
+        if (itr != page_blocks.end()) {
+            invalidate_page(itr->second);
+            page_blocks.erase(itr);
+        }
+    }
+}
+
 // Resets certain MPCore CP15 values to their ARM-defined reset values.
 void ARMul_State::ResetMPCoreCP15Registers() {
     // c0
@@ -19,6 +19,7 @@
 
 #include <array>
 #include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 #include "core/gdbstub/gdbstub.h"
@@ -206,6 +207,29 @@ public:
 
     void ServeBreak();
 
+    /// Returns the translation cache offset of the block starting at pc, or -1 if there is none
+    std::size_t FindBlock(u32 pc) {
+        BlockCacheEntry& entry = block_cache[(pc >> 1) % block_cache.size()];
+        if (entry.pc == pc) {
+            return entry.offset;
+        }
+        const auto itr = instruction_cache.find(pc);
+        if (itr == instruction_cache.end()) {
+            return static_cast<std::size_t>(-1);
+        }
+        entry = {pc, itr->second};
+        return itr->second;
+    }
+
+    /// Records a block translated at the given translation cache offset
+    void AddBlock(u32 pc, std::size_t offset);
+
+    /// Forgets all the translated blocks
+    void ClearBlocks();
+
+    /// Forgets the translated blocks with instructions in the given range of guest memory
+    void InvalidateBlocks(u32 start_address, std::size_t length);
+
     Core::System* system;
     Memory::MemorySystem& memory;
 
@@ -256,9 +280,28 @@ public:
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
     std::unordered_map<u32, std::size_t> instruction_cache;
 
+    /// Value of trans_cache_generation when the blocks above were translated
+    u64 trans_cache_generation = 0;
+
+    /// Blocks and instructions translated since the state was created
+    u64 blocks_translated = 0;
+    u64 instructions_translated = 0;
+
 private:
     void ResetMPCoreCP15Registers();
 
+    /// Direct-mapped cache in front of instruction_cache, looked up on every block dispatch.
+    /// Instructions are at least halfword-aligned, so an odd pc marks an empty entry.
+    struct BlockCacheEntry {
+        u32 pc = 1;
+        std::size_t offset = 0;
+    };
+    std::array<BlockCacheEntry, 4096> block_cache{};
+
+    /// Start addresses of the translated blocks in each guest page. Blocks never cross a page
+    /// boundary, so they can be invalidated by page.
+    std::unordered_map<u32, std::vector<u32>> page_blocks;
+
     // Defines a reservation granule of 2 words, which protects the first 2 words starting at the
     // tag. This is the smallest granule allowed by the v7 spec, and is coincidentally just large
     // enough to support LDR/STREXD.
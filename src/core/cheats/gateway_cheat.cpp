@@ -6,6 +6,7 @@
 #include <cmath>
 #include <fstream>
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include "common/file_util.h"
@@ -29,7 +30,7 @@ struct State {
 };
 
 template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::CheatLine& line,
+static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::Instruction& line,
                                                               const State& state,
                                                               ReadFunction read_func,
                                                               WriteFunction write_func,
@@ -43,7 +44,7 @@ static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat
 }
 
 template <typename T, typename ReadFunction, typename CompareFunc>
-static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat::CheatLine& line,
+static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat::Instruction& line,
                                                              State& state, ReadFunction read_func,
                                                              CompareFunc comp) {
     u32 addr = line.address + state.offset;
@@ -53,13 +54,13 @@ static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat:
     }
 }
 
-static inline void LoadOffsetOp(Memory::MemorySystem& memory, const GatewayCheat::CheatLine& line,
+static inline void LoadOffsetOp(Memory::MemorySystem& memory, const GatewayCheat::Instruction& line,
                                 State& state) {
     u32 addr = line.address + state.offset;
     state.offset = memory.Read32(addr);
 }
 
-static inline void LoopOp(const GatewayCheat::CheatLine& line, State& state) {
+static inline void LoopOp(const GatewayCheat::Instruction& line, State& state) {
     state.loop_flag = state.loop_count < line.value;
     state.loop_count++;
     state.loop_back_line = state.current_line_nr;
@@ -91,21 +92,21 @@ static inline void FullTerminateOp(State& state) {
     }
 }
 
-static inline void SetOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
+static inline void SetOffsetOp(const GatewayCheat::Instruction& line, State& state) {
     state.offset = line.value;
 }
 
-static inline void AddValueOp(const GatewayCheat::CheatLine& line, State& state) {
+static inline void AddValueOp(const GatewayCheat::Instruction& line, State& state) {
     state.reg += line.value;
 }
 
-static inline void SetValueOp(const GatewayCheat::CheatLine& line, State& state) {
+static inline void SetValueOp(const GatewayCheat::Instruction& line, State& state) {
     state.reg = line.value;
 }
 
 template <typename T, typename ReadFunction, typename WriteFunction>
 static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
-    const GatewayCheat::CheatLine& line, State& state, ReadFunction read_func,
+    const GatewayCheat::Instruction& line, State& state, ReadFunction read_func,
     WriteFunction write_func, Core::System& system) {
     u32 addr = line.value + state.offset;
     T val = read_func(addr);
@@ -117,65 +118,44 @@ static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
 }
 
 template <typename T, typename ReadFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> LoadOp(const GatewayCheat::CheatLine& line,
+static inline std::enable_if_t<std::is_integral_v<T>> LoadOp(const GatewayCheat::Instruction& line,
                                                              State& state, ReadFunction read_func) {
 
     u32 addr = line.value + state.offset;
     state.reg = read_func(addr);
 }
 
-static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
+static inline void AddOffsetOp(const GatewayCheat::Instruction& line, State& state) {
     state.offset += line.value;
 }
 
-static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
-                           const Core::System& system) {
-    u32 pad_state = system.ServiceManager()
+static inline void JokerOp(const GatewayCheat::Instruction& line, State& state,
+                           const Core::System& system, std::optional<u32>& pad_state) {
+    // The pad doesn't change while the cheat runs, so the service is looked up once
+    if (!pad_state) {
+        pad_state = system.ServiceManager()
                         .GetService<Service::HID::Module::Interface>("hid:USER")
                         ->GetModule()
                         ->GetState()
                         .hex;
-    bool pressed = (pad_state & line.value) == line.value;
+    }
+    bool pressed = (*pad_state & line.value) == line.value;
     if (!pressed) {
         state.if_flag++;
     }
 }
 
-static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
-                           const std::vector<GatewayCheat::CheatLine>& cheat_lines) {
+static inline void PatchOp(const GatewayCheat::Instruction& line, State& state,
+                           Core::System& system, const std::vector<u8>& patch_data) {
     if (state.if_flag > 0) {
         // Skip over the additional patch lines
-        state.current_line_nr += static_cast<int>(std::ceil(line.value / 8.0));
+        state.current_line_nr = line.skipped_end_line;
         return;
     }
-    u32 num_bytes = line.value;
     u32 addr = line.address + state.offset;
-    system.InvalidateCacheRange(addr, num_bytes);
-
-    bool first = true;
-    u32 bit_offset = 0;
-    if (num_bytes > 0)
-        state.current_line_nr++; // skip over the current code
-    while (num_bytes >= 4) {
-        u32 tmp = first ? cheat_lines[state.current_line_nr].first
-                        : cheat_lines[state.current_line_nr].value;
-        if (!first && num_bytes > 4) {
-            state.current_line_nr++;
-        }
-        first = !first;
-        system.Memory().Write32(addr, tmp);
-        addr += 4;
-        num_bytes -= 4;
-    }
-    while (num_bytes > 0) {
-        u32 tmp = (first ? cheat_lines[state.current_line_nr].first
-                         : cheat_lines[state.current_line_nr].value) >>
-                  bit_offset;
-        system.Memory().Write8(addr, tmp);
-        addr += 1;
-        num_bytes -= 1;
-        bit_offset += 8;
-    }
+    system.InvalidateCacheRange(addr, line.value);
+    system.Memory().WriteBlock(addr, patch_data.data() + line.data_offset, line.data_size);
+    state.current_line_nr = line.end_line;
 }
 
 GatewayCheat::CheatLine::CheatLine(const std::string& line) {
@@ -209,6 +189,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    Compile();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -223,12 +204,75 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(code_lines[i]);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    Compile();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
+void GatewayCheat::Compile() {
+    program.clear();
+    patch_data.clear();
+    for (std::size_t i = 0; i < cheat_lines.size(); i++) {
+        const CheatLine& line = cheat_lines[i];
+        Instruction& instruction = program.emplace_back();
+        instruction.type = line.type;
+        instruction.address = line.address;
+        instruction.value = line.value;
+        instruction.mask = static_cast<u16>(~line.value >> 16);
+        if (line.type != CheatType::Patch) {
+            continue;
+        }
+
+        // EXXXXXXX YYYYYYYY: the YYYYYYYY bytes to copy follow the line, the first word of each
+        // line comes first
+        instruction.skipped_end_line =
+            static_cast<u32>(i + static_cast<std::size_t>(std::ceil(line.value / 8.0)));
+        instruction.data_offset = static_cast<u32>(patch_data.size());
+        u32 num_bytes = line.value;
+        std::size_t line_nr = i;
+        bool first = true;
+        if (num_bytes > 0) {
+            line_nr++;
+        }
+        const auto word = [&]() -> std::optional<u32> {
+            if (line_nr >= cheat_lines.size()) {
+                return std::nullopt;
+            }
+            return first ? cheat_lines[line_nr].first : cheat_lines[line_nr].value;
+        };
+        while (num_bytes >= 4) {
+            const auto data = word();
+            if (!data) {
+                break;
+            }
+            if (!first && num_bytes > 4) {
+                line_nr++;
+            }
+            first = !first;
+            for (u32 shift = 0; shift < 32; shift += 8) {
+                patch_data.push_back(static_cast<u8>(*data >> shift));
+            }
+            num_bytes -= 4;
+        }
+        if (num_bytes < 4) {
+            if (const auto data = word()) {
+                for (u32 shift = 0; shift < num_bytes * 8; shift += 8) {
+                    patch_data.push_back(static_cast<u8>(*data >> shift));
+                }
+                num_bytes = 0;
+            }
+        }
+        if (num_bytes > 0) {
+            LOG_ERROR(Core_Cheats, "Cheat patch is missing data: {}", line.cheat_line);
+        }
+        instruction.data_size = static_cast<u32>(patch_data.size() - instruction.data_offset);
+        instruction.end_line = static_cast<u32>(std::min(line_nr, cheat_lines.size() - 1));
+    }
+}
+
 void GatewayCheat::Execute(Core::System& system) const {
     State state;
+    std::optional<u32> pad_state;
 
     Memory::MemorySystem& memory = system.Memory();
     auto Read8 = [&memory](VAddr addr) { return memory.Read8(addr); };
@@ -238,9 +282,9 @@ void GatewayCheat::Execute(Core::System& system) const {
     auto Write16 = [&memory](VAddr addr, u16 value) { memory.Write16(addr, value); };
     auto Write32 = [&memory](VAddr addr, u32 value) { memory.Write32(addr, value); };
 
-    for (state.current_line_nr = 0; state.current_line_nr < cheat_lines.size();
+    for (state.current_line_nr = 0; state.current_line_nr < program.size();
          state.current_line_nr++) {
-        auto line = cheat_lines[state.current_line_nr];
+        const Instruction& line = program[state.current_line_nr];
         if (state.if_flag > 0) {
             switch (line.type) {
             case CheatType::GreaterThan32:
@@ -259,7 +303,7 @@ void GatewayCheat::Execute(Core::System& system) const {
                 // EXXXXXXX YYYYYYYY
                 // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
                 // We need to call this here to skip the additional patch lines
-                PatchOp(line, state, system, cheat_lines);
+                PatchOp(line, state, system, patch_data);
                 break;
             case CheatType::Terminator:
                 // D0000000 00000000 - ENDIF
@@ -311,25 +355,25 @@ void GatewayCheat::Execute(Core::System& system) const {
         case CheatType::GreaterThan16WithMask:
             // 7XXXXXXX ZZZZYYYY - Execute next block IF YYYY > ((not ZZZZ) AND half[XXXXXXX])
             CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) > (static_cast<u16>(~line.value >> 16) & val);
+                return static_cast<u16>(line.value) > (line.mask & val);
             });
             break;
         case CheatType::LessThan16WithMask:
             // 8XXXXXXX ZZZZYYYY - Execute next block IF YYYY < ((not ZZZZ) AND half[XXXXXXX])
             CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) < (static_cast<u16>(~line.value >> 16) & val);
+                return static_cast<u16>(line.value) < (line.mask & val);
             });
             break;
         case CheatType::EqualTo16WithMask:
             // 9XXXXXXX ZZZZYYYY - Execute next block IF YYYY = ((not ZZZZ) AND half[XXXXXXX])
             CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) == (static_cast<u16>(~line.value >> 16) & val);
+                return static_cast<u16>(line.value) == (line.mask & val);
             });
             break;
         case CheatType::NotEqualTo16WithMask:
             // AXXXXXXX ZZZZYYYY - Execute next block IF YYYY <> ((not ZZZZ) AND half[XXXXXXX])
             CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) != (static_cast<u16>(~line.value >> 16) & val);
+                return static_cast<u16>(line.value) != (line.mask & val);
             });
             break;
         case CheatType::LoadOffset:
@@ -409,13 +453,13 @@ void GatewayCheat::Execute(Core::System& system) const {
         }
         case CheatType::Joker: {
             // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+            JokerOp(line, state, system, pad_state);
             break;
         }
         case CheatType::Patch: {
             // EXXXXXXX YYYYYYYY
             // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-            PatchOp(line, state, system, cheat_lines);
+            PatchOp(line, state, system, patch_data);
             break;
         }
         }
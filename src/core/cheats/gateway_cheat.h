@@ -55,6 +55,21 @@ public:
         bool valid = true;
     };
 
+    /// Cheat line decoded ahead of execution, there is one for every line of the cheat
+    struct Instruction {
+        CheatType type;
+        u32 address;
+        u32 value;
+        /// Masked comparisons: the mask applied to the half in memory
+        u16 mask;
+        /// Patches: the data written, from patch_data
+        u32 data_offset;
+        u32 data_size;
+        /// Patches: the line the patch ends on, when it runs and when it is skipped
+        u32 end_line;
+        u32 skipped_end_line;
+    };
+
     GatewayCheat(std::string name, std::vector<CheatLine> cheat_lines, std::string comments);
     GatewayCheat(std::string name, std::string code, std::string comments);
     ~GatewayCheat();
@@ -80,9 +95,16 @@ public:
     static std::vector<std::unique_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    /// Decodes the cheat lines into the program
+    void Compile();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
     const std::string comments;
+
+    std::vector<Instruction> program;
+    /// Data of all the patches of the program
+    std::vector<u8> patch_data;
 };
 } // namespace Cheats
@@ -12,6 +12,7 @@
 #include "audio_core/lle/lle.h"
 #include "common/arch.h"
 #include "common/logging/log.h"
+#include "common/memory_usage.h"
 #include "common/texture.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/exclusive_monitor.h"
@@ -22,6 +23,7 @@
 #include "core/cheats/cheats.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/cpu_threads.h"
 #include "core/dumping/backend.h"
 #ifdef ENABLE_FFMPEG_VIDEO_DUMPER
 #include "core/dumping/ffmpeg_backend.h"
@@ -34,6 +36,7 @@
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/thread.h"
+#include "core/hle/lock.h"
 #include "core/hle/service/apt/applet_manager.h"
 #include "core/hle/service/apt/apt.h"
 #include "core/hle/service/fs/archive.h"
@@ -46,8 +49,11 @@
 #include "core/hw/lcd.h"
 #include "core/loader/loader.h"
 #include "core/movie.h"
+#include "core/perf_tuner.h"
+#include "core/rewind.h"
 #include "core/rpc/rpc_server.h"
 #include "network/network.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
@@ -79,21 +85,21 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         return ResultStatus::ErrorNotInitialized;
     }
 
-    if (GDBStub::IsServerEnabled()) {
+    if (GDBStub::IsServerEnabled() && GDBStub::HasPendingPacket()) {
         Kernel::Thread* thread = kernel->GetCurrentThreadManager().GetCurrentThread();
         if (thread && running_core) {
             running_core->SaveContext(thread->context);
         }
         GDBStub::HandlePacket();
+    }
 
-        // If the loop is halted and we want to step, use a tiny (1) number of instructions to
-        // execute. Otherwise, get out of the loop function.
-        if (GDBStub::GetCpuHaltFlag()) {
-            if (GDBStub::GetCpuStepFlag()) {
-                tight_loop = false;
-            } else {
-                return ResultStatus::Success;
-            }
+    // If the loop is halted and we want to step, use a tiny (1) number of instructions to
+    // execute. Otherwise, get out of the loop function.
+    if (GDBStub::IsServerEnabled() && GDBStub::GetCpuHaltFlag()) {
+        if (GDBStub::GetCpuStepFlag()) {
+            tight_loop = false;
+        } else {
+            return ResultStatus::Success;
         }
     }
 
@@ -107,6 +113,16 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             current_signal = Signal::None;
         }
     }
+    if (pending_save.valid() && !IsSaveStatePending()) {
+        try {
+            WaitForPendingSaveState();
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error saving: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+    }
+
     switch (signal) {
     case Signal::Reset:
         Reset();
@@ -130,7 +146,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         LOG_INFO(Core, "Begin save");
         try {
             System::SaveState(param);
-            LOG_INFO(Core, "Save completed");
+            LOG_INFO(Core, "Save snapshot taken");
         } catch (const std::exception& e) {
             LOG_ERROR(Core, "Error saving: {}", e.what());
             status_details = e.what();
@@ -139,10 +155,72 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         frame_limiter.WaitOnce();
         return ResultStatus::Success;
     }
+    case Signal::Rewind: {
+        try {
+            if (Rewind()) {
+                LOG_INFO(Core, "Rewind completed");
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error rewinding: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        frame_limiter.WaitOnce();
+        return ResultStatus::Success;
+    }
     default:
         break;
     }
 
+    // Movies and multiplayer sessions have to boot normally
+    if (!boot_snapshot_path.empty() && (Movie::GetInstance().GetCurrentMovieID() != 0 ||
+                                        Network::GetRoomMember().lock()->IsConnected())) {
+        boot_snapshot_path.clear();
+    }
+    if (!boot_snapshot_path.empty() && restore_boot_snapshot) {
+        const std::string path = std::move(boot_snapshot_path);
+        boot_snapshot_path.clear();
+        try {
+            LoadStateFromFile(path);
+            LOG_INFO(Core, "Resumed from the boot snapshot");
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error loading the boot snapshot: {}", e.what());
+            // The next boot takes a new snapshot instead
+            FileUtil::Delete(path);
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        return ResultStatus::Success;
+    }
+    if (!boot_snapshot_path.empty() &&
+        timing->GetGlobalTimeUs() >=
+            std::chrono::milliseconds(Settings::values.boot_snapshot_time.GetValue())) {
+        const std::string path = std::move(boot_snapshot_path);
+        boot_snapshot_path.clear();
+        try {
+            SaveStateToFile(path);
+            LOG_INFO(Core, "Boot snapshot taken");
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error saving the boot snapshot: {}", e.what());
+        }
+    }
+
+    if (perf_tuner) {
+        perf_tuner->Update();
+    }
+
+    if (rewind_buffer && timing->GetGlobalTimeUs() >= next_rewind_snapshot) {
+        try {
+            rewind_buffer->TakeSnapshot(*this);
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Disabling rewind, the state can't be saved: {}", e.what());
+            rewind_buffer.reset();
+        }
+        next_rewind_snapshot =
+            timing->GetGlobalTimeUs() +
+            std::chrono::milliseconds(Settings::values.rewind_interval.GetValue());
+    }
+
     // All cores should have executed the same amount of ticks. If this is not the case an event was
     // scheduled with a cycles_into_future smaller then the current downcount.
     // So we have to get those cores to the same global time first
@@ -199,27 +277,47 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
             kernel->GetThreadManager(cpu_core->GetID()).Reschedule();
             max_slice = std::min(max_slice, cpu_core->GetTimer().GetMaxSliceLength());
         }
-        for (auto& cpu_core : cpu_cores) {
-            cpu_core->GetTimer().SetNextSlice(max_slice);
-            auto start_ticks = cpu_core->GetTimer().GetTicks();
-            LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
-                      cpu_core->GetTimer().GetDowncount());
-            running_core = cpu_core.get();
-            kernel->SetRunningCPU(running_core);
-            // If we don't have a currently active thread then don't execute instructions,
-            // instead advance to the next event and try to yield to the next thread
-            if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
-                LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
-                cpu_core->GetTimer().Idle();
-                PrepareReschedule();
-            } else {
-                if (tight_loop) {
-                    cpu_core->Run();
+        if (cpu_threads && tight_loop && !GDBStub::IsServerEnabled()) {
+            // Idle cores advance serially, all the others run the same slice concurrently
+            std::vector<ARM_Interface*> cores_to_run(cpu_cores.size());
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(max_slice);
+                running_core = cpu_core.get();
+                kernel->SetRunningCPU(running_core);
+                if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+                    LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+                    cpu_core->GetTimer().Idle();
+                    PrepareReschedule();
+                } else {
+                    cores_to_run[cpu_core->GetID()] = cpu_core.get();
+                }
+            }
+            parallel_slice = true;
+            cpu_threads->RunSlice(cores_to_run);
+            parallel_slice = false;
+        } else {
+            for (auto& cpu_core : cpu_cores) {
+                cpu_core->GetTimer().SetNextSlice(max_slice);
+                auto start_ticks = cpu_core->GetTimer().GetTicks();
+                LOG_TRACE(Core_ARM11, "Core {} running for {} ticks", cpu_core->GetID(),
+                          cpu_core->GetTimer().GetDowncount());
+                running_core = cpu_core.get();
+                kernel->SetRunningCPU(running_core);
+                // If we don't have a currently active thread then don't execute instructions,
+                // instead advance to the next event and try to yield to the next thread
+                if (kernel->GetCurrentThreadManager().GetCurrentThread() == nullptr) {
+                    LOG_TRACE(Core_ARM11, "Core {} idling", cpu_core->GetID());
+                    cpu_core->GetTimer().Idle();
+                    PrepareReschedule();
                 } else {
-                    cpu_core->Step();
+                    if (tight_loop) {
+                        cpu_core->Run();
+                    } else {
+                        cpu_core->Step();
+                    }
                 }
+                max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
             }
-            max_slice = cpu_core->GetTimer().GetTicks() - start_ticks;
         }
     }
 
@@ -233,6 +331,19 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
     return status;
 }
 
+std::unique_lock<std::recursive_mutex> System::AcquireCoreContext(ARM_Interface& core) {
+    if (!parallel_slice) {
+        return {};
+    }
+
+    std::unique_lock lock{HLE::g_hle_lock};
+    if (running_core != &core) {
+        running_core = &core;
+        kernel->SetRunningCPU(&core);
+    }
+    return lock;
+}
+
 bool System::SendSignal(System::Signal signal, u32 param) {
     std::lock_guard lock{signal_mutex};
     if (current_signal != signal && current_signal != Signal::None) {
@@ -256,6 +367,25 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
         LOG_CRITICAL(Core, "Failed to obtain loader for {}!", filepath);
         return ResultStatus::ErrorGetLoader;
     }
+
+    // Settings configured for the title take precedence over its measured profile
+    u64 profile_title_id{};
+    if (Settings::values.use_perf_profiles &&
+        app_loader->ReadProgramId(profile_title_id) == Loader::ResultStatus::Success) {
+        if (const auto profile = LoadPerfProfile(profile_title_id)) {
+            LOG_INFO(Core, "Using the performance profile of {:016X}: {}", profile_title_id,
+                     profile->ToString());
+            profile->Apply(true);
+            Settings::Apply();
+        }
+    }
+
+    Settings::ApplyDeterministicMode();
+    if (Settings::values.deterministic &&
+        Core::Movie::GetInstance().GetPlayMode() != Core::Movie::PlayMode::Playing) {
+        LOG_WARNING(Core, "Deterministic mode: the input isn't replayed from a movie");
+    }
+
     std::pair<std::optional<u32>, Loader::ResultStatus> system_mode =
         app_loader->LoadKernelSystemMode();
 
@@ -313,6 +443,27 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
                   static_cast<u32>(load_result));
     }
     perf_stats = std::make_unique<PerfStats>(title_id);
+    if (Settings::values.tune_performance) {
+        perf_tuner = std::make_unique<PerfTuner>(title_id);
+    }
+    if (Settings::values.rewind_interval.GetValue() != 0) {
+        rewind_buffer = std::make_unique<RewindBuffer>(
+            static_cast<std::size_t>(Settings::values.rewind_buffer_size.GetValue()) << 20);
+        next_rewind_snapshot = {};
+    }
+    perf_stats->SetFrameCallback([this](const PerfStats::FrameSample& sample) {
+        if (perf_tuner) {
+            perf_tuner->OnFrame(sample);
+        }
+        if (registered_frame_observer) {
+            registered_frame_observer(sample);
+        }
+        if (rpc_server) {
+            rpc_server->PublishFrameStats(sample);
+            rpc_server->PublishMemoryRanges();
+            rpc_server->EndSystemFrame(sample);
+        }
+    });
     custom_tex_cache = std::make_unique<Core::CustomTexCache>();
 
     if (Settings::values.custom_textures) {
@@ -330,6 +481,7 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     m_secondary_window = secondary_window;
     m_filepath = filepath;
     self_delete_pending = false;
+    PrepareBootSnapshot();
 
     // Reset counters and set time origin to current frame
     [[maybe_unused]] const PerfStats::Results result = GetAndResetPerfStats();
@@ -378,6 +530,9 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
             cpu_cores.push_back(std::make_shared<ARM_Dynarmic>(
                 this, *memory, i, timing->GetTimer(i), *exclusive_monitor));
         }
+        if (Settings::values.use_multi_core && num_cores > 1) {
+            cpu_threads = std::make_unique<CPUThreads>(num_cores);
+        }
 #else
         for (u32 i = 0; i < num_cores; ++i) {
             cpu_cores.push_back(
@@ -397,11 +552,15 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     kernel->SetRunningCPU(cpu_cores[0].get());
 
     const auto audio_emulation = Settings::values.audio_emulation.GetValue();
-    if (audio_emulation == Settings::AudioEmulation::HLE) {
-        dsp_core = std::make_unique<AudioCore::DspHle>(*memory);
+    if (audio_emulation == Settings::AudioEmulation::HLE ||
+        audio_emulation == Settings::AudioEmulation::HLEMultithreaded) {
+        const bool multithread = audio_emulation == Settings::AudioEmulation::HLEMultithreaded;
+        dsp_core = std::make_unique<AudioCore::DspHle>(*memory, *timing, multithread,
+                                                       Settings::values.headless_dsp.GetValue());
     } else {
         const bool multithread = audio_emulation == Settings::AudioEmulation::LLEMultithreaded;
-        dsp_core = std::make_unique<AudioCore::DspLle>(*memory, multithread);
+        dsp_core = std::make_unique<AudioCore::DspLle>(
+            *memory, multithread, Settings::values.lle_dsp_run_ahead.GetValue());
     }
 
     memory->SetDSP(*dsp_core);
@@ -530,7 +689,18 @@ void System::RegisterImageInterface(std::shared_ptr<Frontend::ImageInterface> im
     registered_image_interface = std::move(image_interface);
 }
 
+void System::RegisterFrameObserver(PerfStats::FrameCallback frame_observer) {
+    registered_frame_observer = std::move(frame_observer);
+}
+
 void System::Shutdown(bool is_deserializing) {
+    // Let the savestate being written finish, its error can't be reported anymore
+    try {
+        WaitForPendingSaveState();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Core, "Error saving: {}", e.what());
+    }
+
     // Log last frame performance stats
     const auto perf_results = GetAndResetPerfStats();
     constexpr auto performance = Common::Telemetry::FieldType::Performance;
@@ -541,13 +711,18 @@ void System::Shutdown(bool is_deserializing) {
     telemetry_session->AddField(performance, "Shutdown_Frametime", perf_results.frametime * 1000.0);
     telemetry_session->AddField(performance, "Mean_Frametime_MS", perf_stats->GetMeanFrametime());
 
+    // The peaks of the session, before the subsystems release their memory
+    Common::MemoryUsage::LogUsages();
+
     // Shutdown emulation session
     VideoCore::Shutdown();
     HW::Shutdown();
     if (!is_deserializing) {
         GDBStub::Shutdown();
+        perf_tuner.reset();
         perf_stats.reset();
         cheat_engine.reset();
+        rewind_buffer.reset();
         app_loader.reset();
     }
     telemetry_session.reset();
@@ -556,6 +731,7 @@ void System::Shutdown(bool is_deserializing) {
     service_manager.reset();
     dsp_core.reset();
     kernel.reset();
+    cpu_threads.reset();
     cpu_cores.clear();
     exclusive_monitor.reset();
     timing.reset();
@@ -661,7 +837,11 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
         Service::GSP::SetGlobalModule(*this);
         memory->SetDSP(*dsp_core);
         cheat_engine->Connect();
-        VideoCore::g_renderer->Sync();
+        if (VideoCore::g_gpu_thread) {
+            VideoCore::g_gpu_thread->SyncState();
+        } else {
+            VideoCore::g_renderer->Sync();
+        }
     }
 }
 
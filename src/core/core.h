@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -61,7 +63,10 @@ class RendererBase;
 
 namespace Core {
 
+class CPUThreads;
 class ExclusiveMonitor;
+class PerfTuner;
+class RewindBuffer;
 class Timing;
 
 class System {
@@ -121,7 +126,7 @@ public:
     /// Shutdown and then load again
     void Reset();
 
-    enum class Signal : u32 { None, Shutdown, Reset, Save, Load };
+    enum class Signal : u32 { None, Shutdown, Reset, Save, Load, Rewind };
 
     bool SendSignal(Signal signal, u32 param = 0);
 
@@ -180,6 +185,13 @@ public:
         return *running_core;
     };
 
+    /**
+     * Makes the given core the running one, along with its process and timer, for as long as the
+     * returned lock is held. Must be held by a core that leaves the JIT while the cores run in
+     * parallel, otherwise the returned lock is empty.
+     */
+    [[nodiscard]] std::unique_lock<std::recursive_mutex> AcquireCoreContext(ARM_Interface& core);
+
     /**
      * Gets a reference to the emulated CPU.
      * @param core_id The id of the core requested.
@@ -307,7 +319,31 @@ public:
         return registered_image_interface;
     }
 
-    void SaveState(u32 slot) const;
+    /// Frame observer
+
+    /**
+     * Registers a callback that gets the timings of every system frame as it ends, on the
+     * emulation thread. Registered before Load, it applies to the loaded title.
+     */
+    void RegisterFrameObserver(PerfStats::FrameCallback frame_observer);
+
+    /**
+     * Takes a snapshot of the emulated state, which is compressed and written to the slot on a
+     * background thread. Errors of the background write are reported by a later RunLoop.
+     */
+    void SaveState(u32 slot);
+
+    /// Returns whether a savestate is still being written in the background
+    [[nodiscard]] bool IsSaveStatePending() const;
+
+    /// Waits for the savestate being written in the background, rethrowing its error
+    void WaitForPendingSaveState();
+
+    /**
+     * Restores the newest rewind snapshot, the next call steps back further.
+     * @return false if rewinding is disabled or there is no snapshot left
+     */
+    bool Rewind();
 
     void LoadState(u32 slot);
 
@@ -342,6 +378,10 @@ private:
     std::vector<std::shared_ptr<ARM_Interface>> cpu_cores;
     ARM_Interface* running_core = nullptr;
 
+    /// Host threads running the cores in parallel, null if they run one after the other
+    std::unique_ptr<CPUThreads> cpu_threads;
+    bool parallel_slice = false;
+
     /// DSP core
     std::unique_ptr<AudioCore::DspInterface> dsp_core;
 
@@ -370,6 +410,9 @@ private:
     /// Image interface
     std::shared_ptr<Frontend::ImageInterface> registered_image_interface;
 
+    /// Frame observer of the frontend
+    PerfStats::FrameCallback registered_frame_observer;
+
     /// RPC Server for scripting support
     std::unique_ptr<RPC::RPCServer> rpc_server;
 
@@ -381,6 +424,18 @@ private:
 
     std::unique_ptr<Core::ExclusiveMonitor> exclusive_monitor;
 
+    /// Recent snapshots to rewind to, null if rewinding is disabled
+    std::unique_ptr<RewindBuffer> rewind_buffer;
+
+    /// Measures the settings of the running title, null unless performance tuning is enabled
+    std::unique_ptr<PerfTuner> perf_tuner;
+    std::chrono::microseconds next_rewind_snapshot{};
+
+    /// Snapshot of the booted title, empty if boot snapshots are disabled or it was handled
+    std::string boot_snapshot_path;
+    /// Whether the snapshot exists and is restored before the title runs, otherwise it is taken
+    bool restore_boot_snapshot = false;
+
 private:
     static System s_instance;
 
@@ -400,6 +455,21 @@ private:
     Signal current_signal;
     u32 signal_param;
 
+    /// Savestate being written in the background
+    std::future<void> pending_save;
+
+    /// Writes a snapshot of the emulated state to the file, see SaveState
+    void SaveStateToFile(const std::string& path);
+
+    /// Restores the emulated state from the file
+    void LoadStateFromFile(const std::string& path);
+
+    /**
+     * Finds the boot snapshot of the title. Its path depends on everything that affects the boot,
+     * so that a changed ROM, emulator or setting leads to a new snapshot.
+     */
+    void PrepareBootSnapshot();
+
     friend class boost::serialization::access;
     template <typename Archive>
     void serialize(Archive& ar, const unsigned int file_version);
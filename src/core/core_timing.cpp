@@ -7,6 +7,7 @@
 #include <tuple>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/core_timing.h"
 
 namespace Core {
@@ -68,9 +69,7 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
         if (!timer->is_timer_sane)
             timer->ForceExceptionCheck(cycles_into_future);
 
-        timer->event_queue.emplace_back(
-            Event{timeout, timer->event_fifo_id++, user_data, event_type});
-        std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+        timer->event_queue.Push(Event{timeout, timer->event_fifo_id++, user_data, event_type});
     } else {
         timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
                                    user_data, event_type});
@@ -82,17 +81,10 @@ void Timing::UnscheduleEvent(const TimingEventType* event_type, std::uintptr_t u
         return;
     }
     for (auto timer : timers) {
-        auto itr = std::remove_if(
-            timer->event_queue.begin(), timer->event_queue.end(),
-            [&](const Event& e) { return e.type == event_type && e.user_data == user_data; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        // Take in the events scheduled from other threads so that they are removed as well
+        timer->MoveEvents();
+        timer->event_queue.Remove(event_type, user_data);
     }
-    // TODO:remove events from ts_queue
 }
 
 void Timing::RemoveEvent(const TimingEventType* event_type) {
@@ -100,16 +92,9 @@ void Timing::RemoveEvent(const TimingEventType* event_type) {
         return;
     }
     for (auto timer : timers) {
-        auto itr = std::remove_if(timer->event_queue.begin(), timer->event_queue.end(),
-                                  [&](const Event& e) { return e.type == event_type; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
-        }
+        timer->MoveEvents();
+        timer->event_queue.Remove(event_type);
     }
-    // TODO:remove events from ts_queue
 }
 
 void Timing::SetCurrentTimer(std::size_t core_id) {
@@ -167,11 +152,10 @@ void Timing::Timer::ForceExceptionCheck(s64 cycles) {
 }
 
 void Timing::Timer::MoveEvents() {
-    for (Event ev; ts_queue.Pop(ev);) {
+    ts_queue.Drain([this](Event&& ev) {
         ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-    }
+        event_queue.Push(ev);
+    });
 }
 
 u32 Timing::Timer::StartAdjust() {
@@ -183,18 +167,21 @@ u32 Timing::Timer::StartAdjust() {
 void Timing::Timer::EndAdjust(u32 start_adjust_handle) {
     std::chrono::time_point<std::chrono::steady_clock> new_timer = std::chrono::steady_clock::now();
     ASSERT(new_timer >= adjust_value_last && start_adjust_handle == adjust_value_curr_handle);
-    AddTicks(nsToCycles(static_cast<float>(
-        std::chrono::duration_cast<std::chrono::nanoseconds>(new_timer - adjust_value_last)
-            .count() /
-        cpu_clock_scale)));
+    // With virtual time, the time the host spent blocking mustn't be visible to the guest
+    if (!Settings::values.use_virtual_time) {
+        AddTicks(nsToCycles(static_cast<float>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(new_timer - adjust_value_last)
+                .count() /
+            cpu_clock_scale)));
+    }
     ++adjust_value_curr_handle;
 }
 
 s64 Timing::Timer::GetMaxSliceLength() const {
-    const auto& next_event = event_queue.begin();
-    if (next_event != event_queue.end()) {
-        ASSERT(next_event->time - executed_ticks > 0);
-        return next_event->time - executed_ticks;
+    if (!event_queue.Empty()) {
+        const Event& next_event = event_queue.Top();
+        ASSERT(next_event.time - executed_ticks > 0);
+        return next_event.time - executed_ticks;
     }
     return MAX_SLICE_LENGTH;
 }
@@ -210,10 +197,8 @@ void Timing::Timer::Advance() {
 
     is_timer_sane = true;
 
-    while (!event_queue.empty() && event_queue.front().time <= executed_ticks) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    while (!event_queue.Empty() && event_queue.Top().time <= executed_ticks) {
+        const Event evt = event_queue.Pop();
         if (evt.type->callback != nullptr) {
             evt.type->callback(evt.user_data, static_cast<int>(executed_ticks - evt.time));
         } else {
@@ -228,9 +213,9 @@ void Timing::Timer::SetNextSlice(s64 max_slice_length) {
     slice_length = max_slice_length;
 
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
+    if (!event_queue.Empty()) {
         slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - executed_ticks, max_slice_length));
+            std::min<s64>(event_queue.Top().time - executed_ticks, max_slice_length));
     }
 
     downcount = slice_length;
@@ -245,4 +230,188 @@ s64 Timing::Timer::GetDowncount() const {
     return downcount;
 }
 
+std::size_t Timing::EventQueue::KeyHash::operator()(const Key& key) const noexcept {
+    return std::hash<const void*>{}(key.first) ^ (std::hash<std::uintptr_t>{}(key.second) << 1);
+}
+
+void Timing::EventQueue::Push(const Event& event) {
+    Node* node = AllocateNode();
+    node->event = event;
+    node->child = nullptr;
+    node->sibling = nullptr;
+    node->prev = nullptr;
+    root = Meld(root, node);
+    ++size;
+
+    if (events_by_key.size() > 2 * size + 64) {
+        std::erase_if(events_by_key, [](const auto& entry) { return entry.second == nullptr; });
+    }
+    Node*& key_head = events_by_key[Key{event.type, event.user_data}];
+    node->key_prev = nullptr;
+    node->key_next = key_head;
+    if (key_head != nullptr) {
+        key_head->key_prev = node;
+    }
+    key_head = node;
+}
+
+Timing::Event Timing::EventQueue::Pop() {
+    const Event event = root->event;
+    Erase(root);
+    return event;
+}
+
+void Timing::EventQueue::Remove(const TimingEventType* type, std::uintptr_t user_data) {
+    const auto it = events_by_key.find(Key{type, user_data});
+    if (it == events_by_key.end()) {
+        return;
+    }
+    while (it->second != nullptr) {
+        Erase(it->second);
+    }
+}
+
+void Timing::EventQueue::Remove(const TimingEventType* type) {
+    std::vector<Node*> nodes;
+    ForEachNode([&](Node* node) {
+        if (node->event.type == type) {
+            nodes.push_back(node);
+        }
+    });
+    for (Node* node : nodes) {
+        Erase(node);
+    }
+}
+
+void Timing::EventQueue::Clear() {
+    while (root != nullptr) {
+        Erase(root);
+    }
+    events_by_key.clear();
+}
+
+std::vector<Timing::Event> Timing::EventQueue::GetEvents() const {
+    std::vector<Event> events;
+    events.reserve(size);
+    ForEachNode([&](const Node* node) { events.push_back(node->event); });
+    std::sort(events.begin(), events.end());
+    return events;
+}
+
+Timing::EventQueue::Node* Timing::EventQueue::AllocateNode() {
+    if (free_nodes == nullptr) {
+        constexpr std::size_t NODES_PER_CHUNK = 64;
+        auto& chunk = node_chunks.emplace_back(std::make_unique<Node[]>(NODES_PER_CHUNK));
+        for (std::size_t i = 0; i < NODES_PER_CHUNK; ++i) {
+            chunk[i].sibling = free_nodes;
+            free_nodes = &chunk[i];
+        }
+    }
+    Node* node = free_nodes;
+    free_nodes = node->sibling;
+    return node;
+}
+
+Timing::EventQueue::Node* Timing::EventQueue::Meld(Node* a, Node* b) {
+    if (a == nullptr) {
+        return b;
+    }
+    if (b == nullptr) {
+        return a;
+    }
+    if (b->event < a->event) {
+        std::swap(a, b);
+    }
+    // The later root becomes the leftmost child of the earlier one
+    b->prev = a;
+    b->sibling = a->child;
+    if (a->child != nullptr) {
+        a->child->prev = b;
+    }
+    a->child = b;
+    a->sibling = nullptr;
+    a->prev = nullptr;
+    return a;
+}
+
+Timing::EventQueue::Node* Timing::EventQueue::MergePairs(Node* first) {
+    if (first == nullptr) {
+        return nullptr;
+    }
+
+    // First pass: meld the siblings in pairs from left to right, stacking the results
+    Node* pairs = nullptr;
+    while (first != nullptr) {
+        Node* a = first;
+        Node* b = a->sibling;
+        first = b != nullptr ? b->sibling : nullptr;
+        a->sibling = nullptr;
+        if (b != nullptr) {
+            b->sibling = nullptr;
+            a = Meld(a, b);
+        }
+        a->sibling = pairs;
+        pairs = a;
+    }
+
+    // Second pass: meld the pairs from right to left
+    Node* result = pairs;
+    pairs = pairs->sibling;
+    result->sibling = nullptr;
+    while (pairs != nullptr) {
+        Node* next = pairs->sibling;
+        pairs->sibling = nullptr;
+        result = Meld(result, pairs);
+        pairs = next;
+    }
+    result->prev = nullptr;
+    return result;
+}
+
+void Timing::EventQueue::Erase(Node* node) {
+    if (node == root) {
+        root = MergePairs(root->child);
+    } else {
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
+        } else {
+            node->prev->sibling = node->sibling;
+        }
+        if (node->sibling != nullptr) {
+            node->sibling->prev = node->prev;
+        }
+        root = Meld(root, MergePairs(node->child));
+    }
+
+    if (node->key_prev != nullptr) {
+        node->key_prev->key_next = node->key_next;
+    } else {
+        events_by_key.find(Key{node->event.type, node->event.user_data})->second =
+            node->key_next;
+    }
+    if (node->key_next != nullptr) {
+        node->key_next->key_prev = node->key_prev;
+    }
+
+    node->sibling = free_nodes;
+    free_nodes = node;
+    --size;
+}
+
+template <typename Func>
+void Timing::EventQueue::ForEachNode(Func&& func) const {
+    if (root == nullptr) {
+        return;
+    }
+    std::vector<Node*> pending{root};
+    while (!pending.empty()) {
+        Node* node = pending.back();
+        pending.pop_back();
+        func(node);
+        for (Node* child = node->child; child != nullptr; child = child->sibling) {
+            pending.push_back(child);
+        }
+    }
+}
+
 } // namespace Core
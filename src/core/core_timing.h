@@ -20,6 +20,7 @@
 #include <chrono>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -171,6 +172,77 @@ public:
         BOOST_SERIALIZATION_SPLIT_MEMBER()
     };
 
+    /**
+     * The pending events of a timer, ordered by time and then by the order in which they were
+     * scheduled. It is a pairing heap over pooled nodes, so scheduling an event is O(1) and doesn't
+     * allocate in the steady state. Events are also indexed by type and user data, so that they
+     * can be cancelled without searching the queue.
+     */
+    class EventQueue {
+    public:
+        EventQueue() = default;
+        ~EventQueue() = default;
+
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        [[nodiscard]] bool Empty() const {
+            return root == nullptr;
+        }
+
+        /// Returns the earliest event. The queue must not be empty.
+        [[nodiscard]] const Event& Top() const {
+            return root->event;
+        }
+
+        void Push(const Event& event);
+
+        /// Removes and returns the earliest event. The queue must not be empty.
+        Event Pop();
+
+        /// Removes all the events with the given type and user data
+        void Remove(const TimingEventType* type, std::uintptr_t user_data);
+
+        /// Removes all the events with the given type
+        void Remove(const TimingEventType* type);
+
+        void Clear();
+
+        /// Returns all the events, in the order they will be triggered
+        [[nodiscard]] std::vector<Event> GetEvents() const;
+
+    private:
+        struct Node {
+            Event event;
+            Node* child;
+            Node* sibling;
+            Node* prev; ///< Parent of the leftmost child, previous sibling of the others
+            Node* key_next;
+            Node* key_prev;
+        };
+
+        using Key = std::pair<const TimingEventType*, std::uintptr_t>;
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const noexcept;
+        };
+
+        Node* AllocateNode();
+        static Node* Meld(Node* a, Node* b);
+        static Node* MergePairs(Node* first);
+        void Erase(Node* node);
+
+        template <typename Func>
+        void ForEachNode(Func&& func) const;
+
+        Node* root = nullptr;
+        Node* free_nodes = nullptr;
+        std::size_t size = 0;
+        std::vector<std::unique_ptr<Node[]>> node_chunks;
+        /// Heads of the lists of events sharing a key. Entries are kept when their list empties,
+        /// since the same events tend to be rescheduled, and are pruned when they pile up.
+        std::unordered_map<Key, Node*, KeyHash> events_by_key;
+    };
+
     // currently Service::HID::pad_update_ticks is the smallest interval for an event that gets
     // always scheduled. Therfore we use this as orientation for the MAX_SLICE_LENGTH
     // For performance bigger slice length are desired, though this will lead to cores desync
@@ -210,15 +282,11 @@ public:
 
     private:
         friend class Timing;
-        // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-        // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-        // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-        // accommodated by the standard adaptor class.
-        std::vector<Event> event_queue;
+        EventQueue event_queue;
         u64 event_fifo_id = 0;
-        // the queue for storing the events from other threads threadsafe until they will be added
+        // the lock-free inbox for storing the events from other threads until they will be added
         // to the event_queue by the emu thread
-        Common::MPSCQueue<Event> ts_queue;
+        Common::MPSCInbox<Event> ts_queue;
         // Are we in a function that has been called from Advance()
         // If events are sheduled from a function that gets called from Advance(),
         // don't change slice_length and downcount.
@@ -246,7 +314,14 @@ public:
             // TODO(SaveState): Remove the next two lines when we break compatibility
             s64 x;
             ar& x; // to keep compatibility with old save states that stored global_timer
-            ar& event_queue;
+            std::vector<Event> events = event_queue.GetEvents();
+            ar& events;
+            if (Archive::is_loading::value) {
+                event_queue.Clear();
+                for (const Event& event : events) {
+                    event_queue.Push(event);
+                }
+            }
             ar& event_fifo_id;
             ar& slice_length;
             ar& downcount;
@@ -0,0 +1,84 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <string>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "core/arm/arm_interface.h"
+#include "core/cpu_threads.h"
+
+namespace Core {
+
+CPUThreads::CPUThreads(std::size_t num_cores) : slice(num_cores) {
+    for (std::size_t core_id = 1; core_id < num_cores; ++core_id) {
+        workers.emplace_back(&CPUThreads::WorkerLoop, this, core_id);
+    }
+}
+
+CPUThreads::~CPUThreads() {
+    {
+        std::scoped_lock lock{mutex};
+        stop = true;
+    }
+    start_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void CPUThreads::RunSlice(std::span<ARM_Interface* const> cores) {
+    ASSERT(cores.size() == slice.size());
+    {
+        std::scoped_lock lock{mutex};
+        std::copy(cores.begin(), cores.end(), slice.begin());
+        ++generation;
+        busy_workers = static_cast<u32>(workers.size());
+    }
+    start_cv.notify_all();
+
+    if (slice[0]) {
+        slice[0]->Run();
+    }
+
+    std::unique_lock lock{mutex};
+    done_cv.wait(lock, [this] { return busy_workers == 0; });
+}
+
+void CPUThreads::WorkerLoop(std::size_t core_id) {
+    const std::string name = fmt::format("CPUCore_{}", core_id);
+    Common::SetCurrentThreadName(name.c_str());
+    MicroProfileOnThreadCreate(name.c_str());
+
+    u64 seen_generation = 0;
+    while (true) {
+        ARM_Interface* core;
+        {
+            std::unique_lock lock{mutex};
+            start_cv.wait(lock, [&] { return stop || generation != seen_generation; });
+            if (stop) {
+                break;
+            }
+            seen_generation = generation;
+            core = slice[core_id];
+        }
+
+        if (core) {
+            core->Run();
+        }
+
+        std::scoped_lock lock{mutex};
+        if (--busy_workers == 0) {
+            done_cv.notify_one();
+        }
+    }
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+} // namespace Core
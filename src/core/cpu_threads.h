@@ -0,0 +1,52 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+
+class ARM_Interface;
+
+namespace Core {
+
+/**
+ * Runs the time slices of the emulated ARM11 cores in parallel, each core on its own host thread.
+ * All the cores are given the same slice length and are joined at the end of it, so that they
+ * never drift apart by more than one slice. Any work leaving the JIT must be serialized by the
+ * caller (see System::AcquireCoreContext).
+ */
+class CPUThreads {
+public:
+    /// @param num_cores Number of emulated cores, the first of which runs on the calling thread
+    explicit CPUThreads(std::size_t num_cores);
+    ~CPUThreads();
+
+    CPUThreads(const CPUThreads&) = delete;
+    CPUThreads& operator=(const CPUThreads&) = delete;
+
+    /**
+     * Runs each of the cores until the end of its slice and waits for all of them to finish.
+     * @param cores Cores to run indexed by core id, null for the cores that don't run this slice
+     */
+    void RunSlice(std::span<ARM_Interface* const> cores);
+
+private:
+    void WorkerLoop(std::size_t core_id);
+
+    std::vector<ARM_Interface*> slice;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    u64 generation = 0;
+    u32 busy_workers = 0;
+    bool stop = false;
+};
+
+} // namespace Core
@@ -2,16 +2,62 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <random>
 #include <fmt/format.h>
+#include "common/common_funcs.h"
 #include "common/file_util.h"
+#include "common/mapped_file.h"
+#include "common/memory_usage.h"
+#include "common/settings.h"
+#include "common/swap.h"
 #include "common/texture.h"
+#include "common/thread.h"
 #include "core.h"
 #include "core/custom_tex_cache.h"
+#include "core/frontend/image_interface.h"
 
 namespace Core {
+
+namespace {
+
+/// Header of a texture in the decoded texture cache, followed by its RGBA8 texels
+struct DecodedTextureHeader {
+    u32_le magic;
+    u32_le width;
+    u32_le height;
+    INSERT_PADDING_WORDS(1);
+    u64_le source_size; ///< Size of the PNG file the texture was decoded from
+    s64_le source_time; ///< Modification time of the PNG file
+};
+static_assert(sizeof(DecodedTextureHeader) == 32, "DecodedTextureHeader has incorrect size");
+
+constexpr u32 decoded_texture_magic = 0x30584554; // "TEX0"
+
+/// Textures mapped from the decoded texture cache count too, they are paged in when used
+Common::MemoryUsage::Counter CustomTextureUsage{"Custom textures", "Cached textures"};
+
+std::string DecodedTexturePath(const std::string& dir, u64 hash) {
+    return fmt::format("{}{:016X}.rgba", dir, hash);
+}
+
+} // Anonymous namespace
+
 CustomTexCache::CustomTexCache() = default;
 
-CustomTexCache::~CustomTexCache() = default;
+CustomTexCache::~CustomTexCache() {
+    CustomTextureUsage.Set(0, 0);
+    {
+        std::scoped_lock lock{queue_mutex};
+        stop_workers = true;
+    }
+    queue_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
 
 bool CustomTexCache::IsTextureDumped(u64 hash) const {
     return dumped_textures.count(hash);
@@ -21,16 +67,249 @@ void CustomTexCache::SetTextureDumped(const u64 hash) {
     dumped_textures.insert(hash);
 }
 
-bool CustomTexCache::IsTextureCached(u64 hash) const {
+bool CustomTexCache::IsTextureCached(u64 hash) {
+    CollectDecodedTextures();
     return custom_textures.count(hash);
 }
 
-const CustomTexInfo& CustomTexCache::LookupTexture(u64 hash) const {
-    return custom_textures.at(hash);
+const CustomTexInfo& CustomTexCache::LookupTexture(u64 hash) {
+    auto& texture = custom_textures.at(hash);
+    lru_list.splice(lru_list.begin(), lru_list, texture.lru_entry);
+    return texture.info;
+}
+
+void CustomTexCache::CacheTexture(u64 hash, CustomTexInfo tex_info) {
+    auto it = custom_textures.find(hash);
+    if (it != custom_textures.end()) {
+        cached_size -= it->second.info.Size();
+        lru_list.erase(it->second.lru_entry);
+        custom_textures.erase(it);
+    }
+
+    lru_list.push_front(hash);
+    cached_size += tex_info.Size();
+    custom_textures[hash] = {std::move(tex_info), lru_list.begin()};
+    EvictTextures();
+    CustomTextureUsage.Set(cached_size, custom_textures.size());
+}
+
+bool CustomTexCache::RequestTexture(u64 hash,
+                                    std::shared_ptr<Frontend::ImageInterface> image_interface) {
+    CollectDecodedTextures();
+    if (failed_textures.count(hash)) {
+        return false;
+    }
+
+    {
+        std::scoped_lock lock{queue_mutex};
+        if (!requested_textures.insert(hash).second) {
+            return true;
+        }
+        pending_requests.push_back(hash);
+
+        if (workers.empty()) {
+            // PNG decoding is mostly serial, so a few workers are enough to keep up with
+            // the textures requested by a frame without competing with emulation
+            worker_image_interface = std::move(image_interface);
+            const u32 num_workers = std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U);
+            for (u32 i = 0; i < num_workers; ++i) {
+                workers.emplace_back(&CustomTexCache::WorkerLoop, this);
+            }
+        }
+    }
+    queue_cv.notify_one();
+    return true;
+}
+
+bool CustomTexCache::LoadTexture(u64 hash, Frontend::ImageInterface& image_interface) {
+    if (failed_textures.count(hash)) {
+        return false;
+    }
+
+    CustomTexInfo tex_info;
+    if (!DecodeTexture(image_interface, custom_texture_paths.at(hash), tex_info)) {
+        failed_textures.insert(hash);
+        return false;
+    }
+
+    CacheTexture(hash, std::move(tex_info));
+    return true;
 }
 
-void CustomTexCache::CacheTexture(u64 hash, const std::vector<u8>& tex, u32 width, u32 height) {
-    custom_textures[hash] = {width, height, tex};
+bool CustomTexCache::DecodeTexture(Frontend::ImageInterface& image_interface,
+                                   const CustomTexPathInfo& path_info,
+                                   CustomTexInfo& tex_info) const {
+    const bool use_decoded_cache = !decoded_cache_dir.empty();
+    if (use_decoded_cache && MapDecodedTexture(path_info, tex_info)) {
+        LOG_DEBUG(Render_OpenGL, "Mapped decoded custom texture {}", path_info.path);
+        return true;
+    }
+
+    std::vector<u8> tex;
+    if (!image_interface.DecodePNG(tex, tex_info.width, tex_info.height, path_info.path)) {
+        LOG_ERROR(Render_OpenGL, "Failed to load custom texture {}", path_info.path);
+        return false;
+    }
+
+    // Make sure the texture size is a power of 2
+    std::bitset<32> width_bits(tex_info.width);
+    std::bitset<32> height_bits(tex_info.height);
+    if (width_bits.count() != 1 || height_bits.count() != 1) {
+        LOG_ERROR(Render_OpenGL, "Texture {} size is not a power of 2", path_info.path);
+        return false;
+    }
+
+    LOG_DEBUG(Render_OpenGL, "Loaded custom texture from {}", path_info.path);
+    Common::FlipRGBA8Texture(tex, tex_info.width, tex_info.height);
+
+    // Other instances may be using the texture too, so prefer the mapping of the cached copy
+    if (use_decoded_cache && StoreDecodedTexture(path_info, tex, tex_info.width, tex_info.height) &&
+        MapDecodedTexture(path_info, tex_info)) {
+        return true;
+    }
+
+    auto buffer = std::make_shared<const std::vector<u8>>(std::move(tex));
+    tex_info.tex = std::shared_ptr<const u8>(buffer, buffer->data());
+    return true;
+}
+
+bool CustomTexCache::MapDecodedTexture(const CustomTexPathInfo& path_info,
+                                       CustomTexInfo& tex_info) const {
+    const std::string path = DecodedTexturePath(decoded_cache_dir, path_info.hash);
+    if (!FileUtil::Exists(path)) {
+        return false;
+    }
+
+    const u64 size = FileUtil::GetSize(path);
+    if (size < sizeof(DecodedTextureHeader)) {
+        return false;
+    }
+    auto mapping = std::make_shared<const Common::MappedFile>(path, 0, size);
+    if (!mapping->Data()) {
+        return false;
+    }
+
+    DecodedTextureHeader header;
+    std::memcpy(&header, mapping->Data(), sizeof(header));
+    if (header.magic != decoded_texture_magic ||
+        size != sizeof(header) + static_cast<u64>(header.width) * header.height * 4 ||
+        header.source_size != FileUtil::GetSize(path_info.path) ||
+        header.source_time != FileUtil::GetModificationTime(path_info.path)) {
+        LOG_DEBUG(Render_OpenGL, "Decoded custom texture {} is out of date", path);
+        return false;
+    }
+
+    tex_info.width = header.width;
+    tex_info.height = header.height;
+    tex_info.tex = std::shared_ptr<const u8>(mapping, mapping->Data() + sizeof(header));
+    return true;
+}
+
+bool CustomTexCache::StoreDecodedTexture(const CustomTexPathInfo& path_info,
+                                         const std::vector<u8>& tex, u32 width,
+                                         u32 height) const {
+    DecodedTextureHeader header{};
+    header.magic = decoded_texture_magic;
+    header.width = width;
+    header.height = height;
+    header.source_size = FileUtil::GetSize(path_info.path);
+    header.source_time = FileUtil::GetModificationTime(path_info.path);
+
+    // The texture is written under a name of its own first, so that instances decoding it at the
+    // same time never map a partially written one
+    const std::string path = DecodedTexturePath(decoded_cache_dir, path_info.hash);
+    const std::string temp_path = fmt::format("{}.{:08x}", path, std::random_device{}());
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file.IsOpen() || file.WriteObject(header) != 1 ||
+            file.WriteBytes(tex.data(), tex.size()) != tex.size()) {
+            LOG_WARNING(Render_OpenGL, "Unable to write decoded custom texture {}", path);
+            file.Close();
+            FileUtil::Delete(temp_path);
+            return false;
+        }
+    }
+    if (!FileUtil::Rename(temp_path, path)) {
+        FileUtil::Delete(temp_path);
+        // Another instance may have stored it in the meantime
+        return FileUtil::Exists(path);
+    }
+    return true;
+}
+
+void CustomTexCache::CollectDecodedTextures() {
+    std::vector<std::pair<u64, CustomTexInfo>> decoded;
+    {
+        std::scoped_lock lock{queue_mutex};
+        if (decoded_textures.empty() && decode_failures.empty()) {
+            return;
+        }
+        decoded.swap(decoded_textures);
+        for (const u64 hash : decode_failures) {
+            requested_textures.erase(hash);
+            failed_textures.insert(hash);
+        }
+        decode_failures.clear();
+        for (const auto& [hash, info] : decoded) {
+            requested_textures.erase(hash);
+        }
+    }
+
+    for (auto& [hash, info] : decoded) {
+        lru_list.push_front(hash);
+        cached_size += info.Size();
+        custom_textures[hash] = {std::move(info), lru_list.begin()};
+    }
+    EvictTextures();
+    CustomTextureUsage.Set(cached_size, custom_textures.size());
+}
+
+void CustomTexCache::EvictTextures() {
+    // Preloaded textures are meant to stay resident, so they are not bound by the budget
+    if (Settings::values.preload_textures) {
+        return;
+    }
+
+    const std::size_t budget =
+        static_cast<std::size_t>(Settings::values.custom_textures_cache_size.GetValue()) << 20;
+    // Always keep the most recently used texture, even if it exceeds the budget on its own
+    while (cached_size > budget && lru_list.size() > 1) {
+        const u64 hash = lru_list.back();
+        lru_list.pop_back();
+
+        auto it = custom_textures.find(hash);
+        cached_size -= it->second.info.Size();
+        custom_textures.erase(it);
+    }
+}
+
+void CustomTexCache::WorkerLoop() {
+    Common::SetCurrentThreadName("CustomTexLoader");
+
+    while (true) {
+        u64 hash;
+        {
+            std::unique_lock lock{queue_mutex};
+            queue_cv.wait(lock, [this] { return stop_workers || !pending_requests.empty(); });
+            if (stop_workers) {
+                return;
+            }
+            hash = pending_requests.front();
+            pending_requests.pop_front();
+        }
+
+        // The path map is only populated before the game starts, so it can be read unlocked
+        CustomTexInfo tex_info;
+        const bool success = DecodeTexture(*worker_image_interface,
+                                           custom_texture_paths.at(hash), tex_info);
+
+        std::scoped_lock lock{queue_mutex};
+        if (success) {
+            decoded_textures.emplace_back(hash, std::move(tex_info));
+        } else {
+            decode_failures.push_back(hash);
+        }
+    }
 }
 
 void CustomTexCache::AddTexturePath(u64 hash, const std::string& path) {
@@ -44,6 +323,16 @@ void CustomTexCache::FindCustomTextures(u64 program_id) {
     // Custom textures are currently stored as
     // [TitleID]/tex1_[width]x[height]_[64-bit hash]_[format].png
 
+    if (Settings::values.share_custom_textures) {
+        decoded_cache_dir =
+            fmt::format("{}custom_textures/{:016X}/",
+                        FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), program_id);
+        if (!FileUtil::CreateFullPath(decoded_cache_dir)) {
+            LOG_ERROR(Core, "Unable to create the decoded texture cache {}", decoded_cache_dir);
+            decoded_cache_dir.clear();
+        }
+    }
+
     const std::string load_path = fmt::format(
         "{}textures/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir), program_id);
 
@@ -77,20 +366,8 @@ void CustomTexCache::PreloadTextures(Frontend::ImageInterface& image_interface)
     for (const auto& path : custom_texture_paths) {
         const auto& path_info = path.second;
         Core::CustomTexInfo tex_info;
-        if (image_interface.DecodePNG(tex_info.tex, tex_info.width, tex_info.height,
-                                      path_info.path)) {
-            // Make sure the texture size is a power of 2
-            std::bitset<32> width_bits(tex_info.width);
-            std::bitset<32> height_bits(tex_info.height);
-            if (width_bits.count() == 1 && height_bits.count() == 1) {
-                LOG_DEBUG(Render_OpenGL, "Loaded custom texture from {}", path_info.path);
-                Common::FlipRGBA8Texture(tex_info.tex, tex_info.width, tex_info.height);
-                CacheTexture(path_info.hash, tex_info.tex, tex_info.width, tex_info.height);
-            } else {
-                LOG_ERROR(Render_OpenGL, "Texture {} size is not a power of 2", path_info.path);
-            }
-        } else {
-            LOG_ERROR(Render_OpenGL, "Failed to load custom texture {}", path_info.path);
+        if (DecodeTexture(image_interface, path_info, tex_info)) {
+            CacheTexture(path_info.hash, std::move(tex_info));
         }
     }
 }
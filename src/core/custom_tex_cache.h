@@ -4,7 +4,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -18,7 +24,13 @@ namespace Core {
 struct CustomTexInfo {
     u32 width;
     u32 height;
-    std::vector<u8> tex;
+    /// RGBA8 texels, shared by the cache and the surfaces using the texture. They are either
+    /// decoded in memory or mapped from the decoded texture cache on disk.
+    std::shared_ptr<const u8> tex;
+
+    [[nodiscard]] std::size_t Size() const {
+        return static_cast<std::size_t>(width) * height * 4;
+    }
 };
 
 // This is to avoid parsing the filename multiple times
@@ -36,9 +48,19 @@ public:
     bool IsTextureDumped(u64 hash) const;
     void SetTextureDumped(u64 hash);
 
-    bool IsTextureCached(u64 hash) const;
-    const CustomTexInfo& LookupTexture(u64 hash) const;
-    void CacheTexture(u64 hash, const std::vector<u8>& tex, u32 width, u32 height);
+    bool IsTextureCached(u64 hash);
+    const CustomTexInfo& LookupTexture(u64 hash);
+    void CacheTexture(u64 hash, CustomTexInfo tex_info);
+
+    /**
+     * Queues the replacement texture for decoding on a worker thread. Decoded textures are
+     * picked up by IsTextureCached once they are ready.
+     * @returns false if the texture failed to decode before and is not going to be replaced
+     */
+    bool RequestTexture(u64 hash, std::shared_ptr<Frontend::ImageInterface> image_interface);
+
+    /// Decodes the replacement texture on the calling thread, returns false on failure
+    bool LoadTexture(u64 hash, Frontend::ImageInterface& image_interface);
 
     void AddTexturePath(u64 hash, const std::string& path);
     void FindCustomTextures(u64 program_id);
@@ -48,8 +70,49 @@ public:
     bool IsTexturePathMapEmpty() const;
 
 private:
+    /// Decodes the replacement texture from its PNG file, returns false on failure
+    bool DecodeTexture(Frontend::ImageInterface& image_interface,
+                       const CustomTexPathInfo& path_info, CustomTexInfo& tex_info) const;
+
+    /// Maps the texture from the decoded texture cache, returns false if it isn't up to date
+    bool MapDecodedTexture(const CustomTexPathInfo& path_info, CustomTexInfo& tex_info) const;
+
+    /// Writes the decoded texture to the decoded texture cache, returns false on failure
+    bool StoreDecodedTexture(const CustomTexPathInfo& path_info, const std::vector<u8>& tex,
+                             u32 width, u32 height) const;
+
+    /// Moves the textures decoded by the workers into the cache
+    void CollectDecodedTextures();
+
+    /// Evicts the least recently used textures until the cache fits in its memory budget
+    void EvictTextures();
+
+    void WorkerLoop();
+
+    struct CachedTexture {
+        CustomTexInfo info;
+        std::list<u64>::iterator lru_entry;
+    };
+
     std::unordered_set<u64> dumped_textures;
-    std::unordered_map<u64, CustomTexInfo> custom_textures;
+    std::unordered_map<u64, CachedTexture> custom_textures;
     std::unordered_map<u64, CustomTexPathInfo> custom_texture_paths;
+    /// Directory of the decoded texture cache, shared by all instances running the title
+    std::string decoded_cache_dir;
+
+    std::list<u64> lru_list; ///< Cached textures, the most recently used first
+    std::size_t cached_size = 0;
+    std::unordered_set<u64> failed_textures;
+
+    // Worker threads decoding the requested textures
+    std::vector<std::thread> workers;
+    std::shared_ptr<Frontend::ImageInterface> worker_image_interface;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<u64> pending_requests;
+    std::unordered_set<u64> requested_textures; ///< Queued or being decoded
+    std::vector<std::pair<u64, CustomTexInfo>> decoded_textures;
+    std::vector<u64> decode_failures;
+    bool stop_workers = false;
 };
 } // namespace Core
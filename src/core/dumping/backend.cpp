@@ -7,9 +7,21 @@
 
 namespace VideoDumper {
 
-VideoFrame::VideoFrame(std::size_t width_, std::size_t height_, u8* data_)
-    : width(width_), height(height_), stride(static_cast<u32>(width * 4)),
-      data(data_, data_ + width * height * 4) {}
+VideoFrame::VideoFrame(std::size_t width_, std::size_t height_, u8* data_,
+                       VideoFrameFormat format_)
+    : width(width_), height(height_),
+      stride(static_cast<u32>(format_ == VideoFrameFormat::BGRA ? width * 4 : width)),
+      format(format_), data(data_, data_ + GetSize(width, height, format)) {}
+
+std::size_t VideoFrame::GetSize(std::size_t width, std::size_t height, VideoFrameFormat format) {
+    switch (format) {
+    case VideoFrameFormat::YUV420P:
+        return width * height * 3 / 2;
+    case VideoFrameFormat::BGRA:
+    default:
+        return width * height * 4;
+    }
+}
 
 Backend::~Backend() = default;
 NullBackend::~NullBackend() = default;
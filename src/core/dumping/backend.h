@@ -11,18 +11,31 @@
 #include "core/frontend/framebuffer_layout.h"
 
 namespace VideoDumper {
+
+/// Pixel formats the video frames can be in
+enum class VideoFrameFormat {
+    BGRA,    ///< Packed 32-bit BGRA
+    YUV420P, ///< Planar limited range BT.601 YUV with chroma subsampled by 2 in both directions
+};
+
 /**
  * Frame dump data for a single screen
- * data is in RGB888 format, left to right then top to bottom
+ * data is in the given format, left to right then top to bottom. The planes of planar formats
+ * follow each other without padding.
  */
 class VideoFrame {
 public:
     std::size_t width;
     std::size_t height;
-    u32 stride;
+    u32 stride; ///< Stride of the first plane
+    VideoFrameFormat format;
     std::vector<u8> data;
 
-    VideoFrame(std::size_t width_ = 0, std::size_t height_ = 0, u8* data_ = nullptr);
+    VideoFrame(std::size_t width_ = 0, std::size_t height_ = 0, u8* data_ = nullptr,
+               VideoFrameFormat format_ = VideoFrameFormat::BGRA);
+
+    /// Returns the size of a frame of the given dimensions and format in bytes
+    static std::size_t GetSize(std::size_t width, std::size_t height, VideoFrameFormat format);
 };
 
 class Backend {
@@ -35,6 +48,10 @@ public:
     virtual void StopDumping() = 0;
     virtual bool IsDumping() const = 0;
     virtual Layout::FramebufferLayout GetLayout() const = 0;
+    /// Returns the format the video frames should be passed in, valid once dumping has started
+    virtual VideoFrameFormat GetVideoFrameFormat() const {
+        return VideoFrameFormat::BGRA;
+    }
 };
 
 class NullBackend : public Backend {
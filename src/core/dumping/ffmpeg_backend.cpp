@@ -9,17 +9,22 @@
 #include "common/param_package.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "core/3ds.h"
 #include "core/dumping/ffmpeg_backend.h"
 #include "core/hw/gpu.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
 extern "C" {
+#include <libavutil/hwcontext.h>
 #include <libavutil/pixdesc.h>
 }
 
 namespace VideoDumper {
 
+/// Number of video frames that may wait for the encoder, which evens out encoding time spikes
+constexpr std::size_t VideoFrameQueueSize = 4;
+
 void InitializeFFmpegLibraries() {
     static bool initialized = false;
 
@@ -102,7 +107,8 @@ FFmpegVideoStream::~FFmpegVideoStream() {
     Free();
 }
 
-bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout_) {
+bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout_,
+                             const Common::Rectangle<u32>& region_, const char* title) {
 
     InitializeFFmpegLibraries();
 
@@ -110,7 +116,9 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
         return false;
 
     layout = layout_;
-    frame_count = 0;
+    region = region_;
+    const u32 width = region.GetWidth();
+    const u32 height = region.GetHeight();
 
     // Initialize video codec
     const AVCodec* codec = avcodec_find_encoder_by_name(Settings::values.video_encoder.c_str());
@@ -123,8 +131,8 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     // Configure video codec context
     codec_context->codec_type = AVMEDIA_TYPE_VIDEO;
     codec_context->bit_rate = Settings::values.video_bitrate;
-    codec_context->width = layout.width;
-    codec_context->height = layout.height;
+    codec_context->width = width;
+    codec_context->height = height;
     // TODO(xperia64): While these numbers from core timing work fine, certain video codecs do not
     // support the strange resulting timebase (280071/16756991); Addressing this issue would require
     // resampling the video
@@ -133,10 +141,27 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     codec_context->time_base.num = static_cast<int>(GPU::frame_ticks);
     codec_context->time_base.den = static_cast<int>(BASE_CLOCK_RATE_ARM11);
     codec_context->gop_size = 12;
-    codec_context->pix_fmt = codec->pix_fmts ? codec->pix_fmts[0] : AV_PIX_FMT_YUV420P;
+    // Use as many threads as the encoder supports, unless the options say otherwise
+    codec_context->thread_count = 0;
     if (format_context->oformat->flags & AVFMT_GLOBALHEADER)
         codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
+    // Hardware encoders may list formats of frames in GPU memory first, skip those
+    sw_pixel_format = codec->pix_fmts ? AV_PIX_FMT_NONE : AV_PIX_FMT_YUV420P;
+    for (const AVPixelFormat* format = codec->pix_fmts; format && *format != AV_PIX_FMT_NONE;
+         format++) {
+        const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get(*format);
+        if (descriptor && !(descriptor->flags & AV_PIX_FMT_FLAG_HWACCEL)) {
+            sw_pixel_format = *format;
+            break;
+        }
+    }
+    if (sw_pixel_format != AV_PIX_FMT_NONE) {
+        codec_context->pix_fmt = sw_pixel_format;
+    } else if (!InitHardwareFrames(codec)) {
+        return false;
+    }
+
     AVDictionary* options = ToAVDictionary(Settings::values.video_encoder_options);
     if (avcodec_open2(codec_context.get(), codec, &options) < 0) {
         LOG_ERROR(Render, "Could not open video codec");
@@ -157,61 +182,164 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     }
 
     stream->time_base = codec_context->time_base;
+    if (title[0] != '\0') {
+        av_dict_set(&stream->metadata, "title", title, 0);
+    }
 
     // Allocate frames
     current_frame.reset(av_frame_alloc());
     scaled_frame.reset(av_frame_alloc());
-    scaled_frame->format = codec_context->pix_fmt;
-    scaled_frame->width = layout.width;
-    scaled_frame->height = layout.height;
+    if (codec_context->hw_frames_ctx) {
+        hw_frame.reset(av_frame_alloc());
+    }
+    scaled_frame->format = sw_pixel_format;
+    scaled_frame->width = width;
+    scaled_frame->height = height;
     if (av_frame_get_buffer(scaled_frame.get(), 0) < 0) {
         LOG_ERROR(Render, "Could not allocate frame buffer");
         return false;
     }
 
+    // Let the renderer convert the frames when they can be encoded as they are, which takes
+    // expensive work off the CPU
+    const bool even_size = layout.width % 2 == 0 && layout.height % 2 == 0 &&
+                           region.left % 2 == 0 && region.top % 2 == 0 && width % 2 == 0 &&
+                           height % 2 == 0;
+    frame_format = Settings::values.video_gpu_conversion && even_size &&
+                           sw_pixel_format == AV_PIX_FMT_YUV420P
+                       ? VideoFrameFormat::YUV420P
+                       : VideoFrameFormat::BGRA;
+
     // Create SWS Context
     auto* context = sws_getCachedContext(
-        sws_context.get(), layout.width, layout.height, pixel_format, layout.width, layout.height,
-        codec_context->pix_fmt, SWS_BICUBIC, nullptr, nullptr, nullptr);
+        sws_context.get(), width, height, pixel_format, width, height, sw_pixel_format, SWS_BICUBIC,
+        nullptr, nullptr, nullptr);
     if (context != sws_context.get())
         sws_context.reset(context);
 
     return true;
 }
 
+bool FFmpegVideoStream::InitHardwareFrames(const AVCodec* codec) {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 18, 100)
+    for (int i = 0;; i++) {
+        const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i);
+        if (!config) {
+            break;
+        }
+        if (!(config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_FRAMES_CTX)) {
+            continue;
+        }
+
+        AVBufferRef* device = nullptr;
+        if (av_hwdevice_ctx_create(&device, config->device_type, nullptr, nullptr, 0) < 0) {
+            continue;
+        }
+        AVBufferRef* frames = av_hwframe_ctx_alloc(device);
+        av_buffer_unref(&device);
+        if (!frames) {
+            continue;
+        }
+
+        // NV12 is the format hardware encoders commonly take
+        auto* frames_context = reinterpret_cast<AVHWFramesContext*>(frames->data);
+        frames_context->format = config->pix_fmt;
+        frames_context->sw_format = AV_PIX_FMT_NV12;
+        frames_context->width = region.GetWidth();
+        frames_context->height = region.GetHeight();
+        frames_context->initial_pool_size = 16;
+        if (av_hwframe_ctx_init(frames) < 0) {
+            av_buffer_unref(&frames);
+            continue;
+        }
+
+        // The codec context owns the reference now
+        codec_context->hw_frames_ctx = frames;
+        codec_context->pix_fmt = config->pix_fmt;
+        sw_pixel_format = AV_PIX_FMT_NV12;
+        LOG_INFO(Render, "Uploading video frames to {} for the encoder",
+                 av_hwdevice_get_type_name(config->device_type));
+        return true;
+    }
+#endif
+    LOG_ERROR(Render, "Could not find a pixel format or hardware device for the video encoder");
+    return false;
+}
+
 void FFmpegVideoStream::Free() {
     FFmpegStream::Free();
 
     current_frame.reset();
     scaled_frame.reset();
+    hw_frame.reset();
     sws_context.reset();
 }
 
-void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
+void FFmpegVideoStream::ProcessFrame(VideoFrame& frame, u64 index) {
     if (frame.width != layout.width || frame.height != layout.height) {
         LOG_ERROR(Render, "Frame dropped: resolution does not match");
         return;
     }
-    // Prepare frame
-    current_frame->data[0] = frame.data.data();
-    current_frame->linesize[0] = frame.stride;
-    current_frame->format = pixel_format;
-    current_frame->width = layout.width;
-    current_frame->height = layout.height;
-
-    // Scale the frame
-    if (av_frame_make_writable(scaled_frame.get()) < 0) {
-        LOG_ERROR(Render, "Video frame dropped: Could not prepare frame");
-        return;
+    const u32 width = region.GetWidth();
+    const u32 height = region.GetHeight();
+    AVFrame* output_frame;
+    if (frame.format == VideoFrameFormat::YUV420P) {
+        // The frame is already in the pixel format of the codec. The encoder copies the data as
+        // the frame isn't reference counted.
+        const std::size_t luma_size = layout.width * layout.height;
+        const std::size_t chroma_stride = frame.stride / 2;
+        u8* const luma = frame.data.data();
+        u8* const chroma = luma + luma_size;
+        current_frame->data[0] = luma + region.top * frame.stride + region.left;
+        current_frame->data[1] = chroma + region.top / 2 * chroma_stride + region.left / 2;
+        current_frame->data[2] =
+            chroma + luma_size / 4 + region.top / 2 * chroma_stride + region.left / 2;
+        current_frame->linesize[0] = frame.stride;
+        current_frame->linesize[1] = static_cast<int>(chroma_stride);
+        current_frame->linesize[2] = static_cast<int>(chroma_stride);
+        current_frame->format = AV_PIX_FMT_YUV420P;
+        current_frame->width = width;
+        current_frame->height = height;
+        output_frame = current_frame.get();
+    } else {
+        // Prepare frame
+        current_frame->data[0] = frame.data.data() + region.top * frame.stride + region.left * 4;
+        current_frame->linesize[0] = frame.stride;
+        current_frame->format = pixel_format;
+        current_frame->width = width;
+        current_frame->height = height;
+
+        // Scale the frame
+        if (av_frame_make_writable(scaled_frame.get()) < 0) {
+            LOG_ERROR(Render, "Video frame dropped: Could not prepare frame");
+            return;
+        }
+        if (sws_context) {
+            sws_scale(sws_context.get(), current_frame->data, current_frame->linesize, 0, height,
+                      scaled_frame->data, scaled_frame->linesize);
+        }
+        output_frame = scaled_frame.get();
     }
-    if (sws_context) {
-        sws_scale(sws_context.get(), current_frame->data, current_frame->linesize, 0, layout.height,
-                  scaled_frame->data, scaled_frame->linesize);
+
+    if (hw_frame) {
+        av_frame_unref(hw_frame.get());
+        if (av_hwframe_get_buffer(codec_context->hw_frames_ctx, hw_frame.get(), 0) < 0 ||
+            av_hwframe_transfer_data(hw_frame.get(), output_frame, 0) < 0) {
+            LOG_ERROR(Render, "Video frame dropped: Could not upload frame");
+            return;
+        }
+        output_frame = hw_frame.get();
     }
-    scaled_frame->pts = frame_count++;
+
+    // Dropped frames leave gaps in the indices, which keeps the video in sync with the audio
+    output_frame->pts = static_cast<s64>(index);
 
     // Encode frame
-    SendFrame(scaled_frame.get());
+    SendFrame(output_frame);
+}
+
+VideoFrameFormat FFmpegVideoStream::GetFrameFormat() const {
+    return frame_format;
 }
 
 FFmpegAudioStream::~FFmpegAudioStream() {
@@ -434,8 +562,18 @@ bool FFmpegMuxer::Init(const std::string& path, const Layout::FramebufferLayout&
     }
     format_context.reset(format_context_raw);
 
-    if (!video_stream.Init(*this, layout))
-        return false;
+    if (Settings::values.video_separate_screens) {
+        num_video_streams = 2;
+        if (!video_streams[0].Init(*this, layout, layout.top_screen, "Top screen") ||
+            !video_streams[1].Init(*this, layout, layout.bottom_screen, "Bottom screen")) {
+            return false;
+        }
+    } else {
+        num_video_streams = 1;
+        const Common::Rectangle<u32> frame{0, 0, layout.width, layout.height};
+        if (!video_streams[0].Init(*this, layout, frame, ""))
+            return false;
+    }
     if (!audio_stream.Init(*this))
         return false;
 
@@ -458,13 +596,27 @@ bool FFmpegMuxer::Init(const std::string& path, const Layout::FramebufferLayout&
 }
 
 void FFmpegMuxer::Free() {
-    video_stream.Free();
+    for (auto& video_stream : video_streams) {
+        video_stream.Free();
+    }
     audio_stream.Free();
     format_context.reset();
 }
 
-void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame) {
-    video_stream.ProcessFrame(frame);
+void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame, u64 index) {
+    for (std::size_t i = 0; i < num_video_streams; i++) {
+        video_streams[i].ProcessFrame(frame, index);
+    }
+}
+
+VideoFrameFormat FFmpegMuxer::GetVideoFrameFormat() const {
+    // The streams share the frames
+    for (std::size_t i = 0; i < num_video_streams; i++) {
+        if (video_streams[i].GetFrameFormat() != VideoFrameFormat::YUV420P) {
+            return VideoFrameFormat::BGRA;
+        }
+    }
+    return VideoFrameFormat::YUV420P;
 }
 
 void FFmpegMuxer::ProcessAudioFrame(const VariableAudioFrame& channel0,
@@ -473,7 +625,9 @@ void FFmpegMuxer::ProcessAudioFrame(const VariableAudioFrame& channel0,
 }
 
 void FFmpegMuxer::FlushVideo() {
-    video_stream.Flush();
+    for (std::size_t i = 0; i < num_video_streams; i++) {
+        video_streams[i].Flush();
+    }
 }
 
 void FFmpegMuxer::FlushAudio() {
@@ -498,34 +652,66 @@ FFmpegBackend::~FFmpegBackend() {
     ffmpeg.Free();
 }
 
-bool FFmpegBackend::StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) {
+/// The default layout at the given scale, in which the screens don't overlap and match the
+/// internal resolution
+static Layout::FramebufferLayout SeparateScreensLayout(u32 res_scale) {
+    const u32 top_width = Core::kScreenTopWidth * res_scale;
+    const u32 top_height = Core::kScreenTopHeight * res_scale;
+    const u32 bottom_width = Core::kScreenBottomWidth * res_scale;
+    const u32 bottom_height = Core::kScreenBottomHeight * res_scale;
+    const u32 bottom_left = (top_width - bottom_width) / 2;
+
+    Layout::FramebufferLayout layout{};
+    layout.width = top_width;
+    layout.height = top_height + bottom_height;
+    layout.top_screen_enabled = true;
+    layout.bottom_screen_enabled = true;
+    layout.top_screen = {0, 0, top_width, top_height};
+    layout.bottom_screen = {bottom_left, top_height, bottom_left + bottom_width, layout.height};
+    layout.is_rotated = true;
+    return layout;
+}
+
+bool FFmpegBackend::StartDumping(const std::string& path,
+                                 const Layout::FramebufferLayout& frontend_layout) {
 
     InitializeFFmpegLibraries();
 
+    // The screens are cut out of the frames when they are dumped separately
+    const Layout::FramebufferLayout layout =
+        Settings::values.video_separate_screens
+            ? SeparateScreensLayout(VideoCore::GetResolutionScaleFactor())
+            : frontend_layout;
+
     if (!ffmpeg.Init(path, layout)) {
         ffmpeg.Free();
         return false;
     }
 
     video_layout = layout;
+    video_frame_format = ffmpeg.GetVideoFrameFormat();
 
     if (video_processing_thread.joinable())
         video_processing_thread.join();
+    video_frame_queue.clear();
+    next_video_frame_index = 0;
+    dropped_video_frames = 0;
     video_processing_thread = std::thread([&] {
-        event1.Set();
         while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
+            std::unique_lock lock{video_frame_queue_mutex};
+            video_frame_added.wait(lock, [&] { return !video_frame_queue.empty(); });
+            auto [frame, index] = std::move(video_frame_queue.front());
+            video_frame_queue.pop_front();
+            lock.unlock();
+            video_frame_taken.notify_one();
+
             // Process this frame
-            auto& frame = video_frame_buffers[current_buffer];
             if (frame.width == 0 && frame.height == 0) {
                 // An empty frame marks the end of frame data
                 ffmpeg.FlushVideo();
                 break;
             }
-            ffmpeg.ProcessVideoFrame(frame);
+            ffmpeg.ProcessVideoFrame(frame, index);
         }
         // Finish audio execution first if not done yet
         if (audio_processing_thread.joinable())
@@ -556,9 +742,21 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
 }
 
 void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+    std::unique_lock lock{video_frame_queue_mutex};
+    const u64 index = next_video_frame_index++;
+    // The empty frame marking the end is never dropped
+    const bool is_end = frame.width == 0 && frame.height == 0;
+    if (!is_end && video_frame_queue.size() >= VideoFrameQueueSize) {
+        if (Settings::values.video_drop_frames) {
+            dropped_video_frames++;
+            return;
+        }
+        video_frame_taken.wait(lock,
+                               [&] { return video_frame_queue.size() < VideoFrameQueueSize; });
+    }
+    video_frame_queue.emplace_back(std::move(frame), index);
+    lock.unlock();
+    video_frame_added.notify_one();
 }
 
 void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
@@ -602,8 +800,16 @@ Layout::FramebufferLayout FFmpegBackend::GetLayout() const {
     return video_layout;
 }
 
+VideoFrameFormat FFmpegBackend::GetVideoFrameFormat() const {
+    return video_frame_format;
+}
+
 void FFmpegBackend::EndDumping() {
     LOG_INFO(Render, "Ending frame dumping");
+    if (dropped_video_frames != 0) {
+        LOG_WARNING(Render, "{} video frames were dropped as the encoder fell behind",
+                    dropped_video_frames);
+    }
 
     ffmpeg.WriteTrailer();
     ffmpeg.Free();
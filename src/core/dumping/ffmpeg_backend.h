@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -69,15 +70,23 @@ protected:
 
 /**
  * A FFmpegStream used for video data.
- * Rescales, encodes and writes a frame.
+ * Rescales, encodes and writes a region of a frame.
  */
 class FFmpegVideoStream : public FFmpegStream {
 public:
     ~FFmpegVideoStream();
 
-    bool Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout);
+    /**
+     * @param layout layout of the frames
+     * @param region the region of the frames to encode
+     * @param title title of the stream, empty for none
+     */
+    bool Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout,
+              const Common::Rectangle<u32>& region, const char* title);
     void Free();
-    void ProcessFrame(VideoFrame& frame);
+    /// Encodes the frame, index is its position in the video
+    void ProcessFrame(VideoFrame& frame, u64 index);
+    VideoFrameFormat GetFrameFormat() const;
 
 private:
     struct SwsContextDeleter {
@@ -86,14 +95,23 @@ private:
         }
     };
 
-    u64 frame_count{};
+    /// Sets up uploading the frames for encoders that only take frames in GPU memory
+    bool InitHardwareFrames(const AVCodec* codec);
 
     std::unique_ptr<AVFrame, AVFrameDeleter> current_frame{};
     std::unique_ptr<AVFrame, AVFrameDeleter> scaled_frame{};
+    /// The uploaded frame, for hardware encoders
+    std::unique_ptr<AVFrame, AVFrameDeleter> hw_frame{};
     std::unique_ptr<SwsContext, SwsContextDeleter> sws_context{};
     Layout::FramebufferLayout layout;
-
-    /// The pixel format the frames are stored in
+    Common::Rectangle<u32> region;
+    /// The pixel format of the frames in CPU memory
+    AVPixelFormat sw_pixel_format{};
+    /// The format the frames are requested in, frames in the pixel format of the codec are encoded
+    /// directly
+    VideoFrameFormat frame_format{};
+
+    /// The pixel format the frames are stored in when they need to be converted
     static constexpr AVPixelFormat pixel_format = AVPixelFormat::AV_PIX_FMT_BGRA;
 };
 
@@ -138,7 +156,8 @@ public:
 
     bool Init(const std::string& path, const Layout::FramebufferLayout& layout);
     void Free();
-    void ProcessVideoFrame(VideoFrame& frame);
+    void ProcessVideoFrame(VideoFrame& frame, u64 index);
+    VideoFrameFormat GetVideoFrameFormat() const;
     void ProcessAudioFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
     void FlushVideo();
     void FlushAudio();
@@ -153,7 +172,9 @@ private:
     };
 
     FFmpegAudioStream audio_stream{};
-    FFmpegVideoStream video_stream{};
+    /// The whole frame, or the top and bottom screens when they are dumped separately
+    std::array<FFmpegVideoStream, 2> video_streams{};
+    std::size_t num_video_streams = 0;
     std::unique_ptr<AVFormatContext, AVFormatContextDeleter> format_context{};
     std::mutex format_context_mutex;
 
@@ -162,7 +183,8 @@ private:
 
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer.
+ * The video frames are passed to the encoder through a bounded queue. When it is full, the
+ * frames are either dropped or the caller waits, depending on the settings.
  */
 class FFmpegBackend : public Backend {
 public:
@@ -175,6 +197,7 @@ public:
     void StopDumping() override;
     bool IsDumping() const override;
     Layout::FramebufferLayout GetLayout() const override;
+    VideoFrameFormat GetVideoFrameFormat() const override;
 
 private:
     void EndDumping();
@@ -184,9 +207,14 @@ private:
     FFmpegMuxer ffmpeg{};
 
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
+    VideoFrameFormat video_frame_format{};
+    /// Frames waiting to be encoded, with their position in the video
+    std::deque<std::pair<VideoFrame, u64>> video_frame_queue;
+    std::mutex video_frame_queue_mutex;
+    std::condition_variable video_frame_added;
+    std::condition_variable video_frame_taken;
+    u64 next_video_frame_index = 0;
+    u64 dropped_video_frames = 0;
     std::thread video_processing_thread;
 
     std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
@@ -58,6 +58,9 @@ ResultVal<std::unique_ptr<FileBackend>> SDMCArchive::OpenFile(const Path& path,
 
 ResultVal<std::unique_ptr<FileBackend>> SDMCArchive::OpenFileBase(const Path& path,
                                                                   const Mode& mode) const {
+    if (mode.create_flag) {
+        InvalidateDiskDirectories();
+    }
     LOG_DEBUG(Service_FS, "called path={} mode={:01X}", path.DebugStr(), mode.hex);
 
     const PathParser path_parser(path);
@@ -116,6 +119,7 @@ ResultVal<std::unique_ptr<FileBackend>> SDMCArchive::OpenFileBase(const Path& pa
 }
 
 ResultCode SDMCArchive::DeleteFile(const Path& path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -150,6 +154,7 @@ ResultCode SDMCArchive::DeleteFile(const Path& path) const {
 }
 
 ResultCode SDMCArchive::RenameFile(const Path& src_path, const Path& dest_path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser_src(src_path);
 
     // TODO: Verify these return codes with HW
@@ -181,6 +186,7 @@ ResultCode SDMCArchive::RenameFile(const Path& src_path, const Path& dest_path)
 template <typename T>
 static ResultCode DeleteDirectoryHelper(const Path& path, const std::string& mount_point,
                                         T deleter) {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -227,6 +233,7 @@ ResultCode SDMCArchive::DeleteDirectoryRecursively(const Path& path) const {
 }
 
 ResultCode SDMCArchive::CreateFile(const FileSys::Path& path, u64 size) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -272,6 +279,7 @@ ResultCode SDMCArchive::CreateFile(const FileSys::Path& path, u64 size) const {
 }
 
 ResultCode SDMCArchive::CreateDirectory(const Path& path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -307,6 +315,7 @@ ResultCode SDMCArchive::CreateDirectory(const Path& path) const {
 }
 
 ResultCode SDMCArchive::RenameDirectory(const Path& src_path, const Path& dest_path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser_src(src_path);
 
     // TODO: Verify these return codes with HW
@@ -7,6 +7,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/file_sys/archive_source_sd_savedata.h"
+#include "core/file_sys/disk_archive.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/savedata_archive.h"
 #include "core/hle/service/fs/archive.h"
@@ -62,6 +63,7 @@ ResultCode ArchiveSource_SDSaveData::Format(u64 program_id,
     std::string concrete_mount_point = GetSaveDataPath(mount_point, program_id);
     FileUtil::DeleteDirRecursively(concrete_mount_point);
     FileUtil::CreateFullPath(concrete_mount_point);
+    InvalidateDiskDirectories();
 
     // Write the format metadata
     std::string metadata_path = GetSaveDataMetadataPath(mount_point, program_id);
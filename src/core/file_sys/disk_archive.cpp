@@ -4,7 +4,11 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "common/archives.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
@@ -20,11 +24,16 @@ SERIALIZE_EXPORT_IMPL(FileSys::DiskDirectory)
 
 namespace FileSys {
 
+DiskFile::~DiskFile() {
+    FlushPendingWrite();
+}
+
 ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length,
                                       u8* buffer) const {
     if (!mode.read_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
+    FlushPendingWrite();
     file->Seek(offset, SEEK_SET);
     return MakeResult<std::size_t>(file->ReadBytes(buffer, length));
 }
@@ -34,32 +43,125 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
-    file->Seek(offset, SEEK_SET);
-    std::size_t written = file->WriteBytes(buffer, length);
-    if (flush)
-        file->Flush();
-    return MakeResult<std::size_t>(written);
+    // The size of the file in the scans of its directory may be changing
+    InvalidateDiskDirectories();
+
+    if (!pending_write.empty() &&
+        (offset < pending_write_offset || offset > pending_write_offset + pending_write.size() ||
+         offset + length - pending_write_offset > MAX_PENDING_WRITE)) {
+        FlushPendingWrite();
+    }
+
+    if (pending_write.empty()) {
+        if (flush || length >= MAX_PENDING_WRITE) {
+            file->Seek(offset, SEEK_SET);
+            std::size_t written = file->WriteBytes(buffer, length);
+            if (flush)
+                file->Flush();
+            return MakeResult<std::size_t>(written);
+        }
+        pending_write_offset = offset;
+    }
+
+    const std::size_t pending_offset = static_cast<std::size_t>(offset - pending_write_offset);
+    if (pending_offset + length > pending_write.size()) {
+        pending_write.resize(pending_offset + length);
+    }
+    std::memcpy(pending_write.data() + pending_offset, buffer, length);
+
+    if (flush) {
+        Flush();
+    }
+    return MakeResult<std::size_t>(length);
+}
+
+void DiskFile::FlushPendingWrite() const {
+    if (pending_write.empty()) {
+        return;
+    }
+    file->Seek(pending_write_offset, SEEK_SET);
+    if (file->WriteBytes(pending_write.data(), pending_write.size()) != pending_write.size()) {
+        LOG_ERROR(Service_FS, "Failed to write {:#x} bytes at offset {:#x}", pending_write.size(),
+                  pending_write_offset);
+    }
+    pending_write.clear();
 }
 
 u64 DiskFile::GetSize() const {
-    return file->GetSize();
+    const u64 size = file->GetSize();
+    if (pending_write.empty()) {
+        return size;
+    }
+    return std::max<u64>(size, pending_write_offset + pending_write.size());
 }
 
 bool DiskFile::SetSize(const u64 size) const {
+    // Data still buffered by the host must not be written back after truncating
+    Flush();
     file->Resize(size);
-    file->Flush();
+    InvalidateDiskDirectories();
     return true;
 }
 
 bool DiskFile::Close() const {
+    FlushPendingWrite();
     return file->Close();
 }
 
+void DiskFile::Flush() const {
+    FlushPendingWrite();
+    file->Flush();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-DiskDirectory::DiskDirectory(const std::string& path) {
-    directory.size = FileUtil::ScanDirectoryTree(path, directory);
-    directory.isDirectory = true;
+namespace {
+
+struct CachedDirectory {
+    u64 generation;
+    s64 modification_time;
+    std::shared_ptr<const FileUtil::FSTEntry> entry;
+};
+
+/// Maximum number of directories whose scans are kept
+constexpr std::size_t MAX_CACHED_DIRECTORIES = 64;
+
+std::mutex directory_cache_mutex;
+std::unordered_map<std::string, CachedDirectory> directory_cache;
+std::atomic<u64> directory_cache_generation{};
+
+} // Anonymous namespace
+
+std::shared_ptr<const FileUtil::FSTEntry> ScanDiskDirectory(const std::string& path) {
+    const u64 generation = directory_cache_generation.load(std::memory_order_acquire);
+    // The modification time catches entries added or removed by the host behind our back
+    const s64 modification_time = FileUtil::GetModificationTime(path);
+    {
+        std::scoped_lock lock{directory_cache_mutex};
+        const auto it = directory_cache.find(path);
+        if (it != directory_cache.end() && it->second.generation == generation &&
+            it->second.modification_time == modification_time) {
+            return it->second.entry;
+        }
+    }
+
+    auto entry = std::make_shared<FileUtil::FSTEntry>();
+    entry->size = FileUtil::ScanDirectoryTree(path, *entry);
+    entry->isDirectory = true;
+
+    std::scoped_lock lock{directory_cache_mutex};
+    if (directory_cache.size() >= MAX_CACHED_DIRECTORIES && !directory_cache.contains(path)) {
+        directory_cache.clear();
+    }
+    directory_cache.insert_or_assign(path, CachedDirectory{generation, modification_time, entry});
+    return entry;
+}
+
+void InvalidateDiskDirectories() {
+    directory_cache_generation.fetch_add(1, std::memory_order_release);
+}
+
+DiskDirectory::DiskDirectory(const std::string& path) : directory{*ScanDiskDirectory(path)} {
     children_iterator = directory.children.begin();
 }
 
@@ -31,6 +31,7 @@ public:
         delay_generator = std::move(delay_generator_);
         mode.hex = mode_.hex;
     }
+    ~DiskFile() override;
 
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
@@ -38,20 +39,31 @@ public:
     u64 GetSize() const override;
     bool SetSize(u64 size) const override;
     bool Close() const override;
-
-    void Flush() const override {
-        file->Flush();
-    }
+    void Flush() const override;
 
 protected:
     Mode mode;
     std::unique_ptr<FileUtil::IOFile> file;
 
 private:
+    /// Maximum size of the range of consecutive writes buffered before writing it to the file
+    static constexpr std::size_t MAX_PENDING_WRITE = 256 * 1024;
+
+    /// Writes the buffered range to the file
+    void FlushPendingWrite() const;
+
+    // Small writes that continue or overlap each other are coalesced in memory, and written to the
+    // file as one when something else needs the file to be up to date
+    mutable std::vector<u8> pending_write;
+    mutable u64 pending_write_offset = 0;
+
     DiskFile() = default;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        if (Archive::is_saving::value) {
+            FlushPendingWrite();
+        }
         ar& boost::serialization::base_object<FileBackend>(*this);
         ar& mode.hex;
         ar& file;
@@ -59,6 +71,15 @@ private:
     friend class boost::serialization::access;
 };
 
+/**
+ * Returns the entries of a host directory, scanning it only if it wasn't already scanned since
+ * the last call to InvalidateDiskDirectories and its modification time didn't change.
+ */
+std::shared_ptr<const FileUtil::FSTEntry> ScanDiskDirectory(const std::string& path);
+
+/// Drops the cached directory scans, to be called whenever the contents of a disk archive change
+void InvalidateDiskDirectories();
+
 class DiskDirectory : public DirectoryBackend {
 public:
     explicit DiskDirectory(const std::string& path);
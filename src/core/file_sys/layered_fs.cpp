@@ -9,6 +9,7 @@
 #include "common/assert.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/string_util.h"
 #include "common/swap.h"
 #include "core/file_sys/layered_fs.h"
@@ -54,6 +55,9 @@ struct FileMetadata {
 };
 static_assert(sizeof(FileMetadata) == 0x20, "Size of FileMetadata is not correct");
 
+// Identifies the index files, and their version in the low byte
+constexpr u32 INDEX_MAGIC = 0x4C465301; // LFS\x01
+
 LayeredFS::LayeredFS() = default;
 
 LayeredFS::LayeredFS(std::shared_ptr<RomFSReader> romfs_, std::string patch_path_,
@@ -68,6 +72,16 @@ void LayeredFS::Load() {
 
     ASSERT_MSG(header.header_length == sizeof(header), "Header size is incorrect");
 
+    // Unchanged mods reuse the metadata built the last time they were loaded. Dumping the RomFS
+    // needs the directory tree, so it always loads it.
+    u64 fingerprint{};
+    if (load_relocations) {
+        fingerprint = ComputeFingerprint();
+        if (LoadIndex(fingerprint)) {
+            return;
+        }
+    }
+
     // TODO: is root always the first directory in table?
     root.parent = &root;
     LoadDirectory(root, 0);
@@ -78,6 +92,10 @@ void LayeredFS::Load() {
     }
 
     RebuildMetadata();
+
+    if (load_relocations) {
+        SaveIndex(fingerprint);
+    }
 }
 
 LayeredFS::~LayeredFS() = default;
@@ -328,22 +346,25 @@ static std::size_t WriteName(u8* dest, std::u16string name) {
 void LayeredFS::BuildDirectories() {
     directory_metadata_table.resize(current_directory_offset, 0xFF);
 
+    // Link siblings up front, instead of scanning the parent of every directory
+    std::unordered_map<const Directory*, u32> next_sibling_offsets;
+    for (const auto& directory : directory_list) {
+        const auto& children = directory->directories;
+        for (std::size_t i = 1; i < children.size(); ++i) {
+            next_sibling_offsets.emplace(children[i - 1].get(),
+                                         directory_metadata_offset_map.at(children[i].get()));
+        }
+    }
+
     std::size_t written = 0;
     for (const auto& directory : directory_list) {
         DirectoryMetadata metadata;
         std::memset(&metadata, 0xFF, sizeof(metadata));
         metadata.parent_directory_offset = directory_metadata_offset_map.at(directory->parent);
 
-        if (directory->parent != directory) {
-            bool flag = false;
-            for (const auto& sibling : directory->parent->directories) {
-                if (flag) {
-                    metadata.next_sibling_offset = directory_metadata_offset_map.at(sibling.get());
-                    break;
-                } else if (sibling.get() == directory) {
-                    flag = true;
-                }
-            }
+        if (const auto it = next_sibling_offsets.find(directory);
+            it != next_sibling_offsets.end()) {
+            metadata.next_sibling_offset = it->second;
         }
 
         if (!directory->directories.empty()) {
@@ -378,6 +399,21 @@ void LayeredFS::BuildDirectories() {
 void LayeredFS::BuildFiles() {
     file_metadata_table.resize(current_file_offset, 0xFF);
 
+    // Link siblings up front, skipping removed files
+    std::unordered_map<const File*, u32> next_sibling_offsets;
+    for (const auto& directory : directory_list) {
+        const File* previous = nullptr;
+        for (const auto& sibling : directory->files) {
+            if (sibling->relocation.type == 3) { // removed file
+                continue;
+            }
+            if (previous) {
+                next_sibling_offsets.emplace(previous, file_metadata_offset_map.at(sibling.get()));
+            }
+            previous = sibling.get();
+        }
+    }
+
     std::size_t written = 0;
     for (const auto& file : file_list) {
         FileMetadata metadata;
@@ -385,17 +421,8 @@ void LayeredFS::BuildFiles() {
 
         metadata.parent_directory_offset = directory_metadata_offset_map.at(file->parent);
 
-        bool flag = false;
-        for (const auto& sibling : file->parent->files) {
-            if (sibling->relocation.type == 3) { // removed file
-                continue;
-            }
-            if (flag) {
-                metadata.next_sibling_offset = file_metadata_offset_map.at(sibling.get());
-                break;
-            } else if (sibling.get() == file) {
-                flag = true;
-            }
+        if (const auto it = next_sibling_offsets.find(file); it != next_sibling_offsets.end()) {
+            metadata.next_sibling_offset = it->second;
         }
 
         metadata.file_data_offset = current_data_offset;
@@ -483,6 +510,160 @@ void LayeredFS::RebuildMetadata() {
                 header.file_metadata_table.length);
 }
 
+static std::string WithoutTrailingSeparator(std::string path) {
+    while (!path.empty() && (path.back() == '/' || path.back() == '\\')) {
+        path.pop_back();
+    }
+    return path;
+}
+
+u64 LayeredFS::ComputeFingerprint() {
+    std::vector<u8> data(header.file_data_offset);
+    romfs->ReadFile(0, data.size(), data.data());
+    const u64 metadata_hash = Common::ComputeHash64(data.data(), data.size());
+
+    std::string entries =
+        fmt::format("{:x}:{:x}:{:x}\n", INDEX_MAGIC, romfs->GetSize(), metadata_hash);
+    const FileUtil::DirectoryEntryCallable callback =
+        [&entries, &callback](u64* /*num_entries_out*/, const std::string& directory,
+                              const std::string& virtual_name) {
+            const auto path = directory + virtual_name;
+            if (FileUtil::IsDirectory(path)) {
+                entries += fmt::format("{}/\n", path);
+                return FileUtil::ForeachDirectoryEntry(nullptr, path + DIR_SEP, callback);
+            }
+            entries += fmt::format("{}:{:x}:{:x}\n", path, FileUtil::GetSize(path),
+                                   FileUtil::GetModificationTime(path));
+            return true;
+        };
+    for (const auto& path : {patch_path, patch_ext_path}) {
+        const auto directory = WithoutTrailingSeparator(path) + DIR_SEP;
+        entries += fmt::format("{}\n", directory);
+        if (FileUtil::Exists(directory)) {
+            FileUtil::ForeachDirectoryEntry(nullptr, directory, callback);
+        }
+    }
+    return Common::ComputeHash64(entries.data(), entries.size());
+}
+
+std::string LayeredFS::GetIndexPath() const {
+    const auto paths = fmt::format("{}\n{}", WithoutTrailingSeparator(patch_path),
+                                   WithoutTrailingSeparator(patch_ext_path));
+    return fmt::format("{}layeredfs{}{:016x}.bin",
+                       FileUtil::GetUserPath(FileUtil::UserPath::CacheDir), DIR_SEP,
+                       Common::ComputeHash64(paths.data(), paths.size()));
+}
+
+bool LayeredFS::LoadIndex(u64 fingerprint) {
+    FileUtil::IOFile file(GetIndexPath(), "rb");
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    // Sizes are checked against the size of the index, so that a corrupted one can't make the
+    // allocations explode
+    const u64 index_size = file.GetSize();
+    const auto read_value = [&file](auto& value) {
+        return file.ReadBytes(&value, sizeof(value)) == sizeof(value);
+    };
+    const auto read_string = [&file, &read_value, index_size](std::string& value) {
+        u32 length{};
+        if (!read_value(length) || length > index_size) {
+            return false;
+        }
+        value.resize(length);
+        return file.ReadBytes(value.data(), length) == length;
+    };
+
+    u32 magic{};
+    u64 index_fingerprint{};
+    u64 metadata_size{};
+    if (!read_value(magic) || magic != INDEX_MAGIC || !read_value(index_fingerprint) ||
+        index_fingerprint != fingerprint || !read_value(metadata_size) ||
+        metadata_size > index_size) {
+        return false;
+    }
+
+    std::vector<u8> index_metadata(metadata_size);
+    u64 data_size{};
+    u64 file_count{};
+    if (file.ReadBytes(index_metadata.data(), index_metadata.size()) != metadata_size ||
+        !read_value(data_size) || !read_value(file_count) || file_count > index_size) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<File>> files;
+    std::map<u64, File*> offsets;
+    for (u64 i = 0; i < file_count; ++i) {
+        auto current = std::make_unique<File>();
+        auto& relocation = current->relocation;
+        u64 data_offset{};
+        u64 patched_size{};
+        if (!read_value(data_offset) || !read_value(relocation.type) ||
+            !read_value(relocation.original_offset) || !read_value(relocation.size) ||
+            !read_string(current->path) || !read_string(relocation.replace_file_path) ||
+            !read_value(patched_size) || patched_size > index_size) {
+            return false;
+        }
+        relocation.patched_file.resize(patched_size);
+        if (file.ReadBytes(relocation.patched_file.data(), patched_size) != patched_size) {
+            return false;
+        }
+        offsets.emplace(data_offset, current.get());
+        files.emplace_back(std::move(current));
+    }
+
+    metadata = std::move(index_metadata);
+    current_data_offset = data_size;
+    indexed_files = std::move(files);
+    data_offset_map = std::move(offsets);
+    LOG_INFO(Service_FS, "LayeredFS loaded unchanged mods from index {}", GetIndexPath());
+    return true;
+}
+
+void LayeredFS::SaveIndex(u64 fingerprint) const {
+    const auto path = GetIndexPath();
+    std::string directory;
+    Common::SplitPath(path, &directory, nullptr, nullptr);
+    if (!FileUtil::CreateFullPath(directory)) {
+        return;
+    }
+
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_WARNING(Service_FS, "LayeredFS could not create index {}", path);
+        return;
+    }
+
+    const auto write_string = [&file](const std::string& value) {
+        file.WriteObject(static_cast<u32>(value.size()));
+        file.WriteString(value);
+    };
+
+    file.WriteObject(INDEX_MAGIC);
+    file.WriteObject(fingerprint);
+    file.WriteObject(static_cast<u64>(metadata.size()));
+    file.WriteBytes(metadata.data(), metadata.size());
+    file.WriteObject(current_data_offset);
+    file.WriteObject(static_cast<u64>(data_offset_map.size()));
+    for (const auto& [data_offset, current] : data_offset_map) {
+        const auto& relocation = current->relocation;
+        file.WriteObject(data_offset);
+        file.WriteObject(relocation.type);
+        file.WriteObject(relocation.original_offset);
+        file.WriteObject(relocation.size);
+        write_string(current->path);
+        write_string(relocation.replace_file_path);
+        file.WriteObject(static_cast<u64>(relocation.patched_file.size()));
+        file.WriteBytes(relocation.patched_file.data(), relocation.patched_file.size());
+    }
+
+    if (!file.IsGood()) {
+        file.Close();
+        FileUtil::Delete(path);
+    }
+}
+
 std::size_t LayeredFS::GetSize() const {
     return metadata.size() + current_data_offset;
 }
@@ -98,6 +98,19 @@ private:
 
     void RebuildMetadata();
 
+    // Hashes the base RomFS metadata, and the paths, sizes and modification times of the mod
+    // files, which together determine the built metadata
+    u64 ComputeFingerprint();
+
+    // Returns the path of the index persisting the built metadata for these mod paths
+    std::string GetIndexPath() const;
+
+    // Loads the built metadata and relocations from the index.
+    // Returns false if the index is missing or was built for a different fingerprint.
+    bool LoadIndex(u64 fingerprint);
+
+    void SaveIndex(u64 fingerprint) const;
+
     void Load();
 
     std::shared_ptr<RomFSReader> romfs;
@@ -111,6 +124,7 @@ private:
     std::unordered_map<std::string, Directory*> directory_path_map;
     std::map<u64, File*> data_offset_map; // assigned data offset -> file
     std::vector<u8> metadata;             // Includes header, hash table and metadata
+    std::vector<std::unique_ptr<File>> indexed_files; // Files with data, when loaded from index
 
     // Used for rebuilding header
     std::vector<u32_le> directory_hash_table;
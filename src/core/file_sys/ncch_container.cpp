@@ -8,8 +8,11 @@
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
+#include "common/common_paths.h"
 #include "common/common_types.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/string_util.h"
 #include "core/core.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/ncch_container.h"
@@ -65,8 +68,8 @@ static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decom
     u32 index = compressed_size - ((buffer_top_and_bottom >> 24) & 0xFF);
     u32 stop_index = compressed_size - (buffer_top_and_bottom & 0xFFFFFF);
 
-    memset(decompressed, 0, decompressed_size);
     memcpy(decompressed, compressed, compressed_size);
+    memset(decompressed + compressed_size, 0, decompressed_size - compressed_size);
 
     while (index > stop_index) {
         u8 control = compressed[--index];
@@ -90,17 +93,20 @@ static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decom
                 segment_offset &= 0x0FFF;
                 segment_offset += 2;
 
-                // Check if compression is out of bounds
-                if (out < segment_size)
+                // Check if compression is out of bounds, the first byte copied is the furthest
+                if (out < segment_size || out + segment_offset >= decompressed_size)
                     return false;
 
-                for (unsigned j = 0; j < segment_size; j++) {
-                    // Check if compression is out of bounds
-                    if (out + segment_offset >= decompressed_size)
-                        return false;
-
-                    u8 data = decompressed[out + segment_offset];
-                    decompressed[--out] = data;
+                if (segment_size <= segment_offset + 1) {
+                    // The source and destination of the copy don't overlap
+                    out -= segment_size;
+                    std::memcpy(decompressed + out, decompressed + out + segment_offset + 1,
+                                segment_size);
+                } else {
+                    for (unsigned j = 0; j < segment_size; j++) {
+                        u8 data = decompressed[out + segment_offset];
+                        decompressed[--out] = data;
+                    }
                 }
             } else {
                 // Check if compression is out of bounds
@@ -114,6 +120,59 @@ static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decom
     return true;
 }
 
+constexpr u32 CODE_CACHE_MAGIC = 0x43444301; // CDC\x01
+
+/// Returns the path of the cached decompressed .code section of a program
+static std::string GetCodeCachePath(u64 program_id) {
+    return fmt::format("{}code{}{:016X}.bin", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+                       DIR_SEP, program_id);
+}
+
+/**
+ * Loads the decompressed .code section of a program from the cache
+ * @param hash Hash of the compressed section the cached one must have been decompressed from
+ * @return True if the cached section was valid and loaded
+ */
+static bool LoadCachedCode(u64 program_id, u64 hash, std::vector<u8>& buffer) {
+    FileUtil::IOFile file(GetCodeCachePath(program_id), "rb");
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    u32 magic{};
+    u64 cached_hash{};
+    u64 size{};
+    if (file.ReadBytes(&magic, sizeof(magic)) != sizeof(magic) || magic != CODE_CACHE_MAGIC ||
+        file.ReadBytes(&cached_hash, sizeof(cached_hash)) != sizeof(cached_hash) ||
+        cached_hash != hash || file.ReadBytes(&size, sizeof(size)) != sizeof(size) ||
+        size != buffer.size()) {
+        return false;
+    }
+    return file.ReadBytes(buffer.data(), buffer.size()) == buffer.size();
+}
+
+static void SaveCachedCode(u64 program_id, u64 hash, const std::vector<u8>& buffer) {
+    const auto path = GetCodeCachePath(program_id);
+    std::string directory;
+    Common::SplitPath(path, &directory, nullptr, nullptr);
+    if (!FileUtil::CreateFullPath(directory)) {
+        return;
+    }
+
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_WARNING(Service_FS, "Could not create code cache {}", path);
+        return;
+    }
+    file.WriteObject(CODE_CACHE_MAGIC);
+    file.WriteObject(hash);
+    file.WriteObject(static_cast<u64>(buffer.size()));
+    if (file.WriteBytes(buffer.data(), buffer.size()) != buffer.size()) {
+        file.Close();
+        FileUtil::Delete(path);
+    }
+}
+
 NCCHContainer::NCCHContainer(const std::string& filepath, u32 ncch_offset, u32 partition)
     : ncch_offset(ncch_offset), partition(partition), filepath(filepath) {
     file = FileUtil::IOFile(filepath, "rb");
@@ -515,6 +574,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
     if (!exefs_file.IsOpen())
         return Loader::ResultStatus::Error;
 
+    std::unique_lock lock{exefs_mutex};
     LOG_DEBUG(Service_FS, "{} sections:", kMaxSections);
     // Iterate through the ExeFs archive until we find a section with the specified name...
     for (unsigned section_number = 0; section_number < kMaxSections; section_number++) {
@@ -555,13 +615,19 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 if (is_encrypted) {
                     dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
                 }
+                lock.unlock();
 
-                // Decompress .code section...
+                // Decompress .code section, unless it was already decompressed at a previous boot
                 u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
                 buffer.resize(decompressed_size);
+                const u64 hash = Common::ComputeHash64(&temp_buffer[0], section.size);
+                if (LoadCachedCode(ncch_header.program_id, hash, buffer)) {
+                    return Loader::ResultStatus::Success;
+                }
                 if (!LZSS_Decompress(&temp_buffer[0], section.size, buffer.data(),
                                      decompressed_size))
                     return Loader::ResultStatus::ErrorInvalidFormat;
+                SaveCachedCode(ncch_header.program_id, hash, buffer);
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
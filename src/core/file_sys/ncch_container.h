@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "common/bit_field.h"
@@ -370,6 +371,7 @@ private:
     std::string filepath;
     FileUtil::IOFile file;
     FileUtil::IOFile exefs_file;
+    std::mutex exefs_mutex; ///< Guards exefs_file, sections can be loaded from multiple threads
 };
 
 } // namespace FileSys
@@ -19,6 +19,8 @@
 // DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+#include <mutex>
+#include <unordered_map>
 #include "core/file_sys/file_backend.h"
 #include "core/file_sys/plugin_3gx.h"
 #include "core/file_sys/plugin_3gx_bootloader.h"
@@ -62,21 +64,71 @@ static bool ReadSection(std::vector<u8>& data_out, FileUtil::IOFile& file, std::
     return true;
 }
 
+namespace {
+
+/// A plugin read by an earlier launch, with the size and modification time of its file then
+struct CachedPlugin {
+    u64 file_size;
+    s64 modification_time;
+    FileSys::Plugin3GXLoader plugin;
+};
+
+std::mutex plugin_cache_mutex;
+std::unordered_map<std::string, CachedPlugin> plugin_cache;
+
+} // Anonymous namespace
+
 Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
     Service::PLGLDR::PLG_LDR::PluginLoaderContext& plg_context, Kernel::Process& process,
     Kernel::KernelSystem& kernel) {
-    FileUtil::IOFile file(plg_context.plugin_path, "rb");
+    // Plugins are usually loaded on every launch of the same title, only read them again when
+    // their file changed
+    const std::string& path = plg_context.plugin_path;
+    const u64 file_size = FileUtil::GetSize(path);
+    const s64 modification_time = FileUtil::GetModificationTime(path);
+    bool is_cached = false;
+    {
+        std::scoped_lock lock{plugin_cache_mutex};
+        const auto it = plugin_cache.find(path);
+        if (it != plugin_cache.end() && it->second.file_size == file_size &&
+            it->second.modification_time == modification_time) {
+            *this = it->second.plugin;
+            is_cached = true;
+        }
+    }
+    if (!is_cached) {
+        const Loader::ResultStatus result = Read(path);
+        if (result != Loader::ResultStatus::Success) {
+            return result;
+        }
+        std::scoped_lock lock{plugin_cache_mutex};
+        plugin_cache.insert_or_assign(path, CachedPlugin{file_size, modification_time, *this});
+    }
+
+    LOG_INFO(Service_PLGLDR, "Trying to load plugin - Title: {} - Author: {}", title, author);
+
+    if (!compatible_TID.empty() &&
+        std::find(compatible_TID.begin(), compatible_TID.end(),
+                  static_cast<u32>(process.codeset->program_id)) == compatible_TID.end()) {
+        LOG_ERROR(Service_PLGLDR,
+                  "Failed to load 3GX plugin. Not compatible with loaded process: {}", path);
+        return Loader::ResultStatus::Error;
+    }
+
+    return Map(plg_context, process, kernel);
+}
+
+Loader::ResultStatus FileSys::Plugin3GXLoader::Read(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
     if (!file.IsOpen()) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not found: {}",
-                  plg_context.plugin_path);
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not found: {}", path);
         return Loader::ResultStatus::Error;
     }
 
     // Load CIA Header
     std::vector<u8> header_data(sizeof(_3gx_Header));
     if (file.ReadBytes(header_data.data(), sizeof(_3gx_Header)) != sizeof(_3gx_Header)) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}",
-                  plg_context.plugin_path);
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}", path);
         return Loader::ResultStatus::Error;
     }
 
@@ -85,13 +137,12 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
     // Check magic value
     if (std::memcmp(&header.magic, _3GX_magic, 8) != 0) {
         LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Outdated or invalid 3GX plugin: {}",
-                  plg_context.plugin_path);
+                  path);
         return Loader::ResultStatus::Error;
     }
 
     if (header.infos.flags.compatibility == static_cast<u32>(_3gx_Infos::Compatibility::CONSOLE)) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not compatible with Citra: {}",
-                  plg_context.plugin_path);
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. Not compatible with Citra: {}", path);
         return Loader::ResultStatus::Error;
     }
 
@@ -102,9 +153,8 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
         ReadTextInfo(file, header.infos.description_msg_offset, header.infos.description_len);
     summary = ReadTextInfo(file, header.infos.summary_msg_offset, header.infos.summary_len);
 
-    LOG_INFO(Service_PLGLDR, "Trying to load plugin - Title: {} - Author: {}", title, author);
-
     // Load compatible TIDs
+    compatible_TID.clear();
     {
         std::vector<u8> raw_TID_data;
         if (!ReadSection(raw_TID_data, file, header.targets.title_offsets,
@@ -117,24 +167,24 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
         }
     }
 
-    if (!compatible_TID.empty() &&
-        std::find(compatible_TID.begin(), compatible_TID.end(),
-                  static_cast<u32>(process.codeset->program_id)) == compatible_TID.end()) {
-        LOG_ERROR(Service_PLGLDR,
-                  "Failed to load 3GX plugin. Not compatible with loaded process: {}",
-                  plg_context.plugin_path);
-        return Loader::ResultStatus::Error;
-    }
-
     // Load exe load func and args
     if (header.infos.flags.embedded_exe_func.Value() &&
         header.executable.exe_load_func_offset != 0) {
         exe_load_func.clear();
+        // The function is at most 32 instructions long, read them at once
+        constexpr u64 max_func_size = 32 * sizeof(u32);
+        const u64 func_offset = header.executable.exe_load_func_offset;
+        const u64 file_size = file.GetSize();
+        const u64 func_size =
+            func_offset < file_size ? std::min(max_func_size, (file_size - func_offset) & ~u64{3})
+                                    : 0;
         std::vector<u8> out;
-        for (int i = 0; i < 32; i++) {
-            ReadSection(out, file, header.executable.exe_load_func_offset + i * sizeof(u32),
-                        sizeof(u32));
-            u32 instruction = *reinterpret_cast<u32_le*>(out.data());
+        if (!ReadSection(out, file, func_offset, func_size)) {
+            out.clear();
+        }
+        for (std::size_t i = 0; i < out.size() / sizeof(u32); i++) {
+            u32_le instruction;
+            std::memcpy(&instruction, out.data() + i * sizeof(u32), sizeof(u32));
             if (instruction == 0xE320F000) {
                 break;
             }
@@ -151,12 +201,11 @@ Loader::ResultStatus FileSys::Plugin3GXLoader::Load(
                      header.executable.rodata_size) ||
         !ReadSection(data_section, file, header.executable.data_offset,
                      header.executable.data_size)) {
-        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}",
-                  plg_context.plugin_path);
+        LOG_ERROR(Service_PLGLDR, "Failed to load 3GX plugin. File corrupted: {}", path);
         return Loader::ResultStatus::Error;
     }
 
-    return Map(plg_context, process, kernel);
+    return Loader::ResultStatus::Success;
 }
 
 Loader::ResultStatus FileSys::Plugin3GXLoader::Map(
@@ -66,6 +66,9 @@ public:
     static constexpr u32 _3GX_fb_size = 0xA9000;
 
 private:
+    /// Reads the header, the infos and the sections of the plugin file
+    Loader::ResultStatus Read(const std::string& path);
+
     Loader::ResultStatus Map(Service::PLGLDR::PLG_LDR::PluginLoaderContext& plg_context,
                              Kernel::Process& process, Kernel::KernelSystem& kernel);
 
@@ -1,25 +1,186 @@
 #include <algorithm>
+#include <cstring>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
+#include "common/thread.h"
 #include "core/file_sys/romfs_reader.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
 
 namespace FileSys {
 
+struct DirectRomFSReader::Cipher {
+    std::mutex mutex;
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption decryption;
+};
+
+DirectRomFSReader::DirectRomFSReader() = default;
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size)
+    : is_encrypted(false), file(std::move(file)), file_offset(file_offset), data_size(data_size) {
+    SetupData();
+}
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size, const std::array<u8, 16>& key,
+                                     const std::array<u8, 16>& ctr, std::size_t crypto_offset)
+    : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
+      crypto_offset(crypto_offset), data_size(data_size) {
+    SetupData();
+}
+
+DirectRomFSReader::~DirectRomFSReader() {
+    {
+        std::scoped_lock lock{cache_mutex};
+        stop_read_ahead = true;
+    }
+    cache_cv.notify_all();
+    if (read_ahead_thread.joinable()) {
+        read_ahead_thread.join();
+    }
+}
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
-    if (length == 0)
+    if (length == 0 || offset >= data_size)
         return 0; // Crypto++ does not like zero size buffer
-    file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
-    read_length = file.ReadBytes(buffer, read_length);
+    const std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
+    if (mapping) {
+        std::memcpy(buffer, mapping->Data() + offset, read_length);
+        return read_length;
+    }
+    if (read_length >= MAX_CACHED_READ) {
+        return ReadUncached(offset, read_length, buffer);
+    }
+
+    const std::size_t first_block = offset / BLOCK_SIZE;
+    const std::size_t last_block = (offset + read_length - 1) / BLOCK_SIZE;
+    std::size_t copied = 0;
+    for (std::size_t index = first_block; index <= last_block; ++index) {
+        const Block block = GetBlock(index);
+        const std::size_t block_offset = (offset + copied) - index * BLOCK_SIZE;
+        if (block->size() <= block_offset) {
+            break;
+        }
+        const std::size_t to_copy = std::min(read_length - copied, block->size() - block_offset);
+        std::memcpy(buffer + copied, block->data() + block_offset, to_copy);
+        copied += to_copy;
+    }
+
+    // Consecutive reads that stay within or advance by one block are considered sequential
+    bool sequential;
+    {
+        std::scoped_lock lock{cache_mutex};
+        sequential =
+            first_block == next_sequential_block || first_block + 1 == next_sequential_block;
+        next_sequential_block = last_block + 1;
+    }
+    if (sequential) {
+        for (std::size_t i = 0; i < READ_AHEAD_BLOCKS; ++i) {
+            RequestReadAhead(last_block + 1 + i);
+        }
+    }
+    return copied;
+}
+
+void DirectRomFSReader::SetupData() {
     if (is_encrypted) {
-        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-        d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
+        // Keying once lets Crypto++ pipeline AES-NI/ARMv8 blocks over whole cache blocks
+        cipher = std::make_unique<Cipher>();
+        cipher->decryption.SetKeyWithIV(key.data(), key.size(), ctr.data());
+        return;
+    }
+    if (!file.IsOpen()) {
+        return;
+    }
+    auto mapped = std::make_unique<Common::MappedFile>(file.GetFilename(), file_offset,
+                                                       static_cast<std::size_t>(data_size));
+    if (mapped->Data()) {
+        mapping = std::move(mapped);
+    }
+}
+
+std::size_t DirectRomFSReader::ReadUncached(std::size_t offset, std::size_t length, u8* buffer) {
+    std::size_t read_length;
+    {
+        std::scoped_lock lock{file_mutex};
+        file.Seek(file_offset + offset, SEEK_SET);
+        read_length = file.ReadBytes(buffer, length);
+    }
+    if (is_encrypted && read_length != 0) {
+        std::scoped_lock lock{cipher->mutex};
+        cipher->decryption.Seek(crypto_offset + offset);
+        cipher->decryption.ProcessData(buffer, buffer, read_length);
     }
     return read_length;
 }
 
+DirectRomFSReader::Block DirectRomFSReader::GetBlock(std::size_t index) {
+    std::unique_lock lock{cache_mutex};
+    cache_cv.wait(lock, [&] { return !loading_blocks.contains(index); });
+    if (const auto it = cached_blocks.find(index); it != cached_blocks.end()) {
+        lru_blocks.splice(lru_blocks.begin(), lru_blocks, it->second);
+        return it->second->second;
+    }
+    loading_blocks.insert(index);
+    lock.unlock();
+
+    const std::size_t offset = index * BLOCK_SIZE;
+    auto data = std::make_shared<std::vector<u8>>(
+        std::min(BLOCK_SIZE, static_cast<std::size_t>(data_size) - offset));
+    data->resize(ReadUncached(offset, data->size(), data->data()));
+
+    lock.lock();
+    loading_blocks.erase(index);
+    lru_blocks.emplace_front(index, data);
+    cached_blocks.emplace(index, lru_blocks.begin());
+    cached_size += data->size();
+    while (cached_size > CACHE_SIZE && lru_blocks.size() > 1) {
+        cached_size -= lru_blocks.back().second->size();
+        cached_blocks.erase(lru_blocks.back().first);
+        lru_blocks.pop_back();
+    }
+    lock.unlock();
+    cache_cv.notify_all();
+    return data;
+}
+
+void DirectRomFSReader::RequestReadAhead(std::size_t index) {
+    if (index * BLOCK_SIZE >= data_size) {
+        return;
+    }
+    {
+        std::scoped_lock lock{cache_mutex};
+        if (cached_blocks.contains(index) || loading_blocks.contains(index) ||
+            std::find(read_ahead_queue.begin(), read_ahead_queue.end(), index) !=
+                read_ahead_queue.end()) {
+            return;
+        }
+        read_ahead_queue.push_back(index);
+        if (!read_ahead_thread.joinable()) {
+            read_ahead_thread = std::thread(&DirectRomFSReader::ReadAheadLoop, this);
+        }
+    }
+    cache_cv.notify_all();
+}
+
+void DirectRomFSReader::ReadAheadLoop() {
+    Common::SetCurrentThreadName("RomFSReadAhead");
+
+    while (true) {
+        std::size_t index;
+        {
+            std::unique_lock lock{cache_mutex};
+            cache_cv.wait(lock, [this] { return stop_read_ahead || !read_ahead_queue.empty(); });
+            if (stop_read_ahead) {
+                break;
+            }
+            index = read_ahead_queue.front();
+            read_ahead_queue.pop_front();
+        }
+        GetBlock(index);
+    }
+}
+
 } // namespace FileSys
@@ -1,11 +1,21 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/mapped_file.h"
 
 namespace FileSys {
 
@@ -26,21 +36,20 @@ private:
 };
 
 /**
- * A RomFS reader that directly reads the RomFS file.
+ * A RomFS reader that directly reads the RomFS file. Unencrypted data is read from a memory
+ * mapping of the file when possible. Otherwise, data is read and decrypted in blocks which are
+ * kept in a LRU cache, and the blocks following sequential reads are loaded ahead of time on a
+ * background thread.
  */
 class DirectRomFSReader : public RomFSReader {
 public:
-    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size);
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
-                      std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+                      std::size_t crypto_offset);
 
-    ~DirectRomFSReader() override = default;
+    ~DirectRomFSReader() override;
 
     std::size_t GetSize() const override {
         return data_size;
@@ -49,6 +58,37 @@ public:
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
 
 private:
+    /// Size of the blocks read from the file and kept in the cache
+    static constexpr std::size_t BLOCK_SIZE = 128 * 1024;
+    /// Maximum size of the cached blocks
+    static constexpr std::size_t CACHE_SIZE = 8 * 1024 * 1024;
+    /// Reads of at least this size bypass the cache, so that they don't evict everything else
+    static constexpr std::size_t MAX_CACHED_READ = 4 * BLOCK_SIZE;
+    /// Number of blocks loaded ahead of a sequential read
+    static constexpr std::size_t READ_AHEAD_BLOCKS = 2;
+
+    using Block = std::shared_ptr<const std::vector<u8>>;
+
+    /// Keyed AES-CTR decryption, reused across reads by seeking to the offset of each read
+    struct Cipher;
+
+    /**
+     * Prepares the reads of the data. Unencrypted data is mapped so that it can be read without
+     * syscalls, while encrypted data gets its keyed cipher.
+     */
+    void SetupData();
+
+    /// Reads and decrypts a range of the RomFS from the file
+    std::size_t ReadUncached(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Returns the given block, loading it if it isn't cached
+    Block GetBlock(std::size_t index);
+
+    /// Queues the given block to be loaded by the read-ahead thread
+    void RequestReadAhead(std::size_t index);
+
+    void ReadAheadLoop();
+
     bool is_encrypted;
     FileUtil::IOFile file;
     std::array<u8, 16> key;
@@ -57,7 +97,26 @@ private:
     u64 crypto_offset;
     u64 data_size;
 
-    DirectRomFSReader() = default;
+    std::unique_ptr<Common::MappedFile> mapping;
+    std::unique_ptr<Cipher> cipher;
+
+    /// Protects the position of the file
+    std::mutex file_mutex;
+
+    /// Protects the cache and the read-ahead state
+    std::mutex cache_mutex;
+    std::condition_variable cache_cv;
+    std::list<std::pair<std::size_t, Block>> lru_blocks; ///< Most recently used first
+    std::unordered_map<std::size_t, decltype(lru_blocks)::iterator> cached_blocks;
+    std::unordered_set<std::size_t> loading_blocks;
+    std::size_t cached_size = 0;
+    std::size_t next_sequential_block = 0;
+
+    std::deque<std::size_t> read_ahead_queue;
+    std::thread read_ahead_thread;
+    bool stop_read_ahead = false;
+
+    DirectRomFSReader();
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -69,6 +128,9 @@ private:
         ar& file_offset;
         ar& crypto_offset;
         ar& data_size;
+        if (Archive::is_loading::value) {
+            SetupData();
+        }
     }
     friend class boost::serialization::access;
 };
@@ -40,6 +40,9 @@ public:
 
 ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& path,
                                                                   const Mode& mode) const {
+    if (mode.create_flag) {
+        InvalidateDiskDirectories();
+    }
     LOG_DEBUG(Service_FS, "called path={} mode={:01X}", path.DebugStr(), mode.hex);
 
     const PathParser path_parser(path);
@@ -98,6 +101,7 @@ ResultVal<std::unique_ptr<FileBackend>> SaveDataArchive::OpenFile(const Path& pa
 }
 
 ResultCode SaveDataArchive::DeleteFile(const Path& path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -132,6 +136,7 @@ ResultCode SaveDataArchive::DeleteFile(const Path& path) const {
 }
 
 ResultCode SaveDataArchive::RenameFile(const Path& src_path, const Path& dest_path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser_src(src_path);
 
     // TODO: Verify these return codes with HW
@@ -163,6 +168,7 @@ ResultCode SaveDataArchive::RenameFile(const Path& src_path, const Path& dest_pa
 template <typename T>
 static ResultCode DeleteDirectoryHelper(const Path& path, const std::string& mount_point,
                                         T deleter) {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -209,6 +215,7 @@ ResultCode SaveDataArchive::DeleteDirectoryRecursively(const Path& path) const {
 }
 
 ResultCode SaveDataArchive::CreateFile(const FileSys::Path& path, u64 size) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -254,6 +261,7 @@ ResultCode SaveDataArchive::CreateFile(const FileSys::Path& path, u64 size) cons
 }
 
 ResultCode SaveDataArchive::CreateDirectory(const Path& path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser(path);
 
     if (!path_parser.IsValid()) {
@@ -291,6 +299,7 @@ ResultCode SaveDataArchive::CreateDirectory(const Path& path) const {
 }
 
 ResultCode SaveDataArchive::RenameDirectory(const Path& src_path, const Path& dest_path) const {
+    InvalidateDiskDirectories();
     const PathParser path_parser_src(src_path);
 
     // TODO: Verify these return codes with HW
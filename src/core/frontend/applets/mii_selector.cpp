@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include <future>
+#include <mutex>
 #include "common/file_util.h"
 #include "common/string_util.h"
 #include "core/file_sys/archive_extsavedata.h"
@@ -15,7 +18,9 @@ void MiiSelector::Finalize(u32 return_code, HLE::Applets::MiiData mii) {
     data = {return_code, mii};
 }
 
-std::vector<HLE::Applets::MiiData> LoadMiis() {
+namespace {
+
+std::vector<HLE::Applets::MiiData> ReadMiis() {
     std::vector<HLE::Applets::MiiData> miis;
 
     std::string nand_directory{FileUtil::GetUserPath(FileUtil::UserPath::NANDDir)};
@@ -33,17 +38,20 @@ std::vector<HLE::Applets::MiiData> LoadMiis() {
         if (file_result.Succeeded()) {
             auto file = std::move(file_result).Unwrap();
 
-            u32 saved_miis_offset = 0x8;
+            constexpr u32 saved_miis_offset = 0x8;
             // The Mii Maker has a 100 Mii limit on the 3ds
-            for (int i = 0; i < 100; ++i) {
+            constexpr std::size_t max_miis = 100;
+            std::vector<u8> miis_raw(max_miis * sizeof(HLE::Applets::MiiData));
+            const auto read_result =
+                file->Read(saved_miis_offset, miis_raw.size(), miis_raw.data());
+            const std::size_t read_miis =
+                read_result.Succeeded() ? *read_result / sizeof(HLE::Applets::MiiData) : 0;
+            for (std::size_t i = 0; i < read_miis; ++i) {
                 HLE::Applets::MiiData mii;
-                std::array<u8, sizeof(mii)> mii_raw;
-                file->Read(saved_miis_offset, sizeof(mii), mii_raw.data());
-                std::memcpy(&mii, mii_raw.data(), sizeof(mii));
+                std::memcpy(&mii, miis_raw.data() + i * sizeof(mii), sizeof(mii));
                 if (mii.mii_id != 0) {
                     miis.push_back(mii);
                 }
-                saved_miis_offset += sizeof(mii);
             }
         }
     }
@@ -51,6 +59,27 @@ std::vector<HLE::Applets::MiiData> LoadMiis() {
     return miis;
 }
 
+std::mutex prefetch_mutex;
+std::future<std::vector<HLE::Applets::MiiData>> prefetched_miis;
+
+} // Anonymous namespace
+
+void PrefetchMiis() {
+    std::scoped_lock lock{prefetch_mutex};
+    // Miis prefetched for a frontend that never listed them may be outdated by now
+    prefetched_miis = std::async(std::launch::async, ReadMiis);
+}
+
+std::vector<HLE::Applets::MiiData> LoadMiis() {
+    {
+        std::scoped_lock lock{prefetch_mutex};
+        if (prefetched_miis.valid()) {
+            return prefetched_miis.get();
+        }
+    }
+    return ReadMiis();
+}
+
 void DefaultMiiSelector::Setup(const Frontend::MiiSelectorConfig& config) {
     MiiSelector::Setup(config);
     Finalize(0, HLE::Applets::MiiSelector::GetStandardMiiResult().selected_mii_data);
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/serialization/version.hpp>
 #include "core/hle/applets/mii_selector.h"
 
@@ -50,6 +51,13 @@ protected:
     MiiSelectorData data;
 };
 
+/**
+ * Starts reading the Miis of the Mii Maker on a background thread, so that the next LoadMiis
+ * doesn't wait for the storage.
+ */
+void PrefetchMiis();
+
+/// Returns the Miis of the Mii Maker, either prefetched by PrefetchMiis or read right away
 std::vector<HLE::Applets::MiiData> LoadMiis();
 
 class DefaultMiiSelector final : public MiiSelector {
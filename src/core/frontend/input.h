@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -99,7 +100,37 @@ std::unique_ptr<InputDeviceType> CreateDevice(const std::string& params) {
  * A button device is an input device that returns bool as status.
  * true for pressed; false for released.
  */
-using ButtonDevice = InputDevice<bool>;
+class ButtonDevice : public InputDevice<bool> {
+public:
+    /**
+     * Returns the flag holding the status if GetStatus only loads it, so that the button can be
+     * polled without calling it. The flag lives as long as the device.
+     */
+    virtual const std::atomic<bool>* GetStatusFlag() const {
+        return nullptr;
+    }
+};
+
+/**
+ * Polls a button as cheaply as it allows: buttons backed by a flag are read directly, the others
+ * are called. Composite devices and the HID service build these once, when creating the devices,
+ * so that polling them doesn't go through a virtual call per button. The button has to outlive
+ * the reader.
+ */
+class ButtonReader {
+public:
+    ButtonReader() = default;
+    explicit ButtonReader(const ButtonDevice& device_)
+        : device{&device_}, flag{device_.GetStatusFlag()} {}
+
+    bool GetStatus() const {
+        return flag != nullptr ? flag->load(std::memory_order_relaxed) : device->GetStatus();
+    }
+
+private:
+    const ButtonDevice* device = nullptr;
+    const std::atomic<bool>* flag = nullptr;
+};
 
 /**
  * An analog device is an input device that returns a tuple of x and y coordinates as status. The
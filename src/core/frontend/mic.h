@@ -4,10 +4,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 #include "common/swap.h"
-#include "common/threadsafe_queue.h"
 
 namespace Frontend::Mic {
 
@@ -18,8 +18,6 @@ enum class Signedness : u8 {
     Unsigned,
 };
 
-using Samples = std::vector<u8>;
-
 struct Parameters {
     Signedness sign;
     u8 sample_size;
@@ -43,10 +41,15 @@ public:
 
     /**
      * Called from the actual event timing at a constant period under a given sample rate.
-     * When sampling is enabled this function is expected to return a buffer of 16 samples in ideal
-     * conditions, but can be lax if the data is coming in from another source like a real mic.
+     * Copies the samples captured since the last call into the buffer, already in the sample
+     * format given by the Parameters. When sampling is enabled this is expected to be 16 samples
+     * in ideal conditions, but can be lax if the data is coming in from another source like a
+     * real mic.
+     * @param buffer Where to write the samples, typically the guest shared memory
+     * @param max_size Maximum number of bytes to write, a multiple of the sample size
+     * @returns The number of bytes written
      */
-    virtual Samples Read() = 0;
+    virtual std::size_t Read(u8* buffer, std::size_t max_size) = 0;
 
     /**
      * Adjusts the Parameters. Implementations should update the parameters field in addition to
@@ -94,7 +97,7 @@ public:
 
     void AdjustSampleRate(u32 sample_rate) override;
 
-    Samples Read() override;
+    std::size_t Read(u8* buffer, std::size_t max_size) override;
 };
 
 class StaticMic final : public Interface {
@@ -106,7 +109,7 @@ public:
     void StopSampling() override;
     void AdjustSampleRate(u32 sample_rate) override;
 
-    Samples Read() override;
+    std::size_t Read(u8* buffer, std::size_t max_size) override;
 
 private:
     u16 sample_rate = 0;
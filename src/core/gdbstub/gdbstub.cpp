@@ -13,6 +13,8 @@
 #include <cstring>
 #include <map>
 #include <numeric>
+#include <thread>
+#include <vector>
 #include <fcntl.h>
 #include <fmt/format.h>
 
@@ -32,6 +34,7 @@
 #endif
 
 #include "common/logging/log.h"
+#include "common/threadsafe_queue.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -123,6 +126,13 @@ constexpr char target_xml[] =
 int gdbserver_socket = -1;
 bool defer_start = false;
 
+/// Receives from the client while the emulation runs, so that the CPU loop only has to check the
+/// queue. An empty chunk means that the client disconnected.
+std::thread receive_thread;
+Common::SPSCQueue<std::vector<u8>> receive_queue;
+std::vector<u8> receive_chunk;
+std::size_t receive_offset = 0;
+
 u8 command_buffer[GDB_BUFFER_SIZE];
 u32 command_length;
 
@@ -284,10 +294,17 @@ static u32 HexToInt(const u8* src, std::size_t len) {
  * @param len Length of src array.
  */
 static void MemToGdbHex(u8* dest, const u8* src, std::size_t len) {
-    while (len-- > 0) {
-        u8 tmp = *src++;
-        *dest++ = NibbleToHex(tmp >> 4);
-        *dest++ = NibbleToHex(tmp);
+    static constexpr auto hex_table = [] {
+        constexpr char digits[] = "0123456789abcdef";
+        std::array<std::array<u8, 2>, 256> table{};
+        for (std::size_t i = 0; i < table.size(); i++) {
+            table[i] = {static_cast<u8>(digits[i >> 4]), static_cast<u8>(digits[i & 0xF])};
+        }
+        return table;
+    }();
+
+    for (std::size_t i = 0; i < len; i++) {
+        std::memcpy(dest + i * 2, hex_table[src[i]].data(), 2);
     }
 }
 
@@ -363,16 +380,38 @@ static u64 GdbHexToLong(const u8* src) {
     return output;
 }
 
-/// Read a byte from the gdb client.
-static u8 ReadByte() {
-    u8 c;
-    std::size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
-    if (received_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
-        Shutdown();
+/// Receives the data sent by the gdb client until it disconnects.
+static void ReceiveLoop(int socket) {
+    std::vector<u8> buffer(GDB_BUFFER_SIZE);
+    while (true) {
+        const int received_size =
+            recv(socket, reinterpret_cast<char*>(buffer.data()), GDB_BUFFER_SIZE, 0);
+        if (received_size <= 0) {
+            if (received_size < 0) {
+                LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
+            }
+            receive_queue.Push(std::vector<u8>{});
+            return;
+        }
+        receive_queue.Push(std::vector<u8>(buffer.begin(), buffer.begin() + received_size));
     }
+}
 
-    return c;
+/// Read a byte from the gdb client, returns GDB_STUB_END once it is disconnected.
+static u8 ReadByte() {
+    if (!IsConnected()) {
+        return GDB_STUB_END;
+    }
+    if (receive_offset == receive_chunk.size()) {
+        receive_chunk = receive_queue.PopWait();
+        receive_offset = 0;
+        if (receive_chunk.empty()) {
+            LOG_INFO(Debug_GDBStub, "Client disconnected");
+            Shutdown();
+            return GDB_STUB_END;
+        }
+    }
+    return receive_chunk[receive_offset++];
 }
 
 /// Calculate the checksum of the current command buffer.
@@ -497,14 +536,14 @@ static void SendPacket(const char packet) {
  *
  * @param reply Reply to be sent to client.
  */
-static void SendReply(const char* reply) {
+static void SendReply(const char* reply, std::size_t length) {
     if (!IsConnected()) {
         return;
     }
 
     memset(command_buffer, 0, sizeof(command_buffer));
 
-    command_length = static_cast<u32>(strlen(reply));
+    command_length = static_cast<u32>(length);
     if (command_length + 4 > sizeof(command_buffer)) {
         LOG_ERROR(Debug_GDBStub, "command_buffer overflow in SendReply");
         return;
@@ -532,6 +571,10 @@ static void SendReply(const char* reply) {
     }
 }
 
+static void SendReply(const char* reply) {
+    SendReply(reply, strlen(reply));
+}
+
 /// Handle query command from gdb client.
 static void HandleQuery() {
     const char* query = reinterpret_cast<const char*>(command_buffer + 1);
@@ -674,6 +717,10 @@ static void ReadCommand() {
         }
         command_buffer[command_length++] = c;
     }
+    if (!IsConnected()) {
+        command_length = 0;
+        return;
+    }
 
     u8 checksum_received = HexCharToValue(ReadByte()) << 4;
     checksum_received |= HexCharToValue(ReadByte());
@@ -701,22 +748,7 @@ static bool IsDataAvailable() {
     if (!IsConnected()) {
         return false;
     }
-
-    fd_set fd_socket;
-
-    FD_ZERO(&fd_socket);
-    FD_SET(static_cast<u32>(gdbserver_socket), &fd_socket);
-
-    struct timeval t;
-    t.tv_sec = 0;
-    t.tv_usec = 0;
-
-    if (select(gdbserver_socket + 1, &fd_socket, nullptr, nullptr, &t) < 0) {
-        LOG_ERROR(Debug_GDBStub, "select failed");
-        return false;
-    }
-
-    return FD_ISSET(gdbserver_socket, &fd_socket) != 0;
+    return receive_offset < receive_chunk.size() || !receive_queue.Empty();
 }
 
 /// Send requested register to gdb client.
@@ -831,10 +863,8 @@ static void WriteRegisters() {
     SendReply("OK");
 }
 
-/// Read location in memory specified by gdb client.
-static void ReadMemory() {
-    static u8 reply[GDB_BUFFER_SIZE - 4];
-
+/// Parses the address and length of a memory read command.
+static std::pair<VAddr, u32> ParseMemoryRead() {
     auto start_offset = command_buffer + 1;
     auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
     VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
@@ -844,9 +874,16 @@ static void ReadMemory() {
         HexToInt(start_offset, static_cast<u32>((command_buffer + command_length) - start_offset));
 
     LOG_DEBUG(Debug_GDBStub, "gdb: addr: {:08x} len: {:08x}\n", addr, len);
+    return {addr, len};
+}
 
-    if (len * 2 > sizeof(reply)) {
-        SendReply("E01");
+/// Read location in memory specified by gdb client.
+static void ReadMemory() {
+    static u8 reply[GDB_BUFFER_SIZE - 4];
+
+    const auto [addr, len] = ParseMemoryRead();
+    if (len * 2 >= sizeof(reply)) {
+        return SendReply("E01");
     }
 
     auto& memory = Core::System::GetInstance().Memory();
@@ -863,6 +900,36 @@ static void ReadMemory() {
     SendReply(reinterpret_cast<char*>(reply));
 }
 
+/// Read location in memory specified by gdb client, replying with binary data.
+static void ReadMemoryBinary() {
+    static u8 reply[GDB_BUFFER_SIZE - 4];
+
+    auto [addr, len] = ParseMemoryRead();
+    // The reply may be shorter than requested, so read what fits even if every byte is escaped
+    len = std::min<u32>(len, (sizeof(reply) - 1) / 2);
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                                      addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data(len);
+    memory.ReadBlock(addr, data.data(), len);
+
+    std::size_t reply_length = 0;
+    reply[reply_length++] = 'b';
+    for (const u8 byte : data) {
+        if (byte == '#' || byte == '$' || byte == '}' || byte == '*') {
+            reply[reply_length++] = '}';
+            reply[reply_length++] = static_cast<u8>(byte ^ 0x20);
+        } else {
+            reply[reply_length++] = byte;
+        }
+    }
+    SendReply(reinterpret_cast<char*>(reply), reply_length);
+}
+
 /// Modify location in memory with data received from the gdb client.
 static void WriteMemory() {
     auto start_offset = command_buffer + 1;
@@ -1090,6 +1157,9 @@ void HandlePacket() {
     case 'm':
         ReadMemory();
         break;
+    case 'x':
+        ReadMemoryBinary();
+        break;
     case 'M':
         WriteMemory();
         break;
@@ -1208,6 +1278,7 @@ static void Init(u16 port) {
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.\n");
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
+        receive_thread = std::thread(ReceiveLoop, gdbserver_socket);
     }
 
     // Clean up temporary socket if it's still alive at this point.
@@ -1231,6 +1302,13 @@ void Shutdown() {
         shutdown(gdbserver_socket, SHUT_RDWR);
         gdbserver_socket = -1;
     }
+    // The receive thread stops once the socket is shut down
+    if (receive_thread.joinable()) {
+        receive_thread.join();
+    }
+    receive_queue.Clear();
+    receive_chunk.clear();
+    receive_offset = 0;
 
 #ifdef _WIN32
     WSACleanup();
@@ -1247,6 +1325,10 @@ bool IsConnected() {
     return IsServerEnabled() && gdbserver_socket != -1;
 }
 
+bool HasPendingPacket() {
+    return !IsConnected() || IsDataAvailable();
+}
+
 bool GetCpuHaltFlag() {
     return halt_loop;
 }
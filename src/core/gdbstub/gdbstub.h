@@ -68,6 +68,9 @@ void Break(bool is_memory_break = false);
 /// Determine if there was a memory breakpoint.
 bool IsMemoryBreak();
 
+/// Returns true if HandlePacket has something to do, which doesn't need to wait on the client.
+bool HasPendingPacket();
+
 /// Read and handle packet from gdb client.
 void HandlePacket();
 
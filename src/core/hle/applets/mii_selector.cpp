@@ -27,6 +27,9 @@ ResultCode MiiSelector::ReceiveParameter(const Service::APT::MessageParameter& p
         return ResultCode(-1);
     }
 
+    // The frontend lists the Miis when the applet is started, read them in the meantime
+    Frontend::PrefetchMiis();
+
     // The LibAppJustStarted message contains a buffer with the size of the framebuffer shared
     // memory.
     // Create the SharedMemory that will hold the framebuffer data
@@ -21,52 +21,81 @@ namespace Kernel {
 void AddressArbiter::WaitThread(std::shared_ptr<Thread> thread, VAddr wait_address) {
     thread->wait_address = wait_address;
     thread->status = ThreadStatus::WaitArb;
-    waiting_threads.emplace_back(std::move(thread));
+    waiting_threads[wait_address].emplace_back(std::move(thread));
 }
 
 void AddressArbiter::ResumeAllThreads(VAddr address) {
-    // Determine which threads are waiting on this address, those should be woken up.
-    auto itr = std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                     [address](const auto& thread) {
-                                         ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                    "Inconsistent AddressArbiter state");
-                                         return thread->wait_address != address;
-                                     });
-
-    // Wake up all the found threads
-    std::for_each(itr, waiting_threads.end(), [](auto& thread) { thread->ResumeFromWait(); });
-
-    // Remove the woken up threads from the wait list.
-    waiting_threads.erase(itr, waiting_threads.end());
+    const auto bucket = waiting_threads.find(address);
+    if (bucket == waiting_threads.end()) {
+        return;
+    }
+
+    // Take the list out first, resuming a thread doesn't touch it but keeps this robust
+    const auto threads = std::move(bucket->second);
+    waiting_threads.erase(bucket);
+
+    for (const auto& thread : threads) {
+        ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        thread->ResumeFromWait();
+    }
 }
 
 std::shared_ptr<Thread> AddressArbiter::ResumeHighestPriorityThread(VAddr address) {
-    // Determine which threads are waiting on this address, those should be considered for wakeup.
-    auto matches_start = std::stable_partition(
-        waiting_threads.begin(), waiting_threads.end(), [address](const auto& thread) {
-            ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                       "Inconsistent AddressArbiter state");
-            return thread->wait_address != address;
-        });
+    const auto bucket = waiting_threads.find(address);
+    if (bucket == waiting_threads.end()) {
+        return nullptr;
+    }
+    auto& threads = bucket->second;
 
     // Iterate through threads, find highest priority thread that is waiting to be arbitrated.
     // Note: The real kernel will pick the first thread in the list if more than one have the
     // same highest priority value. Lower priority values mean higher priority.
-    auto itr = std::min_element(matches_start, waiting_threads.end(),
+    auto itr = std::min_element(threads.begin(), threads.end(),
                                 [](const auto& lhs, const auto& rhs) {
                                     return lhs->current_priority < rhs->current_priority;
                                 });
+    ASSERT_MSG((*itr)->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
 
-    if (itr == waiting_threads.end())
-        return nullptr;
+    auto thread = std::move(*itr);
+    threads.erase(itr);
+    if (threads.empty()) {
+        waiting_threads.erase(bucket);
+    }
 
-    auto thread = *itr;
     thread->ResumeFromWait();
-
-    waiting_threads.erase(itr);
     return thread;
 }
 
+void AddressArbiter::RemoveWaitingThread(const Thread* thread) {
+    const auto bucket = waiting_threads.find(thread->wait_address);
+    if (bucket == waiting_threads.end()) {
+        return;
+    }
+    auto& threads = bucket->second;
+    threads.erase(std::remove_if(threads.begin(), threads.end(),
+                                 [thread](const auto& t) { return t.get() == thread; }),
+                  threads.end());
+    if (threads.empty()) {
+        waiting_threads.erase(bucket);
+    }
+}
+
+std::vector<std::shared_ptr<Thread>> AddressArbiter::GetWaitingThreads() const {
+    std::vector<std::shared_ptr<Thread>> threads{loaded_threads};
+    for (const auto& [address, bucket] : waiting_threads) {
+        threads.insert(threads.end(), bucket.begin(), bucket.end());
+    }
+    return threads;
+}
+
+void AddressArbiter::IndexLoadedThreads() {
+    for (auto& thread : loaded_threads) {
+        const VAddr address = thread->wait_address;
+        waiting_threads[address].push_back(std::move(thread));
+    }
+    loaded_threads.clear();
+}
+
 AddressArbiter::AddressArbiter(KernelSystem& kernel)
     : Object(kernel), kernel(kernel), timeout_callback(std::make_shared<Callback>(*this)) {}
 AddressArbiter::~AddressArbiter() {}
@@ -100,13 +129,15 @@ private:
 void AddressArbiter::WakeUp(ThreadWakeupReason reason, std::shared_ptr<Thread> thread,
                             std::shared_ptr<WaitObject> object) {
     ASSERT(reason == ThreadWakeupReason::Timeout);
+    IndexLoadedThreads();
     // Remove the newly-awakened thread from the Arbiter's waiting list.
-    waiting_threads.erase(std::remove(waiting_threads.begin(), waiting_threads.end(), thread),
-                          waiting_threads.end());
+    RemoveWaitingThread(thread.get());
 };
 
 ResultCode AddressArbiter::ArbitrateAddress(std::shared_ptr<Thread> thread, ArbitrationType type,
                                             VAddr address, s32 value, u64 nanoseconds) {
+    IndexLoadedThreads();
+
     switch (type) {
 
     // Signal thread(s) waiting for arbitrate address...
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
@@ -74,8 +75,22 @@ private:
     /// the resumed thread.
     std::shared_ptr<Thread> ResumeHighestPriorityThread(VAddr address);
 
-    /// Threads waiting for the address arbiter to be signaled.
-    std::vector<std::shared_ptr<Thread>> waiting_threads;
+    /// Removes a thread from the threads waiting on its wait address
+    void RemoveWaitingThread(const Thread* thread);
+
+    /// Flattens the waiting threads in the layout used by save states
+    std::vector<std::shared_ptr<Thread>> GetWaitingThreads() const;
+
+    /// Indexes the waiting threads restored from a save state
+    void IndexLoadedThreads();
+
+    /// Threads waiting for the address arbiter to be signaled, indexed by the address they wait
+    /// on. Each list is in the order the threads started waiting.
+    std::unordered_map<VAddr, std::vector<std::shared_ptr<Thread>>> waiting_threads;
+
+    /// Waiting threads restored from a save state. They are only indexed on first use, because
+    /// they may still be partially loaded when the arbiter is, without their wait address.
+    std::vector<std::shared_ptr<Thread>> loaded_threads;
 
     std::shared_ptr<Callback> timeout_callback;
 
@@ -101,7 +116,13 @@ private:
             ar& boost::serialization::base_object<WakeupCallback>(x);
         }
         ar& name;
-        ar& waiting_threads;
+        if (Archive::is_saving::value) {
+            auto threads = GetWaitingThreads();
+            ar& threads;
+        } else {
+            waiting_threads.clear();
+            ar& loaded_threads;
+        }
         if (file_version > 1) {
             ar& timeout_callback;
         }
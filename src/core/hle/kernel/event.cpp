@@ -19,7 +19,7 @@ Event::Event(KernelSystem& kernel) : WaitObject(kernel) {}
 Event::~Event() {}
 
 std::shared_ptr<Event> KernelSystem::CreateEvent(ResetType reset_type, std::string name) {
-    auto evt{std::make_shared<Event>(*this)};
+    auto evt{MakePooledObject<Event>(*this)};
 
     evt->signaled = false;
     evt->reset_type = reset_type;
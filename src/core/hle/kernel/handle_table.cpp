@@ -94,6 +94,19 @@ std::shared_ptr<Object> HandleTable::GetGeneric(Handle handle) const {
     return objects[GetSlot(handle)];
 }
 
+Object* HandleTable::BorrowGeneric(Handle handle) const {
+    if (handle == CurrentThread) {
+        return kernel.GetCurrentThreadManager().GetCurrentThread();
+    } else if (handle == CurrentProcess) {
+        return kernel.GetCurrentProcess().get();
+    }
+
+    if (!IsValid(handle)) {
+        return nullptr;
+    }
+    return objects[GetSlot(handle)].get();
+}
+
 void HandleTable::Clear() {
     for (u16 i = 0; i < MAX_COUNT; ++i) {
         generations[i] = i + 1;
@@ -89,6 +89,27 @@ public:
         return DynamicObjectCast<T>(GetGeneric(handle));
     }
 
+    /**
+     * Looks up a handle without taking a reference to the object. The pointer is only valid while
+     * the handle stays open, e.g. during an SVC that doesn't close or wait on the handle.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid.
+     */
+    Object* BorrowGeneric(Handle handle) const;
+
+    /**
+     * Looks up a handle while verifying its type, without taking a reference to the object.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid or its
+     *         type differs from the requested one.
+     */
+    template <class T>
+    T* Borrow(Handle handle) const {
+        Object* object = BorrowGeneric(handle);
+        if (object != nullptr && object->GetHandleType() == T::HANDLE_TYPE) {
+            return static_cast<T*>(object);
+        }
+        return nullptr;
+    }
+
     /// Closes all handles held in this table.
     void Clear();
 
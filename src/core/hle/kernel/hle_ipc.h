@@ -8,6 +8,7 @@
 #include <array>
 #include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -132,6 +133,9 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+    /// Returns a direct view of part of the buffer, or an empty span if it can't be viewed
+    /// directly. See Memory::MemorySystem::GetContiguousSpan.
+    std::span<u8> GetSpan(std::size_t offset, std::size_t size);
     std::size_t GetSize() const {
         return size;
     }
@@ -224,7 +224,7 @@ public:
     /// Retrieves a process from the current list of processes.
     std::shared_ptr<Process> GetProcessById(u32 process_id) const;
 
-    std::shared_ptr<Process> GetCurrentProcess() const;
+    const std::shared_ptr<Process>& GetCurrentProcess() const;
     void SetCurrentProcess(std::shared_ptr<Process> process);
     void SetCurrentProcessForCPU(std::shared_ptr<Process> process, u32 core_id);
 
@@ -31,7 +31,7 @@ Mutex::Mutex(KernelSystem& kernel) : WaitObject(kernel), kernel(kernel) {}
 Mutex::~Mutex() {}
 
 std::shared_ptr<Mutex> KernelSystem::CreateMutex(bool initial_locked, std::string name) {
-    auto mutex{std::make_shared<Mutex>(*this)};
+    auto mutex{MakePooledObject<Mutex>(*this)};
 
     mutex->lock_count = 0;
     mutex->name = std::move(name);
@@ -7,10 +7,12 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <utility>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/assume_abstract.hpp>
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
+#include "common/object_pool.h"
 #include "common/serialization/atomic.h"
 #include "core/global.h"
 #include "core/hle/kernel/kernel.h"
@@ -85,6 +87,16 @@ std::shared_ptr<T> SharedFrom(T* raw) {
     return std::static_pointer_cast<T>(raw->shared_from_this());
 }
 
+/**
+ * Creates an object of a type that's created and destroyed often, e.g. sessions and events, in
+ * the pool of the type rather than on the heap. Objects loaded from a savestate are constructed
+ * by the serialization on the heap, both are freed the same way by their shared_ptr.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> MakePooledObject(Args&&... args) {
+    return std::allocate_shared<T>(Common::PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+
 /**
  * Attempts to downcast the given Object pointer to a pointer to T.
  * @return Derived pointer to the object, or `nullptr` if `object` isn't of type T.
@@ -92,7 +104,7 @@ std::shared_ptr<T> SharedFrom(T* raw) {
 template <typename T>
 inline std::shared_ptr<T> DynamicObjectCast(std::shared_ptr<Object> object) {
     if (object != nullptr && object->GetHandleType() == T::HANDLE_TYPE) {
-        return std::static_pointer_cast<T>(object);
+        return std::static_pointer_cast<T>(std::move(object));
     }
     return nullptr;
 }
@@ -251,8 +251,7 @@ ResultVal<VAddr> Process::HeapAllocate(VAddr target, u32 size, VMAPermission per
         u32 interval_size = interval.upper() - interval.lower();
         LOG_DEBUG(Kernel, "Allocated FCRAM region lower={:08X}, upper={:08X}", interval.lower(),
                   interval.upper());
-        std::fill(kernel.memory.GetFCRAMPointer(interval.lower()),
-                  kernel.memory.GetFCRAMPointer(interval.upper()), 0);
+        kernel.memory.ZeroFCRAM(interval.lower(), interval_size);
         auto vma = vm_manager.MapBackingMemory(interval_target,
                                                kernel.memory.GetFCRAMRef(interval.lower()),
                                                interval_size, memory_state);
@@ -328,7 +327,7 @@ ResultVal<VAddr> Process::LinearAllocate(VAddr target, u32 size, VMAPermission p
 
     auto backing_memory = kernel.memory.GetFCRAMRef(physical_offset);
 
-    std::fill(backing_memory.GetPtr(), backing_memory.GetPtr() + size, 0);
+    kernel.memory.ZeroFCRAM(physical_offset, size);
     auto vma = vm_manager.MapBackingMemory(target, backing_memory, size, MemoryState::Continuous);
     ASSERT(vma.Succeeded());
     vm_manager.Reprotect(vma.Unwrap(), perms);
@@ -36,6 +36,9 @@ static std::chrono::seconds GetInitTime() {
         // Override the clock init time with the one in the movie
         return std::chrono::seconds(override_init_time);
     }
+    if (Settings::values.use_virtual_time) {
+        return std::chrono::seconds(Settings::values.init_time.GetValue());
+    }
 
     switch (Settings::values.init_clock.GetValue()) {
     case Settings::InitClock::SystemTime: {
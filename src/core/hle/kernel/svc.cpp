@@ -10,6 +10,7 @@
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
+#include "common/settings.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -336,12 +337,34 @@ class SVC : public SVCWrapper<SVC> {
 public:
     SVC(Core::System& system);
     void CallSVC(u32 immediate);
+    bool CallFastSVC(ARM_Interface& core, u32 immediate);
 
 private:
     Core::System& system;
     Kernel::KernelSystem& kernel;
     Memory::MemorySystem& memory;
 
+    /// Ticks spent by a call to GetSystemTick
+    static constexpr u64 GET_SYSTEM_TICK_TICKS = 150;
+
+    /// Maximum number of ticks between two polls of a thread for them to be part of a spin loop
+    static constexpr u64 MAX_POLL_INTERVAL = 2000;
+    /// Number of consecutive tight polls after which a thread is considered to be spinning
+    static constexpr u32 MIN_SPIN_POLLS = 32;
+
+    // Spin loop detection state of the core running this SVC context
+    const Thread* poll_thread = nullptr;
+    u64 last_poll_ticks = 0;
+    u32 poll_count = 0;
+    bool polled = false;
+
+    /**
+     * Called by the SVCs that let a thread check for a condition without blocking. When a thread
+     * keeps polling in a tight loop, only an event or another core can change the outcome, so the
+     * rest of the slice of the core is skipped instead of being spent in the loop.
+     */
+    void OnPoll();
+
     friend class SVCWrapper<SVC>;
 
     // ARM interfaces
@@ -427,6 +450,11 @@ private:
 
     static const std::array<FunctionDef, 180> SVC_Table;
     static const FunctionDef* GetSVCInfo(u32 func_num);
+
+#if MICROPROFILE_ENABLED
+    /// Returns the profiler token of a SVC, so that each SVC is timed separately
+    static MicroProfileToken GetProfileToken(u32 func_num);
+#endif
 };
 
 /// Map application or GSP heap memory
@@ -731,8 +759,10 @@ ResultCode SVC::WaitSynchronization1(Handle handle, s64 nano_seconds) {
 
     if (object->ShouldWait(thread)) {
 
-        if (nano_seconds == 0)
+        if (nano_seconds == 0) {
+            OnPoll();
             return RESULT_TIMEOUT;
+        }
 
         thread->wait_objects = {object};
         object->AddWaitingThread(SharedFrom(thread));
@@ -800,8 +830,10 @@ ResultCode SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle
 
         // If a timeout value of 0 was provided, just return the Timeout error code instead of
         // suspending the thread.
-        if (nano_seconds == 0)
+        if (nano_seconds == 0) {
+            OnPoll();
             return RESULT_TIMEOUT;
+        }
 
         // Put the thread to sleep
         thread->status = ThreadStatus::WaitSynchAll;
@@ -843,8 +875,10 @@ ResultCode SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle
 
         // If a timeout value of 0 was provided, just return the Timeout error code instead of
         // suspending the thread.
-        if (nano_seconds == 0)
+        if (nano_seconds == 0) {
+            OnPoll();
             return RESULT_TIMEOUT;
+        }
 
         // Put the thread to sleep
         thread->status = ThreadStatus::WaitSynchAny;
@@ -1204,8 +1238,7 @@ void SVC::ExitThread() {
 
 /// Gets the priority for the specified thread
 ResultCode SVC::GetThreadPriority(u32* priority, Handle handle) {
-    const std::shared_ptr<Thread> thread =
-        kernel.GetCurrentProcess()->handle_table.Get<Thread>(handle);
+    const Thread* thread = kernel.GetCurrentProcess()->handle_table.Borrow<Thread>(handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1219,7 +1252,7 @@ ResultCode SVC::SetThreadPriority(Handle handle, u32 priority) {
         return ERR_OUT_OF_RANGE;
     }
 
-    std::shared_ptr<Thread> thread = kernel.GetCurrentProcess()->handle_table.Get<Thread>(handle);
+    Thread* thread = kernel.GetCurrentProcess()->handle_table.Borrow<Thread>(handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1257,7 +1290,7 @@ ResultCode SVC::CreateMutex(Handle* out_handle, u32 initial_locked) {
 ResultCode SVC::ReleaseMutex(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called handle=0x{:08X}", handle);
 
-    std::shared_ptr<Mutex> mutex = kernel.GetCurrentProcess()->handle_table.Get<Mutex>(handle);
+    Mutex* mutex = kernel.GetCurrentProcess()->handle_table.Borrow<Mutex>(handle);
     if (mutex == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1268,8 +1301,8 @@ ResultCode SVC::ReleaseMutex(Handle handle) {
 ResultCode SVC::GetProcessId(u32* process_id, Handle process_handle) {
     LOG_TRACE(Kernel_SVC, "called process=0x{:08X}", process_handle);
 
-    const std::shared_ptr<Process> process =
-        kernel.GetCurrentProcess()->handle_table.Get<Process>(process_handle);
+    const Process* process =
+        kernel.GetCurrentProcess()->handle_table.Borrow<Process>(process_handle);
     if (process == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1281,8 +1314,7 @@ ResultCode SVC::GetProcessId(u32* process_id, Handle process_handle) {
 ResultCode SVC::GetProcessIdOfThread(u32* process_id, Handle thread_handle) {
     LOG_TRACE(Kernel_SVC, "called thread=0x{:08X}", thread_handle);
 
-    const std::shared_ptr<Thread> thread =
-        kernel.GetCurrentProcess()->handle_table.Get<Thread>(thread_handle);
+    const Thread* thread = kernel.GetCurrentProcess()->handle_table.Borrow<Thread>(thread_handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1297,8 +1329,7 @@ ResultCode SVC::GetProcessIdOfThread(u32* process_id, Handle thread_handle) {
 ResultCode SVC::GetThreadId(u32* thread_id, Handle handle) {
     LOG_TRACE(Kernel_SVC, "called thread=0x{:08X}", handle);
 
-    const std::shared_ptr<Thread> thread =
-        kernel.GetCurrentProcess()->handle_table.Get<Thread>(handle);
+    const Thread* thread = kernel.GetCurrentProcess()->handle_table.Borrow<Thread>(handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1323,8 +1354,7 @@ ResultCode SVC::CreateSemaphore(Handle* out_handle, s32 initial_count, s32 max_c
 ResultCode SVC::ReleaseSemaphore(s32* count, Handle handle, s32 release_count) {
     LOG_TRACE(Kernel_SVC, "called release_count={}, handle=0x{:08X}", release_count, handle);
 
-    std::shared_ptr<Semaphore> semaphore =
-        kernel.GetCurrentProcess()->handle_table.Get<Semaphore>(handle);
+    Semaphore* semaphore = kernel.GetCurrentProcess()->handle_table.Borrow<Semaphore>(handle);
     if (semaphore == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1417,7 +1447,7 @@ ResultCode SVC::DuplicateHandle(Handle* out, Handle handle) {
 ResultCode SVC::SignalEvent(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called event=0x{:08X}", handle);
 
-    std::shared_ptr<Event> evt = kernel.GetCurrentProcess()->handle_table.Get<Event>(handle);
+    Event* evt = kernel.GetCurrentProcess()->handle_table.Borrow<Event>(handle);
     if (evt == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1430,7 +1460,7 @@ ResultCode SVC::SignalEvent(Handle handle) {
 ResultCode SVC::ClearEvent(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called event=0x{:08X}", handle);
 
-    std::shared_ptr<Event> evt = kernel.GetCurrentProcess()->handle_table.Get<Event>(handle);
+    Event* evt = kernel.GetCurrentProcess()->handle_table.Borrow<Event>(handle);
     if (evt == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1454,7 +1484,7 @@ ResultCode SVC::CreateTimer(Handle* out_handle, u32 reset_type) {
 ResultCode SVC::ClearTimer(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
-    std::shared_ptr<Timer> timer = kernel.GetCurrentProcess()->handle_table.Get<Timer>(handle);
+    Timer* timer = kernel.GetCurrentProcess()->handle_table.Borrow<Timer>(handle);
     if (timer == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1470,7 +1500,7 @@ ResultCode SVC::SetTimer(Handle handle, s64 initial, s64 interval) {
         return ERR_OUT_OF_RANGE_KERNEL;
     }
 
-    std::shared_ptr<Timer> timer = kernel.GetCurrentProcess()->handle_table.Get<Timer>(handle);
+    Timer* timer = kernel.GetCurrentProcess()->handle_table.Borrow<Timer>(handle);
     if (timer == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1483,7 +1513,7 @@ ResultCode SVC::SetTimer(Handle handle, s64 initial, s64 interval) {
 ResultCode SVC::CancelTimer(Handle handle) {
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
-    std::shared_ptr<Timer> timer = kernel.GetCurrentProcess()->handle_table.Get<Timer>(handle);
+    Timer* timer = kernel.GetCurrentProcess()->handle_table.Borrow<Timer>(handle);
     if (timer == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1500,8 +1530,10 @@ void SVC::SleepThread(s64 nanoseconds) {
 
     // Don't attempt to yield execution if there are no available threads to run,
     // this way we avoid a useless reschedule to the idle thread.
-    if (nanoseconds == 0 && !thread_manager.HaveReadyThreads())
+    if (nanoseconds == 0 && !thread_manager.HaveReadyThreads()) {
+        OnPoll();
         return;
+    }
 
     // Sleep current thread and check for next thread to schedule
     thread_manager.WaitCurrentThread_Sleep();
@@ -1518,7 +1550,8 @@ s64 SVC::GetSystemTick() {
     s64 result = system.GetRunningCore().GetTimer().GetTicks();
     // Advance time to defeat dumb games (like Cubic Ninja) that busy-wait for the frame to end.
     // Measured time between two calls on a 9.2 o3DS with Ninjhax 1.1b
-    system.GetRunningCore().GetTimer().AddTicks(150);
+    system.GetRunningCore().GetTimer().AddTicks(GET_SYSTEM_TICK_TICKS);
+    OnPoll();
     return result;
 }
 
@@ -1932,8 +1965,9 @@ ResultCode SVC::ControlProcess(Handle process_handle, u32 process_OP, u32 varg2,
     case ControlProcessOP::PROCESSOP_SET_MMU_TO_RWX: {
         for (auto it = process->vm_manager.vma_map.cbegin();
              it != process->vm_manager.vma_map.cend(); it++) {
+            // Reprotect may merge the VMA with its neighbours, so continue from the merged one
             if (it->second.meminfo_state != MemoryState::Free)
-                process->vm_manager.Reprotect(it, Kernel::VMAPermission::ReadWriteExecute);
+                it = process->vm_manager.Reprotect(it, Kernel::VMAPermission::ReadWriteExecute);
         }
         return RESULT_SUCCESS;
     }
@@ -2178,6 +2212,19 @@ const SVC::FunctionDef* SVC::GetSVCInfo(u32 func_num) {
 
 MICROPROFILE_DEFINE(Kernel_SVC, "Kernel", "SVC", MP_RGB(70, 200, 70));
 
+#if MICROPROFILE_ENABLED
+MicroProfileToken SVC::GetProfileToken(u32 func_num) {
+    static const auto tokens = [] {
+        std::array<MicroProfileToken, SVC_Table.size()> result;
+        for (std::size_t i = 0; i < SVC_Table.size(); ++i) {
+            result[i] = MicroProfileGetToken("SVC", SVC_Table[i].name, MP_RGB(70, 200, 70));
+        }
+        return result;
+    }();
+    return tokens[func_num];
+}
+#endif
+
 void SVC::CallSVC(u32 immediate) {
     MICROPROFILE_SCOPE(Kernel_SVC);
 
@@ -2188,14 +2235,74 @@ void SVC::CallSVC(u32 immediate) {
                      "Running threads from exiting processes is unimplemented");
 
     const FunctionDef* info = GetSVCInfo(immediate);
-    LOG_TRACE(Kernel_SVC, "calling {}", info->name);
     if (info) {
-        if (info->func) {
-            (this->*(info->func))();
-        } else {
-            LOG_ERROR(Kernel_SVC, "unimplemented SVC function {}(..)", info->name);
+        LOG_TRACE(Kernel_SVC, "calling {}", info->name);
+        MICROPROFILE_SCOPE_TOKEN(GetProfileToken(immediate));
+
+        // The hottest SVCs are called directly, so that their wrappers can be inlined
+        switch (immediate) {
+        case 0x24:
+            Wrap<&SVC::WaitSynchronization1>();
+            break;
+        case 0x28:
+            Wrap<&SVC::GetSystemTick>();
+            break;
+        case 0x32:
+            Wrap<&SVC::SendSyncRequest>();
+            break;
+        default:
+            if (info->func) {
+                (this->*(info->func))();
+            } else {
+                LOG_ERROR(Kernel_SVC, "unimplemented SVC function {}(..)", info->name);
+            }
+            break;
         }
     }
+
+    // Any other SVC means that the thread is making progress
+    if (!polled) {
+        poll_count = 0;
+    }
+    polled = false;
+}
+
+bool SVC::CallFastSVC(ARM_Interface& core, u32 immediate) {
+    // GetSystemTick only needs the timer of the calling core, which is only ever advanced by its
+    // own thread. Spin loop detection needs the kernel, so it takes the regular path.
+    if (immediate != 0x28 || Settings::values.skip_idle_loops) {
+        return false;
+    }
+
+    auto& timer = core.GetTimer();
+    const u64 ticks = timer.GetTicks();
+    timer.AddTicks(GET_SYSTEM_TICK_TICKS);
+    core.SetReg(0, static_cast<u32>(ticks));
+    core.SetReg(1, static_cast<u32>(ticks >> 32));
+    return true;
+}
+
+void SVC::OnPoll() {
+    polled = true;
+    if (!Settings::values.skip_idle_loops) {
+        return;
+    }
+
+    auto& timer = system.GetRunningCore().GetTimer();
+    const Thread* thread = kernel.GetCurrentThreadManager().GetCurrentThread();
+    const u64 ticks = timer.GetTicks();
+    if (thread != poll_thread || ticks - last_poll_ticks > MAX_POLL_INTERVAL) {
+        poll_thread = thread;
+        poll_count = 0;
+    }
+
+    if (++poll_count >= MIN_SPIN_POLLS) {
+        // Fast-forward to the end of the slice, which never goes past the next scheduled event
+        LOG_TRACE(Kernel_SVC, "Skipping spin loop of thread {}", thread->GetObjectId());
+        timer.Idle();
+        system.GetRunningCore().PrepareReschedule();
+    }
+    last_poll_ticks = timer.GetTicks();
 }
 
 SVC::SVC(Core::System& system) : system(system), kernel(system.Kernel()), memory(system.Memory()) {}
@@ -2215,6 +2322,10 @@ void SVCContext::CallSVC(u32 immediate) {
     impl->CallSVC(immediate);
 }
 
+bool SVCContext::CallFastSVC(ARM_Interface& core, u32 immediate) {
+    return impl->CallFastSVC(core, immediate);
+}
+
 } // namespace Kernel
 
 SERIALIZE_EXPORT_IMPL(Kernel::SVC_SyncCallback)
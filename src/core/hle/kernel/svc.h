@@ -8,6 +8,8 @@
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
 
+class ARM_Interface;
+
 namespace Core {
 class System;
 } // namespace Core
@@ -22,6 +24,13 @@ public:
     ~SVCContext();
     void CallSVC(u32 immediate);
 
+    /**
+     * Handles the SVCs that only access the state of the calling core, without locking or
+     * entering the kernel. Can be called from the CPU thread of the core before CallSVC.
+     * @returns true if the SVC was handled, false if it has to go through CallSVC
+     */
+    bool CallFastSVC(ARM_Interface& core, u32 immediate);
+
 private:
     std::unique_ptr<SVC> impl;
 };
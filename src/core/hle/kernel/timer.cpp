@@ -25,7 +25,7 @@ Timer::~Timer() {
 }
 
 std::shared_ptr<Timer> KernelSystem::CreateTimer(ResetType reset_type, std::string name) {
-    auto timer{std::make_shared<Timer>(*this)};
+    auto timer{MakePooledObject<Timer>(*this)};
 
     timer->reset_type = reset_type;
     timer->signaled = false;
@@ -169,16 +169,17 @@ ResultCode VMManager::ChangeMemoryState(VAddr target, u32 size, MemoryState expe
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
     while (vma != end && vma->second.base < target_end) {
+        // The page table doesn't track the state or permissions, so the pages are left as is
         vma->second.permissions = new_perms;
         vma->second.meminfo_state = new_state;
-        UpdatePageTableForVMA(vma->second);
         vma = std::next(MergeAdjacent(vma));
     }
 
+    NotifyMemoryChanged();
     return RESULT_SUCCESS;
 }
 
-VMManager::VMAIter VMManager::Unmap(VMAIter vma_handle) {
+VMManager::VMAIter VMManager::Unmap(VMAIter vma_handle, bool update_page_table) {
     ASSERT(!is_locked);
 
     VirtualMemoryArea& vma = vma_handle->second;
@@ -189,7 +190,9 @@ VMManager::VMAIter VMManager::Unmap(VMAIter vma_handle) {
     vma.backing_memory = nullptr;
     vma.paddr = 0;
 
-    UpdatePageTableForVMA(vma);
+    if (update_page_table) {
+        UpdatePageTableForVMA(vma);
+    }
 
     return MergeAdjacent(vma_handle);
 }
@@ -204,9 +207,13 @@ ResultCode VMManager::UnmapRange(VAddr target, u32 size) {
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
     while (vma != end && vma->second.base < target_end) {
-        vma = std::next(Unmap(vma));
+        vma = std::next(Unmap(vma, false));
     }
 
+    // Unmap the pages of the whole range at once rather than VMA by VMA
+    memory.UnmapRegion(*page_table, target, size);
+    NotifyMemoryChanged();
+
     ASSERT(FindVMA(target)->second.size >= size);
     return RESULT_SUCCESS;
 }
@@ -216,9 +223,9 @@ VMManager::VMAHandle VMManager::Reprotect(VMAHandle vma_handle, VMAPermission ne
 
     VMAIter iter = StripIterConstness(vma_handle);
 
-    VirtualMemoryArea& vma = iter->second;
-    vma.permissions = new_perms;
-    UpdatePageTableForVMA(vma);
+    // The page table doesn't track the permissions, so the pages are left as is
+    iter->second.permissions = new_perms;
+    NotifyMemoryChanged();
 
     return MergeAdjacent(iter);
 }
@@ -233,9 +240,11 @@ ResultCode VMManager::ReprotectRange(VAddr target, u32 size, VMAPermission new_p
     // The comparison against the end of the range must be done using addresses since VMAs can be
     // merged during this process, causing invalidation of the iterators.
     while (vma != end && vma->second.base < target_end) {
-        vma = std::next(StripIterConstness(Reprotect(vma, new_perms)));
+        vma->second.permissions = new_perms;
+        vma = std::next(MergeAdjacent(vma));
     }
 
+    NotifyMemoryChanged();
     return RESULT_SUCCESS;
 }
 
@@ -386,6 +395,10 @@ void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
         break;
     }
 
+    NotifyMemoryChanged();
+}
+
+void VMManager::NotifyMemoryChanged() {
     auto plgldr = Service::PLGLDR::GetService(Core::System::GetInstance());
     if (plgldr)
         plgldr->OnMemoryChanged(process, Core::System::GetInstance().Kernel());
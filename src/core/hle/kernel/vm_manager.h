@@ -223,8 +223,8 @@ private:
     /// Converts a VMAHandle to a mutable VMAIter.
     VMAIter StripIterConstness(const VMAHandle& iter);
 
-    /// Unmaps the given VMA.
-    VMAIter Unmap(VMAIter vma);
+    /// Unmaps the given VMA. The page table is only updated if update_page_table is set.
+    VMAIter Unmap(VMAIter vma, bool update_page_table = true);
 
     /**
      * Carves a VMA of a specific size at the specified address by splitting Free VMAs while doing
@@ -253,6 +253,9 @@ private:
     /// Updates the pages corresponding to this VMA so they match the VMA's attributes.
     void UpdatePageTableForVMA(const VirtualMemoryArea& vma);
 
+    /// Tells the plugin loader that the memory layout of the process changed
+    void NotifyMemoryChanged();
+
     Memory::MemorySystem& memory;
     Kernel::Process& process;
 
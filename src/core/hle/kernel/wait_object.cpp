@@ -43,6 +43,10 @@ void WaitObject::RemoveWaitingThread(Thread* thread) {
 }
 
 std::shared_ptr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
+    return SharedFrom(FindHighestPriorityReadyThread());
+}
+
+Thread* WaitObject::FindHighestPriorityReadyThread() const {
     Thread* candidate = nullptr;
     u32 candidate_priority = ThreadPrioLowest + 1;
 
@@ -75,25 +79,28 @@ std::shared_ptr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
         }
     }
 
-    return SharedFrom(candidate);
+    return candidate;
 }
 
 void WaitObject::WakeupAllWaitingThreads() {
-    while (auto thread = GetHighestPriorityReadyThread()) {
+    // Threads stay alive in the thread list of their manager while they are waiting, so they are
+    // handled by raw pointer and only shared with the wakeup callback
+    while (Thread* thread = FindHighestPriorityReadyThread()) {
         if (!thread->IsSleepingOnWaitAll()) {
-            Acquire(thread.get());
+            Acquire(thread);
         } else {
             for (auto& object : thread->wait_objects) {
-                object->Acquire(thread.get());
+                object->Acquire(thread);
             }
         }
 
         // Invoke the wakeup callback before clearing the wait objects
         if (thread->wakeup_callback)
-            thread->wakeup_callback->WakeUp(ThreadWakeupReason::Signal, thread, SharedFrom(this));
+            thread->wakeup_callback->WakeUp(ThreadWakeupReason::Signal, SharedFrom(thread),
+                                            SharedFrom(this));
 
         for (auto& object : thread->wait_objects)
-            object->RemoveWaitingThread(thread.get());
+            object->RemoveWaitingThread(thread);
         thread->wait_objects.clear();
 
         thread->ResumeFromWait();
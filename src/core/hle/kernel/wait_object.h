@@ -60,6 +60,9 @@ public:
     void SetHLENotifier(std::function<void()> callback);
 
 private:
+    /// Returns the highest priority thread that is ready to run, without taking a reference to it
+    Thread* FindHighestPriorityReadyThread() const;
+
     /// Threads waiting for this object to become available
     std::vector<std::shared_ptr<Thread>> waiting_threads;
 
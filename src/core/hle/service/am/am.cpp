@@ -6,6 +6,7 @@
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
+#include <future>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <fmt/format.h>
@@ -13,6 +14,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/ncch_container.h"
@@ -27,6 +29,7 @@
 #include "core/hle/service/am/am_net.h"
 #include "core/hle/service/am/am_sys.h"
 #include "core/hle/service/am/am_u.h"
+#include "core/hle/service/am/title_database.h"
 #include "core/hle/service/fs/archive.h"
 #include "core/hle/service/fs/fs_user.h"
 #include "core/loader/loader.h"
@@ -120,6 +123,7 @@ ResultCode CIAFile::WriteTitleMetadata() {
     // Save TMD so that we can start getting new .app paths
     if (tmd.Save(tmd_path) != Loader::ResultStatus::Success)
         return FileSys::ERROR_INSUFFICIENT_SPACE;
+    TitleDatabase::GetInstance().Invalidate(media_type, tmd.GetTitleID());
 
     // Create any other .app folders which may not exist yet
     std::string app_folder;
@@ -130,6 +134,7 @@ ResultCode CIAFile::WriteTitleMetadata() {
 
     auto content_count = container.GetTitleMetadata().GetContentCount();
     content_written.resize(content_count);
+    content_files.resize(content_count);
 
     if (auto title_key = container.GetTicket().GetTitleKey()) {
         decryption_state->content.resize(content_count);
@@ -168,28 +173,37 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
 
             // Since the incoming TMD has already been written, we can use GetTitleContentPath
             // to get the content paths to write to.
-            FileSys::TitleMetadata tmd = container.GetTitleMetadata();
-            FileUtil::IOFile file(GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
-                                  content_written[i] ? "ab" : "wb");
+            const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+            FileUtil::IOFile& file = content_files[i];
+            if (!file.IsOpen()) {
+                file = FileUtil::IOFile(
+                    GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
+                    content_written[i] ? "ab" : "wb");
+            }
 
             if (!file.IsOpen()) {
                 return FileSys::ERROR_INSUFFICIENT_SPACE;
             }
 
-            std::vector<u8> temp(buffer + (range_min - offset),
-                                 buffer + (range_min - offset) + available_to_write);
-
+            const u8* const content_data = buffer + (range_min - offset);
+            const std::size_t content_length = static_cast<std::size_t>(available_to_write);
             if ((tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
+                content_buffer.resize(content_length);
+                decryption_state->content[i].ProcessData(content_buffer.data(), content_data,
+                                                         content_length);
+                file.WriteBytes(content_buffer.data(), content_length);
+            } else {
+                file.WriteBytes(content_data, content_length);
             }
 
-            file.WriteBytes(temp.data(), temp.size());
-
             // Keep tabs on how much of this content ID has been written so new range_min
             // values can be calculated.
             content_written[i] += available_to_write;
             LOG_DEBUG(Service_AM, "Wrote {:x} to content {}, total {:x}", available_to_write, i,
                       content_written[i]);
+            if (content_written[i] == size) {
+                file.Close();
+            }
         }
     }
 
@@ -276,6 +290,8 @@ bool CIAFile::SetSize(u64 size) const {
 }
 
 bool CIAFile::Close() const {
+    content_files.clear();
+
     bool complete = true;
     for (std::size_t i = 0; i < container.GetTitleMetadata().GetContentCount(); i++) {
         if (content_written[i] < container.GetContentSize(static_cast<u16>(i)))
@@ -286,6 +302,8 @@ bool CIAFile::Close() const {
     if (!complete) {
         LOG_ERROR(Service_AM, "CIAFile closed prematurely, aborting install...");
         FileUtil::DeleteDir(GetTitlePath(media_type, container.GetTitleMetadata().GetTitleID()));
+        TitleDatabase::GetInstance().Invalidate(media_type,
+                                                container.GetTitleMetadata().GetTitleID());
         return true;
     }
 
@@ -326,6 +344,8 @@ bool CIAFile::Close() const {
         }
 
         FileUtil::Delete(old_tmd_path);
+        TitleDatabase::GetInstance().Invalidate(media_type,
+                                                container.GetTitleMetadata().GetTitleID());
     }
     return true;
 }
@@ -361,21 +381,41 @@ InstallStatus InstallCIA(const std::string& path,
         if (!file.IsOpen())
             return InstallStatus::ErrorFailedToOpenFile;
 
-        std::array<u8, 0x10000> buffer;
+        // Reading the next chunk overlaps with decrypting and writing the current one
+        constexpr std::size_t CHUNK_SIZE = 0x100000;
+        std::array<std::vector<u8>, 2> buffers{std::vector<u8>(CHUNK_SIZE),
+                                               std::vector<u8>(CHUNK_SIZE)};
+        const auto read_chunk = [&file](std::vector<u8>& buffer) {
+            return file.ReadBytes(buffer.data(), buffer.size());
+        };
+
+        const std::size_t file_size = file.GetSize();
         std::size_t total_bytes_read = 0;
-        while (total_bytes_read != file.GetSize()) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
+        std::size_t current = 0;
+        auto next_read = std::async(std::launch::async, read_chunk, std::ref(buffers[current]));
+        while (total_bytes_read != file_size) {
+            const std::size_t bytes_read = next_read.get();
+            if (bytes_read == 0) {
+                LOG_ERROR(Service_AM, "CIA file installation aborted, unable to read {}", path);
+                return InstallStatus::ErrorAborted;
+            }
+            if (total_bytes_read + bytes_read != file_size) {
+                next_read =
+                    std::async(std::launch::async, read_chunk, std::ref(buffers[current ^ 1]));
+            }
+
             auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            static_cast<u8*>(buffer.data()));
+                                            buffers[current].data());
 
             if (update_callback)
-                update_callback(total_bytes_read, file.GetSize());
+                update_callback(total_bytes_read, file_size);
             if (result.Failed()) {
                 LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
                           result.Code().raw);
                 return InstallStatus::ErrorAborted;
             }
             total_bytes_read += bytes_read;
+            current ^= 1;
         }
         installFile.Close();
 
@@ -440,34 +480,21 @@ std::string GetTitleMetadataPath(Service::FS::MediaType media_type, u64 tid, boo
         return "";
     }
 
-    // The TMD ID is usually held in the title databases, which we don't implement.
-    // For now, just scan for any .tmd files which exist, the smallest will be the
-    // base ID and the largest will be the (currently installing) update ID.
-    constexpr u32 MAX_TMD_ID = 0xFFFFFFFF;
-    u32 base_id = MAX_TMD_ID;
-    u32 update_id = 0;
-    FileUtil::FSTEntry entries;
-    FileUtil::ScanDirectoryTree(content_path, entries);
-    for (const FileUtil::FSTEntry& entry : entries.children) {
-        std::string filename_filename, filename_extension;
-        Common::SplitPath(entry.virtualName, nullptr, &filename_filename, &filename_extension);
-
-        if (filename_extension == ".tmd") {
-            const u32 id = std::stoul(filename_filename, nullptr, 16);
-            base_id = std::min(base_id, id);
-            update_id = std::max(update_id, id);
-        }
+    if (!update) {
+        const auto title = TitleDatabase::GetInstance().Get(media_type, tid);
+        return content_path + fmt::format("{:08x}.tmd", title.base_tmd_id);
     }
 
-    // If we didn't find anything, default to 00000000.tmd for it to be created.
-    if (base_id == MAX_TMD_ID)
-        base_id = 0;
+    // The update TMD is only asked for while installing it, so it's always looked up on disk
+    TitleDatabase::Title title;
+    TitleDatabase::ReadTMDIDs(content_path, title);
 
     // Update ID should be one more than the last, if it hasn't been created yet.
-    if (base_id == update_id)
+    u32 update_id = title.last_tmd_id;
+    if (title.base_tmd_id == update_id)
         update_id++;
 
-    return content_path + fmt::format("{:08x}.tmd", (update ? update_id : base_id));
+    return content_path + fmt::format("{:08x}.tmd", update_id);
 }
 
 std::string GetTitleContentPath(Service::FS::MediaType media_type, u64 tid, std::size_t index,
@@ -481,32 +508,14 @@ std::string GetTitleContentPath(Service::FS::MediaType media_type, u64 tid, std:
         return fs_user->GetCurrentGamecardPath();
     }
 
-    std::string content_path = GetTitlePath(media_type, tid) + "content/";
-
-    std::string tmd_path = GetTitleMetadataPath(media_type, tid, update);
-
-    u32 content_id = 0;
-    FileSys::TitleMetadata tmd;
-    if (tmd.Load(tmd_path) == Loader::ResultStatus::Success) {
-        if (index < tmd.GetContentCount()) {
-            content_id = tmd.GetContentIDByIndex(index);
-        } else {
-            LOG_ERROR(Service_AM, "Attempted to get path for non-existent content index {:04x}.",
-                      index);
-            return "";
-        }
-
-        // TODO(shinyquagsire23): how does DLC actually get this folder on hardware?
-        // For now, check if the second (index 1) content has the optional flag set, for most
-        // apps this is usually the manual and not set optional, DLC has it set optional.
-        // All .apps (including index 0) will be in the 00000000/ folder for DLC.
-        if (tmd.GetContentCount() > 1 &&
-            tmd.GetContentTypeByIndex(1) & FileSys::TMDContentTypeFlag::Optional) {
-            content_path += "00000000/";
-        }
+    const std::string title_path = GetTitlePath(media_type, tid);
+    if (!update) {
+        return TitleDatabase::GetInstance().Get(media_type, tid).GetContentPath(title_path, index);
     }
 
-    return fmt::format("{}{:08x}.app", content_path, content_id);
+    TitleDatabase::Title title;
+    TitleDatabase::ReadContents(GetTitleMetadataPath(media_type, tid, true), title);
+    return title.GetContentPath(title_path, index);
 }
 
 std::string GetTitlePath(Service::FS::MediaType media_type, u64 tid) {
@@ -549,32 +558,21 @@ std::string GetMediaTitlePath(Service::FS::MediaType media_type) {
 }
 
 void Module::ScanForTitles(Service::FS::MediaType media_type) {
-    am_title_list[static_cast<u32>(media_type)].clear();
-
-    std::string title_path = GetMediaTitlePath(media_type);
-
-    FileUtil::FSTEntry entries;
-    FileUtil::ScanDirectoryTree(title_path, entries, 1);
-    for (const FileUtil::FSTEntry& tid_high : entries.children) {
-        for (const FileUtil::FSTEntry& tid_low : tid_high.children) {
-            std::string tid_string = tid_high.virtualName + tid_low.virtualName;
-
-            if (tid_string.length() == TITLE_ID_VALID_LENGTH) {
-                const u64 tid = std::stoull(tid_string, nullptr, 16);
-
-                FileSys::NCCHContainer container(GetTitleContentPath(media_type, tid));
-                if (container.Load() == Loader::ResultStatus::Success)
-                    am_title_list[static_cast<u32>(media_type)].push_back(tid);
-            }
-        }
-    }
+    am_title_list[static_cast<u32>(media_type)] = TitleDatabase::GetInstance().Scan(media_type);
 }
 
 void Module::ScanForAllTitles() {
+    WaitForTitleScan();
     ScanForTitles(Service::FS::MediaType::NAND);
     ScanForTitles(Service::FS::MediaType::SDMC);
 }
 
+void Module::WaitForTitleScan() {
+    if (title_scan.valid()) {
+        title_scan.get();
+    }
+}
+
 Module::Interface::Interface(std::shared_ptr<Module> am, const char* name, u32 max_session)
     : ServiceFramework(name, max_session), am(std::move(am)) {}
 
@@ -584,6 +582,7 @@ void Module::Interface::GetNumPrograms(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x0001, 1, 0); // 0x00010040
     u32 media_type = rp.Pop<u8>();
 
+    am->WaitForTitleScan();
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
     rb.Push(RESULT_SUCCESS);
     rb.Push<u32>(static_cast<u32>(am->am_title_list[media_type].size()));
@@ -736,6 +735,7 @@ void Module::Interface::GetProgramList(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    am->WaitForTitleScan();
     u32 media_count = static_cast<u32>(am->am_title_list[media_type].size());
     u32 copied = std::min(media_count, count);
 
@@ -816,6 +816,7 @@ void Module::Interface::DeleteUserProgram(Kernel::HLERequestContext& ctx) {
         return;
     }
     bool success = FileUtil::DeleteDirRecursively(path);
+    TitleDatabase::GetInstance().Invalidate(media_type, title_id);
     am->ScanForAllTitles();
     rb.Push(RESULT_SUCCESS);
     if (!success)
@@ -1148,11 +1149,13 @@ public:
         : file(std::move(file)), file_offset(offset), file_size(size) {}
 
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override {
+        std::scoped_lock lock{file->backend_mutex};
         return file->backend->Read(offset + file_offset, length, buffer);
     }
 
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
                                  const u8* buffer) override {
+        std::scoped_lock lock{file->backend_mutex};
         return file->backend->Write(offset + file_offset, length, flush, buffer);
     }
 
@@ -1410,6 +1413,7 @@ void Module::Interface::DeleteProgram(Kernel::HLERequestContext& ctx) {
         return;
     }
     bool success = FileUtil::DeleteDirRecursively(path);
+    TitleDatabase::GetInstance().Invalidate(media_type, title_id);
     am->ScanForAllTitles();
     rb.Push(RESULT_SUCCESS);
     if (!success)
@@ -1493,13 +1497,24 @@ void Module::Interface::GetMetaDataFromCia(Kernel::HLERequestContext& ctx) {
 }
 
 Module::Module(Core::System& system) : kernel(system.Kernel()) {
-    ScanForAllTitles();
+    // Reading the headers of every installed title takes a while with large SD cards, most
+    // titles never ask for the list
+    title_scan = Common::ThreadPool::Shared().Submit(
+        [this] {
+            ScanForTitles(Service::FS::MediaType::NAND);
+            ScanForTitles(Service::FS::MediaType::SDMC);
+        },
+        Common::TaskPriority::Normal);
     system_updater_mutex = system.Kernel().CreateMutex(false, "AM::SystemUpdaterMutex");
 }
 
 Module::Module(Kernel::KernelSystem& kernel) : kernel(kernel) {}
 
-Module::~Module() = default;
+Module::~Module() {
+    if (title_scan.valid()) {
+        title_scan.wait();
+    }
+}
 
 void InstallInterfaces(Core::System& system) {
     auto& service_manager = system.ServiceManager();
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,6 +15,7 @@
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
 #include "common/construct.h"
+#include "common/file_util.h"
 #include "core/file_sys/cia_container.h"
 #include "core/file_sys/file_backend.h"
 #include "core/global.h"
@@ -97,6 +99,11 @@ private:
     std::vector<u64> content_written;
     Service::FS::MediaType media_type;
 
+    // Files of the contents being written, kept open across writes. Close has to release them
+    // before cleaning up.
+    mutable std::vector<FileUtil::IOFile> content_files;
+    std::vector<u8> content_buffer;
+
     class DecryptionState;
     std::unique_ptr<DecryptionState> decryption_state;
 };
@@ -580,13 +587,18 @@ private:
      */
     void ScanForAllTitles();
 
+    /// Waits for the scan of all storage mediums started in the background by the constructor
+    void WaitForTitleScan();
+
     Kernel::KernelSystem& kernel;
     bool cia_installing = false;
     std::array<std::vector<u64_le>, 3> am_title_list;
+    std::future<void> title_scan;
     std::shared_ptr<Kernel::Mutex> system_updater_mutex;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
+        WaitForTitleScan();
         ar& cia_installing;
         ar& am_title_list;
         ar& system_updater_mutex;
@@ -0,0 +1,354 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "core/file_sys/ncch_container.h"
+#include "core/file_sys/title_metadata.h"
+#include "core/hle/service/am/am.h"
+#include "core/hle/service/am/title_database.h"
+#include "core/hle/service/fs/archive.h"
+#include "core/loader/loader.h"
+
+namespace Service::AM {
+
+namespace {
+
+constexpr u32 DATABASE_MAGIC = 0x43544401; // CTD\x01
+
+bool IsCached(FS::MediaType media_type) {
+    return media_type == FS::MediaType::NAND || media_type == FS::MediaType::SDMC;
+}
+
+/// The database is next to the title directory, this keeps it out of the way of the titles
+std::string GetDatabasePath(const std::string& title_path) {
+    return fmt::format("{}/citra_titles.bin",
+                       FileUtil::GetParentPath(FileUtil::RemoveTrailingSlash(title_path)));
+}
+
+std::string GetTMDPath(const std::string& content_path, u32 tmd_id) {
+    return content_path + fmt::format("{:08x}.tmd", tmd_id);
+}
+
+/// Checks the modification times that the title was read at, without parsing anything
+bool IsUnchanged(const std::string& content_path, const TitleDatabase::Title& title) {
+    if (!FileUtil::IsDirectory(content_path) ||
+        FileUtil::GetModificationTime(content_path) != title.directory_time) {
+        return false;
+    }
+    if (!title.has_tmd) {
+        return true;
+    }
+    const std::string tmd_path = GetTMDPath(content_path, title.base_tmd_id);
+    return FileUtil::Exists(tmd_path) &&
+           FileUtil::GetModificationTime(tmd_path) == title.tmd_time &&
+           FileUtil::GetSize(tmd_path) == title.tmd_size;
+}
+
+} // Anonymous namespace
+
+std::string TitleDatabase::Title::GetContentPath(const std::string& title_path,
+                                                 std::size_t index) const {
+    std::string content_path = title_path + "content/";
+    u32 content_id = 0;
+    if (has_tmd) {
+        if (index >= content_ids.size()) {
+            LOG_ERROR(Service_AM, "Attempted to get path for non-existent content index {:04x}.",
+                      index);
+            return "";
+        }
+        content_id = content_ids[index];
+        if (dlc_layout) {
+            content_path += "00000000/";
+        }
+    }
+    return fmt::format("{}{:08x}.app", content_path, content_id);
+}
+
+TitleDatabase& TitleDatabase::GetInstance() {
+    static TitleDatabase instance;
+    return instance;
+}
+
+std::vector<u64> TitleDatabase::Scan(FS::MediaType media_type) {
+    if (!IsCached(media_type)) {
+        return {};
+    }
+
+    FileUtil::FSTEntry entries;
+    FileUtil::ScanDirectoryTree(GetMediaTitlePath(media_type), entries, 1);
+
+    std::unordered_set<u64> installed;
+    std::vector<u64> listed;
+    std::size_t read_count = 0;
+    for (const FileUtil::FSTEntry& tid_high : entries.children) {
+        for (const FileUtil::FSTEntry& tid_low : tid_high.children) {
+            const std::string tid_string = tid_high.virtualName + tid_low.virtualName;
+            if (tid_string.length() != TITLE_ID_VALID_LENGTH) {
+                continue;
+            }
+            const u64 tid = std::stoull(tid_string, nullptr, 16);
+
+            std::optional<Title> title;
+            u64 generation;
+            {
+                std::scoped_lock lock{mutex};
+                Medium& medium = GetMedium(media_type);
+                generation = medium.generation;
+                if (const auto it = medium.titles.find(tid); it != medium.titles.end()) {
+                    title = it->second;
+                }
+            }
+            if (!title || !IsUnchanged(GetTitlePath(media_type, tid) + "content/", *title)) {
+                title = ReadTitle(media_type, tid);
+                Insert(media_type, tid, *title, generation);
+                read_count++;
+            }
+
+            installed.insert(tid);
+            if (title->listed) {
+                listed.push_back(tid);
+            }
+        }
+    }
+
+    std::scoped_lock lock{mutex};
+    Medium& medium = GetMedium(media_type);
+    if (std::erase_if(medium.titles,
+                      [&installed](const auto& entry) { return !installed.count(entry.first); })) {
+        medium.dirty = true;
+    }
+    if (medium.dirty) {
+        Save(medium);
+    }
+    LOG_DEBUG(Service_AM, "Found {} titles in {}, read {} of them", installed.size(),
+              medium.title_path, read_count);
+    return listed;
+}
+
+TitleDatabase::Title TitleDatabase::Get(FS::MediaType media_type, u64 title_id) {
+    if (!IsCached(media_type)) {
+        return ReadTitle(media_type, title_id);
+    }
+
+    u64 generation;
+    {
+        std::scoped_lock lock{mutex};
+        Medium& medium = GetMedium(media_type);
+        if (const auto it = medium.titles.find(title_id); it != medium.titles.end()) {
+            return it->second;
+        }
+        generation = medium.generation;
+    }
+    // Reading the title doesn't hold the lock, the background scan shouldn't stall the queries
+    const Title title = ReadTitle(media_type, title_id);
+    Insert(media_type, title_id, title, generation);
+    return title;
+}
+
+void TitleDatabase::Invalidate(FS::MediaType media_type, u64 title_id) {
+    if (!IsCached(media_type)) {
+        return;
+    }
+    std::scoped_lock lock{mutex};
+    Medium& medium = GetMedium(media_type);
+    medium.titles.erase(title_id);
+    medium.generation++;
+    medium.dirty = true;
+}
+
+void TitleDatabase::ReadTMDIDs(const std::string& content_path, Title& title) {
+    // The TMD ID is usually held in the title databases of the 3DS, which we don't implement.
+    // For now, just scan for any .tmd files which exist, the smallest will be the
+    // base ID and the largest will be the (currently installing) update ID.
+    constexpr u32 MAX_TMD_ID = 0xFFFFFFFF;
+    u32 base_id = MAX_TMD_ID;
+    u32 update_id = 0;
+    FileUtil::FSTEntry entries;
+    FileUtil::ScanDirectoryTree(content_path, entries);
+    for (const FileUtil::FSTEntry& entry : entries.children) {
+        std::string filename_filename, filename_extension;
+        Common::SplitPath(entry.virtualName, nullptr, &filename_filename, &filename_extension);
+
+        if (filename_extension == ".tmd") {
+            const u32 id = std::stoul(filename_filename, nullptr, 16);
+            base_id = std::min(base_id, id);
+            update_id = std::max(update_id, id);
+        }
+    }
+
+    // If we didn't find anything, default to 00000000.tmd for it to be created.
+    if (base_id == MAX_TMD_ID)
+        base_id = 0;
+
+    title.base_tmd_id = base_id;
+    title.last_tmd_id = update_id;
+}
+
+void TitleDatabase::ReadContents(const std::string& tmd_path, Title& title) {
+    title.content_ids.clear();
+    title.dlc_layout = false;
+
+    FileSys::TitleMetadata tmd;
+    title.has_tmd = tmd.Load(tmd_path) == Loader::ResultStatus::Success;
+    if (!title.has_tmd) {
+        return;
+    }
+    for (std::size_t i = 0; i < tmd.GetContentCount(); i++) {
+        title.content_ids.push_back(tmd.GetContentIDByIndex(i));
+    }
+
+    // TODO(shinyquagsire23): how does DLC actually get this folder on hardware?
+    // For now, check if the second (index 1) content has the optional flag set, for most
+    // apps this is usually the manual and not set optional, DLC has it set optional.
+    // All .apps (including index 0) will be in the 00000000/ folder for DLC.
+    title.dlc_layout = tmd.GetContentCount() > 1 &&
+                       tmd.GetContentTypeByIndex(1) & FileSys::TMDContentTypeFlag::Optional;
+}
+
+TitleDatabase::Medium& TitleDatabase::GetMedium(FS::MediaType media_type) {
+    Medium& medium = media[static_cast<u32>(media_type)];
+    std::string title_path = GetMediaTitlePath(media_type);
+    if (title_path != medium.title_path) {
+        medium.title_path = std::move(title_path);
+        medium.generation++;
+        Load(medium);
+    }
+    return medium;
+}
+
+void TitleDatabase::Insert(FS::MediaType media_type, u64 title_id, const Title& title,
+                           u64 generation) {
+    if (!title.installed) {
+        return;
+    }
+    std::scoped_lock lock{mutex};
+    Medium& medium = GetMedium(media_type);
+    if (medium.generation != generation) {
+        return;
+    }
+    medium.titles.insert_or_assign(title_id, title);
+    medium.dirty = true;
+}
+
+TitleDatabase::Title TitleDatabase::ReadTitle(FS::MediaType media_type, u64 title_id) {
+    Title title;
+    const std::string title_path = GetTitlePath(media_type, title_id);
+    const std::string content_path = title_path + "content/";
+    if (!FileUtil::IsDirectory(content_path)) {
+        return title;
+    }
+
+    // The times are taken before reading, so that a change while reading shows in the next scan
+    title.installed = true;
+    title.directory_time = FileUtil::GetModificationTime(content_path);
+    ReadTMDIDs(content_path, title);
+    const std::string tmd_path = GetTMDPath(content_path, title.base_tmd_id);
+    if (FileUtil::Exists(tmd_path)) {
+        title.tmd_time = FileUtil::GetModificationTime(tmd_path);
+        title.tmd_size = FileUtil::GetSize(tmd_path);
+    }
+    ReadContents(tmd_path, title);
+
+    FileSys::NCCHContainer container(title.GetContentPath(title_path, 0));
+    title.listed = container.Load() == Loader::ResultStatus::Success;
+    return title;
+}
+
+void TitleDatabase::Load(Medium& medium) {
+    medium.titles.clear();
+    medium.dirty = false;
+
+    const std::string path = GetDatabasePath(medium.title_path);
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    // Counts are checked against the size of the database, so that a corrupted one can't make the
+    // allocations explode
+    const u64 database_size = file.GetSize();
+    const auto read_value = [&file](auto& value) {
+        return file.ReadBytes(&value, sizeof(value)) == sizeof(value);
+    };
+
+    u32 magic{};
+    u64 title_count{};
+    if (!read_value(magic) || magic != DATABASE_MAGIC || !read_value(title_count) ||
+        title_count > database_size) {
+        LOG_WARNING(Service_AM, "Ignoring the invalid title database {}", path);
+        return;
+    }
+
+    std::unordered_map<u64, Title> titles;
+    for (u64 i = 0; i < title_count; i++) {
+        u64 title_id{};
+        Title title;
+        title.installed = true;
+        u8 flags{};
+        u32 content_count{};
+        if (!read_value(title_id) || !read_value(title.base_tmd_id) ||
+            !read_value(title.last_tmd_id) || !read_value(flags) ||
+            !read_value(title.directory_time) || !read_value(title.tmd_time) ||
+            !read_value(title.tmd_size) || !read_value(content_count) ||
+            content_count > database_size) {
+            LOG_WARNING(Service_AM, "Ignoring the invalid title database {}", path);
+            return;
+        }
+        title.has_tmd = flags & 1;
+        title.dlc_layout = flags & 2;
+        title.listed = flags & 4;
+        title.content_ids.resize(content_count);
+        if (file.ReadArray(title.content_ids.data(), content_count) != content_count) {
+            LOG_WARNING(Service_AM, "Ignoring the invalid title database {}", path);
+            return;
+        }
+        titles.emplace(title_id, std::move(title));
+    }
+
+    medium.titles = std::move(titles);
+    LOG_INFO(Service_AM, "Loaded {} titles from {}", medium.titles.size(), path);
+}
+
+void TitleDatabase::Save(Medium& medium) {
+    medium.dirty = false;
+    if (!FileUtil::IsDirectory(medium.title_path)) {
+        return;
+    }
+
+    const std::string path = GetDatabasePath(medium.title_path);
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_WARNING(Service_AM, "Could not create the title database {}", path);
+        return;
+    }
+
+    file.WriteObject(DATABASE_MAGIC);
+    file.WriteObject(static_cast<u64>(medium.titles.size()));
+    for (const auto& [title_id, title] : medium.titles) {
+        const u8 flags = (title.has_tmd ? 1 : 0) | (title.dlc_layout ? 2 : 0) |
+                         (title.listed ? 4 : 0);
+        file.WriteObject(title_id);
+        file.WriteObject(title.base_tmd_id);
+        file.WriteObject(title.last_tmd_id);
+        file.WriteObject(flags);
+        file.WriteObject(title.directory_time);
+        file.WriteObject(title.tmd_time);
+        file.WriteObject(title.tmd_size);
+        file.WriteObject(static_cast<u32>(title.content_ids.size()));
+        file.WriteArray(title.content_ids.data(), title.content_ids.size());
+    }
+
+    if (!file.IsGood()) {
+        file.Close();
+        FileUtil::Delete(path);
+    }
+}
+
+} // namespace Service::AM
@@ -0,0 +1,100 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service::FS {
+enum class MediaType : u32;
+}
+
+namespace Service::AM {
+
+/**
+ * What AM looks up about the titles installed to the NAND and the SD card, so that the path
+ * queries don't scan the title directories and parse the TMDs every time. It's saved next to the
+ * titles of each medium, where a scan reuses the entries of the titles whose content directory and
+ * TMD haven't been modified since. This isn't the title.db of the 3DS, which Citra doesn't use.
+ */
+class TitleDatabase {
+public:
+    struct Title {
+        /// Whether the title has a content directory, only those are kept in the database
+        bool installed = false;
+        /// The IDs of the smallest and the largest TMD files, the smallest is the one in use
+        u32 base_tmd_id = 0;
+        u32 last_tmd_id = 0;
+        bool has_tmd = false;
+        /// Whether the contents are in the 00000000 directory, as those of DLC are
+        bool dlc_layout = false;
+        /// Whether the main content is a valid NCCH, the titles are only listed then
+        bool listed = false;
+        std::vector<u32> content_ids;
+        s64 directory_time = 0;
+        s64 tmd_time = 0;
+        u64 tmd_size = 0;
+
+        /**
+         * Gets the path of a content of the title.
+         * @param title_path the path of the title, see GetTitlePath
+         * @param index the index of the content
+         * @returns the path, empty if the TMD doesn't have the content
+         */
+        std::string GetContentPath(const std::string& title_path, std::size_t index) const;
+    };
+
+    static TitleDatabase& GetInstance();
+
+    /**
+     * Scans the titles of a medium, reading only those that changed since the last scan, and
+     * saves the database if anything changed.
+     * @returns the IDs of the titles to list
+     */
+    std::vector<u64> Scan(FS::MediaType media_type);
+
+    /// Gets the title from the database, reading it if it's not there
+    Title Get(FS::MediaType media_type, u64 title_id);
+
+    /// Drops the title, called when its files are written or deleted
+    void Invalidate(FS::MediaType media_type, u64 title_id);
+
+    /// Scans the content directory of a title for the IDs of its TMD files
+    static void ReadTMDIDs(const std::string& content_path, Title& title);
+
+    /// Reads the content IDs and the layout of a title from its TMD
+    static void ReadContents(const std::string& tmd_path, Title& title);
+
+private:
+    struct Medium {
+        /// The title directory the titles were loaded from, it changes with the user directory
+        std::string title_path;
+        bool dirty = false;
+        /// Counts the invalidations, so that a title read during one isn't saved
+        u64 generation = 0;
+        std::unordered_map<u64, Title> titles;
+    };
+
+    /// Gets the titles of a medium, loading them first if the user directory changed
+    Medium& GetMedium(FS::MediaType media_type);
+
+    /// Adds a title that was read at the given generation, unless it was invalidated since
+    void Insert(FS::MediaType media_type, u64 title_id, const Title& title, u64 generation);
+
+    static Title ReadTitle(FS::MediaType media_type, u64 title_id);
+
+    void Load(Medium& medium);
+    void Save(Medium& medium);
+
+    std::mutex mutex;
+    /// The titles of the NAND and the SD card
+    std::array<Medium, 2> media;
+};
+
+} // namespace Service::AM
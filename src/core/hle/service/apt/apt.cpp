@@ -2,12 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <cstring>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/vector.hpp>
 #include "common/archives.h"
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/mapped_disk_cache.h"
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/file_sys/archive_ncch.h"
@@ -16,6 +20,7 @@
 #include "core/hle/kernel/mutex.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/romfs.h"
+#include "core/hle/service/am/am.h"
 #include "core/hle/service/apt/applet_manager.h"
 #include "core/hle/service/apt/apt.h"
 #include "core/hle/service/apt/apt_a.h"
@@ -147,6 +152,9 @@ static u32 DecompressLZ11(const u8* in, u8* out) {
     return decompressed_size;
 }
 
+/// The version of the shared font cache, to be bumped when the loaded font changes
+constexpr u32 SharedFontCacheVersion = 1;
+
 bool Module::LoadSharedFont() {
     u8 font_region_code;
     auto cfg = Service::CFG::GetModule(system);
@@ -168,6 +176,31 @@ bool Module::LoadSharedFont() {
 
     const u64_le shared_font_archive_id_low = 0x0004009b00014002 | ((font_region_code - 1) << 8);
 
+    // Reading the archive and decompressing the font takes a while, so the loaded font is cached.
+    // The key changes when the font archive is replaced.
+    const std::string content_path =
+        Service::AM::GetTitleContentPath(Service::FS::MediaType::NAND, shared_font_archive_id_low);
+    const bool content_exists = FileUtil::Exists(content_path);
+    const std::array<u64, 3> font_source{
+        shared_font_archive_id_low,
+        content_exists ? FileUtil::GetSize(content_path) : 0,
+        content_exists ? static_cast<u64>(FileUtil::GetModificationTime(content_path)) : 0,
+    };
+    const u64 cache_key = Common::ComputeHash64(font_source.data(), sizeof(font_source));
+
+    const std::string cache_path =
+        FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + SHARED_FONT_CACHE;
+    FileUtil::CreateFullPath(cache_path);
+    Common::MappedDiskCache cache;
+    if (cache.Open(cache_path, SharedFontCacheVersion)) {
+        const auto cached_font = cache.Get(cache_key);
+        if (cached_font && cached_font->size() <= shared_font_mem->GetSize()) {
+            std::memcpy(shared_font_mem->GetPointer(), cached_font->data(), cached_font->size());
+            LOG_INFO(Service_APT, "Loaded the cached shared font");
+            return true;
+        }
+    }
+
     FileSys::NCCHArchive archive(shared_font_archive_id_low, Service::FS::MediaType::NAND);
     // 20-byte all zero path for opening RomFS
     const FileSys::Path file_path(std::vector<u8>(20, 0));
@@ -204,6 +237,10 @@ bool Module::LoadSharedFont() {
     std::memcpy(shared_font_mem->GetPointer(), &shared_font_header, sizeof(shared_font_header));
     *shared_font_mem->GetPointer(0x83) = 'U'; // Change the magic from "CFNT" to "CFNU"
 
+    if (cache.IsOpen()) {
+        const std::size_t font_size = 0x80 + shared_font_header.decompressed_size;
+        cache.Append(cache_key, {shared_font_mem->GetPointer(), font_size});
+    }
     return true;
 }
 
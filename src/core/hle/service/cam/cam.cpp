@@ -37,6 +37,7 @@ void Module::serialize(Archive& ar, const unsigned int file_version) {
     }
     if (Archive::is_loading::value && initialized) {
         for (int i = 0; i < NumCameras; i++) {
+            DiscardPrefetchedFrames(i);
             LoadCameraImplementation(cameras[i], i);
         }
         for (std::size_t i = 0; i < ports.size(); i++) {
@@ -162,6 +163,12 @@ void Module::CompletionEventCallBack(u64 port_id, s64) {
 
     port.is_receiving = false;
     port.completion_event->Signal();
+
+    // Captures the next frame while the game processes this one, so that the next receiving
+    // process only has to copy it
+    if (port.is_busy) {
+        LaunchCapture(static_cast<int>(port_id));
+    }
 }
 
 static constexpr std::size_t MaxVsyncTimings = 5;
@@ -189,6 +196,21 @@ void Module::StartReceiving(int port_id) {
     PortConfig& port = ports[port_id];
     port.is_receiving = true;
 
+    // uses the frame prefetched by the last receiving process if there is one
+    if (!port.capture_result.valid()) {
+        LaunchCapture(port_id);
+    }
+
+    // schedules a completion event according to the frame rate. The event will block on the
+    // capture task if it is not finished within the expected time
+    system.CoreTiming().ScheduleEvent(
+        msToCycles(LATENCY_BY_FRAME_RATE[static_cast<int>(cameras[port.camera_id].frame_rate)]),
+        completion_event_callback, port_id);
+}
+
+void Module::LaunchCapture(int port_id) {
+    PortConfig& port = ports[port_id];
+
     // launches a capture task asynchronously
     CameraConfig& camera = cameras[port.camera_id];
     port.capture_result = std::async(std::launch::async, [&camera, &port, this] {
@@ -200,12 +222,16 @@ void Module::StartReceiving(int port_id) {
         }
         return camera.impl->ReceiveFrame();
     });
+}
 
-    // schedules a completion event according to the frame rate. The event will block on the
-    // capture task if it is not finished within the expected time
-    system.CoreTiming().ScheduleEvent(
-        msToCycles(LATENCY_BY_FRAME_RATE[static_cast<int>(camera.frame_rate)]),
-        completion_event_callback, port_id);
+void Module::DiscardPrefetchedFrames(int camera_id) {
+    for (PortConfig& port : ports) {
+        // the capture of an ongoing receiving process is waited for by the completion event
+        if (port.camera_id == camera_id && !port.is_receiving && port.capture_result.valid()) {
+            port.capture_result.wait();
+            port.capture_result = {};
+        }
+    }
 }
 
 void Module::CancelReceiving(int port_id) {
@@ -220,6 +246,7 @@ void Module::CancelReceiving(int port_id) {
 void Module::ActivatePort(int port_id, int camera_id) {
     if (ports[port_id].is_busy && ports[port_id].camera_id != camera_id) {
         CancelReceiving(port_id);
+        DiscardPrefetchedFrames(ports[port_id].camera_id);
         cameras[ports[port_id].camera_id].impl->StopCapture();
         ports[port_id].is_busy = false;
     }
@@ -301,6 +328,7 @@ void Module::Interface::StopCapture(Kernel::HLERequestContext& ctx) {
         for (int i : port_select) {
             if (cam->ports[i].is_busy) {
                 cam->CancelReceiving(i);
+                cam->DiscardPrefetchedFrames(cam->ports[i].camera_id);
                 cam->cameras[cam->ports[i].camera_id].impl->StopCapture();
                 cam->ports[i].is_busy = false;
             } else {
@@ -682,6 +710,7 @@ void Module::Interface::Activate(Kernel::HLERequestContext& ctx) {
             for (int i = 0; i < 2; ++i) {
                 if (cam->ports[i].is_busy) {
                     cam->CancelReceiving(i);
+                    cam->DiscardPrefetchedFrames(cam->ports[i].camera_id);
                     cam->cameras[cam->ports[i].camera_id].impl->StopCapture();
                     cam->ports[i].is_busy = false;
                 }
@@ -721,6 +750,7 @@ void Module::Interface::SwitchContext(Kernel::HLERequestContext& ctx) {
     if (camera_select.IsValid() && context_select.IsSingle()) {
         int context = *context_select.begin();
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             cam->cameras[camera].current_context = context;
             const ContextConfig& context_config = cam->cameras[camera].contexts[context];
             cam->cameras[camera].impl->SetFlip(context_config.flip);
@@ -748,6 +778,7 @@ void Module::Interface::FlipImage(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     if (camera_select.IsValid() && context_select.IsValid()) {
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].flip = flip;
                 if (cam->cameras[camera].current_context == context) {
@@ -781,6 +812,7 @@ void Module::Interface::SetDetailSize(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     if (camera_select.IsValid() && context_select.IsValid()) {
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].resolution = resolution;
                 if (cam->cameras[camera].current_context == context) {
@@ -811,6 +843,7 @@ void Module::Interface::SetSize(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     if (camera_select.IsValid() && context_select.IsValid()) {
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].resolution = PRESET_RESOLUTION[size];
                 if (cam->cameras[camera].current_context == context) {
@@ -837,6 +870,7 @@ void Module::Interface::SetFrameRate(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     if (camera_select.IsValid()) {
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             cam->cameras[camera].frame_rate = frame_rate;
             cam->cameras[camera].impl->SetFrameRate(frame_rate);
         }
@@ -859,6 +893,7 @@ void Module::Interface::SetEffect(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     if (camera_select.IsValid() && context_select.IsValid()) {
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].effect = effect;
                 if (cam->cameras[camera].current_context == context) {
@@ -886,6 +921,7 @@ void Module::Interface::SetOutputFormat(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     if (camera_select.IsValid() && context_select.IsValid()) {
         for (int camera : camera_select) {
+            cam->DiscardPrefetchedFrames(camera);
             for (int context : context_select) {
                 cam->cameras[camera].contexts[context].format = format;
                 if (cam->cameras[camera].current_context == context) {
@@ -989,6 +1025,7 @@ ResultCode Module::SetPackageParameter(const PackageParameterType& package) {
 
     if (camera_select.IsValid() && context_select.IsValid()) {
         for (int camera_id : camera_select) {
+            DiscardPrefetchedFrames(camera_id);
             CameraConfig& camera = cameras[camera_id];
             for (int context_id : context_select) {
                 ContextConfig& context = camera.contexts[context_id];
@@ -1064,6 +1101,7 @@ void Module::Interface::DriverInitialize(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     for (int camera_id = 0; camera_id < NumCameras; ++camera_id) {
+        cam->DiscardPrefetchedFrames(camera_id);
         CameraConfig& camera = cam->cameras[camera_id];
         camera.current_context = 0;
         for (int context_id = 0; context_id < 2; ++context_id) {
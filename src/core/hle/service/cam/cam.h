@@ -643,6 +643,14 @@ private:
     // and is_receiving = false.
     void StartReceiving(int port_id);
 
+    // Launches the capture of a frame on the specified port. The result is used by the next
+    // completion event.
+    void LaunchCapture(int port_id);
+
+    // Waits for and drops the frames captured ahead of time with the specified camera. This needs
+    // to be called before the camera is stopped or reconfigured.
+    void DiscardPrefetchedFrames(int camera_id);
+
     // Cancels any ongoing receiving processes at the specified port. This is used by functions that
     // stop capturing.
     // TODO: what is the exact behaviour on real 3DS when stopping capture during an ongoing
@@ -721,7 +729,9 @@ private:
 
         std::deque<s64> vsync_timings;
 
-        std::future<std::vector<u16>> capture_result; // will hold the received frame.
+        // will hold the received frame. Outside of a receiving process, this is the next frame
+        // captured ahead of time.
+        std::future<std::vector<u16>> capture_result;
         Kernel::Process* dest_process{nullptr};
         VAddr dest{0};    // the destination address of the receiving process
         u32 dest_size{0}; // the destination size of the receiving process
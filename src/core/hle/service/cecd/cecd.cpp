@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unique_ptr.hpp>
 #include <cryptopp/base64.h>
@@ -38,6 +39,9 @@ void Module::serialize(Archive& ar, const unsigned int) {
     ar& cecd_system_save_data_archive;
     ar& cecinfo_event;
     ar& change_state_event;
+    if (Archive::is_loading::value) {
+        file_cache.clear();
+    }
 }
 SERIALIZE_IMPL(Module)
 
@@ -117,6 +121,7 @@ void Module::Interface::Open(Kernel::HLERequestContext& ctx) {
             std::memcpy(program_id.data(), &le_program_id, sizeof(u64));
             session_data->file->Write(0, sizeof(u64), true, program_id.data());
             session_data->file->Close();
+            cecd->InvalidateCachedFiles(path);
         }
     }
     }
@@ -373,6 +378,7 @@ void Module::Interface::Write(Kernel::HLERequestContext& ctx) {
         [[maybe_unused]] const u32 bytes_written = static_cast<u32>(
             session_data->file->Write(0, buffer.size(), true, buffer.data()).Unwrap());
         session_data->file->Close();
+        cecd->UpdateCachedFile(session_data->path, buffer);
 
         rb.Push(RESULT_SUCCESS);
     }
@@ -435,6 +441,8 @@ void Module::Interface::WriteMessage(Kernel::HLERequestContext& ctx) {
         [[maybe_unused]] const u32 bytes_written =
             static_cast<u32>(message->Write(0, buffer_size, true, buffer.data()).Unwrap());
         message->Close();
+        // The message isn't truncated, so its contents are read again when needed
+        cecd->InvalidateCachedFiles(message_path);
 
         rb.Push(RESULT_SUCCESS);
     } else {
@@ -522,6 +530,8 @@ void Module::Interface::WriteMessageWithHMAC(Kernel::HLERequestContext& ctx) {
         [[maybe_unused]] const u32 bytes_written =
             static_cast<u32>(message->Write(0, buffer_size, true, buffer.data()).Unwrap());
         message->Close();
+        // The message isn't truncated, so its contents are read again when needed
+        cecd->InvalidateCachedFiles(message_path);
 
         rb.Push(RESULT_SUCCESS);
     } else {
@@ -557,10 +567,12 @@ void Module::Interface::Delete(Kernel::HLERequestContext& ctx) {
     case CecDataPathType::MboxDir:
     case CecDataPathType::InboxDir:
     case CecDataPathType::OutboxDir:
+        cecd->InvalidateCachedFiles(path);
         rb.Push(cecd->cecd_system_save_data_archive->DeleteDirectoryRecursively(path));
         break;
     default: // If not directory, then it is a file
         if (message_id_size == 0) {
+            cecd->InvalidateCachedFiles(path);
             rb.Push(cecd->cecd_system_save_data_archive->DeleteFile(path));
         } else {
             std::vector<u8> id_buffer(message_id_size);
@@ -571,6 +583,7 @@ void Module::Interface::Delete(Kernel::HLERequestContext& ctx) {
                                                            : CecDataPathType::InboxMsg,
                                                  ncch_program_id, id_buffer)
                     .data();
+            cecd->InvalidateCachedFiles(message_path);
             rb.Push(cecd->cecd_system_save_data_archive->DeleteFile(message_path));
         }
     }
@@ -607,6 +620,7 @@ void Module::Interface::SetData(Kernel::HLERequestContext& ctx) {
 
             file->Write(0, buffer.size(), true, buffer.data());
             file->Close();
+            cecd->InvalidateCachedFiles(path);
         }
     }
 
@@ -764,6 +778,7 @@ void Module::Interface::OpenAndWrite(Kernel::HLERequestContext& ctx) {
             [[maybe_unused]] const u32 bytes_written =
                 static_cast<u32>(file->Write(0, buffer.size(), true, buffer.data()).Unwrap());
             file->Close();
+            cecd->UpdateCachedFile(path, buffer);
 
             rb.Push(RESULT_SUCCESS);
         } else {
@@ -806,15 +821,12 @@ void Module::Interface::OpenAndRead(Kernel::HLERequestContext& ctx) {
         rb.Push<u32>(0); // No entries read
         break;
     default: // If not directory, then it is a file
-        auto file_result = cecd->cecd_system_save_data_archive->OpenFile(path, mode);
-        if (file_result.Succeeded()) {
-            auto file = std::move(file_result).Unwrap();
+        if (const std::vector<u8>* contents = cecd->ReadCachedFile(path)) {
             std::vector<u8> buffer(buffer_size);
 
-            const u32 bytes_read =
-                static_cast<u32>(file->Read(0, buffer_size, buffer.data()).Unwrap());
+            const u32 bytes_read = std::min(buffer_size, static_cast<u32>(contents->size()));
+            std::memcpy(buffer.data(), contents->data(), bytes_read);
             write_buffer.Write(buffer.data(), 0, buffer_size);
-            file->Close();
 
             rb.Push(RESULT_SUCCESS);
             rb.Push<u32>(bytes_read);
@@ -1230,19 +1242,13 @@ void Module::CheckAndUpdateFile(const CecDataPathType path_type, const u32 ncch_
                      file_name)
                         .data());
 
-                FileSys::Mode mode;
-                mode.read_flag.Assign(1);
-
-                auto message_result = cecd_system_save_data_archive->OpenFile(message_path, mode);
-
-                auto message = std::move(message_result).Unwrap();
-                const u32 message_size = static_cast<u32>(message->GetSize());
-                std::vector<u8> buffer(message_size);
-
-                message->Read(0, message_size, buffer.data()).Unwrap();
-                message->Close();
+                const std::vector<u8>* message = ReadCachedFile(message_path);
+                if (message == nullptr || message->size() < sizeof(CecMessageHeader)) {
+                    LOG_ERROR(Service_CECD, "Failed to read message: {}", file_name);
+                    continue;
+                }
 
-                std::memcpy(&message_headers[outbox_info_header.message_num++], buffer.data(),
+                std::memcpy(&message_headers[outbox_info_header.message_num++], message->data(),
                             sizeof(CecMessageHeader));
             }
         }
@@ -1320,20 +1326,14 @@ void Module::CheckAndUpdateFile(const CecDataPathType path_type, const u32 ncch_
                      file_name)
                         .data());
 
-                FileSys::Mode mode;
-                mode.read_flag.Assign(1);
-
-                auto message_result = cecd_system_save_data_archive->OpenFile(message_path, mode);
-
-                auto message = std::move(message_result).Unwrap();
-                const u32 message_size = static_cast<u32>(message->GetSize());
-                std::vector<u8> buffer(message_size);
-
-                message->Read(0, message_size, buffer.data()).Unwrap();
-                message->Close();
+                const std::vector<u8>* message = ReadCachedFile(message_path);
+                if (message == nullptr || message->size() < sizeof(CecMessageHeader)) {
+                    LOG_ERROR(Service_CECD, "Failed to read message: {}", file_name);
+                    continue;
+                }
 
                 // Message id is at offset 0x20, and is 8 bytes
-                std::memcpy(&message_ids[obindex_header.message_num++], buffer.data() + 0x20, 8);
+                std::memcpy(&message_ids[obindex_header.message_num++], message->data() + 0x20, 8);
             }
         }
 
@@ -1371,6 +1371,42 @@ Module::SessionData::~SessionData() {
         file->Close();
 }
 
+const std::vector<u8>* Module::ReadCachedFile(const FileSys::Path& path) {
+    const std::string key = path.AsString();
+    if (const auto it = file_cache.find(key); it != file_cache.end()) {
+        return &it->second;
+    }
+
+    FileSys::Mode mode;
+    mode.read_flag.Assign(1);
+    auto file_result = cecd_system_save_data_archive->OpenFile(path, mode);
+    if (file_result.Failed()) {
+        return nullptr;
+    }
+    auto file = std::move(file_result).Unwrap();
+    std::vector<u8> contents(file->GetSize());
+    const auto read_result = file->Read(0, contents.size(), contents.data());
+    file->Close();
+    if (read_result.Failed()) {
+        return nullptr;
+    }
+    contents.resize(*read_result);
+    return &(file_cache[key] = std::move(contents));
+}
+
+void Module::UpdateCachedFile(const FileSys::Path& path, const std::vector<u8>& contents) {
+    file_cache[path.AsString()] = contents;
+}
+
+void Module::InvalidateCachedFiles(const FileSys::Path& path) {
+    const std::string prefix = path.AsString();
+    std::erase_if(file_cache, [&prefix](const auto& entry) {
+        const std::string& key = entry.first;
+        return key.starts_with(prefix) &&
+               (key.size() == prefix.size() || key[prefix.size()] == '/' || prefix.ends_with('/'));
+    });
+}
+
 Module::Interface::Interface(std::shared_ptr<Module> cecd, const char* name, u32 max_session)
     : ServiceFramework(name, max_session), cecd(std::move(cecd)) {}
 
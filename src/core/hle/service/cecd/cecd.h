@@ -5,6 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "common/bit_field.h"
 #include "common/common_funcs.h"
 #include "core/hle/kernel/event.h"
@@ -620,8 +623,24 @@ private:
     void CheckAndUpdateFile(const CecDataPathType path_type, const u32 ncch_program_id,
                             std::vector<u8>& file_buffer);
 
+    /**
+     * Returns the contents of a file in the system save data, reading it only the first time.
+     * @return nullptr if the file can't be opened
+     */
+    const std::vector<u8>* ReadCachedFile(const FileSys::Path& path);
+
+    /// Records the contents of a file that has been written completely
+    void UpdateCachedFile(const FileSys::Path& path, const std::vector<u8>& contents);
+
+    /// Forgets the cached contents of a file, or of every file in a directory
+    void InvalidateCachedFiles(const FileSys::Path& path);
+
     std::unique_ptr<FileSys::ArchiveBackend> cecd_system_save_data_archive;
 
+    /// The contents of the files that were read, by path. The titles polling cecd read the box
+    /// info files over and over, while they're only changed through cecd itself.
+    std::unordered_map<std::string, std::vector<u8>> file_cache;
+
     std::shared_ptr<Kernel::Event> cecinfo_event;
     std::shared_ptr<Kernel::Event> change_state_event;
 
@@ -2,7 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <future>
 #include <boost/serialization/unique_ptr.hpp>
+#include <boost/serialization/vector.hpp>
 #include "common/archives.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -24,9 +26,65 @@ template <class Archive>
 void File::serialize(Archive& ar, const unsigned int) {
     ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
     ar& path;
+    std::scoped_lock lock{backend_mutex};
     ar& backend;
 }
 
+/// Completes a read that ran on a host thread once the client thread wakes up
+class File::ReadCallback : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    explicit ReadCallback(u32 length) : data(length) {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) override {
+        Wait();
+
+        IPC::RequestParser rp(ctx, 0x0802, 3, 2);
+        rp.Skip(3, false);
+        auto& buffer = rp.PopMappedBuffer();
+        if (code.IsSuccess() && !data.empty()) {
+            buffer.Write(data.data(), 0, read_size);
+        }
+
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+        rb.Push(code);
+        rb.Push<u32>(read_size);
+        rb.PushMappedBuffer(buffer);
+    }
+
+    /// Intermediate buffer, used when the guest buffer isn't contiguous in host memory
+    std::vector<u8> data;
+    std::future<ResultVal<std::size_t>> result;
+
+private:
+    ReadCallback() = default;
+
+    /// Waits for the host thread, which only blocks when the host is slower than the guest
+    void Wait() {
+        if (!result.valid()) {
+            return;
+        }
+        const ResultVal<std::size_t> read = result.get();
+        code = read.Code();
+        read_size = read.Succeeded() ? static_cast<u32>(*read) : 0;
+    }
+
+    ResultCode code = RESULT_SUCCESS;
+    u32 read_size = 0;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        if (Archive::is_saving::value) {
+            Wait();
+        }
+        ar& data;
+        ar& code.raw;
+        ar& read_size;
+    }
+    friend class boost::serialization::access;
+};
+
 File::File() : File(Core::Global<Kernel::KernelSystem>()) {}
 
 File::File(Kernel::KernelSystem& kernel, std::unique_ptr<FileSys::FileBackend>&& backend,
@@ -70,27 +128,54 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
 
+    std::unique_lock lock{backend_mutex};
     if (offset + length > backend->GetSize()) {
         LOG_ERROR(Service_FS,
                   "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
                   offset, length, backend->GetSize());
     }
 
+    // Read straight into the guest buffer when possible, large reads are common
+    const std::span<u8> view =
+        length <= buffer.GetSize() ? buffer.GetSpan(0, length) : std::span<u8>{};
+    const std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+
+    if (length >= MIN_ASYNC_READ_SIZE && read_timeout_ns.count() > 0) {
+        lock.unlock();
+
+        // The client thread sleeps for the modeled read delay anyway, so the host read can run on
+        // another thread meanwhile instead of stalling the emulation. The guest observes the same
+        // timing either way.
+        auto callback = std::make_shared<ReadCallback>(view.empty() ? length : 0);
+        u8* const dest = view.empty() ? callback->data.data() : view.data();
+        callback->result = std::async(
+            std::launch::async, [self = std::static_pointer_cast<File>(shared_from_this()),
+                                 offset, length, dest]() -> ResultVal<std::size_t> {
+                std::scoped_lock lock{self->backend_mutex};
+                return self->backend->Read(offset, length, dest);
+            });
+        ctx.SleepClientThread("file::read", read_timeout_ns, std::move(callback));
+        return;
+    }
+
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
 
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
+    std::vector<u8> data(view.empty() ? length : 0);
+    u8* const dest = view.empty() ? data.data() : view.data();
+    ResultVal<std::size_t> read = backend->Read(offset, length, dest);
+    lock.unlock();
     if (read.Failed()) {
         rb.Push(read.Code());
         rb.Push<u32>(0);
     } else {
-        buffer.Write(data.data(), 0, *read);
+        if (view.empty()) {
+            buffer.Write(data.data(), 0, *read);
+        }
         rb.Push(RESULT_SUCCESS);
         rb.Push<u32>(static_cast<u32>(*read));
     }
     rb.PushMappedBuffer(buffer);
 
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
     ctx.SleepClientThread("file::read", read_timeout_ns, nullptr);
 }
 
@@ -115,12 +200,19 @@ void File::Write(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
+    const std::span<u8> view = buffer.GetSpan(0, length);
+    std::vector<u8> data;
+    if (view.empty()) {
+        data.resize(length);
+        buffer.Read(data.data(), 0, data.size());
+    }
+    const u8* const src = view.empty() ? data.data() : view.data();
+    std::unique_lock lock{backend_mutex};
+    ResultVal<std::size_t> written = backend->Write(offset, length, flush != 0, src);
 
     // Update file size
     file->size = backend->GetSize();
+    lock.unlock();
 
     if (written.Failed()) {
         rb.Push(written.Code());
@@ -157,6 +249,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
     }
 
     file->size = size;
+    std::scoped_lock lock{backend_mutex};
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
 }
@@ -169,6 +262,7 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
 
+    std::scoped_lock lock{backend_mutex};
     backend->Close();
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -187,6 +281,7 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    std::scoped_lock lock{backend_mutex};
     backend->Flush();
     rb.Push(RESULT_SUCCESS);
 }
@@ -224,7 +319,10 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
 
     slot->priority = original_file->priority;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    {
+        std::scoped_lock lock{backend_mutex};
+        slot->size = backend->GetSize();
+    }
     slot->subfile = false;
 
     rb.Push(RESULT_SUCCESS);
@@ -282,7 +380,10 @@ std::shared_ptr<Kernel::ClientSession> File::Connect() {
     FileSessionSlot* slot = GetSessionData(std::move(server));
     slot->priority = 0;
     slot->offset = 0;
-    slot->size = backend->GetSize();
+    {
+        std::scoped_lock lock{backend_mutex};
+        slot->size = backend->GetSize();
+    }
     slot->subfile = false;
 
     return client;
@@ -301,3 +402,5 @@ std::size_t File::GetSessionFileSize(std::shared_ptr<Kernel::ServerSession> sess
 }
 
 } // namespace Service::FS
+
+SERIALIZE_EXPORT_IMPL(Service::FS::File::ReadCallback)
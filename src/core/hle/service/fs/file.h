@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <boost/serialization/base_object.hpp>
 #include "core/file_sys/archive_backend.h"
 #include "core/global.h"
@@ -49,6 +50,7 @@ public:
 
     FileSys::Path path;                            ///< Path of the file
     std::unique_ptr<FileSys::FileBackend> backend; ///< File backend interface
+    std::mutex backend_mutex; ///< Held while using the backend, as reads can run on host threads
 
     /// Creates a new session to this File and returns the ClientSession part of the connection.
     std::shared_ptr<Kernel::ClientSession> Connect();
@@ -61,7 +63,12 @@ public:
     // OpenSubFile.
     std::size_t GetSessionFileSize(std::shared_ptr<Kernel::ServerSession> session);
 
+    class ReadCallback;
+
 private:
+    /// Minimum size of the reads performed on a host thread while the client thread sleeps
+    static constexpr u32 MIN_ASYNC_READ_SIZE = 16 * 1024;
+
     void Read(Kernel::HLERequestContext& ctx);
     void Write(Kernel::HLERequestContext& ctx);
     void GetSize(Kernel::HLERequestContext& ctx);
@@ -87,3 +94,4 @@ private:
 
 BOOST_CLASS_EXPORT_KEY(Service::FS::FileSessionSlot)
 BOOST_CLASS_EXPORT_KEY(Service::FS::File)
+BOOST_CLASS_EXPORT_KEY(Service::FS::File::ReadCallback)
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <optional>
 #include <vector>
 #include "common/archives.h"
 #include "common/bit_field.h"
@@ -451,9 +452,31 @@ void GSP_GPU::SignalInterruptForThread(InterruptId interrupt_id, u32 thread_id)
             info->is_dirty.Assign(false);
         }
     }
+
+    // While a command queue is being drained the guest can't observe the event, so it is signaled
+    // once for all the interrupts of the batch instead of waking the thread for each of them.
+    if (defer_interrupt_events) {
+        pending_interrupt_events[thread_id] = true;
+        return;
+    }
     interrupt_event->Signal();
 }
 
+void GSP_GPU::SignalPendingInterruptEvents() {
+    for (u32 thread_id = 0; thread_id < MaxGSPThreads; ++thread_id) {
+        if (!pending_interrupt_events[thread_id]) {
+            continue;
+        }
+        pending_interrupt_events[thread_id] = false;
+
+        // The session may have unregistered its relay queue while the batch was processed
+        SessionData* session_data = FindRegisteredThreadData(thread_id);
+        if (session_data != nullptr && session_data->interrupt_event != nullptr) {
+            session_data->interrupt_event->Signal();
+        }
+    }
+}
+
 /**
  * Signals that the specified interrupt type has occurred to userland code
  * @param interrupt_id ID of interrupt that is being signalled
@@ -485,6 +508,31 @@ void GSP_GPU::SignalInterrupt(InterruptId interrupt_id) {
 }
 
 MICROPROFILE_DEFINE(GPU_GSP_DMA, "GPU", "GSP DMA", MP_RGB(100, 0, 255));
+MICROPROFILE_DEFINE(GPU_GSP_CmdList, "GPU", "GSP Submit Command List", MP_RGB(100, 50, 255));
+MICROPROFILE_DEFINE(GPU_GSP_MemoryFill, "GPU", "GSP Memory Fill", MP_RGB(100, 100, 255));
+MICROPROFILE_DEFINE(GPU_GSP_DisplayTransfer, "GPU", "GSP Display Transfer", MP_RGB(100, 150, 255));
+MICROPROFILE_DEFINE(GPU_GSP_TextureCopy, "GPU", "GSP Texture Copy", MP_RGB(100, 200, 255));
+MICROPROFILE_DEFINE(GPU_GSP_CommandQueue, "GPU", "GSP Command Queue", MP_RGB(50, 0, 255));
+
+/**
+ * Returns the physical address of a virtual memory range if it lies entirely within one of the
+ * regions that are physically contiguous (VRAM and the linear heaps).
+ */
+static std::optional<PAddr> GetContiguousPhysicalAddress(VAddr addr, u32 size) {
+    const auto in_region = [addr, size](VAddr region_start, VAddr region_end) {
+        return addr >= region_start && addr <= region_end && size <= region_end - addr;
+    };
+    if (in_region(Memory::VRAM_VADDR, Memory::VRAM_VADDR_END)) {
+        return addr - Memory::VRAM_VADDR + Memory::VRAM_PADDR;
+    }
+    if (in_region(Memory::LINEAR_HEAP_VADDR, Memory::LINEAR_HEAP_VADDR_END)) {
+        return addr - Memory::LINEAR_HEAP_VADDR + Memory::FCRAM_PADDR;
+    }
+    if (in_region(Memory::NEW_LINEAR_HEAP_VADDR, Memory::NEW_LINEAR_HEAP_VADDR_END)) {
+        return addr - Memory::NEW_LINEAR_HEAP_VADDR + Memory::FCRAM_PADDR;
+    }
+    return std::nullopt;
+}
 
 /// Executes the next GSP command
 static void ExecuteCommand(const Command& command, u32 thread_id) {
@@ -498,26 +546,36 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
     // GX request DMA - typically used for copying memory from GSP heap to VRAM
     case CommandId::REQUEST_DMA: {
         MICROPROFILE_SCOPE(GPU_GSP_DMA);
+        const auto& dma = command.dma_request;
+
+        // Copies between physically contiguous regions stay on the GPU if the data is cached, so
+        // that render-to-texture results don't round-trip through guest memory
+        const auto src_addr = GetContiguousPhysicalAddress(dma.source_address, dma.size);
+        const auto dst_addr = GetContiguousPhysicalAddress(dma.dest_address, dma.size);
+        if (src_addr && dst_addr && dma.size != 0 && dma.size % 16 == 0 &&
+            (*src_addr | *dst_addr) % 8 == 0) {
+            GPU::CopyBlock(*src_addr, *dst_addr, dma.size);
+            SignalInterrupt(InterruptId::DMA);
+            break;
+        }
+
         Memory::MemorySystem& memory = Core::System::GetInstance().Memory();
 
-        // TODO: Consider attempting rasterizer-accelerated surface blit if that usage is ever
-        // possible/likely
-        Memory::RasterizerFlushVirtualRegion(command.dma_request.source_address,
-                                             command.dma_request.size, Memory::FlushMode::Flush);
-        Memory::RasterizerFlushVirtualRegion(command.dma_request.dest_address,
-                                             command.dma_request.size,
+        Memory::RasterizerFlushVirtualRegion(dma.source_address, dma.size,
+                                             Memory::FlushMode::Flush);
+        Memory::RasterizerFlushVirtualRegion(dma.dest_address, dma.size,
                                              Memory::FlushMode::Invalidate);
 
         // TODO(Subv): These memory accesses should not go through the application's memory mapping.
         // They should go through the GSP module's memory mapping.
         memory.CopyBlock(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
-                         command.dma_request.dest_address, command.dma_request.source_address,
-                         command.dma_request.size);
+                         dma.dest_address, dma.source_address, dma.size);
         SignalInterrupt(InterruptId::DMA);
         break;
     }
     // TODO: This will need some rework in the future. (why?)
     case CommandId::SUBMIT_GPU_CMDLIST: {
+        MICROPROFILE_SCOPE(GPU_GSP_CmdList);
         auto& params = command.submit_gpu_cmdlist;
 
         if (params.do_flush) {
@@ -543,6 +601,7 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
     // It's assumed that the two "blocks" behave equivalently.
     // Presumably this is done simply to allow two memory fills to run in parallel.
     case CommandId::SET_MEMORY_FILL: {
+        MICROPROFILE_SCOPE(GPU_GSP_MemoryFill);
         auto& params = command.memory_fill;
 
         if (params.start1 != 0) {
@@ -570,6 +629,7 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
     }
 
     case CommandId::SET_DISPLAY_TRANSFER: {
+        MICROPROFILE_SCOPE(GPU_GSP_DisplayTransfer);
         auto& params = command.display_transfer;
         WriteGPURegister(static_cast<u32>(GPU_REG_INDEX(display_transfer_config.input_address)),
                          VirtualToPhysicalAddress(params.in_buffer_address) >> 3);
@@ -586,6 +646,7 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
     }
 
     case CommandId::SET_TEXTURE_COPY: {
+        MICROPROFILE_SCOPE(GPU_GSP_TextureCopy);
         auto& params = command.texture_copy;
         WriteGPURegister((u32)GPU_REG_INDEX(display_transfer_config.input_address),
                          VirtualToPhysicalAddress(params.in_buffer_address) >> 3);
@@ -640,22 +701,31 @@ void GSP_GPU::SetLcdForceBlack(Kernel::HLERequestContext& ctx) {
 void GSP_GPU::TriggerCmdReqQueue(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0xC, 0, 0);
 
-    // Iterate through each thread's command queue...
-    for (unsigned thread_id = 0; thread_id < 0x4; ++thread_id) {
-        CommandBuffer* command_buffer = (CommandBuffer*)GetCommandBuffer(shared_memory, thread_id);
+    MICROPROFILE_SCOPE(GPU_GSP_CommandQueue);
+    defer_interrupt_events = true;
 
-        // Iterate through each command...
-        for (unsigned i = 0; i < command_buffer->number_commands; ++i) {
-            g_debugger.GXCommandProcessed((u8*)&command_buffer->commands[i]);
+    // Drain each thread's command queue, starting from the command after the last processed one
+    for (u32 thread_id = 0; thread_id < MaxGSPThreads; ++thread_id) {
+        CommandBuffer* command_buffer = (CommandBuffer*)GetCommandBuffer(shared_memory, thread_id);
+        const u32 num_slots = static_cast<u32>(std::size(command_buffer->commands));
 
-            // Decode and execute command
-            ExecuteCommand(command_buffer->commands[i], thread_id);
+        while (command_buffer->number_commands != 0) {
+            const u32 index = command_buffer->index % num_slots;
+            const Command& command = command_buffer->commands[index];
+            g_debugger.GXCommandProcessed((u8*)&command);
 
-            // Indicates that command has completed
+            // The index is updated right before the command is processed
+            command_buffer->index.Assign((index + 1) % num_slots);
             command_buffer->number_commands.Assign(command_buffer->number_commands - 1);
+
+            // Decode and execute command
+            ExecuteCommand(command, thread_id);
         }
     }
 
+    defer_interrupt_events = false;
+    SignalPendingInterruptEvents();
+
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
 }
@@ -247,6 +247,9 @@ private:
      */
     void SignalInterruptForThread(InterruptId interrupt_id, u32 thread_id);
 
+    /// Signals the events of the threads that received interrupts while they were deferred
+    void SignalPendingInterruptEvents();
+
     /**
      * GSP_GPU::WriteHWRegs service function
      *
@@ -444,6 +447,13 @@ private:
     /// Thread ids currently in use by the sessions connected to the GSPGPU service.
     std::array<bool, MaxGSPThreads> used_thread_ids = {false, false, false, false};
 
+    /// Whether interrupt events are signaled once at the end of the current command batch.
+    /// Only set during TriggerCmdReqQueue, so it isn't serialized.
+    bool defer_interrupt_events = false;
+
+    /// Threads that received interrupts while their events were deferred
+    std::array<bool, MaxGSPThreads> pending_interrupt_events{};
+
     friend class SessionData;
 
     template <class Archive>
@@ -44,7 +44,8 @@ void Module::serialize(Archive& ar, const unsigned int file_version) {
     ar& enable_accelerometer_count;
     ar& enable_gyroscope_count;
     if (Archive::is_loading::value) {
-        LoadInputDevices();
+        // The devices are reloaded by whichever thread owns them
+        is_device_reload_pending.store(true);
     }
     if (file_version >= 1) {
         ar& state.hex;
@@ -92,6 +93,8 @@ void Module::LoadInputDevices() {
                    Settings::values.current_input_profile.buttons.begin() +
                        Settings::NativeButton::BUTTON_HID_END,
                    buttons.begin(), Input::CreateDevice<Input::ButtonDevice>);
+    std::transform(buttons.begin(), buttons.end(), button_readers.begin(),
+                   [](const auto& button) { return Input::ButtonReader{*button}; });
     circle_pad = Input::CreateDevice<Input::AnalogDevice>(
         Settings::values.current_input_profile.analogs[Settings::NativeAnalog::CirclePad]);
     motion_device = Input::CreateDevice<Input::MotionDevice>(
@@ -105,11 +108,67 @@ void Module::LoadInputDevices() {
     }
 }
 
-void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
-    SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
+void Module::SamplePadDevices(InputSnapshot& snapshot) {
+    std::transform(button_readers.begin(), button_readers.end(), snapshot.buttons.begin(),
+                   [](const Input::ButtonReader& reader) { return reader.GetStatus(); });
+    std::tie(snapshot.circle_pad_x, snapshot.circle_pad_y) = circle_pad->GetStatus();
+    std::tie(snapshot.touch_x, snapshot.touch_y, snapshot.touch_pressed) =
+        touch_device->GetStatus();
+    if (!snapshot.touch_pressed && touch_btn_device) {
+        std::tie(snapshot.touch_x, snapshot.touch_y, snapshot.touch_pressed) =
+            touch_btn_device->GetStatus();
+    }
+}
+
+void Module::SampleMotionDevice(InputSnapshot& snapshot) {
+    std::tie(snapshot.accel, snapshot.gyro) = motion_device->GetStatus();
+}
 
-    if (is_device_reload_pending.exchange(false))
+const InputSnapshot& Module::GetPadInput() {
+    if (input_thread.joinable()) {
+        return input_snapshots.Read();
+    }
+    if (is_device_reload_pending.exchange(false)) {
         LoadInputDevices();
+    }
+    SamplePadDevices(polled_input);
+    return polled_input;
+}
+
+const InputSnapshot& Module::GetMotionInput() {
+    if (input_thread.joinable()) {
+        return input_snapshots.Read();
+    }
+    if (is_device_reload_pending.exchange(false)) {
+        LoadInputDevices();
+    }
+    SampleMotionDevice(polled_input);
+    return polled_input;
+}
+
+void Module::InputThreadLoop(u32 polling_rate) {
+    Common::SetCurrentThreadName("HID Input");
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+
+    const auto period = std::chrono::nanoseconds{std::chrono::seconds{1}} / polling_rate;
+    auto next_sample = std::chrono::steady_clock::now();
+    do {
+        if (is_device_reload_pending.exchange(false)) {
+            LoadInputDevices();
+        }
+        InputSnapshot& snapshot = input_snapshots.WriteBuffer();
+        SamplePadDevices(snapshot);
+        SampleMotionDevice(snapshot);
+        input_snapshots.Publish();
+
+        // Don't try to catch up on samples that were missed, e.g. while the host was suspended
+        next_sample = std::max(next_sample + period, std::chrono::steady_clock::now());
+    } while (!stop_input_thread.WaitUntil(next_sample));
+}
+
+void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
+    SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
+    const InputSnapshot& input = GetPadInput();
 
     static std::unique_ptr<CTroll3D::CTroll3DInterface> ctroll3d = CTroll3D::CreateCTroll3D("ctroll3d");
     if (!ctroll3d) {
@@ -119,22 +178,22 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
     }
 
     using namespace Settings::NativeButton;
-    state.a.Assign(buttons[A - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 1));
-    state.b.Assign(buttons[B - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 2));
-    state.x.Assign(buttons[X - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 4));
-    state.y.Assign(buttons[Y - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 8));
-    state.right.Assign(buttons[Right - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 16));
-    state.left.Assign(buttons[Left - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 32));
-    state.up.Assign(buttons[Up - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 64));
-    state.down.Assign(buttons[Down - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 128));
-    state.l.Assign(buttons[L - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 256));
-    state.r.Assign(buttons[R - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 512));
-    state.start.Assign(buttons[Start - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 1024));
-    state.select.Assign(buttons[Select - BUTTON_HID_BEGIN]->GetStatus() || (ctroll3dInfo.pressedButtons & 2048));
+    state.a.Assign(input.buttons[A - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 1));
+    state.b.Assign(input.buttons[B - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 2));
+    state.x.Assign(input.buttons[X - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 4));
+    state.y.Assign(input.buttons[Y - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 8));
+    state.right.Assign(input.buttons[Right - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 16));
+    state.left.Assign(input.buttons[Left - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 32));
+    state.up.Assign(input.buttons[Up - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 64));
+    state.down.Assign(input.buttons[Down - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 128));
+    state.l.Assign(input.buttons[L - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 256));
+    state.r.Assign(input.buttons[R - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 512));
+    state.start.Assign(input.buttons[Start - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 1024));
+    state.select.Assign(input.buttons[Select - BUTTON_HID_BEGIN] || (ctroll3dInfo.pressedButtons & 2048));
 
     // Get current circle pad position and update circle pad direction
-    float circle_pad_x_f, circle_pad_y_f;
-    std::tie(circle_pad_x_f, circle_pad_y_f) = circle_pad->GetStatus();
+    const float circle_pad_x_f = input.circle_pad_x;
+    const float circle_pad_y_f = input.circle_pad_y;
 
     // xperia64: 0x9A seems to be the calibrated limit of the circle pad
     // Verified by using Input Redirector with very large-value digital inputs
@@ -195,14 +254,11 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
 
     // Get the current touch entry
     TouchDataEntry& touch_entry = mem->touch.entries[mem->touch.index];
-    bool pressed = false;
-    float x, y;
-    std::tie(x, y, pressed) = touch_device->GetStatus();
-    if (!pressed && touch_btn_device) {
-        std::tie(x, y, pressed) = touch_btn_device->GetStatus();
-    }
-    touch_entry.x = ctroll3dInfo.touchX + static_cast<u16>(x * Core::kScreenBottomWidth);
-    touch_entry.y = ctroll3dInfo.touchY + static_cast<u16>(y * Core::kScreenBottomHeight);
+    bool pressed = input.touch_pressed;
+    touch_entry.x =
+        ctroll3dInfo.touchX + static_cast<u16>(input.touch_x * Core::kScreenBottomWidth);
+    touch_entry.y =
+        ctroll3dInfo.touchY + static_cast<u16>(input.touch_y * Core::kScreenBottomHeight);
     pressed |= (ctroll3dInfo.touchX != 0) || (ctroll3dInfo.touchY != 0);
     touch_entry.valid.Assign(pressed ? 1 : 0);
 
@@ -238,8 +294,7 @@ void Module::UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_la
     mem->accelerometer.index = next_accelerometer_index;
     next_accelerometer_index = (next_accelerometer_index + 1) % mem->accelerometer.entries.size();
 
-    Common::Vec3<float> accel;
-    std::tie(accel, std::ignore) = motion_device->GetStatus();
+    Common::Vec3<float> accel = GetMotionInput().accel;
     accel *= accelerometer_coef;
     // TODO(wwylele): do a time stretch like the one in UpdateGyroscopeCallback
     // The time stretch formula should be like
@@ -285,8 +340,7 @@ void Module::UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late)
 
     GyroscopeDataEntry& gyroscope_entry = mem->gyroscope.entries[mem->gyroscope.index];
 
-    Common::Vec3<float> gyro;
-    std::tie(std::ignore, gyro) = motion_device->GetStatus();
+    Common::Vec3<float> gyro = GetMotionInput().gyro;
     double stretch = system.perf_stats->GetLastFrameTimeScale();
     gyro *= gyroscope_coef * static_cast<float>(stretch);
     gyroscope_entry.x = ctroll3dInfo.gyroX + static_cast<s16>(gyro.x);
@@ -459,6 +513,18 @@ Module::Module(Core::System& system) : system(system) {
         });
 
     timing.ScheduleEvent(pad_update_ticks, pad_update_event);
+
+    if (const u32 polling_rate = Settings::values.input_polling_rate.GetValue();
+        polling_rate != 0) {
+        input_thread = std::thread{[this, polling_rate] { InputThreadLoop(polling_rate); }};
+    }
+}
+
+Module::~Module() {
+    if (input_thread.joinable()) {
+        stop_input_thread.Set();
+        input_thread.join();
+    }
 }
 
 void Module::ReloadInputDevices() {
@@ -8,12 +8,15 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <boost/serialization/version.hpp>
 #include "common/bit_field.h"
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "common/settings.h"
+#include "common/thread.h"
+#include "common/triple_buffer.h"
 #include "core/core_timing.h"
 #include "core/frontend/input.h"
 #include "core/frontend/ctroll3d/interface.h"
@@ -201,9 +204,22 @@ struct DirectionState {
 /// Translates analog stick axes to directions. This is exposed for ir_rst module to use.
 DirectionState GetStickDirectionState(s16 circle_pad_x, s16 circle_pad_y);
 
+/// Status of the input devices read by the HID module, as sampled at one point in time
+struct InputSnapshot {
+    std::array<bool, Settings::NativeButton::NUM_BUTTONS_HID> buttons{};
+    float circle_pad_x = 0.0f;
+    float circle_pad_y = 0.0f;
+    float touch_x = 0.0f;
+    float touch_y = 0.0f;
+    bool touch_pressed = false;
+    Common::Vec3<float> accel{};
+    Common::Vec3<float> gyro{};
+};
+
 class Module final {
 public:
     explicit Module(Core::System& system);
+    ~Module();
 
     class Interface : public ServiceFramework<Interface> {
     public:
@@ -312,6 +328,20 @@ private:
     void CheckCTroll3D(CTroll3DInfo *info);
 
     void LoadInputDevices();
+
+    /// Reads the buttons, circle pad and touch screen into the snapshot
+    void SamplePadDevices(InputSnapshot& snapshot);
+    /// Reads the accelerometer and gyroscope into the snapshot
+    void SampleMotionDevice(InputSnapshot& snapshot);
+
+    /// Returns the latest pad and touch status, from the input thread if it is running
+    const InputSnapshot& GetPadInput();
+    /// Returns the latest motion status, from the input thread if it is running
+    const InputSnapshot& GetMotionInput();
+
+    /// Samples all the input devices at the configured rate until the thread is stopped
+    void InputThreadLoop(u32 polling_rate);
+
     void UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late);
@@ -355,10 +385,19 @@ private:
     std::atomic<bool> is_device_reload_pending{true};
     std::array<std::unique_ptr<Input::ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID>
         buttons;
+    /// Polls the buttons, rebuilt along with them
+    std::array<Input::ButtonReader, Settings::NativeButton::NUM_BUTTONS_HID> button_readers;
     std::unique_ptr<Input::AnalogDevice> circle_pad;
     std::unique_ptr<Input::MotionDevice> motion_device;
     std::unique_ptr<Input::TouchDevice> touch_device;
     std::unique_ptr<Input::TouchDevice> touch_btn_device;
+
+    /// When the input thread is running, it owns the devices and publishes their status here
+    Common::TripleBuffer<InputSnapshot> input_snapshots;
+    /// Status read on the emulation thread when there is no input thread
+    InputSnapshot polled_input;
+    Common::Event stop_input_thread;
+    std::thread input_thread;
     
     CTroll3DInfo ctroll3dInfo = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     
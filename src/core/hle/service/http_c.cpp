@@ -2,15 +2,18 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
 #include "common/assert.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/file_sys/archive_ncch.h"
 #include "core/file_sys/file_backend.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/event.h"
 #include "core/hle/kernel/ipc.h"
 #include "core/hle/romfs.h"
 #include "core/hle/service/fs/archive.h"
@@ -53,15 +56,43 @@ const ResultCode ERROR_WRONG_CERT_HANDLE = // 0xD8A0A0C9
     ResultCode(201, ErrorModule::HTTP, ErrorSummary::InvalidState, ErrorLevel::Permanent);
 const ResultCode ERROR_CERT_ALREADY_SET = // 0xD8A0A03D
     ResultCode(61, ErrorModule::HTTP, ErrorSummary::InvalidState, ErrorLevel::Permanent);
+const ResultCode ERROR_CONTEXT_NOT_FOUND =
+    ResultCode(ErrCodes::ContextNotFound, ErrorModule::HTTP, ErrorSummary::InvalidState,
+               ErrorLevel::Permanent);
+const ResultCode ERROR_INVALID_REQUEST_STATE =
+    ResultCode(ErrCodes::InvalidRequestState, ErrorModule::HTTP, ErrorSummary::InvalidState,
+               ErrorLevel::Permanent);
+const ResultCode ERROR_DOWNLOAD_PENDING = // 0xD840A02B
+    ResultCode(43, ErrorModule::HTTP, ErrorSummary::WouldBlock, ErrorLevel::Permanent);
+const ResultCode ERROR_TIMEOUT = // 0xD820A069
+    ResultCode(105, ErrorModule::HTTP, ErrorSummary::NothingHappened, ErrorLevel::Permanent);
 
-void Context::MakeRequest() {
-    ASSERT(state == RequestState::NotStarted);
+/// Interval at which the responses of the sleeping threads are checked
+constexpr int REQUEST_POLL_INTERVAL_MS = 1;
 
 #ifdef ENABLE_WEB_SERVICE
-    std::unique_ptr<httplib::Client> client = std::make_unique<httplib::Client>(url.c_str());
-    SSL_CTX* ctx = client->ssl_context();
+static std::string PoolKey(const std::string& server,
+                           const std::shared_ptr<ClientCertContext>& client_cert) {
+    return fmt::format("{} {}", server, client_cert ? client_cert->handle : 0);
+}
+
+std::unique_ptr<httplib::Client> ConnectionPool::Acquire(
+    const std::string& server, const std::shared_ptr<ClientCertContext>& client_cert) {
+    {
+        std::scoped_lock lock{mutex};
+        auto& idle = idle_clients[PoolKey(server, client_cert)];
+        if (!idle.empty()) {
+            std::unique_ptr<httplib::Client> client = std::move(idle.back());
+            idle.pop_back();
+            return client;
+        }
+    }
+
+    auto client = std::make_unique<httplib::Client>(server);
+    client->set_keep_alive(true);
+    SSL_CTX* ctx = client->is_valid() ? client->ssl_context() : nullptr;
     if (ctx) {
-        if (auto client_cert = ssl_config.client_cert_ctx.lock()) {
+        if (client_cert) {
             SSL_CTX_use_certificate_ASN1(ctx, static_cast<int>(client_cert->certificate.size()),
                                          client_cert->certificate.data());
             SSL_CTX_use_PrivateKey_ASN1(EVP_PKEY_RSA, ctx, client_cert->private_key.data(),
@@ -73,6 +104,43 @@ void Context::MakeRequest() {
         // Hack: Since for now RootCerts are not implemented we set the VerifyMode to None.
         SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
     }
+    return client;
+}
+
+void ConnectionPool::Release(const std::string& server,
+                             const std::shared_ptr<ClientCertContext>& client_cert,
+                             std::unique_ptr<httplib::Client> client) {
+    std::scoped_lock lock{mutex};
+    auto& idle = idle_clients[PoolKey(server, client_cert)];
+    if (idle.size() < MaxIdleClientsPerServer) {
+        idle.push_back(std::move(client));
+    }
+}
+
+/// Splits a URL into the server it is on (scheme://host:port) and the path of the resource
+static std::pair<std::string, std::string> SplitUrl(std::string url) {
+    url = url.substr(0, url.find('#'));
+    const std::size_t scheme_end = url.find("://");
+    const std::size_t host_start = scheme_end == std::string::npos ? 0 : scheme_end + 3;
+    const std::size_t path_start = url.find_first_of("/?", host_start);
+    if (path_start == std::string::npos) {
+        return {url, "/"};
+    }
+    std::string path = url.substr(path_start);
+    if (path[0] != '/') {
+        path.insert(0, "/");
+    }
+    return {url.substr(0, path_start), std::move(path)};
+}
+#endif
+
+void Context::MakeRequest(ConnectionPool& pool) {
+    ASSERT(state == RequestState::NotStarted);
+
+#ifdef ENABLE_WEB_SERVICE
+    const auto [server, path] = SplitUrl(url);
+    const std::shared_ptr<ClientCertContext> client_cert = ssl_config.client_cert_ctx.lock();
+    std::unique_ptr<httplib::Client> client = pool.Acquire(server, client_cert);
 
     state = RequestState::InProgress;
 
@@ -84,14 +152,26 @@ void Context::MakeRequest() {
     };
 
     httplib::Request request;
-    httplib::Error error;
+    httplib::Error error = httplib::Error::Connection;
     request.method = request_method_strings.at(method);
-    request.path = url;
+    request.path = path;
     // TODO(B3N30): Add post data body
-    request.progress = [this](u64 current, u64 total) -> bool {
-        // TODO(B3N30): Is there a state that shows response header are available
-        current_download_size_bytes = current;
-        total_download_size_bytes = total;
+    request.response_handler = [this](const httplib::Response& response) {
+        status_code = static_cast<u32>(response.status);
+        return true;
+    };
+    // The body goes to the guest as it arrives, the server is only read ahead of it up to a limit
+    request.content_receiver = [this](const char* data, std::size_t data_length, u64 offset,
+                                      u64 total_length) {
+        total_download_size_bytes = total_length;
+        std::unique_lock lock{body_mutex};
+        body_read.wait(lock, [this] {
+            return cancelled || pending_body.size() < MaxPendingBodySize;
+        });
+        if (cancelled) {
+            return false;
+        }
+        pending_body.insert(pending_body.end(), data, data + data_length);
         return true;
     };
 
@@ -99,7 +179,7 @@ void Context::MakeRequest() {
         request.headers.emplace(header.name, header.value);
     }
 
-    if (!client->send(request, response, error)) {
+    if (!client->is_valid() || !client->send(request, response, error)) {
         LOG_ERROR(Service_HTTP, "Request failed: {}", error);
         state = RequestState::TimedOut;
     } else {
@@ -107,12 +187,106 @@ void Context::MakeRequest() {
         // TODO(B3N30): Verify this state on HW
         state = RequestState::ReadyToDownloadContent;
     }
+    pool.Release(server, client_cert, std::move(client));
 #else
     LOG_ERROR(Service_HTTP, "Tried to make request but WebServices is not enabled in this build");
     state = RequestState::TimedOut;
 #endif
 }
 
+bool Context::IsBodyReady(std::size_t size) {
+    std::scoped_lock lock{body_mutex};
+    return IsFinished() || pending_body.size() >= std::min(size, MaxPendingBodySize);
+}
+
+bool Context::IsBodyDone() {
+    std::scoped_lock lock{body_mutex};
+    return IsFinished() && pending_body.empty();
+}
+
+std::size_t Context::ReadBody(Kernel::MappedBuffer& buffer, std::size_t size) {
+    std::size_t read_size;
+    {
+        std::scoped_lock lock{body_mutex};
+        read_size = std::min(size, pending_body.size());
+        buffer.Write(pending_body.data(), 0, read_size);
+        pending_body.erase(pending_body.begin(), pending_body.begin() + read_size);
+    }
+    current_download_size_bytes += read_size;
+    body_read.notify_one();
+    return read_size;
+}
+
+void Context::Cancel() {
+    {
+        std::scoped_lock lock{body_mutex};
+        cancelled = true;
+    }
+    body_read.notify_one();
+}
+
+/// Handles the request again once the response it waited for is ready
+class HTTP_C::RetryCallback : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    explicit RetryCallback(std::shared_ptr<HTTP_C> http_c_) : http_c(std::move(http_c_)) {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) override {
+        http_c->resuming_request = true;
+        http_c->HandleSyncRequest(ctx);
+        http_c->resuming_request = false;
+    }
+
+private:
+    RetryCallback() = default;
+
+    std::shared_ptr<HTTP_C> http_c;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        ar& http_c;
+    }
+    friend class boost::serialization::access;
+};
+
+void HTTP_C::WaitForRequest(Kernel::HLERequestContext& ctx, RequestWait wait) {
+    wait.event = ctx.SleepClientThread(
+        "http_c::WaitForRequest", std::chrono::nanoseconds{0},
+        std::make_shared<RetryCallback>(std::static_pointer_cast<HTTP_C>(shared_from_this())));
+    if (request_waits.empty()) {
+        Core::System::GetInstance().CoreTiming().ScheduleEvent(
+            msToCycles(REQUEST_POLL_INTERVAL_MS), poll_requests_event);
+    }
+    request_waits.push_back(std::move(wait));
+}
+
+void HTTP_C::PollRequestWaits(s64 cycles_late) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = request_waits.begin(); it != request_waits.end();) {
+        // The thread may also have been stopped while it slept
+        if (it->event->GetWaitingThreads().empty()) {
+            it = request_waits.erase(it);
+            continue;
+        }
+        const auto context = contexts.find(it->context_handle);
+        const bool ready =
+            context == contexts.end() ||
+            (it->body_size ? context->second.IsBodyReady(*it->body_size)
+                           : context->second.status_code != 0 || context->second.IsFinished());
+        if (ready || (it->deadline && now >= *it->deadline)) {
+            it->event->Signal();
+            it = request_waits.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    if (!request_waits.empty()) {
+        Core::System::GetInstance().CoreTiming().ScheduleEvent(
+            msToCycles(REQUEST_POLL_INTERVAL_MS) - cycles_late, poll_requests_event);
+    }
+}
+
 void HTTP_C::Initialize(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x1, 1, 4);
     const u32 shmem_size = rp.Pop<u32>();
@@ -225,7 +399,8 @@ void HTTP_C::BeginRequest(Kernel::HLERequestContext& ctx) {
     // For now make every request async in it's own thread.
 
     itr->second.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second));
+        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second),
+                   std::ref(connection_pool));
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -278,12 +453,129 @@ void HTTP_C::BeginRequestAsync(Kernel::HLERequestContext& ctx) {
     // For now make every request async in it's own thread.
 
     itr->second.request_future =
-        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second));
+        std::async(std::launch::async, &Context::MakeRequest, std::ref(itr->second),
+                   std::ref(connection_pool));
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
 }
 
+void HTTP_C::GetDownloadSizeState(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx, 0x6, 1, 0);
+    const Context::Handle context_handle = rp.Pop<u32>();
+
+    LOG_DEBUG(Service_HTTP, "called, context_id={}", context_handle);
+
+    auto itr = contexts.find(context_handle);
+    if (itr == contexts.end()) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+        rb.Push(ERROR_CONTEXT_NOT_FOUND);
+        return;
+    }
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(3, 0);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(static_cast<u32>(itr->second.current_download_size_bytes));
+    rb.Push(static_cast<u32>(itr->second.total_download_size_bytes));
+}
+
+void HTTP_C::ReceiveData(Kernel::HLERequestContext& ctx) {
+    ReceiveDataImpl(ctx, false);
+}
+
+void HTTP_C::ReceiveDataTimeout(Kernel::HLERequestContext& ctx) {
+    ReceiveDataImpl(ctx, true);
+}
+
+void HTTP_C::ReceiveDataImpl(Kernel::HLERequestContext& ctx, bool timeout) {
+    IPC::RequestParser rp(ctx, timeout ? 0xC : 0xB, timeout ? 4 : 2, 2);
+    const Context::Handle context_handle = rp.Pop<u32>();
+    const u32 buffer_size = rp.Pop<u32>();
+    const u64 timeout_nanos = timeout ? rp.Pop<u64>() : 0;
+    Kernel::MappedBuffer& buffer = rp.PopMappedBuffer();
+
+    LOG_DEBUG(Service_HTTP, "called, context_id={}, buffer_size={}", context_handle, buffer_size);
+
+    auto itr = contexts.find(context_handle);
+    if (itr == contexts.end() || itr->second.state == RequestState::NotStarted) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+        rb.Push(itr == contexts.end() ? ERROR_CONTEXT_NOT_FOUND : ERROR_INVALID_REQUEST_STATE);
+        rb.PushMappedBuffer(buffer);
+        return;
+    }
+    Context& http_context = itr->second;
+
+    const std::size_t size = std::min<std::size_t>(buffer_size, buffer.GetSize());
+    if (!http_context.IsBodyReady(size)) {
+        if (!resuming_request) {
+            std::optional<std::chrono::steady_clock::time_point> deadline;
+            if (timeout) {
+                deadline = std::chrono::steady_clock::now() +
+                           std::chrono::nanoseconds{static_cast<s64>(timeout_nanos)};
+            }
+            WaitForRequest(ctx, {context_handle, size, deadline, nullptr});
+            return;
+        }
+
+        // Only the timeout wakes the thread up before the body is ready
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+        rb.Push(ERROR_TIMEOUT);
+        rb.PushMappedBuffer(buffer);
+        return;
+    }
+
+    // The guest finds out how much was read from the download size state
+    http_context.ReadBody(buffer, size);
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+    rb.Push(http_context.IsBodyDone() ? RESULT_SUCCESS : ERROR_DOWNLOAD_PENDING);
+    rb.PushMappedBuffer(buffer);
+}
+
+void HTTP_C::GetResponseStatusCode(Kernel::HLERequestContext& ctx) {
+    GetResponseStatusCodeImpl(ctx, false);
+}
+
+void HTTP_C::GetResponseStatusCodeTimeout(Kernel::HLERequestContext& ctx) {
+    GetResponseStatusCodeImpl(ctx, true);
+}
+
+void HTTP_C::GetResponseStatusCodeImpl(Kernel::HLERequestContext& ctx, bool timeout) {
+    IPC::RequestParser rp(ctx, timeout ? 0x23 : 0x22, timeout ? 3 : 1, 0);
+    const Context::Handle context_handle = rp.Pop<u32>();
+    const u64 timeout_nanos = timeout ? rp.Pop<u64>() : 0;
+
+    LOG_DEBUG(Service_HTTP, "called, context_id={}", context_handle);
+
+    auto itr = contexts.find(context_handle);
+    if (itr == contexts.end() || itr->second.state == RequestState::NotStarted) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+        rb.Push(itr == contexts.end() ? ERROR_CONTEXT_NOT_FOUND : ERROR_INVALID_REQUEST_STATE);
+        return;
+    }
+    Context& http_context = itr->second;
+
+    if (http_context.status_code == 0 && !http_context.IsFinished()) {
+        if (!resuming_request) {
+            std::optional<std::chrono::steady_clock::time_point> deadline;
+            if (timeout) {
+                deadline = std::chrono::steady_clock::now() +
+                           std::chrono::nanoseconds{static_cast<s64>(timeout_nanos)};
+            }
+            WaitForRequest(ctx, {context_handle, std::nullopt, deadline, nullptr});
+            return;
+        }
+
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+        rb.Push(ERROR_TIMEOUT);
+        return;
+    }
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push<u32>(http_context.status_code);
+}
+
 void HTTP_C::CreateContext(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x2, 2, 2);
     const u32 url_size = rp.Pop<u32>();
@@ -390,6 +682,7 @@ void HTTP_C::CloseContext(Kernel::HLERequestContext& ctx) {
     // TODO(Subv): Make sure that only the session that created the context can close it.
 
     // Note that this will block if a request is still in progress
+    itr->second.Cancel();
     contexts.erase(itr);
     session_data->num_http_contexts--;
 
@@ -873,13 +1166,13 @@ HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
         {0x00030040, &HTTP_C::CloseContext, "CloseContext"},
         {0x00040040, nullptr, "CancelConnection"},
         {0x00050040, nullptr, "GetRequestState"},
-        {0x00060040, nullptr, "GetDownloadSizeState"},
+        {0x00060040, &HTTP_C::GetDownloadSizeState, "GetDownloadSizeState"},
         {0x00070040, nullptr, "GetRequestError"},
         {0x00080042, &HTTP_C::InitializeConnectionSession, "InitializeConnectionSession"},
         {0x00090040, &HTTP_C::BeginRequest, "BeginRequest"},
         {0x000A0040, &HTTP_C::BeginRequestAsync, "BeginRequestAsync"},
-        {0x000B0082, nullptr, "ReceiveData"},
-        {0x000C0102, nullptr, "ReceiveDataTimeout"},
+        {0x000B0082, &HTTP_C::ReceiveData, "ReceiveData"},
+        {0x000C0102, &HTTP_C::ReceiveDataTimeout, "ReceiveDataTimeout"},
         {0x000D0146, nullptr, "SetProxy"},
         {0x000E0040, nullptr, "SetProxyDefault"},
         {0x000F00C4, nullptr, "SetBasicAuthorization"},
@@ -901,8 +1194,9 @@ HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
         {0x001F0144, nullptr, "GetResponseHeaderTimeout"},
         {0x00200082, nullptr, "GetResponseData"},
         {0x00210102, nullptr, "GetResponseDataTimeout"},
-        {0x00220040, nullptr, "GetResponseStatusCode"},
-        {0x002300C0, nullptr, "GetResponseStatusCodeTimeout"},
+        {0x00220040, &HTTP_C::GetResponseStatusCode, "GetResponseStatusCode"},
+        {0x002300C0, &HTTP_C::GetResponseStatusCodeTimeout,
+         "GetResponseStatusCodeTimeout"},
         {0x00240082, nullptr, "AddTrustedRootCA"},
         {0x00250080, nullptr, "AddDefaultCert"},
         {0x00260080, nullptr, "SelectRootCertChain"},
@@ -927,11 +1221,26 @@ HTTP_C::HTTP_C() : ServiceFramework("http:C", 32) {
     };
     RegisterHandlers(functions);
 
+    poll_requests_event = Core::System::GetInstance().CoreTiming().RegisterEvent(
+        "HTTP_C::PollRequestWaits",
+        [this](std::uintptr_t user_data, s64 cycles_late) { PollRequestWaits(cycles_late); });
+
     DecryptClCertA();
 }
 
+HTTP_C::~HTTP_C() {
+    Core::System::GetInstance().CoreTiming().UnscheduleEvent(poll_requests_event, 0);
+
+    // Requests waiting for the guest to read their body would never finish
+    for (auto& [handle, context] : contexts) {
+        context.Cancel();
+    }
+}
+
 void InstallInterfaces(Core::System& system) {
     auto& service_manager = system.ServiceManager();
     std::make_shared<HTTP_C>()->InstallAsService(service_manager);
 }
 } // namespace Service::HTTP
+
+SERIALIZE_EXPORT_IMPL(Service::HTTP::HTTP_C::RetryCallback)
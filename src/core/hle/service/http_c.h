@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -28,7 +32,8 @@
 
 namespace Core {
 class System;
-}
+struct TimingEventType;
+} // namespace Core
 
 namespace Service::HTTP {
 
@@ -112,6 +117,27 @@ private:
     friend class boost::serialization::access;
 };
 
+/// Keeps the connections of finished requests open, so that the following requests to the same
+/// server skip connecting and the TLS handshake.
+class ConnectionPool {
+#ifdef ENABLE_WEB_SERVICE
+public:
+    /// Returns an idle client for the server (scheme://host:port), or a new one
+    std::unique_ptr<httplib::Client> Acquire(const std::string& server,
+                                             const std::shared_ptr<ClientCertContext>& client_cert);
+
+    /// Keeps the client of a finished request for the next request to the server
+    void Release(const std::string& server, const std::shared_ptr<ClientCertContext>& client_cert,
+                 std::unique_ptr<httplib::Client> client);
+
+private:
+    static constexpr std::size_t MaxIdleClientsPerServer = 4;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<httplib::Client>>> idle_clients;
+#endif
+};
+
 /// Represents an HTTP context.
 class Context final {
 public:
@@ -121,7 +147,27 @@ public:
     Context(const Context&) = delete;
     Context& operator=(const Context&) = delete;
 
-    void MakeRequest();
+    void MakeRequest(ConnectionPool& pool);
+
+    /// Whether the request is done, successfully or not
+    bool IsFinished() const {
+        return state == RequestState::ReadyToDownloadContent || state == RequestState::TimedOut;
+    }
+
+    /// Whether the guest can read size bytes of the body without waiting for the server
+    bool IsBodyReady(std::size_t size);
+
+    /// Whether the whole body was read by the guest
+    bool IsBodyDone();
+
+    /// Moves up to size bytes of the received body to the buffer, returns the number of bytes
+    std::size_t ReadBody(Kernel::MappedBuffer& buffer, std::size_t size);
+
+    /// Stops a request that waits for the guest to read its body
+    void Cancel();
+
+    /// Maximum amount of the body that is received ahead of the guest reading it
+    static constexpr std::size_t MaxPendingBodySize = 512 * 1024;
 
     struct Proxy {
         std::string url;
@@ -211,11 +257,20 @@ public:
     std::vector<PostData> post_data;
 
     std::future<void> request_future;
-    std::atomic<u64> current_download_size_bytes;
-    std::atomic<u64> total_download_size_bytes;
+    /// Size of the body that the guest read, and that the server announced
+    std::atomic<u64> current_download_size_bytes = 0;
+    std::atomic<u64> total_download_size_bytes = 0;
+    /// Status code of the response, 0 until its headers are received
+    std::atomic<u32> status_code = 0;
 #ifdef ENABLE_WEB_SERVICE
     httplib::Response response;
 #endif
+
+    std::mutex body_mutex;
+    std::condition_variable body_read;
+    /// Part of the body that was received but not read by the guest yet
+    std::vector<u8> pending_body;
+    bool cancelled = false;
 };
 
 struct SessionData : public Kernel::SessionRequestHandler::SessionDataBase {
@@ -251,6 +306,9 @@ private:
 class HTTP_C final : public ServiceFramework<HTTP_C, SessionData> {
 public:
     HTTP_C();
+    ~HTTP_C();
+
+    class RetryCallback;
 
 private:
     /**
@@ -330,6 +388,26 @@ private:
      *  Outputs:
      *      1 : Result of function, 0 on success, otherwise error code
      */
+    void GetDownloadSizeState(Kernel::HLERequestContext& ctx);
+
+    /**
+     * HTTP_C::ReceiveData service function
+     *  Inputs:
+     *      1 : Context handle
+     *      2 : Buffer size
+     *      3-4 : (ReceiveDataTimeout only) Timeout in nanoseconds
+     *      5-6 : Mapped buffer
+     *  Outputs:
+     *      1 : Result of function, the download pending result while the body isn't done
+     */
+    void ReceiveData(Kernel::HLERequestContext& ctx);
+    void ReceiveDataTimeout(Kernel::HLERequestContext& ctx);
+    void ReceiveDataImpl(Kernel::HLERequestContext& ctx, bool timeout);
+
+    void GetResponseStatusCode(Kernel::HLERequestContext& ctx);
+    void GetResponseStatusCodeTimeout(Kernel::HLERequestContext& ctx);
+    void GetResponseStatusCodeImpl(Kernel::HLERequestContext& ctx, bool timeout);
+
     void AddRequestHeader(Kernel::HLERequestContext& ctx);
 
     /**
@@ -410,6 +488,33 @@ private:
 
     void DecryptClCertA();
 
+    /// A guest thread sleeping until the response of a request is ready for it
+    struct RequestWait {
+        Context::Handle context_handle;
+        /// Size of the body that the thread waits for, none when it waits for the headers
+        std::optional<std::size_t> body_size;
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        std::shared_ptr<Kernel::Event> event;
+    };
+
+    /**
+     * Puts the client thread to sleep until the response is ready for it or the timeout of the
+     * wait expires, instead of blocking the emulation. The request is then handled again.
+     */
+    void WaitForRequest(Kernel::HLERequestContext& ctx, RequestWait wait);
+
+    /// Wakes up the threads whose responses are ready, periodically while there are any
+    void PollRequestWaits(s64 cycles_late);
+
+    /// Event that checks the responses of the sleeping threads
+    Core::TimingEventType* poll_requests_event;
+
+    /// Threads waiting for their responses, these are lost in savestates like the requests
+    std::list<RequestWait> request_waits;
+
+    /// Whether the request being handled is for a thread woken up from a wait
+    bool resuming_request = false;
+
     std::shared_ptr<Kernel::SharedMemory> shared_memory = nullptr;
 
     /// The next number to use when a new HTTP session is initalized.
@@ -421,6 +526,9 @@ private:
     /// The next handle number to use when a new ClientCert context is created.
     ClientCertContext::Handle client_certs_counter = 0;
 
+    /// Connections shared by the requests of all contexts, outlives them
+    ConnectionPool connection_pool;
+
     /// Global list of HTTP contexts currently opened.
     std::unordered_map<Context::Handle, Context> contexts;
 
@@ -458,3 +566,4 @@ void InstallInterfaces(Core::System& system);
 
 BOOST_CLASS_EXPORT_KEY(Service::HTTP::HTTP_C)
 BOOST_CLASS_EXPORT_KEY(Service::HTTP::SessionData)
+BOOST_CLASS_EXPORT_KEY(Service::HTTP::HTTP_C::RetryCallback)
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <memory>
 #include <boost/crc.hpp>
 #include <boost/serialization/base_object.hpp>
@@ -97,7 +98,7 @@ public:
      * @params packet The data of the packet to put.
      * @returns whether the operation is successful.
      */
-    bool Put(const std::vector<u8>& packet) {
+    bool Put(std::span<const u8> packet) {
         if (info.packet_count == max_packet_count)
             return false;
 
@@ -122,10 +123,12 @@ public:
         PacketInfo packet_info{write_offset, static_cast<u32>(packet.size())};
         SetPacketInfo(info.end_index, packet_info);
 
-        // writes packet data
-        for (std::size_t i = 0; i < packet.size(); ++i) {
-            *GetDataBufferPointer((write_offset + i) % max_data_size) = packet[i];
-        }
+        // writes packet data, wrapping around the end of the data buffer
+        const std::size_t first_size =
+            std::min<std::size_t>(packet.size(), max_data_size - write_offset);
+        std::memcpy(GetDataBufferPointer(write_offset), packet.data(), first_size);
+        std::memcpy(GetDataBufferPointer(0), packet.data() + first_size,
+                    packet.size() - first_size);
 
         // updates buffer info
         info.end_index++;
@@ -224,11 +227,11 @@ private:
 };
 
 /// Wraps the payload into packet and puts it to the receive buffer
-void IR_USER::PutToReceive(const std::vector<u8>& payload) {
+void IR_USER::PutToReceive(std::span<const u8> payload) {
     LOG_TRACE(Service_IR, "called, data={}", fmt::format("{:02x}", fmt::join(payload, " ")));
     std::size_t size = payload.size();
 
-    std::vector<u8> packet;
+    packet.clear();
 
     // Builds packet header. For the format info:
     // https://www.3dbrew.org/wiki/IRUSER_Shared_Memory#Packet_structure
@@ -462,7 +465,7 @@ IR_USER::IR_USER(Core::System& system) : ServiceFramework("ir:USER", 1) {
     receive_event = system.Kernel().CreateEvent(ResetType::OneShot, "IR:ReceiveEvent");
 
     extra_hid = std::make_unique<ExtraHID>(
-        [this](const std::vector<u8>& data) { PutToReceive(data); }, system.CoreTiming());
+        [this](std::span<const u8> data) { PutToReceive(data); }, system.CoreTiming());
 }
 
 IR_USER::~IR_USER() {
@@ -478,7 +481,7 @@ void IR_USER::ReloadInputDevices() {
 IRDevice::IRDevice(SendFunc send_func_) : send_func(send_func_) {}
 IRDevice::~IRDevice() = default;
 
-void IRDevice::Send(const std::vector<u8>& data) {
+void IRDevice::Send(std::span<const u8> data) {
     send_func(data);
 }
 
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <vector>
 #include "core/hle/service/service.h"
 
@@ -23,10 +24,10 @@ class ExtraHID;
 class IRDevice {
 public:
     /**
-     * A function object that implements the method to send data to the 3DS, which takes a vector of
-     * data to send.
+     * A function object that implements the method to send data to the 3DS, which takes the data
+     * to send.
      */
-    using SendFunc = std::function<void(const std::vector<u8>& data)>;
+    using SendFunc = std::function<void(std::span<const u8> data)>;
 
     explicit IRDevice(SendFunc send_func);
     virtual ~IRDevice();
@@ -42,7 +43,7 @@ public:
 
 protected:
     /// Sends data to the 3DS. The actual sending method is specified in the constructor
-    void Send(const std::vector<u8>& data);
+    void Send(std::span<const u8> data);
 
 private:
     // NOTE: This value is *not* serialized because it's always passed in the constructor
@@ -161,13 +162,15 @@ private:
      */
     void ReleaseReceivedData(Kernel::HLERequestContext& ctx);
 
-    void PutToReceive(const std::vector<u8>& payload);
+    void PutToReceive(std::span<const u8> payload);
 
     std::shared_ptr<Kernel::Event> conn_status_event, send_event, receive_event;
     std::shared_ptr<Kernel::SharedMemory> shared_memory;
     bool connected_device;
     std::unique_ptr<BufferManager> receive_buffer;
     std::unique_ptr<ExtraHID> extra_hid;
+    /// The packet being put to the receive buffer, kept to reuse its memory for every packet
+    std::vector<u8> packet;
 
 private:
     template <class Archive>
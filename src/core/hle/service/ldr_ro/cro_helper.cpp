@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -48,14 +49,21 @@ const std::array<CROHelper::HeaderField, 4> CROHelper::FIX_BARRIERS{{
     Fix3Barrier,
 }};
 
+const std::vector<CROHelper::SegmentEntry>& CROHelper::GetSegmentTable() const {
+    if (!is_segment_table_cached) {
+        cached_segment_table = GetEntries<SegmentEntry>(system.Memory(), GetField(SegmentNum));
+        is_segment_table_cached = true;
+    }
+    return cached_segment_table;
+}
+
 VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
-    u32 segment_num = GetField(SegmentNum);
+    const auto& segments = GetSegmentTable();
 
-    if (segment_tag.segment_index >= segment_num)
+    if (segment_tag.segment_index >= segments.size())
         return 0;
 
-    SegmentEntry entry;
-    GetEntry(system.Memory(), segment_tag.segment_index, entry);
+    const SegmentEntry& entry = segments[segment_tag.segment_index];
 
     if (segment_tag.offset_into_segment >= entry.size)
         return 0;
@@ -63,6 +71,30 @@ VAddr CROHelper::SegmentTagToAddress(SegmentTag segment_tag) const {
     return entry.offset + segment_tag.offset_into_segment;
 }
 
+void CROHelper::WriteRelocation(VAddr target_address, u32 value) {
+    system.Memory().Write32(target_address, value);
+    pending_invalidations.push_back(target_address);
+}
+
+void CROHelper::FlushRelocations() {
+    if (pending_invalidations.empty())
+        return;
+
+    // Relocations are mostly sequential, so merge them in as few ranges as possible
+    std::sort(pending_invalidations.begin(), pending_invalidations.end());
+    VAddr range_begin = pending_invalidations.front();
+    VAddr range_end = range_begin + sizeof(u32);
+    for (VAddr address : pending_invalidations) {
+        if (address > range_end) {
+            system.InvalidateCacheRange(range_begin, range_end - range_begin);
+            range_begin = address;
+        }
+        range_end = std::max<VAddr>(range_end, address + sizeof(u32));
+    }
+    system.InvalidateCacheRange(range_begin, range_end - range_begin);
+    pending_invalidations.clear();
+}
+
 ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType relocation_type,
                                       u32 addend, u32 symbol_address, u32 target_future_address) {
 
@@ -71,12 +103,10 @@ ResultCode CROHelper::ApplyRelocation(VAddr target_address, RelocationType reloc
         break;
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
-        system.Memory().Write32(target_address, symbol_address + addend);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        WriteRelocation(target_address, symbol_address + addend);
         break;
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, symbol_address + addend - target_future_address);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        WriteRelocation(target_address, symbol_address + addend - target_future_address);
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -98,8 +128,7 @@ ResultCode CROHelper::ClearRelocation(VAddr target_address, RelocationType reloc
     case RelocationType::AbsoluteAddress:
     case RelocationType::AbsoluteAddress2:
     case RelocationType::RelativeAddress:
-        system.Memory().Write32(target_address, 0);
-        system.InvalidateCacheRange(target_address, sizeof(u32));
+        WriteRelocation(target_address, 0);
         break;
     case RelocationType::ThumbBranch:
     case RelocationType::ArmBranch:
@@ -118,6 +147,7 @@ ResultCode CROHelper::ApplyRelocationBatch(VAddr batch, u32 symbol_address, bool
     if (symbol_address == 0 && !reset)
         return CROFormatError(0x10);
 
+    SCOPE_EXIT({ FlushRelocations(); });
     VAddr relocation_address = batch;
     while (true) {
         RelocationEntry relocation;
@@ -474,17 +504,19 @@ VAddr CROHelper::GetOnUnresolvedAddress() {
 ResultCode CROHelper::ResetExternalRelocations() {
     u32 unresolved_symbol = GetOnUnresolvedAddress();
     u32 external_relocation_num = GetField(ExternalRelocationNum);
-    ExternalRelocationEntry relocation;
+    ExternalRelocationEntry last_relocation;
 
     // Verifies that the last relocation is the end of a batch
-    GetEntry(system.Memory(), external_relocation_num - 1, relocation);
-    if (!relocation.is_batch_end) {
+    GetEntry(system.Memory(), external_relocation_num - 1, last_relocation);
+    if (!last_relocation.is_batch_end) {
         return CROFormatError(0x12);
     }
 
+    SCOPE_EXIT({ FlushRelocations(); });
+    auto relocations =
+        GetEntries<ExternalRelocationEntry>(system.Memory(), external_relocation_num);
     bool batch_begin = true;
-    for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(system.Memory(), i, relocation);
+    for (auto& relocation : relocations) {
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
 
         if (relocation_target == 0) {
@@ -501,23 +533,24 @@ ResultCode CROHelper::ResetExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(system.Memory(), i, relocation);
         }
 
         // if current is an end, then the next is a beginning
         batch_begin = relocation.is_batch_end != 0;
     }
 
+    SetEntries(system.Memory(), relocations);
     return RESULT_SUCCESS;
 }
 
 ResultCode CROHelper::ClearExternalRelocations() {
     u32 external_relocation_num = GetField(ExternalRelocationNum);
-    ExternalRelocationEntry relocation;
 
+    SCOPE_EXIT({ FlushRelocations(); });
+    auto relocations =
+        GetEntries<ExternalRelocationEntry>(system.Memory(), external_relocation_num);
     bool batch_begin = true;
-    for (u32 i = 0; i < external_relocation_num; ++i) {
-        GetEntry(system.Memory(), i, relocation);
+    for (auto& relocation : relocations) {
         VAddr relocation_target = SegmentTagToAddress(relocation.target_position);
 
         if (relocation_target == 0) {
@@ -533,13 +566,13 @@ ResultCode CROHelper::ClearExternalRelocations() {
         if (batch_begin) {
             // resets to unresolved state
             relocation.is_batch_resolved = 0;
-            SetEntry(system.Memory(), i, relocation);
         }
 
         // if current is an end, then the next is a beginning
         batch_begin = relocation.is_batch_end != 0;
     }
 
+    SetEntries(system.Memory(), relocations);
     return RESULT_SUCCESS;
 }
 
@@ -576,19 +609,20 @@ ResultCode CROHelper::ApplyStaticAnonymousSymbolToCRS(VAddr crs_address) {
 }
 
 ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
-    u32 segment_num = GetField(SegmentNum);
+    const auto& segments = GetSegmentTable();
+    u32 segment_num = static_cast<u32>(segments.size());
     u32 internal_relocation_num = GetField(InternalRelocationNum);
-    for (u32 i = 0; i < internal_relocation_num; ++i) {
-        InternalRelocationEntry relocation;
-        GetEntry(system.Memory(), i, relocation);
+
+    SCOPE_EXIT({ FlushRelocations(); });
+    for (const auto& relocation :
+         GetEntries<InternalRelocationEntry>(system.Memory(), internal_relocation_num)) {
         VAddr target_addressB = SegmentTagToAddress(relocation.target_position);
         if (target_addressB == 0) {
             return CROFormatError(0x15);
         }
 
         VAddr target_address;
-        SegmentEntry target_segment;
-        GetEntry(system.Memory(), relocation.target_position.segment_index, target_segment);
+        const SegmentEntry& target_segment = segments[relocation.target_position.segment_index];
 
         if (target_segment.type == SegmentType::Data) {
             // If the relocation is to the .data segment, we need to relocate it in the old buffer
@@ -602,8 +636,7 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
             return CROFormatError(0x15);
         }
 
-        SegmentEntry symbol_segment;
-        GetEntry(system.Memory(), relocation.symbol_segment, symbol_segment);
+        const SegmentEntry& symbol_segment = segments[relocation.symbol_segment];
         LOG_TRACE(Service_LDR, "Internally relocates 0x{:08X} with 0x{:08X}", target_address,
                   symbol_segment.offset);
         ResultCode result = ApplyRelocation(target_address, relocation.type, relocation.addend,
@@ -618,9 +651,10 @@ ResultCode CROHelper::ApplyInternalRelocations(u32 old_data_segment_address) {
 
 ResultCode CROHelper::ClearInternalRelocations() {
     u32 internal_relocation_num = GetField(InternalRelocationNum);
-    for (u32 i = 0; i < internal_relocation_num; ++i) {
-        InternalRelocationEntry relocation;
-        GetEntry(system.Memory(), i, relocation);
+
+    SCOPE_EXIT({ FlushRelocations(); });
+    for (const auto& relocation :
+         GetEntries<InternalRelocationEntry>(system.Memory(), internal_relocation_num)) {
         VAddr target_address = SegmentTagToAddress(relocation.target_position);
 
         if (target_address == 0) {
@@ -750,40 +784,42 @@ void CROHelper::UnrebaseHeader() {
 ResultCode CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
     u32 import_strings_size = GetField(ImportStringsSize);
     u32 symbol_import_num = GetField(ImportNamedSymbolNum);
-    for (u32 i = 0; i < symbol_import_num; ++i) {
-        ImportNamedSymbolEntry entry;
-        GetEntry(system.Memory(), i, entry);
+    if (symbol_import_num == 0)
+        return RESULT_SUCCESS;
+
+    // The module list doesn't change while linking, so it is walked only once for all imports
+    std::vector<CROHelper> sources;
+    ForEachAutoLinkCRO(process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+        sources.push_back(source);
+        return MakeResult<bool>(true);
+    });
+
+    for (const auto& entry :
+         GetEntries<ImportNamedSymbolEntry>(system.Memory(), symbol_import_num)) {
         VAddr relocation_addr = entry.relocation_batch_offset;
         ExternalRelocationEntry relocation_entry;
         system.Memory().ReadBlock(process, relocation_addr, &relocation_entry,
                                   sizeof(ExternalRelocationEntry));
 
-        if (!relocation_entry.is_batch_resolved) {
-            ResultCode result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        system.Memory().ReadCString(entry.name_offset, import_strings_size);
-                    u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
-
-                    if (symbol_address != 0) {
-                        LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"",
-                                  ModuleName(), symbol_name, source.ModuleName());
+        if (relocation_entry.is_batch_resolved)
+            continue;
 
-                        ResultCode result = ApplyRelocationBatch(relocation_addr, symbol_address);
-                        if (result.IsError()) {
-                            LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}",
-                                      result.raw);
-                            return result;
-                        }
+        std::string symbol_name =
+            system.Memory().ReadCString(entry.name_offset, import_strings_size);
+        for (const CROHelper& source : sources) {
+            u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
+            if (symbol_address == 0)
+                continue;
 
-                        return MakeResult<bool>(false);
-                    }
+            LOG_TRACE(Service_LDR, "CRO \"{}\" imports \"{}\" from \"{}\"", ModuleName(),
+                      symbol_name, source.ModuleName());
 
-                    return MakeResult<bool>(true);
-                });
+            ResultCode result = ApplyRelocationBatch(relocation_addr, symbol_address);
             if (result.IsError()) {
+                LOG_ERROR(Service_LDR, "Error applying relocation batch {:08X}", result.raw);
                 return result;
             }
+            break;
         }
     }
     return RESULT_SUCCESS;
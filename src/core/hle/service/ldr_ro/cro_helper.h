@@ -5,7 +5,10 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -406,6 +409,7 @@ private:
 
     void SetField(HeaderField field, u32 value) {
         system.Memory().Write32(Field(field), value);
+        is_segment_table_cached = false;
     }
 
     /**
@@ -434,8 +438,35 @@ private:
         memory.WriteBlock(process,
                           GetField(T::TABLE_OFFSET_FIELD) + static_cast<u32>(index * sizeof(T)),
                           &data, sizeof(T));
+        if constexpr (std::is_same_v<T, SegmentEntry>) {
+            is_segment_table_cached = false;
+        }
     }
 
+    /**
+     * Reads a whole module table with a single block read.
+     * @param count the number of entries in the table
+     * @note the entry type must have the static member TABLE_OFFSET_FIELD
+     *       indicating which table the entries are in.
+     */
+    template <typename T>
+    std::vector<T> GetEntries(Memory::MemorySystem& memory, u32 count) const {
+        std::vector<T> entries(count);
+        memory.ReadBlock(process, GetField(T::TABLE_OFFSET_FIELD), entries.data(),
+                         entries.size() * sizeof(T));
+        return entries;
+    }
+
+    /// Writes back a whole module table read with GetEntries
+    template <typename T>
+    void SetEntries(Memory::MemorySystem& memory, const std::vector<T>& entries) {
+        memory.WriteBlock(process, GetField(T::TABLE_OFFSET_FIELD), entries.data(),
+                          entries.size() * sizeof(T));
+    }
+
+    /// Returns the segment table, reading it from memory if it changed since the last call
+    const std::vector<SegmentEntry>& GetSegmentTable() const;
+
     /**
      * Converts a segment tag to virtual address in this module.
      * @param segment_tag the segment tag to convert
@@ -506,6 +537,12 @@ private:
      */
     ResultCode ClearRelocation(VAddr target_address, RelocationType relocation_type);
 
+    /// Writes a relocated word, deferring the invalidation of translated code that reads it
+    void WriteRelocation(VAddr target_address, u32 value);
+
+    /// Invalidates the translated code of all the pages patched since the last call
+    void FlushRelocations();
+
     /**
      * Applies or resets a batch of relocations
      * @param batch the virtual address of the first relocation in the batch
@@ -715,6 +752,13 @@ private:
      * @returns ResultCode RESULT_SUCCESS on success, otherwise error code.
      */
     ResultCode ApplyExitRelocations(VAddr crs_address);
+
+    /// Copy of the segment table, read on the first segment tag lookup
+    mutable std::vector<SegmentEntry> cached_segment_table;
+    mutable bool is_segment_table_cached = false;
+
+    /// Pages patched by relocations whose translated code hasn't been invalidated yet
+    std::vector<VAddr> pending_invalidations;
 };
 
 } // namespace Service::LDR
@@ -76,25 +76,25 @@ struct State {
     u8 sample_size = 0;
     SampleRate sample_rate = SampleRate::Rate16360;
 
-    void WriteSamples(const std::vector<u8>& samples) {
-        u32 bytes_total_written = 0;
-        const std::size_t remaining_space = size - offset;
-        std::size_t bytes_to_write = std::min(samples.size(), remaining_space);
-
-        // Write as many samples as we can to the buffer.
-        // TODO if the sample size is 16bit, this could theoretically cut a sample in the case where
-        // the application configures an odd size
-        std::memcpy(sharedmem_buffer + offset, samples.data(), bytes_to_write);
-        offset += static_cast<u32>(bytes_to_write);
-        bytes_total_written += static_cast<u32>(bytes_to_write);
-
-        // If theres any samples left to write after we looped, go ahead and write them now
-        if (looped_buffer && samples.size() > bytes_total_written) {
-            offset = initial_offset;
-            bytes_to_write = std::min(samples.size() - bytes_total_written, size);
-            std::memcpy(sharedmem_buffer + offset, samples.data() + bytes_total_written,
-                        bytes_to_write);
-            offset += static_cast<u32>(bytes_to_write);
+    /// Reads the samples captured by the mic straight into the sharedmem buffer
+    void ReadSamples(Frontend::Mic::Interface& mic) {
+        const std::size_t sample_bytes = sample_size / 8;
+        const auto space_from = [this, sample_bytes](std::size_t start) -> std::size_t {
+            // Only whole samples are read, so that none are cut in the case where the
+            // application configures an odd size
+            return size > start ? (size - start) / sample_bytes * sample_bytes : 0;
+        };
+
+        // Read as many samples as we can to the buffer.
+        offset += static_cast<u32>(mic.Read(sharedmem_buffer + offset, space_from(offset)));
+
+        // If theres any samples left to read after we looped, go ahead and read them now
+        if (looped_buffer && space_from(offset) == 0) {
+            const std::size_t wrapped = mic.Read(sharedmem_buffer + initial_offset,
+                                                 space_from(initial_offset));
+            if (wrapped > 0) {
+                offset = initial_offset + static_cast<u32>(wrapped);
+            }
         }
 
         // The last 4 bytes of the shared memory contains the latest offset
@@ -167,10 +167,8 @@ struct MIC_U::Impl {
             return;
         }
 
-        Frontend::Mic::Samples samples = mic->Read();
-        if (!samples.empty()) {
-            // write the samples to sharedmem page
-            state.WriteSamples(samples);
+        if (state.sharedmem_buffer) {
+            state.ReadSamples(*mic);
         }
 
         // schedule next run
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <boost/serialization/list.hpp>
 #include <boost/serialization/map.hpp>
 #include <cryptopp/osrng.h>
@@ -49,28 +50,109 @@ enum {
 // TODO(Subv): Find a more accurate value for this limit.
 constexpr std::size_t MaxBeaconFrames = 15;
 
+// Number of beacon intervals after which an unchanged beacon is sent again, so that the members of
+// the room can tell that the host is still there.
+constexpr u32 BeaconRefreshInterval = 10;
+
+// Time after which a host from which no beacon was received is considered gone.
+const std::chrono::duration<double, std::milli> BeaconTimeout{
+    BeaconRefreshInterval * DefaultBeaconInterval * MillisecondsPerTU * 3};
+
 // Network node id used when a SecureData packet is addressed to every connected node.
 constexpr u16 BroadcastNetworkNodeId = 0xFFFF;
 
 // The Host has always dest_node_id 1
 constexpr u16 HostDestNodeId = 1;
 
+bool NWM_UDS::ReceiveBuffer::Push(u16 src_node_id, std::span<const u8> data) {
+    const EntryHeader header{static_cast<u16>(data.size()), src_node_id};
+    if (data.size() > std::numeric_limits<u16>::max() ||
+        buffer.size() - used < sizeof(header) + data.size()) {
+        return false;
+    }
+    const std::size_t tail = head + used;
+    Write(tail, {reinterpret_cast<const u8*>(&header), sizeof(header)});
+    Write(tail + sizeof(header), data);
+    used += sizeof(header) + data.size();
+    return true;
+}
+
+u16 NWM_UDS::ReceiveBuffer::FrontSize() const {
+    return ReadFrontHeader().size;
+}
+
+u16 NWM_UDS::ReceiveBuffer::FrontSourceNodeId() const {
+    return ReadFrontHeader().src_node_id;
+}
+
+void NWM_UDS::ReceiveBuffer::Pop(std::span<u8> out) {
+    const EntryHeader header = ReadFrontHeader();
+    Read(head + sizeof(header), out.first(std::min<std::size_t>(out.size(), header.size)));
+    head = (head + sizeof(header) + header.size) % buffer.size();
+    used -= sizeof(header) + header.size;
+    if (used == 0) {
+        head = 0;
+    }
+}
+
+NWM_UDS::ReceiveBuffer::EntryHeader NWM_UDS::ReceiveBuffer::ReadFrontHeader() const {
+    ASSERT(!IsEmpty());
+    EntryHeader header;
+    Read(head, {reinterpret_cast<u8*>(&header), sizeof(header)});
+    return header;
+}
+
+void NWM_UDS::ReceiveBuffer::Read(std::size_t offset, std::span<u8> out) const {
+    offset %= buffer.size();
+    const std::size_t first = std::min(out.size(), buffer.size() - offset);
+    std::memcpy(out.data(), buffer.data() + offset, first);
+    std::memcpy(out.data() + first, buffer.data(), out.size() - first);
+}
+
+void NWM_UDS::ReceiveBuffer::Write(std::size_t offset, std::span<const u8> data) {
+    offset %= buffer.size();
+    const std::size_t first = std::min(data.size(), buffer.size() - offset);
+    std::memcpy(buffer.data() + offset, data.data(), first);
+    std::memcpy(buffer.data(), data.data() + first, data.size() - first);
+}
+
 std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sender) {
     std::lock_guard lock(beacon_mutex);
+    std::list<Network::WifiPacket> beacons;
     if (sender != Network::BroadcastMac) {
-        std::list<Network::WifiPacket> filtered_list;
         const auto beacon = std::find_if(received_beacons.begin(), received_beacons.end(),
                                          [&sender](const Network::WifiPacket& packet) {
                                              return packet.transmitter_address == sender;
                                          });
         if (beacon != received_beacons.end()) {
-            filtered_list.push_back(*beacon);
+            beacons.push_back(*beacon);
             // TODO(B3N30): Check if the complete deque is cleared or just the fetched entries
             received_beacons.erase(beacon);
         }
-        return filtered_list;
+    } else {
+        beacons = std::move(received_beacons);
+        received_beacons.clear();
     }
-    return std::move(received_beacons);
+
+    // Hosts whose beacon didn't change since it was last sent would have sent it again meanwhile
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = beacon_cache.begin(); it != beacon_cache.end();) {
+        const auto& [address, cached] = *it;
+        if (now - cached.received_time > BeaconTimeout) {
+            it = beacon_cache.erase(it);
+            continue;
+        }
+        const bool included = std::any_of(beacons.begin(), beacons.end(),
+                                          [&address](const Network::WifiPacket& packet) {
+                                              return packet.transmitter_address == address;
+                                          });
+        if ((sender == Network::BroadcastMac || sender == address) && !included &&
+            beacons.size() < MaxBeaconFrames) {
+            beacons.push_back(cached.packet);
+        }
+        ++it;
+    }
+    return beacons;
 }
 
 /// Sends a WifiPacket to the room we're currently connected to.
@@ -161,6 +243,8 @@ void NWM_UDS::HandleBeaconFrame(const Network::WifiPacket& packet) {
     // Discard old beacons if the buffer is full.
     if (received_beacons.size() > MaxBeaconFrames)
         received_beacons.pop_front();
+
+    beacon_cache[packet.transmitter_address] = {packet, std::chrono::steady_clock::now()};
 }
 
 void NWM_UDS::HandleAssociationResponseFrame(const Network::WifiPacket& packet) {
@@ -323,7 +407,17 @@ void NWM_UDS::HandleEAPoLPacket(const Network::WifiPacket& packet) {
 }
 
 void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
+    constexpr std::size_t HeadersSize = sizeof(LLCHeader) + sizeof(SecureDataHeader);
+    if (packet.data.size() < HeadersSize) {
+        LOG_ERROR(Service_NWM, "Received a SecureData packet that is too small");
+        return;
+    }
     auto secure_data = ParseSecureDataHeader(packet.data);
+    if (secure_data.protocol_size < sizeof(SecureDataHeader) ||
+        secure_data.GetActualDataSize() > packet.data.size() - HeadersSize) {
+        LOG_ERROR(Service_NWM, "Received a SecureData packet with an invalid size");
+        return;
+    }
     std::unique_lock hle_lock(HLE::g_hle_lock, std::defer_lock);
     std::unique_lock lock(connection_status_mutex, std::defer_lock);
     std::lock(hle_lock, lock);
@@ -378,8 +472,13 @@ void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
         channel_info->second.network_node_id != secure_data.src_node_id)
         return;
 
-    // Add the received packet to the data queue.
-    channel_info->second.received_packets.emplace_back(packet.data);
+    // Add the received data to the receive buffer, hardware drops the packets that don't fit.
+    const std::span data{packet.data.data() + HeadersSize, secure_data.GetActualDataSize()};
+    if (!channel_info->second.received_packets.Push(secure_data.src_node_id, data)) {
+        LOG_DEBUG(Service_NWM, "Receive buffer of channel {} is full, dropped a packet",
+                  secure_data.data_channel);
+        return;
+    }
 
     // Signal the data event. We can do this directly because we locked g_hle_lock
     channel_info->second.event->Signal();
@@ -801,9 +900,15 @@ void NWM_UDS::Bind(Kernel::HLERequestContext& ctx) {
                                              "NWM::BindNodeEvent" + std::to_string(bind_node_id));
     std::lock_guard lock(connection_status_mutex);
 
+    // On hardware the receive buffers are carved out of the shared memory given to Initialize
+    if (recv_buffer_memory) {
+        recv_buffer_size = std::min<u32>(recv_buffer_size, recv_buffer_memory->GetSize());
+    }
+
     ASSERT(channel_data.find(data_channel) == channel_data.end());
     // TODO(B3N30): Support more than one bind node per channel.
-    channel_data[data_channel] = {bind_node_id, data_channel, network_node_id, event};
+    channel_data[data_channel] = {bind_node_id, data_channel, network_node_id, event,
+                                  ReceiveBuffer{recv_buffer_size}};
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
@@ -904,6 +1009,7 @@ ResultCode NWM_UDS::BeginHostingNetwork(const u8* network_info_buffer,
     connection_status_event->Signal();
 
     // Start broadcasting the network, send a beacon frame every 102.4ms.
+    sent_beacon_frame.clear();
     system.CoreTiming().ScheduleEvent(msToCycles(DefaultBeaconInterval * MillisecondsPerTU),
                                       beacon_broadcast_event, 0);
 
@@ -1200,7 +1306,8 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    if (channel->second.received_packets.empty()) {
+    ReceiveBuffer& received_packets = channel->second.received_packets;
+    if (received_packets.IsEmpty()) {
         std::vector<u8> output_buffer(buff_size);
         IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
         rb.Push(RESULT_SUCCESS);
@@ -1210,10 +1317,8 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    const auto& next_packet = channel->second.received_packets.front();
-
-    auto secure_data = ParseSecureDataHeader(next_packet);
-    auto data_size = secure_data.GetActualDataSize();
+    const u32 data_size = received_packets.FrontSize();
+    const u16 src_node_id = received_packets.FrontSourceNodeId();
 
     if (data_size > max_out_buff_size) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1226,15 +1331,12 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
 
     std::vector<u8> output_buffer(buff_size);
     // Write the actual data.
-    std::memcpy(output_buffer.data(),
-                next_packet.data() + sizeof(LLCHeader) + sizeof(SecureDataHeader), data_size);
+    received_packets.Pop(output_buffer);
 
     rb.Push(RESULT_SUCCESS);
     rb.Push<u32>(data_size);
-    rb.Push<u16>(secure_data.src_node_id);
+    rb.Push<u16>(src_node_id);
     rb.PushStaticBuffer(std::move(output_buffer), 0);
-
-    channel->second.received_packets.pop_front();
 }
 
 void NWM_UDS::GetChannel(Kernel::HLERequestContext& ctx) {
@@ -1450,14 +1552,20 @@ void NWM_UDS::BeaconBroadcastCallback(std::uintptr_t user_data, s64 cycles_late)
 
     std::vector<u8> frame = GenerateBeaconFrame(network_info, node_info);
 
-    using Network::WifiPacket;
-    WifiPacket packet;
-    packet.type = WifiPacket::PacketType::Beacon;
-    packet.data = std::move(frame);
-    packet.destination_address = Network::BroadcastMac;
-    packet.channel = network_channel;
+    // The other members of the room keep the last beacon, so only send it when it changed
+    if (frame != sent_beacon_frame || ++beacons_since_sent >= BeaconRefreshInterval) {
+        sent_beacon_frame = frame;
+        beacons_since_sent = 0;
 
-    SendPacket(packet);
+        using Network::WifiPacket;
+        WifiPacket packet;
+        packet.type = WifiPacket::PacketType::Beacon;
+        packet.data = std::move(frame);
+        packet.destination_address = Network::BroadcastMac;
+        packet.channel = network_channel;
+
+        SendPacket(packet);
+    }
 
     // Start broadcasting the network, send a beacon frame every 102.4ms.
     system.CoreTiming().ScheduleEvent(msToCycles(DefaultBeaconInterval * MillisecondsPerTU) -
@@ -6,12 +6,14 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <deque>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 #include <boost/optional.hpp>
@@ -511,8 +513,8 @@ private:
     // Event that is signaled every time the connection status changes.
     std::shared_ptr<Kernel::Event> connection_status_event;
 
-    // Shared memory provided by the application to store the receive buffer.
-    // This is not currently used.
+    // Shared memory provided by the application to store the receive buffers.
+    // This is not currently used, the buffers of the bind nodes are kept by the service.
     std::shared_ptr<Kernel::SharedMemory> recv_buffer_memory;
 
     // Connection status of this 3DS.
@@ -530,13 +532,57 @@ private:
     // Node information about our own system.
     NodeInfo current_node;
 
+    /**
+     * Receive buffer of a bind node. Like the buffer of the size given to Bind on hardware, it
+     * holds the received packets back to back in a ring, and packets that don't fit anymore are
+     * dropped. Storing a packet doesn't allocate.
+     */
+    class ReceiveBuffer {
+    public:
+        explicit ReceiveBuffer(std::size_t size = 0) : buffer(size) {}
+
+        /**
+         * Stores the data of a received packet.
+         * @return Whether there was enough room for the packet
+         */
+        bool Push(u16 src_node_id, std::span<const u8> data);
+
+        /// Returns the size of the oldest packet's data, the buffer must not be empty
+        u16 FrontSize() const;
+
+        /// Returns the node id the oldest packet was sent from, the buffer must not be empty
+        u16 FrontSourceNodeId() const;
+
+        /// Copies the start of the oldest packet's data to out, and removes the packet
+        void Pop(std::span<u8> out);
+
+        bool IsEmpty() const {
+            return used == 0;
+        }
+
+    private:
+        /// Header stored in front of the data of every packet
+        struct EntryHeader {
+            u16 size;
+            u16 src_node_id;
+        };
+
+        EntryHeader ReadFrontHeader() const;
+        void Read(std::size_t offset, std::span<u8> out) const;
+        void Write(std::size_t offset, std::span<const u8> data);
+
+        std::vector<u8> buffer;
+        std::size_t head = 0; ///< Offset of the oldest packet
+        std::size_t used = 0; ///< Number of bytes used by the stored packets
+    };
+
     struct BindNodeData {
         u32 bind_node_id;    ///< Id of the bind node associated with this data.
         u8 channel;          ///< Channel that this bind node was bound to.
         u16 network_node_id; ///< Node id this bind node is associated with, only packets from this
                              /// network node will be received.
-        std::shared_ptr<Kernel::Event> event;         ///< Receive event for this bind node.
-        std::deque<std::vector<u8>> received_packets; ///< List of packets received on this channel.
+        std::shared_ptr<Kernel::Event> event; ///< Receive event for this bind node.
+        ReceiveBuffer received_packets;       ///< Packets received on this channel.
     };
 
     // Mapping of data channels to their internal data.
@@ -584,6 +630,19 @@ private:
     // List of the last <MaxBeaconFrames> beacons received from the network.
     std::list<Network::WifiPacket> received_beacons;
 
+    struct CachedBeacon {
+        Network::WifiPacket packet;
+        std::chrono::steady_clock::time_point received_time;
+    };
+
+    // Last beacon received from each host. Hosts only resend a beacon when it changes or once in
+    // a while, so these stand in for the beacons that weren't sent.
+    std::map<MacAddress, CachedBeacon> beacon_cache;
+
+    // Last beacon frame that was sent while hosting, and the number of beacon intervals since.
+    std::vector<u8> sent_beacon_frame;
+    u32 beacons_since_sent = 0;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
     friend class boost::serialization::access;
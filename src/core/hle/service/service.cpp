@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
@@ -144,6 +145,14 @@ void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* function
     for (std::size_t i = 0; i < n; ++i) {
         // Usually this array is sorted by id already, so hint to insert at the end
         handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
+
+        const u32 command = functions[i].expected_header >> 16;
+        if (command >= handlers_by_command.size()) {
+            handlers_by_command.resize(command + 1);
+        }
+        if (handlers_by_command[command].name == nullptr) {
+            handlers_by_command[command] = functions[i];
+        }
     }
 }
 
@@ -170,8 +179,15 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(u32* cmd_buf, const Funct
 
 void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context) {
     u32 header_code = context.CommandBuffer()[0];
-    auto itr = handlers.find(header_code);
-    const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
+    const u32 command = header_code >> 16;
+    const FunctionInfoBase* info = nullptr;
+    if (command < handlers_by_command.size() &&
+        handlers_by_command[command].expected_header == header_code &&
+        handlers_by_command[command].name != nullptr) {
+        info = &handlers_by_command[command];
+    } else if (auto itr = handlers.find(header_code); itr != handlers.end()) {
+        info = &itr->second;
+    }
     if (info == nullptr || info->handler_callback == nullptr) {
         context.ReportUnimplemented();
         return ReportUnimplementedFunction(context.CommandBuffer(), info);
@@ -212,13 +228,31 @@ static bool AttemptLLE(const ServiceModuleInfo& service_module) {
 
 /// Initialize ServiceManager
 void Init(Core::System& core) {
+    // The time each module takes to boot is recorded in the trace, and logged
+    static const auto trace_categories = [] {
+        std::array<Common::Trace::Category, service_module_map.size()> categories;
+        for (std::size_t i = 0; i < service_module_map.size(); ++i) {
+            categories[i] = {"Service", service_module_map[i].name.c_str()};
+        }
+        return categories;
+    }();
+
     SM::ServiceManager::InstallInterfaces(core);
 
-    for (const auto& service_module : service_module_map) {
+    const u64 start_time = Common::Trace::Now();
+    for (std::size_t i = 0; i < service_module_map.size(); ++i) {
+        const auto& service_module = service_module_map[i];
+        const u64 module_start_time = Common::Trace::Now();
         if (!AttemptLLE(service_module) && service_module.init_function != nullptr)
             service_module.init_function(core);
+        const u64 module_end_time = Common::Trace::Now();
+        Common::Trace::CurrentThreadTrack().Record(trace_categories[i], module_start_time,
+                                                   module_end_time);
+        LOG_DEBUG(Service, "Initialized {} in {} us", service_module.name,
+                  (module_end_time - module_start_time) / 1000);
     }
-    LOG_DEBUG(Service, "initialized OK");
+    LOG_INFO(Service, "Initialized the services in {} ms",
+             (Common::Trace::Now() - start_time) / 1000000);
 }
 
 } // namespace Service
@@ -9,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/container/flat_map.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -103,6 +104,10 @@ private:
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
+    /// The handlers indexed by the command id in their header, so that a request is dispatched
+    /// without a search. Slots without a handler have no name. When several handlers have the same
+    /// id, the others are only in the map.
+    std::vector<FunctionInfoBase> handlers_by_command;
 };
 
 /**
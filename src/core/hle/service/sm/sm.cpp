@@ -13,7 +13,7 @@
 namespace Service::SM {
 
 static ResultCode ValidateServiceName(const std::string& name) {
-    if (name.size() <= 0 || name.size() > 8) {
+    if (name.size() <= 0 || name.size() > MaxServiceNameSize) {
         return ERR_INVALID_NAME_SIZE;
     }
     if (name.find('\0') != std::string::npos) {
@@ -37,13 +37,14 @@ ResultVal<std::shared_ptr<Kernel::ServerPort>> ServiceManager::RegisterService(
 
     CASCADE_CODE(ValidateServiceName(name));
 
-    if (registered_services.find(name) != registered_services.end())
+    const u64 key = GetServiceKey(name);
+    if (registered_services.find(key) != registered_services.end())
         return ERR_ALREADY_REGISTERED;
 
     auto [server_port, client_port] = system.Kernel().CreatePortPair(max_sessions, name);
 
-    registered_services_inverse.emplace(client_port->GetObjectId(), name);
-    registered_services.emplace(std::move(name), std::move(client_port));
+    registered_services_inverse.emplace(client_port->GetObjectId(), std::move(name));
+    registered_services.emplace(key, std::move(client_port));
     return MakeResult(std::move(server_port));
 }
 
@@ -51,7 +52,7 @@ ResultVal<std::shared_ptr<Kernel::ClientPort>> ServiceManager::GetServicePort(
     const std::string& name) {
 
     CASCADE_CODE(ValidateServiceName(name));
-    auto it = registered_services.find(name);
+    auto it = registered_services.find(GetServiceKey(name));
     if (it == registered_services.end()) {
         return ERR_SERVICE_NOT_REGISTERED;
     }
@@ -67,8 +68,9 @@ ResultVal<std::shared_ptr<Kernel::ClientSession>> ServiceManager::ConnectToServi
 }
 
 std::string ServiceManager::GetServiceNameByPortId(u32 port) const {
-    if (registered_services_inverse.count(port)) {
-        return registered_services_inverse.at(port);
+    const auto it = registered_services_inverse.find(port);
+    if (it != registered_services_inverse.end()) {
+        return it->second;
     }
 
     return "";
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <boost/serialization/shared_ptr.hpp>
@@ -45,6 +47,9 @@ constexpr ResultCode ERR_ALREADY_REGISTERED(ErrorDescription::AlreadyExists, Err
                                             ErrorSummary::WrongArgument,
                                             ErrorLevel::Permanent); // 0xD9001BFC
 
+/// The most characters a service name can have
+constexpr std::size_t MaxServiceNameSize = 8;
+
 class ServiceManager {
 public:
     static void InstallInterfaces(Core::System& system);
@@ -62,7 +67,9 @@ public:
     std::shared_ptr<T> GetService(const std::string& service_name) const {
         static_assert(std::is_base_of_v<Kernel::SessionRequestHandler, T>,
                       "Not a base of ServiceFrameworkBase");
-        auto service = registered_services.find(service_name);
+        auto service = service_name.size() <= MaxServiceNameSize
+                           ? registered_services.find(GetServiceKey(service_name))
+                           : registered_services.end();
         if (service == registered_services.end()) {
             LOG_DEBUG(Service, "Can't find service: {}", service_name);
             return nullptr;
@@ -75,27 +82,51 @@ public:
     }
 
 private:
+    /**
+     * Packs a name of up to 8 characters into an integer, so that looking it up doesn't need to
+     * hash a string. Names can't contain NUL, so the padding keeps the keys unique.
+     */
+    static u64 GetServiceKey(std::string_view name) {
+        u64 key = 0;
+        std::memcpy(&key, name.data(), name.size());
+        return key;
+    }
+
+    static std::string GetServiceName(u64 key) {
+        const char* name = reinterpret_cast<const char*>(&key);
+        return std::string(name, strnlen(name, MaxServiceNameSize));
+    }
+
     Core::System& system;
     std::weak_ptr<SRV> srv_interface;
 
-    /// Map of registered services, retrieved using GetServicePort or ConnectToService.
-    std::unordered_map<std::string, std::shared_ptr<Kernel::ClientPort>> registered_services;
+    /// Map of registered services by their keys, retrieved using GetServicePort or
+    /// ConnectToService.
+    std::unordered_map<u64, std::shared_ptr<Kernel::ClientPort>> registered_services;
 
     // For IPC Recorder
     /// client port Object id -> service name
     std::unordered_map<u32, std::string> registered_services_inverse;
 
+    // The services are saved by name, as they were before they were keyed by integers
     template <class Archive>
     void save(Archive& ar, const unsigned int file_version) const {
-        ar << registered_services;
+        std::unordered_map<std::string, std::shared_ptr<Kernel::ClientPort>> services;
+        for (const auto& [key, port] : registered_services) {
+            services.emplace(GetServiceName(key), port);
+        }
+        ar << services;
     }
 
     template <class Archive>
     void load(Archive& ar, const unsigned int file_version) {
-        ar >> registered_services;
+        std::unordered_map<std::string, std::shared_ptr<Kernel::ClientPort>> services;
+        ar >> services;
+        registered_services.clear();
         registered_services_inverse.clear();
-        for (const auto& pair : registered_services) {
-            registered_services_inverse.emplace(pair.second->GetObjectId(), pair.first);
+        for (auto& [name, port] : services) {
+            registered_services_inverse.emplace(port->GetObjectId(), name);
+            registered_services.emplace(GetServiceKey(name), std::move(port));
         }
     }
 
@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <optional>
 #include <type_traits>
 #include <vector>
 #include "common/archives.h"
@@ -14,7 +16,9 @@
 #include "common/scope_exit.h"
 #include "common/swap.h"
 #include "core/core.h"
+#include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
+#include "core/hle/kernel/event.h"
 #include "core/hle/kernel/shared_memory.h"
 #include "core/hle/result.h"
 #include "core/hle/service/soc_u.h"
@@ -354,6 +358,12 @@ struct CTRAddrInfo {
 
 static_assert(sizeof(CTRAddrInfo) == 0x130, "Size of CTRAddrInfo is not correct");
 
+struct SOC_U::SocketWait {
+    std::vector<pollfd> fds;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    std::shared_ptr<Kernel::Event> event;
+};
+
 void SOC_U::PreTimerAdjust() {
     timer_adjust_handle = Core::System::GetInstance().GetRunningCore().GetTimer().StartAdjust();
 }
@@ -366,6 +376,102 @@ void SOC_U::CleanupSockets() {
     for (auto sock : open_sockets)
         closesocket(sock.second.socket_fd);
     open_sockets.clear();
+
+    // The sleeping threads find their sockets closed
+    for (auto& wait : socket_waits) {
+        wait.event->Signal();
+    }
+    socket_waits.clear();
+}
+
+/// Interval at which the sockets of the sleeping threads are polled
+constexpr int SOCKET_POLL_INTERVAL_MS = 1;
+
+/// Handles the request again once the sockets it waited for are ready
+class SOC_U::RetryCallback : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    explicit RetryCallback(std::shared_ptr<SOC_U> soc_) : soc(std::move(soc_)) {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) override {
+        soc->resuming_request = true;
+        soc->HandleSyncRequest(ctx);
+        soc->resuming_request = false;
+    }
+
+private:
+    RetryCallback() = default;
+
+    std::shared_ptr<SOC_U> soc;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        ar& soc;
+    }
+    friend class boost::serialization::access;
+};
+
+void SOC_U::WaitForSockets(Kernel::HLERequestContext& ctx, SocketWait wait) {
+    // Timeouts are kept in host time, like when the host calls waited for the sockets
+    wait.event = ctx.SleepClientThread(
+        "soc_u::WaitForSockets", std::chrono::nanoseconds{0},
+        std::make_shared<RetryCallback>(std::static_pointer_cast<SOC_U>(shared_from_this())));
+    if (socket_waits.empty()) {
+        Core::System::GetInstance().CoreTiming().ScheduleEvent(
+            msToCycles(SOCKET_POLL_INTERVAL_MS), poll_sockets_event);
+    }
+    socket_waits.push_back(std::move(wait));
+}
+
+/// Changes whether a host socket blocks, regardless of what the guest asked for
+static void SetHostBlocking(const SocketHolder& holder, bool blocking) {
+#ifdef _WIN32
+    unsigned long nonblocking = blocking ? 0 : 1;
+    ioctlsocket(holder.socket_fd, FIONBIO, &nonblocking);
+#else
+    const int flags = ::fcntl(holder.socket_fd, F_GETFL, 0);
+    ::fcntl(holder.socket_fd, F_SETFL, blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+#endif
+}
+
+bool SOC_U::WaitForSocket(Kernel::HLERequestContext& ctx, const SocketHolder& holder,
+                          short events) {
+    if (!holder.blocking || resuming_request) {
+        return false;
+    }
+    pollfd fd{};
+    fd.fd = static_cast<decltype(fd.fd)>(holder.socket_fd);
+    fd.events = events;
+    const s32 ready = ::poll(&fd, 1, 0);
+    if (ready != 0) {
+        // Errors are left for the actual call to report
+        return false;
+    }
+    WaitForSockets(ctx, {{fd}, std::nullopt, nullptr});
+    return true;
+}
+
+void SOC_U::PollSocketWaits(s64 cycles_late) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = socket_waits.begin(); it != socket_waits.end();) {
+        // The thread may also have been stopped while it slept
+        if (it->event->GetWaitingThreads().empty()) {
+            it = socket_waits.erase(it);
+            continue;
+        }
+        const s32 ready = ::poll(it->fds.data(), static_cast<u32>(it->fds.size()), 0);
+        if (ready != 0 || (it->deadline && now >= *it->deadline)) {
+            it->event->Signal();
+            it = socket_waits.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    if (!socket_waits.empty()) {
+        Core::System::GetInstance().CoreTiming().ScheduleEvent(
+            msToCycles(SOCKET_POLL_INTERVAL_MS) - cycles_late, poll_sockets_event);
+    }
 }
 
 void SOC_U::Socket(Kernel::HLERequestContext& ctx) {
@@ -499,6 +605,7 @@ void SOC_U::Fcntl(Kernel::HLERequestContext& ctx) {
             posix_ret = TranslateError(GET_ERRNO);
             return;
         }
+        fd_info->second.blocking = (flags & O_NONBLOCK) == 0;
 #endif
     } else {
         LOG_ERROR(Service_SOC, "Unsupported command ({}) in fcntl call", ctr_cmd);
@@ -529,9 +636,6 @@ void SOC_U::Listen(Kernel::HLERequestContext& ctx) {
 }
 
 void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x04, 2, 2);
     const auto socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -542,6 +646,9 @@ void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
     }
     [[maybe_unused]] const auto max_addr_len = static_cast<socklen_t>(rp.Pop<u32>());
     rp.PopPID();
+    if (WaitForSocket(ctx, fd_info->second, POLLIN)) {
+        return;
+    }
     sockaddr addr;
     socklen_t addr_len = sizeof(addr);
     PreTimerAdjust();
@@ -613,6 +720,60 @@ void SOC_U::Close(Kernel::HLERequestContext& ctx) {
     rb.Push(ret);
 }
 
+s32 SOC_U::SendToImpl(const SocketHolder& holder, const u8* data, u32 len, u32 flags,
+                      u32 addr_len, const std::vector<u8>& dest_addr_buff) {
+    s32 ret = -1;
+    PreTimerAdjust();
+    if (addr_len > 0) {
+        CTRSockAddr ctr_dest_addr;
+        std::memcpy(&ctr_dest_addr, dest_addr_buff.data(), sizeof(ctr_dest_addr));
+        sockaddr dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
+        ret = ::sendto(holder.socket_fd, reinterpret_cast<const char*>(data), len, flags,
+                       &dest_addr, sizeof(dest_addr));
+    } else {
+        ret = ::sendto(holder.socket_fd, reinterpret_cast<const char*>(data), len, flags, nullptr,
+                       0);
+    }
+    PostTimerAdjust();
+
+    if (ret == SOCKET_ERROR_VALUE)
+        ret = TranslateError(GET_ERRNO);
+    return ret;
+}
+
+void SOC_U::SendToOther(Kernel::HLERequestContext& ctx) {
+    IPC::RequestParser rp(ctx, 0x09, 4, 6);
+    u32 socket_handle = rp.Pop<u32>();
+    auto fd_info = open_sockets.find(socket_handle);
+    if (fd_info == open_sockets.end()) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
+        rb.Push(ERR_INVALID_HANDLE);
+        return;
+    }
+    u32 len = rp.Pop<u32>();
+    u32 flags = rp.Pop<u32>();
+    u32 addr_len = rp.Pop<u32>();
+    rp.PopPID();
+    auto dest_addr_buff = rp.PopStaticBuffer();
+    auto& buffer = rp.PopMappedBuffer();
+    len = std::min<u32>(len, static_cast<u32>(buffer.GetSize()));
+
+    // Send straight from the guest buffer when it can be viewed directly
+    const std::span<u8> view = buffer.GetSpan(0, len);
+    std::vector<u8> input_buff;
+    if (view.empty()) {
+        input_buff.resize(len);
+        buffer.Read(input_buff.data(), 0, len);
+    }
+    const u8* data = view.empty() ? input_buff.data() : view.data();
+    const s32 ret = SendToImpl(fd_info->second, data, len, flags, addr_len, dest_addr_buff);
+
+    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+    rb.Push(RESULT_SUCCESS);
+    rb.Push(ret);
+    rb.PushMappedBuffer(buffer);
+}
+
 void SOC_U::SendTo(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x0A, 4, 6);
     u32 socket_handle = rp.Pop<u32>();
@@ -629,22 +790,8 @@ void SOC_U::SendTo(Kernel::HLERequestContext& ctx) {
     auto input_buff = rp.PopStaticBuffer();
     auto dest_addr_buff = rp.PopStaticBuffer();
 
-    s32 ret = -1;
-    PreTimerAdjust();
-    if (addr_len > 0) {
-        CTRSockAddr ctr_dest_addr;
-        std::memcpy(&ctr_dest_addr, dest_addr_buff.data(), sizeof(ctr_dest_addr));
-        sockaddr dest_addr = CTRSockAddr::ToPlatform(ctr_dest_addr);
-        ret = ::sendto(fd_info->second.socket_fd, reinterpret_cast<const char*>(input_buff.data()),
-                       len, flags, &dest_addr, sizeof(dest_addr));
-    } else {
-        ret = ::sendto(fd_info->second.socket_fd, reinterpret_cast<const char*>(input_buff.data()),
-                       len, flags, nullptr, 0);
-    }
-    PostTimerAdjust();
-
-    if (ret == SOCKET_ERROR_VALUE)
-        ret = TranslateError(GET_ERRNO);
+    const s32 ret =
+        SendToImpl(fd_info->second, input_buff.data(), len, flags, addr_len, dest_addr_buff);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
     rb.Push(RESULT_SUCCESS);
@@ -665,9 +812,17 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
     u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
     auto& buffer = rp.PopMappedBuffer();
+    if (WaitForSocket(ctx, fd_info->second, POLLIN)) {
+        return;
+    }
 
+    len = std::min<u32>(len, static_cast<u32>(buffer.GetSize()));
+
+    // Receive straight into the guest buffer when it can be viewed directly
+    const std::span<u8> view = buffer.GetSpan(0, len);
     CTRSockAddr ctr_src_addr;
-    std::vector<u8> output_buff(len);
+    std::vector<u8> output_buff(view.empty() ? len : 0);
+    u8* const output = view.empty() ? output_buff.data() : view.data();
     std::vector<u8> addr_buff(sizeof(ctr_src_addr));
     sockaddr src_addr;
     socklen_t src_addr_len = sizeof(src_addr);
@@ -675,21 +830,21 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
     s32 ret = -1;
     PreTimerAdjust();
     if (addr_len > 0) {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, &src_addr, &src_addr_len);
+        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output), len, flags,
+                         &src_addr, &src_addr_len);
         if (ret >= 0 && src_addr_len > 0) {
             ctr_src_addr = CTRSockAddr::FromPlatform(src_addr);
             std::memcpy(addr_buff.data(), &ctr_src_addr, sizeof(ctr_src_addr));
         }
     } else {
-        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output_buff.data()),
-                         len, flags, NULL, 0);
+        ret = ::recvfrom(fd_info->second.socket_fd, reinterpret_cast<char*>(output), len, flags,
+                         NULL, 0);
         addr_buff.resize(0);
     }
     PostTimerAdjust();
     if (ret == SOCKET_ERROR_VALUE) {
         ret = TranslateError(GET_ERRNO);
-    } else {
+    } else if (view.empty()) {
         buffer.Write(output_buff.data(), 0, ret);
     }
 
@@ -701,9 +856,6 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
 }
 
 void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x08, 4, 2);
     u32 socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -716,6 +868,9 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
     u32 flags = rp.Pop<u32>();
     u32 addr_len = rp.Pop<u32>();
     rp.PopPID();
+    if (WaitForSocket(ctx, fd_info->second, POLLIN)) {
+        return;
+    }
 
     CTRSockAddr ctr_src_addr;
     std::vector<u8> output_buff(len);
@@ -775,9 +930,16 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
         platform_pollfd[i] = CTRPollFD::ToPlatform(*this, ctr_fds[i]);
     }
 
-    PreTimerAdjust();
-    s32 ret = ::poll(platform_pollfd.data(), nfds, timeout);
-    PostTimerAdjust();
+    // Only check the sockets here, a thread that waits for them sleeps until they are ready
+    s32 ret = ::poll(platform_pollfd.data(), nfds, 0);
+    if (ret == 0 && timeout != 0 && !resuming_request) {
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        if (timeout > 0) {
+            deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{timeout};
+        }
+        WaitForSockets(ctx, {std::move(platform_pollfd), deadline, nullptr});
+        return;
+    }
 
     // Now update the output 3ds_pollfd structure
     for (u32 i = 0; i < nfds; i++) {
@@ -883,9 +1045,6 @@ void SOC_U::GetPeerName(Kernel::HLERequestContext& ctx) {
 }
 
 void SOC_U::Connect(Kernel::HLERequestContext& ctx) {
-    // TODO(Subv): Calling this function on a blocking socket will block the emu thread,
-    // preventing graceful shutdown when closing the emulator, this can be fixed by always
-    // performing nonblocking operations and spinlock until the data is available
     IPC::RequestParser rp(ctx, 0x06, 2, 4);
     const auto socket_handle = rp.Pop<u32>();
     auto fd_info = open_sockets.find(socket_handle);
@@ -898,15 +1057,41 @@ void SOC_U::Connect(Kernel::HLERequestContext& ctx) {
     rp.PopPID();
     auto input_addr_buf = rp.PopStaticBuffer();
 
-    CTRSockAddr ctr_input_addr;
-    std::memcpy(&ctr_input_addr, input_addr_buf.data(), sizeof(ctr_input_addr));
+    const SocketHolder& holder = fd_info->second;
+    s32 ret = 0;
+    if (resuming_request) {
+        // The connection that was started before the thread went to sleep is done
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (::getsockopt(holder.socket_fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error),
+                         &error_len) != 0) {
+            error = GET_ERRNO;
+        }
+        ret = error != 0 ? TranslateError(error) : 0;
+    } else {
+        CTRSockAddr ctr_input_addr;
+        std::memcpy(&ctr_input_addr, input_addr_buf.data(), sizeof(ctr_input_addr));
 
-    sockaddr input_addr = CTRSockAddr::ToPlatform(ctr_input_addr);
-    PreTimerAdjust();
-    s32 ret = ::connect(fd_info->second.socket_fd, &input_addr, sizeof(input_addr));
-    PostTimerAdjust();
-    if (ret != 0)
-        ret = TranslateError(GET_ERRNO);
+        // A blocking connect is started nonblocking, so that the thread can sleep until it is done
+        sockaddr input_addr = CTRSockAddr::ToPlatform(ctr_input_addr);
+        if (holder.blocking) {
+            SetHostBlocking(holder, false);
+        }
+        ret = ::connect(holder.socket_fd, &input_addr, sizeof(input_addr));
+        const int error = ret != 0 ? GET_ERRNO : 0;
+        if (holder.blocking) {
+            SetHostBlocking(holder, true);
+            if (error == ERRNO(EINPROGRESS) || error == ERRNO(EWOULDBLOCK)) {
+                pollfd fd{};
+                fd.fd = static_cast<decltype(fd.fd)>(holder.socket_fd);
+                fd.events = POLLOUT;
+                WaitForSockets(ctx, {{fd}, std::nullopt, nullptr});
+                return;
+            }
+        }
+        if (ret != 0)
+            ret = TranslateError(error);
+    }
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 0);
     rb.Push(RESULT_SUCCESS);
@@ -1109,7 +1294,7 @@ SOC_U::SOC_U() : ServiceFramework("soc:U") {
         {0x00060084, &SOC_U::Connect, "Connect"},
         {0x00070104, &SOC_U::RecvFromOther, "recvfrom_other"},
         {0x00080102, &SOC_U::RecvFrom, "RecvFrom"},
-        {0x00090106, nullptr, "sendto_other"},
+        {0x00090106, &SOC_U::SendToOther, "sendto_other"},
         {0x000A0106, &SOC_U::SendTo, "SendTo"},
         {0x000B0042, &SOC_U::Close, "Close"},
         {0x000C0082, &SOC_U::Shutdown, "Shutdown"},
@@ -1138,6 +1323,10 @@ SOC_U::SOC_U() : ServiceFramework("soc:U") {
 
     RegisterHandlers(functions);
 
+    poll_sockets_event = Core::System::GetInstance().CoreTiming().RegisterEvent(
+        "SOC_U::PollSocketWaits",
+        [this](std::uintptr_t user_data, s64 cycles_late) { PollSocketWaits(cycles_late); });
+
 #ifdef _WIN32
     WSADATA data;
     WSAStartup(MAKEWORD(2, 2), &data);
@@ -1145,6 +1334,7 @@ SOC_U::SOC_U() : ServiceFramework("soc:U") {
 }
 
 SOC_U::~SOC_U() {
+    Core::System::GetInstance().CoreTiming().UnscheduleEvent(poll_sockets_event, 0);
     CleanupSockets();
 #ifdef _WIN32
     WSACleanup();
@@ -1157,3 +1347,5 @@ void InstallInterfaces(Core::System& system) {
 }
 
 } // namespace Service::SOC
+
+SERIALIZE_EXPORT_IMPL(Service::SOC::SOC_U::RetryCallback)
@@ -4,14 +4,22 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 #include <boost/serialization/unordered_map.hpp>
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
 class System;
-}
+struct TimingEventType;
+} // namespace Core
+
+namespace Kernel {
+class Event;
+} // namespace Kernel
 
 namespace Service::SOC {
 
@@ -24,7 +32,7 @@ struct SocketHolder {
     u32 socket_fd; ///< The socket descriptor
 #endif // _WIN32
 
-    bool blocking; ///< Whether the socket is blocking or not, it is only read on Windows.
+    bool blocking; ///< Whether the socket is blocking or not, as seen by the guest
 
 private:
     template <class Archive>
@@ -40,6 +48,8 @@ public:
     SOC_U();
     ~SOC_U();
 
+    class RetryCallback;
+
 private:
     static constexpr ResultCode ERR_INVALID_HANDLE =
         ResultCode(ErrorDescription::InvalidHandle, ErrorModule::SOC, ErrorSummary::InvalidArgument,
@@ -52,6 +62,7 @@ private:
     void Accept(Kernel::HLERequestContext& ctx);
     void GetHostId(Kernel::HLERequestContext& ctx);
     void Close(Kernel::HLERequestContext& ctx);
+    void SendToOther(Kernel::HLERequestContext& ctx);
     void SendTo(Kernel::HLERequestContext& ctx);
     void RecvFromOther(Kernel::HLERequestContext& ctx);
     void RecvFrom(Kernel::HLERequestContext& ctx);
@@ -70,6 +81,11 @@ private:
     void GetAddrInfoImpl(Kernel::HLERequestContext& ctx);
     void GetNameInfoImpl(Kernel::HLERequestContext& ctx);
 
+    /// Sends len bytes of data on a socket, to the address in dest_addr_buff if addr_len is
+    /// nonzero. Returns the number of bytes sent or the translated error.
+    s32 SendToImpl(const SocketHolder& holder, const u8* data, u32 len, u32 flags, u32 addr_len,
+                   const std::vector<u8>& dest_addr_buff);
+
     // Socked ids
     u32 next_socket_id = 3;
     u32 GetNextSocketID() {
@@ -84,6 +100,32 @@ private:
     /// Close all open sockets
     void CleanupSockets();
 
+    /// A guest thread sleeping until some of its host sockets are ready
+    struct SocketWait;
+
+    /**
+     * Puts the client thread to sleep instead of blocking the emulation in a host socket call,
+     * until the sockets of the wait are ready or its timeout expires. The request is then handled
+     * again, and takes whatever result the sockets give at that point.
+     */
+    void WaitForSockets(Kernel::HLERequestContext& ctx, SocketWait wait);
+
+    /// Waits for a blocking socket to be ready for the given poll events, returns whether the
+    /// client thread was put to sleep
+    bool WaitForSocket(Kernel::HLERequestContext& ctx, const SocketHolder& holder, short events);
+
+    /// Wakes up the threads whose sockets are ready, periodically while there are any
+    void PollSocketWaits(s64 cycles_late);
+
+    /// Event that polls the sockets of the sleeping threads
+    Core::TimingEventType* poll_sockets_event;
+
+    /// Threads waiting for their sockets, these are lost in savestates like the host sockets
+    std::list<SocketWait> socket_waits;
+
+    /// Whether the request being handled is for a thread woken up from a socket wait
+    bool resuming_request = false;
+
     /// Holds info about the currently open sockets
     friend struct CTRPollFD;
     std::unordered_map<u32, SocketHolder> open_sockets;
@@ -102,3 +144,4 @@ void InstallInterfaces(Core::System& system);
 } // namespace Service::SOC
 
 BOOST_CLASS_EXPORT_KEY(Service::SOC::SOC_U)
+BOOST_CLASS_EXPORT_KEY(Service::SOC::SOC_U::RetryCallback)
@@ -3,7 +3,9 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <exception>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <cryptopp/aes.h>
@@ -495,7 +497,16 @@ void LoadPresetKeys() {
 } // namespace
 
 void InitKeys() {
+    static std::atomic_bool loaded{false};
+    if (loaded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Loading the keys opens the firmware NCCHs, which call this again. The flag returns early on
+    // the thread loading them, the mutex makes the other threads wait for it.
+    static std::recursive_mutex mutex;
     static bool initialized = false;
+    std::lock_guard lock{mutex};
     if (initialized)
         return;
     initialized = true;
@@ -505,29 +516,36 @@ void InitKeys() {
     LoadSafeModeNativeFirmKeysOld3DS();
     LoadNativeFirmKeysNew3DS();
     LoadPresetKeys();
+    loaded.store(true, std::memory_order_release);
 }
 
 void SetKeyX(std::size_t slot_id, const AESKey& key) {
+    InitKeys();
     key_slots.at(slot_id).SetKeyX(key);
 }
 
 void SetKeyY(std::size_t slot_id, const AESKey& key) {
+    InitKeys();
     key_slots.at(slot_id).SetKeyY(key);
 }
 
 void SetNormalKey(std::size_t slot_id, const AESKey& key) {
+    InitKeys();
     key_slots.at(slot_id).SetNormalKey(key);
 }
 
 bool IsNormalKeyAvailable(std::size_t slot_id) {
+    InitKeys();
     return key_slots.at(slot_id).normal.has_value();
 }
 
 AESKey GetNormalKey(std::size_t slot_id) {
+    InitKeys();
     return key_slots.at(slot_id).normal.value_or(AESKey{});
 }
 
 void SelectCommonKeyIndex(u8 index) {
+    InitKeys();
     key_slots[KeySlotID::TicketCommonKey].SetKeyY(common_key_y_slots.at(index));
 }
 
@@ -52,6 +52,10 @@ constexpr std::size_t AES_BLOCK_SIZE = 16;
 
 using AESKey = std::array<u8, AES_BLOCK_SIZE>;
 
+/**
+ * Loads the keys, once per process. The functions below load them on their first use, so a title
+ * that needs no keys doesn't spend its boot on reading the bootrom and the firmware.
+ */
 void InitKeys();
 
 void SetGeneratorConstant(const AESKey& key);
@@ -2,10 +2,13 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstring>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 #include "common/alignment.h"
+#include "common/arch.h"
 #include "common/color.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
@@ -20,11 +23,18 @@
 #include "core/tracer/recorder.h"
 #include "video_core/command_processor.h"
 #include "video_core/debug_utils/debug_utils.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_base.h"
 #include "video_core/utils.h"
 #include "video_core/video_core.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace GPU {
 
 Regs g_regs;
@@ -70,6 +80,373 @@ static Common::Vec4<u8> DecodePixel(Regs::PixelFormat input_format, const u8* sr
     }
 }
 
+static void EncodePixel(Regs::PixelFormat output_format, const Common::Vec4<u8>& color,
+                        u8* dst_pixel) {
+    switch (output_format) {
+    case Regs::PixelFormat::RGBA8:
+        Common::Color::EncodeRGBA8(color, dst_pixel);
+        break;
+
+    case Regs::PixelFormat::RGB8:
+        Common::Color::EncodeRGB8(color, dst_pixel);
+        break;
+
+    case Regs::PixelFormat::RGB565:
+        Common::Color::EncodeRGB565(color, dst_pixel);
+        break;
+
+    case Regs::PixelFormat::RGB5A1:
+        Common::Color::EncodeRGB5A1(color, dst_pixel);
+        break;
+
+    case Regs::PixelFormat::RGBA4:
+        Common::Color::EncodeRGBA4(color, dst_pixel);
+        break;
+
+    default:
+        LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
+                  static_cast<u32>(output_format));
+        break;
+    }
+}
+
+/**
+ * Fills the memory with a pattern of 48 bytes, which holds a whole number of 16, 24 and 32-bit
+ * values as well as of 16 byte vectors.
+ */
+static void FillPattern(u8* dst, std::size_t size, const std::array<u8, 48>& pattern) {
+    std::size_t offset = 0;
+#if CITRA_ARCH(x86_64)
+    const auto load = [&pattern](std::size_t part) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.data() + part));
+    };
+    const __m128i part0 = load(0);
+    const __m128i part1 = load(16);
+    const __m128i part2 = load(32);
+    for (; offset + pattern.size() <= size; offset += pattern.size()) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset), part0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + 16), part1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + offset + 32), part2);
+    }
+#elif CITRA_ARCH(arm64)
+    const uint8x16_t part0 = vld1q_u8(pattern.data());
+    const uint8x16_t part1 = vld1q_u8(pattern.data() + 16);
+    const uint8x16_t part2 = vld1q_u8(pattern.data() + 32);
+    for (; offset + pattern.size() <= size; offset += pattern.size()) {
+        vst1q_u8(dst + offset, part0);
+        vst1q_u8(dst + offset + 16, part1);
+        vst1q_u8(dst + offset + 32, part2);
+    }
+#endif
+    for (; offset + pattern.size() <= size; offset += pattern.size()) {
+        std::memcpy(dst + offset, pattern.data(), pattern.size());
+    }
+    std::memcpy(dst + offset, pattern.data(), size - offset);
+}
+
+/// The size and the lowest bit of a component of a 16-bit pixel
+struct ComponentLayout {
+    u32 bits;
+    u32 position;
+};
+
+/// The layouts of the red, green, blue and alpha components, alpha having no bits if it's opaque
+template <Regs::PixelFormat format>
+constexpr std::array<ComponentLayout, 4> Layout16 = [] {
+    static_assert(format == Regs::PixelFormat::RGB565 || format == Regs::PixelFormat::RGB5A1 ||
+                  format == Regs::PixelFormat::RGBA4);
+    if constexpr (format == Regs::PixelFormat::RGB565) {
+        return std::array<ComponentLayout, 4>{{{5, 11}, {6, 5}, {5, 0}, {0, 0}}};
+    } else if constexpr (format == Regs::PixelFormat::RGB5A1) {
+        return std::array<ComponentLayout, 4>{{{5, 11}, {5, 6}, {5, 1}, {1, 0}}};
+    } else {
+        return std::array<ComponentLayout, 4>{{{4, 12}, {4, 8}, {4, 4}, {4, 0}}};
+    }
+}();
+
+#if CITRA_ARCH(x86_64)
+/// Extracts a component of eight 16-bit pixels and expands it to 8 bits like Convert5To8
+template <ComponentLayout layout>
+static inline __m128i UnpackComponent(__m128i pixels) {
+    if constexpr (layout.bits == 0) {
+        return _mm_set1_epi16(0xFF);
+    } else {
+        const __m128i value = _mm_and_si128(_mm_srli_epi16(pixels, layout.position),
+                                            _mm_set1_epi16((1 << layout.bits) - 1));
+        if constexpr (layout.bits == 1) {
+            return _mm_sub_epi16(_mm_slli_epi16(value, 8), value);
+        } else {
+            return _mm_or_si128(_mm_slli_epi16(value, 8 - layout.bits),
+                                _mm_srli_epi16(value, 2 * layout.bits - 8));
+        }
+    }
+}
+
+/// Decodes eight pixels of a 16-bit format to RGBA8
+template <Regs::PixelFormat format>
+static inline void DecodePixels16(const u8* src, u8* dst) {
+    constexpr auto& layout = Layout16<format>;
+    const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i r = _mm_packus_epi16(UnpackComponent<layout[0]>(pixels), zero);
+    const __m128i g = _mm_packus_epi16(UnpackComponent<layout[1]>(pixels), zero);
+    const __m128i b = _mm_packus_epi16(UnpackComponent<layout[2]>(pixels), zero);
+    const __m128i a = _mm_packus_epi16(UnpackComponent<layout[3]>(pixels), zero);
+
+    // RGBA8 stores the components of a pixel from alpha to red
+    const __m128i ab = _mm_unpacklo_epi8(a, b);
+    const __m128i gr = _mm_unpacklo_epi8(g, r);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(ab, gr));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(ab, gr));
+}
+
+/// Moves the top bits of a component of four RGBA8 pixels to their place in a 16-bit pixel
+template <ComponentLayout layout, u32 component>
+static inline __m128i PackComponent(__m128i pixels) {
+    if constexpr (layout.bits == 0) {
+        return _mm_setzero_si128();
+    } else {
+        constexpr u32 top = 32 - 8 * component;
+        return _mm_and_si128(_mm_srli_epi32(pixels, top - layout.bits - layout.position),
+                             _mm_set1_epi32(((1 << layout.bits) - 1) << layout.position));
+    }
+}
+
+/// Encodes eight RGBA8 pixels to a 16-bit format
+template <Regs::PixelFormat format>
+static inline void EncodePixels16(const u8* src, u8* dst) {
+    constexpr auto& layout = Layout16<format>;
+    const auto pack = [](const u8* ptr) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        const __m128i value = _mm_or_si128(
+            _mm_or_si128(PackComponent<layout[0], 0>(pixels), PackComponent<layout[1], 1>(pixels)),
+            _mm_or_si128(PackComponent<layout[2], 2>(pixels), PackComponent<layout[3], 3>(pixels)));
+        // Sign extending the values keeps the signed saturation of the packing from clamping them
+        return _mm_srai_epi32(_mm_slli_epi32(value, 16), 16);
+    };
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(pack(src), pack(src + 16)));
+}
+#elif CITRA_ARCH(arm64)
+/// Extracts a component of eight 16-bit pixels and expands it to 8 bits like Convert5To8
+template <ComponentLayout layout>
+static inline uint8x8_t UnpackComponent(uint16x8_t pixels) {
+    if constexpr (layout.bits == 0) {
+        return vdup_n_u8(0xFF);
+    } else {
+        uint16x8_t value = pixels;
+        if constexpr (layout.position != 0) {
+            value = vshrq_n_u16(pixels, layout.position);
+        }
+        const uint8x8_t bits = vmovn_u16(vandq_u16(value, vdupq_n_u16((1 << layout.bits) - 1)));
+        if constexpr (layout.bits == 1) {
+            return vsub_u8(vdup_n_u8(0), bits);
+        } else if constexpr (layout.bits == 4) {
+            return vorr_u8(vshl_n_u8(bits, 4), bits);
+        } else {
+            return vorr_u8(vshl_n_u8(bits, 8 - layout.bits), vshr_n_u8(bits, 2 * layout.bits - 8));
+        }
+    }
+}
+
+/// Decodes eight pixels of a 16-bit format to RGBA8
+template <Regs::PixelFormat format>
+static inline void DecodePixels16(const u8* src, u8* dst) {
+    constexpr auto& layout = Layout16<format>;
+    const uint16x8_t pixels = vreinterpretq_u16_u8(vld1q_u8(src));
+    // RGBA8 stores the components of a pixel from alpha to red
+    const uint8x8x4_t components{{UnpackComponent<layout[3]>(pixels),
+                                  UnpackComponent<layout[2]>(pixels),
+                                  UnpackComponent<layout[1]>(pixels),
+                                  UnpackComponent<layout[0]>(pixels)}};
+    vst4_u8(dst, components);
+}
+
+/// Moves the top bits of a component of eight RGBA8 pixels to their place in a 16-bit pixel
+template <ComponentLayout layout>
+static inline uint16x8_t PackComponent(uint8x8_t component) {
+    if constexpr (layout.bits == 0) {
+        return vdupq_n_u16(0);
+    } else {
+        return vshlq_n_u16(vmovl_u8(vshr_n_u8(component, 8 - layout.bits)), layout.position);
+    }
+}
+
+/// Encodes eight RGBA8 pixels to a 16-bit format
+template <Regs::PixelFormat format>
+static inline void EncodePixels16(const u8* src, u8* dst) {
+    constexpr auto& layout = Layout16<format>;
+    const uint8x8x4_t components = vld4_u8(src);
+    const uint16x8_t value = vorrq_u16(vorrq_u16(PackComponent<layout[0]>(components.val[3]),
+                                                 PackComponent<layout[1]>(components.val[2])),
+                                       vorrq_u16(PackComponent<layout[2]>(components.val[1]),
+                                                 PackComponent<layout[3]>(components.val[0])));
+    vst1q_u8(dst, vreinterpretq_u8_u16(value));
+}
+#endif
+
+/// Decodes a row of pixels of a 16-bit format to RGBA8
+template <Regs::PixelFormat format>
+static void DecodeRow16(const u8* src, u8* dst, u32 width) {
+    u32 x = 0;
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    for (; x + 8 <= width; x += 8) {
+        DecodePixels16<format>(src + x * 2, dst + x * 4);
+    }
+#endif
+    for (; x < width; ++x) {
+        Common::Color::EncodeRGBA8(DecodePixel(format, src + x * 2), dst + x * 4);
+    }
+}
+
+/// Encodes a row of RGBA8 pixels to a 16-bit format
+template <Regs::PixelFormat format>
+static void EncodeRow16(const u8* src, u8* dst, u32 width) {
+    u32 x = 0;
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    for (; x + 8 <= width; x += 8) {
+        EncodePixels16<format>(src + x * 4, dst + x * 2);
+    }
+#endif
+    for (; x < width; ++x) {
+        EncodePixel(format, Common::Color::DecodeRGBA8(src + x * 4), dst + x * 2);
+    }
+}
+
+/// Decodes a row of pixels to RGBA8
+static void DecodeRow(Regs::PixelFormat format, const u8* src, u8* dst, u32 width) {
+    switch (format) {
+    case Regs::PixelFormat::RGB565:
+        return DecodeRow16<Regs::PixelFormat::RGB565>(src, dst, width);
+    case Regs::PixelFormat::RGB5A1:
+        return DecodeRow16<Regs::PixelFormat::RGB5A1>(src, dst, width);
+    case Regs::PixelFormat::RGBA4:
+        return DecodeRow16<Regs::PixelFormat::RGBA4>(src, dst, width);
+    default: {
+        const u32 bytes_per_pixel = Regs::BytesPerPixel(format);
+        for (u32 x = 0; x < width; ++x) {
+            Common::Color::EncodeRGBA8(DecodePixel(format, src + x * bytes_per_pixel), dst + x * 4);
+        }
+        return;
+    }
+    }
+}
+
+/// Encodes a row of RGBA8 pixels
+static void EncodeRow(Regs::PixelFormat format, const u8* src, u8* dst, u32 width) {
+    switch (format) {
+    case Regs::PixelFormat::RGB565:
+        return EncodeRow16<Regs::PixelFormat::RGB565>(src, dst, width);
+    case Regs::PixelFormat::RGB5A1:
+        return EncodeRow16<Regs::PixelFormat::RGB5A1>(src, dst, width);
+    case Regs::PixelFormat::RGBA4:
+        return EncodeRow16<Regs::PixelFormat::RGBA4>(src, dst, width);
+    default: {
+        const u32 bytes_per_pixel = Regs::BytesPerPixel(format);
+        for (u32 x = 0; x < width; ++x) {
+            EncodePixel(format, Common::Color::DecodeRGBA8(src + x * 4), dst + x * bytes_per_pixel);
+        }
+        return;
+    }
+    }
+}
+
+/**
+ * Copies a row of a tiled image to a linear row, or the other way around. The 8 pixels a tile has
+ * in the row are pairs, at 0, 4, 16 and 20 pixels from the first one in Morton order.
+ */
+template <u32 bytes_per_pixel, bool to_tiled>
+static void CopyTiledRow(const u8* src, u8* dst, u32 tiled_width, u32 y, u32 width) {
+    constexpr u32 pair_size = 2 * bytes_per_pixel;
+    const u32 row_offset =
+        ((y & ~7) * tiled_width + VideoCore::MortonInterleave(0, y)) * bytes_per_pixel;
+    for (u32 x = 0; x < width; x += 8) {
+        const u32 tile_offset = row_offset + x * 8 * bytes_per_pixel;
+        const u32 linear_offset = x * bytes_per_pixel;
+        for (u32 pair = 0; pair < 4; ++pair) {
+            const u32 tiled =
+                tile_offset + VideoCore::MortonInterleave(pair * 2, 0) * bytes_per_pixel;
+            const u32 linear = linear_offset + pair * pair_size;
+            if constexpr (to_tiled) {
+                std::memcpy(dst + tiled, src + linear, pair_size);
+            } else {
+                std::memcpy(dst + linear, src + tiled, pair_size);
+            }
+        }
+    }
+}
+
+using CopyTiledRowFunc = void (*)(const u8* src, u8* dst, u32 tiled_width, u32 y, u32 width);
+
+template <bool to_tiled>
+static CopyTiledRowFunc GetCopyTiledRow(u32 bytes_per_pixel) {
+    switch (bytes_per_pixel) {
+    case 2:
+        return &CopyTiledRow<2, to_tiled>;
+    case 3:
+        return &CopyTiledRow<3, to_tiled>;
+    default:
+        return &CopyTiledRow<4, to_tiled>;
+    }
+}
+
+/**
+ * Performs an unscaled display transfer a row at a time. A tiled row is gathered into or scattered
+ * from a linear one, and the pixels are converted a row at a time through RGBA8.
+ * @return false if the transfer needs the per pixel path
+ */
+static bool TransferRows(const Regs::DisplayTransferConfig& config, const u8* src_pointer,
+                         u8* dst_pointer, u32 width, u32 height) {
+    const Regs::PixelFormat input_format = config.input_format;
+    const Regs::PixelFormat output_format = config.output_format;
+    if (input_format > Regs::PixelFormat::RGBA4 || output_format > Regs::PixelFormat::RGBA4) {
+        return false;
+    }
+    const bool input_tiled = !config.input_linear;
+    const bool output_tiled = config.input_linear != config.dont_swizzle;
+    if ((input_tiled || output_tiled) && width % 8 != 0) {
+        return false;
+    }
+
+    const u32 src_bytes_per_pixel = Regs::BytesPerPixel(input_format);
+    const u32 dst_bytes_per_pixel = Regs::BytesPerPixel(output_format);
+    const CopyTiledRowFunc gather_row = GetCopyTiledRow<false>(src_bytes_per_pixel);
+    const CopyTiledRowFunc scatter_row = GetCopyTiledRow<true>(dst_bytes_per_pixel);
+    std::vector<u8> src_row(input_tiled ? width * src_bytes_per_pixel : 0);
+    std::vector<u8> dst_row(output_tiled ? width * dst_bytes_per_pixel : 0);
+    const bool convert = input_format != output_format;
+    const bool via_rgba8 = convert && input_format != Regs::PixelFormat::RGBA8 &&
+                           output_format != Regs::PixelFormat::RGBA8;
+    std::vector<u8> rgba8_row(via_rgba8 ? width * 4 : 0);
+
+    for (u32 y = 0; y < height; ++y) {
+        const u32 output_y = config.flip_vertically ? height - y - 1 : y;
+
+        const u8* src = src_pointer + y * config.input_width * src_bytes_per_pixel;
+        if (input_tiled) {
+            gather_row(src_pointer, src_row.data(), config.input_width, y, width);
+            src = src_row.data();
+        }
+        u8* dst = output_tiled ? dst_row.data()
+                               : dst_pointer + output_y * width * dst_bytes_per_pixel;
+
+        if (!convert) {
+            std::memcpy(dst, src, width * dst_bytes_per_pixel);
+        } else if (input_format == Regs::PixelFormat::RGBA8) {
+            EncodeRow(output_format, src, dst, width);
+        } else if (output_format == Regs::PixelFormat::RGBA8) {
+            DecodeRow(input_format, src, dst, width);
+        } else {
+            DecodeRow(input_format, src, rgba8_row.data(), width);
+            EncodeRow(output_format, rgba8_row.data(), dst, width);
+        }
+
+        if (output_tiled) {
+            scatter_row(dst_row.data(), dst_pointer, width, output_y, width);
+        }
+    }
+    return true;
+}
+
 MICROPROFILE_DEFINE(GPU_DisplayTransfer, "GPU", "DisplayTransfer", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(GPU_CmdlistProcessing, "GPU", "Cmdlist Processing", MP_RGB(100, 255, 100));
 
@@ -103,27 +480,32 @@ static void MemoryFill(const Regs::MemoryFillConfig& config) {
     Memory::RasterizerInvalidateRegion(config.GetStartAddress(),
                                        config.GetEndAddress() - config.GetStartAddress());
 
+    std::array<u8, 48> pattern;
+    std::size_t size = end - start;
     if (config.fill_24bit) {
-        // fill with 24-bit values
-        for (u8* ptr = start; ptr < end; ptr += 3) {
-            ptr[0] = config.value_24bit_r;
-            ptr[1] = config.value_24bit_g;
-            ptr[2] = config.value_24bit_b;
+        // fill with 24-bit values, the last one is written whole even if it crosses the end
+        for (std::size_t i = 0; i < pattern.size(); i += 3) {
+            pattern[i] = config.value_24bit_r;
+            pattern[i + 1] = config.value_24bit_g;
+            pattern[i + 2] = config.value_24bit_b;
         }
+        size = Common::AlignUp(size, 3);
     } else if (config.fill_32bit) {
         // fill with 32-bit values
-        if (end > start) {
-            u32 value = config.value_32bit;
-            std::size_t len = (end - start) / sizeof(u32);
-            for (std::size_t i = 0; i < len; ++i)
-                memcpy(&start[i * sizeof(u32)], &value, sizeof(u32));
+        const u32 value = config.value_32bit;
+        for (std::size_t i = 0; i < pattern.size(); i += sizeof(u32)) {
+            std::memcpy(&pattern[i], &value, sizeof(u32));
         }
+        size = Common::AlignDown(size, sizeof(u32));
     } else {
         // fill with 16-bit values
-        u16 value_16bit = config.value_16bit.Value();
-        for (u8* ptr = start; ptr < end; ptr += sizeof(u16))
-            memcpy(ptr, &value_16bit, sizeof(u16));
+        const u16 value = config.value_16bit.Value();
+        for (std::size_t i = 0; i < pattern.size(); i += sizeof(u16)) {
+            std::memcpy(&pattern[i], &value, sizeof(u16));
+        }
+        size = Common::AlignUp(size, sizeof(u16));
     }
+    FillPattern(start, size, pattern);
 }
 
 static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
@@ -193,6 +575,11 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
     Memory::RasterizerFlushRegion(config.GetPhysicalInputAddress(), input_size);
     Memory::RasterizerInvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
+    if (config.scaling == config.NoScale &&
+        TransferRows(config, src_pointer, dst_pointer, output_width, output_height)) {
+        return;
+    }
+
     for (u32 y = 0; y < output_height; ++y) {
         for (u32 x = 0; x < output_width; ++x) {
             Common::Vec4<u8> src_color;
@@ -271,33 +658,7 @@ static void DisplayTransfer(const Regs::DisplayTransferConfig& config) {
                 src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
             }
 
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Regs::PixelFormat::RGBA8:
-                Common::Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB8:
-                Common::Color::EncodeRGB8(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB565:
-                Common::Color::EncodeRGB565(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGB5A1:
-                Common::Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
-
-            case Regs::PixelFormat::RGBA4:
-                Common::Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
-
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
-            }
+            EncodePixel(config.output_format, src_color, dst_pointer + dst_offset);
         }
     }
 }
@@ -384,6 +745,24 @@ static void TextureCopy(const Regs::DisplayTransferConfig& config) {
     }
 }
 
+void CopyBlock(PAddr src_addr, PAddr dst_addr, u32 size) {
+    // A linear copy is a texture copy without gaps, which lets the rasterizer perform it between
+    // cached surfaces instead of flushing the source and reloading the destination.
+    Regs::DisplayTransferConfig config{};
+    config.input_address = src_addr >> 3;
+    config.output_address = dst_addr >> 3;
+    config.is_texture_copy.Assign(1);
+    config.texture_copy.size = size;
+
+    if (VideoCore::g_gpu_thread) {
+        // The caller expects the copy to have completed, like a CPU copy would have
+        VideoCore::g_gpu_thread->PushHardwareOperation([config] { TextureCopy(config); });
+        VideoCore::g_gpu_thread->WaitIdle();
+    } else {
+        TextureCopy(config);
+    }
+}
+
 template <typename T>
 inline void Write(u32 addr, const T data) {
     addr -= HW::VADDR_GPU;
@@ -406,7 +785,12 @@ inline void Write(u32 addr, const T data) {
         auto& config = g_regs.memory_fill_config[is_second_filler];
 
         if (config.trigger) {
-            MemoryFill(config);
+            if (VideoCore::g_gpu_thread) {
+                VideoCore::g_gpu_thread->PushHardwareOperation(
+                    [config = Regs::MemoryFillConfig{config}] { MemoryFill(config); });
+            } else {
+                MemoryFill(config);
+            }
             LOG_TRACE(HW_GPU, "MemoryFill from {:#010X} to {:#010X}", config.GetStartAddress(),
                       config.GetEndAddress());
 
@@ -438,8 +822,22 @@ inline void Write(u32 addr, const T data) {
                 Pica::g_debug_context->OnEvent(Pica::DebugContext::Event::IncomingDisplayTransfer,
                                                nullptr);
 
-            if (config.is_texture_copy) {
+            if (VideoCore::g_gpu_thread) {
+                VideoCore::g_gpu_thread->PushHardwareOperation(
+                    [config = Regs::DisplayTransferConfig{config}] {
+                        if (config.is_texture_copy) {
+                            TextureCopy(config);
+                        } else {
+                            DisplayTransfer(config);
+                        }
+                    });
+            } else if (config.is_texture_copy) {
                 TextureCopy(config);
+            } else {
+                DisplayTransfer(config);
+            }
+
+            if (config.is_texture_copy) {
                 LOG_TRACE(HW_GPU,
                           "TextureCopy: {:#X} bytes from {:#010X}({}+{})-> "
                           "{:#010X}({}+{}), flags {:#010X}",
@@ -448,7 +846,6 @@ inline void Write(u32 addr, const T data) {
                           config.GetPhysicalOutputAddress(), config.texture_copy.output_width * 16,
                           config.texture_copy.output_gap * 16, config.flags);
             } else {
-                DisplayTransfer(config);
                 LOG_TRACE(HW_GPU,
                           "DisplayTransfer: {:#010X}({}x{})-> "
                           "{:#010X}({}x{}), dst format {:x}, flags {:#010X}",
@@ -470,7 +867,21 @@ inline void Write(u32 addr, const T data) {
         if (config.trigger & 1) {
             MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
 
-            Pica::CommandProcessor::ProcessCommandList(config.GetPhysicalAddress(), config.size);
+            if (VideoCore::g_gpu_thread) {
+                const PAddr list = config.GetPhysicalAddress();
+                VideoCore::g_gpu_thread->SubmitList(list, config.size);
+
+                // The GPU thread can't signal the interrupt itself, do it here on its behalf
+                const auto* buffer =
+                    reinterpret_cast<const u32*>(g_memory->GetPhysicalPointer(list));
+                if (buffer &&
+                    Pica::CommandProcessor::ListTriggersInterrupt(buffer, config.size)) {
+                    Service::GSP::SignalInterrupt(Service::GSP::InterruptId::P3D);
+                }
+            } else {
+                Pica::CommandProcessor::ProcessCommandList(config.GetPhysicalAddress(),
+                                                           config.size);
+            }
 
             g_regs.command_processor_config.trigger = 0;
         }
@@ -504,7 +915,11 @@ template void Write<u8>(u32 addr, const u8 data);
 
 /// Update hardware
 static void VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
-    VideoCore::g_renderer->SwapBuffers();
+    if (VideoCore::g_gpu_thread) {
+        VideoCore::g_gpu_thread->SwapBuffers();
+    } else {
+        VideoCore::g_renderer->SwapBuffers();
+    }
 
     // Signal to GSP that GPU interrupt has occurred
     // TODO(yuriks): hwtest to determine if PDC0 is for the Top screen and PDC1 for the Sub
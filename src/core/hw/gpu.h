@@ -322,6 +322,12 @@ void Read(T& var, const u32 addr);
 template <typename T>
 void Write(u32 addr, const T data);
 
+/**
+ * Copies a block of physical memory, on the GPU when the source is cached by the rasterizer.
+ * The address must be 8-byte aligned and the size a multiple of 16.
+ */
+void CopyBlock(PAddr src_addr, PAddr dst_addr, u32 size);
+
 /// Initialize hardware
 void Init(Memory::MemorySystem& memory);
 
@@ -4,7 +4,6 @@
 
 #include "common/common_types.h"
 #include "common/logging/log.h"
-#include "core/hw/aes/key.h"
 #include "core/hw/gpu.h"
 #include "core/hw/hw.h"
 #include "core/hw/lcd.h"
@@ -87,7 +86,6 @@ void Update() {}
 
 /// Initialize hardware
 void Init(Memory::MemorySystem& memory) {
-    AES::InitKeys();
     GPU::Init(memory);
     LCD::Init();
     LOG_DEBUG(HW, "initialized OK");
@@ -5,7 +5,9 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <memory>
+#include "common/arch.h"
 #include "common/assert.h"
 #include "common/color.h"
 #include "common/common_types.h"
@@ -15,6 +17,12 @@
 #include "core/hw/y2r.h"
 #include "core/memory.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace HW::Y2R {
 
 using namespace Service::Y2R;
@@ -23,55 +31,143 @@ static const std::size_t MAX_TILES = 1024 / 8;
 static const std::size_t TILE_SIZE = 8 * 8;
 using ImageTile = std::array<u32, TILE_SIZE>;
 
-/// Converts a image strip from the source YUV format into individual 8x8 RGB32 tiles.
-static void ConvertYUVToRGB(InputFormat input_format, const u8* input_Y, const u8* input_U,
-                            const u8* input_V, ImageTile output[], unsigned int width,
+/// Converts 8 pixels to RGB32, with the red component in the top byte and the bottom byte clear.
+static inline void ConvertPixels(const u8* Y, const u8* U, const u8* V, u32* output,
+                                 const CoefficientSet& c) {
+    // This conversion process is bit-exact with hardware, as far as could be tested.
+    const s32 rounding_offset = 0x18;
+#if CITRA_ARCH(x86_64)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Y)), zero);
+    const __m128i u = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(U)), zero);
+    const __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(V)), zero);
+
+    // Each product is taken by multiplying a pair of 16-bit components with a pair of coefficients
+    const auto pair = [](s16 lo, s16 hi) {
+        return _mm_set1_epi32(static_cast<s32>(static_cast<u32>(static_cast<u16>(lo)) |
+                                               (static_cast<u32>(static_cast<u16>(hi)) << 16)));
+    };
+    const __m128i c_r = pair(c[0], c[1]);
+    const __m128i c_y = pair(c[0], 0);
+    const __m128i c_g = pair(c[2], c[3]);
+    const __m128i c_b = pair(c[0], c[4]);
+    const __m128i offset_r = _mm_set1_epi32(c[5] + rounding_offset);
+    const __m128i offset_g = _mm_set1_epi32(c[6] + rounding_offset);
+    const __m128i offset_b = _mm_set1_epi32(c[7] + rounding_offset);
+    const auto finish = [](__m128i value, __m128i offset) {
+        return _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(value, 3), offset), 5);
+    };
+
+    __m128i r[2], g[2], b[2];
+    for (int half = 0; half < 2; ++half) {
+        const __m128i yv = half ? _mm_unpackhi_epi16(y, v) : _mm_unpacklo_epi16(y, v);
+        const __m128i vu = half ? _mm_unpackhi_epi16(v, u) : _mm_unpacklo_epi16(v, u);
+        const __m128i yu = half ? _mm_unpackhi_epi16(y, u) : _mm_unpacklo_epi16(y, u);
+        const __m128i cY = _mm_madd_epi16(yv, c_y);
+        r[half] = finish(_mm_madd_epi16(yv, c_r), offset_r);
+        g[half] = finish(_mm_sub_epi32(cY, _mm_madd_epi16(vu, c_g)), offset_g);
+        b[half] = finish(_mm_madd_epi16(yu, c_b), offset_b);
+    }
+
+    // Saturating to 16 and then to unsigned 8 bits clamps the components to [0, 255]
+    const auto clamp = [](__m128i lo, __m128i hi) {
+        const __m128i value = _mm_packs_epi32(lo, hi);
+        return _mm_packus_epi16(value, value);
+    };
+    const __m128i zero_b = _mm_unpacklo_epi8(zero, clamp(b[0], b[1]));
+    const __m128i g_r = _mm_unpacklo_epi8(clamp(g[0], g[1]), clamp(r[0], r[1]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_unpacklo_epi16(zero_b, g_r));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4), _mm_unpackhi_epi16(zero_b, g_r));
+#elif CITRA_ARCH(arm64)
+    const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(Y)));
+    const int16x8_t u = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(U)));
+    const int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(V)));
+    const int32x4_t offset_r = vdupq_n_s32(c[5] + rounding_offset);
+    const int32x4_t offset_g = vdupq_n_s32(c[6] + rounding_offset);
+    const int32x4_t offset_b = vdupq_n_s32(c[7] + rounding_offset);
+    const auto finish = [](int32x4_t value, int32x4_t offset) {
+        return vshrq_n_s32(vaddq_s32(vshrq_n_s32(value, 3), offset), 5);
+    };
+
+    int32x4_t r[2], g[2], b[2];
+    for (int half = 0; half < 2; ++half) {
+        const int16x4_t y_half = half ? vget_high_s16(y) : vget_low_s16(y);
+        const int16x4_t u_half = half ? vget_high_s16(u) : vget_low_s16(u);
+        const int16x4_t v_half = half ? vget_high_s16(v) : vget_low_s16(v);
+        const int32x4_t cY = vmull_n_s16(y_half, c[0]);
+        r[half] = finish(vmlal_n_s16(cY, v_half, c[1]), offset_r);
+        g[half] = finish(vmlsl_n_s16(vmlsl_n_s16(cY, v_half, c[2]), u_half, c[3]), offset_g);
+        b[half] = finish(vmlal_n_s16(cY, u_half, c[4]), offset_b);
+    }
+
+    // Saturating to 16 and then to unsigned 8 bits clamps the components to [0, 255]
+    const auto clamp = [](int32x4_t lo, int32x4_t hi) {
+        return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    };
+    const uint8x8x4_t pixels{{vdup_n_u8(0), clamp(b[0], b[1]), clamp(g[0], g[1]),
+                              clamp(r[0], r[1])}};
+    vst4_u8(reinterpret_cast<u8*>(output), pixels);
+#else
+    for (unsigned int i = 0; i < 8; ++i) {
+        s32 cY = c[0] * Y[i];
+
+        s32 r = cY + c[1] * V[i];
+        s32 g = cY - c[2] * V[i] - c[3] * U[i];
+        s32 b = cY + c[4] * U[i];
+
+        r = (r >> 3) + c[5] + rounding_offset;
+        g = (g >> 3) + c[6] + rounding_offset;
+        b = (b >> 3) + c[7] + rounding_offset;
+
+        output[i] = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
+                    ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
+                    ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+    }
+#endif
+}
+
+/**
+ * Converts a image strip from the source YUV format to RGB32. The 8 pixels of a line of the strip
+ * that belong to the same tile are contiguous, pixel (x, y) being stored at
+ * output[(x / 8) * tile_stride + y * line_stride + x % 8].
+ */
+template <InputFormat input_format>
+static void ConvertYUVToRGB(const u8* input_Y, const u8* input_U, const u8* input_V, u32* output,
+                            std::size_t tile_stride, std::size_t line_stride, unsigned int width,
                             unsigned int height, const CoefficientSet& coefficients) {
+    alignas(16) std::array<u8, 8> Y;
+    alignas(16) std::array<u8, 8> U;
+    alignas(16) std::array<u8, 8> V;
 
     for (unsigned int y = 0; y < height; ++y) {
-        for (unsigned int x = 0; x < width; ++x) {
-            s32 Y = 0;
-            s32 U = 0;
-            s32 V = 0;
+        u32* line = output + y * line_stride;
+        for (unsigned int x = 0; x < width; x += 8, line += tile_stride) {
             switch (input_format) {
             case InputFormat::YUV422_Indiv8:
             case InputFormat::YUV422_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[(y * width + x) / 2];
-                V = input_V[(y * width + x) / 2];
+                std::memcpy(Y.data(), input_Y + y * width + x, Y.size());
+                for (unsigned int i = 0; i < 8; ++i) {
+                    U[i] = input_U[(y * width + x + i) / 2];
+                    V[i] = input_V[(y * width + x + i) / 2];
+                }
                 break;
             case InputFormat::YUV420_Indiv8:
             case InputFormat::YUV420_Indiv16:
-                Y = input_Y[y * width + x];
-                U = input_U[((y / 2) * width + x) / 2];
-                V = input_V[((y / 2) * width + x) / 2];
+                std::memcpy(Y.data(), input_Y + y * width + x, Y.size());
+                for (unsigned int i = 0; i < 8; ++i) {
+                    U[i] = input_U[((y / 2) * width + x + i) / 2];
+                    V[i] = input_V[((y / 2) * width + x + i) / 2];
+                }
                 break;
             case InputFormat::YUYV422_Interleaved:
-                Y = input_Y[(y * width + x) * 2];
-                U = input_Y[(y * width + (x / 2) * 2) * 2 + 1];
-                V = input_Y[(y * width + (x / 2) * 2) * 2 + 3];
+                for (unsigned int i = 0; i < 8; ++i) {
+                    Y[i] = input_Y[(y * width + x + i) * 2];
+                    U[i] = input_Y[(y * width + x + (i / 2) * 2) * 2 + 1];
+                    V[i] = input_Y[(y * width + x + (i / 2) * 2) * 2 + 3];
+                }
                 break;
             }
-
-            // This conversion process is bit-exact with hardware, as far as could be tested.
-            auto& c = coefficients;
-            s32 cY = c[0] * Y;
-
-            s32 r = cY + c[1] * V;
-            s32 g = cY - c[2] * V - c[3] * U;
-            s32 b = cY + c[4] * U;
-
-            const s32 rounding_offset = 0x18;
-            r = (r >> 3) + c[5] + rounding_offset;
-            g = (g >> 3) + c[6] + rounding_offset;
-            b = (b >> 3) + c[7] + rounding_offset;
-
-            unsigned int tile = x / 8;
-            unsigned int tile_x = x % 8;
-            u32* out = &output[tile][y * 8 + tile_x];
-            *out = ((u32)std::clamp(r >> 5, 0, 0xFF) << 24) |
-                   ((u32)std::clamp(g >> 5, 0, 0xFF) << 16) |
-                   ((u32)std::clamp(b >> 5, 0, 0xFF) << 8);
+            ConvertPixels(Y.data(), U.data(), V.data(), line, coefficients);
         }
     }
 }
@@ -87,8 +183,12 @@ static void ReceiveData(Memory::MemorySystem& memory, u8* output, ConversionBuff
     ASSERT(amount_of_data % output_unit == 0);
 
     while (amount_of_data > 0) {
-        for (std::size_t i = 0; i < output_unit; ++i) {
-            output[i] = input[i * N];
+        if constexpr (N == 1) {
+            std::memcpy(output, input, output_unit);
+        } else {
+            for (std::size_t i = 0; i < output_unit; ++i) {
+                output[i] = input[i * N];
+            }
         }
 
         output += output_unit;
@@ -102,8 +202,9 @@ static void ReceiveData(Memory::MemorySystem& memory, u8* output, ConversionBuff
 
 /// Convert intermediate RGB32 format to the final output format while simulating an outgoing CDMA
 /// transfer.
+template <OutputFormat output_format>
 static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionBuffer& buf,
-                     int amount_of_data, OutputFormat output_format, u8 alpha) {
+                     int amount_of_data, u8 alpha) {
 
     u8* output = memory.GetPointer(buf.address);
 
@@ -111,25 +212,25 @@ static void SendData(Memory::MemorySystem& memory, const u32* input, ConversionB
         u8* unit_end = output + buf.transfer_unit;
         while (output < unit_end) {
             u32 color = *input++;
-            Common::Vec4<u8> col_vec{(u8)(color >> 24), (u8)(color >> 16), (u8)(color >> 8), alpha};
 
-            switch (output_format) {
-            case OutputFormat::RGBA8:
-                Common::Color::EncodeRGBA8(col_vec, output);
+            if constexpr (output_format == OutputFormat::RGBA8) {
+                // The intermediate format only lacks the alpha in its bottom byte
+                const u32 value = color | alpha;
+                std::memcpy(output, &value, sizeof(value));
                 output += 4;
-                break;
-            case OutputFormat::RGB8:
-                Common::Color::EncodeRGB8(col_vec, output);
-                output += 3;
-                break;
-            case OutputFormat::RGB5A1:
-                Common::Color::EncodeRGB5A1(col_vec, output);
-                output += 2;
-                break;
-            case OutputFormat::RGB565:
-                Common::Color::EncodeRGB565(col_vec, output);
-                output += 2;
-                break;
+            } else {
+                Common::Vec4<u8> col_vec{(u8)(color >> 24), (u8)(color >> 16), (u8)(color >> 8),
+                                         alpha};
+                if constexpr (output_format == OutputFormat::RGB8) {
+                    Common::Color::EncodeRGB8(col_vec, output);
+                    output += 3;
+                } else if constexpr (output_format == OutputFormat::RGB5A1) {
+                    Common::Color::EncodeRGB5A1(col_vec, output);
+                    output += 2;
+                } else {
+                    Common::Color::EncodeRGB565(col_vec, output);
+                    output += 2;
+                }
             }
 
             amount_of_data -= 1;
@@ -202,10 +303,48 @@ static void RotateTile270(const ImageTile& input, ImageTile& output, int height,
     }
 }
 
-static void WriteTileToOutput(u32* output, const ImageTile& tile, int height, int line_stride) {
-    for (int y = 0; y < height; ++y) {
+/**
+ * Computes where the rotation and the output alignment move each pixel of a converted tile, as an
+ * offset from the start of the tile in the output strip.
+ */
+static void BuildTileOutputMap(std::array<u32, TILE_SIZE>& map, Rotation rotation,
+                               BlockAlignment block_alignment, unsigned int width, int height) {
+    const u8* tile_remap = block_alignment == BlockAlignment::Block8x8 ? morton_lut : linear_lut;
+
+    // Rotating a tile of indices tells where each input pixel ends in the rotated tile
+    ImageTile indices;
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = static_cast<u32>(i);
+    }
+    ImageTile rotated{};
+    int line_stride = 0;
+    switch (rotation) {
+    case Rotation::None:
+        RotateTile0(indices, rotated, height, tile_remap);
+        line_stride = width;
+        break;
+    case Rotation::Clockwise_90:
+        RotateTile90(indices, rotated, height, tile_remap);
+        line_stride = 8;
+        break;
+    case Rotation::Clockwise_180:
+        RotateTile180(indices, rotated, height, tile_remap);
+        line_stride = width;
+        break;
+    case Rotation::Clockwise_270:
+        RotateTile270(indices, rotated, height, tile_remap);
+        line_stride = 8;
+        break;
+    }
+
+    // Linear tiles are written line by line in the strip, swizzled ones as a whole
+    const int written_lines = block_alignment == BlockAlignment::Block8x8 ? 8 : height;
+    if (block_alignment == BlockAlignment::Block8x8) {
+        line_stride = 8;
+    }
+    for (int y = 0; y < written_lines; ++y) {
         for (int x = 0; x < 8; ++x) {
-            output[y * line_stride + x] = tile[y * 8 + x];
+            map[rotated[y * 8 + x]] = y * line_stride + x;
         }
     }
 }
@@ -271,19 +410,28 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration& cv
     std::unique_ptr<u8[]> data_buffer(new u8[cvt.input_line_width * 8 * 4]);
     // Intermediate storage for decoded 8x8 image tiles. Always stored as RGB32.
     std::unique_ptr<ImageTile[]> tiles(new ImageTile[num_tiles]);
-    ImageTile tmp_tile;
-
-    // LUT used to remap writes to a tile. Used to allow linear or swizzled output without
-    // requiring two different code paths.
-    const u8* tile_remap = nullptr;
-    switch (cvt.block_alignment) {
-    case BlockAlignment::Linear:
-        tile_remap = linear_lut;
-        break;
-    case BlockAlignment::Block8x8:
-        tile_remap = morton_lut;
-        break;
-    }
+
+    // Without rotation, linear output is the converted strip itself, so it is converted directly
+    const bool direct_output =
+        cvt.rotation == Rotation::None && cvt.block_alignment == BlockAlignment::Linear;
+
+    std::array<u32, TILE_SIZE> tile_map;
+    unsigned int tile_map_height = 0;
+
+    const auto convert = [&cvt](auto... args) {
+        switch (cvt.input_format) {
+        case InputFormat::YUV422_Indiv8:
+            return ConvertYUVToRGB<InputFormat::YUV422_Indiv8>(args...);
+        case InputFormat::YUV420_Indiv8:
+            return ConvertYUVToRGB<InputFormat::YUV420_Indiv8>(args...);
+        case InputFormat::YUV422_Indiv16:
+            return ConvertYUVToRGB<InputFormat::YUV422_Indiv16>(args...);
+        case InputFormat::YUV420_Indiv16:
+            return ConvertYUVToRGB<InputFormat::YUV420_Indiv16>(args...);
+        case InputFormat::YUYV422_Interleaved:
+            return ConvertYUVToRGB<InputFormat::YUYV422_Interleaved>(args...);
+        }
+    };
 
     for (unsigned int y = 0; y < cvt.input_lines; y += 8) {
         unsigned int row_height = std::min(cvt.input_lines - y, 8u);
@@ -323,58 +471,67 @@ void PerformConversion(Memory::MemorySystem& memory, ConversionConfiguration& cv
             break;
         }
 
-        // Note(yuriks): If additional optimization is required, input_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
-        ConvertYUVToRGB(cvt.input_format, input_Y, input_U, input_V, tiles.get(),
-                        cvt.input_line_width, row_height, cvt.coefficients);
-
         u32* output_buffer = reinterpret_cast<u32*>(data_buffer.get());
 
-        for (std::size_t i = 0; i < num_tiles; ++i) {
-            int image_strip_width = 0;
-            int output_stride = 0;
-
-            switch (cvt.rotation) {
-            case Rotation::None:
-                RotateTile0(tiles[i], tmp_tile, row_height, tile_remap);
-                image_strip_width = cvt.input_line_width;
-                output_stride = 8;
-                break;
-            case Rotation::Clockwise_90:
-                RotateTile90(tiles[i], tmp_tile, row_height, tile_remap);
-                image_strip_width = 8;
-                output_stride = 8 * row_height;
-                break;
-            case Rotation::Clockwise_180:
-                // For 180 and 270 degree rotations we also invert the order of tiles in the strip,
-                // since the rotates are done individually on each tile.
-                RotateTile180(tiles[num_tiles - i - 1], tmp_tile, row_height, tile_remap);
-                image_strip_width = cvt.input_line_width;
-                output_stride = 8;
-                break;
-            case Rotation::Clockwise_270:
-                RotateTile270(tiles[num_tiles - i - 1], tmp_tile, row_height, tile_remap);
-                image_strip_width = 8;
-                output_stride = 8 * row_height;
-                break;
+        if (direct_output) {
+            // The tiles are used as the output strip, written linearly as the lines are converted
+            output_buffer = tiles[0].data();
+            convert(input_Y, input_U, input_V, output_buffer, 8, cvt.input_line_width,
+                    cvt.input_line_width, row_height, cvt.coefficients);
+        } else {
+            convert(input_Y, input_U, input_V, tiles[0].data(), TILE_SIZE, 8,
+                    cvt.input_line_width, row_height, cvt.coefficients);
+
+            if (tile_map_height != row_height) {
+                BuildTileOutputMap(tile_map, cvt.rotation, cvt.block_alignment,
+                                   cvt.input_line_width, row_height);
+                tile_map_height = row_height;
             }
 
+            std::size_t tile_output_size = 0;
             switch (cvt.block_alignment) {
             case BlockAlignment::Linear:
-                WriteTileToOutput(output_buffer, tmp_tile, row_height, image_strip_width);
-                output_buffer += output_stride;
+                tile_output_size = cvt.rotation == Rotation::Clockwise_90 ||
+                                           cvt.rotation == Rotation::Clockwise_270
+                                       ? 8 * row_height
+                                       : 8;
                 break;
             case BlockAlignment::Block8x8:
-                WriteTileToOutput(output_buffer, tmp_tile, 8, 8);
-                output_buffer += TILE_SIZE;
+                tile_output_size = TILE_SIZE;
                 break;
             }
+
+            // For 180 and 270 degree rotations we also invert the order of tiles in the strip,
+            // since the rotates are done individually on each tile.
+            const bool reverse_tiles = cvt.rotation == Rotation::Clockwise_180 ||
+                                       cvt.rotation == Rotation::Clockwise_270;
+            for (std::size_t i = 0; i < num_tiles; ++i) {
+                const ImageTile& tile = tiles[reverse_tiles ? num_tiles - i - 1 : i];
+                u32* const tile_output = output_buffer + i * tile_output_size;
+                for (unsigned int j = 0; j < row_height * 8; ++j) {
+                    tile_output[tile_map[j]] = tile[j];
+                }
+            }
         }
 
-        // Note(yuriks): If additional optimization is required, output_format can be moved to a
-        // template parameter, so that its dispatch can be moved to outside the inner loop.
-        SendData(memory, reinterpret_cast<u32*>(data_buffer.get()), cvt.dst, (int)row_data_size,
-                 cvt.output_format, (u8)cvt.alpha);
+        switch (cvt.output_format) {
+        case OutputFormat::RGBA8:
+            SendData<OutputFormat::RGBA8>(memory, output_buffer, cvt.dst, (int)row_data_size,
+                                          (u8)cvt.alpha);
+            break;
+        case OutputFormat::RGB8:
+            SendData<OutputFormat::RGB8>(memory, output_buffer, cvt.dst, (int)row_data_size,
+                                         (u8)cvt.alpha);
+            break;
+        case OutputFormat::RGB5A1:
+            SendData<OutputFormat::RGB5A1>(memory, output_buffer, cvt.dst, (int)row_data_size,
+                                           (u8)cvt.alpha);
+            break;
+        case OutputFormat::RGB565:
+            SendData<OutputFormat::RGB565>(memory, output_buffer, cvt.dst, (int)row_data_size,
+                                           (u8)cvt.alpha);
+            break;
+        }
     }
 }
 } // namespace HW::Y2R
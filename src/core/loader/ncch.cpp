@@ -6,6 +6,7 @@
 #include <cinttypes>
 #include <codecvt>
 #include <cstring>
+#include <future>
 #include <locale>
 #include <memory>
 #include <vector>
@@ -75,16 +76,15 @@ std::pair<std::optional<u8>, ResultStatus> AppLoader_NCCH::LoadKernelN3dsMode()
                           ResultStatus::Success);
 }
 
-ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process) {
+ResultStatus AppLoader_NCCH::LoadExec(std::shared_ptr<Kernel::Process>& process,
+                                      std::vector<u8> code) {
     using Kernel::CodeSet;
 
     if (!is_loaded)
         return ResultStatus::ErrorNotLoaded;
 
-    std::vector<u8> code;
     u64_le program_id;
-    if (ResultStatus::Success == ReadCode(code) &&
-        ResultStatus::Success == ReadProgramId(program_id)) {
+    if (ResultStatus::Success == ReadProgramId(program_id)) {
         std::string process_name = Common::StringFromFixedZeroTerminatedBuffer(
             (const char*)overlay_ncch->exheader_header.codeset_info.name, 8);
 
@@ -212,12 +212,24 @@ ResultStatus AppLoader_NCCH::Load(std::shared_ptr<Kernel::Process>& process) {
 
     is_loaded = true; // Set state to loaded
 
-    result = LoadExec(process); // Load the executable into memory for booting
-    if (ResultStatus::Success != result)
-        return result;
+    // Reading and decompressing the code doesn't depend on the RomFS, which may have to build a
+    // LayeredFS when opened, so both are done at the same time
+    auto code = std::async(std::launch::async, [this] {
+        std::vector<u8> buffer;
+        const ResultStatus read_result = ReadCode(buffer);
+        return std::make_pair(read_result, std::move(buffer));
+    });
 
     system.ArchiveManager().RegisterSelfNCCH(*this);
 
+    auto [code_result, code_buffer] = code.get();
+    if (ResultStatus::Success != code_result)
+        return ResultStatus::Error;
+
+    result = LoadExec(process, std::move(code_buffer)); // Load the executable into memory
+    if (ResultStatus::Success != result)
+        return result;
+
     ParseRegionLockoutInfo();
 
     return ResultStatus::Success;
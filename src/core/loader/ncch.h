@@ -71,9 +71,10 @@ private:
     /**
      * Loads .code section into memory for booting
      * @param process The newly created process
+     * @param code The .code section, as returned by ReadCode
      * @return ResultStatus result of function
      */
-    ResultStatus LoadExec(std::shared_ptr<Kernel::Process>& process);
+    ResultStatus LoadExec(std::shared_ptr<Kernel::Process>& process, std::vector<u8> code);
 
     /// Reads the region lockout info in the SMDH and send it to CFG service
     void ParseRegionLockoutInfo();
@@ -2,16 +2,23 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <stdexcept>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/binary_object.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include "audio_core/dsp_interface.h"
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/atomic_ops.h"
 #include "common/common_types.h"
+#include "common/host_memory.h"
 #include "common/logging/log.h"
+#include "common/memory_usage.h"
 #include "common/settings.h"
 #include "common/swap.h"
 #include "core/arm/arm_interface.h"
@@ -23,9 +30,12 @@
 #include "core/hle/service/plgldr/plgldr.h"
 #include "core/hw/hw.h"
 #include "core/memory.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
 #include "video_core/video_core.h"
 
+BOOST_CLASS_VERSION(Memory::MemorySystem::Impl, 1)
+
 SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::FCRAM>)
 SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::VRAM>)
 SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::DSP>)
@@ -33,12 +43,74 @@ SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::N3DS>
 
 namespace Memory {
 
+/// FCRAM, VRAM and the N3DS extra RAM, reserved up front and committed as the guest touches them
+static Common::MemoryUsage::Counter GuestMemoryUsage{"Memory", "Guest memory"};
+static Common::MemoryUsage::Counter PageTableUsage{"Memory", "Page tables"};
+
 void PageTable::Clear() {
     pointers.raw.fill(nullptr);
     pointers.refs.fill(MemoryRef());
     attributes.fill(PageType::Unmapped);
 }
 
+template <class Archive>
+void PageTable::serialize(Archive& ar, const unsigned int file_version) {
+    if (file_version == 0) {
+        ar& pointers.refs;
+        ar& special_regions;
+        ar& attributes;
+    } else {
+        // Most pages are unmapped or map the page after the previous one, so the references are
+        // stored as runs of pages rather than a million objects, and the attributes as raw bytes.
+        if constexpr (Archive::is_saving::value) {
+            std::vector<u32> run_starts{0};
+            for (u32 page = 1; page < PAGE_TABLE_NUM_ENTRIES; ++page) {
+                const MemoryRef& previous = pointers.refs[page - 1];
+                const MemoryRef& current = pointers.refs[page];
+                const bool continues = (!previous && !current) ||
+                                       (previous && current.Follows(previous, CITRA_PAGE_SIZE));
+                if (!continues) {
+                    run_starts.push_back(page);
+                }
+            }
+            ar << static_cast<u32>(run_starts.size());
+            for (std::size_t run = 0; run < run_starts.size(); ++run) {
+                const u32 run_end = run + 1 < run_starts.size()
+                                        ? run_starts[run + 1]
+                                        : static_cast<u32>(PAGE_TABLE_NUM_ENTRIES);
+                ar << static_cast<u32>(run_end - run_starts[run]);
+                ar << pointers.refs[run_starts[run]];
+            }
+        } else {
+            u32 num_runs{};
+            ar >> num_runs;
+            std::size_t page = 0;
+            for (u32 run = 0; run < num_runs; ++run) {
+                u32 length{};
+                MemoryRef first;
+                ar >> length;
+                ar >> first;
+                if (length > PAGE_TABLE_NUM_ENTRIES - page) {
+                    throw std::runtime_error("Page table runs exceed the address space");
+                }
+                for (u32 i = 0; i < length; ++i, ++page) {
+                    pointers.refs[page] = first ? first + i * CITRA_PAGE_SIZE : MemoryRef{};
+                }
+            }
+            if (page != PAGE_TABLE_NUM_ENTRIES) {
+                throw std::runtime_error("Page table runs don't cover the address space");
+            }
+        }
+        ar& special_regions;
+        ar& boost::serialization::make_binary_object(attributes.data(), sizeof(attributes));
+    }
+    for (std::size_t i = 0; i < PAGE_TABLE_NUM_ENTRIES; i++) {
+        pointers.raw[i] = pointers.refs[i].GetPtr();
+    }
+}
+
+SERIALIZE_IMPL(PageTable)
+
 class RasterizerCacheMarker {
 public:
     void Mark(VAddr addr, bool cached) {
@@ -87,13 +159,19 @@ private:
     }
 };
 
+/// Cleared while rewind snapshots are serialized, which keep the contents of the memory themselves
+static bool serialize_state_memory = true;
+
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time if they are std::array, which would
-    // exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    // FCRAM, VRAM and the N3DS extra RAM share a single host memory block, so that they can also
+    // be mapped into the fastmem arenas of the page tables.
+    Common::HostMemory host_memory{
+        Memory::FCRAM_N3DS_SIZE + Memory::VRAM_SIZE + Memory::N3DS_EXTRA_RAM_SIZE,
+        Settings::values.use_huge_pages.GetValue()};
+    u8* fcram = host_memory.BackingBasePointer();
+    u8* vram = fcram + Memory::FCRAM_N3DS_SIZE;
+    u8* n3ds_extra_ram = vram + Memory::VRAM_SIZE;
 
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
@@ -108,16 +186,20 @@ public:
 
     Impl();
 
+    void UpdatePageTableUsage() const {
+        PageTableUsage.Set(page_table_list.size() * sizeof(PageTable), page_table_list.size());
+    }
+
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -126,13 +208,13 @@ public:
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram;
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram;
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram;
         default:
             UNREACHABLE();
         }
@@ -167,6 +249,28 @@ public:
         return nullptr; // Should never happen
     }
 
+    /**
+     * Returns the number of bytes, up to max_size and counted from the start of the page, of the
+     * run of plain memory pages beginning at page_index that are also contiguous in host memory.
+     * Such runs can be accessed with a single copy.
+     */
+    std::size_t GetMemoryRunSize(PageTable& page_table, std::size_t page_index,
+                                 std::size_t max_size) const {
+        const auto& pointers = page_table.GetPointerArray();
+        const u8* const start = pointers[page_index];
+        std::size_t run_size = CITRA_PAGE_SIZE;
+        while (run_size < max_size) {
+            const std::size_t next_page = page_index + (run_size >> CITRA_PAGE_BITS);
+            if (next_page == PAGE_TABLE_NUM_ENTRIES ||
+                page_table.attributes[next_page] != PageType::Memory ||
+                pointers[next_page] != start + run_size) {
+                break;
+            }
+            run_size += CITRA_PAGE_SIZE;
+        }
+        return std::min(run_size, max_size);
+    }
+
     template <bool UNSAFE>
     void ReadBlockImpl(const Kernel::Process& process, const VAddr src_addr, void* dest_buffer,
                        const std::size_t size) {
@@ -194,9 +298,17 @@ public:
             case PageType::Memory: {
                 DEBUG_ASSERT(page_table.pointers[page_index]);
 
+                const std::size_t run_size =
+                    GetMemoryRunSize(page_table, page_index, page_offset + remaining_size);
+                const std::size_t block_size = run_size - page_offset;
                 const u8* src_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_buffer, src_ptr, copy_amount);
-                break;
+                std::memcpy(dest_buffer, src_ptr, block_size);
+
+                page_index += run_size >> CITRA_PAGE_BITS;
+                page_offset = run_size & CITRA_PAGE_MASK;
+                dest_buffer = static_cast<u8*>(dest_buffer) + block_size;
+                remaining_size -= block_size;
+                continue;
             }
             case PageType::Special: {
                 MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
@@ -248,9 +360,17 @@ public:
             case PageType::Memory: {
                 DEBUG_ASSERT(page_table.pointers[page_index]);
 
+                const std::size_t run_size =
+                    GetMemoryRunSize(page_table, page_index, page_offset + remaining_size);
+                const std::size_t block_size = run_size - page_offset;
                 u8* dest_ptr = page_table.pointers[page_index] + page_offset;
-                std::memcpy(dest_ptr, src_buffer, copy_amount);
-                break;
+                std::memcpy(dest_ptr, src_buffer, block_size);
+
+                page_index += run_size >> CITRA_PAGE_BITS;
+                page_offset = run_size & CITRA_PAGE_MASK;
+                src_buffer = static_cast<const u8*>(src_buffer) + block_size;
+                remaining_size -= block_size;
+                continue;
             }
             case PageType::Special: {
                 MMIORegionPointer handler = GetMMIOHandler(page_table, current_vaddr);
@@ -277,6 +397,69 @@ public:
         }
     }
 
+    bool IsFastmemEnabled() const {
+        return Settings::values.use_cpu_jit.GetValue() && Settings::values.use_fastmem.GetValue() &&
+               host_memory.SupportsArenas() &&
+               Common::HostMemory::PageSize() == CITRA_PAGE_SIZE;
+    }
+
+    /// Reserves the fastmem arena of the page table and maps all of its pages
+    void InitFastmem(PageTable& page_table) {
+        page_table.fastmem_arena.reset();
+        page_table.fastmem_base = nullptr;
+        if (!IsFastmemEnabled()) {
+            return;
+        }
+
+        auto arena = std::make_shared<Common::VirtualArena>(
+            host_memory, static_cast<std::size_t>(PAGE_TABLE_NUM_ENTRIES) * CITRA_PAGE_SIZE);
+        if (arena->BasePointer() == nullptr) {
+            return;
+        }
+        page_table.fastmem_base = arena->BasePointer();
+        page_table.fastmem_arena = std::move(arena);
+        UpdateFastmem(page_table, 0, PAGE_TABLE_NUM_ENTRIES);
+    }
+
+    /**
+     * Mirrors the pointers of a range of pages into the fastmem arena of the page table. Pages
+     * backed by the host memory block are mapped, contiguous ones in a single call, while all the
+     * others are left inaccessible so that accesses to them fault and fall back to the callbacks.
+     */
+    void UpdateFastmem(PageTable& page_table, u32 base, u32 num_pages) {
+        if (!page_table.fastmem_arena) {
+            return;
+        }
+
+        auto& arena = *page_table.fastmem_arena;
+        const auto& pointers = page_table.GetPointerArray();
+        const u8* backing = host_memory.BackingBasePointer();
+        const auto host_offset = [&](u32 page) {
+            return static_cast<std::size_t>(pointers[page] - backing);
+        };
+
+        const u32 end = base + num_pages;
+        u32 page = base;
+        while (page != end) {
+            const bool mapped = host_memory.Contains(pointers[page]);
+            u32 run_end = page + 1;
+            while (run_end != end && host_memory.Contains(pointers[run_end]) == mapped &&
+                   (!mapped || host_offset(run_end) ==
+                                   host_offset(page) + (run_end - page) * CITRA_PAGE_SIZE)) {
+                ++run_end;
+            }
+
+            const std::size_t virtual_offset = static_cast<std::size_t>(page) * CITRA_PAGE_SIZE;
+            const std::size_t length = static_cast<std::size_t>(run_end - page) * CITRA_PAGE_SIZE;
+            if (mapped) {
+                arena.Map(virtual_offset, host_offset(page), length);
+            } else {
+                arena.Unmap(virtual_offset, length);
+            }
+            page = run_end;
+        }
+    }
+
     MemoryRef GetPointerForRasterizerCache(VAddr addr) const {
         if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
             return {fcram_mem, addr - LINEAR_HEAP_VADDR};
@@ -296,19 +479,138 @@ public:
         return MemoryRef{};
     }
 
+    void UpdateStateMemoryCopy(
+        std::span<u8> copy,
+        const std::function<void(std::size_t, std::span<const u8>)>& changed) const {
+        ASSERT(copy.size() == StateMemorySize);
+        const u8* const base = host_memory.BackingBasePointer();
+        const auto update_page = [&](std::size_t offset, const u8* current) {
+            u8* const old = copy.data() + offset;
+            if (current ? std::memcmp(old, current, CITRA_PAGE_SIZE) == 0 : IsZeroPage(old)) {
+                return;
+            }
+            changed(offset, {old, CITRA_PAGE_SIZE});
+            if (current) {
+                std::memcpy(old, current, CITRA_PAGE_SIZE);
+            } else {
+                std::memset(old, 0, CITRA_PAGE_SIZE);
+            }
+        };
+
+        // Pages that the host never populated are known to be zero without reading them
+        std::size_t offset = 0;
+        for (const auto& [range_offset, range_size] :
+             host_memory.GetPopulatedRanges(0, StateMemorySize)) {
+            const std::size_t first = range_offset & ~static_cast<std::size_t>(CITRA_PAGE_MASK);
+            const std::size_t last = (range_offset + range_size + CITRA_PAGE_MASK) &
+                                     ~static_cast<std::size_t>(CITRA_PAGE_MASK);
+            for (; offset < first; offset += CITRA_PAGE_SIZE) {
+                update_page(offset, nullptr);
+            }
+            for (offset = std::max(offset, first); offset < last; offset += CITRA_PAGE_SIZE) {
+                update_page(offset, base + offset);
+            }
+        }
+        for (; offset < StateMemorySize; offset += CITRA_PAGE_SIZE) {
+            update_page(offset, nullptr);
+        }
+    }
+
+    void RestoreStateMemory(std::span<const u8> copy) {
+        ASSERT(copy.size() == StateMemorySize);
+        host_memory.Discard(0, StateMemorySize);
+        u8* const base = host_memory.BackingBasePointer();
+        for (std::size_t offset = 0; offset < StateMemorySize; offset += CITRA_PAGE_SIZE) {
+            // Leave the zero pages to the host
+            if (!IsZeroPage(copy.data() + offset)) {
+                std::memcpy(base + offset, copy.data() + offset, CITRA_PAGE_SIZE);
+            }
+        }
+    }
+
 private:
+    /// Returns true if the page at the pointer only holds zeroes
+    static bool IsZeroPage(const u8* page) {
+        std::array<u64, CITRA_PAGE_SIZE / sizeof(u64)> words;
+        std::memcpy(words.data(), page, CITRA_PAGE_SIZE);
+        return std::all_of(words.begin(), words.end(), [](u64 word) { return word == 0; });
+    }
+
+    /**
+     * Serializes a region of the host memory block sparsely: only the pages holding data are
+     * stored, after a bitmap of them. Pages that are missing on load are discarded instead, so
+     * they stop using host memory.
+     */
+    template <class Archive>
+    void SerializeRegion(Archive& ar, u8* base, std::size_t size) {
+        const std::size_t offset = static_cast<std::size_t>(base - fcram);
+        const std::size_t num_pages = size >> CITRA_PAGE_BITS;
+        std::vector<u64> present((num_pages + 63) / 64);
+        const auto is_present = [&present](std::size_t page) {
+            return ((present[page / 64] >> (page % 64)) & 1) != 0;
+        };
+
+        if constexpr (Archive::is_saving::value) {
+            // Pages that the host never populated are known to be zero without reading them
+            for (const auto& [range_offset, range_size] :
+                 host_memory.GetPopulatedRanges(offset, size)) {
+                const std::size_t first = (range_offset - offset) >> CITRA_PAGE_BITS;
+                const std::size_t last =
+                    (range_offset - offset + range_size + CITRA_PAGE_MASK) >> CITRA_PAGE_BITS;
+                for (std::size_t page = first; page < last; ++page) {
+                    if (!IsZeroPage(base + (page << CITRA_PAGE_BITS))) {
+                        present[page / 64] |= u64{1} << (page % 64);
+                    }
+                }
+            }
+        }
+        ar& present;
+
+        std::size_t page = 0;
+        while (page != num_pages) {
+            const bool run_present = is_present(page);
+            std::size_t run_end = page + 1;
+            while (run_end != num_pages && is_present(run_end) == run_present) {
+                ++run_end;
+            }
+
+            u8* const run = base + (page << CITRA_PAGE_BITS);
+            const std::size_t run_size = (run_end - page) << CITRA_PAGE_BITS;
+            if (run_present) {
+                ar& boost::serialization::make_binary_object(run, run_size);
+            } else if constexpr (Archive::is_loading::value) {
+                host_memory.Discard(offset + (page << CITRA_PAGE_BITS), run_size);
+            }
+            page = run_end;
+        }
+    }
+
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
         ar& save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+        const std::size_t fcram_size = save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE;
+        const std::size_t n3ds_extra_ram_size = save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0;
+        if (!serialize_state_memory) {
+            // Kept by the rewind snapshot
+        } else if (file_version > 0) {
+            SerializeRegion(ar, vram, Memory::VRAM_SIZE);
+            SerializeRegion(ar, fcram, fcram_size);
+            SerializeRegion(ar, n3ds_extra_ram, n3ds_extra_ram_size);
+        } else {
+            ar& boost::serialization::make_binary_object(vram, Memory::VRAM_SIZE);
+            ar& boost::serialization::make_binary_object(fcram, fcram_size);
+            ar& boost::serialization::make_binary_object(n3ds_extra_ram, n3ds_extra_ram_size);
+        }
         ar& cache_marker;
         ar& page_table_list;
+        if constexpr (Archive::is_loading::value) {
+            for (auto& page_table : page_table_list) {
+                InitFastmem(*page_table);
+            }
+            UpdatePageTableUsage();
+        }
         // dsp is set from Core::System at startup
         ar& current_page_table;
         ar& fcram_mem;
@@ -351,8 +653,14 @@ MemorySystem::Impl::Impl()
       n3ds_extra_ram_mem(std::make_shared<BackingMemImpl<Region::N3DS>>(*this)),
       dsp_mem(std::make_shared<BackingMemImpl<Region::DSP>>(*this)) {}
 
-MemorySystem::MemorySystem() : impl(std::make_unique<Impl>()) {}
-MemorySystem::~MemorySystem() = default;
+MemorySystem::MemorySystem() : impl(std::make_unique<Impl>()) {
+    GuestMemoryUsage.Add(impl->host_memory.BackingSize());
+}
+
+MemorySystem::~MemorySystem() {
+    GuestMemoryUsage.Remove(impl->host_memory.BackingSize());
+    PageTableUsage.Set(0, 0);
+}
 
 template <class Archive>
 void MemorySystem::serialize(Archive& ar, const unsigned int file_version) {
@@ -377,6 +685,7 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
     RasterizerFlushVirtualRegion(base << CITRA_PAGE_BITS, size * CITRA_PAGE_SIZE,
                                  FlushMode::FlushAndInvalidate);
 
+    const u32 first_page = base;
     u32 end = base + size;
     while (base != end) {
         ASSERT_MSG(base < PAGE_TABLE_NUM_ENTRIES, "out of range mapping at {:08X}", base);
@@ -394,6 +703,8 @@ void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef
         if (memory != nullptr && memory.GetSize() > CITRA_PAGE_SIZE)
             memory += CITRA_PAGE_SIZE;
     }
+
+    impl->UpdateFastmem(page_table, first_page, size);
 }
 
 void MemorySystem::MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, MemoryRef target) {
@@ -424,7 +735,9 @@ MemoryRef MemorySystem::GetPointerForRasterizerCache(VAddr addr) const {
 }
 
 void MemorySystem::RegisterPageTable(std::shared_ptr<PageTable> page_table) {
+    impl->InitFastmem(*page_table);
     impl->page_table_list.push_back(page_table);
+    impl->UpdatePageTableUsage();
 }
 
 void MemorySystem::UnregisterPageTable(std::shared_ptr<PageTable> page_table) {
@@ -432,6 +745,9 @@ void MemorySystem::UnregisterPageTable(std::shared_ptr<PageTable> page_table) {
     if (it != impl->page_table_list.end()) {
         impl->page_table_list.erase(it);
     }
+    impl->UpdatePageTableUsage();
+    page_table->fastmem_arena.reset();
+    page_table->fastmem_base = nullptr;
 }
 
 template <typename T>
@@ -742,6 +1058,7 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                     case PageType::Memory:
                         page_type = PageType::RasterizerCachedMemory;
                         page_table->pointers[vaddr >> CITRA_PAGE_BITS] = nullptr;
+                        impl->UpdateFastmem(*page_table, vaddr >> CITRA_PAGE_BITS, 1);
                         break;
                     default:
                         UNREACHABLE();
@@ -757,6 +1074,7 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
                         page_type = PageType::Memory;
                         page_table->pointers[vaddr >> CITRA_PAGE_BITS] =
                             GetPointerForRasterizerCache(vaddr & ~CITRA_PAGE_MASK);
+                        impl->UpdateFastmem(*page_table, vaddr >> CITRA_PAGE_BITS, 1);
                         break;
                     }
                     default:
@@ -773,6 +1091,11 @@ void RasterizerFlushRegion(PAddr start, u32 size) {
         return;
     }
 
+    if (VideoCore::g_gpu_thread) {
+        VideoCore::g_gpu_thread->FlushRegion(start, size);
+        return;
+    }
+
     VideoCore::g_renderer->Rasterizer()->FlushRegion(start, size);
 }
 
@@ -781,6 +1104,11 @@ void RasterizerInvalidateRegion(PAddr start, u32 size) {
         return;
     }
 
+    if (VideoCore::g_gpu_thread) {
+        VideoCore::g_gpu_thread->InvalidateRegion(start, size);
+        return;
+    }
+
     VideoCore::g_renderer->Rasterizer()->InvalidateRegion(start, size);
 }
 
@@ -791,6 +1119,11 @@ void RasterizerFlushAndInvalidateRegion(PAddr start, u32 size) {
         return;
     }
 
+    if (VideoCore::g_gpu_thread) {
+        VideoCore::g_gpu_thread->FlushAndInvalidateRegion(start, size);
+        return;
+    }
+
     VideoCore::g_renderer->Rasterizer()->FlushAndInvalidateRegion(start, size);
 }
 
@@ -801,6 +1134,11 @@ void RasterizerClearAll(bool flush) {
         return;
     }
 
+    if (VideoCore::g_gpu_thread) {
+        VideoCore::g_gpu_thread->ClearAll(flush);
+        return;
+    }
+
     VideoCore::g_renderer->Rasterizer()->ClearAll(flush);
 }
 
@@ -824,16 +1162,15 @@ void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
         PAddr physical_start = paddr_region_start + (overlap_start - region_start);
         u32 overlap_size = overlap_end - overlap_start;
 
-        auto* rasterizer = VideoCore::g_renderer->Rasterizer();
         switch (mode) {
         case FlushMode::Flush:
-            rasterizer->FlushRegion(physical_start, overlap_size);
+            RasterizerFlushRegion(physical_start, overlap_size);
             break;
         case FlushMode::Invalidate:
-            rasterizer->InvalidateRegion(physical_start, overlap_size);
+            RasterizerInvalidateRegion(physical_start, overlap_size);
             break;
         case FlushMode::FlushAndInvalidate:
-            rasterizer->FlushAndInvalidateRegion(physical_start, overlap_size);
+            RasterizerFlushAndInvalidateRegion(physical_start, overlap_size);
             break;
         }
     };
@@ -872,6 +1209,22 @@ void MemorySystem::ReadBlock(VAddr src_addr, void* dest_buffer, std::size_t size
     return impl->ReadBlockImpl<false>(process, src_addr, dest_buffer, size);
 }
 
+std::span<u8> MemorySystem::GetContiguousSpan(const Kernel::Process& process, const VAddr vaddr,
+                                               const std::size_t size) {
+    if (size == 0) {
+        return {};
+    }
+    auto& page_table = *process.vm_manager.page_table;
+    const std::size_t page_index = vaddr >> CITRA_PAGE_BITS;
+    const std::size_t page_offset = vaddr & CITRA_PAGE_MASK;
+    if (page_table.attributes[page_index] != PageType::Memory ||
+        impl->GetMemoryRunSize(page_table, page_index, page_offset + size) !=
+            page_offset + size) {
+        return {};
+    }
+    return {page_table.GetPointerArray()[page_index] + page_offset, size};
+}
+
 void MemorySystem::Write8(const VAddr addr, const u8 data) {
     Write<u8>(addr, data);
 }
@@ -1067,18 +1420,23 @@ void WriteMMIO<u64>(MMIORegionPointer mmio_handler, VAddr addr, const u64 data)
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram && pointer <= impl->fcram + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram);
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram + offset;
+}
+
+void MemorySystem::ZeroFCRAM(std::size_t offset, std::size_t size) {
+    ASSERT(offset + size <= Memory::FCRAM_N3DS_SIZE);
+    impl->host_memory.Discard(offset, size);
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
@@ -1090,4 +1448,26 @@ void MemorySystem::SetDSP(AudioCore::DspInterface& dsp) {
     impl->dsp = &dsp;
 }
 
+void MemorySystem::UpdateStateMemoryCopy(
+    std::span<u8> copy,
+    const std::function<void(std::size_t, std::span<const u8>)>& changed) const {
+    impl->UpdateStateMemoryCopy(copy, changed);
+}
+
+void MemorySystem::RestoreStateMemory(std::span<const u8> copy) {
+    impl->RestoreStateMemory(copy);
+}
+
+std::span<u8> MemorySystem::GetStateMemory() {
+    return {impl->host_memory.BackingBasePointer(), StateMemorySize};
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> MemorySystem::GetPopulatedStateMemory() const {
+    return impl->host_memory.GetPopulatedRanges(0, StateMemorySize);
+}
+
+void MemorySystem::SetSerializeStateMemory(bool serialize) {
+    serialize_state_memory = serialize;
+}
+
 } // namespace Memory
@@ -5,15 +5,25 @@
 #pragma once
 #include <array>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/common_types.h"
 #include "common/memory_ref.h"
 #include "core/mmio.h"
 
 class ARM_Interface;
 
+namespace Common {
+class VirtualArena;
+}
+
 namespace Kernel {
 class Process;
 }
@@ -118,6 +128,13 @@ struct PageTable {
      */
     std::array<PageType, PAGE_TABLE_NUM_ENTRIES> attributes;
 
+    /**
+     * Host mapping of the whole address space, in which only the pages of type `Memory` are
+     * accessible. Null if fastmem is disabled. Not serialized, it is rebuilt on load.
+     */
+    std::shared_ptr<Common::VirtualArena> fastmem_arena;
+    u8* fastmem_base = nullptr;
+
     std::array<u8*, PAGE_TABLE_NUM_ENTRIES>& GetPointerArray() {
         return pointers.raw;
     }
@@ -126,14 +143,7 @@ struct PageTable {
 
 private:
     template <class Archive>
-    void serialize(Archive& ar, const unsigned int) {
-        ar& pointers.refs;
-        ar& special_regions;
-        ar& attributes;
-        for (std::size_t i = 0; i < PAGE_TABLE_NUM_ENTRIES; i++) {
-            pointers.raw[i] = pointers.refs[i].GetPtr();
-        }
-    }
+    void serialize(Archive& ar, const unsigned int file_version);
     friend class boost::serialization::access;
 };
 
@@ -535,6 +545,23 @@ public:
      */
     void WriteBlock(VAddr dest_addr, const void* src_buffer, std::size_t size);
 
+    /**
+     * Gets a direct view of a range of a process' address space, for HLE code to access guest
+     * buffers without copying them.
+     *
+     * @param process The process whose address space is viewed.
+     * @param vaddr   The virtual address the view begins at.
+     * @param size    The size of the view, in bytes.
+     *
+     * @returns The view, or an empty span if any page of the range isn't plain memory or the
+     *          pages aren't contiguous in host memory. Callers must then fall back to
+     *          ReadBlock/WriteBlock.
+     *
+     * @note The view is only valid until the address space or the rasterizer cache state of the
+     *       range changes, so it must not be held across a reschedule.
+     */
+    std::span<u8> GetContiguousSpan(const Kernel::Process& process, VAddr vaddr, std::size_t size);
+
     /**
      * Zeros a range of bytes within the current process' address space at the specified
      * virtual address.
@@ -599,6 +626,9 @@ public:
     /// Gets a serializable ref to FCRAM with the given offset
     MemoryRef GetFCRAMRef(std::size_t offset) const;
 
+    /// Zeroes a range of FCRAM, returning its host memory until it is written to again
+    void ZeroFCRAM(std::size_t offset, std::size_t size);
+
     /// Registers page table for rasterizer cache marking
     void RegisterPageTable(std::shared_ptr<PageTable> page_table);
 
@@ -607,6 +637,35 @@ public:
 
     void SetDSP(AudioCore::DspInterface& dsp);
 
+    /// Size of FCRAM, VRAM and the N3DS extra RAM, which rewind snapshots keep outside of the
+    /// serialized state
+    static constexpr std::size_t StateMemorySize =
+        FCRAM_N3DS_SIZE + VRAM_SIZE + N3DS_EXTRA_RAM_SIZE;
+
+    /**
+     * Updates a copy of FCRAM, VRAM and the N3DS extra RAM to their current contents.
+     * @param copy the copy to update, StateMemorySize bytes large
+     * @param changed called with the offset and the old contents of every page that differs,
+     * before the page is updated
+     */
+    void UpdateStateMemoryCopy(
+        std::span<u8> copy,
+        const std::function<void(std::size_t, std::span<const u8>)>& changed) const;
+
+    /// Replaces FCRAM, VRAM and the N3DS extra RAM with a copy made by UpdateStateMemoryCopy
+    void RestoreStateMemory(std::span<const u8> copy);
+
+    /// Returns FCRAM, VRAM and the N3DS extra RAM, laid out one after the other
+    [[nodiscard]] std::span<u8> GetStateMemory();
+
+    /// Returns the (offset, length) ranges of the state memory that may hold data, the rest of it
+    /// reads as zero
+    [[nodiscard]] std::vector<std::pair<std::size_t, std::size_t>> GetPopulatedStateMemory() const;
+
+    /// Sets whether the memory system serializes the contents of FCRAM, VRAM and the N3DS extra
+    /// RAM, which rewind snapshots keep separately
+    static void SetSerializeStateMemory(bool serialize);
+
 private:
     template <typename T>
     T Read(const VAddr vaddr);
@@ -627,7 +686,11 @@ private:
 
     void MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef memory, PageType type);
 
+public:
+    // Public so that its serialization version can be declared
     class Impl;
+
+private:
     std::unique_ptr<Impl> impl;
 
     friend class boost::serialization::access;
@@ -645,3 +708,5 @@ BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::FCRA
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::VRAM>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::DSP>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::N3DS>)
+
+BOOST_CLASS_VERSION(Memory::PageTable, 1)
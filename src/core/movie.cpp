@@ -129,7 +129,10 @@ struct CTMHeader {
 static_assert(sizeof(CTMHeader) == 256, "CTMHeader should be 256 bytes");
 #pragma pack(pop)
 
-static u64 GetInputCount(const std::vector<u8>& input) {
+/// The input is written to and read from the movie file in chunks of this size
+constexpr std::size_t InputChunkSize = sizeof(ControllerState) * 8192;
+
+static u64 GetInputCount(std::span<const u8> input) {
     u64 input_count = 0;
     for (std::size_t pos = 0; pos < input.size(); pos += sizeof(ControllerState)) {
         if (input.size() < pos + sizeof(ControllerState)) {
@@ -156,7 +159,10 @@ void Movie::serialize(Archive& ar, const unsigned int file_version) {
         ar& current_input;
     }
 
-    std::vector<u8> recorded_input_ = recorded_input;
+    std::vector<u8> recorded_input_;
+    if (Archive::is_saving::value) {
+        recorded_input_ = ReadInput(static_cast<std::size_t>(GetInputSize()));
+    }
     ar& recorded_input_;
 
     ar& init_time;
@@ -184,10 +190,6 @@ void Movie::serialize(Archive& ar, const unsigned int file_version) {
     }
 
     if (Archive::is_loading::value && id != 0) {
-        if (!read_only) {
-            recorded_input = std::move(recorded_input_);
-        }
-
         if (post_movie) {
             play_mode = PlayMode::MovieFinished;
             return;
@@ -197,21 +199,24 @@ void Movie::serialize(Archive& ar, const unsigned int file_version) {
             if (play_mode == PlayMode::Recording) {
                 SaveMovie();
             }
-            if (recorded_input_.size() >= recorded_input.size()) {
+            if (recorded_input_.size() >= GetInputSize()) {
                 throw std::runtime_error("Future event savestate not allowed in R/O mode");
             }
             // Ensure that the current movie and savestate movie are in the same timeline
-            if (std::mismatch(recorded_input_.begin(), recorded_input_.end(),
-                              recorded_input.begin())
-                    .first != recorded_input_.end()) {
+            if (ReadInput(recorded_input_.size()) != recorded_input_) {
                 throw std::runtime_error("Timeline mismatch not allowed in R/O mode");
             }
 
             play_mode = PlayMode::Playing;
-            total_input = GetInputCount(recorded_input);
+            total_input = file_input_count;
+            input_buffer.clear();
+            buffer_offset = current_byte;
         } else {
+            // The input after the savestate is recorded again
+            recorded_input_.resize(std::min(current_byte, recorded_input_.size()));
             play_mode = PlayMode::Recording;
             rerecord_count++;
+            RewriteInput(recorded_input_);
         }
     }
 }
@@ -230,7 +235,7 @@ u64 Movie::GetTotalInputCount() const {
 }
 
 void Movie::CheckInputEnd() {
-    if (current_byte + sizeof(ControllerState) > recorded_input.size()) {
+    if (current_byte + sizeof(ControllerState) > file_input_size) {
         LOG_INFO(Movie, "Playback finished");
         play_mode = PlayMode::MovieFinished;
         playback_completion_callback();
@@ -239,7 +244,7 @@ void Movie::CheckInputEnd() {
 
 void Movie::Play(Service::HID::PadState& pad_state, s16& circle_pad_x, s16& circle_pad_y) {
     ControllerState s;
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+    std::memcpy(&s, &input_buffer[current_byte - buffer_offset], sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
     current_input++;
 
@@ -271,7 +276,7 @@ void Movie::Play(Service::HID::PadState& pad_state, s16& circle_pad_x, s16& circ
 
 void Movie::Play(Service::HID::TouchDataEntry& touch_data) {
     ControllerState s;
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+    std::memcpy(&s, &input_buffer[current_byte - buffer_offset], sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
 
     if (s.type != ControllerStateType::Touch) {
@@ -288,7 +293,7 @@ void Movie::Play(Service::HID::TouchDataEntry& touch_data) {
 
 void Movie::Play(Service::HID::AccelerometerDataEntry& accelerometer_data) {
     ControllerState s;
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+    std::memcpy(&s, &input_buffer[current_byte - buffer_offset], sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
 
     if (s.type != ControllerStateType::Accelerometer) {
@@ -305,7 +310,7 @@ void Movie::Play(Service::HID::AccelerometerDataEntry& accelerometer_data) {
 
 void Movie::Play(Service::HID::GyroscopeDataEntry& gyroscope_data) {
     ControllerState s;
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+    std::memcpy(&s, &input_buffer[current_byte - buffer_offset], sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
 
     if (s.type != ControllerStateType::Gyroscope) {
@@ -322,7 +327,7 @@ void Movie::Play(Service::HID::GyroscopeDataEntry& gyroscope_data) {
 
 void Movie::Play(Service::IR::PadState& pad_state, s16& c_stick_x, s16& c_stick_y) {
     ControllerState s;
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+    std::memcpy(&s, &input_buffer[current_byte - buffer_offset], sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
 
     if (s.type != ControllerStateType::IrRst) {
@@ -340,7 +345,7 @@ void Movie::Play(Service::IR::PadState& pad_state, s16& c_stick_x, s16& c_stick_
 
 void Movie::Play(Service::IR::ExtraHIDResponse& extra_hid_response) {
     ControllerState s;
-    std::memcpy(&s, &recorded_input[current_byte], sizeof(ControllerState));
+    std::memcpy(&s, &input_buffer[current_byte - buffer_offset], sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
 
     if (s.type != ControllerStateType::ExtraHidResponse) {
@@ -362,9 +367,14 @@ void Movie::Play(Service::IR::ExtraHIDResponse& extra_hid_response) {
 }
 
 void Movie::Record(const ControllerState& controller_state) {
-    recorded_input.resize(current_byte + sizeof(ControllerState));
-    std::memcpy(&recorded_input[current_byte], &controller_state, sizeof(ControllerState));
+    ASSERT(current_byte == GetInputSize());
+    const auto* bytes = reinterpret_cast<const u8*>(&controller_state);
+    input_buffer.insert(input_buffer.end(), bytes, bytes + sizeof(ControllerState));
     current_byte += sizeof(ControllerState);
+
+    if (input_buffer.size() >= InputChunkSize) {
+        FlushInput();
+    }
 }
 
 void Movie::Record(const Service::HID::PadState& pad_state, const s16& circle_pad_x,
@@ -475,21 +485,7 @@ Movie::ValidationResult Movie::ValidateHeader(const CTMHeader& header) const {
     return ValidationResult::OK;
 }
 
-Movie::ValidationResult Movie::ValidateInput(const std::vector<u8>& input,
-                                             u64 expected_count) const {
-    return GetInputCount(input) == expected_count ? ValidationResult::OK
-                                                  : ValidationResult::InputCountDismatch;
-}
-
-void Movie::SaveMovie() {
-    LOG_INFO(Movie, "Saving recorded movie to '{}'", record_movie_file);
-    FileUtil::IOFile save_record(record_movie_file, "wb");
-
-    if (!save_record.IsGood()) {
-        LOG_ERROR(Movie, "Unable to open file to save movie");
-        return;
-    }
-
+void Movie::WriteHeader() {
     CTMHeader header = {};
     header.filetype = header_magic_bytes;
     header.program_id = program_id;
@@ -500,21 +496,94 @@ void Movie::SaveMovie() {
                 std::min(header.author.size(), record_movie_author.size()));
 
     header.rerecord_count = rerecord_count;
-    header.input_count = GetInputCount(recorded_input);
+    // Only count the input in the file, so that the header matches it after a crash
+    header.input_count = file_input_count;
 
     std::string rev_bytes;
     CryptoPP::StringSource(Common::g_scm_rev, true,
                            new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
     std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(CTMHeader::revision));
 
-    save_record.WriteBytes(&header, sizeof(CTMHeader));
-    save_record.WriteBytes(recorded_input.data(), recorded_input.size());
+    movie_file_handle.Seek(0, SEEK_SET);
+    movie_file_handle.WriteBytes(&header, sizeof(CTMHeader));
+}
 
-    if (!save_record.IsGood()) {
+void Movie::FlushInput() {
+    if (!input_buffer.empty()) {
+        movie_file_handle.Seek(sizeof(CTMHeader) + file_input_size, SEEK_SET);
+        movie_file_handle.WriteBytes(input_buffer.data(), input_buffer.size());
+        file_input_size += input_buffer.size();
+        file_input_count += GetInputCount(input_buffer);
+        input_buffer.clear();
+        buffer_offset = file_input_size;
+    }
+    WriteHeader();
+    movie_file_handle.Flush();
+
+    if (!movie_file_handle.IsGood()) {
         LOG_ERROR(Movie, "Error saving movie");
+        movie_file_handle.Clear();
     }
 }
 
+void Movie::RewriteInput(std::span<const u8> input) {
+    movie_file_handle = FileUtil::IOFile(record_movie_file, "w+b");
+    if (!movie_file_handle.IsOpen()) {
+        LOG_ERROR(Movie, "Unable to open file to save movie");
+    }
+    input_buffer.assign(input.begin(), input.end());
+    buffer_offset = 0;
+    file_input_size = 0;
+    file_input_count = 0;
+    FlushInput();
+}
+
+bool Movie::BufferInput() {
+    if (current_byte >= buffer_offset &&
+        current_byte + sizeof(ControllerState) <= buffer_offset + input_buffer.size()) {
+        return true;
+    }
+
+    buffer_offset = current_byte;
+    input_buffer.resize(static_cast<std::size_t>(
+        std::min<u64>(InputChunkSize, file_input_size - current_byte)));
+    if (!movie_file_handle.Seek(sizeof(CTMHeader) + buffer_offset, SEEK_SET) ||
+        movie_file_handle.ReadBytes(input_buffer.data(), input_buffer.size()) !=
+            input_buffer.size()) {
+        input_buffer.clear();
+        movie_file_handle.Clear();
+        return false;
+    }
+    return true;
+}
+
+std::vector<u8> Movie::ReadInput(std::size_t size) {
+    if (play_mode == PlayMode::Recording) {
+        FlushInput();
+    }
+
+    std::vector<u8> input(size);
+    if (size == 0) {
+        return input;
+    }
+    if (!movie_file_handle.Seek(sizeof(CTMHeader), SEEK_SET) ||
+        movie_file_handle.ReadBytes(input.data(), size) != size) {
+        movie_file_handle.Clear();
+        throw std::runtime_error("Could not read the movie file");
+    }
+    return input;
+}
+
+u64 Movie::GetInputSize() const {
+    return play_mode == PlayMode::Recording ? file_input_size + input_buffer.size()
+                                            : file_input_size;
+}
+
+void Movie::SaveMovie() {
+    LOG_INFO(Movie, "Saving recorded movie to '{}'", record_movie_file);
+    FlushInput();
+}
+
 void Movie::SetPlaybackCompletionCallback(std::function<void()> completion_callback) {
     playback_completion_callback = completion_callback;
 }
@@ -538,8 +607,12 @@ void Movie::StartPlayback(const std::string& movie_file) {
             rerecord_count = header.rerecord_count;
             total_input = header.input_count;
 
-            recorded_input.resize(size - sizeof(CTMHeader));
-            save_record.ReadArray(recorded_input.data(), recorded_input.size());
+            // The input is read from the file as it is played
+            movie_file_handle = std::move(save_record);
+            input_buffer.clear();
+            buffer_offset = 0;
+            file_input_size = size - sizeof(CTMHeader);
+            file_input_count = header.input_count;
 
             current_byte = 0;
             current_input = 0;
@@ -554,6 +627,13 @@ void Movie::StartPlayback(const std::string& movie_file) {
 }
 
 void Movie::StartRecording(const std::string& movie_file, const std::string& author) {
+    // The input is written to the file as it is recorded
+    FileUtil::IOFile save_record(movie_file, "w+b");
+    if (!save_record.IsOpen()) {
+        LOG_ERROR(Movie, "Unable to open file to save movie");
+        return;
+    }
+
     play_mode = PlayMode::Recording;
     record_movie_file = movie_file;
     record_movie_author = author;
@@ -567,6 +647,13 @@ void Movie::StartRecording(const std::string& movie_file, const std::string& aut
     program_id = 0;
     Core::System::GetInstance().GetAppLoader().ReadProgramId(program_id);
 
+    movie_file_handle = std::move(save_record);
+    input_buffer.clear();
+    buffer_offset = 0;
+    file_input_size = 0;
+    file_input_count = 0;
+    FlushInput();
+
     LOG_INFO(Movie, "Enabling Movie recording, ID: {:016X}", id);
 }
 
@@ -640,9 +727,18 @@ Movie::ValidationResult Movie::ValidateMovie(const std::string& movie_file) cons
         return ValidationResult::OK;
     }
 
-    std::vector<u8> input(size - sizeof(header));
-    save_record.ReadArray(input.data(), input.size());
-    return ValidateInput(input, header.input_count);
+    u64 input_count = 0;
+    std::vector<u8> input(InputChunkSize);
+    for (u64 remaining = size - sizeof(header); remaining > 0;) {
+        const auto count = static_cast<std::size_t>(std::min<u64>(remaining, input.size()));
+        if (save_record.ReadBytes(input.data(), count) != count) {
+            return ValidationResult::Invalid;
+        }
+        input_count += GetInputCount({input.data(), count});
+        remaining -= count;
+    }
+    return input_count == header.input_count ? ValidationResult::OK
+                                             : ValidationResult::InputCountDismatch;
 }
 
 Movie::MovieMetadata Movie::GetMovieMetadata(const std::string& movie_file) const {
@@ -663,7 +759,11 @@ void Movie::Shutdown() {
     }
 
     play_mode = PlayMode::None;
-    recorded_input.resize(0);
+    movie_file_handle.Close();
+    input_buffer = {};
+    buffer_offset = 0;
+    file_input_size = 0;
+    file_input_count = 0;
     record_movie_file.clear();
     current_byte = 0;
     current_input = 0;
@@ -674,7 +774,13 @@ void Movie::Shutdown() {
 template <typename... Targs>
 void Movie::Handle(Targs&... Fargs) {
     if (play_mode == PlayMode::Playing) {
-        ASSERT(current_byte + sizeof(ControllerState) <= recorded_input.size());
+        ASSERT(current_byte + sizeof(ControllerState) <= file_input_size);
+        if (!BufferInput()) {
+            LOG_ERROR(Movie, "Unable to read the movie file, stopping playback");
+            play_mode = PlayMode::MovieFinished;
+            playback_completion_callback();
+            return;
+        }
         Play(Fargs...);
         CheckInputEnd();
     } else if (play_mode == PlayMode::Recording) {
@@ -5,8 +5,10 @@
 #pragma once
 
 #include <functional>
+#include <span>
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
+#include "common/file_util.h"
 
 namespace Service {
 namespace HID {
@@ -126,7 +128,8 @@ public:
     u64 GetTotalInputCount() const;
 
     /**
-     * Saves the movie immediately, in its current state.
+     * Writes the buffered input and the header to the movie file immediately. The input is also
+     * written whenever a chunk of it has been recorded, so little is lost when Citra crashes.
      * This is called in Shutdown.
      */
     void SaveMovie();
@@ -156,7 +159,24 @@ private:
     void Record(const Service::IR::ExtraHIDResponse& extra_hid_response);
 
     ValidationResult ValidateHeader(const CTMHeader& header) const;
-    ValidationResult ValidateInput(const std::vector<u8>& input, u64 expected_count) const;
+
+    /// Writes the header of the movie being recorded to the movie file
+    void WriteHeader();
+
+    /// Writes the recorded input that is still buffered and the header to the movie file
+    void FlushInput();
+
+    /// Replaces the input of the movie file, used when rerecording from a savestate
+    void RewriteInput(std::span<const u8> input);
+
+    /// Reads the next controller state into the input buffer when playing, if it isn't there yet
+    bool BufferInput();
+
+    /// Returns the first bytes of the input of the current movie
+    std::vector<u8> ReadInput(std::size_t size);
+
+    /// Returns the size of the input of the current movie in bytes
+    u64 GetInputSize() const;
 
     PlayMode play_mode;
 
@@ -165,7 +185,15 @@ private:
 
     u64 init_time; // Clock init time override for RNG consistency
 
-    std::vector<u8> recorded_input;
+    // The file of the current movie, which the input is streamed to and from
+    FileUtil::IOFile movie_file_handle;
+    // When recording: Input not written to the file yet, starting at buffer_offset
+    // When playing: Input read ahead from the file, starting at buffer_offset
+    std::vector<u8> input_buffer;
+    u64 buffer_offset = 0;
+    // Size and input count of the input in the file
+    u64 file_input_size = 0;
+    u64 file_input_count = 0;
     std::size_t current_byte = 0;
     u64 current_input = 0;
     // Total input count of the current movie being played. Not used for recording.
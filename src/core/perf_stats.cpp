@@ -53,19 +53,32 @@ void PerfStats::BeginSystemFrame() {
 }
 
 void PerfStats::EndSystemFrame() {
-    std::lock_guard lock{object_mutex};
-
-    auto frame_end = Clock::now();
-    const auto frame_time = frame_end - frame_begin;
-    if (current_index < perf_history.size()) {
-        perf_history[current_index++] =
-            std::chrono::duration<double, std::milli>(frame_time).count();
+    FrameCallback callback;
+    FrameSample sample;
+    {
+        std::lock_guard lock{object_mutex};
+
+        auto frame_end = Clock::now();
+        const auto frame_time = frame_end - frame_begin;
+        if (current_index < perf_history.size()) {
+            perf_history[current_index++] =
+                std::chrono::duration<double, std::milli>(frame_time).count();
+        }
+        accumulated_frametime += frame_time;
+        system_frames += 1;
+
+        previous_frame_length = frame_end - previous_frame_end;
+        previous_frame_end = frame_end;
+
+        sample = {++total_system_frames, frame_time, previous_frame_length,
+                  game_frames - previous_game_frames};
+        previous_game_frames = game_frames;
+        callback = frame_callback;
+    }
+    // Invoked outside of the lock, so that the callback can query the stats
+    if (callback) {
+        callback(sample);
     }
-    accumulated_frametime += frame_time;
-    system_frames += 1;
-
-    previous_frame_length = frame_end - previous_frame_end;
-    previous_frame_end = frame_end;
 }
 
 void PerfStats::EndGameFrame() {
@@ -108,6 +121,7 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    previous_game_frames = 0;
 
     return results;
 }
@@ -119,6 +133,12 @@ double PerfStats::GetLastFrameTimeScale() const {
     return duration_cast<DoubleSecs>(previous_frame_length).count() / FRAME_LENGTH;
 }
 
+void PerfStats::SetFrameCallback(FrameCallback callback) {
+    std::lock_guard lock{object_mutex};
+
+    frame_callback = std::move(callback);
+}
+
 void FrameLimiter::WaitOnce() {
     if (frame_advancing_enabled) {
         // Frame advancing is enabled: wait on event instead of doing framelimiting
@@ -138,7 +158,7 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     auto now = Clock::now();
     double sleep_scale = Settings::values.frame_limit.GetValue() / 100.0;
 
-    if (Settings::values.frame_limit.GetValue() == 0) {
+    if (Settings::values.frame_limit.GetValue() == 0 || Settings::values.use_virtual_time) {
         return;
     }
 
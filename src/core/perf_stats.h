@@ -8,6 +8,7 @@
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <functional>
 #include <mutex>
 #include "common/common_types.h"
 #include "common/thread.h"
@@ -36,6 +37,20 @@ public:
         double emulation_speed;
     };
 
+    /// Timings of a single system frame
+    struct FrameSample {
+        /// Number of system frames since the stats were created
+        u32 frame;
+        /// Walltime of the frame, excluding any waits
+        Clock::duration frametime;
+        /// Walltime since the end of the previous frame, including any waits
+        Clock::duration frame_length;
+        /// Game frames (GSP frame submissions) during the frame
+        u32 game_frames;
+    };
+
+    using FrameCallback = std::function<void(const FrameSample&)>;
+
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
@@ -53,6 +68,12 @@ public:
      */
     double GetLastFrameTimeScale() const;
 
+    /**
+     * Sets a callback that is invoked with the sample of every system frame as it ends, on the
+     * thread that ended it.
+     */
+    void SetFrameCallback(FrameCallback callback);
+
 private:
     mutable std::mutex object_mutex;
 
@@ -82,6 +103,12 @@ private:
     Clock::time_point frame_begin = reset_point;
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length = Clock::duration::zero();
+
+    /// Number of system frames since the stats were created
+    u32 total_system_frames = 0;
+    /// Value of game_frames when the previous system frame ended
+    u32 previous_game_frames = 0;
+    FrameCallback frame_callback;
 };
 
 class FrameLimiter {
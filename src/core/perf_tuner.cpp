@@ -0,0 +1,320 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <sstream>
+#include <string_view>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/trace.h"
+#include "core/hw/gpu.h"
+#include "core/perf_tuner.h"
+
+namespace Core {
+
+namespace {
+
+/// Frames skipped after changing the settings, while the shaders and surfaces are rebuilt
+constexpr u32 WarmupFrames = 300;
+constexpr u32 MeasureFrames = 600;
+
+/// A change has to save this much of the frame time to be kept
+constexpr double MinSpeedup = 0.03;
+/// The game may drop this much of its frame rate before a change counts as slowing it down
+constexpr double MaxGameSlowdown = 0.05;
+
+constexpr std::array<s32, 2> CpuClockCandidates{75, 50};
+
+constexpr Common::Trace::Category MeasureCategory{"PerfTuner", "Measure"};
+
+template <typename Type, bool ranged>
+void SetGameValue(Settings::SwitchableSetting<Type, ranged>& setting, const Type& value,
+                  bool keep_game_settings) {
+    if (keep_game_settings && !setting.UsingGlobal()) {
+        return;
+    }
+    setting.SetGlobal(false);
+    setting.SetValue(value);
+}
+
+std::string_view Trim(std::string_view text) {
+    const auto begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+} // Anonymous namespace
+
+PerfProfile PerfProfile::FromSettings() {
+    const auto& values = Settings::values;
+    return {
+        .use_hw_shader = values.use_hw_shader.GetValue(),
+        .separable_shader = values.separable_shader.GetValue(),
+        .shaders_accurate_mul = values.shaders_accurate_mul.GetValue(),
+        .cpu_clock_percentage = values.cpu_clock_percentage.GetValue(),
+        .resolution_factor = values.resolution_factor.GetValue(),
+        .audio_emulation = values.audio_emulation.GetValue(),
+    };
+}
+
+void PerfProfile::Apply(bool keep_game_settings) const {
+    auto& values = Settings::values;
+    SetGameValue(values.use_hw_shader, use_hw_shader, keep_game_settings);
+    SetGameValue(values.separable_shader, separable_shader, keep_game_settings);
+    SetGameValue(values.shaders_accurate_mul, shaders_accurate_mul, keep_game_settings);
+    SetGameValue(values.cpu_clock_percentage, cpu_clock_percentage, keep_game_settings);
+    SetGameValue(values.resolution_factor, resolution_factor, keep_game_settings);
+    SetGameValue(values.audio_emulation, audio_emulation, keep_game_settings);
+}
+
+std::string PerfProfile::ToString() const {
+    return fmt::format("hardware shaders {}, separable shaders {}, accurate multiplication {}, "
+                       "CPU clock {}%, resolution {}x, audio emulation {}",
+                       use_hw_shader, separable_shader, shaders_accurate_mul,
+                       cpu_clock_percentage, resolution_factor,
+                       static_cast<u32>(audio_emulation));
+}
+
+std::string GetPerfProfilePath(u64 title_id) {
+    return fmt::format("{}perf_profiles/{:016X}.ini",
+                       FileUtil::GetUserPath(FileUtil::UserPath::ConfigDir), title_id);
+}
+
+std::optional<PerfProfile> LoadPerfProfile(u64 title_id) {
+    std::string contents;
+    if (FileUtil::ReadFileToString(true, GetPerfProfilePath(title_id), contents) == 0) {
+        return std::nullopt;
+    }
+
+    // Settings the file doesn't list keep their current values
+    PerfProfile profile = PerfProfile::FromSettings();
+    const auto& values = Settings::values;
+    std::istringstream lines{contents};
+    std::string line;
+    while (std::getline(lines, line)) {
+        const std::string_view text = Trim(line);
+        if (text.empty() || text.front() == '#') {
+            continue;
+        }
+        const auto separator = text.find('=');
+        if (separator == std::string_view::npos) {
+            LOG_ERROR(Core, "Invalid line in the performance profile of {:016X}: {}", title_id,
+                      text);
+            return std::nullopt;
+        }
+        const std::string_view key = Trim(text.substr(0, separator));
+        const std::string_view value_text = Trim(text.substr(separator + 1));
+        s32 value{};
+        const auto [end, error] =
+            std::from_chars(value_text.data(), value_text.data() + value_text.size(), value);
+        if (error != std::errc{} || end != value_text.data() + value_text.size()) {
+            LOG_ERROR(Core, "Invalid value in the performance profile of {:016X}: {}", title_id,
+                      text);
+            return std::nullopt;
+        }
+
+        if (key == values.use_hw_shader.GetLabel()) {
+            profile.use_hw_shader = value != 0;
+        } else if (key == values.separable_shader.GetLabel()) {
+            profile.separable_shader = value != 0;
+        } else if (key == values.shaders_accurate_mul.GetLabel()) {
+            profile.shaders_accurate_mul = value != 0;
+        } else if (key == values.cpu_clock_percentage.GetLabel()) {
+            profile.cpu_clock_percentage = value;
+        } else if (key == values.resolution_factor.GetLabel()) {
+            profile.resolution_factor = static_cast<u16>(value);
+        } else if (key == values.audio_emulation.GetLabel() && value >= 0 &&
+                   value <= static_cast<s32>(Settings::AudioEmulation::HLEMultithreaded)) {
+            profile.audio_emulation = static_cast<Settings::AudioEmulation>(value);
+        } else {
+            LOG_WARNING(Core, "Ignoring unknown line in the performance profile of {:016X}: {}",
+                        title_id, text);
+        }
+    }
+    return profile;
+}
+
+bool SavePerfProfile(u64 title_id, const PerfProfile& profile) {
+    const auto& values = Settings::values;
+    const std::string contents = fmt::format(
+        "# Performance profile of {:016X}, measured with {} {}\n"
+        "{} = {}\n{} = {}\n{} = {}\n{} = {}\n{} = {}\n{} = {}\n",
+        title_id, Common::g_scm_branch, Common::g_scm_desc, values.use_hw_shader.GetLabel(),
+        static_cast<int>(profile.use_hw_shader), values.separable_shader.GetLabel(),
+        static_cast<int>(profile.separable_shader), values.shaders_accurate_mul.GetLabel(),
+        static_cast<int>(profile.shaders_accurate_mul), values.cpu_clock_percentage.GetLabel(),
+        profile.cpu_clock_percentage, values.resolution_factor.GetLabel(),
+        profile.resolution_factor, values.audio_emulation.GetLabel(),
+        static_cast<u32>(profile.audio_emulation));
+
+    const std::string path = GetPerfProfilePath(title_id);
+    if (!FileUtil::CreateFullPath(path) ||
+        FileUtil::WriteStringToFile(true, path, contents) != contents.size()) {
+        LOG_ERROR(Core, "Failed to write the performance profile {}", path);
+        return false;
+    }
+    return true;
+}
+
+PerfTuner::PerfTuner(u64 title_id_)
+    : title_id{title_id_}, best{PerfProfile::FromSettings()}, candidate{best},
+      frame_limit_global{Settings::values.frame_limit.UsingGlobal()},
+      frame_limit{Settings::values.frame_limit.GetValue()} {
+    using Kind = Change::Kind;
+    changes.push_back({Kind::HwShader, !best.use_hw_shader, false});
+    changes.push_back({Kind::SeparableShader, !best.separable_shader, false});
+    changes.push_back({Kind::AccurateMul, !best.shaders_accurate_mul, best.shaders_accurate_mul});
+    for (const s32 clock : CpuClockCandidates) {
+        if (clock < best.cpu_clock_percentage) {
+            changes.push_back({Kind::CpuClock, clock, true});
+        }
+    }
+    // 0 scales with the window, which is left to the user
+    for (s32 factor = best.resolution_factor - 1; factor >= 1; --factor) {
+        changes.push_back({Kind::Resolution, factor, true});
+    }
+
+    LOG_INFO(Core, "Tuning the performance of {:016X}, starting from {}", title_id,
+             best.ToString());
+    // The current settings are measured first, without the frame limit
+    pending = best;
+    has_pending = true;
+}
+
+PerfTuner::~PerfTuner() {
+    if (!saved) {
+        Settings::values.frame_limit.SetGlobal(frame_limit_global);
+        Settings::values.frame_limit.SetValue(frame_limit);
+    }
+}
+
+void PerfTuner::OnFrame(const PerfStats::FrameSample& sample) {
+    // Frames before the settings changed don't count
+    if (finished || has_pending) {
+        return;
+    }
+    if (frames < WarmupFrames) {
+        if (++frames == WarmupFrames) {
+            window_begin = Common::Trace::Now();
+        }
+        return;
+    }
+    frametime_sum += std::chrono::duration<double>(sample.frametime).count();
+    game_frames += sample.game_frames;
+    if (++frames < WarmupFrames + MeasureFrames) {
+        return;
+    }
+
+    Common::Trace::CurrentThreadTrack().Record(MeasureCategory, window_begin,
+                                               Common::Trace::Now());
+    const Measurement measurement{frametime_sum / MeasureFrames,
+                                  static_cast<double>(game_frames) / MeasureFrames};
+    LOG_INFO(Core, "{:.2f} ms per frame and {:.2f} game frames per frame with {}",
+             measurement.frametime * 1000.0, measurement.game_frame_rate, candidate.ToString());
+
+    if (!baseline) {
+        baseline = measurement;
+        best_measurement = measurement;
+    } else {
+        const bool keeps_game_speed =
+            measurement.game_frame_rate >= baseline->game_frame_rate * (1.0 - MaxGameSlowdown);
+        const bool faster =
+            measurement.frametime < best_measurement->frametime * (1.0 - MinSpeedup);
+        if (keeps_game_speed && faster) {
+            best = candidate;
+            best_measurement = measurement;
+        }
+    }
+    StartNextChange();
+}
+
+void PerfTuner::StartNextChange() {
+    frames = 0;
+    frametime_sum = 0.0;
+    game_frames = 0;
+
+    const double full_speed_frametime = 1.0 / GPU::SCREEN_REFRESH_RATE;
+    while (next_change < changes.size()) {
+        const Change& change = changes[next_change++];
+        if (change.lowers_quality && best_measurement->frametime <= full_speed_frametime) {
+            continue;
+        }
+        PerfProfile next = best;
+        switch (change.kind) {
+        case Change::Kind::HwShader:
+            next.use_hw_shader = change.value != 0;
+            break;
+        case Change::Kind::SeparableShader:
+            next.separable_shader = change.value != 0;
+            break;
+        case Change::Kind::AccurateMul:
+            next.shaders_accurate_mul = change.value != 0;
+            break;
+        case Change::Kind::CpuClock:
+            next.cpu_clock_percentage = change.value;
+            break;
+        case Change::Kind::Resolution:
+            next.resolution_factor = static_cast<u16>(change.value);
+            break;
+        }
+        // The shader settings only matter to hardware shaders
+        const bool shader_change = change.kind == Change::Kind::SeparableShader ||
+                                   change.kind == Change::Kind::AccurateMul;
+        if (next == best || (shader_change && !best.use_hw_shader)) {
+            continue;
+        }
+        candidate = next;
+        std::scoped_lock lock{mutex};
+        pending = candidate;
+        has_pending = true;
+        return;
+    }
+
+    finished = true;
+    std::scoped_lock lock{mutex};
+    pending = best;
+    has_pending = true;
+}
+
+bool PerfTuner::Update() {
+    if (saved) {
+        return true;
+    }
+    if (!has_pending) {
+        return false;
+    }
+
+    std::optional<PerfProfile> profile;
+    {
+        std::scoped_lock lock{mutex};
+        profile = std::exchange(pending, std::nullopt);
+    }
+    if (profile) {
+        profile->Apply(false);
+    }
+    if (finished) {
+        Settings::values.frame_limit.SetGlobal(frame_limit_global);
+        Settings::values.frame_limit.SetValue(frame_limit);
+        Settings::Apply();
+        LOG_INFO(Core, "Finished tuning the performance of {:016X}: {}", title_id,
+                 best.ToString());
+        SavePerfProfile(title_id, best);
+        saved = true;
+        return true;
+    }
+    Settings::values.frame_limit.SetGlobal(false);
+    Settings::values.frame_limit.SetValue(0);
+    Settings::Apply();
+    // Cleared last, so that the frames only count once the settings changed
+    has_pending = false;
+    return false;
+}
+
+} // namespace Core
@@ -0,0 +1,120 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "common/settings.h"
+#include "core/perf_stats.h"
+
+namespace Core {
+
+/// The settings affecting the performance of a title the most
+struct PerfProfile {
+    bool use_hw_shader;
+    bool separable_shader;
+    bool shaders_accurate_mul;
+    s32 cpu_clock_percentage;
+    u16 resolution_factor;
+    Settings::AudioEmulation audio_emulation;
+
+    bool operator==(const PerfProfile&) const = default;
+
+    /// Returns the profile of the current settings
+    static PerfProfile FromSettings();
+
+    /**
+     * Sets the settings to the profile, as settings of the running title.
+     * @param keep_game_settings whether settings configured for the title keep their values
+     */
+    void Apply(bool keep_game_settings) const;
+
+    std::string ToString() const;
+};
+
+/// Returns the path of the performance profile of a title
+std::string GetPerfProfilePath(u64 title_id);
+
+/// Reads the performance profile of a title, empty if there is none or it's invalid
+std::optional<PerfProfile> LoadPerfProfile(u64 title_id);
+
+bool SavePerfProfile(u64 title_id, const PerfProfile& profile);
+
+/**
+ * Finds the fastest settings for a running title. Starting from the current settings, it changes
+ * one setting at a time and keeps the change if the frames got faster and the game didn't slow
+ * down, e.g. from underclocking. Changes lowering the accuracy or the resolution are only tried
+ * while the title doesn't run at full speed. The frame limit is lifted meanwhile.
+ *
+ * The measurements show on the trace of the thread presenting the frames.
+ */
+class PerfTuner {
+public:
+    explicit PerfTuner(u64 title_id);
+    ~PerfTuner();
+
+    PerfTuner(const PerfTuner&) = delete;
+    PerfTuner& operator=(const PerfTuner&) = delete;
+
+    /// Measures a system frame, may be called from any single thread
+    void OnFrame(const PerfStats::FrameSample& sample);
+
+    /**
+     * Changes the settings once a measurement finished, on the emulation thread.
+     * @return true once the tuning finished and the profile was saved
+     */
+    bool Update();
+
+private:
+    struct Change {
+        enum class Kind { HwShader, SeparableShader, AccurateMul, CpuClock, Resolution };
+        Kind kind;
+        s32 value;
+        /// Whether the change lowers the accuracy or quality, instead of only the speed
+        bool lowers_quality;
+    };
+
+    struct Measurement {
+        /// Mean walltime per system frame, excluding waits, in seconds
+        double frametime;
+        /// Game frames per system frame
+        double game_frame_rate;
+    };
+
+    /// Starts measuring the next change that applies to the best profile so far
+    void StartNextChange();
+
+    u64 title_id;
+    std::vector<Change> changes;
+    std::size_t next_change = 0;
+
+    PerfProfile best;
+    std::optional<Measurement> best_measurement;
+    std::optional<Measurement> baseline;
+    PerfProfile candidate;
+
+    /// Frames measured of the current candidate, they count after the warmup frames
+    u32 frames = 0;
+    double frametime_sum = 0.0;
+    u32 game_frames = 0;
+    u64 window_begin = 0;
+
+    /// The frame limit of the settings before the tuning
+    bool frame_limit_global;
+    u16 frame_limit;
+
+    std::mutex mutex;
+    /// The profile to apply on the emulation thread
+    std::optional<PerfProfile> pending;
+    std::atomic<bool> has_pending{false};
+    std::atomic<bool> finished{false};
+    bool saved = false;
+};
+
+} // namespace Core
@@ -0,0 +1,180 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include "common/archives.h"
+#include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "common/thread_pool.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "core/rewind.h"
+
+namespace Core {
+
+namespace {
+
+/// Deltas are compressed quickly, as one is made for every snapshot
+constexpr s32 DeltaCompressionLevel = 1;
+
+/// Appends the bytes to the data
+void Append(std::vector<u8>& data, const void* source, std::size_t size) {
+    const auto* bytes = static_cast<const u8*>(source);
+    data.insert(data.end(), bytes, bytes + size);
+}
+
+std::string SerializeState(System& system) {
+    Memory::MemorySystem::SetSerializeStateMemory(false);
+    SCOPE_EXIT({ Memory::MemorySystem::SetSerializeStateMemory(true); });
+
+    std::ostringstream stream;
+    {
+        oarchive oa{stream};
+        oa& system;
+    }
+    if (!stream) {
+        throw std::runtime_error("Could not serialize the state");
+    }
+    return std::move(stream).str();
+}
+
+void DeserializeState(System& system, const std::string& state) {
+    Memory::MemorySystem::SetSerializeStateMemory(false);
+    SCOPE_EXIT({ Memory::MemorySystem::SetSerializeStateMemory(true); });
+
+    std::istringstream stream{state};
+    iarchive ia{stream};
+    ia& system;
+}
+
+} // Anonymous namespace
+
+const std::vector<u8>& RewindBuffer::Delta::Get() {
+    if (pending.valid()) {
+        compressed = pending.get();
+    }
+    return compressed;
+}
+
+RewindBuffer::RewindBuffer(std::size_t memory_budget_)
+    : memory_budget{memory_budget_},
+      // The host only backs the pages that are written
+      memory{static_cast<u8*>(std::calloc(Memory::MemorySystem::StateMemorySize, 1))} {
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+}
+
+RewindBuffer::~RewindBuffer() = default;
+
+void RewindBuffer::TakeSnapshot(System& system) {
+    // Serializing the state flushes the rasterizer caches, so the memory has to be compared after
+    std::string new_state = SerializeState(system);
+    const std::span<u8> copy{memory.get(), Memory::MemorySystem::StateMemorySize};
+    if (!has_snapshot) {
+        system.Memory().UpdateStateMemoryCopy(copy, [](std::size_t, std::span<const u8>) {});
+        state = std::move(new_state);
+        has_snapshot = true;
+        return;
+    }
+
+    // The delta holds the size of the old state, the old state, then the u64 offset and the old
+    // contents of every page that changed
+    std::vector<u8> raw;
+    const u64 state_size = state.size();
+    Append(raw, &state_size, sizeof(state_size));
+    Append(raw, state.data(), state.size());
+    system.Memory().UpdateStateMemoryCopy(
+        copy, [&raw](std::size_t offset, std::span<const u8> old_page) {
+            const u64 page_offset = offset;
+            Append(raw, &page_offset, sizeof(page_offset));
+            Append(raw, old_page.data(), old_page.size());
+        });
+    state = std::move(new_state);
+
+    auto& delta = deltas.emplace_back();
+    delta.raw_size = raw.size();
+    delta.pending = Common::ThreadPool::Shared().Submit([raw = std::move(raw)] {
+        return Common::Compression::CompressDataZSTD(raw.data(), raw.size(),
+                                                     DeltaCompressionLevel);
+    });
+    EnforceBudget();
+}
+
+bool RewindBuffer::Rewind(System& system) {
+    if (!has_snapshot) {
+        return false;
+    }
+
+    DeserializeState(system, state);
+    system.Memory().RestoreStateMemory({memory.get(), Memory::MemorySystem::StateMemorySize});
+
+    if (deltas.empty()) {
+        has_snapshot = false;
+        state.clear();
+        return true;
+    }
+
+    // Turn the copy into the previous snapshot
+    const std::vector<u8> raw = Common::Compression::DecompressDataZSTD(deltas.back().Get());
+    deltas.pop_back();
+    u64 state_size;
+    if (raw.size() < sizeof(state_size)) {
+        throw std::runtime_error("Invalid rewind snapshot");
+    }
+    std::memcpy(&state_size, raw.data(), sizeof(state_size));
+    std::size_t position = sizeof(state_size);
+    if (raw.size() - position < state_size) {
+        throw std::runtime_error("Invalid rewind snapshot");
+    }
+    state.assign(reinterpret_cast<const char*>(raw.data() + position), state_size);
+    position += state_size;
+
+    u8* const copy = memory.get();
+    while (position != raw.size()) {
+        u64 offset;
+        if (raw.size() - position < sizeof(offset) + Memory::CITRA_PAGE_SIZE) {
+            throw std::runtime_error("Invalid rewind snapshot");
+        }
+        std::memcpy(&offset, raw.data() + position, sizeof(offset));
+        position += sizeof(offset);
+        if (offset > Memory::MemorySystem::StateMemorySize - Memory::CITRA_PAGE_SIZE) {
+            throw std::runtime_error("Invalid rewind snapshot");
+        }
+        std::memcpy(copy + offset, raw.data() + position, Memory::CITRA_PAGE_SIZE);
+        position += Memory::CITRA_PAGE_SIZE;
+    }
+    return true;
+}
+
+std::size_t RewindBuffer::GetSnapshotCount() const {
+    return has_snapshot ? deltas.size() + 1 : 0;
+}
+
+std::size_t RewindBuffer::GetMemoryUsage() const {
+    std::size_t usage = 0;
+    for (const auto& delta : deltas) {
+        usage += delta.pending.valid() ? delta.raw_size : delta.compressed.size();
+    }
+    return usage;
+}
+
+void RewindBuffer::EnforceBudget() {
+    for (auto& delta : deltas) {
+        if (delta.pending.valid() &&
+            delta.pending.wait_for(std::chrono::seconds::zero()) == std::future_status::ready) {
+            delta.Get();
+        }
+    }
+    while (!deltas.empty() && GetMemoryUsage() > memory_budget) {
+        deltas.pop_front();
+    }
+    LOG_TRACE(Core, "{} rewind snapshots using {} bytes", GetSnapshotCount(), GetMemoryUsage());
+}
+
+} // namespace Core
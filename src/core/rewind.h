@@ -0,0 +1,79 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core {
+
+class System;
+
+/**
+ * Keeps recent snapshots of the emulated state in memory to step back to. Only the newest
+ * snapshot is kept whole, every older one is kept as the pages and the state that differ from its
+ * successor, compressed on a worker thread. The oldest snapshots are dropped to stay within the
+ * memory budget.
+ */
+class RewindBuffer {
+public:
+    /// @param memory_budget the memory the older snapshots may use, in bytes
+    explicit RewindBuffer(std::size_t memory_budget);
+    ~RewindBuffer();
+
+    /// Adds a snapshot of the current state of the system
+    void TakeSnapshot(System& system);
+
+    /**
+     * Restores the newest snapshot and drops it, so that the next call steps back further.
+     * @return false if there is no snapshot to restore
+     */
+    bool Rewind(System& system);
+
+    /// Returns the number of snapshots that can be restored
+    [[nodiscard]] std::size_t GetSnapshotCount() const;
+
+    /// Returns the memory used by the older snapshots, in bytes
+    [[nodiscard]] std::size_t GetMemoryUsage() const;
+
+private:
+    /// Turns a snapshot into its predecessor
+    struct Delta {
+        /// Size before compression
+        std::size_t raw_size;
+        std::future<std::vector<u8>> pending;
+        std::vector<u8> compressed;
+
+        /// Returns the compressed delta, waiting for the worker if needed
+        const std::vector<u8>& Get();
+    };
+
+    struct FreeDeleter {
+        void operator()(u8* pointer) const {
+            std::free(pointer);
+        }
+    };
+
+    /// Evicts the oldest deltas until the others fit into the budget
+    void EnforceBudget();
+
+    std::size_t memory_budget;
+
+    /// Serialized state of the newest snapshot, without the memory
+    std::string state;
+    /// Memory of the newest snapshot, pages that were never written are left to the host
+    std::unique_ptr<u8, FreeDeleter> memory;
+    bool has_snapshot = false;
+
+    /// Ordered from the oldest to the newest
+    std::deque<Delta> deltas;
+};
+
+} // namespace Core
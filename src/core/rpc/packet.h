@@ -14,6 +14,14 @@ enum class PacketType {
     Undefined = 0,
     ReadMemory,
     WriteMemory,
+    SubscribeFrameStats,
+    FrameStats,
+    ReadMemoryRanges,
+    SubscribeMemoryRanges,
+    MemoryRanges,
+    FrameAdvance,
+    SaveTrace,
+    ReadMemoryUsage,
 };
 
 struct PacketHeader {
@@ -25,9 +33,70 @@ struct PacketHeader {
 
 constexpr u32 CURRENT_VERSION = 1;
 constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
-constexpr u32 MAX_PACKET_DATA_SIZE = 32;
+constexpr u32 MAX_PACKET_DATA_SIZE = 1024;
 constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
-constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
+/// Maximum size of a ReadMemory request, kept from when packets were limited to it
+constexpr u32 MAX_READ_SIZE = 32;
+
+/**
+ * Pushed for every emulated frame to the clients subscribed with SubscribeFrameStats, using the id
+ * of the subscription request. The request holds the number of frames to send as a u32, zero
+ * cancels the subscription.
+ */
+struct FrameStatsData {
+    /// Number of system frames since the game was loaded
+    u32 frame;
+    /// Walltime spent on the frame in microseconds, excluding v-sync and frame limiting
+    u32 frametime_us;
+    /// Walltime since the end of the previous frame in microseconds
+    u32 frame_length_us;
+    /// Game frames (GSP frame submissions) during the frame
+    u32 game_frames;
+};
+static_assert(sizeof(FrameStatsData) <= MAX_PACKET_DATA_SIZE);
+
+/**
+ * A ReadMemoryRanges request is a list of ranges, and is replied with the contents of all of them
+ * one after the other. A SubscribeMemoryRanges request is a u32 number of frames followed by the
+ * list of ranges, and has their contents pushed at the end of every emulated frame as MemoryRanges
+ * packets, using the id of the subscription request. Zero frames cancels the subscription. The
+ * total size of the ranges is limited to MAX_PACKET_DATA_SIZE.
+ */
+struct MemoryRange {
+    u32 address;
+    u32 size;
+};
+constexpr u32 MAX_MEMORY_RANGES = MAX_PACKET_DATA_SIZE / sizeof(MemoryRange);
+
+/**
+ * A FrameAdvance request is a u32 number of frames to emulate, without frame limiting, after which
+ * the emulation is paused at the end of the last frame and the request is replied with the u32
+ * number of that frame. The requests received in the meantime are handled once the frames have
+ * run, so that they see the state at the end of the last one. The first request made while the
+ * emulation runs counts the frame being emulated, zero frames resumes the emulation.
+ */
+constexpr u32 FRAME_ADVANCE_REPLY_SIZE = sizeof(u32);
+
+/**
+ * A SaveTrace request has no data. The recent events of the trace recorder are written to a file
+ * in the log directory, and the request is replied with its path, empty if it couldn't be written.
+ */
+
+/**
+ * A ReadMemoryUsage request holds the u32 index of the first counter to read, zero if empty, and
+ * is replied with as many counters from there as fit. Clients read the next counters while the
+ * reply is full. The counters are sorted by name.
+ */
+struct MemoryUsageEntry {
+    /// "group/name" of the counter, truncated and padded with zeros
+    std::array<char, 40> name;
+    u64 bytes;
+    u64 peak_bytes;
+    u32 count;
+    u32 peak_count;
+};
+static_assert(sizeof(MemoryUsageEntry) == 64);
+constexpr u32 MAX_MEMORY_USAGE_ENTRIES = MAX_PACKET_DATA_SIZE / sizeof(MemoryUsageEntry);
 
 class Packet {
 public:
@@ -45,6 +114,10 @@ public:
         return header.packet_type;
     }
 
+    void SetPacketType(PacketType type) {
+        header.packet_type = type;
+    }
+
     u32 GetPacketDataSize() const {
         return header.packet_size;
     }
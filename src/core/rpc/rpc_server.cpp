@@ -1,4 +1,12 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <fmt/format.h>
 #include "common/logging/log.h"
+#include "common/memory_usage.h"
+#include "common/trace.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
@@ -54,6 +62,177 @@ void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u
     packet.SendReply();
 }
 
+void RPCServer::HandleReadMemoryRanges(Packet& packet, const std::vector<MemoryRange>& ranges) {
+    // Note: Memory read occurs asynchronously from the state of the emulator
+    auto& system = Core::System::GetInstance();
+    u32 offset = 0;
+    for (const MemoryRange& range : ranges) {
+        system.Memory().ReadBlock(*system.Kernel().GetCurrentProcess(), range.address,
+                                  packet.GetPacketData().data() + offset, range.size);
+        offset += range.size;
+    }
+    packet.SetPacketDataSize(offset);
+    packet.SendReply();
+}
+
+void RPCServer::Subscribe(std::vector<Subscription>& subscriptions, Subscription subscription,
+                          PacketType update_type) {
+    subscription.packet->SetPacketDataSize(0);
+    subscription.packet->SendReply();
+
+    std::lock_guard lock{subscriptions_mutex};
+    // A client renews or cancels a subscription by sending the request with the same id again
+    const u32 id = subscription.packet->GetId();
+    std::erase_if(subscriptions, [id](const Subscription& other) {
+        return other.packet->GetId() == id;
+    });
+    if (subscription.remaining_frames > 0) {
+        subscription.packet->SetPacketType(update_type);
+        subscriptions.push_back(std::move(subscription));
+    }
+}
+
+void RPCServer::HandleSubscribeFrameStats(std::unique_ptr<Packet> packet, u32 frames) {
+    Subscribe(frame_stats_subscriptions, {std::move(packet), frames, {}}, PacketType::FrameStats);
+}
+
+void RPCServer::HandleSubscribeMemoryRanges(std::unique_ptr<Packet> packet, u32 frames,
+                                            std::vector<MemoryRange> ranges) {
+    Subscribe(memory_subscriptions, {std::move(packet), frames, std::move(ranges)},
+              PacketType::MemoryRanges);
+}
+
+void RPCServer::PublishFrameStats(const Core::PerfStats::FrameSample& sample) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::lock_guard lock{subscriptions_mutex};
+    if (frame_stats_subscriptions.empty()) {
+        return;
+    }
+
+    const FrameStatsData data{
+        .frame = sample.frame,
+        .frametime_us = static_cast<u32>(duration_cast<microseconds>(sample.frametime).count()),
+        .frame_length_us =
+            static_cast<u32>(duration_cast<microseconds>(sample.frame_length).count()),
+        .game_frames = sample.game_frames,
+    };
+    for (auto& subscription : frame_stats_subscriptions) {
+        Packet& packet = *subscription.packet;
+        std::memcpy(packet.GetPacketData().data(), &data, sizeof(data));
+        packet.SetPacketDataSize(sizeof(data));
+        packet.SendReply();
+        subscription.remaining_frames--;
+    }
+    std::erase_if(frame_stats_subscriptions, [](const Subscription& subscription) {
+        return subscription.remaining_frames == 0;
+    });
+}
+
+void RPCServer::PublishMemoryRanges() {
+    std::lock_guard lock{subscriptions_mutex};
+    for (auto& subscription : memory_subscriptions) {
+        HandleReadMemoryRanges(*subscription.packet, subscription.ranges);
+        subscription.remaining_frames--;
+    }
+    std::erase_if(memory_subscriptions, [](const Subscription& subscription) {
+        return subscription.remaining_frames == 0;
+    });
+}
+
+void RPCServer::HandleFrameAdvance(std::unique_ptr<Packet> packet, u32 frames) {
+    auto& frame_limiter = Core::System::GetInstance().frame_limiter;
+    if (frames == 0) {
+        if (frame_advancing) {
+            frame_advancing = false;
+            frame_limiter.SetFrameAdvancing(false);
+        }
+        packet->SetPacketDataSize(0);
+        packet->SendReply();
+        return;
+    }
+
+    frame_advance = std::move(packet);
+    remaining_frames_to_advance = frames;
+    frame_advancing = true;
+    frame_limiter.SetFrameAdvancing(true);
+    frame_limiter.AdvanceFrame();
+}
+
+void RPCServer::HandleSaveTrace(Packet& packet) {
+    const std::string path = Common::Trace::SaveTrace();
+    const u32 size = static_cast<u32>(std::min<std::size_t>(path.size(), MAX_PACKET_DATA_SIZE));
+    std::memcpy(packet.GetPacketData().data(), path.data(), size);
+    packet.SetPacketDataSize(size);
+    packet.SendReply();
+}
+
+void RPCServer::HandleReadMemoryUsage(Packet& packet, u32 first_index) {
+    const auto usages = Common::MemoryUsage::GetUsages();
+    u32 num_entries = 0;
+    for (std::size_t i = first_index;
+         i < usages.size() && num_entries < MAX_MEMORY_USAGE_ENTRIES; ++i, ++num_entries) {
+        const auto& usage = usages[i];
+        MemoryUsageEntry entry{};
+        const std::string name = fmt::format("{}/{}", usage.group, usage.name);
+        std::memcpy(entry.name.data(), name.data(), std::min(name.size(), entry.name.size()));
+        entry.bytes = usage.bytes;
+        entry.peak_bytes = usage.peak_bytes;
+        entry.count = static_cast<u32>(usage.count);
+        entry.peak_count = static_cast<u32>(usage.peak_count);
+        std::memcpy(packet.GetPacketData().data() + num_entries * sizeof(entry), &entry,
+                    sizeof(entry));
+    }
+    packet.SetPacketDataSize(num_entries * static_cast<u32>(sizeof(MemoryUsageEntry)));
+    packet.SendReply();
+}
+
+void RPCServer::EndSystemFrame(const Core::PerfStats::FrameSample& sample) {
+    std::lock_guard lock{frame_advance_mutex};
+    if (!frame_advance) {
+        return;
+    }
+    auto& frame_limiter = Core::System::GetInstance().frame_limiter;
+    if (--remaining_frames_to_advance > 0) {
+        // Let the frame limiter through for the next frame too
+        frame_limiter.AdvanceFrame();
+        return;
+    }
+
+    // The emulation is now paused until the next frame advance request
+    static_assert(sizeof(sample.frame) == FRAME_ADVANCE_REPLY_SIZE);
+    std::memcpy(frame_advance->GetPacketData().data(), &sample.frame, FRAME_ADVANCE_REPLY_SIZE);
+    frame_advance->SetPacketDataSize(FRAME_ADVANCE_REPLY_SIZE);
+    frame_advance->SendReply();
+    frame_advance.reset();
+
+    // Handle the requests that came in the meantime, up to the next frame advance
+    auto request = deferred_requests.begin();
+    while (request != deferred_requests.end() && !frame_advance) {
+        HandleSingleRequest(std::move(*request));
+        ++request;
+    }
+    deferred_requests.erase(deferred_requests.begin(), request);
+}
+
+/// Reads the list of memory ranges of a request, which must fit in a reply
+static std::optional<std::vector<MemoryRange>> ParseMemoryRanges(const u8* data, u32 size) {
+    if (size == 0 || size % sizeof(MemoryRange) != 0) {
+        return std::nullopt;
+    }
+    std::vector<MemoryRange> ranges(size / sizeof(MemoryRange));
+    std::memcpy(ranges.data(), data, size);
+    u32 total_size = 0;
+    for (const MemoryRange& range : ranges) {
+        if (range.size > MAX_PACKET_DATA_SIZE - total_size) {
+            return std::nullopt;
+        }
+        total_size += range.size;
+    }
+    return ranges;
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
@@ -63,6 +242,17 @@ bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
                 return true;
             }
             break;
+        case PacketType::SubscribeFrameStats:
+        case PacketType::SubscribeMemoryRanges:
+        case PacketType::FrameAdvance:
+            if (packet_header.packet_size >= sizeof(u32)) {
+                return true;
+            }
+            break;
+        case PacketType::ReadMemoryRanges:
+        case PacketType::SaveTrace:
+        case PacketType::ReadMemoryUsage:
+            return true;
         default:
             break;
         }
@@ -74,12 +264,16 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
     bool success = false;
 
     if (ValidatePacket(request_packet->GetHeader())) {
-        // Currently, all request types use the address/data_size wire format
+        const u8* packet_data = request_packet->GetPacketData().data();
+        const u32 packet_size = request_packet->GetPacketDataSize();
+
+        // The memory requests use the address/data_size wire format, the subscriptions and frame
+        // advances start with the number of frames
         u32 address = 0;
         u32 data_size = 0;
-        std::memcpy(&address, request_packet->GetPacketData().data(), sizeof(address));
-        std::memcpy(&data_size, request_packet->GetPacketData().data() + sizeof(address),
-                    sizeof(data_size));
+        std::memcpy(&address, packet_data, sizeof(address));
+        std::memcpy(&data_size, packet_data + sizeof(address), sizeof(data_size));
+        const u32 frames = address;
 
         switch (request_packet->GetPacketType()) {
         case PacketType::ReadMemory:
@@ -89,12 +283,46 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
             }
             break;
         case PacketType::WriteMemory:
-            if (data_size > 0 && data_size <= MAX_PACKET_DATA_SIZE - (sizeof(u32) * 2)) {
-                const u8* data = request_packet->GetPacketData().data() + (sizeof(u32) * 2);
+            if (data_size > 0 && data_size <= packet_size - (sizeof(u32) * 2)) {
+                const u8* data = packet_data + (sizeof(u32) * 2);
                 HandleWriteMemory(*request_packet, address, data, data_size);
                 success = true;
             }
             break;
+        case PacketType::SubscribeFrameStats:
+            HandleSubscribeFrameStats(std::move(request_packet), frames);
+            return;
+        case PacketType::ReadMemoryRanges:
+            if (auto ranges = ParseMemoryRanges(packet_data, packet_size)) {
+                HandleReadMemoryRanges(*request_packet, *ranges);
+                success = true;
+            }
+            break;
+        case PacketType::SubscribeMemoryRanges: {
+            auto ranges =
+                ParseMemoryRanges(packet_data + sizeof(frames), packet_size - sizeof(frames));
+            // Cancelling doesn't need the ranges
+            if (frames == 0) {
+                HandleSubscribeMemoryRanges(std::move(request_packet), 0, {});
+                return;
+            }
+            if (ranges) {
+                HandleSubscribeMemoryRanges(std::move(request_packet), frames, std::move(*ranges));
+                return;
+            }
+            break;
+        }
+        case PacketType::FrameAdvance:
+            HandleFrameAdvance(std::move(request_packet), frames);
+            return;
+        case PacketType::SaveTrace:
+            HandleSaveTrace(*request_packet);
+            success = true;
+            break;
+        case PacketType::ReadMemoryUsage:
+            HandleReadMemoryUsage(*request_packet, packet_size >= sizeof(u32) ? address : 0);
+            success = true;
+            break;
         default:
             break;
         }
@@ -113,7 +341,12 @@ void RPCServer::HandleRequestsLoop() {
     LOG_INFO(RPC_Server, "Request handler started.");
 
     while ((request_packet = request_queue.PopWait())) {
-        HandleSingleRequest(std::move(request_packet));
+        std::lock_guard lock{frame_advance_mutex};
+        if (frame_advance) {
+            deferred_requests.push_back(std::move(request_packet));
+        } else {
+            HandleSingleRequest(std::move(request_packet));
+        }
     }
 }
 
@@ -127,9 +360,29 @@ void RPCServer::Start() {
     server.Start();
 }
 
+void RPCServer::ClearPendingReplies() {
+    {
+        std::lock_guard lock{frame_advance_mutex};
+        frame_advance.reset();
+        deferred_requests.clear();
+        if (frame_advancing) {
+            // Don't leave the emulation paused without a client to resume it
+            frame_advancing = false;
+            Core::System::GetInstance().frame_limiter.SetFrameAdvancing(false);
+        }
+    }
+    std::lock_guard lock{subscriptions_mutex};
+    frame_stats_subscriptions.clear();
+    memory_subscriptions.clear();
+}
+
 void RPCServer::Stop() {
+    // The pending replies send through the UDP server, which is about to be destroyed
+    ClearPendingReplies();
     server.Stop();
     request_handler_thread.join();
+    // Drop the ones that the remaining requests made
+    ClearPendingReplies();
 }
 
 }; // namespace RPC
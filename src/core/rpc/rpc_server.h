@@ -8,14 +8,14 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include "common/threadsafe_queue.h"
+#include "core/perf_stats.h"
+#include "core/rpc/packet.h"
 #include "core/rpc/server.h"
 
 namespace RPC {
 
-class Packet;
-struct PacketHeader;
-
 class RPCServer {
 public:
     RPCServer();
@@ -23,11 +23,38 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /// Sends the sample to the clients subscribed to the frame stats
+    void PublishFrameStats(const Core::PerfStats::FrameSample& sample);
+
+    /// Sends the current contents of the subscribed memory ranges to their clients
+    void PublishMemoryRanges();
+
+    /// Finishes the frame advance requests, called at the end of every system frame
+    void EndSystemFrame(const Core::PerfStats::FrameSample& sample);
+
 private:
+    struct Subscription {
+        /// The subscription request, reused for sending the updates to its client
+        std::unique_ptr<Packet> packet;
+        u32 remaining_frames;
+        /// Memory to send, for the memory subscriptions
+        std::vector<MemoryRange> ranges;
+    };
+
     void Start();
     void Stop();
+    void ClearPendingReplies();
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size);
+    void HandleReadMemoryRanges(Packet& packet, const std::vector<MemoryRange>& ranges);
+    void HandleSubscribeFrameStats(std::unique_ptr<Packet> packet, u32 frames);
+    void HandleSubscribeMemoryRanges(std::unique_ptr<Packet> packet, u32 frames,
+                                     std::vector<MemoryRange> ranges);
+    void HandleFrameAdvance(std::unique_ptr<Packet> packet, u32 frames);
+    void HandleSaveTrace(Packet& packet);
+    void HandleReadMemoryUsage(Packet& packet, u32 first_index);
+    void Subscribe(std::vector<Subscription>& subscriptions, Subscription subscription,
+                   PacketType update_type);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop();
@@ -35,6 +62,20 @@ private:
     Server server;
     Common::SPSCQueue<std::unique_ptr<Packet>> request_queue;
     std::thread request_handler_thread;
+
+    std::mutex subscriptions_mutex;
+    std::vector<Subscription> frame_stats_subscriptions;
+    std::vector<Subscription> memory_subscriptions;
+
+    /// Held while handling requests, so that they don't race with the end of the frame advances
+    std::mutex frame_advance_mutex;
+    /// Whether the emulation is paused between the frame advance requests
+    bool frame_advancing = false;
+    /// The frame advance request being run, replied to at the end of its last frame
+    std::unique_ptr<Packet> frame_advance;
+    u32 remaining_frames_to_advance = 0;
+    /// Requests received while advancing frames, handled once the frames have run
+    std::vector<std::unique_ptr<Packet>> deferred_requests;
 };
 
 } // namespace RPC
@@ -71,7 +71,10 @@ private:
 
         if (error) {
             LOG_WARNING(RPC_Server, "Failed to send reply: {}", error.message());
-        } else {
+        } else if (const auto type = reply_packet.GetPacketType();
+                   type != PacketType::FrameStats && type != PacketType::MemoryRanges &&
+                   type != PacketType::FrameAdvance) {
+            // These can be sent every frame and would flood the log
             LOG_INFO(RPC_Server, "Sent reply version({}) id=({}) type=({}) size=({})",
                      reply_packet.GetVersion(), reply_packet.GetId(), reply_packet.GetPacketType(),
                      reply_packet.GetPacketDataSize());
@@ -2,16 +2,36 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
 #include <boost/serialization/binary_object.hpp>
 #include <cryptopp/hex.h>
 #include "common/archives.h"
+#include "common/color.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/scope_exit.h"
 #include "common/scm_rev.h"
+#include "common/settings.h"
+#include "common/thread_pool.h"
 #include "common/zstd_compression.h"
 #include "core/cheats/cheats.h"
 #include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
 #include "core/movie.h"
+#include "core/rewind.h"
 #include "core/savestate.h"
 #include "network/network.h"
 #include "video_core/video_core.h"
@@ -25,7 +45,17 @@ struct CSTHeader {
     std::array<u8, 20> revision; /// Git hash of the revision this savestate was created with
     u64_le time;                 /// The time when this save state was created
 
-    std::array<u8, 216> reserved; /// Make heading 256 bytes so it has consistent size
+    u32_le format;             /// How the state is stored, see CSTFormat
+    u32_le chunk_size;         /// Memory covered by each chunk, in bytes
+    u64_le state_size;         /// Compressed size of the state, which follows the header
+    u64_le chunk_table_offset; /// Position of the chunk table in the file
+    u32_le num_chunks;         /// Number of entries of the chunk table
+
+    u64_le thumbnail_offset; /// Position of the RGB8 thumbnail in the file, 0 if there is none
+    u16_le thumbnail_width;  /// Width of the thumbnail, in pixels
+    u16_le thumbnail_height; /// Height of the thumbnail, in pixels
+
+    std::array<u8, 176> reserved; /// Make heading 256 bytes so it has consistent size
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -33,8 +63,28 @@ struct CSTHeader {
     }
 };
 static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
+
+/// Describes a chunk of the memory, which is compressed on its own
+struct CSTChunk {
+    u32_le index;  /// Position of the chunk in the memory, in chunks
+    u32_le size;   /// Compressed size of the chunk
+    u64_le offset; /// Position of the compressed chunk in the file
+};
+static_assert(sizeof(CSTChunk) == 16, "CSTChunk should be 16 bytes");
 #pragma pack(pop)
 
+enum CSTFormat : u32 {
+    /// The whole state, including the memory, is a single zstd stream
+    Stream = 0,
+    /// The memory is left out of the state stream, its non-zero chunks follow the state
+    MemoryChunks = 1,
+};
+
+/// Chunks of the memory are whole pages, so that they can be decompressed in place
+constexpr std::size_t MemoryChunkSize = 1024 * 1024;
+static_assert(Memory::MemorySystem::StateMemorySize % MemoryChunkSize == 0);
+static_assert(MemoryChunkSize % Memory::CITRA_PAGE_SIZE == 0);
+
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'S', 'T', 0x1B}};
 
 std::string GetSaveStatePath(u64 program_id, u32 slot) {
@@ -49,75 +99,394 @@ std::string GetSaveStatePath(u64 program_id, u32 slot) {
     }
 }
 
+/// Thumbnails are the top screen scaled down by this factor
+constexpr u32 ThumbnailScale = 4;
+
+namespace {
+
+/// Listed savestates of a title, valid while the savestates directory isn't modified
+struct SaveStateList {
+    s64 directory_time;
+    std::vector<SaveStateInfo> savestates;
+};
+
+std::mutex save_state_list_mutex;
+/// Indexed by the savestate path of the first slot, which tells apart the titles and movies
+std::unordered_map<std::string, SaveStateList> save_state_lists;
+
+/// Drops the cached lists, after a savestate was written
+void InvalidateSaveStateLists() {
+    std::scoped_lock lock{save_state_list_mutex};
+    save_state_lists.clear();
+}
+
+std::optional<SaveStateInfo> ReadSaveStateInfo(const std::string& path, u64 program_id,
+                                               u32 slot) {
+    if (!FileUtil::Exists(path)) {
+        return std::nullopt;
+    }
+
+    SaveStateInfo info;
+    info.slot = slot;
+
+    FileUtil::IOFile file(path, "rb");
+    if (!file) {
+        LOG_ERROR(Core, "Could not open file {}", path);
+        return std::nullopt;
+    }
+    CSTHeader header;
+    if (file.GetSize() < sizeof(header)) {
+        LOG_ERROR(Core, "File too small {}", path);
+        return std::nullopt;
+    }
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        LOG_ERROR(Core, "Could not read from file {}", path);
+        return std::nullopt;
+    }
+    if (header.filetype != header_magic_bytes) {
+        LOG_WARNING(Core, "Invalid save state file {}", path);
+        return std::nullopt;
+    }
+    info.time = header.time;
+
+    if (header.program_id != program_id) {
+        LOG_WARNING(Core, "Save state file isn't for the current game {}", path);
+        return std::nullopt;
+    }
+    const std::string revision = fmt::format("{:02x}", fmt::join(header.revision, ""));
+    if (revision == Common::g_scm_rev) {
+        info.status = SaveStateInfo::ValidationStatus::OK;
+    } else {
+        LOG_WARNING(Core, "Save state file {} created from a different revision {}", path,
+                    revision);
+        info.status = SaveStateInfo::ValidationStatus::RevisionDismatch;
+    }
+
+    if (header.format == CSTFormat::MemoryChunks && header.thumbnail_offset != 0) {
+        std::vector<u8> thumbnail(std::size_t{header.thumbnail_width} * header.thumbnail_height *
+                                  3);
+        if (file.Seek(header.thumbnail_offset, SEEK_SET) &&
+            file.ReadBytes(thumbnail.data(), thumbnail.size()) == thumbnail.size()) {
+            info.thumbnail = std::move(thumbnail);
+            info.thumbnail_width = header.thumbnail_width;
+            info.thumbnail_height = header.thumbnail_height;
+        } else {
+            LOG_WARNING(Core, "Could not read the thumbnail of {}", path);
+        }
+    }
+    return info;
+}
+
+} // Anonymous namespace
+
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id) {
+    const std::string directory = FileUtil::GetUserPath(FileUtil::UserPath::StatesDir);
+    if (!FileUtil::Exists(directory)) {
+        return {};
+    }
+
+    // Writing, renaming or deleting a savestate updates the time of the directory. Savestates
+    // written by the emulator also drop the lists, as the time only has a resolution of seconds.
+    const s64 directory_time = FileUtil::GetModificationTime(directory);
+    const std::string key = GetSaveStatePath(program_id, 1);
+    {
+        std::scoped_lock lock{save_state_list_mutex};
+        const auto it = save_state_lists.find(key);
+        if (it != save_state_lists.end() && it->second.directory_time == directory_time) {
+            return it->second.savestates;
+        }
+    }
+
     std::vector<SaveStateInfo> result;
     for (u32 slot = 1; slot <= SaveStateSlotCount; ++slot) {
-        const auto path = GetSaveStatePath(program_id, slot);
-        if (!FileUtil::Exists(path)) {
-            continue;
+        if (auto info = ReadSaveStateInfo(GetSaveStatePath(program_id, slot), program_id, slot)) {
+            result.push_back(std::move(*info));
+        }
+    }
+
+    std::scoped_lock lock{save_state_list_mutex};
+    save_state_lists.insert_or_assign(key, SaveStateList{directory_time, result});
+    return result;
+}
+
+namespace {
+
+/**
+ * Stream buffer keeping the written data in fixed size chunks, so that growing it never copies
+ * what was written before.
+ */
+class SnapshotBuffer final : public std::streambuf {
+public:
+    using Chunks = std::vector<std::vector<char>>;
+
+    /// Returns the written data, leaving the buffer empty
+    Chunks TakeChunks() {
+        if (!chunks.empty()) {
+            chunks.back().resize(pptr() - pbase());
+        }
+        setp(nullptr, nullptr);
+        return std::move(chunks);
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        NextChunk();
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    std::streamsize xsputn(const char_type* data, std::streamsize size) override {
+        std::streamsize written = 0;
+        while (written < size) {
+            if (pptr() == epptr()) {
+                NextChunk();
+            }
+            const auto count = std::min<std::streamsize>(size - written, epptr() - pptr());
+            std::memcpy(pptr(), data + written, count);
+            pbump(static_cast<int>(count));
+            written += count;
         }
+        return written;
+    }
 
-        SaveStateInfo info;
-        info.slot = slot;
+private:
+    static constexpr std::size_t ChunkSize = 16 * 1024 * 1024;
+
+    void NextChunk() {
+        auto& chunk = chunks.emplace_back(ChunkSize);
+        setp(chunk.data(), chunk.data() + chunk.size());
+    }
+
+    Chunks chunks;
+};
+
+/// Copy of a chunk of the memory that holds data
+struct MemoryChunk {
+    u32 index;
+    std::vector<u8> data;
+};
 
-        FileUtil::IOFile file(path, "rb");
+/// Emulated state that is written on a background thread
+struct SaveStateSnapshot {
+    CSTHeader header;
+    SnapshotBuffer::Chunks state;
+    std::vector<MemoryChunk> memory;
+    std::vector<u8> thumbnail;
+};
+
+/// Scales down the framebuffer displayed on the top screen, returns false if it can't be read
+bool TakeThumbnail(Memory::MemorySystem& memory, SaveStateSnapshot& snapshot) {
+    using PixelFormat = GPU::Regs::PixelFormat;
+    const auto& framebuffer = GPU::g_regs.framebuffer_config[0];
+    const PixelFormat format = framebuffer.color_format;
+    if (format > PixelFormat::RGBA4) {
+        return false;
+    }
+    const u32 bpp = GPU::Regs::BytesPerPixel(format);
+
+    // The framebuffer is rotated, its rows are the columns of the screen from the left, each
+    // starting at the bottom
+    const u32 screen_width = framebuffer.height;
+    const u32 screen_height = framebuffer.width;
+    const u32 stride = framebuffer.stride;
+    if (screen_width < ThumbnailScale || screen_height < ThumbnailScale ||
+        stride < screen_height * bpp) {
+        return false;
+    }
+    const PAddr address =
+        framebuffer.active_fb == 0 ? framebuffer.address_left1 : framebuffer.address_left2;
+    const std::size_t size = std::size_t{screen_width - 1} * stride + screen_height * bpp;
+    const u8* const pixels = memory.GetPhysicalPointer(address);
+    if (!pixels || memory.GetPhysicalPointer(address + static_cast<u32>(size) - 1) !=
+                       pixels + size - 1) {
+        return false;
+    }
+
+    const auto decode = [format](const u8* pixel) {
+        switch (format) {
+        case PixelFormat::RGBA8:
+            return Common::Color::DecodeRGBA8(pixel);
+        case PixelFormat::RGB8:
+            return Common::Color::DecodeRGB8(pixel);
+        case PixelFormat::RGB565:
+            return Common::Color::DecodeRGB565(pixel);
+        case PixelFormat::RGB5A1:
+            return Common::Color::DecodeRGB5A1(pixel);
+        default:
+            return Common::Color::DecodeRGBA4(pixel);
+        }
+    };
+    const u32 width = screen_width / ThumbnailScale;
+    const u32 height = screen_height / ThumbnailScale;
+    snapshot.thumbnail.resize(std::size_t{width} * height * 3);
+    u8* out = snapshot.thumbnail.data();
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            std::array<u32, 3> sum{};
+            for (u32 dy = 0; dy < ThumbnailScale; dy++) {
+                for (u32 dx = 0; dx < ThumbnailScale; dx++) {
+                    const u32 row = x * ThumbnailScale + dx;
+                    const u32 column = screen_height - 1 - (y * ThumbnailScale + dy);
+                    const auto color = decode(pixels + row * stride + column * bpp);
+                    for (std::size_t i = 0; i < sum.size(); i++) {
+                        sum[i] += color[i];
+                    }
+                }
+            }
+            for (const u32 component : sum) {
+                *out++ = static_cast<u8>(component / (ThumbnailScale * ThumbnailScale));
+            }
+        }
+    }
+    snapshot.header.thumbnail_width = static_cast<u16>(width);
+    snapshot.header.thumbnail_height = static_cast<u16>(height);
+    return true;
+}
+
+/// Copies the chunks of the memory that hold data
+std::vector<MemoryChunk> CopyMemoryChunks(Memory::MemorySystem& memory) {
+    const std::span<const u8> state_memory = memory.GetStateMemory();
+    std::vector<MemoryChunk> chunks;
+    for (const auto& [offset, size] : memory.GetPopulatedStateMemory()) {
+        u32 index = static_cast<u32>(offset / MemoryChunkSize);
+        if (!chunks.empty() && chunks.back().index >= index) {
+            index = chunks.back().index + 1;
+        }
+        for (; index * MemoryChunkSize < offset + size; index++) {
+            const auto chunk = state_memory.subspan(index * MemoryChunkSize, MemoryChunkSize);
+            if (std::any_of(chunk.begin(), chunk.end(), [](u8 byte) { return byte != 0; })) {
+                chunks.push_back({index, {chunk.begin(), chunk.end()}});
+            }
+        }
+    }
+    return chunks;
+}
+
+/// Compresses the snapshot into a temporary file, which then replaces the slot
+void WriteSaveState(const std::string& path, SaveStateSnapshot& snapshot) {
+    // The chunks are compressed independently, so they can use all the pool workers
+    std::vector<std::vector<u8>> compressed_chunks(snapshot.memory.size());
+    {
+        Common::TaskGroup group;
+        group.RunForEach(snapshot.memory.size(), [&](std::size_t i) {
+            const auto& data = snapshot.memory[i].data;
+            compressed_chunks[i] =
+                Common::Compression::CompressDataZSTDDefault(data.data(), data.size());
+        });
+        group.Wait();
+    }
+
+    // The state is written to a temporary file first, so that the slot stays intact if writing
+    // fails halfway
+    const std::string temp_path = path + ".tmp";
+    {
+        FileUtil::IOFile file(temp_path, "wb");
         if (!file) {
-            LOG_ERROR(Core, "Could not open file {}", path);
-            continue;
+            throw std::runtime_error("Could not open file " + temp_path);
         }
-        CSTHeader header;
-        if (file.GetSize() < sizeof(header)) {
-            LOG_ERROR(Core, "File too small {}", path);
-            continue;
+        CSTHeader& header = snapshot.header;
+        if (file.WriteBytes(&header, sizeof(header)) != sizeof(header)) {
+            throw std::runtime_error("Could not write to file " + temp_path);
         }
-        if (file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
-            LOG_ERROR(Core, "Could not read from file {}", path);
-            continue;
+
+        u64 state_size = 0;
+        Common::Compression::ZSTDCompressionStreamBuffer compressed{
+            [&file, &state_size](std::span<const u8> data) {
+                state_size += data.size();
+                return file.WriteBytes(data.data(), data.size()) == data.size();
+            },
+            0};
+        for (const auto& chunk : snapshot.state) {
+            const auto size = static_cast<std::streamsize>(chunk.size());
+            if (compressed.sputn(chunk.data(), size) != size) {
+                throw std::runtime_error("Could not write to file " + temp_path);
+            }
         }
-        if (header.filetype != header_magic_bytes) {
-            LOG_WARNING(Core, "Invalid save state file {}", path);
-            continue;
+        if (!compressed.Finish()) {
+            throw std::runtime_error("Could not write to file " + temp_path);
         }
-        info.time = header.time;
 
-        if (header.program_id != program_id) {
-            LOG_WARNING(Core, "Save state file isn't for the current game {}", path);
-            continue;
+        std::vector<CSTChunk> chunk_table;
+        u64 offset = sizeof(header) + state_size;
+        for (std::size_t i = 0; i < compressed_chunks.size(); i++) {
+            const auto& data = compressed_chunks[i];
+            if (file.WriteBytes(data.data(), data.size()) != data.size()) {
+                throw std::runtime_error("Could not write to file " + temp_path);
+            }
+            chunk_table.push_back(
+                {snapshot.memory[i].index, static_cast<u32>(data.size()), offset});
+            offset += data.size();
         }
-        const std::string revision = fmt::format("{:02x}", fmt::join(header.revision, ""));
-        if (revision == Common::g_scm_rev) {
-            info.status = SaveStateInfo::ValidationStatus::OK;
-        } else {
-            LOG_WARNING(Core, "Save state file {} created from a different revision {}", path,
-                        revision);
-            info.status = SaveStateInfo::ValidationStatus::RevisionDismatch;
+        if (file.WriteArray(chunk_table.data(), chunk_table.size()) != chunk_table.size()) {
+            throw std::runtime_error("Could not write to file " + temp_path);
+        }
+        const u64 thumbnail_offset = offset + chunk_table.size() * sizeof(CSTChunk);
+        if (file.WriteBytes(snapshot.thumbnail.data(), snapshot.thumbnail.size()) !=
+            snapshot.thumbnail.size()) {
+            throw std::runtime_error("Could not write to file " + temp_path);
+        }
+
+        // Now that the layout is known, the header can be completed
+        header.format = CSTFormat::MemoryChunks;
+        header.chunk_size = static_cast<u32>(MemoryChunkSize);
+        header.state_size = state_size;
+        header.chunk_table_offset = offset;
+        header.num_chunks = static_cast<u32>(chunk_table.size());
+        header.thumbnail_offset = snapshot.thumbnail.empty() ? 0 : thumbnail_offset;
+        if (!file.Seek(0, SEEK_SET) || file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
+            !file.Close()) {
+            throw std::runtime_error("Could not write to file " + temp_path);
         }
-        result.emplace_back(std::move(info));
     }
-    return result;
+
+    if (FileUtil::Exists(path)) {
+        FileUtil::Delete(path);
+    }
+    const bool renamed = FileUtil::Rename(temp_path, path);
+    InvalidateSaveStateLists();
+    if (!renamed) {
+        throw std::runtime_error("Could not rename " + temp_path + " to " + path);
+    }
 }
 
-void System::SaveState(u32 slot) const {
-    std::ostringstream sstream{std::ios_base::binary};
-    // Serialize
-    oarchive oa{sstream};
-    oa&* this;
+/// Decompresses the chunks of the memory in place, using all the pool workers
+void ReadMemoryChunks(Memory::MemorySystem& memory, const std::vector<CSTChunk>& chunk_table,
+                      std::span<const u8> chunk_data, u64 chunk_data_offset) {
+    const std::span<u8> state_memory = memory.GetStateMemory();
+    Common::TaskGroup group;
+    group.RunForEach(chunk_table.size(), [&](std::size_t i) {
+        const CSTChunk& chunk = chunk_table[i];
+        const auto destination =
+            state_memory.subspan(chunk.index * MemoryChunkSize, MemoryChunkSize);
+        const auto source = chunk_data.subspan(chunk.offset - chunk_data_offset, chunk.size);
+        if (!Common::Compression::DecompressFrameZSTD(source, destination)) {
+            throw std::runtime_error("Could not decompress the memory");
+        }
+    });
+    group.Wait();
+}
 
-    const std::string& str{sstream.str()};
-    auto buffer = Common::Compression::CompressDataZSTDDefault(
-        reinterpret_cast<const u8*>(str.data()), str.size());
+} // Anonymous namespace
+
+void System::SaveState(u32 slot) {
+    SaveStateToFile(GetSaveStatePath(title_id, slot));
+}
+
+void System::SaveStateToFile(const std::string& path) {
+    // Only one savestate is written at a time
+    WaitForPendingSaveState();
 
-    const auto path = GetSaveStatePath(title_id, slot);
     if (!FileUtil::CreateFullPath(path)) {
         throw std::runtime_error("Could not create path " + path);
     }
 
-    FileUtil::IOFile file(path, "wb");
-    if (!file) {
-        throw std::runtime_error("Could not open file " + path);
-    }
-
-    CSTHeader header{};
+    auto snapshot = std::make_shared<SaveStateSnapshot>();
+    CSTHeader& header = snapshot->header;
+    header = {};
     header.filetype = header_magic_bytes;
     header.program_id = title_id;
     std::string rev_bytes;
@@ -128,9 +497,42 @@ void System::SaveState(u32 slot) const {
                       std::chrono::system_clock::now().time_since_epoch())
                       .count();
 
-    if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
-        file.WriteBytes(buffer.data(), buffer.size()) != buffer.size()) {
-        throw std::runtime_error("Could not write to file " + path);
+    // Only the copy into memory has to happen while emulation is stopped, compressing and writing
+    // the snapshot is left to a background thread. The memory is stored apart from the rest of
+    // the state, in chunks that can be decompressed in parallel.
+    SnapshotBuffer buffer;
+    {
+        Memory::MemorySystem::SetSerializeStateMemory(false);
+        SCOPE_EXIT({ Memory::MemorySystem::SetSerializeStateMemory(true); });
+        std::ostream stream{&buffer};
+        {
+            oarchive oa{stream};
+            oa&* this;
+        }
+        if (!stream) {
+            throw std::runtime_error("Could not serialize the state");
+        }
+    }
+    snapshot->state = buffer.TakeChunks();
+    // Serializing the state flushes the rasterizer caches, so the memory has to be copied after
+    snapshot->memory = CopyMemoryChunks(*memory);
+    if (!TakeThumbnail(*memory, *snapshot)) {
+        LOG_WARNING(Core, "Could not take a thumbnail of the top screen");
+    }
+    pending_save =
+        Common::ThreadPool::Shared().Submit([path, snapshot] { WriteSaveState(path, *snapshot); });
+}
+
+bool System::IsSaveStatePending() const {
+    return pending_save.valid() &&
+           pending_save.wait_for(std::chrono::seconds::zero()) != std::future_status::ready;
+}
+
+void System::WaitForPendingSaveState() {
+    if (pending_save.valid()) {
+        // Rethrows the error of the background write
+        pending_save.get();
+        LOG_INFO(Core, "Save completed");
     }
 }
 
@@ -139,27 +541,140 @@ void System::LoadState(u32 slot) {
         throw std::runtime_error("Unable to load while connected to multiplayer");
     }
 
-    const auto path = GetSaveStatePath(title_id, slot);
+    LoadStateFromFile(GetSaveStatePath(title_id, slot));
+}
 
-    std::vector<u8> decompressed;
-    {
-        std::vector<u8> buffer(FileUtil::GetSize(path) - sizeof(CSTHeader));
+void System::LoadStateFromFile(const std::string& path) {
+    // Make sure that the file was written completely
+    WaitForPendingSaveState();
+
+    FileUtil::IOFile file(path, "rb");
+    CSTHeader header;
+    if (!file || file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        throw std::runtime_error("Could not read from file at " + path);
+    }
 
-        FileUtil::IOFile file(path, "rb");
-        file.Seek(sizeof(CSTHeader), SEEK_SET); // Skip header
-        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
-            throw std::runtime_error("Could not read from file at " + path);
+    if (header.format == CSTFormat::Stream) {
+        // Deserialize straight from the decompressor, which reads the file as it goes
+        Common::Compression::ZSTDDecompressionStreamBuffer decompressed{
+            [&file](std::span<u8> data) { return file.ReadBytes(data.data(), data.size()); }};
+        std::istream stream{&decompressed};
+        iarchive ia{stream};
+        ia&* this;
+        if (decompressed.HasFailed()) {
+            throw std::runtime_error("Could not decompress file at " + path);
+        }
+        return;
+    }
+    if (header.format != CSTFormat::MemoryChunks || header.chunk_size != MemoryChunkSize) {
+        throw std::runtime_error("Unsupported save state format in file at " + path);
+    }
+
+    // Read the chunks of the memory up front, the memory is only recreated by the
+    // deserialization of the state
+    const u64 chunk_data_offset = sizeof(header) + header.state_size;
+    const u64 file_size = file.GetSize();
+    if (header.chunk_table_offset < chunk_data_offset || header.chunk_table_offset > file_size ||
+        (file_size - header.chunk_table_offset) / sizeof(CSTChunk) < header.num_chunks) {
+        throw std::runtime_error("Invalid file at " + path);
+    }
+    std::vector<CSTChunk> chunk_table(header.num_chunks);
+    std::vector<u8> chunk_data(header.chunk_table_offset - chunk_data_offset);
+    if (!file.Seek(chunk_data_offset, SEEK_SET) ||
+        file.ReadBytes(chunk_data.data(), chunk_data.size()) != chunk_data.size() ||
+        file.ReadArray(chunk_table.data(), chunk_table.size()) != chunk_table.size()) {
+        throw std::runtime_error("Could not read from file at " + path);
+    }
+    for (const CSTChunk& chunk : chunk_table) {
+        if (chunk.index >= Memory::MemorySystem::StateMemorySize / MemoryChunkSize ||
+            chunk.offset < chunk_data_offset ||
+            chunk.offset - chunk_data_offset > chunk_data.size() ||
+            chunk_data.size() - (chunk.offset - chunk_data_offset) < chunk.size) {
+            throw std::runtime_error("Invalid file at " + path);
         }
-        decompressed = Common::Compression::DecompressDataZSTD(buffer);
     }
-    std::istringstream sstream{
-        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
-        std::ios_base::binary};
-    decompressed.clear();
 
-    // Deserialize
-    iarchive ia{sstream};
-    ia&* this;
+    if (!file.Seek(sizeof(header), SEEK_SET)) {
+        throw std::runtime_error("Could not read from file at " + path);
+    }
+    u64 state_remaining = header.state_size;
+    Common::Compression::ZSTDDecompressionStreamBuffer decompressed{
+        [&file, &state_remaining](std::span<u8> data) {
+            const std::size_t size = file.ReadBytes(
+                data.data(), static_cast<std::size_t>(std::min<u64>(data.size(), state_remaining)));
+            state_remaining -= size;
+            return size;
+        }};
+    {
+        Memory::MemorySystem::SetSerializeStateMemory(false);
+        SCOPE_EXIT({ Memory::MemorySystem::SetSerializeStateMemory(true); });
+        std::istream stream{&decompressed};
+        iarchive ia{stream};
+        ia&* this;
+    }
+    if (decompressed.HasFailed()) {
+        throw std::runtime_error("Could not decompress file at " + path);
+    }
+    ReadMemoryChunks(*memory, chunk_table, chunk_data, chunk_data_offset);
+}
+
+void System::PrepareBootSnapshot() {
+    boot_snapshot_path.clear();
+    restore_boot_snapshot = false;
+    const u32 boot_snapshot_time = Settings::values.boot_snapshot_time.GetValue();
+    if (boot_snapshot_time == 0) {
+        return;
+    }
+    if (Settings::values.audio_emulation.GetValue() != Settings::AudioEmulation::HLE) {
+        LOG_WARNING(Core, "Boot snapshots aren't supported with LLE audio");
+        return;
+    }
+
+    // The configuration savegame and the installed titles are left out, like for savestates
+    const std::string boot_key = fmt::format(
+        "{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}", Common::g_scm_rev, m_filepath,
+        FileUtil::GetSize(m_filepath), FileUtil::GetModificationTime(m_filepath),
+        Settings::values.is_new_3ds.GetValue(), Settings::values.region_value.GetValue(),
+        static_cast<u32>(Settings::values.init_clock.GetValue()),
+        Settings::values.init_time.GetValue(), Settings::values.init_time_offset.GetValue(),
+        Settings::values.use_virtual_time.GetValue(),
+        Settings::values.cpu_clock_percentage.GetValue(),
+        Settings::values.plugin_loader_enabled.GetValue(), boot_snapshot_time);
+    const u64 hash = Common::ComputeHash64(boot_key.data(), boot_key.size());
+    const std::string directory =
+        FileUtil::GetUserPath(FileUtil::UserPath::StatesDir) + "boot" DIR_SEP;
+    const std::string prefix = fmt::format("{:016X}.", title_id);
+    boot_snapshot_path = fmt::format("{}{}{:016X}.cst", directory, prefix, hash);
+    restore_boot_snapshot = FileUtil::Exists(boot_snapshot_path);
+    if (restore_boot_snapshot) {
+        return;
+    }
+
+    // The snapshots taken before the change are never used again
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, directory,
+        [&prefix](u64*, const std::string& parent, const std::string& virtual_name) {
+            if (virtual_name.starts_with(prefix)) {
+                FileUtil::Delete(parent + virtual_name);
+            }
+            return true;
+        });
+}
+
+bool System::Rewind() {
+    if (!rewind_buffer) {
+        return false;
+    }
+    if (Network::GetRoomMember().lock()->IsConnected()) {
+        throw std::runtime_error("Unable to rewind while connected to multiplayer");
+    }
+
+    if (!rewind_buffer->Rewind(*this)) {
+        return false;
+    }
+    next_rewind_snapshot = timing->GetGlobalTimeUs() +
+                           std::chrono::milliseconds(Settings::values.rewind_interval.GetValue());
+    return true;
 }
 
 } // namespace Core
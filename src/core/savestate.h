@@ -18,10 +18,18 @@ struct SaveStateInfo {
         OK,
         RevisionDismatch,
     } status;
+    /// RGB8 thumbnail of the top screen, rows from the top, empty for older savestates
+    std::vector<u8> thumbnail;
+    u32 thumbnail_width = 0;
+    u32 thumbnail_height = 0;
 };
 
 constexpr u32 SaveStateSlotCount = 10; // Maximum count of savestate slots
 
+/**
+ * Lists the savestates of the title. The list is cached until the savestates directory changes or
+ * a savestate is written, so that menus can call this whenever they are shown.
+ */
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id);
 
 } // namespace Core
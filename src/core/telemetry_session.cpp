@@ -17,6 +17,7 @@
 #ifdef ENABLE_WEB_SERVICE
 #include "web_service/telemetry_json.h"
 #include "web_service/verify_login.h"
+#include "web_service/web_backend.h"
 #endif
 
 namespace Core {
@@ -77,6 +78,12 @@ bool VerifyLogin(const std::string& username, const std::string& token) {
 #endif
 }
 
+void ShutdownWebService() {
+#ifdef ENABLE_WEB_SERVICE
+    WebService::Shutdown();
+#endif
+}
+
 TelemetrySession::TelemetrySession() = default;
 
 TelemetrySession::~TelemetrySession() {
@@ -88,4 +88,10 @@ u64 RegenerateTelemetryId();
  */
 bool VerifyLogin(const std::string& username, const std::string& token);
 
+/**
+ * Gives the web service requests that are still queued, e.g. the telemetry of the last session, a
+ * moment to finish and drops the rest. Called by the frontends on exit.
+ */
+void ShutdownWebService();
+
 } // namespace Core
@@ -9,6 +9,11 @@
 namespace CiTrace {
 
 // NOTE: Things are stored in little-endian
+//
+// The header is stored as is, everything after it is compressed into a single Zstandard frame.
+// Offsets refer to the uncompressed file, in which the initial state follows the header and the
+// stream follows the initial state. The data of a memory load is stored right after the element
+// when it wasn't recorded before, otherwise the element refers to the earlier copy.
 
 #pragma pack(1)
 
@@ -18,7 +23,7 @@ struct CTHeader {
     }
 
     static u32 ExpectedVersion() {
-        return 1;
+        return 2;
     }
 
     char magic[4];
@@ -57,6 +62,7 @@ struct CTHeader {
     } initial_state_offsets;
 
     u32 stream_offset;
+    /// Number of stream elements
     u32 stream_size;
 };
 
@@ -0,0 +1,131 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <istream>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "core/tracer/reader.h"
+
+namespace CiTrace {
+
+namespace {
+
+/// Size of the pieces the compressed file is read in
+constexpr std::size_t ReadChunkSize = 1024 * 1024;
+
+} // Anonymous namespace
+
+std::optional<Trace> Trace::Load(const std::string& filename) {
+    FileUtil::IOFile file(filename, "rb");
+    Trace trace;
+    if (!file.IsOpen() || file.ReadArray(&trace.header, 1) != 1) {
+        LOG_ERROR(HW_GPU, "Could not read the CiTrace file {}", filename);
+        return std::nullopt;
+    }
+    if (std::memcmp(trace.header.magic, CTHeader::ExpectedMagicWord(), 4) != 0 ||
+        trace.header.version != CTHeader::ExpectedVersion() ||
+        trace.header.header_size != sizeof(CTHeader)) {
+        LOG_ERROR(HW_GPU, "{} is not a CiTrace file of version {}", filename,
+                  CTHeader::ExpectedVersion());
+        return std::nullopt;
+    }
+
+    Common::Compression::ZSTDDecompressionStreamBuffer buffer{[&file](std::span<u8> out) {
+        return file.ReadBytes(out.data(), out.size());
+    }};
+    std::istream stream{&buffer};
+    trace.file_data.resize(sizeof(CTHeader));
+    std::memcpy(trace.file_data.data(), &trace.header, sizeof(CTHeader));
+    while (stream) {
+        const std::size_t size = trace.file_data.size();
+        trace.file_data.resize(size + ReadChunkSize);
+        stream.read(reinterpret_cast<char*>(trace.file_data.data() + size), ReadChunkSize);
+        trace.file_data.resize(size + static_cast<std::size_t>(stream.gcount()));
+    }
+    if (buffer.HasFailed()) {
+        LOG_ERROR(HW_GPU, "The CiTrace file {} is corrupted", filename);
+        return std::nullopt;
+    }
+
+    if (!trace.Parse()) {
+        LOG_ERROR(HW_GPU, "The CiTrace file {} is invalid", filename);
+        return std::nullopt;
+    }
+    return trace;
+}
+
+bool Trace::Parse() {
+    const auto read_words = [this](u32 offset, u32 size, std::vector<u32>& out) {
+        const u64 end = offset + u64{size} * sizeof(u32);
+        if (offset < sizeof(CTHeader) || end > file_data.size()) {
+            return false;
+        }
+        out.resize(size);
+        std::memcpy(out.data(), file_data.data() + offset, size * sizeof(u32));
+        return true;
+    };
+
+    const auto& initial = header.initial_state_offsets;
+    if (!read_words(initial.gpu_registers, initial.gpu_registers_size,
+                    initial_state.gpu_registers) ||
+        !read_words(initial.lcd_registers, initial.lcd_registers_size,
+                    initial_state.lcd_registers) ||
+        !read_words(initial.pica_registers, initial.pica_registers_size,
+                    initial_state.pica_registers) ||
+        !read_words(initial.default_attributes, initial.default_attributes_size,
+                    initial_state.default_attributes) ||
+        !read_words(initial.vs_program_binary, initial.vs_program_binary_size,
+                    initial_state.vs_program_binary) ||
+        !read_words(initial.vs_swizzle_data, initial.vs_swizzle_data_size,
+                    initial_state.vs_swizzle_data) ||
+        !read_words(initial.vs_float_uniforms, initial.vs_float_uniforms_size,
+                    initial_state.vs_float_uniforms) ||
+        !read_words(initial.gs_program_binary, initial.gs_program_binary_size,
+                    initial_state.gs_program_binary) ||
+        !read_words(initial.gs_swizzle_data, initial.gs_swizzle_data_size,
+                    initial_state.gs_swizzle_data) ||
+        !read_words(initial.gs_float_uniforms, initial.gs_float_uniforms_size,
+                    initial_state.gs_float_uniforms)) {
+        return false;
+    }
+
+    std::size_t offset = header.stream_offset;
+    elements.reserve(header.stream_size);
+    for (u32 i = 0; i < header.stream_size; i++) {
+        if (offset > file_data.size() || file_data.size() - offset < sizeof(CTStreamElement)) {
+            return false;
+        }
+        Element& element = elements.emplace_back();
+        std::memcpy(&element.data, file_data.data() + offset, sizeof(CTStreamElement));
+        offset += sizeof(CTStreamElement);
+
+        switch (element.data.type) {
+        case FrameMarker:
+        case RegisterWrite:
+            break;
+        case MemoryLoad: {
+            // The contents either follow the element or were stored by an earlier one
+            const CTMemoryLoad& load = element.data.memory_load;
+            const u64 end = u64{load.file_offset} + load.size;
+            if (load.file_offset == offset) {
+                if (end > file_data.size()) {
+                    return false;
+                }
+                offset += load.size;
+            } else if (load.file_offset < header.stream_offset || end > offset) {
+                return false;
+            }
+            element.memory = {file_data.data() + load.file_offset, load.size};
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return offset == file_data.size();
+}
+
+} // namespace CiTrace
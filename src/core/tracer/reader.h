@@ -0,0 +1,61 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "core/tracer/citrace.h"
+#include "core/tracer/recorder.h"
+
+namespace CiTrace {
+
+/// Trace loaded from a CiTrace file, for replaying or inspecting it
+class Trace {
+public:
+    struct Element {
+        CTStreamElement data;
+        /// Memory contents of a memory load, empty for the other elements
+        std::span<const u8> memory;
+    };
+
+    /**
+     * Loads and decompresses the trace.
+     * @return the trace, or nullopt if the file isn't a valid trace of the current version
+     */
+    [[nodiscard]] static std::optional<Trace> Load(const std::string& filename);
+
+    Trace(Trace&&) = default;
+    Trace& operator=(Trace&&) = default;
+
+    [[nodiscard]] const CTHeader& GetHeader() const {
+        return header;
+    }
+
+    [[nodiscard]] const Recorder::InitialState& GetInitialState() const {
+        return initial_state;
+    }
+
+    /// Returns the stream elements in the order they were recorded
+    [[nodiscard]] const std::vector<Element>& GetElements() const {
+        return elements;
+    }
+
+private:
+    Trace() = default;
+
+    /// Reads the initial state and the stream from the uncompressed file
+    bool Parse();
+
+    CTHeader header{};
+    /// Uncompressed file, referenced by the memory loads
+    std::vector<u8> file_data;
+    Recorder::InitialState initial_state;
+    std::vector<Element> elements;
+};
+
+} // namespace CiTrace
@@ -3,201 +3,175 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
-#include "common/assert.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/zstd_compression.h"
 #include "core/tracer/recorder.h"
 
 namespace CiTrace {
 
-Recorder::Recorder(const InitialState& initial_state) : initial_state(initial_state) {}
+namespace {
+
+/// The trace is compressed on a worker thread, so that recording doesn't slow down the GPU thread
+constexpr u32 CompressionThreads = 1;
+
+} // Anonymous namespace
+
+Recorder::Recorder(const InitialState& initial_state)
+    : temp_path{FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "citrace_recording.part"} {
+    if (FileUtil::CreateFullPath(temp_path)) {
+        file = FileUtil::IOFile(temp_path, "wb");
+    }
+    if (!file.IsOpen()) {
+        LOG_ERROR(HW_GPU, "Could not create the CiTrace file {}", temp_path);
+        failed = true;
+        return;
+    }
 
-void Recorder::Finish(const std::string& filename) {
-    // Setup CiTrace header
-    CTHeader header;
     std::memcpy(header.magic, CTHeader::ExpectedMagicWord(), 4);
     header.version = CTHeader::ExpectedVersion();
     header.header_size = sizeof(CTHeader);
 
-    // Calculate file offsets
-    auto& initial = header.initial_state_offsets;
+    // The header is written again once the stream size is known
+    if (file.WriteObject(header) != 1) {
+        LOG_ERROR(HW_GPU, "Writing CiTrace file failed: Failed to write header");
+        failed = true;
+        return;
+    }
+    file_offset = sizeof(CTHeader);
+    compressor = std::make_unique<Common::Compression::ZSTDCompressionStreamBuffer>(
+        [this](std::span<const u8> chunk) {
+            return file.WriteBytes(chunk.data(), chunk.size()) == chunk.size();
+        },
+        0, CompressionThreads);
+    WriteInitialState(initial_state);
+}
 
-    initial.gpu_registers_size = static_cast<u32>(initial_state.gpu_registers.size());
-    initial.lcd_registers_size = static_cast<u32>(initial_state.lcd_registers.size());
-    initial.pica_registers_size = static_cast<u32>(initial_state.pica_registers.size());
-    initial.default_attributes_size = static_cast<u32>(initial_state.default_attributes.size());
-    initial.vs_program_binary_size = static_cast<u32>(initial_state.vs_program_binary.size());
-    initial.vs_swizzle_data_size = static_cast<u32>(initial_state.vs_swizzle_data.size());
-    initial.vs_float_uniforms_size = static_cast<u32>(initial_state.vs_float_uniforms.size());
-    initial.gs_program_binary_size = static_cast<u32>(initial_state.gs_program_binary.size());
-    initial.gs_swizzle_data_size = static_cast<u32>(initial_state.gs_swizzle_data.size());
-    initial.gs_float_uniforms_size = static_cast<u32>(initial_state.gs_float_uniforms.size());
-    header.stream_size = static_cast<u32>(stream.size());
-
-    initial.gpu_registers = sizeof(header);
-    initial.lcd_registers = initial.gpu_registers + initial.gpu_registers_size * sizeof(u32);
-    initial.pica_registers = initial.lcd_registers + initial.lcd_registers_size * sizeof(u32);
-    ;
-    initial.default_attributes = initial.pica_registers + initial.pica_registers_size * sizeof(u32);
-    initial.vs_program_binary =
-        initial.default_attributes + initial.default_attributes_size * sizeof(u32);
-    initial.vs_swizzle_data =
-        initial.vs_program_binary + initial.vs_program_binary_size * sizeof(u32);
-    initial.vs_float_uniforms =
-        initial.vs_swizzle_data + initial.vs_swizzle_data_size * sizeof(u32);
-    initial.gs_program_binary =
-        initial.vs_float_uniforms + initial.vs_float_uniforms_size * sizeof(u32);
-    initial.gs_swizzle_data =
-        initial.gs_program_binary + initial.gs_program_binary_size * sizeof(u32);
-    initial.gs_float_uniforms =
-        initial.gs_swizzle_data + initial.gs_swizzle_data_size * sizeof(u32);
-    header.stream_offset = initial.gs_float_uniforms + initial.gs_float_uniforms_size * sizeof(u32);
-
-    // Iterate through stream elements, update relevant stream element data
-    for (auto& stream_element : stream) {
-        switch (stream_element.data.type) {
-        case MemoryLoad: {
-            auto& file_offset = memory_regions[stream_element.hash];
-            if (!stream_element.uses_existing_data) {
-                file_offset = header.stream_offset;
-            }
-            stream_element.data.memory_load.file_offset = file_offset;
-            break;
-        }
+Recorder::~Recorder() {
+    if (file.IsOpen()) {
+        // The recording was aborted
+        compressor.reset();
+        file.Close();
+        FileUtil::Delete(temp_path);
+    }
+}
 
-        default:
-            // Other commands don't use any extra data
-            DEBUG_ASSERT(stream_element.extra_data.size() == 0);
-            break;
-        }
-        header.stream_offset += static_cast<u32>(stream_element.extra_data.size());
+void Recorder::Finish(const std::string& filename) {
+    std::scoped_lock lock{mutex};
+    if (!file.IsOpen()) {
+        return;
     }
 
     try {
-        // Open file and write header
-        FileUtil::IOFile file(filename, "wb");
-        std::size_t written = file.WriteObject(header);
-        if (written != 1 || file.Tell() != initial.gpu_registers)
+        if (failed || !compressor->Finish()) {
+            throw "Failed to write stream";
+        }
+        compressor.reset();
+        if (!file.Seek(0, SEEK_SET) || file.WriteObject(header) != 1) {
             throw "Failed to write header";
-
-        // Write initial state
-        written =
-            file.WriteArray(initial_state.gpu_registers.data(), initial_state.gpu_registers.size());
-        if (written != initial_state.gpu_registers.size() || file.Tell() != initial.lcd_registers)
-            throw "Failed to write GPU registers";
-
-        written =
-            file.WriteArray(initial_state.lcd_registers.data(), initial_state.lcd_registers.size());
-        if (written != initial_state.lcd_registers.size() || file.Tell() != initial.pica_registers)
-            throw "Failed to write LCD registers";
-
-        written = file.WriteArray(initial_state.pica_registers.data(),
-                                  initial_state.pica_registers.size());
-        if (written != initial_state.pica_registers.size() ||
-            file.Tell() != initial.default_attributes)
-            throw "Failed to write Pica registers";
-
-        written = file.WriteArray(initial_state.default_attributes.data(),
-                                  initial_state.default_attributes.size());
-        if (written != initial_state.default_attributes.size() ||
-            file.Tell() != initial.vs_program_binary)
-            throw "Failed to write default vertex attributes";
-
-        written = file.WriteArray(initial_state.vs_program_binary.data(),
-                                  initial_state.vs_program_binary.size());
-        if (written != initial_state.vs_program_binary.size() ||
-            file.Tell() != initial.vs_swizzle_data)
-            throw "Failed to write vertex shader program binary";
-
-        written = file.WriteArray(initial_state.vs_swizzle_data.data(),
-                                  initial_state.vs_swizzle_data.size());
-        if (written != initial_state.vs_swizzle_data.size() ||
-            file.Tell() != initial.vs_float_uniforms)
-            throw "Failed to write vertex shader swizzle data";
-
-        written = file.WriteArray(initial_state.vs_float_uniforms.data(),
-                                  initial_state.vs_float_uniforms.size());
-        if (written != initial_state.vs_float_uniforms.size() ||
-            file.Tell() != initial.gs_program_binary)
-            throw "Failed to write vertex shader float uniforms";
-
-        written = file.WriteArray(initial_state.gs_program_binary.data(),
-                                  initial_state.gs_program_binary.size());
-        if (written != initial_state.gs_program_binary.size() ||
-            file.Tell() != initial.gs_swizzle_data)
-            throw "Failed to write geomtry shader program binary";
-
-        written = file.WriteArray(initial_state.gs_swizzle_data.data(),
-                                  initial_state.gs_swizzle_data.size());
-        if (written != initial_state.gs_swizzle_data.size() ||
-            file.Tell() != initial.gs_float_uniforms)
-            throw "Failed to write geometry shader swizzle data";
-
-        written = file.WriteArray(initial_state.gs_float_uniforms.data(),
-                                  initial_state.gs_float_uniforms.size());
-        if (written != initial_state.gs_float_uniforms.size() ||
-            file.Tell() != initial.gs_float_uniforms + sizeof(u32) * initial.gs_float_uniforms_size)
-            throw "Failed to write geometry shader float uniforms";
-
-        // Iterate through stream elements, write "extra data"
-        for (const auto& stream_element : stream) {
-            if (stream_element.extra_data.size() == 0)
-                continue;
-
-            written =
-                file.WriteBytes(stream_element.extra_data.data(), stream_element.extra_data.size());
-            if (written != stream_element.extra_data.size())
-                throw "Failed to write extra data";
         }
+        file.Close();
 
-        if (file.Tell() != header.stream_offset)
-            throw "Unexpected end of extra data";
-
-        // Write actual stream elements
-        for (const auto& stream_element : stream) {
-            if (1 != file.WriteObject(stream_element.data))
-                throw "Failed to write stream element";
+        // Renaming fails if the destination is on another drive on some systems
+        if (FileUtil::Exists(filename)) {
+            FileUtil::Delete(filename);
+        }
+        if (!FileUtil::Rename(temp_path, filename)) {
+            if (!FileUtil::Copy(temp_path, filename)) {
+                throw "Failed to move to the destination";
+            }
+            FileUtil::Delete(temp_path);
         }
     } catch (const char* str) {
         LOG_ERROR(HW_GPU, "Writing CiTrace file failed: {}", str);
+        compressor.reset();
+        file.Close();
+        FileUtil::Delete(temp_path);
     }
 }
 
 void Recorder::FrameFinished() {
-    stream.push_back({{FrameMarker}});
+    std::scoped_lock lock{mutex};
+    CTStreamElement element{FrameMarker};
+    WriteElement(element);
 }
 
 void Recorder::MemoryAccessed(const u8* data, u32 size, u32 physical_address) {
-    StreamElement element = {{MemoryLoad}};
-    element.data.memory_load.size = size;
-    element.data.memory_load.physical_address = physical_address;
+    std::scoped_lock lock{mutex};
+    CTStreamElement element{MemoryLoad};
+    element.memory_load.size = size;
+    element.memory_load.physical_address = physical_address;
 
-    // Compute hash over given memory region to check if the contents are already stored internally
+    // Compute hash over given memory region to check if the contents are already stored in the file
     boost::crc_32_type result;
     result.process_bytes(data, size);
-    element.hash = result.checksum();
+    const auto [it, is_new] =
+        memory_regions.try_emplace(result.checksum(), file_offset + sizeof(CTStreamElement));
+    element.memory_load.file_offset = it->second;
+
+    WriteElement(element);
+    if (is_new) {
+        // New contents follow the element
+        Write(data, size);
+    }
+}
 
-    element.uses_existing_data = (memory_regions.find(element.hash) != memory_regions.end());
-    if (!element.uses_existing_data) {
-        element.extra_data.resize(size);
-        memcpy(element.extra_data.data(), data, size);
-        memory_regions.insert({element.hash, 0}); // file offset will be initialized in Finish()
+void Recorder::Write(const void* data, std::size_t size) {
+    if (failed || !compressor) {
+        return;
+    }
+    const auto count = static_cast<std::streamsize>(size);
+    if (compressor->sputn(static_cast<const char*>(data), count) != count) {
+        LOG_ERROR(HW_GPU, "Writing CiTrace file failed: Failed to compress data");
+        failed = true;
+        return;
     }
+    file_offset += static_cast<u32>(size);
+}
+
+void Recorder::WriteInitialState(const InitialState& initial_state) {
+    auto& initial = header.initial_state_offsets;
+    const auto write = [this](const std::vector<u32>& data, u32& offset, u32& size) {
+        offset = file_offset;
+        size = static_cast<u32>(data.size());
+        Write(data.data(), data.size() * sizeof(u32));
+    };
+
+    write(initial_state.gpu_registers, initial.gpu_registers, initial.gpu_registers_size);
+    write(initial_state.lcd_registers, initial.lcd_registers, initial.lcd_registers_size);
+    write(initial_state.pica_registers, initial.pica_registers, initial.pica_registers_size);
+    write(initial_state.default_attributes, initial.default_attributes,
+          initial.default_attributes_size);
+    write(initial_state.vs_program_binary, initial.vs_program_binary,
+          initial.vs_program_binary_size);
+    write(initial_state.vs_swizzle_data, initial.vs_swizzle_data, initial.vs_swizzle_data_size);
+    write(initial_state.vs_float_uniforms, initial.vs_float_uniforms,
+          initial.vs_float_uniforms_size);
+    write(initial_state.gs_program_binary, initial.gs_program_binary,
+          initial.gs_program_binary_size);
+    write(initial_state.gs_swizzle_data, initial.gs_swizzle_data, initial.gs_swizzle_data_size);
+    write(initial_state.gs_float_uniforms, initial.gs_float_uniforms,
+          initial.gs_float_uniforms_size);
+    header.stream_offset = file_offset;
+}
 
-    stream.push_back(element);
+void Recorder::WriteElement(const CTStreamElement& element) {
+    Write(&element, sizeof(element));
+    header.stream_size++;
 }
 
 template <typename T>
 void Recorder::RegisterWritten(u32 physical_address, T value) {
-    StreamElement element = {{RegisterWrite}};
-    element.data.register_write.size = (sizeof(T) == 1)   ? CTRegisterWrite::SIZE_8
-                                       : (sizeof(T) == 2) ? CTRegisterWrite::SIZE_16
-                                       : (sizeof(T) == 4) ? CTRegisterWrite::SIZE_32
-                                                          : CTRegisterWrite::SIZE_64;
-    element.data.register_write.physical_address = physical_address;
-    element.data.register_write.value = value;
-
-    stream.push_back(element);
+    std::scoped_lock lock{mutex};
+    CTStreamElement element{RegisterWrite};
+    element.register_write.size = (sizeof(T) == 1)   ? CTRegisterWrite::SIZE_8
+                                  : (sizeof(T) == 2) ? CTRegisterWrite::SIZE_16
+                                  : (sizeof(T) == 4) ? CTRegisterWrite::SIZE_32
+                                                     : CTRegisterWrite::SIZE_64;
+    element.register_write.physical_address = physical_address;
+    element.register_write.value = value;
+
+    WriteElement(element);
 }
 
 template void Recorder::RegisterWritten(u32, u8);
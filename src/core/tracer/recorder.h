@@ -4,15 +4,26 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <boost/crc.hpp>
 #include "common/common_types.h"
+#include "common/file_util.h"
 #include "core/tracer/citrace.h"
 
+namespace Common::Compression {
+class ZSTDCompressionStreamBuffer;
+}
+
 namespace CiTrace {
 
+/**
+ * Records the GPU state and the accesses to it. The trace is compressed and streamed to a
+ * temporary file while recording, so that long traces don't have to be kept in memory.
+ */
 class Recorder {
 public:
     struct InitialState {
@@ -29,11 +40,14 @@ public:
     };
 
     /**
-     * Recorder constructor
+     * Recorder constructor, starts streaming the trace to a temporary file
      * @param initial_state Initial recorder state
      */
     explicit Recorder(const InitialState& initial_state);
 
+    /// Deletes the temporary file if the recording wasn't finished
+    ~Recorder();
+
     /// Finish recording of this Citrace and save it using the given filename.
     void Finish(const std::string& filename);
 
@@ -55,27 +69,26 @@ public:
     void RegisterWritten(u32 physical_address, T value);
 
 private:
-    // Initial state of recording start
-    InitialState initial_state;
+    /// Compresses the data into the file, advancing the uncompressed offset
+    void Write(const void* data, std::size_t size);
 
-    // Command stream
-    struct StreamElement {
-        CTStreamElement data;
+    /// Writes the initial state following the header
+    void WriteInitialState(const InitialState& initial_state);
 
-        /**
-         * Extra data to store along "core" data.
-         * This is e.g. used for data used in MemoryUpdates.
-         */
-        std::vector<u8> extra_data;
+    void WriteElement(const CTStreamElement& element);
 
-        /// Optional CRC hash (e.g. for hashing memory regions)
-        boost::crc_32_type::value_type hash;
+    std::mutex mutex;
 
-        /// If true, refer to data already written to the output file instead of extra_data
-        bool uses_existing_data;
-    };
+    std::string temp_path;
+    FileUtil::IOFile file;
+    std::unique_ptr<Common::Compression::ZSTDCompressionStreamBuffer> compressor;
+    bool failed = false;
+
+    /// Header, written again with the final stream size in Finish
+    CTHeader header{};
 
-    std::vector<StreamElement> stream;
+    /// Offset in the uncompressed file
+    u32 file_offset = 0;
 
     /**
      * Internal cache which maps hashes of memory contents to file offsets at which those memory
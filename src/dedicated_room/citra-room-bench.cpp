@@ -0,0 +1,318 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/scm_rev.h"
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options]\n"
+                 "Simulates a local wireless session of several consoles in a room and measures\n"
+                 "how the room keeps up. The first member acts as the session host, which\n"
+                 "broadcasts its data and beacons, the other members send their data to it.\n\n"
+                 "--server            Address of the room to use, a room is hosted when not set\n"
+                 "--port              The port of the room\n"
+                 "--password          The password of the room\n"
+                 "--members           The number of simulated consoles\n"
+                 "--rate              The data packets each console sends per second\n"
+                 "--size              The size of the data packets in bytes\n"
+                 "--duration          The duration of the measurement in seconds\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra room benchmark " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << " Libnetwork: " << Network::network_version << std::endl;
+}
+
+namespace {
+
+/// Identifies the packets sent by the benchmark
+constexpr u32 PayloadMagic = 0x48434E42;
+
+/// Wifi frame data of the benchmark, padded to the packet size
+struct Payload {
+    u32 magic;
+    u32 sender;
+    u64 send_time_ns;
+};
+
+/// Beacons are sent every 100 TU by the session host
+constexpr u32 BeaconsPerSecond = 10;
+constexpr std::size_t BeaconSize = 120;
+
+/// Time to wait for the packets still in flight once sending stopped
+constexpr auto DrainTime = std::chrono::seconds(2);
+
+constexpr auto JoinTimeout = std::chrono::seconds(10);
+
+struct SimulatedConsole {
+    Network::RoomMember member;
+    Network::RoomMember::CallbackHandle<Network::WifiPacket> callback;
+    Network::MacAddress mac_address{};
+    /// Latencies of the received packets, only written by the member's thread
+    std::vector<u64> latencies_ns;
+};
+
+u64 Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+        .count();
+}
+
+Network::WifiPacket MakePacket(Network::WifiPacket::PacketType type, const SimulatedConsole& from,
+                               const Network::MacAddress& to, u32 sender, std::size_t size) {
+    Network::WifiPacket packet{};
+    packet.type = type;
+    packet.data.resize(std::max(size, sizeof(Payload)));
+    const Payload payload{PayloadMagic, sender, Now()};
+    std::memcpy(packet.data.data(), &payload, sizeof(payload));
+    packet.transmitter_address = from.mac_address;
+    packet.destination_address = to;
+    packet.channel = 1;
+    return packet;
+}
+
+double Percentile(const std::vector<u64>& sorted_ns, double percentile) {
+    if (sorted_ns.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(percentile / 100.0 * (sorted_ns.size() - 1));
+    return sorted_ns[index] / 1e6;
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    std::string server;
+    std::string password;
+    u32 port = Network::DefaultRoomPort;
+    u32 num_members = 8;
+    u32 rate = 60;
+    u32 size = 256;
+    u32 duration = 10;
+
+    static struct option long_options[] = {
+        {"server", required_argument, 0, 's'},
+        {"port", required_argument, 0, 'p'},
+        {"password", required_argument, 0, 'w'},
+        {"members", required_argument, 0, 'm'},
+        {"rate", required_argument, 0, 'r'},
+        {"size", required_argument, 0, 'z'},
+        {"duration", required_argument, 0, 'd'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "s:p:w:m:r:z:d:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 's':
+                server.assign(optarg);
+                break;
+            case 'p':
+                port = strtoul(optarg, &endarg, 0);
+                break;
+            case 'w':
+                password.assign(optarg);
+                break;
+            case 'm':
+                num_members = strtoul(optarg, &endarg, 0);
+                break;
+            case 'r':
+                rate = strtoul(optarg, &endarg, 0);
+                break;
+            case 'z':
+                size = strtoul(optarg, &endarg, 0);
+                break;
+            case 'd':
+                duration = strtoul(optarg, &endarg, 0);
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        }
+    }
+
+    if (num_members < 2 || num_members > Network::MaxConcurrentConnections) {
+        std::cout << "members needs to be in the range 2 - " << Network::MaxConcurrentConnections
+                  << "!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (port > 65535) {
+        std::cout << "port needs to be in the range 0 - 65535!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (rate == 0 || duration == 0) {
+        std::cout << "rate and duration need to be at least 1!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    Network::Init();
+
+    // Host the room in this process, so that the time it spends handling the traffic is known
+    std::unique_ptr<Network::Room> room;
+    if (server.empty()) {
+        server = "127.0.0.1";
+        room = std::make_unique<Network::Room>();
+        if (!room->Create("Room benchmark", "", "", static_cast<u16>(port), password,
+                          num_members)) {
+            std::cout << "Failed to create room!\n\n";
+            Network::Shutdown();
+            return -1;
+        }
+    }
+
+    std::vector<std::unique_ptr<SimulatedConsole>> consoles;
+    for (u32 i = 0; i < num_members; i++) {
+        auto& console = *consoles.emplace_back(std::make_unique<SimulatedConsole>());
+        console.callback = console.member.BindOnWifiPacketReceived(
+            [&console](const Network::WifiPacket& packet) {
+                Payload payload;
+                if (packet.data.size() < sizeof(payload)) {
+                    return;
+                }
+                std::memcpy(&payload, packet.data.data(), sizeof(payload));
+                if (payload.magic == PayloadMagic) {
+                    console.latencies_ns.push_back(Now() - payload.send_time_ns);
+                }
+            });
+        console.member.Join(fmt::format("bench{:04}", i), fmt::format("bench-console-{}", i),
+                            server.c_str(), static_cast<u16>(port), 0, Network::NoPreferredMac,
+                            password);
+        const auto join_start = Clock::now();
+        while (console.member.GetState() == Network::RoomMember::State::Joining &&
+               Clock::now() - join_start < JoinTimeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (console.member.GetState() != Network::RoomMember::State::Joined &&
+            console.member.GetState() != Network::RoomMember::State::Moderator) {
+            std::cout << fmt::format("Member {} could not join the room!\n\n", i);
+            for (auto& joined : consoles) {
+                if (joined->member.IsConnected()) {
+                    joined->member.Leave();
+                }
+            }
+            if (room) {
+                room->Destroy();
+            }
+            Network::Shutdown();
+            return -1;
+        }
+        console.mac_address = console.member.GetMacAddress();
+    }
+    std::cout << fmt::format("{} members joined, sending {} packets of {} bytes per second each "
+                             "for {} seconds...\n",
+                             num_members, rate, size, duration);
+
+    const auto room_stats_before = room ? room->GetStatistics() : Network::Room::Statistics{};
+    const std::clock_t cpu_start = std::clock();
+    const auto start = Clock::now();
+
+    // Every tick the host broadcasts its data and the other consoles send theirs to the host
+    const auto tick = std::chrono::nanoseconds(std::chrono::seconds(1)) / rate;
+    const u32 num_ticks = rate * duration;
+    const u32 ticks_per_beacon = std::max(rate / BeaconsPerSecond, 1u);
+    u64 expected_receptions = 0;
+    const SimulatedConsole& host = *consoles[0];
+    for (u32 i = 0; i < num_ticks; i++) {
+        std::this_thread::sleep_until(start + tick * i);
+        if (i % ticks_per_beacon == 0) {
+            consoles[0]->member.SendWifiPacket(MakePacket(Network::WifiPacket::PacketType::Beacon,
+                                                          host, Network::BroadcastMac, 0,
+                                                          BeaconSize));
+            expected_receptions += num_members - 1;
+        }
+        consoles[0]->member.SendWifiPacket(MakePacket(Network::WifiPacket::PacketType::Data, host,
+                                                      Network::BroadcastMac, 0, size));
+        expected_receptions += num_members - 1;
+        for (u32 j = 1; j < num_members; j++) {
+            consoles[j]->member.SendWifiPacket(MakePacket(Network::WifiPacket::PacketType::Data,
+                                                          *consoles[j], host.mac_address, j,
+                                                          size));
+            expected_receptions++;
+        }
+    }
+    const auto sending_time = Clock::now() - start;
+    std::this_thread::sleep_for(DrainTime);
+
+    const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    const auto room_stats = room ? room->GetStatistics() : Network::Room::Statistics{};
+
+    for (auto& console : consoles) {
+        console->member.Unbind(console->callback);
+        console->member.Leave();
+    }
+    if (room) {
+        room->Destroy();
+    }
+    Network::Shutdown();
+
+    std::vector<u64> latencies_ns;
+    for (const auto& console : consoles) {
+        latencies_ns.insert(latencies_ns.end(), console->latencies_ns.begin(),
+                            console->latencies_ns.end());
+    }
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+
+    const double seconds = std::chrono::duration<double>(sending_time).count();
+    const u64 lost = expected_receptions - std::min<u64>(latencies_ns.size(), expected_receptions);
+    std::cout << fmt::format("Received {} of {} packets, {} lost ({:.3f}%)\n", latencies_ns.size(),
+                             expected_receptions, lost,
+                             100.0 * static_cast<double>(lost) / expected_receptions);
+    std::cout << fmt::format("Latency: p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms, "
+                             "max {:.2f} ms\n",
+                             Percentile(latencies_ns, 50), Percentile(latencies_ns, 90),
+                             Percentile(latencies_ns, 99), Percentile(latencies_ns, 100));
+    if (room) {
+        const u64 packets = room_stats.packets_received - room_stats_before.packets_received;
+        const u64 relayed = room_stats.packets_relayed - room_stats_before.packets_relayed;
+        const double handling_seconds =
+            (room_stats.handling_time_ns - room_stats_before.handling_time_ns) / 1e9;
+        std::cout << fmt::format("Room received {:.0f} and relayed {:.0f} packets per second\n",
+                                 packets / seconds, relayed / seconds);
+        std::cout << fmt::format("Room handling time: {:.1f}% of a core, {:.2f} us per received "
+                                 "packet\n",
+                                 100.0 * handling_seconds / seconds,
+                                 packets > 0 ? handling_seconds * 1e6 / packets : 0.0);
+    }
+    std::cout << fmt::format("Process CPU time, including the simulated consoles: {:.1f}% of a "
+                             "core\n",
+                             100.0 * cpu_seconds / seconds);
+    return 0;
+}
@@ -2,14 +2,18 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 #include <cryptopp/base64.h>
+#include <fmt/format.h>
 
 #ifdef _WIN32
 // windows.h needs to be included before shellapi.h
@@ -58,6 +62,11 @@ static void PrintHelp(const char* argv0) {
                  "--ban-list-file     The file for storing the room ban list\n"
                  "--log-file          The file for storing the room log\n"
                  "--enable-citra-mods Allow Citra Community Moderators to moderate on your room\n"
+                 "--room-count        The number of rooms to host, on consecutive ports\n"
+                 "--threads           The number of threads servicing the rooms\n"
+                 "--chat-rate-limit   The chat messages a member may send at once and the\n"
+                 "                    milliseconds after which it may send another, as n:ms\n"
+                 "--game-rate-limit   The same limit for the game changes of a member\n"
                  "-h, --help          Display this help and exit\n"
                  "-v, --version       Output version information and exit\n";
 }
@@ -150,6 +159,21 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     file.flush();
 }
 
+/// Parses a rate limit given as <burst>:<interval in ms>
+static std::optional<Network::RateLimit> ParseRateLimit(const char* text) {
+    char* end;
+    const u32 burst = strtoul(text, &end, 0);
+    if (end == text || *end != ':') {
+        return std::nullopt;
+    }
+    const char* interval_text = end + 1;
+    const u32 interval_ms = strtoul(interval_text, &end, 0);
+    if (end == interval_text || *end != '\0') {
+        return std::nullopt;
+    }
+    return Network::RateLimit{burst, interval_ms};
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
 
@@ -181,6 +205,9 @@ int main(int argc, char** argv) {
     u32 port = Network::DefaultRoomPort;
     u32 max_members = 16;
     bool enable_citra_mods = false;
+    u32 room_count = 1;
+    u32 num_threads = 0;
+    Network::Room::RateLimits rate_limits;
 
     static struct option long_options[] = {
         {"room-name", required_argument, 0, 'n'},
@@ -196,6 +223,10 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citra-mods", no_argument, 0, 'e'},
+        {"room-count", required_argument, 0, 'c'},
+        {"threads", required_argument, 0, 'r'},
+        {"chat-rate-limit", required_argument, 0, 's'},
+        {"game-rate-limit", required_argument, 0, 'x'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -244,6 +275,23 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citra_mods = true;
                 break;
+            case 'c':
+                room_count = strtoul(optarg, &endarg, 0);
+                break;
+            case 'r':
+                num_threads = strtoul(optarg, &endarg, 0);
+                break;
+            case 's':
+            case 'x': {
+                const auto limit = ParseRateLimit(optarg);
+                if (!limit) {
+                    std::cout << "rate limits need to be given as <messages>:<milliseconds>!\n\n";
+                    PrintHelp(argv[0]);
+                    return -1;
+                }
+                (arg == 's' ? rate_limits.chat : rate_limits.game_info) = *limit;
+                break;
+            }
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -279,6 +327,12 @@ int main(int argc, char** argv) {
         PrintHelp(argv[0]);
         return -1;
     }
+    if (room_count == 0 || port + room_count - 1 > 65535) {
+        std::cout << "room-count needs to be at least 1, with all ports in the range 0 - "
+                     "65535!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
     if (ban_list_file.empty()) {
         std::cout << "Ban list file not set!\nThis should get set to load and save room ban "
                      "list.\nSet with --ban-list-file <file>\n\n";
@@ -319,52 +373,120 @@ int main(int argc, char** argv) {
         ban_list = LoadBanList(ban_list_file);
     }
 
-    std::unique_ptr<Network::VerifyUser::Backend> verify_backend;
+#ifndef ENABLE_WEB_SERVICE
     if (announce) {
-#ifdef ENABLE_WEB_SERVICE
-        verify_backend =
-            std::make_unique<WebService::VerifyUserJWT>(NetSettings::values.web_api_url);
-#else
         std::cout
             << "Citra Web Services is not available with this build: validation is disabled.\n\n";
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
-#endif
-    } else {
-        verify_backend = std::make_unique<Network::VerifyUser::NullBackend>();
     }
+#endif
+    const auto make_verify_backend = [announce]() -> std::unique_ptr<Network::VerifyUser::Backend> {
+#ifdef ENABLE_WEB_SERVICE
+        if (announce) {
+            return std::make_unique<WebService::VerifyUserJWT>(NetSettings::values.web_api_url);
+        }
+#endif
+        return std::make_unique<Network::VerifyUser::NullBackend>();
+    };
 
     Network::Init();
-    if (std::shared_ptr<Network::Room> room = Network::GetRoom().lock()) {
-        if (!room->Create(room_name, room_description, "", port, password, max_members, username,
-                          preferred_game, preferred_game_id, std::move(verify_backend), ban_list,
-                          enable_citra_mods)) {
+
+    // A single room keeps its own thread, several rooms share the threads of a pool
+    std::unique_ptr<Network::RoomPool> pool;
+    if (room_count > 1 || num_threads > 0) {
+        const u32 max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        pool = std::make_unique<Network::RoomPool>(
+            std::min(num_threads > 0 ? num_threads : max_threads, room_count));
+    }
+
+    std::vector<std::shared_ptr<Network::Room>> rooms;
+    if (room_count == 1) {
+        rooms.push_back(Network::GetRoom().lock());
+    }
+    while (rooms.size() < room_count) {
+        rooms.push_back(std::make_shared<Network::Room>());
+    }
+
+    std::vector<std::unique_ptr<Network::AnnounceMultiplayerSession>> announce_sessions;
+    for (u32 i = 0; i < room_count; i++) {
+        const std::string name =
+            room_count > 1 ? fmt::format("{} #{}", room_name, i + 1) : room_name;
+        rooms[i]->SetRateLimits(rate_limits);
+        if (!rooms[i]->Create(name, room_description, "", static_cast<u16>(port + i), password,
+                              max_members, username, preferred_game, preferred_game_id,
+                              make_verify_backend(), ban_list, enable_citra_mods, pool.get())) {
             std::cout << "Failed to create room: \n\n";
+            for (u32 j = 0; j < i; j++) {
+                rooms[j]->Destroy();
+            }
             return -1;
         }
-        std::cout << "Room is open. Close with Q+Enter...\n\n";
-        auto announce_session = std::make_unique<Network::AnnounceMultiplayerSession>();
         if (announce) {
-            announce_session->Start();
-        }
-        while (room->GetState() == Network::Room::State::Open) {
-            std::string in;
-            std::cin >> in;
-            if (in.size() > 0) {
-                break;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            auto& session = announce_sessions.emplace_back(
+                std::make_unique<Network::AnnounceMultiplayerSession>(rooms[i]));
+            session->Start();
         }
-        if (announce) {
-            announce_session->Stop();
+    }
+    if (pool) {
+        std::cout << room_count << " rooms are open on ports " << port << " - "
+                  << port + room_count - 1 << ", serviced by " << pool->GetNumThreads()
+                  << " threads. Close with Q+Enter...\n\n";
+    } else {
+        std::cout << "Room is open. Close with Q+Enter...\n\n";
+    }
+
+    const auto any_room_open = [&rooms] {
+        return std::any_of(rooms.begin(), rooms.end(), [](const auto& room) {
+            return room->GetState() == Network::Room::State::Open;
+        });
+    };
+    while (any_room_open()) {
+        std::string in;
+        std::cin >> in;
+        if (in.size() > 0) {
+            break;
         }
-        announce_session.reset();
-        // Save the ban list
-        if (!ban_list_file.empty()) {
-            SaveBanList(room->GetBanList(), ban_list_file);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    for (auto& session : announce_sessions) {
+        session->Stop();
+    }
+    announce_sessions.clear();
+
+    // Save the ban list, which is shared by all rooms
+    if (!ban_list_file.empty()) {
+        Network::Room::BanList merged_ban_list;
+        for (const auto& room : rooms) {
+            const auto [usernames, ips] = room->GetBanList();
+            for (const auto& username : usernames) {
+                if (std::find(merged_ban_list.first.begin(), merged_ban_list.first.end(),
+                              username) == merged_ban_list.first.end()) {
+                    merged_ban_list.first.push_back(username);
+                }
+            }
+            for (const auto& ip : ips) {
+                if (std::find(merged_ban_list.second.begin(), merged_ban_list.second.end(), ip) ==
+                    merged_ban_list.second.end()) {
+                    merged_ban_list.second.push_back(ip);
+                }
+            }
         }
+        SaveBanList(merged_ban_list, ban_list_file);
+    }
+    for (auto& room : rooms) {
+        const auto stats = room->GetStatistics();
+        LOG_INFO(Network,
+                 "{}: received {} packets ({} bytes), relayed {} packets ({} bytes), handling "
+                 "took {} ms",
+                 room->GetRoomInformation().name, stats.packets_received, stats.bytes_received,
+                 stats.packets_relayed, stats.bytes_relayed, stats.handling_time_ns / 1000000);
         room->Destroy();
     }
+    rooms.clear();
+    pool.reset();
     Network::Shutdown();
+#ifdef ENABLE_WEB_SERVICE
+    WebService::Shutdown();
+#endif
     detached_tasks.WaitForAllTasks();
     return 0;
 }
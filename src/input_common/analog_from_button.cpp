@@ -13,23 +13,24 @@ public:
     Analog(Button up_, Button down_, Button left_, Button right_, Button modifier_,
            float modifier_scale_)
         : up(std::move(up_)), down(std::move(down_)), left(std::move(left_)),
-          right(std::move(right_)), modifier(std::move(modifier_)),
-          modifier_scale(modifier_scale_) {}
+          right(std::move(right_)), modifier(std::move(modifier_)), up_reader(*up),
+          down_reader(*down), left_reader(*left), right_reader(*right),
+          modifier_reader(*modifier), modifier_scale(modifier_scale_) {}
 
     std::tuple<float, float> GetStatus() const override {
         constexpr float SQRT_HALF = 0.707106781f;
         int x = 0, y = 0;
 
-        if (right->GetStatus())
+        if (right_reader.GetStatus())
             ++x;
-        if (left->GetStatus())
+        if (left_reader.GetStatus())
             --x;
-        if (up->GetStatus())
+        if (up_reader.GetStatus())
             ++y;
-        if (down->GetStatus())
+        if (down_reader.GetStatus())
             --y;
 
-        float coef = modifier->GetStatus() ? modifier_scale : 1.0f;
+        float coef = modifier_reader.GetStatus() ? modifier_scale : 1.0f;
         return std::make_tuple(x * coef * (y == 0 ? 1.0f : SQRT_HALF),
                                y * coef * (x == 0 ? 1.0f : SQRT_HALF));
     }
@@ -40,6 +41,11 @@ private:
     Button left;
     Button right;
     Button modifier;
+    Input::ButtonReader up_reader;
+    Input::ButtonReader down_reader;
+    Input::ButtonReader left_reader;
+    Input::ButtonReader right_reader;
+    Input::ButtonReader modifier_reader;
     float modifier_scale;
 };
 
@@ -89,7 +89,7 @@ void Adapter::UpdateControllers(const AdapterPayload& adapter_payload) {
         const std::size_t offset = 1 + (9 * port);
         const auto type = static_cast<ControllerTypes>(adapter_payload[offset] >> 4);
         UpdatePadType(port, type);
-        if (DeviceConnected(port)) {
+        if (pads[port].type != ControllerTypes::None) {
             const u8 b1 = adapter_payload[offset + 1];
             const u8 b2 = adapter_payload[offset + 2];
             UpdateStateButtons(port, b1, b2);
@@ -98,9 +98,14 @@ void Adapter::UpdateControllers(const AdapterPayload& adapter_payload) {
                 UpdateSettings(port);
             }
         }
+        PublishPadState(port);
     }
 }
 
+void Adapter::PublishPadState(std::size_t port) {
+    pad_states[port].Store(pads[port]);
+}
+
 void Adapter::UpdatePadType(std::size_t port, ControllerTypes pad_type) {
     if (pads[port].type == pad_type) {
         return;
@@ -328,6 +333,7 @@ void Adapter::ResetDevice(std::size_t port) {
     pads[port].last_button = PadButton::Undefined;
     pads[port].axis_values.fill(0);
     pads[port].axis_origin.fill(255);
+    PublishPadState(port);
 }
 
 std::vector<Common::ParamPackage> Adapter::GetInputDevices() const {
@@ -347,7 +353,7 @@ std::vector<Common::ParamPackage> Adapter::GetInputDevices() const {
 }
 
 bool Adapter::DeviceConnected(std::size_t port) const {
-    return pads[port].type != ControllerTypes::None;
+    return GetPadState(port).type != ControllerTypes::None;
 }
 
 void Adapter::BeginConfiguration() {
@@ -368,12 +374,8 @@ const Common::SPSCQueue<GCPadStatus>& Adapter::GetPadQueue() const {
     return pad_queue;
 }
 
-GCController& Adapter::GetPadState(std::size_t port) {
-    return pads.at(port);
-}
-
-const GCController& Adapter::GetPadState(std::size_t port) const {
-    return pads.at(port);
+GCController Adapter::GetPadState(std::size_t port) const {
+    return pad_states.at(port).Load();
 }
 
 } // namespace GCAdapter
@@ -12,6 +12,7 @@
 #include <unordered_map>
 #include <vector>
 #include "common/common_types.h"
+#include "common/seqlock.h"
 #include "common/threadsafe_queue.h"
 
 struct libusb_context;
@@ -88,8 +89,8 @@ public:
     Common::SPSCQueue<GCPadStatus>& GetPadQueue();
     const Common::SPSCQueue<GCPadStatus>& GetPadQueue() const;
 
-    GCController& GetPadState(std::size_t port);
-    const GCController& GetPadState(std::size_t port) const;
+    /// Returns a consistent copy of the latest state of the pad, without blocking the input thread
+    GCController GetPadState(std::size_t port) const;
 
     /// Returns true if there is a device connected to port
     bool DeviceConnected(std::size_t port) const;
@@ -104,6 +105,7 @@ private:
     void UpdateSettings(std::size_t port);
     void UpdateStateButtons(std::size_t port, u8 b1, u8 b2);
     void UpdateStateAxes(std::size_t port, const AdapterPayload& adapter_payload);
+    void PublishPadState(std::size_t port);
 
     void AdapterInputThread();
 
@@ -134,7 +136,10 @@ private:
     void ClearLibusbHandle();
 
     libusb_device_handle* usb_adapter_handle = nullptr;
+    /// State of the pads, only accessed by the thread that talks to the adapter
     std::array<GCController, 4> pads;
+    /// Copies of the pads that are read by the input devices
+    std::array<Common::SeqLock<GCController>, 4> pad_states;
     Common::SPSCQueue<GCPadStatus> pad_queue;
 
     std::thread adapter_input_thread;
@@ -4,7 +4,6 @@
 
 #include <atomic>
 #include <list>
-#include <mutex>
 #include <utility>
 #include "common/assert.h"
 #include "common/threadsafe_queue.h"
@@ -41,10 +40,8 @@ public:
     ~GCButton() override;
 
     bool GetStatus() const override {
-        if (gcadapter->DeviceConnected(port)) {
-            return (gcadapter->GetPadState(port).buttons & button) != 0;
-        }
-        return false;
+        const GCAdapter::GCController pad = gcadapter->GetPadState(port);
+        return pad.type != GCAdapter::ControllerTypes::None && (pad.buttons & button) != 0;
     }
 
 private:
@@ -61,8 +58,9 @@ public:
           gcadapter(adapter) {}
 
     bool GetStatus() const override {
-        if (gcadapter->DeviceConnected(port)) {
-            const float current_axis_value = gcadapter->GetPadState(port).axis_values.at(axis);
+        const GCAdapter::GCController pad = gcadapter->GetPadState(port);
+        if (pad.type != GCAdapter::ControllerTypes::None) {
+            const float current_axis_value = pad.axis_values.at(axis);
             const float axis_value = current_axis_value / 128.0f;
             if (trigger_if_greater) {
                 return axis_value > threshold;
@@ -173,19 +171,19 @@ public:
                       const GCAdapter::Adapter* adapter)
         : port(port_), axis_x(axis_x_), axis_y(axis_y_), deadzone(deadzone_), gcadapter(adapter) {}
 
-    float GetAxis(u32 axis) const {
-        if (gcadapter->DeviceConnected(port)) {
-            std::lock_guard lock{mutex};
-            const auto axis_value =
-                static_cast<float>(gcadapter->GetPadState(port).axis_values.at(axis));
+    static float GetAxis(const GCAdapter::GCController& pad, u32 axis) {
+        if (pad.type != GCAdapter::ControllerTypes::None) {
+            const auto axis_value = static_cast<float>(pad.axis_values.at(axis));
             return (axis_value) / 50.0f;
         }
         return 0.0f;
     }
 
     std::pair<float, float> GetAnalog(u32 analog_axis_x, u32 analog_axis_y) const {
-        float x = GetAxis(analog_axis_x);
-        float y = GetAxis(analog_axis_y);
+        // Both axes come from the same snapshot of the pad
+        const GCAdapter::GCController pad = gcadapter->GetPadState(port);
+        float x = GetAxis(pad, analog_axis_x);
+        float y = GetAxis(pad, analog_axis_y);
         // Make sure the coordinates are in the unit circle,
         // otherwise normalize it.
         float r = x * x + y * y;
@@ -214,7 +212,6 @@ private:
     const u32 axis_y;
     const float deadzone;
     const GCAdapter::Adapter* gcadapter;
-    mutable std::mutex mutex;
 };
 
 /// An analog device factory that creates analog devices from GC Adapter
@@ -21,6 +21,10 @@ public:
         return status.load();
     }
 
+    const std::atomic<bool>* GetStatusFlag() const override {
+        return &status;
+    }
+
     friend class KeyButtonList;
 
 private:
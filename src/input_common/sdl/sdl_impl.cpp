@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cmath>
 #include <functional>
@@ -19,6 +20,7 @@
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/param_package.h"
+#include "common/seqlock.h"
 #include "common/threadsafe_queue.h"
 #include "core/frontend/input.h"
 #include "input_common/sdl/sdl_impl.h"
@@ -128,23 +130,31 @@ public:
         : guid{std::move(guid_)}, port{port_}, sdl_joystick{joystick} {}
 
     void SetButton(int button, bool value) {
-        std::lock_guard lock{mutex};
-        state.buttons[button] = value;
+        if (IsValidIndex(button)) {
+            state.buttons[button].store(value, std::memory_order_relaxed);
+        }
     }
 
     bool GetButton(int button) const {
-        std::lock_guard lock{mutex};
-        return state.buttons.at(button);
+        return IsValidIndex(button) && state.buttons[button].load(std::memory_order_relaxed);
+    }
+
+    /// Returns the flag GetButton reads, null if the button doesn't exist
+    const std::atomic<bool>* GetButtonFlag(int button) const {
+        return IsValidIndex(button) ? &state.buttons[button] : nullptr;
     }
 
     void SetAxis(int axis, Sint16 value) {
-        std::lock_guard lock{mutex};
-        state.axes[axis] = value;
+        if (IsValidIndex(axis)) {
+            state.axes[axis].store(value, std::memory_order_relaxed);
+        }
     }
 
     float GetAxis(int axis) const {
-        std::lock_guard lock{mutex};
-        return state.axes.at(axis) / 32767.0f;
+        if (!IsValidIndex(axis)) {
+            return 0.0f;
+        }
+        return state.axes[axis].load(std::memory_order_relaxed) / 32767.0f;
     }
 
     std::tuple<float, float> GetAnalog(int axis_x, int axis_y) const {
@@ -165,30 +175,29 @@ public:
     }
 
     void SetHat(int hat, Uint8 direction) {
-        std::lock_guard lock{mutex};
-        state.hats[hat] = direction;
+        if (IsValidIndex(hat)) {
+            state.hats[hat].store(direction, std::memory_order_relaxed);
+        }
     }
 
     bool GetHatDirection(int hat, Uint8 direction) const {
-        std::lock_guard lock{mutex};
-        return (state.hats.at(hat) & direction) != 0;
+        return IsValidIndex(hat) &&
+               (state.hats[hat].load(std::memory_order_relaxed) & direction) != 0;
     }
 
     void SetAccel(const float x, const float y, const float z) {
-        std::lock_guard lock{mutex};
-        state.accel.x = x;
-        state.accel.y = y;
-        state.accel.z = z;
+        std::lock_guard lock{motion_mutex};
+        written_motion.accel = {x, y, z};
+        state.motion.Store(written_motion);
     }
     void SetGyro(const float pitch, const float yaw, const float roll) {
-        std::lock_guard lock{mutex};
-        state.gyro.x = pitch;
-        state.gyro.y = yaw;
-        state.gyro.z = roll;
+        std::lock_guard lock{motion_mutex};
+        written_motion.gyro = {pitch, yaw, roll};
+        state.motion.Store(written_motion);
     }
     std::tuple<Common::Vec3<float>, Common::Vec3<float>> GetMotion() const {
-        std::lock_guard lock{mutex};
-        return std::make_tuple(state.accel, state.gyro);
+        const Motion motion = state.motion.Load();
+        return std::make_tuple(motion.accel, motion.gyro);
     }
 
     /**
@@ -218,17 +227,31 @@ public:
     }
 
 private:
-    struct State {
-        std::unordered_map<int, bool> buttons;
-        std::unordered_map<int, Sint16> axes;
-        std::unordered_map<int, Uint8> hats;
+    /// SDL events index the buttons, axes and hats with a Uint8
+    static constexpr int MaxIndex = 256;
+
+    static bool IsValidIndex(int index) {
+        return index >= 0 && index < MaxIndex;
+    }
+
+    struct Motion {
         Common::Vec3<float> accel;
         Common::Vec3<float> gyro;
+    };
+
+    /// Written from the thread pumping the SDL events and read by the input devices without locks
+    struct State {
+        std::array<std::atomic<bool>, MaxIndex> buttons{};
+        std::array<std::atomic<Sint16>, MaxIndex> axes{};
+        std::array<std::atomic<Uint8>, MaxIndex> hats{};
+        Common::SeqLock<Motion> motion;
     } state;
+    /// Serializes the motion writers, as the events can be pumped from more than one thread
+    std::mutex motion_mutex;
+    Motion written_motion{};
     std::string guid;
     int port;
     std::unique_ptr<SDL_Joystick, SDLJoystickDeleter> sdl_joystick;
-    mutable std::mutex mutex;
 };
 
 struct SDLGameControllerDeleter {
@@ -644,6 +667,10 @@ public:
         return joystick->GetButton(button);
     }
 
+    const std::atomic<bool>* GetStatusFlag() const override {
+        return joystick->GetButtonFlag(button);
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int button;
@@ -761,8 +788,6 @@ public:
             } else {
                 direction = 0;
             }
-            // This is necessary so accessing GetHat with hat won't crash
-            joystick->SetHat(hat, SDL_HAT_CENTERED);
             return std::make_unique<SDLDirectionButton>(joystick, hat, direction);
         }
 
@@ -779,14 +804,10 @@ public:
                 trigger_if_greater = true;
                 LOG_ERROR(Input, "Unknown direction {}", direction_name);
             }
-            // This is necessary so accessing GetAxis with axis won't crash
-            joystick->SetAxis(axis, 0);
             return std::make_unique<SDLAxisButton>(joystick, axis, threshold, trigger_if_greater);
         }
 
         const int button = params.Get("button", 0);
-        // This is necessary so accessing GetButton with button won't crash
-        joystick->SetButton(button, false);
         return std::make_unique<SDLButton>(joystick, button);
     }
 
@@ -815,9 +836,6 @@ public:
 
         auto joystick = state.GetSDLJoystickByGUID(guid, port);
 
-        // This is necessary so accessing GetAxis with axis_x and axis_y won't crash
-        joystick->SetAxis(axis_x, 0);
-        joystick->SetAxis(axis_y, 0);
         return std::make_unique<SDLAnalog>(joystick, axis_x, axis_y, deadzone);
     }
 
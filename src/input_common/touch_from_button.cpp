@@ -18,27 +18,34 @@ public:
                  .buttons) {
 
             const Common::ParamPackage package{config_entry};
-            map.emplace_back(Input::CreateDevice<Input::ButtonDevice>(config_entry),
-                             std::clamp(package.Get("x", 0), 0, Core::kScreenBottomWidth),
-                             std::clamp(package.Get("y", 0), 0, Core::kScreenBottomHeight));
+            auto button = Input::CreateDevice<Input::ButtonDevice>(config_entry);
+            const Input::ButtonReader reader{*button};
+            const int x = std::clamp(package.Get("x", 0), 0, Core::kScreenBottomWidth);
+            const int y = std::clamp(package.Get("y", 0), 0, Core::kScreenBottomHeight);
+            map.push_back({std::move(button), reader,
+                           static_cast<float>(x) / Core::kScreenBottomWidth,
+                           static_cast<float>(y) / Core::kScreenBottomHeight});
         }
     }
 
     std::tuple<float, float, bool> GetStatus() const override {
-        for (const auto& m : map) {
-            const bool state = std::get<0>(m)->GetStatus();
-            if (state) {
-                const float x = static_cast<float>(std::get<1>(m)) / Core::kScreenBottomWidth;
-                const float y = static_cast<float>(std::get<2>(m)) / Core::kScreenBottomHeight;
-                return {x, y, true};
+        for (const auto& entry : map) {
+            if (entry.reader.GetStatus()) {
+                return {entry.x, entry.y, true};
             }
         }
         return {};
     }
 
 private:
-    // A vector of the mapped button, its x and its y-coordinate
-    std::vector<std::tuple<std::unique_ptr<Input::ButtonDevice>, int, int>> map;
+    struct Entry {
+        std::unique_ptr<Input::ButtonDevice> button;
+        Input::ButtonReader reader;
+        /// Position of the touch, normalized to the bottom screen
+        float x;
+        float y;
+    };
+    std::vector<Entry> map;
 };
 
 std::unique_ptr<Input::TouchDevice> TouchFromButtonFactory::Create(
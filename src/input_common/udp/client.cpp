@@ -169,34 +169,38 @@ void Client::OnPadData(Response::PadData data) {
     // Due to differences between the 3ds and cemuhookudp motion directions, we need to invert
     // accel.x and accel.z and also invert pitch and yaw. See
     // https://github.com/citra-emu/citra/pull/4049 for more details on gyro/accel
-    Common::Vec3f accel = Common::MakeVec<float>(-data.accel.x, data.accel.y, -data.accel.z);
-    Common::Vec3f gyro = Common::MakeVec<float>(-data.gyro.pitch, -data.gyro.yaw, data.gyro.roll);
-    {
+    pad_state.accel = Common::MakeVec<float>(-data.accel.x, data.accel.y, -data.accel.z);
+    pad_state.gyro = Common::MakeVec<float>(-data.gyro.pitch, -data.gyro.yaw, data.gyro.roll);
+
+    // High rate controllers send several samples per emulated input poll, sum them up so that
+    // none of the motion is lost. Longer gaps, such as the controller reconnecting, are skipped.
+    constexpr u64 MaxMotionGapUs = 100'000;
+    if (motion_timestamp != 0 && data.motion_timestamp > motion_timestamp) {
+        const u64 delta_us = std::min<u64>(data.motion_timestamp - motion_timestamp,
+                                           MaxMotionGapUs);
+        const double delta = static_cast<double>(delta_us) / 1'000'000.0;
+        pad_state.integrated_gyro += pad_state.gyro.Cast<double>() * delta;
+        pad_state.integrated_time += delta;
+    }
+    motion_timestamp = data.motion_timestamp;
+
+    // TODO: add a setting for "click" touch. Click touch refers to a device that differentiates
+    // between a simple "tap" and a hard press that causes the touch screen to click.
+    pad_state.touch_active = data.touch_1.is_active != 0;
+    pad_state.touch_x = 0;
+    pad_state.touch_y = 0;
+    if (pad_state.touch_active) {
         std::lock_guard guard(status->update_mutex);
-
-        status->motion_status = {accel, gyro};
-
-        // TODO: add a setting for "click" touch. Click touch refers to a device that differentiates
-        // between a simple "tap" and a hard press that causes the touch screen to click.
-        const bool is_active = data.touch_1.is_active != 0;
-
-        float x = 0;
-        float y = 0;
-
-        if (is_active && status->touch_calibration) {
-            const u16 min_x = status->touch_calibration->min_x;
-            const u16 max_x = status->touch_calibration->max_x;
-            const u16 min_y = status->touch_calibration->min_y;
-            const u16 max_y = status->touch_calibration->max_y;
-
-            x = (std::clamp(static_cast<u16>(data.touch_1.x), min_x, max_x) - min_x) /
-                static_cast<float>(max_x - min_x);
-            y = (std::clamp(static_cast<u16>(data.touch_1.y), min_y, max_y) - min_y) /
-                static_cast<float>(max_y - min_y);
+        if (const auto& calibration = status->touch_calibration) {
+            const auto scale = [](u16 value, u16 min, u16 max) {
+                return (std::clamp(value, min, max) - min) / static_cast<float>(max - min);
+            };
+            pad_state.touch_x = scale(data.touch_1.x, calibration->min_x, calibration->max_x);
+            pad_state.touch_y = scale(data.touch_1.y, calibration->min_y, calibration->max_y);
         }
-
-        status->touch_status = {x, y, is_active};
     }
+
+    status->pad_state.Store(pad_state);
 }
 
 void Client::StartCommunication(const std::string& host, u16 port, u8 pad_index, u32 client_id) {
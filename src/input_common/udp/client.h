@@ -12,6 +12,7 @@
 #include <thread>
 #include <tuple>
 #include "common/common_types.h"
+#include "common/seqlock.h"
 #include "common/thread.h"
 #include "common/vector_math.h"
 
@@ -29,9 +30,23 @@ struct Version;
 } // namespace Response
 
 struct DeviceStatus {
+    /// Latest state of the pad, written by the client for every pad data packet
+    struct PadState {
+        Common::Vec3<float> accel;
+        Common::Vec3<float> gyro;
+        /// Gyro summed over the motion timestamps, so that readers can average the rate of all
+        /// the samples received between two of their reads
+        Common::Vec3<double> integrated_gyro;
+        /// Seconds of motion that the gyro was summed over
+        double integrated_time;
+        float touch_x;
+        float touch_y;
+        bool touch_active;
+    };
+    Common::SeqLock<PadState> pad_state;
+
+    /// Guards the touch calibration
     std::mutex update_mutex;
-    std::tuple<Common::Vec3<float>, Common::Vec3<float>> motion_status;
-    std::tuple<float, float, bool> touch_status;
 
     // calibration data for scaling the device's touch area to 3ds
     struct CalibrationData {
@@ -61,6 +76,9 @@ private:
     std::shared_ptr<DeviceStatus> status;
     std::thread thread;
     u64 packet_sequence = 0;
+    /// Copy of the pad state, only accessed by the socket thread
+    DeviceStatus::PadState pad_state{};
+    u64 motion_timestamp = 0;
 };
 
 /// An async job allowing configuration of the touchpad calibration.
@@ -17,8 +17,8 @@ class UDPTouchDevice final : public Input::TouchDevice {
 public:
     explicit UDPTouchDevice(std::shared_ptr<DeviceStatus> status_) : status(std::move(status_)) {}
     std::tuple<float, float, bool> GetStatus() const override {
-        std::lock_guard guard(status->update_mutex);
-        return status->touch_status;
+        const auto state = status->pad_state.Load();
+        return {state.touch_x, state.touch_y, state.touch_active};
     }
 
 private:
@@ -29,12 +29,22 @@ class UDPMotionDevice final : public Input::MotionDevice {
 public:
     explicit UDPMotionDevice(std::shared_ptr<DeviceStatus> status_) : status(std::move(status_)) {}
     std::tuple<Common::Vec3<float>, Common::Vec3<float>> GetStatus() const override {
-        std::lock_guard guard(status->update_mutex);
-        return status->motion_status;
+        const auto state = status->pad_state.Load();
+        Common::Vec3<float> gyro = state.gyro;
+        const double elapsed = state.integrated_time - previous_integrated_time;
+        if (elapsed > 0.0) {
+            // Use the average rate since the previous poll, instead of only the latest sample
+            gyro = ((state.integrated_gyro - previous_integrated_gyro) / elapsed).Cast<float>();
+        }
+        previous_integrated_gyro = state.integrated_gyro;
+        previous_integrated_time = state.integrated_time;
+        return {state.accel, gyro};
     }
 
 private:
     std::shared_ptr<DeviceStatus> status;
+    mutable Common::Vec3<double> previous_integrated_gyro{};
+    mutable double previous_integrated_time = 0.0;
 };
 
 class UDPTouchFactory final : public Input::Factory<Input::TouchDevice> {
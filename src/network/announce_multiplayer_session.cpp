@@ -30,8 +30,18 @@ AnnounceMultiplayerSession::AnnounceMultiplayerSession() {
 #endif
 }
 
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(std::weak_ptr<Room> room)
+    : AnnounceMultiplayerSession() {
+    announced_room = std::move(room);
+    use_global_room = false;
+}
+
+std::shared_ptr<Room> AnnounceMultiplayerSession::LockRoom() const {
+    return use_global_room ? Network::GetRoom().lock() : announced_room.lock();
+}
+
 Common::WebResult AnnounceMultiplayerSession::Register() {
-    std::shared_ptr<Network::Room> room = Network::GetRoom().lock();
+    std::shared_ptr<Network::Room> room = LockRoom();
     if (!room) {
         return Common::WebResult{Common::WebResult::Code::LibError, "Network is not initialized"};
     }
@@ -120,7 +130,7 @@ void AnnounceMultiplayerSession::AnnounceMultiplayerLoop() {
     std::future<Common::WebResult> future;
     while (!shutdown_event.WaitUntil(update_time)) {
         update_time += announce_time_interval;
-        std::shared_ptr<Network::Room> room = Network::GetRoom().lock();
+        std::shared_ptr<Network::Room> room = LockRoom();
         if (!room) {
             break;
         }
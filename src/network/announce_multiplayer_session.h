@@ -26,7 +26,10 @@ class Room;
 class AnnounceMultiplayerSession : NonCopyable {
 public:
     using CallbackHandle = std::shared_ptr<std::function<void(const Common::WebResult&)>>;
+    /// Announces the room of Network::GetRoom
     AnnounceMultiplayerSession();
+    /// Announces the given room, for servers hosting more than one
+    explicit AnnounceMultiplayerSession(std::weak_ptr<Room> room);
     ~AnnounceMultiplayerSession();
 
     /**
@@ -87,6 +90,10 @@ private:
 
     std::atomic_bool registered = false; ///< Whether the room has been registered
 
+    std::weak_ptr<Room> announced_room; ///< The announced room, when not the global one
+    bool use_global_room = true;
+
+    std::shared_ptr<Room> LockRoom() const;
     void UpdateBackendData(std::shared_ptr<Network::Room> room);
     void AnnounceMultiplayerLoop();
 };
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <type_traits>
 #include <vector>
 #include "common/common_types.h"
 
@@ -122,6 +123,16 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
     // First extract the size
     u32 size = 0;
     *this >> size;
+    if constexpr (std::is_same_v<T, u8> || std::is_same_v<T, s8>) {
+        // Bytes have no endianness and are copied at once
+        if (!CheckSize(size)) {
+            out_data.clear();
+            return *this;
+        }
+        out_data.resize(size);
+        Read(out_data.data(), size);
+        return *this;
+    }
     out_data.resize(size);
 
     // Then extract the data
@@ -135,6 +146,10 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator>>(std::array<T, S>& out_data) {
+    if constexpr (std::is_same_v<T, u8> || std::is_same_v<T, s8>) {
+        Read(out_data.data(), S);
+        return *this;
+    }
     for (std::size_t i = 0; i < out_data.size(); ++i) {
         T character;
         *this >> character;
@@ -147,6 +162,10 @@ template <typename T>
 Packet& Packet::operator<<(const std::vector<T>& in_data) {
     // First insert the size
     *this << static_cast<u32>(in_data.size());
+    if constexpr (std::is_same_v<T, u8> || std::is_same_v<T, s8>) {
+        Append(in_data.data(), in_data.size());
+        return *this;
+    }
 
     // Then insert the data
     for (std::size_t i = 0; i < in_data.size(); ++i) {
@@ -4,13 +4,18 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <iomanip>
 #include <mutex>
 #include <random>
 #include <regex>
+#include <shared_mutex>
 #include <sstream>
 #include <thread>
 #include "common/logging/log.h"
+#include "common/zstd_compression.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room.h"
@@ -18,6 +23,29 @@
 
 namespace Network {
 
+/**
+ * Checks a message against a rate limit with the generic cell rate algorithm, accounting for it if
+ * it is within the limit.
+ * @param limit The rate limit of the kind of message
+ * @param full_burst_time Time at which the sender is allowed its full burst again
+ * @param now The time the message was received at
+ * @return Whether the message is within the limit
+ */
+static bool IsWithinRateLimit(const RateLimit& limit,
+                              std::chrono::steady_clock::time_point& full_burst_time,
+                              std::chrono::steady_clock::time_point now) {
+    if (limit.interval_ms == 0) {
+        return true;
+    }
+    const std::chrono::milliseconds interval{limit.interval_ms};
+    const auto start = std::max(full_burst_time, now);
+    if (start - now > interval * (std::max(limit.burst, 1u) - 1)) {
+        return false;
+    }
+    full_burst_time = start + interval;
+    return true;
+}
+
 class Room::RoomImpl {
 public:
     // This MAC address is used to generate a 'Nintendo' like Mac address.
@@ -42,11 +70,18 @@ public:
         /// Data of the user, often including authenticated forum username.
         VerifyUser::UserData user_data;
         ENetPeer* peer; ///< The remote peer.
+
+        // The rate limiting state, only used by the thread servicing the room
+        std::chrono::steady_clock::time_point chat_full_burst_time{};
+        std::chrono::steady_clock::time_point game_info_full_burst_time{};
+        /// Whether the other members have yet to be told about the change of game_info
+        bool game_info_pending = false;
     };
     using MemberList = std::vector<Member>;
-    MemberList members;              ///< Information about the members of this room
-    mutable std::mutex member_mutex; ///< Mutex for locking the members list
-    /// This should be a std::shared_mutex as soon as C++17 is supported
+    MemberList members; ///< Information about the members of this room
+    /// Mutex for locking the members list. Only the thread servicing the room modifies the list,
+    /// the packet fan-out and the queries from other threads share it.
+    mutable std::shared_mutex member_mutex;
 
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
@@ -58,13 +93,32 @@ public:
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> room_thread;
 
+    /// Pool servicing the room instead of room_thread
+    RoomPool* pool = nullptr;
+
+    /// Traffic counters, only incremented by the thread servicing the room
+    std::atomic<u64> packets_received{0};
+    std::atomic<u64> bytes_received{0};
+    std::atomic<u64> packets_relayed{0};
+    std::atomic<u64> bytes_relayed{0};
+    std::atomic<u64> handling_time_ns{0};
+
     /// Verification backend of the room
     std::unique_ptr<VerifyUser::Backend> verify_backend;
 
+    /// Limits on the messages of each member
+    RateLimits rate_limits;
+
     /// Thread function that will receive and dispatch messages until the room is destroyed.
     void ServerLoop();
     void StartLoop();
 
+    /**
+     * Waits up to timeout_ms for a network event and dispatches it.
+     * @return Whether an event was dispatched
+     */
+    bool ServiceEvent(u32 timeout_ms);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -199,22 +253,66 @@ public:
                            const std::string& username, const std::string& ip);
 
     /**
-     * Sends the information about the room, along with the list of members
-     * to every connected client in the room.
+     * Creates the ENet packet of a message for the control channel, compressing it if it is
+     * larger than CompressionThreshold.
+     */
+    ENetPacket* CreateControlPacket(const Packet& packet);
+
+    /**
+     * Sends a message to the client on the control channel.
+     */
+    void SendControlPacket(ENetPeer* client, const Packet& packet);
+
+    /**
+     * Sends a message to all members except the given one on the control channel. member_mutex
+     * must be held.
+     */
+    void BroadcastControlPacket(const Packet& packet, const ENetPeer* except = nullptr);
+
+    /**
+     * Appends the information about a member that is sent to the other members.
+     * The information has the structure:
+     * <String> nickname
+     * <MacAddress> mac_address
+     * <String> game_name
+     * <u64> game_id
+     * <String> username
+     * <String> display_name
+     * <String> avatar_url
+     */
+    void AppendMemberInformation(Packet& packet, const Member& member) const;
+
+    /**
+     * Sends the information about the room, along with the list of members, to a client that
+     * joined the room. The other members are kept up to date with IdMemberListUpdate messages.
      * The packet has the structure:
      * <MessageID>ID_ROOM_INFORMATION
      * <String> room_name
      * <String> room_description
      * <u32> member_slots: The max number of clients allowed in this room
-     * <String> uid
      * <u16> port
+     * <String> preferred_game
+     * <String> host_username
      * <u32> num_members: the number of currently joined clients
-     * This is followed by the following three values for each member:
-     * <String> nickname of that member
-     * <MacAddress> mac_address of that member
-     * <String> game_name of that member
+     * This is followed by the information about each member.
+     */
+    void SendRoomInformation(ENetPeer* client);
+
+    /**
+     * Creates the message telling the members that a member joined or changed, followed by the
+     * information about it.
+     */
+    Packet CreateMemberUpdate(MemberListUpdateTypes type, const Member& member) const;
+
+    /**
+     * Tells all members that the member with the nickname left the room.
+     */
+    void BroadcastMemberRemoved(const std::string& nickname);
+
+    /**
+     * Announces the game changes that were held back by the rate limit, once it allows.
      */
-    void BroadcastRoomInformation();
+    void SendPendingUpdates();
 
     /**
      * Generates a free MAC address to assign to a new client.
@@ -223,7 +321,8 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Broadcasts this packet to all members except the sender. The received packet itself is
+     * queued to the recipients, ENet destroys it once it has been sent to all of them.
      * @param event The ENet event containing the data
      */
     void HandleWifiPacket(const ENetEvent* event);
@@ -250,59 +349,76 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 16) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
-        }
+        ServiceEvent(16);
+        SendPendingUpdates();
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+bool Room::RoomImpl::ServiceEvent(u32 timeout_ms) {
+    ENetEvent event;
+    if (enet_host_service(server, &event, timeout_ms) <= 0) {
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        packets_received.fetch_add(1, std::memory_order_relaxed);
+        bytes_received.fetch_add(event.packet->dataLength, std::memory_order_relaxed);
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(&event);
+            break;
+        case IdSetGameInfo:
+            HandleGameNamePacket(&event);
+            break;
+        case IdWifiPacket:
+            HandleWifiPacket(&event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        // Packets that were forwarded are referenced by the recipients' queues
+        if (event.packet->referenceCount == 0) {
+            enet_packet_destroy(event.packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+    const auto handling_time = std::chrono::steady_clock::now() - start;
+    handling_time_ns.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(handling_time).count(),
+        std::memory_order_relaxed);
+    return true;
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
 
 void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     {
-        std::lock_guard lock(member_mutex);
+        std::shared_lock lock(member_mutex);
         if (members.size() >= room_information.member_slots) {
             SendRoomIsFull(event->peer);
             return;
@@ -401,13 +517,18 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     // Notify everyone that the user has joined.
     SendStatusMessage(IdMemberJoin, member.nickname, member.user_data.username, ip);
 
+    const Packet member_update = CreateMemberUpdate(IdMemberAdded, member);
     {
         std::lock_guard lock(member_mutex);
         members.push_back(std::move(member));
     }
 
-    // Notify everyone that the room information has changed.
-    BroadcastRoomInformation();
+    // The new member gets the whole member list, everyone else only the new member
+    SendRoomInformation(event->peer);
+    {
+        std::shared_lock lock(member_mutex);
+        BroadcastControlPacket(member_update, event->peer);
+    }
     if (HasModPermission(event->peer)) {
         SendJoinSuccessAsMod(event->peer, preferred_mac);
     } else {
@@ -454,7 +575,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberKicked, nickname, username, ip);
-    BroadcastRoomInformation();
+    BroadcastMemberRemoved(nickname);
 }
 
 void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
@@ -515,7 +636,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberBanned, nickname, username, ip);
-    BroadcastRoomInformation();
+    BroadcastMemberRemoved(nickname);
 }
 
 void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
@@ -571,28 +692,28 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
     if (!std::regex_match(nickname, nickname_regex))
         return false;
 
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     return std::all_of(members.begin(), members.end(),
                        [&nickname](const auto& member) { return member.nickname != nickname; });
 }
 
 bool Room::RoomImpl::IsValidMacAddress(const MacAddress& address) const {
     // A MAC address is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     return std::all_of(members.begin(), members.end(),
                        [&address](const auto& member) { return member.mac_address != address; });
 }
 
 bool Room::RoomImpl::IsValidConsoleId(const std::string& console_id_hash) const {
     // A Console ID is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     return std::all_of(members.begin(), members.end(), [&console_id_hash](const auto& member) {
         return member.console_id_hash != console_id_hash;
     });
 }
 
 bool Room::RoomImpl::HasModPermission(const ENetPeer* client) const {
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     const auto sending_member =
         std::find_if(members.begin(), members.end(),
                      [client](const auto& member) { return member.peer == client; });
@@ -616,50 +737,35 @@ void Room::RoomImpl::SendNameCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdNameCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendMacCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdMacCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendConsoleIdCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdConsoleIdCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendWrongPassword(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdWrongPassword);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendRoomIsFull(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdRoomIsFull);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendVersionMismatch(ENetPeer* client) {
@@ -667,70 +773,49 @@ void Room::RoomImpl::SendVersionMismatch(ENetPeer* client) {
     packet << static_cast<u8>(IdVersionMismatch);
     packet << network_version;
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendJoinSuccess(ENetPeer* client, MacAddress mac_address) {
     Packet packet;
     packet << static_cast<u8>(IdJoinSuccess);
     packet << mac_address;
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendJoinSuccessAsMod(ENetPeer* client, MacAddress mac_address) {
     Packet packet;
     packet << static_cast<u8>(IdJoinSuccessAsMod);
     packet << mac_address;
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendUserKicked(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdHostKicked);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendUserBanned(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdHostBanned);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendModPermissionDenied(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModPermissionDenied);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendModNoSuchUser(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModNoSuchUser);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
@@ -741,25 +826,14 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
         packet << username_ban_list;
         packet << ip_ban_list;
     }
-
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_peer_send(client, 0, enet_packet);
-    enet_host_flush(server);
+    SendControlPacket(client, packet);
 }
 
 void Room::RoomImpl::SendCloseMessage() {
     Packet packet;
     packet << static_cast<u8>(IdCloseRoom);
-    std::lock_guard lock(member_mutex);
-    if (!members.empty()) {
-        ENetPacket* enet_packet =
-            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-        for (auto& member : members) {
-            enet_peer_send(member.peer, 0, enet_packet);
-        }
-    }
-    enet_host_flush(server);
+    std::shared_lock lock(member_mutex);
+    BroadcastControlPacket(packet);
     for (auto& member : members) {
         enet_peer_disconnect(member.peer, 0);
     }
@@ -772,15 +846,10 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     packet << static_cast<u8>(type);
     packet << nickname;
     packet << username;
-    std::lock_guard lock(member_mutex);
-    if (!members.empty()) {
-        ENetPacket* enet_packet =
-            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-        for (auto& member : members) {
-            enet_peer_send(member.peer, 0, enet_packet);
-        }
+    {
+        std::shared_lock lock(member_mutex);
+        BroadcastControlPacket(packet);
     }
-    enet_host_flush(server);
 
     const std::string display_name =
         username.empty() ? nickname : fmt::format("{} ({})", nickname, username);
@@ -804,7 +873,57 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     }
 }
 
-void Room::RoomImpl::BroadcastRoomInformation() {
+ENetPacket* Room::RoomImpl::CreateControlPacket(const Packet& packet) {
+    const auto* data = static_cast<const u8*>(packet.GetData());
+    const std::size_t size = packet.GetDataSize();
+    if (size > CompressionThreshold) {
+        const std::vector<u8> compressed = Common::Compression::CompressDataZSTDDefault(data, size);
+        if (!compressed.empty() && compressed.size() + sizeof(u8) < size) {
+            ENetPacket* enet_packet = enet_packet_create(nullptr, compressed.size() + sizeof(u8),
+                                                         ENET_PACKET_FLAG_RELIABLE);
+            enet_packet->data[0] = IdCompressed;
+            std::memcpy(enet_packet->data + sizeof(u8), compressed.data(), compressed.size());
+            return enet_packet;
+        }
+    }
+    return enet_packet_create(data, size, ENET_PACKET_FLAG_RELIABLE);
+}
+
+void Room::RoomImpl::SendControlPacket(ENetPeer* client, const Packet& packet) {
+    enet_peer_send(client, ControlChannel, CreateControlPacket(packet));
+    enet_host_flush(server);
+}
+
+void Room::RoomImpl::BroadcastControlPacket(const Packet& packet, const ENetPeer* except) {
+    if (members.empty()) {
+        return;
+    }
+    // The packet is created once and referenced by the queues of all recipients
+    ENetPacket* enet_packet = CreateControlPacket(packet);
+    bool sent_packet = false;
+    for (const auto& member : members) {
+        if (member.peer != except &&
+            enet_peer_send(member.peer, ControlChannel, enet_packet) == 0) {
+            sent_packet = true;
+        }
+    }
+    if (!sent_packet) {
+        enet_packet_destroy(enet_packet);
+    }
+    enet_host_flush(server);
+}
+
+void Room::RoomImpl::AppendMemberInformation(Packet& packet, const Member& member) const {
+    packet << member.nickname;
+    packet << member.mac_address;
+    packet << member.game_info.name;
+    packet << member.game_info.id;
+    packet << member.user_data.username;
+    packet << member.user_data.display_name;
+    packet << member.user_data.avatar_url;
+}
+
+void Room::RoomImpl::SendRoomInformation(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdRoomInformation);
     packet << room_information.name;
@@ -813,25 +932,43 @@ void Room::RoomImpl::BroadcastRoomInformation() {
     packet << room_information.port;
     packet << room_information.preferred_game;
     packet << room_information.host_username;
-
-    packet << static_cast<u32>(members.size());
     {
-        std::lock_guard lock(member_mutex);
+        std::shared_lock lock(member_mutex);
+        packet << static_cast<u32>(members.size());
         for (const auto& member : members) {
-            packet << member.nickname;
-            packet << member.mac_address;
-            packet << member.game_info.name;
-            packet << member.game_info.id;
-            packet << member.user_data.username;
-            packet << member.user_data.display_name;
-            packet << member.user_data.avatar_url;
+            AppendMemberInformation(packet, member);
         }
     }
+    SendControlPacket(client, packet);
+}
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-    enet_host_broadcast(server, 0, enet_packet);
-    enet_host_flush(server);
+Packet Room::RoomImpl::CreateMemberUpdate(MemberListUpdateTypes type, const Member& member) const {
+    Packet packet;
+    packet << static_cast<u8>(IdMemberListUpdate);
+    packet << static_cast<u8>(type);
+    AppendMemberInformation(packet, member);
+    return packet;
+}
+
+void Room::RoomImpl::BroadcastMemberRemoved(const std::string& nickname) {
+    Packet packet;
+    packet << static_cast<u8>(IdMemberListUpdate);
+    packet << static_cast<u8>(IdMemberRemoved);
+    packet << nickname;
+    std::shared_lock lock(member_mutex);
+    BroadcastControlPacket(packet);
+}
+
+void Room::RoomImpl::SendPendingUpdates() {
+    const auto now = std::chrono::steady_clock::now();
+    std::shared_lock lock(member_mutex);
+    for (auto& member : members) {
+        if (member.game_info_pending &&
+            IsWithinRateLimit(rate_limits.game_info, member.game_info_full_burst_time, now)) {
+            member.game_info_pending = false;
+            BroadcastControlPacket(CreateMemberUpdate(IdMemberChanged, member));
+        }
+    }
 }
 
 MacAddress Room::RoomImpl::GenerateMacAddress() {
@@ -847,50 +984,47 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    // Message type, WifiPacket type and channel, then the transmitter and destination addresses
+    constexpr std::size_t destination_offset = 3 * sizeof(u8) + sizeof(MacAddress);
+    ENetPacket* enet_packet = event->packet;
+    if (enet_packet->dataLength < destination_offset + sizeof(MacAddress)) {
+        return;
+    }
+    // The packet is forwarded as is, so only the destination address is read from it
     MacAddress destination_address;
-    in_packet >> destination_address;
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    std::memcpy(destination_address.data(), enet_packet->data + destination_offset,
+                sizeof(MacAddress));
+    enet_packet->flags |= ENET_PACKET_FLAG_RELIABLE;
 
+    u32 recipients = 0;
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
+        std::shared_lock lock(member_mutex);
         for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+            if (member.peer != event->peer &&
+                enet_peer_send(member.peer, WifiChannel, enet_packet) == 0) {
+                recipients++;
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
+        std::shared_lock lock(member_mutex);
         auto member = std::find_if(members.begin(), members.end(),
                                    [destination_address](const Member& member) -> bool {
                                        return member.mac_address == destination_address;
                                    });
         if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+            if (enet_peer_send(member->peer, WifiChannel, enet_packet) == 0) {
+                recipients++;
+            }
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
+    packets_relayed.fetch_add(recipients, std::memory_order_relaxed);
+    bytes_relayed.fetch_add(recipients * enet_packet->dataLength, std::memory_order_relaxed);
     enet_host_flush(server);
 }
 
@@ -901,16 +1035,23 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
     in_packet >> message;
-    auto CompareNetworkAddress = [event](const Member member) -> bool {
+    auto CompareNetworkAddress = [event](const Member& member) -> bool {
         return member.peer == event->peer;
     };
 
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     const auto sending_member = std::find_if(members.begin(), members.end(), CompareNetworkAddress);
     if (sending_member == members.end()) {
         return; // Received a chat message from a unknown sender
     }
 
+    if (!IsWithinRateLimit(rate_limits.chat, sending_member->chat_full_burst_time,
+                           std::chrono::steady_clock::now())) {
+        LOG_DEBUG(Network, "Dropped a chat message from {} over the rate limit",
+                  sending_member->nickname);
+        return;
+    }
+
     // Limit the size of chat messages to MaxMessageSize
     message.resize(std::min(static_cast<u32>(message.size()), MaxMessageSize));
 
@@ -919,22 +1060,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     out_packet << sending_member->nickname;
     out_packet << sending_member->user_data.username;
     out_packet << message;
-
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
-    bool sent_packet = false;
-    for (const auto& member : members) {
-        if (member.peer != event->peer) {
-            sent_packet = true;
-            enet_peer_send(member.peer, 0, enet_packet);
-        }
-    }
-
-    if (!sent_packet) {
-        enet_packet_destroy(enet_packet);
-    }
-
-    enet_host_flush(server);
+    BroadcastControlPacket(out_packet, event->peer);
 
     if (sending_member->user_data.username.empty()) {
         LOG_INFO(Network, "{}: {}", sending_member->nickname, message);
@@ -959,8 +1085,12 @@ void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
             std::find_if(members.begin(), members.end(), [event](const Member& member) -> bool {
                 return member.peer == event->peer;
             });
-        if (member != members.end()) {
+        if (member == members.end()) {
+            return;
+        }
+        if (member->game_info.name != game_info.name || member->game_info.id != game_info.id) {
             member->game_info = game_info;
+            member->game_info_pending = true;
 
             const std::string display_name =
                 member->user_data.username.empty()
@@ -974,7 +1104,7 @@ void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
             }
         }
     }
-    BroadcastRoomInformation();
+    SendPendingUpdates();
 }
 
 void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
@@ -999,9 +1129,10 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
 
     // Announce the change to all clients.
     enet_peer_disconnect(client, 0);
-    if (!nickname.empty())
+    if (!nickname.empty()) {
         SendStatusMessage(IdMemberLeave, nickname, username, ip);
-    BroadcastRoomInformation();
+        BroadcastMemberRemoved(nickname);
+    }
 }
 
 // Room
@@ -1014,7 +1145,7 @@ bool Room::Create(const std::string& name, const std::string& description,
                   const u32 max_connections, const std::string& host_username,
                   const std::string& preferred_game, u64 preferred_game_id,
                   std::unique_ptr<VerifyUser::Backend> verify_backend,
-                  const Room::BanList& ban_list, bool enable_citra_mods) {
+                  const Room::BanList& ban_list, bool enable_citra_mods, RoomPool* pool) {
     ENetAddress address;
     address.host = ENET_HOST_ANY;
     if (!server_address.empty()) {
@@ -1042,8 +1173,18 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->verify_backend = std::move(verify_backend);
     room_impl->username_ban_list = ban_list.first;
     room_impl->ip_ban_list = ban_list.second;
-
-    room_impl->StartLoop();
+    room_impl->packets_received = 0;
+    room_impl->bytes_received = 0;
+    room_impl->packets_relayed = 0;
+    room_impl->bytes_relayed = 0;
+    room_impl->handling_time_ns = 0;
+
+    if (pool) {
+        room_impl->pool = pool;
+        pool->Add(*room_impl);
+    } else {
+        room_impl->StartLoop();
+    }
     return true;
 }
 
@@ -1067,7 +1208,7 @@ Room::BanList Room::GetBanList() const {
 
 std::vector<Room::Member> Room::GetRoomMemberList() const {
     std::vector<Room::Member> member_list;
-    std::lock_guard lock(room_impl->member_mutex);
+    std::shared_lock lock(room_impl->member_mutex);
     for (const auto& member_impl : room_impl->members) {
         Member member;
         member.nickname = member_impl.nickname;
@@ -1081,6 +1222,20 @@ std::vector<Room::Member> Room::GetRoomMemberList() const {
     return member_list;
 }
 
+Room::Statistics Room::GetStatistics() const {
+    return {
+        .packets_received = room_impl->packets_received.load(std::memory_order_relaxed),
+        .bytes_received = room_impl->bytes_received.load(std::memory_order_relaxed),
+        .packets_relayed = room_impl->packets_relayed.load(std::memory_order_relaxed),
+        .bytes_relayed = room_impl->bytes_relayed.load(std::memory_order_relaxed),
+        .handling_time_ns = room_impl->handling_time_ns.load(std::memory_order_relaxed),
+    };
+}
+
+void Room::SetRateLimits(const RateLimits& limits) {
+    room_impl->rate_limits = limits;
+}
+
 bool Room::HasPassword() const {
     return !room_impl->password.empty();
 }
@@ -1092,8 +1247,15 @@ void Room::SetVerifyUID(const std::string& uid) {
 
 void Room::Destroy() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->pool) {
+        // Once removed from the pool, nothing else services the room anymore
+        room_impl->pool->Remove(*room_impl);
+        room_impl->pool = nullptr;
+        room_impl->SendCloseMessage();
+    } else {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1108,4 +1270,115 @@ void Room::Destroy() {
     room_impl->room_information.name.clear();
 }
 
+// RoomPool
+class RoomPool::PoolImpl {
+public:
+    struct Worker {
+        std::mutex mutex;
+        /// Rooms serviced by the worker, guarded by mutex
+        std::vector<Room::RoomImpl*> rooms;
+        /// Size of rooms, readable without waiting for the worker to release the lock
+        std::atomic<std::size_t> num_rooms{0};
+        std::condition_variable rooms_changed;
+        std::thread thread;
+    };
+
+    explicit PoolImpl(std::size_t num_threads) : workers(std::max<std::size_t>(num_threads, 1)) {
+        for (auto& worker : workers) {
+            worker.thread = std::thread([this, &worker] { WorkerLoop(worker); });
+        }
+    }
+
+    ~PoolImpl() {
+        stopping = true;
+        for (auto& worker : workers) {
+            {
+                std::lock_guard lock(worker.mutex);
+                worker.rooms_changed.notify_one();
+            }
+            worker.thread.join();
+        }
+    }
+
+    void Add(Room::RoomImpl& room) {
+        // Assign the room to the worker with the fewest rooms
+        Worker& target = *std::min_element(
+            workers.begin(), workers.end(),
+            [](const Worker& a, const Worker& b) { return a.num_rooms < b.num_rooms; });
+        std::lock_guard lock(target.mutex);
+        target.rooms.push_back(&room);
+        target.num_rooms = target.rooms.size();
+        target.rooms_changed.notify_one();
+    }
+
+    void Remove(Room::RoomImpl& room) {
+        for (auto& worker : workers) {
+            // The worker holds the lock while servicing its rooms
+            std::lock_guard lock(worker.mutex);
+            std::erase(worker.rooms, &room);
+            worker.num_rooms = worker.rooms.size();
+        }
+    }
+
+    std::vector<Worker> workers;
+
+private:
+    /// Maximum number of events dispatched for a room before the next room gets its turn
+    static constexpr u32 MaxEventsPerRoom = 64;
+
+    void WorkerLoop(Worker& worker) {
+        std::unique_lock lock(worker.mutex);
+        while (!stopping) {
+            if (worker.rooms.empty()) {
+                worker.rooms_changed.wait(lock, [&] { return stopping || !worker.rooms.empty(); });
+                continue;
+            }
+
+            // Dispatch what has been received on all rooms. Servicing a room also sends the
+            // packets queued on it and handles the resends and timeouts of its peers.
+            bool pending = false;
+            for (Room::RoomImpl* room : worker.rooms) {
+                u32 events = 0;
+                while (events < MaxEventsPerRoom && room->ServiceEvent(0)) {
+                    events++;
+                }
+                pending |= events == MaxEventsPerRoom;
+                room->SendPendingUpdates();
+            }
+            if (pending) {
+                continue;
+            }
+
+            // Wait for any of the sockets to receive, like the 16ms wait of a room's own thread
+            ENetSocketSet read_set;
+            ENET_SOCKETSET_EMPTY(read_set);
+            ENetSocket max_socket = 0;
+            for (const Room::RoomImpl* room : worker.rooms) {
+                ENET_SOCKETSET_ADD(read_set, room->server->socket);
+                max_socket = std::max(max_socket, room->server->socket);
+            }
+            enet_socketset_select(max_socket, &read_set, nullptr, 16);
+        }
+    }
+
+    std::atomic_bool stopping{false};
+};
+
+RoomPool::RoomPool(std::size_t num_threads)
+    : pool_impl{std::make_unique<PoolImpl>(num_threads)} {}
+
+RoomPool::~RoomPool() = default;
+
+std::size_t RoomPool::GetNumThreads() const {
+    return pool_impl->workers.size();
+}
+
+void RoomPool::Add(Room::RoomImpl& room) {
+    pool_impl->Add(room);
+}
+
+void RoomPool::Remove(Room::RoomImpl& room) {
+    pool_impl->Remove(room);
+}
+
 } // namespace Network
@@ -13,7 +13,7 @@
 
 namespace Network {
 
-constexpr u32 network_version = 4; ///< The version of this Room and RoomMember
+constexpr u32 network_version = 5; ///< The version of this Room and RoomMember
 
 constexpr u16 DefaultRoomPort = 24872;
 
@@ -22,7 +22,15 @@ constexpr u32 MaxMessageSize = 500;
 /// Maximum number of concurrent connections allowed to this room.
 static constexpr u32 MaxConcurrentConnections = 254;
 
-constexpr std::size_t NumChannels = 1; // Number of channels used for the connection
+constexpr std::size_t NumChannels = 2; // Number of channels used for the connection
+
+/// Channel of the wifi packets
+constexpr u8 WifiChannel = 0;
+/// Channel of all other messages, so that large ones don't hold up the wifi packets
+constexpr u8 ControlChannel = 1;
+
+/// Messages on the control channel larger than this are sent compressed
+constexpr std::size_t CompressionThreshold = 512;
 
 struct RoomInformation {
     std::string name;           ///< Name of the server
@@ -76,6 +84,9 @@ enum RoomMessageTypes : u8 {
     IdModPermissionDenied,
     IdModNoSuchUser,
     IdJoinSuccessAsMod,
+    IdMemberListUpdate,
+    /// A message compressed with zstd, the frame follows the message type
+    IdCompressed,
 };
 
 /// Types of system status messages
@@ -87,6 +98,21 @@ enum StatusMessageTypes : u8 {
     IdAddressUnbanned, ///< A username / ip address is unbanned from the room
 };
 
+/// Types of the member list changes sent with IdMemberListUpdate
+enum MemberListUpdateTypes : u8 {
+    IdMemberAdded = 1, ///< A member joined, followed by the information about it
+    IdMemberChanged,   ///< The information about a member changed, followed by it
+    IdMemberRemoved,   ///< A member left, followed by its nickname
+};
+
+/// Limits how often a member may send a kind of message
+struct RateLimit {
+    u32 burst;       ///< Number of messages that may be sent at once
+    u32 interval_ms; ///< Time after which one more message may be sent, 0 for no limit
+};
+
+class RoomPool;
+
 /// This is what a server [person creating a server] would use.
 class Room final {
 public:
@@ -127,6 +153,31 @@ public:
      */
     std::vector<Member> GetRoomMemberList() const;
 
+    /// Traffic of the room since it was created
+    struct Statistics {
+        u64 packets_received; ///< Packets received from the members
+        u64 bytes_received;   ///< Bytes received from the members
+        u64 packets_relayed;  ///< Wifi packets sent to the members, counted per recipient
+        u64 bytes_relayed;    ///< Bytes of the relayed wifi packets, counted per recipient
+        u64 handling_time_ns; ///< Time spent handling the received packets and disconnections
+    };
+
+    /**
+     * Gets the traffic statistics of the room. Can be called from any thread.
+     */
+    Statistics GetStatistics() const;
+
+    struct RateLimits {
+        RateLimit chat{5, 1000};
+        /// Game changes beyond the limit are announced to the other members once it allows
+        RateLimit game_info{3, 5000};
+    };
+
+    /**
+     * Sets the limits on the messages of each member. Must be called before Create.
+     */
+    void SetRateLimits(const RateLimits& limits);
+
     /**
      * Checks if the room is password protected
      */
@@ -139,7 +190,8 @@ public:
 
     /**
      * Creates the socket for this room. Will bind to default address if
-     * server is empty string.
+     * server is empty string. The room is serviced by the threads of the pool if one is given, it
+     * must outlive the room being open. Otherwise the room gets its own thread.
      */
     bool Create(const std::string& name, const std::string& description = "",
                 const std::string& server = "", u16 server_port = DefaultRoomPort,
@@ -148,7 +200,8 @@ public:
                 const std::string& host_username = "", const std::string& preferred_game = "",
                 u64 preferred_game_id = 0,
                 std::unique_ptr<VerifyUser::Backend> verify_backend = nullptr,
-                const BanList& ban_list = {}, bool enable_citra_mods = false);
+                const BanList& ban_list = {}, bool enable_citra_mods = false,
+                RoomPool* pool = nullptr);
 
     /**
      * Sets the verification GUID of the room.
@@ -166,8 +219,33 @@ public:
     void Destroy();
 
 private:
+    friend class RoomPool;
+
     class RoomImpl;
     std::unique_ptr<RoomImpl> room_impl;
 };
 
+/**
+ * Services the rooms created with it on a fixed number of threads, so that a server can host many
+ * rooms without a thread for each. Every room is assigned to a single thread, which waits on the
+ * sockets of all its rooms at once.
+ */
+class RoomPool final {
+public:
+    explicit RoomPool(std::size_t num_threads);
+    ~RoomPool();
+
+    /// Number of threads servicing the rooms
+    std::size_t GetNumThreads() const;
+
+private:
+    friend class Room;
+
+    void Add(Room::RoomImpl& room);
+    void Remove(Room::RoomImpl& room);
+
+    class PoolImpl;
+    std::unique_ptr<PoolImpl> pool_impl;
+};
+
 } // namespace Network
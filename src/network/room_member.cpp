@@ -9,6 +9,8 @@
 #include <set>
 #include <thread>
 #include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
 #include "enet/enet.h"
 #include "network/packet.h"
 #include "network/room_member.h"
@@ -42,7 +44,9 @@ public:
 
     MacAddress mac_address; ///< The mac_address of this member.
 
-    std::mutex network_mutex; ///< Mutex that controls access to the `client` variable.
+    /// Mutex that controls access to the `client` variable. Recursive, as the callbacks invoked
+    /// by the loop can send packets.
+    std::recursive_mutex network_mutex;
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> loop_thread;
     std::mutex send_list_mutex;  ///< Mutex that controls access to the `send_list` variable.
@@ -72,6 +76,9 @@ public:
 
     void StartLoop();
 
+    /// Sends the packets queued by Send, network_mutex must be held
+    void SendQueuedPackets();
+
     /**
      * Sends data to the room. It will be send on channel 0 with flag RELIABLE
      * @param packet The data to send
@@ -102,6 +109,26 @@ public:
      */
     void HandleRoomInformationPacket(const ENetEvent* event);
 
+    /**
+     * Applies a change of the member list from a received ENet packet.
+     * @param event The ENet event that was received.
+     */
+    void HandleMemberListUpdatePacket(const ENetEvent* event);
+
+    /**
+     * Reads the information about a member, as appended by the room.
+     * @param packet The packet to read from.
+     * @param member The member to read into.
+     */
+    void ReadMemberInformation(Packet& packet, MemberInformation& member);
+
+    /**
+     * Replaces a received IdCompressed packet with the message it contains.
+     * @param event The ENet event that was received.
+     * @return Whether the message could be decompressed
+     */
+    bool DecompressPacket(ENetEvent* event);
+
     /**
      * Extracts a WifiPacket from a received ENet packet.
      * @param event The  ENet event that was received.
@@ -157,12 +184,24 @@ bool RoomMember::RoomMemberImpl::IsConnected() const {
 
 void RoomMember::RoomMemberImpl::MemberLoop() {
     // Receive packets while the connection is open
+    bool wait = false;
     while (IsConnected()) {
+        if (wait) {
+            // Wait without holding the lock, so that Send can send right away in the meantime
+            enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE;
+            enet_socket_wait(client->socket, &condition, 16);
+        }
         std::lock_guard lock(network_mutex);
         ENetEvent event;
-        if (enet_host_service(client, &event, 16) > 0) {
+        // A datagram can hold several events, so only wait once all of them were handled
+        wait = enet_host_service(client, &event, 0) <= 0;
+        if (!wait) {
             switch (event.type) {
             case ENET_EVENT_TYPE_RECEIVE:
+                if (event.packet->data[0] == IdCompressed && !DecompressPacket(&event)) {
+                    enet_packet_destroy(event.packet);
+                    break;
+                }
                 switch (event.packet->data[0]) {
                 case IdWifiPacket:
                     HandleWifiPackets(&event);
@@ -176,6 +215,9 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
                 case IdRoomInformation:
                     HandleRoomInformationPacket(&event);
                     break;
+                case IdMemberListUpdate:
+                    HandleMemberListUpdatePacket(&event);
+                    break;
                 case IdJoinSuccess:
                 case IdJoinSuccessAsMod:
                     // The join request was successful, we are now in the room.
@@ -253,28 +295,42 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
             }
         }
 
-        std::list<Packet> packets;
-        {
-            std::lock_guard lock(send_list_mutex);
-            packets.swap(send_list);
-        }
-        for (const auto& packet : packets) {
-            ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                        ENET_PACKET_FLAG_RELIABLE);
-            enet_peer_send(server, 0, enetPacket);
-        }
-        enet_host_flush(client);
+        SendQueuedPackets();
     }
+    std::lock_guard lock(network_mutex);
     Disconnect();
 };
 
+void RoomMember::RoomMemberImpl::SendQueuedPackets() {
+    std::list<Packet> packets;
+    {
+        std::lock_guard lock(send_list_mutex);
+        packets.swap(send_list);
+    }
+    for (const auto& packet : packets) {
+        ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                                    ENET_PACKET_FLAG_RELIABLE);
+        const bool is_wifi_packet = static_cast<const u8*>(packet.GetData())[0] == IdWifiPacket;
+        enet_peer_send(server, is_wifi_packet ? WifiChannel : ControlChannel, enetPacket);
+    }
+    enet_host_flush(client);
+}
+
 void RoomMember::RoomMemberImpl::StartLoop() {
     loop_thread = std::make_unique<std::thread>(&RoomMember::RoomMemberImpl::MemberLoop, this);
 }
 
 void RoomMember::RoomMemberImpl::Send(Packet&& packet) {
-    std::lock_guard lock(send_list_mutex);
-    send_list.push_back(std::move(packet));
+    {
+        std::lock_guard lock(send_list_mutex);
+        send_list.push_back(std::move(packet));
+    }
+    // Send right away, instead of after the loop's next wait, unless the loop is busy. The loop
+    // sends the list itself when it's done.
+    std::unique_lock lock(network_mutex, std::try_to_lock);
+    if (lock && IsConnected()) {
+        SendQueuedPackets();
+    }
 }
 
 void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
@@ -319,24 +375,69 @@ void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* ev
     member_information.resize(num_members);
 
     for (auto& member : member_information) {
-        packet >> member.nickname;
-        packet >> member.mac_address;
-        packet >> member.game_info.name;
-        packet >> member.game_info.id;
-        packet >> member.username;
-        packet >> member.display_name;
-        packet >> member.avatar_url;
-
-        {
-            std::lock_guard lock(username_mutex);
-            if (member.nickname == nickname) {
-                username = member.username;
-            }
+        ReadMemberInformation(packet, member);
+    }
+    Invoke(room_information);
+}
+
+void RoomMember::RoomMemberImpl::HandleMemberListUpdatePacket(const ENetEvent* event) {
+    Packet packet;
+    packet.Append(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+
+    u8 type{};
+    packet >> type;
+    if (type == IdMemberRemoved) {
+        std::string removed_nickname;
+        packet >> removed_nickname;
+        std::erase_if(member_information, [&removed_nickname](const MemberInformation& member) {
+            return member.nickname == removed_nickname;
+        });
+    } else {
+        MemberInformation update{};
+        ReadMemberInformation(packet, update);
+        const auto member = std::find_if(
+            member_information.begin(), member_information.end(),
+            [&update](const auto& member) { return member.nickname == update.nickname; });
+        if (member != member_information.end()) {
+            *member = std::move(update);
+        } else {
+            member_information.push_back(std::move(update));
         }
     }
     Invoke(room_information);
 }
 
+void RoomMember::RoomMemberImpl::ReadMemberInformation(Packet& packet, MemberInformation& member) {
+    packet >> member.nickname;
+    packet >> member.mac_address;
+    packet >> member.game_info.name;
+    packet >> member.game_info.id;
+    packet >> member.username;
+    packet >> member.display_name;
+    packet >> member.avatar_url;
+
+    std::lock_guard lock(username_mutex);
+    if (member.nickname == nickname) {
+        username = member.username;
+    }
+}
+
+bool RoomMember::RoomMemberImpl::DecompressPacket(ENetEvent* event) {
+    const std::span<const u8> frame{event->packet->data + sizeof(u8),
+                                    event->packet->dataLength - sizeof(u8)};
+    const std::vector<u8> message = Common::Compression::DecompressFrameZSTD(frame);
+    if (message.empty() || message[0] == IdCompressed) {
+        LOG_ERROR(Network, "Received an invalid compressed message");
+        return false;
+    }
+    enet_packet_destroy(event->packet);
+    event->packet = enet_packet_create(message.data(), message.size(), ENET_PACKET_FLAG_RELIABLE);
+    return true;
+}
+
 void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
     Packet packet;
     packet.Append(event->packet->data, event->packet->dataLength);
@@ -485,7 +586,8 @@ RoomMember::RoomMemberImpl::Callbacks::Get() {
 template <typename T>
 void RoomMember::RoomMemberImpl::Invoke(const T& data) {
     std::lock_guard lock(callback_mutex);
-    CallbackSet<T> callback_set = callbacks.Get<T>();
+    // The set can't change while the lock is held, so it doesn't need to be copied
+    const CallbackSet<T>& callback_set = callbacks.Get<T>();
     for (auto const& callback : callback_set)
         (*callback)(data);
 }
@@ -0,0 +1,130 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "common/benchmark_report.h"
+#include "common/scm_rev.h"
+#include "tests/audio_core/hle_replay.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+using namespace AudioCore::Test;
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options]\n"
+                 "Mixes audio scenarios with DspHle, with and without producing the output, and\n"
+                 "reports the time taken per audio frame.\n\n"
+                 "--frames            The number of audio frames to mix per scenario\n"
+                 "--json              Writes the frame times to a JSON file for citra-bench\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra audio benchmark " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+namespace {
+
+/// Mixes the frames and returns the time each one took, in microseconds
+std::vector<double> MeasureFrames(HleReplay& replay, const Scenario& scenario, u32 frames) {
+    std::vector<double> times;
+    times.reserve(frames);
+    for (u32 i = 0; i < frames; i++) {
+        const auto start = Clock::now();
+        replay.RunFrame(scenario);
+        times.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    return times;
+}
+
+void Report(const std::string& metric, const std::vector<double>& times,
+            Common::BenchmarkReport& report) {
+    double total = 0.0;
+    for (const double time : times) {
+        total += time;
+        report.AddSample(metric, "us", Common::BenchmarkReport::Better::Lower, time);
+    }
+    std::cout << fmt::format("{:<32} {:8.2f} us per frame\n", metric,
+                             times.empty() ? 0.0 : total / times.size());
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    u32 frames = 2000;
+    std::string json_path;
+
+    static struct option long_options[] = {
+        {"frames", required_argument, 0, 'f'},
+        {"json", required_argument, 0, 'j'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "f:j:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'f':
+                frames = strtoul(optarg, &endarg, 0);
+                break;
+            case 'j':
+                json_path = optarg;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            optind++;
+        }
+    }
+
+    if (frames == 0) {
+        std::cout << "frames needs to be at least 1!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    Common::BenchmarkReport report{"citra-audio-bench"};
+    report.AddConfig("frames", std::to_string(frames));
+    for (const auto& [name, scenario] : scenarios) {
+        // The hash shows whether an optimization kept the output bit-exact
+        std::cout << fmt::format("{}: output hash {:016x}\n", name, HleReplay{false}.Run(scenario));
+
+        HleReplay replay{false};
+        Report(fmt::format("{}/frame_time", name), MeasureFrames(replay, scenario, frames),
+               report);
+        HleReplay headless{false, true};
+        Report(fmt::format("{}/headless_frame_time", name),
+               MeasureFrames(headless, scenario, frames), report);
+    }
+
+    if (!json_path.empty() && !report.Save(json_path)) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include "tests/audio_core/hle_replay.h"
+
+using namespace AudioCore;
+using namespace AudioCore::Test;
+
+TEST_CASE("DspHle output is deterministic", "[audio_core]") {
+    for (const auto& [name, scenario] : scenarios) {
+        INFO(name);
+        std::vector<HLE::FinalMixSamples> frames;
+        const u64 hash = HleReplay{false}.Run(scenario, &frames);
+        REQUIRE(HleReplay{false}.Run(scenario) == hash);
+
+        // Make sure that the sources were actually heard
+        const auto& last = frames.back().pcm16;
+        REQUIRE(std::any_of(std::begin(last), std::end(last), [](const auto& sample) {
+            return sample[0] != 0 || sample[1] != 0;
+        }));
+    }
+}
+
+TEST_CASE("DspHle multithreaded output is the single-threaded output a frame later",
+          "[audio_core]") {
+    for (const auto& [name, scenario] : scenarios) {
+        INFO(name);
+        std::vector<HLE::FinalMixSamples> expected;
+        HleReplay{false}.Run(scenario, &expected);
+        std::vector<HLE::FinalMixSamples> result;
+        HleReplay{true}.Run(scenario, &result);
+        for (u32 i = 1; i < num_frames; i++) {
+            INFO("frame " << i);
+            REQUIRE(std::memcmp(&result[i], &expected[i - 1], sizeof(result[i])) == 0);
+        }
+    }
+}
+
+TEST_CASE("Headless DspHle reports the same source statuses", "[audio_core]") {
+    for (const auto& [name, scenario] : scenarios) {
+        INFO(name);
+        HleReplay replay{false};
+        HleReplay headless{false, true};
+        for (u32 i = 0; i < num_frames; i++) {
+            INFO("frame " << i);
+            replay.RunFrame(scenario);
+            const auto output = headless.RunFrame(scenario);
+            REQUIRE(std::memcmp(&headless.SourceStatuses(), &replay.SourceStatuses(),
+                                sizeof(HLE::SourceStatus)) == 0);
+            REQUIRE(std::all_of(std::begin(output.pcm16), std::end(output.pcm16),
+                                [](const auto& sample) {
+                                    return sample[0] == 0 && sample[1] == 0;
+                                }));
+        }
+    }
+}
+
+TEST_CASE("DspHle benchmark", "[.][audio_core][benchmark]") {
+    for (const auto& [name, scenario] : scenarios) {
+        // Report the hashes, so that optimizations can be checked to be bit-exact
+        fmt::print("{}: output hash {:016x}\n", name, HleReplay{false}.Run(scenario));
+
+        HleReplay replay{false};
+        BENCHMARK(fmt::format("{}, single frame", name)) {
+            return replay.RunFrame(scenario);
+        };
+        HleReplay headless{false, true};
+        BENCHMARK(fmt::format("{}, single headless frame", name)) {
+            return headless.RunFrame(scenario);
+        };
+    }
+}
@@ -0,0 +1,218 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+#include "audio_core/hle/hle.h"
+#include "audio_core/hle/shared_memory.h"
+#include "common/hash.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+
+/// Drives DspHle without an emulated application, for the audio tests and benchmarks
+namespace AudioCore::Test {
+
+using Configuration = HLE::SourceConfiguration::Configuration;
+
+// ARM11 cycles per audio frame, as in DspHle
+constexpr u64 audio_frame_ticks = samples_per_frame * 4096 * 2ull;
+constexpr u32 num_frames = 200;
+
+/// The configuration an application keeps on its side and submits to the DSP every frame
+struct ApplicationState {
+    HLE::SourceConfiguration sources{};
+    HLE::DspConfiguration dsp{};
+    HLE::AdpcmCoefficients adpcm{};
+    /// Sample data in FCRAM, allocated from the start
+    u8* fcram = nullptr;
+    u32 fcram_used = 0;
+
+    /// Copies the data into FCRAM and returns its physical address
+    u32 Upload(const std::vector<u8>& data) {
+        const u32 address = Memory::FCRAM_PADDR + fcram_used;
+        std::memcpy(fcram + fcram_used, data.data(), data.size());
+        fcram_used += (static_cast<u32>(data.size()) + 15) & ~15u;
+        return address;
+    }
+};
+
+/// Changes the application state before it is submitted for the given frame
+using Scenario = std::function<void(u32 frame, ApplicationState& app)>;
+
+/**
+ * Drives a DspHle the way an emulated application does: every frame the application state is
+ * written to one of the two shared memory regions and the DSP gets to mix a frame from it.
+ */
+class HleReplay {
+public:
+    explicit HleReplay(bool multithread, bool headless = false)
+        : dsp{memory, timing, multithread, headless} {
+        app.fcram = memory.GetFCRAMPointer(0);
+        auto& dsp_memory = *reinterpret_cast<HLE::DspMemory*>(dsp.GetDspMemory().data());
+        regions = {&dsp_memory.region_0, &dsp_memory.region_1};
+
+        // The mixers start out silent
+        app.dsp.volume[0] = 1.0f;
+        app.dsp.volume_0_dirty.Assign(1);
+        app.dsp.output_format = HLE::DspConfiguration::OutputFormat::Stereo;
+        app.dsp.output_format_dirty.Assign(1);
+    }
+
+    /// Submits the application state for the next frame and mixes it, returning the final samples
+    /// that the DSP published in the shared memory
+    HLE::FinalMixSamples RunFrame(const Scenario& scenario) {
+        scenario(frame, app);
+
+        // The application writes the region the DSP wrote its statuses to the frame before
+        HLE::SharedMemory& submitted = *regions[frame % 2];
+        submitted.source_configurations = app.sources;
+        submitted.dsp_configuration = app.dsp;
+        submitted.adpcm_coefficients = app.adpcm;
+        submitted.frame_counter = static_cast<u16>(frame + 1);
+        for (auto& config : app.sources.config) {
+            config.dirty_raw = 0;
+            config.buffers_dirty = 0;
+        }
+        app.dsp.dirty_raw = 0;
+
+        AdvanceFrame();
+        frame++;
+        return regions[frame % 2]->final_samples;
+    }
+
+    /// Returns the statuses that the DSP published for the last frame
+    const HLE::SourceStatus& SourceStatuses() const {
+        return regions[frame % 2]->source_statuses;
+    }
+
+    /// Runs the scenario, returning the hash of all final samples
+    u64 Run(const Scenario& scenario, std::vector<HLE::FinalMixSamples>* frames = nullptr) {
+        std::vector<HLE::FinalMixSamples> output;
+        for (u32 i = 0; i < num_frames; i++) {
+            output.push_back(RunFrame(scenario));
+        }
+        const u64 hash = Common::ComputeHash64(output.data(), output.size() * sizeof(output[0]));
+        if (frames) {
+            *frames = std::move(output);
+        }
+        return hash;
+    }
+
+private:
+    void AdvanceFrame() {
+        const auto timer = timing.GetTimer(0);
+        const u64 target = timer->GetTicks() + audio_frame_ticks;
+        while (timer->GetTicks() < target) {
+            timer->SetNextSlice(static_cast<s64>(target - timer->GetTicks()));
+            timer->AddTicks(timer->GetDowncount());
+            timer->Advance();
+        }
+    }
+
+    Core::Timing timing{1, 100};
+    Memory::MemorySystem memory;
+    DspHle dsp;
+    std::array<HLE::SharedMemory*, 2> regions{};
+    ApplicationState app;
+    u32 frame = 0;
+};
+
+inline std::vector<u8> RandomBytes(std::size_t size, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u8> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<u8>(rng());
+    }
+    return data;
+}
+
+/// Starts a looping embedded buffer on the source that plays into the front channels of a mixer
+inline void StartSource(ApplicationState& app, std::size_t source_id,
+                        Configuration::Format format, Configuration::MonoOrStereo mono_or_stereo,
+                        u32 length, float rate, Configuration::InterpolationMode interpolation,
+                        std::size_t mix, u32 seed) {
+    const std::size_t bytes_per_sample =
+        format == Configuration::Format::PCM16 ? 2 : format == Configuration::Format::PCM8 ? 1 : 0;
+    const std::size_t size = format == Configuration::Format::ADPCM
+                                 ? (length + 13) / 14 * 8
+                                 : length * bytes_per_sample * static_cast<u32>(mono_or_stereo);
+    Configuration& config = app.sources.config[source_id];
+    config.physical_address = app.Upload(RandomBytes(size, seed));
+    config.length = length;
+    config.format.Assign(format);
+    config.mono_or_stereo.Assign(mono_or_stereo);
+    config.is_looping.Assign(1);
+    config.buffer_id = 1;
+    config.rate_multiplier = rate;
+    config.interpolation_mode = interpolation;
+    config.gain[mix][0] = 0.5f;
+    config.gain[mix][1] = 0.5f;
+    config.enable = 1;
+    if (format == Configuration::Format::ADPCM) {
+        std::mt19937 rng{seed};
+        for (auto& coeff : app.adpcm.coeff[source_id]) {
+            coeff = static_cast<s16>(static_cast<int>(rng() % 4096) - 2048);
+        }
+        config.adpcm_coefficients_dirty.Assign(1);
+    }
+    config.enable_dirty.Assign(1);
+    config.embedded_buffer_dirty.Assign(1);
+    config.rate_multiplier_dirty.Assign(1);
+    config.interpolation_dirty.Assign(1);
+    config.gain_0_dirty.Assign(mix == 0);
+    config.gain_1_dirty.Assign(mix == 1);
+    config.gain_2_dirty.Assign(mix == 2);
+}
+
+/// A single stereo stream at the native rate
+inline void StereoMusic(u32 frame, ApplicationState& app) {
+    if (frame == 0) {
+        StartSource(app, 0, Configuration::Format::PCM16, Configuration::MonoOrStereo::Stereo,
+                    22000, 1.0f, Configuration::InterpolationMode::Linear, 0, 1);
+    }
+}
+
+/// All sources playing at once, using every format, interpolation mode and mixer
+inline void BusyScene(u32 frame, ApplicationState& app) {
+    constexpr std::array formats{Configuration::Format::PCM8, Configuration::Format::PCM16,
+                                 Configuration::Format::ADPCM};
+    constexpr std::array interpolations{Configuration::InterpolationMode::Polyphase,
+                                        Configuration::InterpolationMode::Linear,
+                                        Configuration::InterpolationMode::None};
+    constexpr std::array rates{1.0f, 22050.0f / 32728.0f, 48000.0f / 32728.0f, 0.3f};
+    if (frame == 0) {
+        app.dsp.volume[1] = 0.5f;
+        app.dsp.volume[2] = 0.25f;
+        app.dsp.volume_1_dirty.Assign(1);
+        app.dsp.volume_2_dirty.Assign(1);
+    }
+    // Start the sources a few frames apart, like a scene bringing up its sound effects
+    if (frame % 4 == 0 && frame / 4 < HLE::num_sources) {
+        const u32 i = frame / 4;
+        const auto mono_or_stereo =
+            i % 2 == 0 ? Configuration::MonoOrStereo::Mono : Configuration::MonoOrStereo::Stereo;
+        StartSource(app, i, formats[i % formats.size()], mono_or_stereo, 4000 + i * 321,
+                    rates[i % rates.size()], interpolations[i % interpolations.size()], i % 3,
+                    100 + i);
+    }
+    // Sweep the rate of a source, as done for engine sounds
+    if (frame >= 8 && frame % 8 == 0) {
+        Configuration& config = app.sources.config[1];
+        config.rate_multiplier = 0.5f + static_cast<float>(frame % 64) / 64.0f;
+        config.rate_multiplier_dirty.Assign(1);
+    }
+}
+
+inline const std::array<std::pair<const char*, Scenario>, 2> scenarios{{
+    {"stereo music", &StereoMusic},
+    {"busy scene", &BusyScene},
+}};
+
+} // namespace AudioCore::Test
@@ -0,0 +1,209 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/interpolate.h"
+
+using namespace AudioCore;
+
+using Interpolator = void (*)(AudioInterp::State&, AudioInterp::StereoBuffer16&, float,
+                              StereoFrame16&, std::size_t&);
+
+static std::vector<std::array<s16, 2>> RandomStream(std::size_t length, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<std::array<s16, 2>> stream(length);
+    for (auto& sample : stream) {
+        sample = {static_cast<s16>(rng()), static_cast<s16>(rng())};
+    }
+    return stream;
+}
+
+/// Feeds the stream to the interpolator in chunks of varying size, collecting all the output
+static std::vector<std::array<s16, 2>> Resample(Interpolator interpolator,
+                                                const std::vector<std::array<s16, 2>>& stream,
+                                                float rate, u32 seed) {
+    std::mt19937 rng{seed};
+    AudioInterp::State state{};
+    std::vector<std::array<s16, 2>> result;
+    StereoFrame16 frame{};
+    std::size_t outputi = 0;
+
+    auto next = stream.begin();
+    AudioInterp::StereoBuffer16 input;
+    while (true) {
+        if (input.empty()) {
+            if (next == stream.end()) {
+                break;
+            }
+            const auto length = std::min<std::ptrdiff_t>(rng() % 300 + 1, stream.end() - next);
+            input.assign(next, next + length);
+            next += length;
+        }
+        interpolator(state, input, rate, frame, outputi);
+        if (outputi == frame.size()) {
+            result.insert(result.end(), frame.begin(), frame.end());
+            outputi = 0;
+        }
+    }
+    result.insert(result.end(), frame.begin(), frame.begin() + outputi);
+    return result;
+}
+
+/// Straightforward linear interpolation over the whole stream, including the two-sample predelay
+static std::vector<std::array<s16, 2>> ReferenceLinear(
+    const std::vector<std::array<s16, 2>>& stream, float rate) {
+    std::vector<std::array<s16, 2>> window{{}, {}};
+    window.insert(window.end(), stream.begin(), stream.end());
+
+    const u64 step_size = static_cast<u64>(rate * (1 << 24));
+    std::vector<std::array<s16, 2>> result;
+    for (u64 position = 0; (position >> 24) + 2 < window.size(); position += step_size) {
+        const auto& x0 = window[position >> 24];
+        const auto& x1 = window[(position >> 24) + 1];
+        const s64 fraction = static_cast<s64>(position & ((1 << 24) - 1));
+        std::array<s16, 2> sample;
+        for (std::size_t channel = 0; channel < 2; channel++) {
+            const s64 delta = std::clamp<s64>(x1[channel] - x0[channel], -32768, 32767);
+            sample[channel] = static_cast<s16>(x0[channel] + ((fraction * delta) >> 24));
+        }
+        result.push_back(sample);
+    }
+    return result;
+}
+
+TEST_CASE("AudioInterp at unity rate delays the input by two samples", "[audio_core]") {
+    const auto stream = RandomStream(4000, 1);
+    constexpr std::array<s16, 2> silence{};
+    for (const Interpolator interpolator : {&AudioInterp::None, &AudioInterp::Linear}) {
+        for (u32 seed = 0; seed < 8; seed++) {
+            const auto result = Resample(interpolator, stream, 1.0f, seed);
+            REQUIRE(result.size() == stream.size());
+            REQUIRE(result[0] == silence);
+            REQUIRE(result[1] == silence);
+            REQUIRE(std::equal(result.begin() + 2, result.end(), stream.begin()));
+        }
+    }
+}
+
+TEST_CASE("AudioInterp::Linear matches the reference across input buffers", "[audio_core]") {
+    const auto stream = RandomStream(4000, 2);
+    for (const float rate : {0.25f, 0.75f, 1.0f, 1.3f, 2.5f}) {
+        const auto expected = ReferenceLinear(stream, rate);
+        for (u32 seed = 0; seed < 8; seed++) {
+            const auto result = Resample(&AudioInterp::Linear, stream, rate, seed);
+            REQUIRE(result == expected);
+        }
+    }
+}
+
+TEST_CASE("AudioInterp::Polyphase at unity rate delays the input by four samples",
+          "[audio_core]") {
+    const auto stream = RandomStream(4000, 4);
+    for (u32 seed = 0; seed < 8; seed++) {
+        const auto result = Resample(&AudioInterp::Polyphase, stream, 1.0f, seed);
+        REQUIRE(result.size() == stream.size());
+        REQUIRE(std::all_of(result.begin(), result.begin() + 4,
+                            [](const auto& sample) { return sample == std::array<s16, 2>{}; }));
+        REQUIRE(std::equal(result.begin() + 4, result.end(), stream.begin()));
+    }
+}
+
+TEST_CASE("AudioInterp::Polyphase is independent of input buffer boundaries", "[audio_core]") {
+    const auto stream = RandomStream(4000, 5);
+    for (const float rate : {0.25f, 0.75f, 1.3f, 2.5f}) {
+        const auto expected = Resample(&AudioInterp::Polyphase, stream, rate, 0);
+        for (u32 seed = 1; seed < 8; seed++) {
+            REQUIRE(Resample(&AudioInterp::Polyphase, stream, rate, seed) == expected);
+        }
+    }
+}
+
+TEST_CASE("AudioInterp::Polyphase preserves a constant signal", "[audio_core]") {
+    const std::vector<std::array<s16, 2>> stream(1000, {12345, -23456});
+    for (const float rate : {0.3f, 0.75f, 1.7f}) {
+        const auto result = Resample(&AudioInterp::Polyphase, stream, rate, 0);
+        // Skip the samples that are still mixed with the silent history
+        const auto settled = result.begin() + static_cast<std::ptrdiff_t>(8 / rate) + 1;
+        REQUIRE(std::all_of(settled, result.end(),
+                            [&stream](const auto& sample) { return sample == stream[0]; }));
+    }
+}
+
+TEST_CASE("AudioInterp::Skip steps over the input like the interpolators", "[audio_core]") {
+    const auto stream = RandomStream(4000, 6);
+    for (const Interpolator interpolator : {&AudioInterp::Linear, &AudioInterp::Polyphase}) {
+        for (const float rate : {0.25f, 0.75f, 1.0f, 1.3f, 2.5f}) {
+            for (u32 seed = 0; seed < 8; seed++) {
+                std::mt19937 rng{seed};
+                AudioInterp::State state{};
+                AudioInterp::State skip_state{};
+                StereoFrame16 frame{};
+                std::size_t outputi = 0;
+                std::size_t skip_outputi = 0;
+                AudioInterp::StereoBuffer16 input;
+                std::size_t skip_input_size = 0;
+
+                auto next = stream.begin();
+                while (true) {
+                    if (input.empty()) {
+                        if (next == stream.end()) {
+                            break;
+                        }
+                        const auto length =
+                            std::min<std::ptrdiff_t>(rng() % 300 + 1, stream.end() - next);
+                        input.assign(next, next + length);
+                        skip_input_size = input.size();
+                        next += length;
+                    }
+                    interpolator(state, input, rate, frame, outputi);
+                    AudioInterp::Skip(skip_state, skip_input_size, rate, skip_outputi);
+                    REQUIRE(skip_input_size == input.size());
+                    REQUIRE(skip_outputi == outputi);
+                    REQUIRE(skip_state.fposition == state.fposition);
+                    outputi %= frame.size();
+                    skip_outputi %= frame.size();
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("AudioInterp benchmark", "[.][audio_core][benchmark]") {
+    const auto stream = RandomStream(samples_per_frame * 64, 3);
+    const auto run = [&stream](Interpolator interpolator, float rate) {
+        AudioInterp::State state{};
+        AudioInterp::StereoBuffer16 input(stream.begin(), stream.end());
+        StereoFrame16 frame;
+        std::size_t outputi = 0;
+        while (!input.empty()) {
+            interpolator(state, input, rate, frame, outputi);
+            outputi %= frame.size();
+        }
+        return frame[0];
+    };
+
+    BENCHMARK("None, unity rate") {
+        return run(&AudioInterp::None, 1.0f);
+    };
+    BENCHMARK("Linear, unity rate") {
+        return run(&AudioInterp::Linear, 1.0f);
+    };
+    BENCHMARK("Linear, 32728 Hz from 22050 Hz") {
+        return run(&AudioInterp::Linear, 22050.0f / 32728.0f);
+    };
+    BENCHMARK("Linear, 32728 Hz from 48000 Hz") {
+        return run(&AudioInterp::Linear, 48000.0f / 32728.0f);
+    };
+    BENCHMARK("Polyphase, 32728 Hz from 22050 Hz") {
+        return run(&AudioInterp::Polyphase, 22050.0f / 32728.0f);
+    };
+    BENCHMARK("Polyphase, 32728 Hz from 48000 Hz") {
+        return run(&AudioInterp::Polyphase, 48000.0f / 32728.0f);
+    };
+}
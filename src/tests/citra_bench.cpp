@@ -0,0 +1,308 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <json.hpp>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/scm_rev.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options]\n"
+                 "Runs the CPU, audio and trace replay benchmarks with fixed configurations,\n"
+                 "repeats them and summarizes every metric by its median, 99th percentile and\n"
+                 "variance over all samples. Given the summary of an earlier build, it reports\n"
+                 "whether this build is faster or slower, and exits with 1 if it's slower.\n\n"
+                 "--trace             A CiTrace recording to replay, can be repeated\n"
+                 "--repeat            The number of times each benchmark is run, 5 by default\n"
+                 "--output            Writes the summary to a JSON file\n"
+                 "--baseline          The summary of the build to compare against\n"
+                 "--threshold         The change of a median in percent that counts, 5 by default\n"
+                 "--tools             The directory of the benchmark tools, the directory of\n"
+                 "                    this program by default\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra benchmark runner " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+namespace {
+
+struct Benchmark {
+    /// Prefix of the names of the metrics of the benchmark
+    std::string name;
+    std::string tool;
+    /// The options of the tool, fixed so that the results of different builds compare
+    std::vector<std::string> arguments;
+};
+
+struct Metric {
+    std::string unit;
+    std::string better;
+    std::vector<double> samples;
+};
+
+std::string QuoteArgument(const std::string& argument) {
+    return fmt::format("\"{}\"", argument);
+}
+
+/// Runs the benchmark once and adds the samples of its metrics
+bool Run(const Benchmark& benchmark, const std::filesystem::path& tools_dir,
+         std::map<std::string, Metric>& metrics) {
+    const std::string report_path =
+        (std::filesystem::temp_directory_path() / "citra-bench-report.json").string();
+    FileUtil::Delete(report_path);
+
+    std::string command = QuoteArgument((tools_dir / benchmark.tool).string());
+    for (const std::string& argument : benchmark.arguments) {
+        command += " " + QuoteArgument(argument);
+    }
+    command += " --json " + QuoteArgument(report_path);
+#ifdef _WIN32
+    // cmd strips the outer quotes of the command line
+    command = QuoteArgument(command);
+#endif
+    if (std::system(command.c_str()) != 0) {
+        std::cout << fmt::format("{} failed!\n", benchmark.name);
+        return false;
+    }
+
+    std::string contents;
+    FileUtil::ReadFileToString(true, report_path, contents);
+    FileUtil::Delete(report_path);
+    const auto report = nlohmann::json::parse(contents, nullptr, false);
+    if (report.is_discarded() || !report.contains("metrics")) {
+        std::cout << fmt::format("{} didn't write a valid report!\n", benchmark.name);
+        return false;
+    }
+    for (const auto& entry : report["metrics"]) {
+        Metric& metric = metrics[fmt::format("{}/{}", benchmark.name,
+                                             entry.value("name", std::string{}))];
+        metric.unit = entry.value("unit", std::string{});
+        metric.better = entry.value("better", std::string{"lower"});
+        for (const auto& sample : entry["samples"]) {
+            metric.samples.push_back(sample.get<double>());
+        }
+    }
+    return true;
+}
+
+double Percentile(const std::vector<double>& sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    return sorted[static_cast<std::size_t>(percentile / 100.0 * (sorted.size() - 1))];
+}
+
+nlohmann::json Summarize(const std::map<std::string, Metric>& metrics, u32 repeat) {
+    nlohmann::json summary{
+        {"version", std::string{Common::g_scm_desc}},
+        {"branch", std::string{Common::g_scm_branch}},
+        {"repeat", repeat},
+    };
+    auto& entries = summary["metrics"] = nlohmann::json::object();
+    for (const auto& [name, metric] : metrics) {
+        std::vector<double> sorted = metric.samples;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = 0.0;
+        for (const double sample : sorted) {
+            mean += sample;
+        }
+        mean /= std::max<std::size_t>(sorted.size(), 1);
+        double variance = 0.0;
+        for (const double sample : sorted) {
+            variance += (sample - mean) * (sample - mean);
+        }
+        variance /= std::max<std::size_t>(sorted.size(), 1);
+
+        entries[name] = {
+            {"unit", metric.unit},
+            {"better", metric.better},
+            {"median", Percentile(sorted, 50)},
+            {"p99", Percentile(sorted, 99)},
+            {"variance", variance},
+            {"samples", sorted.size()},
+        };
+    }
+    return summary;
+}
+
+/**
+ * Compares the medians to those of the baseline.
+ * @return 1 if a metric got worse, -1 if none got worse and one got better, 0 otherwise
+ */
+int Compare(const nlohmann::json& summary, const nlohmann::json& baseline, double threshold) {
+    bool slower = false;
+    bool faster = false;
+    const auto& base_metrics = baseline["metrics"];
+    for (const auto& [name, metric] : summary["metrics"].items()) {
+        if (!base_metrics.contains(name)) {
+            std::cout << fmt::format("{:<48} new\n", name);
+            continue;
+        }
+        const double base = base_metrics[name].value("median", 0.0);
+        const double median = metric.value("median", 0.0);
+        if (base == 0.0) {
+            continue;
+        }
+        const double change = (median / base - 1.0) * 100.0;
+        const bool lower_is_better = metric.value("better", std::string{}) == "lower";
+        const double improvement = lower_is_better ? -change : change;
+        const char* verdict = "";
+        if (improvement < -threshold) {
+            verdict = "slower";
+            slower = true;
+        } else if (improvement > threshold) {
+            verdict = "faster";
+            faster = true;
+        }
+        std::cout << fmt::format("{:<48} {:12.3f} -> {:12.3f} {:<8} {:+7.2f}% {}\n", name, base,
+                                 median, metric.value("unit", std::string{}), change, verdict);
+    }
+    return slower ? 1 : faster ? -1 : 0;
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    std::vector<std::string> traces;
+    u32 repeat = 5;
+    std::string output_path;
+    std::string baseline_path;
+    double threshold = 5.0;
+    std::filesystem::path tools_dir = std::filesystem::path{argv[0]}.parent_path();
+
+    static struct option long_options[] = {
+        {"trace", required_argument, 0, 't'},
+        {"repeat", required_argument, 0, 'r'},
+        {"output", required_argument, 0, 'o'},
+        {"baseline", required_argument, 0, 'b'},
+        {"threshold", required_argument, 0, 'p'},
+        {"tools", required_argument, 0, 'd'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "t:r:o:b:p:d:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 't':
+                traces.emplace_back(optarg);
+                break;
+            case 'r':
+                repeat = strtoul(optarg, &endarg, 0);
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'b':
+                baseline_path = optarg;
+                break;
+            case 'p':
+                threshold = std::strtod(optarg, nullptr);
+                break;
+            case 'd':
+                tools_dir = optarg;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            optind++;
+        }
+    }
+
+    if (repeat == 0 || threshold < 0.0) {
+        std::cout << "repeat needs to be at least 1 and threshold can't be negative!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    std::optional<nlohmann::json> baseline;
+    if (!baseline_path.empty()) {
+        std::string contents;
+        FileUtil::ReadFileToString(true, baseline_path, contents);
+        baseline = nlohmann::json::parse(contents, nullptr, false);
+        if (baseline->is_discarded() || !baseline->contains("metrics")) {
+            std::cout << fmt::format("Could not read the baseline {}!\n\n", baseline_path);
+            return -1;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks{
+        {"cpu", "citra-cpu-bench", {"--scale", "1"}},
+        {"audio", "citra-audio-bench", {"--frames", "2000"}},
+    };
+    for (const std::string& trace : traces) {
+        benchmarks.push_back({fmt::format("gpu/{}", std::filesystem::path{trace}.stem().string()),
+                              "citra-trace-bench",
+                              {"--passes", "2", "--scale", "1", trace}});
+    }
+
+    std::map<std::string, Metric> metrics;
+    for (u32 run = 1; run <= repeat; run++) {
+        for (const Benchmark& benchmark : benchmarks) {
+            std::cout << fmt::format("Running {}, {} of {}...\n", benchmark.name, run, repeat);
+            if (!Run(benchmark, tools_dir, metrics)) {
+                return -1;
+            }
+        }
+    }
+
+    const nlohmann::json summary = Summarize(metrics, repeat);
+    std::cout << "\n";
+    for (const auto& [name, metric] : summary["metrics"].items()) {
+        std::cout << fmt::format("{:<48} median {:12.3f} {:<8} p99 {:12.3f} variance {:.3f}\n",
+                                 name, metric["median"].get<double>(),
+                                 metric["unit"].get<std::string>(), metric["p99"].get<double>(),
+                                 metric["variance"].get<double>());
+    }
+
+    if (!output_path.empty()) {
+        const std::string contents = summary.dump(4) + "\n";
+        if (FileUtil::WriteStringToFile(true, output_path, contents) != contents.size()) {
+            std::cout << fmt::format("Could not write {}!\n", output_path);
+            return -1;
+        }
+    }
+
+    if (!baseline) {
+        return 0;
+    }
+    std::cout << fmt::format("\nCompared to {}:\n",
+                             baseline->value("version", std::string{"the baseline"}));
+    const int result = Compare(summary, *baseline, threshold);
+    std::cout << fmt::format("\nThis build is {}\n", result > 0   ? "slower"
+                                                     : result < 0 ? "faster"
+                                                                  : "as fast");
+    return result > 0 ? 1 : 0;
+}
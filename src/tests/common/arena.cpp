@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <catch2/catch_test_macros.hpp>
+#include "common/arena.h"
+
+namespace Common {
+
+TEST_CASE("LinearArena keeps allocations valid until the reset", "[common]") {
+    LinearArena arena{64, 1024};
+    const auto first = arena.AllocateArray<u32>(4);
+    std::memset(first.data(), 0xAB, first.size_bytes());
+    // Doesn't fit in the first block anymore
+    const auto second = arena.AllocateArray<u8>(200);
+    std::memset(second.data(), 0xCD, second.size_bytes());
+
+    REQUIRE(reinterpret_cast<uintptr_t>(first.data()) % alignof(std::max_align_t) == 0);
+    REQUIRE(first[3] == 0xABABABAB);
+    REQUIRE(second[199] == 0xCD);
+    REQUIRE(arena.GetStatistics().bytes == 216);
+    REQUIRE(arena.GetStatistics().block_allocations == 2);
+
+    const u64 generation = arena.GetGeneration();
+    arena.Reset();
+    REQUIRE(arena.GetGeneration() != generation);
+    REQUIRE(arena.GetStatistics().bytes == 0);
+    REQUIRE(arena.GetStatistics().peak_bytes == 216);
+}
+
+TEST_CASE("LinearArena reuses its memory after a reset", "[common]") {
+    LinearArena arena{64, 1024};
+    for (int i = 0; i < 4; ++i) {
+        arena.Allocate(100);
+        arena.Allocate(100);
+        arena.Reset();
+    }
+    // The blocks of the first round are merged into one, which is kept from then on
+    REQUIRE(arena.GetStatistics().block_allocations == 3);
+
+    arena.Allocate(2000);
+    arena.Reset();
+    const u64 block_allocations = arena.GetStatistics().block_allocations;
+    // Blocks larger than the retained size are freed
+    arena.Allocate(8);
+    REQUIRE(arena.GetStatistics().block_allocations == block_allocations + 1);
+}
+
+} // namespace Common
@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <numeric>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/hash.h"
+
+namespace Common {
+
+TEST_CASE("ComputeStructHash64 depends on every byte", "[common]") {
+    // Not a multiple of the word size, so that the last word is partial
+    struct Config {
+        std::array<u8, 45> bytes;
+    };
+    Config config{};
+    std::iota(config.bytes.begin(), config.bytes.end(), u8{1});
+    const u64 hash = ComputeStructHash64(config);
+    REQUIRE(ComputeStructHash64(config) == hash);
+    for (std::size_t i = 0; i < config.bytes.size(); ++i) {
+        Config changed = config;
+        changed.bytes[i] ^= 0x10;
+        REQUIRE(ComputeStructHash64(changed) != hash);
+    }
+}
+
+TEST_CASE("ComputeStructHash64 hashes large structs in bulk", "[common]") {
+    struct Config {
+        std::array<u32, 1024> words;
+    };
+    Config config{};
+    config.words[1000] = 1;
+    REQUIRE(ComputeStructHash64(config) == ComputeBulkHash64(&config, sizeof(config)));
+}
+
+TEST_CASE("ComputeBulkHash64 is deterministic", "[common]") {
+    std::vector<u8> data(100000);
+    std::iota(data.begin(), data.end(), u8{0});
+    const u64 hash = ComputeBulkHash64(data.data(), data.size());
+    REQUIRE(ComputeBulkHash64(data.data(), data.size()) == hash);
+    REQUIRE(ComputeBulkHash64(data.data(), data.size() - 1) != hash);
+    data[54321] ^= 1;
+    REQUIRE(ComputeBulkHash64(data.data(), data.size()) != hash);
+}
+
+} // namespace Common
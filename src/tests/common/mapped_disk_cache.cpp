@@ -0,0 +1,118 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "common/mapped_disk_cache.h"
+
+namespace Common {
+
+namespace {
+
+std::string GetCachePath() {
+    return (std::filesystem::temp_directory_path() / "citra_mapped_disk_cache_test.bin").string();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MappedDiskCache reads the entries of a reopened cache", "[common]") {
+    const std::string path = GetCachePath();
+    FileUtil::Delete(path);
+    const std::array<u8, 5> value{1, 2, 3, 4, 5};
+    {
+        MappedDiskCache cache;
+        REQUIRE(cache.Open(path, 1) == 0);
+        REQUIRE(cache.Append(10, value));
+        REQUIRE(!cache.Append(10, value));
+        REQUIRE(cache.Append(20, {}));
+        // Appended entries can be read before closing
+        const auto appended = cache.Get(10);
+        REQUIRE(appended);
+        REQUIRE(std::equal(appended->begin(), appended->end(), value.begin(), value.end()));
+    }
+
+    MappedDiskCache cache;
+    REQUIRE(cache.Open(path, 1) == 2);
+    REQUIRE(cache.Contains(20));
+    REQUIRE(cache.Get(20)->empty());
+    const auto read = cache.Get(10);
+    REQUIRE(read);
+    REQUIRE(std::equal(read->begin(), read->end(), value.begin(), value.end()));
+    REQUIRE(!cache.Get(30));
+
+    // A new version discards the entries
+    cache.Close();
+    REQUIRE(cache.Open(path, 2) == 0);
+    cache.Close();
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("MappedDiskCache drops an incomplete entry", "[common]") {
+    const std::string path = GetCachePath();
+    FileUtil::Delete(path);
+    const std::vector<u8> value(100, 0xAB);
+    {
+        MappedDiskCache cache;
+        REQUIRE(cache.Open(path, 1) == 0);
+        REQUIRE(cache.Append(1, value));
+        REQUIRE(cache.Append(2, value));
+    }
+    {
+        FileUtil::IOFile file(path, "r+b");
+        file.Resize(file.GetSize() - 10);
+    }
+
+    MappedDiskCache cache;
+    REQUIRE(cache.Open(path, 1) == 1);
+    REQUIRE(cache.Get(1)->size() == value.size());
+    // The next entry takes the place of the incomplete one
+    REQUIRE(cache.Append(2, value));
+    cache.Close();
+    REQUIRE(cache.Open(path, 1) == 2);
+    cache.Close();
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("MappedDiskCache appends from many threads", "[common]") {
+    const std::string path = GetCachePath();
+    FileUtil::Delete(path);
+    constexpr u64 NumThreads = 4;
+    constexpr u64 NumEntries = 100;
+    {
+        MappedDiskCache cache;
+        REQUIRE(cache.Open(path, 1) == 0);
+        std::vector<std::thread> threads;
+        for (u64 thread = 0; thread < NumThreads; ++thread) {
+            threads.emplace_back([&cache, thread] {
+                for (u64 i = 0; i < NumEntries; ++i) {
+                    const u64 key = thread * NumEntries + i;
+                    const std::vector<u8> value(key % 17, static_cast<u8>(key));
+                    cache.Append(key, value);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    MappedDiskCache cache;
+    REQUIRE(cache.Open(path, 1) == NumThreads * NumEntries);
+    for (u64 key = 0; key < NumThreads * NumEntries; ++key) {
+        const auto value = cache.Get(key);
+        REQUIRE(value);
+        REQUIRE(value->size() == key % 17);
+        REQUIRE(std::all_of(value->begin(), value->end(),
+                            [key](u8 byte) { return byte == static_cast<u8>(key); }));
+    }
+    cache.Close();
+    FileUtil::Delete(path);
+}
+
+} // namespace Common
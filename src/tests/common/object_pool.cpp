@@ -0,0 +1,50 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/object_pool.h"
+
+namespace Common {
+
+TEST_CASE("FixedSizePool reuses freed blocks", "[common]") {
+    FixedSizePool pool{24, 4};
+    std::vector<void*> blocks;
+    for (int i = 0; i < 5; ++i) {
+        blocks.push_back(pool.Allocate());
+        REQUIRE(reinterpret_cast<uintptr_t>(blocks.back()) % alignof(std::max_align_t) == 0);
+    }
+    REQUIRE(pool.GetStatistics().chunk_allocations == 2);
+
+    void* const freed = blocks[2];
+    pool.Free(freed);
+    REQUIRE(pool.Allocate() == freed);
+    REQUIRE(pool.GetStatistics().chunk_allocations == 2);
+    REQUIRE(pool.GetStatistics().allocations == 6);
+}
+
+TEST_CASE("PoolAllocator allocates shared objects from the pool", "[common]") {
+    struct Object {
+        std::string name;
+        u64 value;
+    };
+    std::weak_ptr<Object> weak;
+    {
+        const auto object = std::allocate_shared<Object>(PoolAllocator<Object>{}, "object", 1);
+        REQUIRE(object->name == "object");
+        weak = object;
+    }
+    REQUIRE(weak.expired());
+
+    // The control block and the object are allocated together, from the pool of that type
+    const auto first = std::allocate_shared<Object>(PoolAllocator<Object>{}, "first", 2);
+    const auto second = std::allocate_shared<Object>(PoolAllocator<Object>{}, "second", 3);
+    REQUIRE(first->value == 2);
+    REQUIRE(second->value == 3);
+    REQUIRE(first.get() != second.get());
+}
+
+} // namespace Common
@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+#include "common/seqlock.h"
+
+namespace Common {
+
+TEST_CASE("SeqLock: Stores and loads", "[common]") {
+    using Value = std::array<u16, 3>;
+    constexpr Value value{1, 2, 3};
+    SeqLock<Value> lock;
+    REQUIRE(lock.Load() == Value{});
+    lock.Store(value);
+    REQUIRE(lock.Load() == value);
+}
+
+TEST_CASE("SeqLock: Loads aren't torn by a concurrent writer", "[common]") {
+    // Every value stored has all of its elements equal
+    SeqLock<std::array<u32, 16>> lock;
+    std::atomic_bool done{false};
+    std::thread writer{[&] {
+        for (u32 i = 1; i <= 100000; i++) {
+            std::array<u32, 16> value;
+            value.fill(i);
+            lock.Store(value);
+        }
+        done = true;
+    }};
+
+    u32 previous = 0;
+    while (!done) {
+        const auto value = lock.Load();
+        for (const u32 element : value) {
+            REQUIRE(element == value[0]);
+        }
+        REQUIRE(value[0] >= previous);
+        previous = value[0];
+    }
+    writer.join();
+    REQUIRE(lock.Load()[0] == 100000);
+}
+
+} // namespace Common
@@ -0,0 +1,83 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/thread.h"
+#include "common/thread_pool.h"
+
+namespace Common {
+
+TEST_CASE("ThreadPool returns the results of submitted tasks", "[common]") {
+    ThreadPool pool{{.num_workers = 4}};
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.Submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(futures[i].get() == i * i);
+    }
+
+    auto failing = pool.Submit([]() -> int { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(failing.get(), std::runtime_error);
+}
+
+TEST_CASE("ThreadPool runs queued tasks by priority", "[common]") {
+    ThreadPool pool{{.num_workers = 1}};
+    Event started;
+    Event release;
+    pool.Submit([&] {
+        started.Set();
+        release.Wait();
+    });
+    started.Wait();
+
+    std::vector<TaskPriority> order;
+    std::vector<std::future<void>> futures;
+    for (const auto priority : {TaskPriority::Low, TaskPriority::Normal, TaskPriority::High}) {
+        futures.push_back(pool.Submit([&order, priority] { order.push_back(priority); }, priority));
+    }
+    release.Set();
+    for (auto& future : futures) {
+        future.get();
+    }
+    const std::vector expected{TaskPriority::High, TaskPriority::Normal, TaskPriority::Low};
+    REQUIRE(order == expected);
+}
+
+TEST_CASE("TaskGroup waits for nested groups", "[common]") {
+    // Every task waits for a group of its own, which only works if waiting threads run tasks
+    ThreadPool pool{{.num_workers = 2}};
+    std::atomic<int> sum{0};
+    TaskGroup group{pool};
+    for (int i = 0; i < 8; ++i) {
+        group.Run([&pool, &sum] {
+            TaskGroup inner{pool};
+            inner.RunForEach(100, [&sum](std::size_t index) { sum += static_cast<int>(index); });
+            inner.Wait();
+        });
+    }
+    group.Wait();
+    REQUIRE(sum == 8 * 4950);
+}
+
+TEST_CASE("TaskGroup rethrows the exception of a task", "[common]") {
+    ThreadPool pool{{.num_workers = 2}};
+    TaskGroup group{pool};
+    std::atomic<int> completed{0};
+    for (int i = 0; i < 10; ++i) {
+        group.Run([i, &completed] {
+            if (i == 5) {
+                throw std::runtime_error("task failed");
+            }
+            ++completed;
+        });
+    }
+    REQUIRE_THROWS_AS(group.Wait(), std::runtime_error);
+    REQUIRE(completed == 9);
+}
+
+} // namespace Common
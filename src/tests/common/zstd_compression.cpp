@@ -0,0 +1,127 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/zstd_compression.h"
+
+namespace Common::Compression {
+
+static std::vector<u8> TestData(std::size_t size) {
+    // Compressible, but not trivially
+    std::mt19937 rng{size};
+    std::vector<u8> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<u8>(rng() % 16);
+    }
+    return data;
+}
+
+/// Writes the data in chunks of varying size, including some much larger than the buffers
+static std::vector<u8> CompressStreamed(const std::vector<u8>& data, u32 num_threads) {
+    std::vector<u8> compressed;
+    ZSTDCompressionStreamBuffer buffer{[&compressed](std::span<const u8> chunk) {
+                                           compressed.insert(compressed.end(), chunk.begin(),
+                                                             chunk.end());
+                                           return true;
+                                       },
+                                       0, num_threads};
+    std::ostream stream{&buffer};
+    std::size_t position = 0;
+    std::size_t chunk_size = 1;
+    while (position < data.size()) {
+        const std::size_t size = std::min(chunk_size, data.size() - position);
+        if (size == 1) {
+            stream.put(static_cast<char>(data[position]));
+        } else {
+            stream.write(reinterpret_cast<const char*>(data.data() + position), size);
+        }
+        position += size;
+        chunk_size = chunk_size * 7 % 1000003;
+    }
+    REQUIRE(stream.good());
+    REQUIRE(buffer.Finish());
+    return compressed;
+}
+
+/// Reads the data back in chunks of varying size, feeding the compressed data in small pieces
+static std::vector<u8> DecompressStreamed(const std::vector<u8>& compressed, std::size_t size) {
+    std::size_t read_position = 0;
+    ZSTDDecompressionStreamBuffer buffer{[&](std::span<u8> out) {
+        const std::size_t count = std::min<std::size_t>({out.size(), 4096,
+                                                          compressed.size() - read_position});
+        std::copy_n(compressed.begin() + read_position, count, out.begin());
+        read_position += count;
+        return count;
+    }};
+    std::istream stream{&buffer};
+    std::vector<u8> data(size);
+    std::size_t position = 0;
+    std::size_t chunk_size = 1;
+    while (position < size) {
+        const std::size_t count = std::min(chunk_size, size - position);
+        stream.read(reinterpret_cast<char*>(data.data() + position), count);
+        REQUIRE(static_cast<std::size_t>(stream.gcount()) == count);
+        position += count;
+        chunk_size = chunk_size * 5 % 700001;
+    }
+    // The stream ends with the data
+    REQUIRE(stream.get() == std::char_traits<char>::eof());
+    REQUIRE(!buffer.HasFailed());
+    return data;
+}
+
+TEST_CASE("ZSTD stream buffers round trip", "[common]") {
+    const std::vector<u8> data = TestData(5 * 1024 * 1024 + 123);
+    for (const u32 num_threads : {0u, 4u}) {
+        const std::vector<u8> compressed = CompressStreamed(data, num_threads);
+        REQUIRE(compressed.size() < data.size());
+        REQUIRE(DecompressDataZSTD(compressed).empty()); // The content size isn't known up front
+        REQUIRE(DecompressStreamed(compressed, data.size()) == data);
+    }
+}
+
+TEST_CASE("ZSTD decompression stream buffer reads single shot frames", "[common]") {
+    const std::vector<u8> data = TestData(300000);
+    const std::vector<u8> compressed = CompressDataZSTDDefault(data.data(), data.size());
+    REQUIRE(DecompressStreamed(compressed, data.size()) == data);
+}
+
+TEST_CASE("ZSTD decompression stream buffer detects truncated data", "[common]") {
+    const std::vector<u8> data = TestData(300000);
+    std::vector<u8> compressed = CompressDataZSTDDefault(data.data(), data.size());
+    compressed.resize(compressed.size() / 2);
+    std::size_t read_position = 0;
+    ZSTDDecompressionStreamBuffer buffer{[&](std::span<u8> out) {
+        const std::size_t count = std::min(out.size(), compressed.size() - read_position);
+        std::copy_n(compressed.begin() + read_position, count, out.begin());
+        read_position += count;
+        return count;
+    }};
+    std::istream stream{&buffer};
+    std::vector<char> out(data.size());
+    stream.read(out.data(), out.size());
+    REQUIRE(static_cast<std::size_t>(stream.gcount()) < data.size());
+    REQUIRE(buffer.HasFailed());
+}
+
+TEST_CASE("ZSTD frames decompress in place", "[common]") {
+    const std::vector<u8> data = TestData(1024 * 1024);
+    const std::vector<u8> compressed = CompressDataZSTDDefault(data.data(), data.size());
+    std::vector<u8> destination(data.size());
+    REQUIRE(DecompressFrameZSTD(compressed, destination));
+    REQUIRE(destination == data);
+
+    // The destination has to match the content size
+    std::vector<u8> too_small(data.size() - 1);
+    REQUIRE(!DecompressFrameZSTD(compressed, too_small));
+    const std::vector<u8> truncated(compressed.begin(), compressed.end() - 16);
+    REQUIRE(!DecompressFrameZSTD(truncated, destination));
+}
+
+} // namespace Common::Compression
@@ -0,0 +1,414 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "common/arch.h"
+#include "common/benchmark_report.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/scm_rev.h"
+#include "core/arm/arm_interface.h"
+#include "core/arm/exclusive_monitor.h"
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+#include "core/arm/dynarmic/arm_dynarmic.h"
+#endif
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/vfp/asm_vfp.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options]\n"
+                 "Runs guest code snippets on the CPU backends and reports the guest instructions\n"
+                 "executed per second, the instructions translated and the exits from the JIT.\n\n"
+                 "--workload          The workload to run (alu, mem, vfp, call), all by default\n"
+                 "--code              A raw ARM binary to run instead, it has to end in `b .`\n"
+                 "--backend           The backend to use (dynarmic, dyncom), all by default\n"
+                 "--scale             Multiplies the iterations of the workloads\n"
+                 "--csv               Appends the results to a CSV file to track them over time\n"
+                 "--json              Writes the results to a JSON file for citra-bench\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra CPU benchmark " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+namespace {
+
+/// Where the code and the data of the workloads are mapped
+constexpr VAddr CodeAddress = 0x00100000;
+constexpr u32 CodeSize = 0x00100000;
+constexpr VAddr DataAddress = 0x08000000;
+constexpr u32 DataSize = 0x00080000;
+
+/// `b .`, the workloads end in it
+constexpr u32 HaltInstruction = 0xEAFFFFFE;
+
+/// Short slices, so that little time is spent in the final loop
+constexpr s64 SliceLength = 20000;
+
+/// A guest code snippet the iteration count of which is patched into a literal
+struct Workload {
+    const char* name;
+    std::vector<u32> code;
+    std::size_t iterations_index;
+    u32 iterations;
+    /// Returns the guest instructions executed for the iterations
+    u64 (*instructions)(u64 iterations);
+};
+
+std::vector<Workload> MakeWorkloads() {
+    return {
+        {
+            // xorshift32 in a tight loop, summing the values into r0
+            "alu",
+            {0xE59F1020, 0xE59F2020, 0xE3A00000, 0xE0222682, 0xE02228A2, 0xE0222282, 0xE0800002,
+             0xE2511001, 0x1AFFFFF9, HaltInstruction, 0, 0x12345678},
+            10,
+            10000000,
+            [](u64 iterations) { return 3 + 6 * iterations; },
+        },
+        {
+            // Copies the first half of the data to the second bytewise, summing the bytes in r0
+            "mem",
+            {0xE59F4030, 0xE59F6030, 0xE3A00000, 0xE1A01004, 0xE2842701, 0xE3A03701, 0xE4D15001,
+             0xE0800005, 0xE4C25001, 0xE2533001, 0x1AFFFFFA, 0xE2566001, 0x1AFFFFF5,
+             HaltInstruction, DataAddress, 0},
+            15,
+            40,
+            [](u64 iterations) { return 3 + iterations * (3 + (DataSize / 2) * 5 + 2); },
+        },
+        {
+            // Single precision multiplies and adds, the result is moved to r0
+            "vfp",
+            {0xE59F1030, 0xED9F0A0C, 0xEDDF0A0C, 0xEEB01A40, 0xEEF01A40, 0xEE211A20, 0xEE311A00,
+             0xEE411A20, 0xEE711AC1, 0xE2511001, 0x1AFFFFF9, 0xEE311A21, 0xEE110A10,
+             HaltInstruction, 0, 0x3F800000, 0x3F7FBE77},
+            14,
+            10000000,
+            [](u64 iterations) { return 7 + 6 * iterations; },
+        },
+        {
+            // Calls a function with conditionally executed instructions in a loop
+            "call",
+            {0xE59F1020, 0xE3A00000, 0xEB000002, 0xE2511001, 0x1AFFFFFC, HaltInstruction,
+             0xE3110001, 0x10800001, 0x02400003, 0xE12FFF1E, 0},
+            10,
+            8000000,
+            [](u64 iterations) { return 2 + 7 * iterations; },
+        },
+    };
+}
+
+struct Result {
+    double seconds;
+    u64 ticks;
+    u32 checksum;
+    ARM_Interface::Statistics statistics;
+    u64 slices;
+};
+
+/// Maps the memory of the workloads and holds the CPU cores
+class BenchEnvironment {
+public:
+    BenchEnvironment() : timing(1, 100), page_table(std::make_shared<Memory::PageTable>()) {
+        memory.MapMemoryRegion(*page_table, CodeAddress, CodeSize, memory.GetFCRAMRef(0));
+        memory.MapMemoryRegion(*page_table, DataAddress, DataSize,
+                               memory.GetFCRAMRef(CodeSize));
+        memory.SetCurrentPageTable(page_table);
+        exclusive_monitor = Core::MakeExclusiveMonitor(memory, 1);
+    }
+
+    ~BenchEnvironment() {
+        memory.UnmapRegion(*page_table, DataAddress, DataSize);
+        memory.UnmapRegion(*page_table, CodeAddress, CodeSize);
+    }
+
+    std::unique_ptr<ARM_Interface> MakeCore(const std::string& backend) {
+        // The workloads don't call into the kernel, the cores only need the system for locking
+        auto* system = &Core::System::GetInstance();
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+        if (backend == "dynarmic") {
+            return std::make_unique<ARM_Dynarmic>(system, memory, 0, timing.GetTimer(0),
+                                                  *exclusive_monitor);
+        }
+#endif
+        if (backend == "dyncom") {
+            return std::make_unique<ARM_DynCom>(system, memory, USER32MODE, 0,
+                                                timing.GetTimer(0));
+        }
+        return nullptr;
+    }
+
+    void LoadCode(const std::vector<u32>& code) {
+        memory.WriteBlock(CodeAddress, code.data(), code.size() * sizeof(u32));
+    }
+
+    void FillData() {
+        std::vector<u8> data(DataSize);
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<u8>(i * 7 + (i >> 9));
+        }
+        memory.WriteBlock(DataAddress, data.data(), data.size());
+    }
+
+    Result Run(ARM_Interface& cpu) {
+        cpu.ClearInstructionCache();
+        for (int i = 0; i < 15; i++) {
+            cpu.SetReg(i, 0);
+        }
+        cpu.SetCPSR(USER32MODE);
+        cpu.SetVFPSystemReg(VFP_FPSCR,
+                            FPSCR_DEFAULT_NAN | FPSCR_FLUSH_TO_ZERO | FPSCR_ROUND_TOZERO);
+        cpu.SetPC(CodeAddress);
+
+        auto& timer = cpu.GetTimer();
+        const auto statistics_before = cpu.GetStatistics();
+        const u64 ticks_before = timer.GetTicks();
+        u64 slices = 0;
+        const auto start = Clock::now();
+        while (memory.Read32(cpu.GetPC()) != HaltInstruction) {
+            timer.Advance();
+            timer.SetNextSlice(SliceLength);
+            cpu.Run();
+            slices++;
+        }
+        const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        auto statistics = cpu.GetStatistics();
+        statistics.blocks_translated -= statistics_before.blocks_translated;
+        statistics.instructions_translated -= statistics_before.instructions_translated;
+        statistics.host_calls -= statistics_before.host_calls;
+        return {seconds, timer.GetTicks() - ticks_before, cpu.GetReg(0), statistics, slices};
+    }
+
+private:
+    Core::Timing timing;
+    Memory::MemorySystem memory;
+    std::shared_ptr<Memory::PageTable> page_table;
+    std::unique_ptr<Core::ExclusiveMonitor> exclusive_monitor;
+};
+
+std::optional<std::vector<u32>> LoadBinary(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen() || file.GetSize() == 0 || file.GetSize() > CodeSize) {
+        return std::nullopt;
+    }
+    std::vector<u32> code((file.GetSize() + 3) / 4);
+    if (file.ReadBytes(code.data(), file.GetSize()) != file.GetSize()) {
+        return std::nullopt;
+    }
+    return code;
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+
+    std::string workload_name;
+    std::string code_path;
+    std::string backend_name;
+    std::string csv_path;
+    std::string json_path;
+    double scale = 1.0;
+
+    static struct option long_options[] = {
+        {"workload", required_argument, 0, 'w'},
+        {"code", required_argument, 0, 'c'},
+        {"backend", required_argument, 0, 'b'},
+        {"scale", required_argument, 0, 's'},
+        {"csv", required_argument, 0, 'o'},
+        {"json", required_argument, 0, 'j'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "w:c:b:s:o:j:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'w':
+                workload_name.assign(optarg);
+                break;
+            case 'c':
+                code_path.assign(optarg);
+                break;
+            case 'b':
+                backend_name.assign(optarg);
+                break;
+            case 's':
+                scale = std::strtod(optarg, nullptr);
+                break;
+            case 'o':
+                csv_path.assign(optarg);
+                break;
+            case 'j':
+                json_path.assign(optarg);
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        }
+    }
+
+    if (scale <= 0.0) {
+        std::cout << "scale needs to be positive!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    std::vector<Workload> workloads;
+    if (!code_path.empty()) {
+        const auto code = LoadBinary(code_path);
+        if (!code) {
+            std::cout << fmt::format("Could not load {}!\n\n", code_path);
+            return -1;
+        }
+        // The instructions executed by a custom binary aren't known, only the ticks are reported
+        workloads.push_back({"custom", *code, 0, 0, nullptr});
+    } else {
+        for (auto& workload : MakeWorkloads()) {
+            if (workload_name.empty() || workload_name == workload.name) {
+                workload.iterations = std::max<u32>(
+                    static_cast<u32>(workload.iterations * scale), 1);
+                workload.code[workload.iterations_index] = workload.iterations;
+                workloads.push_back(std::move(workload));
+            }
+        }
+        if (workloads.empty()) {
+            std::cout << fmt::format("Unknown workload {}!\n\n", workload_name);
+            PrintHelp(argv[0]);
+            return -1;
+        }
+    }
+
+    std::vector<std::string> backends;
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    backends.push_back("dynarmic");
+#endif
+    backends.push_back("dyncom");
+    if (!backend_name.empty()) {
+        if (std::find(backends.begin(), backends.end(), backend_name) == backends.end()) {
+            std::cout << fmt::format("The backend {} is not available!\n\n", backend_name);
+            PrintHelp(argv[0]);
+            return -1;
+        }
+        backends = {backend_name};
+    }
+
+    std::FILE* csv = nullptr;
+    if (!csv_path.empty()) {
+        const bool is_new = !FileUtil::Exists(csv_path);
+        csv = std::fopen(csv_path.c_str(), "a");
+        if (!csv) {
+            std::cout << fmt::format("Could not open {}!\n\n", csv_path);
+            return -1;
+        }
+        if (is_new) {
+            fmt::print(csv, "time,version,workload,backend,seconds,mips,ticks_per_second,"
+                            "blocks_translated,instructions_translated,jit_exits,checksum\n");
+        }
+    }
+
+    Common::BenchmarkReport report{"citra-cpu-bench"};
+    report.AddConfig("workload", code_path.empty() ? workload_name : code_path);
+    report.AddConfig("backend", backend_name);
+    report.AddConfig("scale", fmt::format("{}", scale));
+
+    BenchEnvironment environment;
+    int status = 0;
+    for (const auto& workload : workloads) {
+        environment.LoadCode(workload.code);
+        std::optional<u32> checksum;
+        for (const auto& backend : backends) {
+            environment.FillData();
+            const auto cpu = environment.MakeCore(backend);
+            const Result result = environment.Run(*cpu);
+
+            const double mips =
+                workload.instructions ? workload.instructions(workload.iterations) /
+                                            result.seconds / 1e6
+                                      : 0.0;
+            // Every slice ends in an exit from the JIT as well
+            const u64 exits = backend == "dynarmic" ? result.statistics.host_calls + result.slices
+                                                    : 0;
+            std::cout << fmt::format("{:<8} {:<8} {:8.3f} s", workload.name, backend,
+                                     result.seconds);
+            if (workload.instructions) {
+                std::cout << fmt::format(" {:9.1f} MIPS", mips);
+            }
+            std::cout << fmt::format(" {:9.1f} Mticks/s, translated {} blocks, {} instructions",
+                                     result.ticks / result.seconds / 1e6,
+                                     result.statistics.blocks_translated,
+                                     result.statistics.instructions_translated);
+            if (backend == "dynarmic") {
+                std::cout << fmt::format(", {} JIT exits", exits);
+            }
+            std::cout << fmt::format(", r0 = {:08X}\n", result.checksum);
+
+            if (csv) {
+                fmt::print(csv, "{},{},{},{},{:.6f},{:.3f},{:.0f},{},{},{},{:08X}\n",
+                           std::time(nullptr), Common::g_scm_desc, workload.name, backend,
+                           result.seconds, mips, result.ticks / result.seconds,
+                           result.statistics.blocks_translated,
+                           result.statistics.instructions_translated, exits, result.checksum);
+            }
+
+            using Better = Common::BenchmarkReport::Better;
+            const std::string metric = fmt::format("{}/{}", workload.name, backend);
+            report.AddSample(metric + "/seconds", "s", Better::Lower, result.seconds);
+            report.AddSample(metric + "/ticks_per_second", "Mticks/s", Better::Higher,
+                             result.ticks / result.seconds / 1e6);
+            if (workload.instructions) {
+                report.AddSample(metric + "/mips", "MIPS", Better::Higher, mips);
+            }
+
+            // The backends have to agree on the result
+            if (checksum && *checksum != result.checksum) {
+                std::cout << fmt::format("{} computed {:08X} instead of {:08X}!\n", backend,
+                                         result.checksum, *checksum);
+                status = 1;
+            }
+            checksum = result.checksum;
+        }
+    }
+
+    if (csv) {
+        std::fclose(csv);
+    }
+    if (!json_path.empty() && !report.Save(json_path)) {
+        status = 1;
+    }
+    return status;
+}
@@ -140,6 +140,37 @@ TEST_CASE("CoreTiming[PredictableLateness]", "[core]") {
     AdvanceAndCheck(timing, 1, MAX_SLICE_LENGTH, 50, -50);
 }
 
+TEST_CASE("CoreTiming[UnscheduleEvent]", "[core]") {
+    Core::Timing timing(1, 100);
+
+    Core::TimingEventType* cb_a = timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+    Core::TimingEventType* cb_b = timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+    Core::TimingEventType* cb_c = timing.RegisterEvent("callbackC", CallbackTemplate<2>);
+
+    // Enter slice 0
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    timing.ScheduleEvent(100, cb_a, CB_IDS[0], 0);
+    timing.ScheduleEvent(200, cb_a, CB_IDS[1], 0);
+    timing.ScheduleEvent(300, cb_b, CB_IDS[1], 0);
+    timing.ScheduleEvent(400, cb_c, CB_IDS[2], 0);
+    timing.ScheduleEvent(500, cb_c, CB_IDS[2], 0);
+
+    // Only the events matching both the type and the user data are removed
+    timing.UnscheduleEvent(cb_a, CB_IDS[0]);
+    timing.UnscheduleEvent(cb_c, CB_IDS[2]);
+    callbacks_ran_flags = 0;
+    timing.GetTimer(0)->AddTicks(timing.GetTimer(0)->GetDowncount());
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+    REQUIRE(0 == callbacks_ran_flags.to_ullong());
+    REQUIRE(100 == timing.GetTimer(0)->GetDowncount());
+
+    timing.UnscheduleEvent(cb_a, CB_IDS[1]);
+    AdvanceAndCheck(timing, 1, MAX_SLICE_LENGTH, 0, -100); // cb_b at 300
+}
+
 namespace ChainSchedulingTest {
 static int reschedules = 0;
 
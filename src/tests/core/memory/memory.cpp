@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include "core/core_timing.h"
 #include "core/hle/kernel/process.h"
@@ -52,3 +54,45 @@ TEST_CASE("memory.IsValidVirtualAddress", "[core][memory]") {
         CHECK(memory.IsValidVirtualAddress(*process, Memory::CONFIG_MEMORY_VADDR) == false);
     }
 }
+
+TEST_CASE("memory.StateMemoryCopy", "[core][memory]") {
+    Memory::MemorySystem memory;
+    std::vector<u8> copy(Memory::MemorySystem::StateMemorySize);
+    std::vector<std::size_t> changed_offsets;
+    std::vector<u8> old_contents;
+    const auto update = [&] {
+        changed_offsets.clear();
+        old_contents.clear();
+        memory.UpdateStateMemoryCopy(copy, [&](std::size_t offset, std::span<const u8> old_page) {
+            changed_offsets.push_back(offset);
+            old_contents.insert(old_contents.end(), old_page.begin(), old_page.end());
+        });
+    };
+
+    update();
+    CHECK(changed_offsets.empty());
+
+    memory.GetFCRAMPointer(0x1000)[12] = 0xAB;
+    memory.GetFCRAMPointer(0x5000)[34] = 0xCD;
+    update();
+    CHECK(changed_offsets == std::vector<std::size_t>{0x1000, 0x5000});
+    CHECK(std::all_of(old_contents.begin(), old_contents.end(), [](u8 byte) { return byte == 0; }));
+    CHECK(copy[0x1000 + 12] == 0xAB);
+    CHECK(copy[0x5000 + 34] == 0xCD);
+    const std::vector<u8> first = copy;
+
+    memory.GetFCRAMPointer(0x1000)[12] = 0xEF;
+    memory.ZeroFCRAM(0x5000, Memory::CITRA_PAGE_SIZE);
+    update();
+    CHECK(changed_offsets == std::vector<std::size_t>{0x1000, 0x5000});
+    CHECK(old_contents[12] == 0xAB);
+    CHECK(old_contents[Memory::CITRA_PAGE_SIZE + 34] == 0xCD);
+    CHECK(copy[0x5000 + 34] == 0);
+
+    memory.RestoreStateMemory(first);
+    CHECK(memory.GetFCRAMPointer(0x1000)[12] == 0xAB);
+    CHECK(memory.GetFCRAMPointer(0x5000)[34] == 0xCD);
+    copy = first;
+    update();
+    CHECK(changed_offsets.empty());
+}
@@ -0,0 +1,64 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/file_util.h"
+#include "core/tracer/reader.h"
+#include "core/tracer/recorder.h"
+
+namespace CiTrace {
+
+TEST_CASE("CiTrace recordings load back", "[core][tracer]") {
+    const std::string path =
+        FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "citrace_test.ctf";
+
+    Recorder::InitialState state;
+    state.gpu_registers = {1, 2, 3};
+    state.pica_registers.resize(0x300, 0x12345678);
+    state.vs_float_uniforms = {4, 5};
+
+    std::vector<u8> memory(0x10000);
+    for (std::size_t i = 0; i < memory.size(); i++) {
+        memory[i] = static_cast<u8>(i * 7);
+    }
+
+    {
+        Recorder recorder{state};
+        recorder.MemoryAccessed(memory.data(), 0x8000, 0x18000000);
+        recorder.RegisterWritten<u32>(0x1EF00018, 0xABCD);
+        // The same contents are stored once
+        recorder.MemoryAccessed(memory.data(), 0x8000, 0x18100000);
+        recorder.MemoryAccessed(memory.data() + 0x100, 0x100, 0x20000000);
+        recorder.FrameFinished();
+        recorder.Finish(path);
+    }
+
+    const auto trace = Trace::Load(path);
+    REQUIRE(trace.has_value());
+    REQUIRE(FileUtil::GetSize(path) < memory.size());
+    FileUtil::Delete(path);
+
+    REQUIRE(trace->GetInitialState().gpu_registers == state.gpu_registers);
+    REQUIRE(trace->GetInitialState().pica_registers == state.pica_registers);
+    REQUIRE(trace->GetInitialState().vs_float_uniforms == state.vs_float_uniforms);
+    REQUIRE(trace->GetInitialState().lcd_registers.empty());
+
+    const auto& elements = trace->GetElements();
+    REQUIRE(elements.size() == 5);
+    REQUIRE(elements[0].data.type == MemoryLoad);
+    REQUIRE(elements[0].data.memory_load.physical_address == 0x18000000);
+    REQUIRE(std::vector<u8>(elements[0].memory.begin(), elements[0].memory.end()) ==
+            std::vector<u8>(memory.begin(), memory.begin() + 0x8000));
+    REQUIRE(elements[1].data.type == RegisterWrite);
+    REQUIRE(elements[1].data.register_write.size == CTRegisterWrite::SIZE_32);
+    REQUIRE(elements[1].data.register_write.value == 0xABCD);
+    REQUIRE(elements[2].data.memory_load.file_offset == elements[0].data.memory_load.file_offset);
+    REQUIRE(elements[2].data.memory_load.physical_address == 0x18100000);
+    REQUIRE(std::vector<u8>(elements[3].memory.begin(), elements[3].memory.end()) ==
+            std::vector<u8>(memory.begin() + 0x100, memory.begin() + 0x200));
+    REQUIRE(elements[4].data.type == FrameMarker);
+}
+
+} // namespace CiTrace
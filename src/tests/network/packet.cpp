@@ -0,0 +1,44 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "network/packet.h"
+
+using namespace Network;
+
+TEST_CASE("Packet round-trips byte vectors and arrays", "[network]") {
+    const std::vector<u8> data{1, 2, 3, 0xFF, 0, 42};
+    const std::array<u8, 6> mac{0x00, 0x1F, 0x32, 0xAB, 0xCD, 0xEF};
+    const std::vector<u16> words{0x1234, 0xABCD};
+
+    Packet packet;
+    packet << static_cast<u8>(5) << mac << data << words;
+    // The size prefix is followed by the bytes as they are
+    REQUIRE(packet.GetDataSize() == 1 + mac.size() + 4 + data.size() + 4 + words.size() * 2);
+
+    u8 type = 0;
+    std::array<u8, 6> read_mac{};
+    std::vector<u8> read_data;
+    std::vector<u16> read_words;
+    packet >> type >> read_mac >> read_data >> read_words;
+    REQUIRE(packet);
+    REQUIRE(packet.EndOfPacket());
+    REQUIRE(type == 5);
+    REQUIRE(read_mac == mac);
+    REQUIRE(read_data == data);
+    REQUIRE(read_words == words);
+}
+
+TEST_CASE("Packet rejects a byte vector longer than the packet", "[network]") {
+    Packet packet;
+    packet << static_cast<u32>(1000);
+    packet << static_cast<u8>(1);
+
+    std::vector<u8> data{1, 2, 3};
+    packet >> data;
+    REQUIRE_FALSE(packet);
+    REQUIRE(data.empty());
+}
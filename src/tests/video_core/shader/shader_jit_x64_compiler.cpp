@@ -107,6 +107,40 @@ TEST_CASE("EX2", "[video_core][shader][shader_jit]") {
     REQUIRE(std::isinf(shader.Run(800.f)));
 }
 
+TEST_CASE("DP3", "[video_core][shader][shader_jit]") {
+    const auto sh_input1 = SourceRegister::MakeInput(0);
+    const auto sh_input2 = SourceRegister::MakeInput(1);
+    const auto sh_output = DestRegister::MakeOutput(0);
+
+    auto shader = ShaderTest({
+        // clang-format off
+        {OpCode::Id::DP3, sh_output, sh_input1, sh_input2},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    const auto run = [&shader](Common::Vec4<float> a, Common::Vec4<float> b) {
+        Pica::Shader::UnitState shader_unit;
+        for (std::size_t i = 0; i < 4; ++i) {
+            shader_unit.registers.input[0][i] = float24::FromFloat32(a[i]);
+            shader_unit.registers.input[1][i] = float24::FromFloat32(b[i]);
+        }
+        shader.shader_jit.Run(*shader.shader_setup, shader_unit, 0);
+        return shader_unit.registers.output[0];
+    };
+
+    const auto result = run({1.f, 2.f, 3.f, 100.f}, {4.f, 5.f, 6.f, 100.f});
+    for (std::size_t i = 0; i < 4; ++i) {
+        REQUIRE(result[i].ToFloat32() == 32.f);
+    }
+
+    // The W component must not contribute, not even through the sign of a zero sum
+    const auto zero = run({-0.f, -0.f, -0.f, 1.f}, {1.f, 1.f, 1.f, 1.f});
+    REQUIRE(zero.x.ToFloat32() == 0.f);
+    REQUIRE(std::signbit(zero.x.ToFloat32()));
+    REQUIRE(std::isnan(run({1.f, 1.f, NAN, 1.f}, {1.f, 1.f, 1.f, 1.f}).x.ToFloat32()));
+}
+
 TEST_CASE("Nested Loop", "[video_core][shader][shader_jit]") {
     const auto sh_input = SourceRegister::MakeInput(0);
     const auto sh_temp = SourceRegister::MakeTemporary(0);
@@ -0,0 +1,45 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+#include "video_core/texture/texture_decode.h"
+
+using Pica::TexturingRegs;
+using TextureFormat = TexturingRegs::TextureFormat;
+
+static void CheckDecodeTile(TextureFormat format) {
+    Pica::Texture::TextureInfo info{};
+    info.width = 8;
+    info.height = 8;
+    info.format = format;
+    info.SetDefaultStride();
+
+    std::mt19937 rng{static_cast<u32>(format)};
+    std::array<u8, 8 * 8 * 4> tile;
+    std::array<Common::Vec4<u8>, 8 * 8> texels;
+
+    for (int iteration = 0; iteration < 64; ++iteration) {
+        std::generate(tile.begin(), tile.end(), [&rng] { return static_cast<u8>(rng()); });
+        Pica::Texture::DecodeTile(tile.data(), info, texels.data());
+
+        for (unsigned y = 0; y < 8; ++y) {
+            for (unsigned x = 0; x < 8; ++x) {
+                const auto expected =
+                    Pica::Texture::LookupTexelInTile(tile.data(), x, y, info, false);
+                REQUIRE(texels[y * 8 + x] == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("DecodeTile matches LookupTexelInTile", "[video_core][texture]") {
+    for (const auto format : {TextureFormat::RGBA8, TextureFormat::RGB565, TextureFormat::IA8,
+                              TextureFormat::I4, TextureFormat::A4, TextureFormat::ETC1,
+                              TextureFormat::ETC1A4}) {
+        CheckDecodeTile(format);
+    }
+}
@@ -2,14 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <utility>
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "common/vector_math.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hw/gpu.h"
@@ -26,6 +31,7 @@
 #include "video_core/regs_texturing.h"
 #include "video_core/renderer_base.h"
 #include "video_core/shader/shader.h"
+#include "video_core/vertex_batch_processor.h"
 #include "video_core/vertex_loader.h"
 #include "video_core/video_core.h"
 
@@ -39,6 +45,95 @@ constexpr std::array<u32, 16> expand_bits_to_bytes{
 
 MICROPROFILE_DEFINE(GPU_Drawing, "GPU", "Drawing", MP_RGB(50, 50, 240));
 
+static std::unique_ptr<VertexBatchProcessor> vertex_batch_processor;
+
+/// Returns the processor shading the vertices of large draws, or null when single threaded
+static VertexBatchProcessor* GetVertexBatchProcessor() {
+    u32 num_threads = Settings::values.vertex_shader_threads.GetValue();
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (num_threads <= 1) {
+        vertex_batch_processor = nullptr;
+    } else if (!vertex_batch_processor || vertex_batch_processor->GetNumThreads() != num_threads) {
+        vertex_batch_processor = std::make_unique<VertexBatchProcessor>(num_threads);
+    }
+    return vertex_batch_processor.get();
+}
+
+/**
+ * Hashes everything the triangles of a draw shaded on the CPU depend on: the vertex and index data
+ * it reads, the pipeline configuration, the vertex shader and its uniforms.
+ * @returns nothing if the draw has to be shaded, because it depends on or leaves vertices in the
+ *          primitive assembler or goes through a geometry shader
+ */
+static std::optional<u64> GetShadedVerticesKey(const Regs& regs, bool is_indexed) {
+    const auto& pipeline = regs.pipeline;
+    if (pipeline.use_gs != PipelineRegs::UseGS::No || !g_state.geometry_pipeline.IsEmpty() ||
+        !g_state.primitive_assembler.IsEmpty() ||
+        g_state.primitive_assembler.GetTopology() != PipelineRegs::TriangleTopology::List ||
+        pipeline.num_vertices == 0 || pipeline.num_vertices % 3 != 0) {
+        return std::nullopt;
+    }
+
+    // The registers from the vertex attributes to the vertex offset, and the ones after the
+    // command buffer, which is at a different address every frame
+    const u8* pipeline_data = reinterpret_cast<const u8*>(&pipeline);
+    const std::size_t vertex_config_size = offsetof(PipelineRegs, trigger_draw);
+    const std::size_t shader_config_offset = offsetof(PipelineRegs, max_input_attrib_index);
+    std::size_t key = Common::ComputeBulkHash64(pipeline_data, vertex_config_size);
+    Common::HashCombine(key, Common::ComputeBulkHash64(pipeline_data + shader_config_offset,
+                                                       sizeof(pipeline) - shader_config_offset));
+
+    const u32 base_address = pipeline.vertex_attributes.GetPhysicalBaseAddress();
+    u32 vertex_min = pipeline.vertex_offset;
+    u32 vertex_max = pipeline.vertex_offset + pipeline.num_vertices - 1;
+    if (is_indexed) {
+        const bool index_u16 = pipeline.index_array.format != 0;
+        const u8* index_data =
+            VideoCore::g_memory->GetPhysicalPointer(base_address + pipeline.index_array.offset);
+        if (!index_data) {
+            return std::nullopt;
+        }
+        Common::HashCombine(key, Common::ComputeBulkHash64(
+                                     index_data, pipeline.num_vertices * (index_u16 ? 2 : 1)));
+        vertex_min = 0xFFFF;
+        vertex_max = 0;
+        for (u32 index = 0; index < pipeline.num_vertices; ++index) {
+            const u32 vertex = index_u16 ? reinterpret_cast<const u16*>(index_data)[index]
+                                         : index_data[index];
+            vertex_min = std::min(vertex_min, vertex);
+            vertex_max = std::max(vertex_max, vertex);
+        }
+    }
+
+    for (const auto& loader : pipeline.vertex_attributes.attribute_loaders) {
+        if (loader.component_count == 0 || loader.byte_count == 0) {
+            continue;
+        }
+        const u8* data = VideoCore::g_memory->GetPhysicalPointer(
+            base_address + loader.data_offset + loader.byte_count * vertex_min);
+        if (!data) {
+            return std::nullopt;
+        }
+        Common::HashCombine(key, Common::ComputeBulkHash64(
+                                     data, loader.byte_count * (vertex_max - vertex_min + 1)));
+    }
+
+    Common::HashCombine(key, Common::ComputeBulkHash64(&regs.vs, sizeof(regs.vs)));
+    Common::HashCombine(key, g_state.vs.GetProgramCodeHash());
+    Common::HashCombine(key, g_state.vs.GetSwizzleDataHash());
+    Common::HashCombine(key,
+                        Common::ComputeBulkHash64(&g_state.vs.uniforms, sizeof(Shader::Uniforms)));
+    Common::HashCombine(key, Common::ComputeBulkHash64(&g_state.input_default_attributes,
+                                                       sizeof(g_state.input_default_attributes)));
+    Common::HashCombine(key, regs.rasterizer.vs_output_total.Value());
+    const auto& output_attributes = regs.rasterizer.vs_output_attributes;
+    Common::HashCombine(key,
+                        Common::ComputeBulkHash64(output_attributes, sizeof(output_attributes)));
+    return key;
+}
+
 static const char* GetShaderSetupTypeName(Shader::ShaderSetup& setup) {
     if (&setup == &g_state.vs) {
         return "vertex shader";
@@ -124,6 +219,9 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         return;
     }
 
+    // Draws batched by the rasterizer have to be submitted with the state they were recorded with
+    VideoCore::g_renderer->Rasterizer()->NotifyPicaRegisterChanging(id);
+
     // TODO: Figure out how register masking acts on e.g. vs.uniform_setup.set_value
     u32 old_value = regs.reg_array[id];
 
@@ -143,7 +241,11 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
     switch (id) {
     // Trigger IRQ
     case PICA_REG_INDEX(trigger_irq):
-        Service::GSP::SignalInterrupt(Service::GSP::InterruptId::P3D);
+        // With the GPU thread enabled the interrupt is raised by the CPU thread on submission,
+        // since the kernel must not be touched from the GPU thread.
+        if (!VideoCore::g_gpu_thread) {
+            Service::GSP::SignalInterrupt(Service::GSP::InterruptId::P3D);
+        }
         break;
 
     case PICA_REG_INDEX(pipeline.triangle_topology):
@@ -298,19 +400,42 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
             // this, so this is left unimplemented for now. Revisit this when an issue is found in
             // games.
         } else {
-            accelerate_draw = false;
+            // Host geometry shaders can only consume whole invocations of the Point mode, leftover
+            // vertices would have to stay buffered in the software pipeline.
+            const u32 vs_outputs = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+            const u32 gs_inputs = regs.gs.max_input_attribute_index + 1;
+            accelerate_draw = accelerate_draw && g_state.geometry_pipeline.IsEmpty() &&
+                              regs.pipeline.gs_config.mode == PipelineRegs::GSMode::Point &&
+                              gs_inputs % vs_outputs == 0 &&
+                              regs.pipeline.num_vertices % (gs_inputs / vs_outputs) == 0;
         }
 
         bool is_indexed = (id == PICA_REG_INDEX(pipeline.trigger_draw_indexed));
 
         if (accelerate_draw &&
             VideoCore::g_renderer->Rasterizer()->AccelerateDrawBatch(is_indexed)) {
+            if (regs.pipeline.use_gs != PipelineRegs::UseGS::No) {
+                // Matches the software pipeline, which sets b15 after every invocation
+                g_state.gs.uniforms.b[15] = true;
+            }
             if (g_debug_context) {
                 g_debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr);
             }
             break;
         }
 
+        // Static geometry is drawn the same way every frame, so the rasterizer can keep the
+        // triangles instead of shading the vertices again. The debugger observes every invocation.
+        auto* rasterizer = VideoCore::g_renderer->Rasterizer();
+        std::optional<u64> shaded_key;
+        if (!g_debug_context && rasterizer->CachesShadedVertices()) {
+            shaded_key = GetShadedVerticesKey(regs, is_indexed);
+        }
+        if (shaded_key && rasterizer->LoadShadedVertices(*shaded_key)) {
+            rasterizer->DrawTriangles();
+            break;
+        }
+
         // Processes information about internal vertex attributes to figure out how a vertex is
         // loaded.
         // Later, these can be compiled and cached.
@@ -363,58 +488,82 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
         if (g_state.geometry_pipeline.NeedIndexInput())
             ASSERT(is_indexed);
 
-        for (unsigned int index = 0; index < regs.pipeline.num_vertices; ++index) {
-            // Indexed rendering doesn't use the start offset
-            unsigned int vertex =
-                is_indexed ? (index_u16 ? index_address_16[index] : index_address_8[index])
-                           : (index + regs.pipeline.vertex_offset);
+        // Large draws are shaded on multiple threads, the outputs are then submitted in order.
+        // The debugger observes every invocation so it always takes the serial path.
+        VertexBatchProcessor* batch_processor = nullptr;
+        if (!g_debug_context && !g_state.geometry_pipeline.NeedIndexInput() &&
+            regs.pipeline.num_vertices >= VertexBatchProcessor::MIN_BATCH_VERTICES) {
+            batch_processor = GetVertexBatchProcessor();
+        }
 
-            bool vertex_cache_hit = false;
+        if (batch_processor) {
+            const VertexBatch batch{
+                .base_address = base_address,
+                .num_vertices = regs.pipeline.num_vertices,
+                .vertex_offset = regs.pipeline.vertex_offset,
+                .is_indexed = is_indexed,
+                .index_u16 = index_u16,
+                .index_data = index_address_8,
+            };
+            const auto& outputs =
+                batch_processor->Process(regs.vs, g_state.vs, loader, shader_engine, batch);
+            for (const auto& output : outputs) {
+                g_state.geometry_pipeline.SubmitVertex(output);
+            }
+        } else {
+            for (unsigned int index = 0; index < regs.pipeline.num_vertices; ++index) {
+                // Indexed rendering doesn't use the start offset
+                unsigned int vertex =
+                    is_indexed ? (index_u16 ? index_address_16[index] : index_address_8[index])
+                               : (index + regs.pipeline.vertex_offset);
 
-            if (is_indexed) {
-                if (g_state.geometry_pipeline.NeedIndexInput()) {
-                    g_state.geometry_pipeline.SubmitIndex(vertex);
-                    continue;
-                }
+                bool vertex_cache_hit = false;
 
-                if (g_debug_context && Pica::g_debug_context->recorder) {
-                    int size = index_u16 ? 2 : 1;
-                    memory_accesses.AddAccess(base_address + index_info.offset + size * index,
-                                              size);
-                }
+                if (is_indexed) {
+                    if (g_state.geometry_pipeline.NeedIndexInput()) {
+                        g_state.geometry_pipeline.SubmitIndex(vertex);
+                        continue;
+                    }
+
+                    if (g_debug_context && Pica::g_debug_context->recorder) {
+                        int size = index_u16 ? 2 : 1;
+                        memory_accesses.AddAccess(base_address + index_info.offset + size * index,
+                                                  size);
+                    }
 
-                for (unsigned int i = 0; i < VERTEX_CACHE_SIZE; ++i) {
-                    if (vertex_cache_valid[i] && vertex == vertex_cache_ids[i]) {
-                        vs_output = vertex_cache[i];
-                        vertex_cache_hit = true;
-                        break;
+                    for (unsigned int i = 0; i < VERTEX_CACHE_SIZE; ++i) {
+                        if (vertex_cache_valid[i] && vertex == vertex_cache_ids[i]) {
+                            vs_output = vertex_cache[i];
+                            vertex_cache_hit = true;
+                            break;
+                        }
                     }
                 }
-            }
 
-            if (!vertex_cache_hit) {
-                // Initialize data for the current vertex
-                Shader::AttributeBuffer input;
-                loader.LoadVertex(base_address, index, vertex, input, memory_accesses);
+                if (!vertex_cache_hit) {
+                    // Initialize data for the current vertex
+                    Shader::AttributeBuffer input;
+                    loader.LoadVertex(base_address, index, vertex, input, memory_accesses);
 
-                // Send to vertex shader
-                if (g_debug_context)
-                    g_debug_context->OnEvent(DebugContext::Event::VertexShaderInvocation,
-                                             (void*)&input);
-                shader_unit.LoadInput(regs.vs, input);
-                shader_engine->Run(g_state.vs, shader_unit);
-                shader_unit.WriteOutput(regs.vs, vs_output);
+                    // Send to vertex shader
+                    if (g_debug_context)
+                        g_debug_context->OnEvent(DebugContext::Event::VertexShaderInvocation,
+                                                 (void*)&input);
+                    shader_unit.LoadInput(regs.vs, input);
+                    shader_engine->Run(g_state.vs, shader_unit);
+                    shader_unit.WriteOutput(regs.vs, vs_output);
 
-                if (is_indexed) {
-                    vertex_cache[vertex_cache_pos] = vs_output;
-                    vertex_cache_valid[vertex_cache_pos] = true;
-                    vertex_cache_ids[vertex_cache_pos] = vertex;
-                    vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+                    if (is_indexed) {
+                        vertex_cache[vertex_cache_pos] = vs_output;
+                        vertex_cache_valid[vertex_cache_pos] = true;
+                        vertex_cache_ids[vertex_cache_pos] = vertex;
+                        vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+                    }
                 }
-            }
 
-            // Send to geometry pipeline
-            g_state.geometry_pipeline.SubmitVertex(vs_output);
+                // Send to geometry pipeline
+                g_state.geometry_pipeline.SubmitVertex(vs_output);
+            }
         }
 
         for (auto& range : memory_accesses.ranges) {
@@ -422,7 +571,10 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                 VideoCore::g_memory->GetPhysicalPointer(range.first), range.second, range.first);
         }
 
-        VideoCore::g_renderer->Rasterizer()->DrawTriangles();
+        if (shaded_key) {
+            rasterizer->StoreShadedVertices(*shaded_key);
+        }
+        rasterizer->DrawTriangles();
         if (g_debug_context) {
             g_debug_context->OnEvent(DebugContext::Event::FinishedPrimitiveBatch, nullptr);
         }
@@ -645,12 +797,43 @@ static void WritePicaReg(u32 id, u32 value, u32 mask) {
                                  reinterpret_cast<void*>(&id));
 }
 
-void ProcessCommandList(PAddr list, u32 size) {
+bool ListTriggersInterrupt(const u32* buffer, u32 size) {
+    constexpr u32 trigger_irq_id = PICA_REG_INDEX(trigger_irq);
+    const u32* const end = buffer + size / sizeof(u32);
+    const u32* current = buffer;
+
+    while (current < end) {
+        // Align read pointer to 8 bytes
+        if ((buffer - current) % 2 != 0)
+            ++current;
+        if (current + 1 >= end)
+            break;
+
+        // Skip the value, only the header is of interest here
+        ++current;
+        const CommandHeader header = {*current++};
+        const u32 id = header.cmd_id;
+        const u32 last_id = header.group_commands ? id + header.extra_data_length : id;
+        if (id <= trigger_irq_id && trigger_irq_id <= last_id) {
+            return true;
+        }
+
+        current += header.extra_data_length;
+    }
+    return false;
+}
 
-    u32* buffer = (u32*)VideoCore::g_memory->GetPhysicalPointer(list);
+void Shutdown() {
+    vertex_batch_processor = nullptr;
+}
 
+void ProcessCommandList(PAddr list, u32 size) {
+    ProcessCommandList((u32*)VideoCore::g_memory->GetPhysicalPointer(list), list, size);
+}
+
+void ProcessCommandList(const u32* buffer, PAddr list, u32 size) {
     if (Pica::g_debug_context && Pica::g_debug_context->recorder) {
-        Pica::g_debug_context->recorder->MemoryAccessed((u8*)buffer, size, list);
+        Pica::g_debug_context->recorder->MemoryAccessed((const u8*)buffer, size, list);
     }
 
     g_state.cmd_list.addr = list;
@@ -673,6 +856,9 @@ void ProcessCommandList(PAddr list, u32 size) {
             WritePicaReg(cmd, *g_state.cmd_list.current_ptr++, header.parameter_mask);
         }
     }
+
+    // The CPU may overwrite the vertex data once the list has been processed
+    VideoCore::g_renderer->Rasterizer()->SubmitBatchedDraws();
 }
 
 } // namespace Pica::CommandProcessor
@@ -32,6 +32,15 @@ static_assert(std::is_standard_layout<CommandHeader>::value == true,
               "CommandHeader does not use standard layout");
 static_assert(sizeof(CommandHeader) == sizeof(u32), "CommandHeader has incorrect size!");
 
+/// Returns true if the command list writes to the P3D interrupt trigger register
+bool ListTriggersInterrupt(const u32* buffer, u32 size);
+
+/// Releases the resources used to process command lists, e.g. the vertex shader threads
+void Shutdown();
+
 void ProcessCommandList(PAddr list, u32 size);
 
+/// Processes a command list that has already been read out of guest memory at address list
+void ProcessCommandList(const u32* buffer, PAddr list, u32 size);
+
 } // namespace Pica::CommandProcessor
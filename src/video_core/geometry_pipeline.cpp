@@ -350,6 +350,10 @@ void GeometryPipeline::Reconfigure() {
     }
 }
 
+bool GeometryPipeline::IsEmpty() const {
+    return !backend || backend->IsEmpty();
+}
+
 bool GeometryPipeline::NeedIndexInput() const {
     if (!backend)
         return false;
@@ -35,6 +35,9 @@ public:
     /// Reconfigures the pipeline according to current register settings
     void Reconfigure();
 
+    /// Checks if the pipeline has no partially buffered geometry shader input
+    bool IsEmpty() const;
+
     /// Checks if the pipeline needs a direct input from index buffer
     bool NeedIndexInput() const;
 
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <mutex>
 #include <vector>
 #include "core/hle/service/gsp/gsp.h"
 
@@ -28,7 +29,7 @@ public:
          * @note All methods in this class are called from the GSP thread
          */
         virtual void GXCommandProcessed(int total_command_count) {
-            [[maybe_unused]] const Service::GSP::Command& cmd =
+            [[maybe_unused]] const Service::GSP::Command cmd =
                 observed->ReadGXCommandHistory(total_command_count - 1);
             LOG_TRACE(Debug_GPU, "Received command: id={:x}", (int)cmd.id.Value());
         }
@@ -48,18 +49,22 @@ public:
         if (observers.empty())
             return;
 
-        gx_command_history.emplace_back();
-        Service::GSP::Command& cmd = gx_command_history.back();
-
-        memcpy(&cmd, command_data, sizeof(Service::GSP::Command));
+        int total_command_count;
+        {
+            std::scoped_lock lock{history_mutex};
+            Service::GSP::Command& cmd = gx_command_history.emplace_back();
+            memcpy(&cmd, command_data, sizeof(Service::GSP::Command));
+            total_command_count = static_cast<int>(gx_command_history.size());
+        }
 
-        ForEachObserver([this](DebuggerObserver* observer) {
-            observer->GXCommandProcessed(static_cast<int>(this->gx_command_history.size()));
+        ForEachObserver([total_command_count](DebuggerObserver* observer) {
+            observer->GXCommandProcessed(total_command_count);
         });
     }
 
-    const Service::GSP::Command& ReadGXCommandHistory(int index) const {
-        // TODO: Is this thread-safe?
+    /// Returns a copy of the command, the history can grow from the GSP thread at any time
+    Service::GSP::Command ReadGXCommandHistory(int index) const {
+        std::scoped_lock lock{history_mutex};
         return gx_command_history[index];
     }
 
@@ -81,5 +86,6 @@ private:
 
     std::vector<DebuggerObserver*> observers;
 
+    mutable std::mutex history_mutex;
     std::vector<Service::GSP::Command> gx_command_history;
 };
@@ -0,0 +1,194 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "core/frontend/emu_window.h"
+#include "core/frontend/scope_acquire_context.h"
+#include "core/memory.h"
+#include "video_core/command_processor.h"
+#include "video_core/gpu_thread.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
+
+namespace VideoCore {
+
+MICROPROFILE_DEFINE(GPU_ThreadWait, "GPU", "Wait for GPU thread", MP_RGB(255, 120, 40));
+
+GPUThread::GPUThread(Frontend::GraphicsContext& context) : context{context} {}
+
+GPUThread::~GPUThread() {
+    if (!thread.joinable()) {
+        return;
+    }
+    WaitForFence(PushCommand(EndProcessingCommand{}));
+    thread.join();
+}
+
+void GPUThread::SubmitList(PAddr addr, u32 size) {
+    // Copy the list out of guest memory so that the application is free to reuse the buffer
+    // as soon as the submission returns, matching what it observes on hardware.
+    const u8* list = g_memory->GetPhysicalPointer(addr);
+    if (list == nullptr) {
+        LOG_ERROR(HW_GPU, "Submitted command list at invalid address {:#010X}", addr);
+        return;
+    }
+
+    std::vector<u32> buffer(size / sizeof(u32));
+    std::memcpy(buffer.data(), list, buffer.size() * sizeof(u32));
+    PushCommand(SubmitListCommand{addr, std::move(buffer)});
+}
+
+void GPUThread::PushHardwareOperation(std::function<void()> operation) {
+    PushCommand(HardwareOperationCommand{std::move(operation)});
+}
+
+void GPUThread::SwapBuffers() {
+    // Allow a single frame in flight. This keeps the CPU from running arbitrarily far ahead of the
+    // presented frame while the frame limiter runs on the GPU thread.
+    WaitForFence(last_swap_fence);
+    last_swap_fence = PushCommand(SwapBuffersCommand{});
+}
+
+void GPUThread::FlushRegion(PAddr addr, u32 size) {
+    if (IsGPUThread()) {
+        g_renderer->Rasterizer()->FlushRegion(addr, size);
+        return;
+    }
+    WaitForFence(PushCommand(FlushRegionCommand{addr, size}));
+}
+
+void GPUThread::InvalidateRegion(PAddr addr, u32 size) {
+    if (IsGPUThread()) {
+        g_renderer->Rasterizer()->InvalidateRegion(addr, size);
+        return;
+    }
+    PushCommand(InvalidateRegionCommand{addr, size});
+}
+
+void GPUThread::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    if (IsGPUThread()) {
+        g_renderer->Rasterizer()->FlushAndInvalidateRegion(addr, size);
+        return;
+    }
+    WaitForFence(PushCommand(FlushAndInvalidateRegionCommand{addr, size}));
+}
+
+void GPUThread::ClearAll(bool flush) {
+    if (IsGPUThread()) {
+        g_renderer->Rasterizer()->ClearAll(flush);
+        return;
+    }
+    WaitForFence(PushCommand(ClearAllCommand{flush}));
+}
+
+void GPUThread::SyncState() {
+    if (IsGPUThread()) {
+        g_renderer->Sync();
+        return;
+    }
+    WaitForFence(PushCommand(SyncStateCommand{}));
+}
+
+void GPUThread::WaitIdle() {
+    if (IsGPUThread()) {
+        return;
+    }
+
+    u64 fence;
+    {
+        std::scoped_lock lock{push_mutex};
+        fence = last_fence;
+    }
+    WaitForFence(fence);
+}
+
+bool GPUThread::IsGPUThread() const {
+    return std::this_thread::get_id() == thread.get_id();
+}
+
+u64 GPUThread::PushCommand(CommandData&& command_data) {
+    std::scoped_lock lock{push_mutex};
+    if (!thread.joinable()) {
+        // The thread is started lazily by the first command, which is submitted by the emulation
+        // thread once the frontend has finished using the context (e.g. to load disk resources).
+        context.DoneCurrent();
+        thread = std::thread{&GPUThread::ThreadLoop, this};
+    }
+
+    const u64 fence = ++last_fence;
+    queue.Push(CommandDataContainer{std::move(command_data), fence});
+    return fence;
+}
+
+void GPUThread::WaitForFence(u64 fence) {
+    if (signaled_fence.load(std::memory_order_acquire) >= fence) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_ThreadWait);
+    std::unique_lock lock{signal_mutex};
+    signal_cv.wait(lock, [this, fence] { return signaled_fence.load() >= fence; });
+}
+
+void GPUThread::ExecuteCommand(CommandData& command_data) {
+    if (auto* submit_list = std::get_if<SubmitListCommand>(&command_data)) {
+        Pica::CommandProcessor::ProcessCommandList(
+            submit_list->buffer.data(), submit_list->addr,
+            static_cast<u32>(submit_list->buffer.size() * sizeof(u32)));
+    } else if (auto* hw_operation = std::get_if<HardwareOperationCommand>(&command_data)) {
+        hw_operation->operation();
+    } else if (std::holds_alternative<SwapBuffersCommand>(command_data)) {
+        g_renderer->SwapBuffers();
+    } else if (const auto* flush = std::get_if<FlushRegionCommand>(&command_data)) {
+        g_renderer->Rasterizer()->FlushRegion(flush->addr, flush->size);
+    } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&command_data)) {
+        g_renderer->Rasterizer()->InvalidateRegion(invalidate->addr, invalidate->size);
+    } else if (const auto* flush_and_invalidate =
+                   std::get_if<FlushAndInvalidateRegionCommand>(&command_data)) {
+        g_renderer->Rasterizer()->FlushAndInvalidateRegion(flush_and_invalidate->addr,
+                                                           flush_and_invalidate->size);
+    } else if (const auto* clear_all = std::get_if<ClearAllCommand>(&command_data)) {
+        g_renderer->Rasterizer()->ClearAll(clear_all->flush);
+    } else if (std::holds_alternative<SyncStateCommand>(command_data)) {
+        g_renderer->Sync();
+    } else {
+        UNREACHABLE();
+    }
+}
+
+void GPUThread::ThreadLoop() {
+    Common::SetCurrentThreadName("GPU");
+    MicroProfileOnThreadCreate("GPU");
+
+    Frontend::ScopeAcquireContext scope{context};
+
+    while (true) {
+        CommandDataContainer next = queue.PopWait();
+        const bool end_processing = std::holds_alternative<EndProcessingCommand>(next.data);
+        if (!end_processing) {
+            ExecuteCommand(next.data);
+        }
+
+        {
+            std::scoped_lock lock{signal_mutex};
+            signaled_fence.store(next.fence, std::memory_order_release);
+        }
+        signal_cv.notify_all();
+
+        if (end_processing) {
+            break;
+        }
+    }
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+} // namespace VideoCore
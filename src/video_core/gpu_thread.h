@@ -0,0 +1,150 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "common/common_types.h"
+#include "common/threadsafe_queue.h"
+
+namespace Frontend {
+class GraphicsContext;
+}
+
+namespace VideoCore {
+
+/// Processes a Pica command list that was copied out of guest memory at submission time
+struct SubmitListCommand final {
+    PAddr addr;
+    std::vector<u32> buffer;
+};
+
+/// Runs a GPU hardware operation (e.g. MemoryFill or DisplayTransfer) owned by the core
+struct HardwareOperationCommand final {
+    std::function<void()> operation;
+};
+
+/// Finalizes the current guest frame and presents it
+struct SwapBuffersCommand final {};
+
+/// Flushes the given region of guest memory from the rasterizer cache
+struct FlushRegionCommand final {
+    PAddr addr;
+    u32 size;
+};
+
+/// Invalidates the given region of guest memory in the rasterizer cache
+struct InvalidateRegionCommand final {
+    PAddr addr;
+    u32 size;
+};
+
+/// Flushes and invalidates the given region of guest memory in the rasterizer cache
+struct FlushAndInvalidateRegionCommand final {
+    PAddr addr;
+    u32 size;
+};
+
+/// Removes all surfaces from the rasterizer cache, optionally flushing them first
+struct ClearAllCommand final {
+    bool flush;
+};
+
+/// Resynchronizes the rasterizer with the Pica register state (e.g. after loading a savestate)
+struct SyncStateCommand final {};
+
+/// Signals the GPU thread to stop processing commands
+struct EndProcessingCommand final {};
+
+using CommandData =
+    std::variant<EndProcessingCommand, SubmitListCommand, HardwareOperationCommand,
+                 SwapBuffersCommand, FlushRegionCommand, InvalidateRegionCommand,
+                 FlushAndInvalidateRegionCommand, ClearAllCommand, SyncStateCommand>;
+
+struct CommandDataContainer {
+    CommandDataContainer() = default;
+
+    CommandDataContainer(CommandData&& data, u64 next_fence)
+        : data{std::move(data)}, fence{next_fence} {}
+
+    CommandData data;
+    u64 fence{};
+};
+
+/**
+ * Runs Pica command processing and the renderer on a dedicated host thread, so that ARM11
+ * emulation can overlap with GPU emulation. Every operation is queued in submission order and is
+ * tagged with a monotonically increasing fence; operations whose result is observed by the CPU
+ * (e.g. FlushRegion before a guest memory read) block until their fence has been signaled.
+ * The graphics context is taken over from the submitting thread when the first command arrives.
+ */
+class GPUThread {
+public:
+    explicit GPUThread(Frontend::GraphicsContext& context);
+    ~GPUThread();
+
+    GPUThread(const GPUThread&) = delete;
+    GPUThread& operator=(const GPUThread&) = delete;
+
+    /// Queues the command list at the specified physical address for processing
+    void SubmitList(PAddr addr, u32 size);
+
+    /// Queues a hardware operation that must be ordered with respect to command lists
+    void PushHardwareOperation(std::function<void()> operation);
+
+    /// Queues a buffer swap, waiting for the previously queued one to complete
+    void SwapBuffers();
+
+    /// Flushes the region and waits for the flush to complete
+    void FlushRegion(PAddr addr, u32 size);
+
+    /// Queues an invalidation of the region
+    void InvalidateRegion(PAddr addr, u32 size);
+
+    /// Flushes and invalidates the region and waits for the flush to complete
+    void FlushAndInvalidateRegion(PAddr addr, u32 size);
+
+    /// Clears the rasterizer cache and waits for the operation to complete
+    void ClearAll(bool flush);
+
+    /// Resynchronizes the rasterizer state and waits for the operation to complete
+    void SyncState();
+
+    /// Waits until all the queued commands have been processed
+    void WaitIdle();
+
+    /// Returns true if the caller is running on the GPU thread
+    [[nodiscard]] bool IsGPUThread() const;
+
+private:
+    /// Pushes a command to be executed by the GPU thread and returns its fence
+    u64 PushCommand(CommandData&& command_data);
+
+    /// Blocks the caller until the specified fence has been signaled
+    void WaitForFence(u64 fence);
+
+    /// Executes a single command on the GPU thread
+    void ExecuteCommand(CommandData& command_data);
+
+    void ThreadLoop();
+
+private:
+    Frontend::GraphicsContext& context;
+    Common::SPSCQueue<CommandDataContainer> queue;
+    std::mutex push_mutex;
+    u64 last_fence{};
+    std::atomic<u64> signaled_fence{};
+    u64 last_swap_fence{};
+    std::mutex signal_mutex;
+    std::condition_variable signal_cv;
+    std::thread thread;
+};
+
+} // namespace VideoCore
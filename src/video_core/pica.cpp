@@ -5,6 +5,7 @@
 #include <cstring>
 #include <type_traits>
 #include "core/global.h"
+#include "video_core/command_processor.h"
 #include "video_core/geometry_pipeline.h"
 #include "video_core/pica.h"
 #include "video_core/pica_state.h"
@@ -27,6 +28,7 @@ void Init() {
 }
 
 void Shutdown() {
+    CommandProcessor::Shutdown();
     Shader::Shutdown();
 }
 
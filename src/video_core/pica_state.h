@@ -5,8 +5,11 @@
 #pragma once
 
 #include <array>
+#include <type_traits>
 #include <boost/serialization/array.hpp>
+#include <boost/serialization/binary_object.hpp>
 #include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/bit_field.h"
 #include "common/common_types.h"
 #include "common/vector_math.h"
@@ -211,16 +214,36 @@ private:
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version) {
         ar& regs.reg_array;
-        ar& vs;
-        ar& gs;
-        ar& input_default_attributes;
+        if (file_version == 0) {
+            ar& vs;
+            ar& gs;
+            ar& input_default_attributes;
+        } else {
+            SerializeShaderSetup(ar, vs);
+            SerializeShaderSetup(ar, gs);
+            ar& boost::serialization::make_binary_object(&input_default_attributes,
+                                                         sizeof(input_default_attributes));
+        }
         ar& proctex;
         ar& lighting.luts;
         ar& fog.lut;
         ar& cmd_list.addr;
         ar& cmd_list.length;
         ar& immediate;
-        ar& gs_unit;
+        if (file_version == 0) {
+            ar& gs_unit;
+        } else {
+            ar& boost::serialization::make_binary_object(&gs_unit.registers,
+                                                         sizeof(gs_unit.registers));
+            ar& gs_unit.conditional_code;
+            ar& gs_unit.address_registers;
+            ar& boost::serialization::make_binary_object(&gs_unit.emitter.buffer,
+                                                         sizeof(gs_unit.emitter.buffer));
+            ar& gs_unit.emitter.vertex_id;
+            ar& gs_unit.emitter.prim_emit;
+            ar& gs_unit.emitter.winding;
+            ar& gs_unit.emitter.output_mask;
+        }
         ar& geometry_pipeline;
         ar& primitive_assembler;
         ar& vs_float_regs_counter;
@@ -235,6 +258,19 @@ private:
         boost::serialization::split_member(ar, *this, file_version);
     }
 
+    /// The float vectors are written as raw bytes, which saves the per-element overhead of boost
+    template <class Archive>
+    static void SerializeShaderSetup(Archive& ar, Shader::ShaderSetup& setup) {
+        static_assert(std::is_trivially_copyable_v<Shader::Uniforms>);
+        ar& boost::serialization::make_binary_object(&setup.uniforms, sizeof(setup.uniforms));
+        ar& setup.program_code;
+        ar& setup.swizzle_data;
+        if (Archive::is_loading::value) {
+            setup.MarkProgramCodeDirty();
+            setup.MarkSwizzleDataDirty();
+        }
+    }
+
     template <class Archive>
     void save(Archive& ar, const unsigned int file_version) const {
         ar << static_cast<u32>(cmd_list.current_ptr - cmd_list.head_ptr);
@@ -253,3 +289,5 @@ private:
 extern State g_state; ///< Current Pica state
 
 } // namespace Pica
+
+BOOST_CLASS_VERSION(Pica::State, 1)
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/memory_usage.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/texture.h"
@@ -10,6 +11,7 @@
 #include "video_core/rasterizer_cache/morton_swizzle.h"
 #include "video_core/rasterizer_cache/rasterizer_cache.h"
 #include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_texture_decoder.h"
 #include "video_core/renderer_opengl/texture_downloader_es.h"
 #include "video_core/renderer_opengl/texture_filters/texture_filterer.h"
 
@@ -33,15 +35,36 @@ static Aspect ToAspect(SurfaceType type) {
     return Aspect::Color;
 }
 
+/// The guest memory covered by the surfaces, their textures count as OpenGL textures
+static Common::MemoryUsage::Counter SurfaceUsage{"Rasterizer cache", "Surfaces"};
+
+CachedSurface::CachedSurface(SurfaceParams params, RasterizerCacheOpenGL& owner,
+                             TextureRuntime& runtime)
+    : SurfaceParams(params), owner(owner), runtime(runtime) {
+    SurfaceUsage.Add(size);
+}
+
 CachedSurface::~CachedSurface() {
+    SurfaceUsage.Remove(size);
     if (texture.handle) {
-        auto tag = is_custom ? HostTextureTag{GetFormatTuple(PixelFormat::RGBA8),
-                                              custom_tex_info.width, custom_tex_info.height}
-                             : HostTextureTag{GetFormatTuple(pixel_format), GetScaledWidth(),
-                                              GetScaledHeight()};
+        if (is_custom) {
+            owner.RecycleSurfaceTexture(GetFormatTuple(PixelFormat::RGBA8), custom_tex_info.width,
+                                        custom_tex_info.height, 4, std::move(texture));
+        } else {
+            owner.RecycleSurfaceTexture(GetFormatTuple(pixel_format), GetScaledWidth(),
+                                        GetScaledHeight(), GetBytesPerPixel(pixel_format),
+                                        std::move(texture));
+        }
+    }
+}
 
-        owner.host_texture_recycler.emplace(tag, std::move(texture));
+void CachedSurface::MapGLBuffer() {
+    auto& arena = owner.frame_arena;
+    if (!gl_buffer.empty() && gl_buffer_generation == arena.GetGeneration()) {
+        return;
     }
+    gl_buffer = arena.AllocateArray<u8>(width * height * GetBytesPerPixel(pixel_format));
+    gl_buffer_generation = arena.GetGeneration();
 }
 
 MICROPROFILE_DEFINE(RasterizerCache_SurfaceLoad, "RasterizerCache", "Surface Load",
@@ -51,12 +74,11 @@ void CachedSurface::LoadGLBuffer(PAddr load_start, PAddr load_end) {
     const bool need_swap =
         GLES && (pixel_format == PixelFormat::RGBA8 || pixel_format == PixelFormat::RGB8);
 
+    MapGLBuffer();
     const u8* const texture_src_data = VideoCore::g_memory->GetPhysicalPointer(addr);
-    if (texture_src_data == nullptr)
+    if (texture_src_data == nullptr) {
+        std::memset(gl_buffer.data(), 0, gl_buffer.size());
         return;
-
-    if (gl_buffer.empty()) {
-        gl_buffer.resize(width * height * GetBytesPerPixel(pixel_format));
     }
 
     // TODO: Should probably be done in ::Memory:: and check for other regions too
@@ -95,7 +117,16 @@ void CachedSurface::LoadGLBuffer(PAddr load_start, PAddr load_end) {
                         load_end - load_start);
         }
     } else {
-        if (type == SurfaceType::Texture) {
+        // Texture dumping and replacement identify textures by their decoded contents
+        const Settings::Snapshot settings = Settings::GetSnapshot();
+        gpu_decode = type == SurfaceType::Texture && settings.use_gpu_texture_decode &&
+                     TextureDecoderOpenGL::CanDecode(pixel_format) && !settings.dump_textures &&
+                     !settings.custom_textures;
+        if (gpu_decode) {
+            // The raw data is smaller than the decoded texels, keep it at the same offsets
+            std::memcpy(&gl_buffer[start_offset], texture_src_data + start_offset,
+                        load_end - load_start);
+        } else if (type == SurfaceType::Texture) {
             Pica::Texture::TextureInfo tex_info{};
             tex_info.width = width;
             tex_info.height = height;
@@ -107,12 +138,28 @@ void CachedSurface::LoadGLBuffer(PAddr load_start, PAddr load_end) {
             const auto rect = GetSubRect(FromInterval(load_interval));
             ASSERT(FromInterval(load_interval).GetInterval() == load_interval);
 
-            for (unsigned y = rect.bottom; y < rect.top; ++y) {
-                for (unsigned x = rect.left; x < rect.right; ++x) {
-                    auto vec4 =
-                        Pica::Texture::LookupTexture(texture_src_data, x, height - 1 - y, tex_info);
-                    const std::size_t offset = (x + (width * y)) * 4;
-                    std::memcpy(&gl_buffer[offset], vec4.AsArray(), 4);
+            // Decode whole tiles at once, the texture is stored upside down with respect to GL
+            const std::size_t tile_size = Pica::Texture::CalculateTileSize(tex_info.format);
+            const unsigned first_row = height - rect.top;
+            const unsigned last_row = height - rect.bottom;
+            std::array<Common::Vec4<u8>, 8 * 8> texels;
+            for (unsigned tile_y = first_row / 8 * 8; tile_y < last_row; tile_y += 8) {
+                for (unsigned tile_x = rect.left / 8 * 8; tile_x < rect.right; tile_x += 8) {
+                    const u8* tile_ptr = texture_src_data + (tile_y / 8) * tex_info.stride +
+                                         (tile_x / 8) * tile_size;
+                    Pica::Texture::DecodeTile(tile_ptr, tex_info, texels.data());
+
+                    const unsigned row_begin = std::max(tile_y, first_row);
+                    const unsigned row_end = std::min(tile_y + 8, last_row);
+                    const unsigned x_begin = std::max(tile_x, rect.left);
+                    const unsigned x_end = std::min(tile_x + 8, rect.right);
+                    for (unsigned row = row_begin; row < row_end; ++row) {
+                        const unsigned y = height - 1 - row;
+                        const std::size_t offset = (x_begin + (width * y)) * 4;
+                        std::memcpy(&gl_buffer[offset],
+                                    texels[(row - tile_y) * 8 + (x_begin - tile_x)].AsArray(),
+                                    (x_end - x_begin) * 4);
+                    }
                 }
             }
         } else {
@@ -129,7 +176,10 @@ void CachedSurface::FlushGLBuffer(PAddr flush_start, PAddr flush_end) {
     if (dst_buffer == nullptr)
         return;
 
-    ASSERT(gl_buffer.size() == width * height * GetBytesPerPixel(pixel_format));
+    // Fill surfaces are written from fill_data, the others from the buffer of their download
+    ASSERT(type == SurfaceType::Fill ||
+           (gl_buffer.size() == width * height * GetBytesPerPixel(pixel_format) &&
+            gl_buffer_generation == owner.frame_arena.GetGeneration()));
 
     // TODO: Should probably be done in ::Memory:: and check for other regions too
     // same as loadglbuffer()
@@ -188,6 +238,7 @@ bool CachedSurface::LoadCustomTexture(u64 tex_hash) {
     auto& custom_tex_cache = Core::System::GetInstance().CustomTexCache();
     const auto& image_interface = Core::System::GetInstance().GetImageInterface();
 
+    custom_tex_pending = false;
     if (custom_tex_cache.IsTextureCached(tex_hash)) {
         custom_tex_info = custom_tex_cache.LookupTexture(tex_hash);
         return true;
@@ -197,24 +248,17 @@ bool CachedSurface::LoadCustomTexture(u64 tex_hash) {
         return false;
     }
 
-    const auto& path_info = custom_tex_cache.LookupTexturePathInfo(tex_hash);
-    if (!image_interface->DecodePNG(custom_tex_info.tex, custom_tex_info.width,
-                                    custom_tex_info.height, path_info.path)) {
-        LOG_ERROR(Render_OpenGL, "Failed to load custom texture {}", path_info.path);
+    if (Settings::GetSnapshot().async_custom_loading) {
+        // Keep the original texture until the replacement has been decoded in the background
+        custom_tex_pending = custom_tex_cache.RequestTexture(tex_hash, image_interface);
         return false;
     }
 
-    const std::bitset<32> width_bits(custom_tex_info.width);
-    const std::bitset<32> height_bits(custom_tex_info.height);
-    if (width_bits.count() != 1 || height_bits.count() != 1) {
-        LOG_ERROR(Render_OpenGL, "Texture {} size is not a power of 2", path_info.path);
+    if (!custom_tex_cache.LoadTexture(tex_hash, *image_interface)) {
         return false;
     }
 
-    LOG_DEBUG(Render_OpenGL, "Loaded custom texture from {}", path_info.path);
-    Common::FlipRGBA8Texture(custom_tex_info.tex, custom_tex_info.width, custom_tex_info.height);
-    custom_tex_cache.CacheTexture(tex_hash, custom_tex_info.tex, custom_tex_info.width,
-                                  custom_tex_info.height);
+    custom_tex_info = custom_tex_cache.LookupTexture(tex_hash);
     return true;
 }
 
@@ -280,16 +324,27 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect) {
     }
 
     MICROPROFILE_SCOPE(RasterizerCache_TextureUL);
-    ASSERT(gl_buffer.size() == width * height * GetBytesPerPixel(pixel_format));
+    ASSERT(gl_buffer.size() == width * height * GetBytesPerPixel(pixel_format) &&
+           gl_buffer_generation == owner.frame_arena.GetGeneration());
+
+    DiscardQueuedDownload();
 
     u64 tex_hash = 0;
 
-    if (Settings::values.dump_textures || Settings::values.custom_textures) {
+    const Settings::Snapshot settings = Settings::GetSnapshot();
+    if (settings.dump_textures || settings.custom_textures) {
+        // Texture packs are named after this hash, so it has to stay the same between versions
         tex_hash = Common::ComputeHash64(gl_buffer.data(), gl_buffer.size());
     }
 
-    if (Settings::values.custom_textures) {
+    if (settings.custom_textures) {
+        // The guest frequently rewrites textures with identical data. When the replacement for
+        // the data is already in the texture there is nothing to decode or upload.
+        if (is_custom && custom_tex_hash != 0 && custom_tex_hash == tex_hash) {
+            return;
+        }
         is_custom = LoadCustomTexture(tex_hash);
+        custom_tex_hash = is_custom || custom_tex_pending ? tex_hash : 0;
     }
 
     // Load data from memory to the surface
@@ -339,7 +394,14 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect) {
 
         glActiveTexture(GL_TEXTURE0);
         glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, custom_tex_info.width, custom_tex_info.height,
-                        GL_RGBA, GL_UNSIGNED_BYTE, custom_tex_info.tex.data());
+                        GL_RGBA, GL_UNSIGNED_BYTE, custom_tex_info.tex.get());
+    } else if (gpu_decode) {
+        const Common::Rectangle<u32> dst_rect{static_cast<u32>(x0),
+                                              static_cast<u32>(y0) + rect.GetHeight(),
+                                              static_cast<u32>(x0) + rect.GetWidth(),
+                                              static_cast<u32>(y0)};
+        owner.texture_decoder->Decode({gl_buffer.data(), end - addr}, pixel_format, width,
+                                      height, rect, target_tex, dst_rect);
     } else {
         glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(stride));
 
@@ -350,7 +412,7 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect) {
     }
 
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    if (Settings::values.dump_textures && !is_custom) {
+    if (settings.dump_textures && !is_custom) {
         DumpTexture(target_tex, tex_hash);
     }
 
@@ -368,8 +430,27 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect) {
         const u32 height = is_custom ? custom_tex_info.height : rect.GetHeight();
         const Common::Rectangle<u32> from_rect{0, height, width, 0};
 
-        if (is_custom ||
-            !owner.texture_filterer->Filter(unscaled_tex, from_rect, texture, scaled_rect, type)) {
+        // Identify the uploaded pixels, so that the filter can reuse its result when the guest
+        // uploads the same data again (e.g. glyph atlases which are rewritten every frame)
+        u64 content_hash = 0;
+        if (!is_custom && !owner.texture_filterer->IsNull()) {
+            std::size_t hash;
+            if (gpu_decode) {
+                // The buffer holds the encoded surface, which the rectangle is decoded from
+                hash = Common::ComputeBulkHash64(gl_buffer.data(), end - addr);
+                Common::HashCombine(hash, (u64{rect.left} << 32) | rect.bottom);
+            } else {
+                const u32 bytes_per_pixel = GetBytesPerPixel(pixel_format);
+                const std::size_t size =
+                    ((rect.GetHeight() - 1) * stride + rect.GetWidth()) * bytes_per_pixel;
+                hash = Common::ComputeBulkHash64(&gl_buffer[buffer_offset], size);
+            }
+            Common::HashCombine(hash, (u64{stride} << 32) | static_cast<u32>(pixel_format));
+            content_hash = hash;
+        }
+
+        if (is_custom || !owner.texture_filterer->Filter(unscaled_tex, from_rect, texture,
+                                                         scaled_rect, type, content_hash)) {
             const Aspect aspect = ToAspect(type);
             runtime.BlitTextures(unscaled_tex, {aspect, from_rect}, texture, {aspect, scaled_rect});
         }
@@ -378,6 +459,19 @@ void CachedSurface::UploadGLTexture(Common::Rectangle<u32> rect) {
     InvalidateAllWatcher();
 }
 
+void SurfaceWatcher::Validate() {
+    const Surface locked = surface.lock();
+    ASSERT(locked);
+    valid = true;
+    validated_tick = locked->modification_tick;
+}
+
+bool SurfaceWatcher::IsModified() const {
+    const Surface locked = surface.lock();
+    return !locked || locked->modification_tick == 0 ||
+           locked->modification_tick != validated_tick;
+}
+
 MICROPROFILE_DEFINE(RasterizerCache_TextureDL, "RasterizerCache", "Texture Download",
                     MP_RGB(128, 192, 64));
 void CachedSurface::DownloadGLTexture(const Common::Rectangle<u32>& rect) {
@@ -387,10 +481,26 @@ void CachedSurface::DownloadGLTexture(const Common::Rectangle<u32>& rect) {
 
     MICROPROFILE_SCOPE(RasterizerCache_TextureDL);
 
-    if (gl_buffer.empty()) {
-        gl_buffer.resize(width * height * GetBytesPerPixel(pixel_format));
+    MapGLBuffer();
+
+    const u32 bytes_per_pixel = GetBytesPerPixel(pixel_format);
+    if (pending_download && rect.left >= pending_download_rect.left &&
+        rect.right <= pending_download_rect.right && rect.bottom >= pending_download_rect.bottom &&
+        rect.top <= pending_download_rect.top) {
+        const auto& queued_rect = pending_download_rect;
+        const std::size_t queued_offset =
+            (queued_rect.bottom * stride + queued_rect.left) * bytes_per_pixel;
+        if (runtime.FinishReadTexture(std::exchange(pending_download, {}),
+                                      &gl_buffer[queued_offset],
+                                      queued_rect.GetWidth() * bytes_per_pixel,
+                                      stride * bytes_per_pixel, queued_rect.GetHeight())) {
+            return;
+        }
     }
 
+    // Download the surface ahead of time the next time it is rendered to
+    read_back = true;
+
     OpenGLState state = OpenGLState::GetCurState();
     OpenGLState prev_state = state;
     SCOPE_EXIT({ prev_state.Apply(); });
@@ -436,6 +546,63 @@ void CachedSurface::DownloadGLTexture(const Common::Rectangle<u32>& rect) {
     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 }
 
+MICROPROFILE_DEFINE(RasterizerCache_TextureDLQueue, "RasterizerCache", "Texture Download Queue",
+                    MP_RGB(128, 192, 64));
+void CachedSurface::QueueDownload(const Common::Rectangle<u32>& rect) {
+    if (type == SurfaceType::Fill) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(RasterizerCache_TextureDLQueue);
+
+    const Aspect aspect = ToAspect(type);
+    const FormatTuple& tuple = GetFormatTuple(pixel_format);
+    const u32 bytes_per_pixel = GetBytesPerPixel(pixel_format);
+    if (GLES && aspect != Aspect::Color) {
+        // GLES can't read depth, so TextureDownloaderES converts it to color first. Its
+        // conversion starts at the origin of the texture, so the rect is copied to one.
+        const Common::Rectangle<u32> scaled_rect{rect.left * res_scale, rect.top * res_scale,
+                                                 rect.right * res_scale, rect.bottom * res_scale};
+        const Common::Rectangle<u32> unscaled_tex_rect{0, rect.GetHeight(), rect.GetWidth(), 0};
+        auto unscaled_tex = owner.AllocateSurfaceTexture(tuple, rect.GetWidth(), rect.GetHeight());
+        runtime.BlitTextures(texture, {aspect, scaled_rect}, unscaled_tex,
+                             {aspect, unscaled_tex_rect});
+
+        OpenGLState prev_state = OpenGLState::GetCurState();
+        SCOPE_EXIT({ prev_state.Apply(); });
+        GLenum format = tuple.format;
+        GLenum pixel_type = tuple.type;
+        const GLuint framebuffer = owner.texture_downloader_es->ConvertDepth(
+            unscaled_tex.handle, 0, format, pixel_type, rect.GetHeight(), rect.GetWidth());
+        if (framebuffer != 0) {
+            pending_download = runtime.QueueReadFramebuffer(framebuffer, unscaled_tex_rect, format,
+                                                            pixel_type, bytes_per_pixel);
+            pending_download_rect = rect;
+        }
+        return;
+    }
+
+    if (res_scale != 1) {
+        auto scaled_rect = rect;
+        scaled_rect.left *= res_scale;
+        scaled_rect.top *= res_scale;
+        scaled_rect.right *= res_scale;
+        scaled_rect.bottom *= res_scale;
+
+        // The temporary texture may be released as soon as the read has been queued
+        const Common::Rectangle<u32> unscaled_tex_rect{0, rect.GetHeight(), rect.GetWidth(), 0};
+        auto unscaled_tex = owner.AllocateSurfaceTexture(tuple, rect.GetWidth(), rect.GetHeight());
+        runtime.BlitTextures(texture, {aspect, scaled_rect}, unscaled_tex,
+                             {aspect, unscaled_tex_rect});
+        pending_download = runtime.QueueReadTexture(unscaled_tex, {aspect, unscaled_tex_rect},
+                                                    tuple, bytes_per_pixel);
+    } else {
+        pending_download =
+            runtime.QueueReadTexture(texture, {aspect, rect}, tuple, bytes_per_pixel);
+    }
+    pending_download_rect = rect;
+}
+
 bool CachedSurface::CanFill(const SurfaceParams& dest_surface,
                             SurfaceInterval fill_interval) const {
     if (type == SurfaceType::Fill && IsRegionValid(fill_interval) &&
@@ -446,7 +613,7 @@ bool CachedSurface::CanFill(const SurfaceParams& dest_surface,
         if (fill_size * 8 != dest_surface.GetFormatBpp()) {
             // Check if bits repeat for our fill_size
             const u32 dest_bytes_per_pixel = std::max(dest_surface.GetFormatBpp() / 8, 1u);
-            std::vector<u8> fill_test(fill_size * dest_bytes_per_pixel);
+            std::array<u8, 4 * 4> fill_test;
 
             for (u32 i = 0; i < dest_bytes_per_pixel; ++i)
                 std::memcpy(&fill_test[i * fill_size], &fill_data[0], fill_size);
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <list>
+#include <span>
 #include "common/assert.h"
 #include "core/custom_tex_cache.h"
 #include "video_core/rasterizer_cache/surface_params.h"
@@ -27,10 +28,14 @@ public:
     }
 
     /// Marks that the content of the referencing surface has been updated to the watcher user.
-    void Validate() {
-        ASSERT(!surface.expired());
-        valid = true;
-    }
+    void Validate();
+
+    /**
+     * Checks whether the texture of the surface has been written since the last Validate. The
+     * watcher is also invalidated when nothing was written, e.g. when the surface is bound as a
+     * framebuffer, so a copy of the texture only needs to be updated when this is true.
+     */
+    bool IsModified() const;
 
     /// Gets the referencing surface. Returns null if the surface has been destroyed
     Surface Get() const {
@@ -40,14 +45,15 @@ public:
 private:
     std::weak_ptr<CachedSurface> surface;
     bool valid = false;
+    /// The modification tick of the surface as of the last Validate
+    u64 validated_tick = 0;
 };
 
 class RasterizerCacheOpenGL;
 
 class CachedSurface : public SurfaceParams, public std::enable_shared_from_this<CachedSurface> {
 public:
-    CachedSurface(SurfaceParams params, RasterizerCacheOpenGL& owner, TextureRuntime& runtime)
-        : SurfaceParams(params), owner(owner), runtime(runtime) {}
+    CachedSurface(SurfaceParams params, RasterizerCacheOpenGL& owner, TextureRuntime& runtime);
     ~CachedSurface();
 
     /// Read/Write data in 3DS memory to/from gl_buffer
@@ -62,6 +68,15 @@ public:
     void UploadGLTexture(Common::Rectangle<u32> rect);
     void DownloadGLTexture(const Common::Rectangle<u32>& rect);
 
+    /// Starts copying the rect of this surface's texture to the host, a later DownloadGLTexture
+    /// of a region inside the rect completes without stalling on the GPU
+    void QueueDownload(const Common::Rectangle<u32>& rect);
+
+    /// Drops the queued download because the surface contents are about to change
+    void DiscardQueuedDownload() {
+        pending_download = {};
+    }
+
     bool CanFill(const SurfaceParams& dest_surface, SurfaceInterval fill_interval) const;
     bool CanCopy(const SurfaceParams& dest_surface, SurfaceInterval copy_interval) const;
 
@@ -102,7 +117,13 @@ public:
 public:
     bool registered = false;
     SurfaceRegions invalid_regions;
-    std::vector<u8> gl_buffer;
+    /// Staging buffer of a load or flush in the frame arena, only valid during the frame of
+    /// gl_buffer_generation
+    std::span<u8> gl_buffer;
+    u64 gl_buffer_generation = 0;
+    /// The modification counter of the cache as of the last write to the texture, so that the
+    /// renderer can tell whether a displayed framebuffer changed
+    u64 modification_tick = 0;
 
     // Number of bytes to read from fill_data
     u32 fill_size = 0;
@@ -113,11 +134,28 @@ public:
     std::array<std::shared_ptr<SurfaceWatcher>, 7> level_watchers;
     u32 max_level = 0;
 
+    // Download that was queued ahead of a flush and the region it covers
+    StagingTicket pending_download;
+    Common::Rectangle<u32> pending_download_rect;
+    // Whether the guest has read back this surface since its last queued download went unused
+    bool read_back = false;
+
     // Information about custom textures
     bool is_custom = false;
     Core::CustomTexInfo custom_tex_info;
+    // Hash of the guest data whose replacement is currently held by the texture. It is reset
+    // when the texture is written on the GPU, so an unchanged replacement is not uploaded again.
+    u64 custom_tex_hash = 0;
+    // Whether the replacement for custom_tex_hash is still being decoded
+    bool custom_tex_pending = false;
+
+    // Whether gl_buffer holds the raw tiled guest data of the last load, to be decoded on the GPU
+    bool gpu_decode = false;
 
 private:
+    /// Takes a staging buffer for the whole surface from the frame arena, unless gl_buffer is one
+    void MapGLBuffer();
+
     RasterizerCacheOpenGL& owner;
     TextureRuntime& runtime;
     std::list<std::weak_ptr<SurfaceWatcher>> watchers;
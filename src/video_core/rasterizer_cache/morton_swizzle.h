@@ -4,18 +4,195 @@
 
 #pragma once
 #include "common/alignment.h"
+#include "common/arch.h"
 #include "core/memory.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_opengl/gl_vars.h"
 #include "video_core/utils.h"
 #include "video_core/video_core.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace OpenGL {
 
+#if CITRA_ARCH(x86_64)
+/// Converts four packed 32-bit pixels between their tiled and OpenGL representations
+template <bool morton_to_gl, PixelFormat format>
+static inline __m128i ConvertPixels(__m128i pixels, bool byteswap) {
+    if constexpr (format == PixelFormat::D24S8) {
+        // Move the stencil byte from the top of the pixel to the bottom or vice versa
+        return morton_to_gl ? _mm_or_si128(_mm_slli_epi32(pixels, 8), _mm_srli_epi32(pixels, 24))
+                            : _mm_or_si128(_mm_srli_epi32(pixels, 8), _mm_slli_epi32(pixels, 24));
+    } else if constexpr (format == PixelFormat::RGBA8) {
+        if (!byteswap) {
+            return pixels;
+        }
+        pixels = _mm_or_si128(_mm_slli_epi16(pixels, 8), _mm_srli_epi16(pixels, 8));
+        pixels = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_shufflehi_epi16(pixels, _MM_SHUFFLE(2, 3, 0, 1));
+    } else {
+        return pixels;
+    }
+}
+#elif CITRA_ARCH(arm64)
+/// Converts four packed 32-bit pixels between their tiled and OpenGL representations
+template <bool morton_to_gl, PixelFormat format>
+static inline uint32x4_t ConvertPixels(uint32x4_t pixels, bool byteswap) {
+    if constexpr (format == PixelFormat::D24S8) {
+        // Move the stencil byte from the top of the pixel to the bottom or vice versa
+        return morton_to_gl ? vorrq_u32(vshlq_n_u32(pixels, 8), vshrq_n_u32(pixels, 24))
+                            : vorrq_u32(vshrq_n_u32(pixels, 8), vshlq_n_u32(pixels, 24));
+    } else if constexpr (format == PixelFormat::RGBA8) {
+        return byteswap ? vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(pixels))) : pixels;
+    } else {
+        return pixels;
+    }
+}
+#endif
+
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+/**
+ * Vectorized 8x8 tile copy for formats with 2 or 4 bytes per pixel. Two consecutive rows of a
+ * tile are interleaved in Morton order: for 32-bit formats every 16 byte block holds a 2x2 pixel
+ * quad, for 16-bit formats it holds two horizontally adjacent quads. Each pair of rows is thus
+ * rebuilt with a few 64-bit (and for 16-bit formats 32-bit) lane shuffles.
+ */
+template <bool morton_to_gl, PixelFormat format>
+static void MortonCopyTileSIMD(u32 stride, u8* tile_buffer, u8* gl_buffer) {
+    constexpr u32 bytes_per_pixel = GetFormatBpp(format) / 8;
+    static_assert(bytes_per_pixel == 2 || bytes_per_pixel == 4);
+    const u32 row_stride = stride * bytes_per_pixel;
+    const bool byteswap = format == PixelFormat::RGBA8 && GLES;
+
+    for (u32 y = 0; y < 8; y += 2) {
+        u8* tile_ptr = tile_buffer + VideoCore::MortonInterleave(0, y) * bytes_per_pixel;
+        u8* gl_row0 = gl_buffer + (7 - y) * row_stride;
+        u8* gl_row1 = gl_row0 - row_stride;
+
+#if CITRA_ARCH(x86_64)
+        const auto load = [](const u8* ptr) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        };
+        const auto store = [](u8* ptr, __m128i value) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), value);
+        };
+        const auto convert = [byteswap](__m128i pixels) {
+            return ConvertPixels<morton_to_gl, format>(pixels, byteswap);
+        };
+
+        if constexpr (bytes_per_pixel == 4) {
+            // Quads of x = 0-1, 2-3, 4-5 and 6-7 are 0, 4, 16 and 20 pixels apart
+            if constexpr (morton_to_gl) {
+                const __m128i quad0 = load(tile_ptr);
+                const __m128i quad1 = load(tile_ptr + 16);
+                const __m128i quad2 = load(tile_ptr + 64);
+                const __m128i quad3 = load(tile_ptr + 80);
+                store(gl_row0, convert(_mm_unpacklo_epi64(quad0, quad1)));
+                store(gl_row0 + 16, convert(_mm_unpacklo_epi64(quad2, quad3)));
+                store(gl_row1, convert(_mm_unpackhi_epi64(quad0, quad1)));
+                store(gl_row1 + 16, convert(_mm_unpackhi_epi64(quad2, quad3)));
+            } else {
+                const __m128i row0_lo = convert(load(gl_row0));
+                const __m128i row0_hi = convert(load(gl_row0 + 16));
+                const __m128i row1_lo = convert(load(gl_row1));
+                const __m128i row1_hi = convert(load(gl_row1 + 16));
+                store(tile_ptr, _mm_unpacklo_epi64(row0_lo, row1_lo));
+                store(tile_ptr + 16, _mm_unpackhi_epi64(row0_lo, row1_lo));
+                store(tile_ptr + 64, _mm_unpacklo_epi64(row0_hi, row1_hi));
+                store(tile_ptr + 80, _mm_unpackhi_epi64(row0_hi, row1_hi));
+            }
+        } else {
+            // Pixels x = 0-3 and 4-7 are 16 pixels apart, pairs of both rows alternate
+            constexpr int deinterleave = _MM_SHUFFLE(3, 1, 2, 0);
+            if constexpr (morton_to_gl) {
+                const __m128i left = _mm_shuffle_epi32(load(tile_ptr), deinterleave);
+                const __m128i right = _mm_shuffle_epi32(load(tile_ptr + 32), deinterleave);
+                store(gl_row0, _mm_unpacklo_epi64(left, right));
+                store(gl_row1, _mm_unpackhi_epi64(left, right));
+            } else {
+                const __m128i row0 = load(gl_row0);
+                const __m128i row1 = load(gl_row1);
+                store(tile_ptr, _mm_shuffle_epi32(_mm_unpacklo_epi64(row0, row1), deinterleave));
+                store(tile_ptr + 32,
+                      _mm_shuffle_epi32(_mm_unpackhi_epi64(row0, row1), deinterleave));
+            }
+        }
+#elif CITRA_ARCH(arm64)
+        const auto load = [](const u8* ptr) { return vreinterpretq_u64_u8(vld1q_u8(ptr)); };
+        const auto store = [](u8* ptr, uint64x2_t value) {
+            vst1q_u8(ptr, vreinterpretq_u8_u64(value));
+        };
+        const auto convert = [byteswap](uint64x2_t pixels) {
+            return vreinterpretq_u64_u32(
+                ConvertPixels<morton_to_gl, format>(vreinterpretq_u32_u64(pixels), byteswap));
+        };
+        const auto unpack_lo = [](uint64x2_t a, uint64x2_t b) {
+            return vcombine_u64(vget_low_u64(a), vget_low_u64(b));
+        };
+        const auto unpack_hi = [](uint64x2_t a, uint64x2_t b) {
+            return vcombine_u64(vget_high_u64(a), vget_high_u64(b));
+        };
+
+        if constexpr (bytes_per_pixel == 4) {
+            // Quads of x = 0-1, 2-3, 4-5 and 6-7 are 0, 4, 16 and 20 pixels apart
+            if constexpr (morton_to_gl) {
+                const uint64x2_t quad0 = load(tile_ptr);
+                const uint64x2_t quad1 = load(tile_ptr + 16);
+                const uint64x2_t quad2 = load(tile_ptr + 64);
+                const uint64x2_t quad3 = load(tile_ptr + 80);
+                store(gl_row0, convert(unpack_lo(quad0, quad1)));
+                store(gl_row0 + 16, convert(unpack_lo(quad2, quad3)));
+                store(gl_row1, convert(unpack_hi(quad0, quad1)));
+                store(gl_row1 + 16, convert(unpack_hi(quad2, quad3)));
+            } else {
+                const uint64x2_t row0_lo = convert(load(gl_row0));
+                const uint64x2_t row0_hi = convert(load(gl_row0 + 16));
+                const uint64x2_t row1_lo = convert(load(gl_row1));
+                const uint64x2_t row1_hi = convert(load(gl_row1 + 16));
+                store(tile_ptr, unpack_lo(row0_lo, row1_lo));
+                store(tile_ptr + 16, unpack_hi(row0_lo, row1_lo));
+                store(tile_ptr + 64, unpack_lo(row0_hi, row1_hi));
+                store(tile_ptr + 80, unpack_hi(row0_hi, row1_hi));
+            }
+        } else {
+            // Pixels x = 0-3 and 4-7 are 16 pixels apart, pairs of both rows alternate
+            const auto deinterleave = [](uint64x2_t value) {
+                const uint32x4_t pairs = vreinterpretq_u32_u64(value);
+                const uint32x2x2_t split = vtrn_u32(vget_low_u32(pairs), vget_high_u32(pairs));
+                return vreinterpretq_u64_u32(vcombine_u32(split.val[0], split.val[1]));
+            };
+            if constexpr (morton_to_gl) {
+                const uint64x2_t left = deinterleave(load(tile_ptr));
+                const uint64x2_t right = deinterleave(load(tile_ptr + 32));
+                store(gl_row0, unpack_lo(left, right));
+                store(gl_row1, unpack_hi(left, right));
+            } else {
+                const uint64x2_t row0 = load(gl_row0);
+                const uint64x2_t row1 = load(gl_row1);
+                store(tile_ptr, deinterleave(unpack_lo(row0, row1)));
+                store(tile_ptr + 32, deinterleave(unpack_hi(row0, row1)));
+            }
+        }
+#endif
+    }
+}
+#endif
+
 template <bool morton_to_gl, PixelFormat format>
 static void MortonCopyTile(u32 stride, u8* tile_buffer, u8* gl_buffer) {
     constexpr u32 bytes_per_pixel = GetFormatBpp(format) / 8;
     constexpr u32 aligned_bytes_per_pixel = GetBytesPerPixel(format);
+#if CITRA_ARCH(x86_64) || CITRA_ARCH(arm64)
+    if constexpr (bytes_per_pixel == aligned_bytes_per_pixel &&
+                  (bytes_per_pixel == 2 || bytes_per_pixel == 4)) {
+        MortonCopyTileSIMD<morton_to_gl, format>(stride, tile_buffer, gl_buffer);
+        return;
+    }
+#endif
     for (u32 y = 0; y < 8; ++y) {
         for (u32 x = 0; x < 8; ++x) {
             u8* tile_ptr = tile_buffer + VideoCore::MortonInterleave(x, y) * bytes_per_pixel;
@@ -2,14 +2,18 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <optional>
+#include <utility>
 #include <boost/range/iterator_range.hpp>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "core/core.h"
 #include "video_core/pica_state.h"
 #include "video_core/rasterizer_cache/rasterizer_cache.h"
 #include "video_core/renderer_opengl/gl_format_reinterpreter.h"
+#include "video_core/renderer_opengl/gl_texture_decoder.h"
 #include "video_core/renderer_opengl/texture_downloader_es.h"
 #include "video_core/renderer_opengl/texture_filters/texture_filterer.h"
 
@@ -74,25 +78,34 @@ static constexpr auto RangeFromInterval(Map& map, const Interval& interval) {
     return boost::make_iterator_range(map.equal_range(interval));
 }
 
+static u32 GetSurfaceTextureLevels(u32 width, u32 height) {
+    return static_cast<u32>(std::log2(std::max(width, height))) + 1;
+}
+
 // Allocate an uninitialized texture of appropriate size and format for the surface
 OGLTexture RasterizerCacheOpenGL::AllocateSurfaceTexture(const FormatTuple& tuple, u32 width,
                                                          u32 height) {
-    auto recycled_tex = host_texture_recycler.find({tuple, width, height});
-    if (recycled_tex != host_texture_recycler.end()) {
-        OGLTexture texture = std::move(recycled_tex->second);
-        host_texture_recycler.erase(recycled_tex);
+    const u32 levels = GetSurfaceTextureLevels(width, height);
+    OGLTexture texture = texture_recycler.Take({tuple, width, height, levels});
+    if (texture.handle) {
         return texture;
     }
 
-    const GLsizei levels = static_cast<GLsizei>(std::log2(std::max(width, height))) + 1;
-
-    OGLTexture texture;
     texture.Create();
-    texture.Allocate(GL_TEXTURE_2D, levels, tuple.internal_format, width, height);
+    texture.Allocate(GL_TEXTURE_2D, static_cast<GLsizei>(levels), tuple.internal_format, width,
+                     height);
 
     return texture;
 }
 
+void RasterizerCacheOpenGL::RecycleSurfaceTexture(const FormatTuple& tuple, u32 width, u32 height,
+                                                  u32 bytes_per_pixel, OGLTexture&& texture) {
+    // The full mipmap chain adds up to a third of the base level
+    const std::size_t size = std::size_t{width} * height * bytes_per_pixel * 4 / 3;
+    texture_recycler.Recycle({tuple, width, height, GetSurfaceTextureLevels(width, height)},
+                             std::move(texture), size);
+}
+
 MICROPROFILE_DEFINE(RasterizerCache_CopySurface, "RasterizerCache", "CopySurface",
                     MP_RGB(128, 192, 64));
 void RasterizerCacheOpenGL::CopySurface(const Surface& src_surface, const Surface& dst_surface,
@@ -102,6 +115,8 @@ void RasterizerCacheOpenGL::CopySurface(const Surface& src_surface, const Surfac
     SurfaceParams subrect_params = dst_surface->FromInterval(copy_interval);
     ASSERT(subrect_params.GetInterval() == copy_interval);
     ASSERT(src_surface != dst_surface);
+    dst_surface->DiscardQueuedDownload();
+    dst_surface->custom_tex_hash = 0;
 
     // This is only called when CanCopy is true, no need to run checks here
     const Aspect aspect = ToAspect(dst_surface->type);
@@ -150,101 +165,123 @@ static constexpr MatchFlags operator|(MatchFlags lhs, MatchFlags rhs) {
     return static_cast<MatchFlags>(static_cast<int>(lhs) | static_cast<int>(rhs));
 }
 
-/// Get the best surface match (and its match type) for the given flags
+/**
+ * Get the best surface match (and its match type) for the given flags.
+ * Exact, SubRect and TexCopy matches must contain params.addr, so when the page of that address
+ * is tracked by the flat page table only its surfaces are considered instead of walking the
+ * interval map.
+ */
 template <MatchFlags find_flags>
-static Surface FindMatch(const SurfaceCache& surface_cache, const SurfaceParams& params,
-                         ScaleMatch match_scale_type,
+static Surface FindMatch(const SurfaceCache& surface_cache, const SurfacePageList* page_surfaces,
+                         const SurfaceParams& params, ScaleMatch match_scale_type,
                          std::optional<SurfaceInterval> validate_interval = std::nullopt) {
     Surface match_surface = nullptr;
     bool match_valid = false;
     u32 match_scale = 0;
     SurfaceInterval match_interval{};
 
-    for (const auto& pair : RangeFromInterval(surface_cache, params.GetInterval())) {
-        for (const auto& surface : pair.second) {
-            const bool res_scale_matched = match_scale_type == ScaleMatch::Exact
-                                               ? (params.res_scale == surface->res_scale)
-                                               : (params.res_scale <= surface->res_scale);
-            // validity will be checked in GetCopyableInterval
-            bool is_valid =
-                find_flags & MatchFlags::Copy
-                    ? true
-                    : surface->IsRegionValid(validate_interval.value_or(params.GetInterval()));
-
-            if (!(find_flags & MatchFlags::Invalid) && !is_valid)
-                continue;
+    const auto check_surface = [&](const Surface& surface) {
+        const bool res_scale_matched = match_scale_type == ScaleMatch::Exact
+                                           ? (params.res_scale == surface->res_scale)
+                                           : (params.res_scale <= surface->res_scale);
+        // validity will be checked in GetCopyableInterval
+        bool is_valid =
+            find_flags & MatchFlags::Copy
+                ? true
+                : surface->IsRegionValid(validate_interval.value_or(params.GetInterval()));
+
+        if (!(find_flags & MatchFlags::Invalid) && !is_valid)
+            return;
+
+        auto IsMatch_Helper = [&](auto check_type, auto match_fn) {
+            if (!(find_flags & check_type))
+                return;
+
+            bool matched;
+            SurfaceInterval surface_interval;
+            std::tie(matched, surface_interval) = match_fn();
+            if (!matched)
+                return;
+
+            if (!res_scale_matched && match_scale_type != ScaleMatch::Ignore &&
+                surface->type != SurfaceType::Fill)
+                return;
+
+            // Found a match, update only if this is better than the previous one
+            auto UpdateMatch = [&] {
+                match_surface = surface;
+                match_valid = is_valid;
+                match_scale = surface->res_scale;
+                match_interval = surface_interval;
+            };
 
-            auto IsMatch_Helper = [&](auto check_type, auto match_fn) {
-                if (!(find_flags & check_type))
-                    return;
-
-                bool matched;
-                SurfaceInterval surface_interval;
-                std::tie(matched, surface_interval) = match_fn();
-                if (!matched)
-                    return;
-
-                if (!res_scale_matched && match_scale_type != ScaleMatch::Ignore &&
-                    surface->type != SurfaceType::Fill)
-                    return;
-
-                // Found a match, update only if this is better than the previous one
-                auto UpdateMatch = [&] {
-                    match_surface = surface;
-                    match_valid = is_valid;
-                    match_scale = surface->res_scale;
-                    match_interval = surface_interval;
-                };
-
-                if (surface->res_scale > match_scale) {
-                    UpdateMatch();
-                    return;
-                } else if (surface->res_scale < match_scale) {
-                    return;
-                }
+            if (surface->res_scale > match_scale) {
+                UpdateMatch();
+                return;
+            } else if (surface->res_scale < match_scale) {
+                return;
+            }
 
-                if (is_valid && !match_valid) {
-                    UpdateMatch();
-                    return;
-                } else if (is_valid != match_valid) {
-                    return;
-                }
+            if (is_valid && !match_valid) {
+                UpdateMatch();
+                return;
+            } else if (is_valid != match_valid) {
+                return;
+            }
 
-                if (boost::icl::length(surface_interval) > boost::icl::length(match_interval)) {
-                    UpdateMatch();
-                }
-            };
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Exact>{}, [&] {
-                return std::make_pair(surface->ExactMatch(params), surface->GetInterval());
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::SubRect>{}, [&] {
-                return std::make_pair(surface->CanSubRect(params), surface->GetInterval());
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Copy>{}, [&] {
-                ASSERT(validate_interval);
-                auto copy_interval =
-                    params.FromInterval(*validate_interval).GetCopyableInterval(surface);
-                bool matched = boost::icl::length(copy_interval & *validate_interval) != 0 &&
-                               surface->CanCopy(params, copy_interval);
-                return std::make_pair(matched, copy_interval);
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Expand>{}, [&] {
-                return std::make_pair(surface->CanExpand(params), surface->GetInterval());
-            });
-            IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::TexCopy>{}, [&] {
-                return std::make_pair(surface->CanTexCopy(params), surface->GetInterval());
-            });
+            if (boost::icl::length(surface_interval) > boost::icl::length(match_interval)) {
+                UpdateMatch();
+            }
+        };
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Exact>{}, [&] {
+            return std::make_pair(surface->ExactMatch(params), surface->GetInterval());
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::SubRect>{}, [&] {
+            return std::make_pair(surface->CanSubRect(params), surface->GetInterval());
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Copy>{}, [&] {
+            ASSERT(validate_interval);
+            auto copy_interval =
+                params.FromInterval(*validate_interval).GetCopyableInterval(surface);
+            bool matched = boost::icl::length(copy_interval & *validate_interval) != 0 &&
+                           surface->CanCopy(params, copy_interval);
+            return std::make_pair(matched, copy_interval);
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::Expand>{}, [&] {
+            return std::make_pair(surface->CanExpand(params), surface->GetInterval());
+        });
+        IsMatch_Helper(std::integral_constant<MatchFlags, MatchFlags::TexCopy>{}, [&] {
+            return std::make_pair(surface->CanTexCopy(params), surface->GetInterval());
+        });
+    };
+
+    constexpr bool contains_addr = !(find_flags & (MatchFlags::Copy | MatchFlags::Expand));
+    if (contains_addr && page_surfaces != nullptr) {
+        for (const auto& surface : *page_surfaces) {
+            check_surface(surface);
+        }
+        return match_surface;
+    }
+
+    for (const auto& pair : RangeFromInterval(surface_cache, params.GetInterval())) {
+        for (const auto& surface : pair.second) {
+            check_surface(surface);
         }
     }
     return match_surface;
 }
 
-RasterizerCacheOpenGL::RasterizerCacheOpenGL() {
+RasterizerCacheOpenGL::RasterizerCacheOpenGL()
+    : texture_recycler(TEXTURE_RECYCLER_BUDGET),
+      vram_pages(Memory::VRAM_SIZE >> Memory::CITRA_PAGE_BITS),
+      fcram_pages(Memory::FCRAM_N3DS_SIZE >> Memory::CITRA_PAGE_BITS) {
     resolution_scale_factor = VideoCore::GetResolutionScaleFactor();
+    settings_epoch = Settings::GetSnapshot().epoch;
     texture_filterer = std::make_unique<TextureFilterer>(
         Settings::values.texture_filter_name.GetValue(), resolution_scale_factor);
     format_reinterpreter = std::make_unique<FormatReinterpreterOpenGL>();
     texture_downloader_es = std::make_unique<TextureDownloaderES>(false);
+    texture_decoder = std::make_unique<TextureDecoderOpenGL>();
 }
 
 RasterizerCacheOpenGL::~RasterizerCacheOpenGL() {
@@ -264,6 +301,7 @@ bool RasterizerCacheOpenGL::BlitSurfaces(const Surface& src_surface,
 
     if (CheckFormatsBlittable(src_surface->pixel_format, dst_surface->pixel_format)) {
         dst_surface->InvalidateAllWatcher();
+        dst_surface->custom_tex_hash = 0;
 
         const Aspect aspect = ToAspect(src_surface->type);
         return runtime.BlitTextures(src_surface->texture, {aspect, src_rect}, dst_surface->texture,
@@ -285,16 +323,19 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
 
     // Check for an exact match in existing surfaces
     Surface surface =
-        FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(surface_cache, params, match_res_scale);
+        FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(
+            surface_cache, GetPageSurfaces(params.addr), params, match_res_scale);
 
-    if (surface == nullptr) {
+    if (surface != nullptr) {
+        ++stats.hits;
+    } else {
         u16 target_res_scale = params.res_scale;
         if (match_res_scale != ScaleMatch::Exact) {
             // This surface may have a subrect of another surface with a higher res_scale, find
             // it to adjust our params
             SurfaceParams find_params = params;
             Surface expandable = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(
-                surface_cache, find_params, match_res_scale);
+                surface_cache, nullptr, find_params, match_res_scale);
             if (expandable != nullptr && expandable->res_scale > target_res_scale) {
                 target_res_scale = expandable->res_scale;
             }
@@ -302,7 +343,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
             if (params.pixel_format == PixelFormat::RGBA8) {
                 find_params.pixel_format = PixelFormat::D24S8;
                 expandable = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(
-                    surface_cache, find_params, match_res_scale);
+                    surface_cache, nullptr, find_params, match_res_scale);
                 if (expandable != nullptr && expandable->res_scale > target_res_scale) {
                     target_res_scale = expandable->res_scale;
                 }
@@ -329,16 +370,20 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
     }
 
     // Attempt to find encompassing surface
-    Surface surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_cache, params,
-                                                                           match_res_scale);
+    const SurfacePageList* page_surfaces = GetPageSurfaces(params.addr);
+    Surface surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(
+        surface_cache, page_surfaces, params, match_res_scale);
+    if (surface != nullptr) {
+        ++stats.hits;
+    }
 
     // Check if FindMatch failed because of res scaling
     // If that's the case create a new surface with
     // the dimensions of the lower res_scale surface
     // to suggest it should not be used again
     if (surface == nullptr && match_res_scale != ScaleMatch::Ignore) {
-        surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_cache, params,
-                                                                       ScaleMatch::Ignore);
+        surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(
+            surface_cache, page_surfaces, params, ScaleMatch::Ignore);
         if (surface != nullptr) {
             SurfaceParams new_params = *surface;
             new_params.res_scale = params.res_scale;
@@ -358,8 +403,8 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
 
     // Check for a surface we can expand before creating a new one
     if (surface == nullptr) {
-        surface = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(surface_cache, aligned_params,
-                                                                      match_res_scale);
+        surface = FindMatch<MatchFlags::Expand | MatchFlags::Invalid>(
+            surface_cache, nullptr, aligned_params, match_res_scale);
         if (surface != nullptr) {
             aligned_params.width = aligned_params.stride;
             aligned_params.UpdateParams();
@@ -440,6 +485,13 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
     if (!surface)
         return nullptr;
 
+    // Swap in the custom texture once it has been decoded in the background
+    if (surface->custom_tex_pending && surface->custom_tex_hash != 0 &&
+        Core::System::GetInstance().CustomTexCache().IsTextureCached(surface->custom_tex_hash)) {
+        surface->invalid_regions.insert(surface->GetInterval());
+        ValidateSurface(surface, surface->addr, surface->size);
+    }
+
     // Update mipmap if necessary
     if (max_level != 0) {
         if (max_level >= 8) {
@@ -486,7 +538,7 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
                     ValidateSurface(level_surface, level_surface->addr, level_surface->size);
                 }
 
-                if (!surface->is_custom && texture_filterer->IsNull()) {
+                if (!surface->is_custom && texture_filterer->IsNull() && watcher->IsModified()) {
                     const auto src_rect = level_surface->GetScaledRect();
                     const auto dst_rect = surface_params.GetScaledRect();
                     const Aspect aspect = ToAspect(surface->type);
@@ -569,11 +621,14 @@ const CachedTextureCube& RasterizerCacheOpenGL::GetTextureCube(const TextureCube
                 ValidateSurface(surface, surface->addr, surface->size);
             }
 
-            const auto src_rect = surface->GetScaledRect();
-            const auto dst_rect = Common::Rectangle<u32>{0, scaled_size, scaled_size, 0};
-            const Aspect aspect = ToAspect(surface->type);
-            runtime.BlitTextures(surface->texture, {aspect, src_rect}, cube.texture,
-                                 {aspect, dst_rect, 0, static_cast<u32>(i)}, true);
+            // Only the faces whose surfaces were written since their last blit are blitted
+            if (face.watcher->IsModified()) {
+                const auto src_rect = surface->GetScaledRect();
+                const auto dst_rect = Common::Rectangle<u32>{0, scaled_size, scaled_size, 0};
+                const Aspect aspect = ToAspect(surface->type);
+                runtime.BlitTextures(surface->texture, {aspect, src_rect}, cube.texture,
+                                     {aspect, dst_rect, 0, static_cast<u32>(i)}, true);
+            }
 
             face.watcher->Validate();
         }
@@ -588,19 +643,22 @@ SurfaceSurfaceRect_Tuple RasterizerCacheOpenGL::GetFramebufferSurfaces(
     const auto& config = regs.framebuffer.framebuffer;
 
     // Update resolution_scale_factor and reset cache if changed
-    const bool resolution_scale_changed =
-        resolution_scale_factor != VideoCore::GetResolutionScaleFactor();
+    const u16 new_resolution_scale_factor = VideoCore::GetResolutionScaleFactor();
+    const bool resolution_scale_changed = resolution_scale_factor != new_resolution_scale_factor;
+    const u32 new_settings_epoch = Settings::GetSnapshot().epoch;
     const bool texture_filter_changed =
-        VideoCore::g_texture_filter_update_requested.exchange(false) &&
+        std::exchange(settings_epoch, new_settings_epoch) != new_settings_epoch &&
         texture_filterer->Reset(Settings::values.texture_filter_name.GetValue(),
-                                VideoCore::GetResolutionScaleFactor());
+                                new_resolution_scale_factor);
 
     if (resolution_scale_changed || texture_filter_changed) {
-        resolution_scale_factor = VideoCore::GetResolutionScaleFactor();
+        resolution_scale_factor = new_resolution_scale_factor;
         FlushAll();
         while (!surface_cache.empty())
             UnregisterSurface(*surface_cache.begin()->second.begin());
         texture_cube_cache.clear();
+        // Pooled textures were allocated for the previous scale and are unlikely to match again
+        texture_recycler.Clear();
     }
 
     Common::Rectangle<u32> viewport_clamped{
@@ -687,17 +745,26 @@ Surface RasterizerCacheOpenGL::GetFillSurface(const GPU::Regs::MemoryFillConfig&
     params.type = SurfaceType::Fill;
     params.res_scale = std::numeric_limits<u16>::max();
 
-    Surface new_surface = std::make_shared<CachedSurface>(params, *this, runtime);
+    std::array<u8, 4> fill_data;
+    std::memcpy(fill_data.data(), &config.value_32bit, sizeof(fill_data));
+    const u32 fill_size = config.fill_32bit ? 4 : config.fill_24bit ? 3 : 2;
 
-    std::memcpy(&new_surface->fill_data[0], &config.value_32bit, 4);
-    if (config.fill_32bit) {
-        new_surface->fill_size = 4;
-    } else if (config.fill_24bit) {
-        new_surface->fill_size = 3;
-    } else {
-        new_surface->fill_size = 2;
+    // Games clear the same buffers every frame, so reuse the fill of the previous clear when it
+    // wrote the same value over the same range instead of registering another surface
+    for (const auto& pair : RangeFromInterval(surface_cache, params.GetInterval())) {
+        for (const auto& surface : pair.second) {
+            if (surface->type == SurfaceType::Fill && surface->addr == params.addr &&
+                surface->end == params.end && surface->fill_size == fill_size &&
+                std::memcmp(surface->fill_data.data(), fill_data.data(), fill_size) == 0) {
+                return surface;
+            }
+        }
     }
 
+    Surface new_surface = std::make_shared<CachedSurface>(params, *this, runtime);
+    new_surface->fill_data = fill_data;
+    new_surface->fill_size = fill_size;
+
     RegisterSurface(new_surface);
     return new_surface;
 }
@@ -706,7 +773,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetTexCopySurface(const SurfaceParams&
     Common::Rectangle<u32> rect{};
 
     Surface match_surface = FindMatch<MatchFlags::TexCopy | MatchFlags::Invalid>(
-        surface_cache, params, ScaleMatch::Ignore);
+        surface_cache, GetPageSurfaces(params.addr), params, ScaleMatch::Ignore);
 
     if (match_surface != nullptr) {
         ValidateSurface(match_surface, params.addr, params.size);
@@ -735,6 +802,7 @@ void RasterizerCacheOpenGL::DuplicateSurface(const Surface& src_surface,
 
     BlitSurfaces(src_surface, src_surface->GetScaledRect(), dest_surface,
                  dest_surface->GetScaledSubRect(*src_surface));
+    dest_surface->modification_tick = ++modification_counter;
 
     dest_surface->invalid_regions -= src_surface->GetInterval();
     dest_surface->invalid_regions += src_surface->invalid_regions;
@@ -762,11 +830,15 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
         return;
     }
 
+    const Settings::Snapshot snapshot = Settings::GetSnapshot();
     auto validate_regions = surface->invalid_regions & validate_interval;
     auto notify_validated = [&](SurfaceInterval interval) {
         surface->invalid_regions.erase(interval);
         validate_regions.erase(interval);
     };
+    if (!validate_regions.empty()) {
+        surface->modification_tick = ++modification_counter;
+    }
 
     while (true) {
         const auto it = validate_regions.begin();
@@ -778,7 +850,8 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
         SurfaceParams params = surface->FromInterval(interval);
 
         Surface copy_surface =
-            FindMatch<MatchFlags::Copy>(surface_cache, params, ScaleMatch::Ignore, interval);
+            FindMatch<MatchFlags::Copy>(surface_cache, nullptr, params, ScaleMatch::Ignore,
+                                        interval);
         if (copy_surface != nullptr) {
             SurfaceInterval copy_interval = params.GetCopyableInterval(copy_surface);
             CopySurface(copy_surface, surface, copy_interval);
@@ -807,9 +880,16 @@ void RasterizerCacheOpenGL::ValidateSurface(const Surface& surface, PAddr addr,
             }
         }
 
-        // Load data from 3DS memory
-        FlushRegion(params.addr, params.size);
-        surface->LoadGLBuffer(params.addr, params.end);
+        // Load data from 3DS memory. Texture dumps and replacements are found by the hash of the
+        // whole surface, which the staging buffer doesn't keep from earlier loads.
+        if (surface->type == SurfaceType::Texture &&
+            (snapshot.dump_textures || snapshot.custom_textures)) {
+            FlushRegion(surface->addr, surface->size);
+            surface->LoadGLBuffer(surface->addr, surface->end);
+        } else {
+            FlushRegion(params.addr, params.size);
+            surface->LoadGLBuffer(params.addr, params.end);
+        }
         surface->UploadGLTexture(surface->GetSubRect(params));
         notify_validated(params.GetInterval());
     }
@@ -832,7 +912,8 @@ bool RasterizerCacheOpenGL::NoUnimplementedReinterpretations(const Surface& surf
             // This could potentially be expensive,
             // although experimentally it hasn't been too bad
             Surface test_surface =
-                FindMatch<MatchFlags::Copy>(surface_cache, params, ScaleMatch::Ignore, interval);
+                FindMatch<MatchFlags::Copy>(surface_cache, nullptr, params, ScaleMatch::Ignore,
+                                            interval);
             if (test_surface != nullptr) {
                 LOG_WARNING(Render_OpenGL, "Missing pixel_format reinterpreter: {} -> {}",
                             PixelFormatAsString(format),
@@ -869,7 +950,8 @@ bool RasterizerCacheOpenGL::ValidateByReinterpretation(const Surface& surface,
 
         params.pixel_format = reinterpreter->GetSourceFormat();
         Surface reinterpret_surface =
-            FindMatch<MatchFlags::Copy>(surface_cache, params, ScaleMatch::Ignore, interval);
+            FindMatch<MatchFlags::Copy>(surface_cache, nullptr, params, ScaleMatch::Ignore,
+                                        interval);
 
         if (reinterpret_surface != nullptr) {
             auto reinterpret_interval = params.GetCopyableInterval(reinterpret_surface);
@@ -887,7 +969,8 @@ bool RasterizerCacheOpenGL::ValidateByReinterpretation(const Surface& surface,
                 const Common::Rectangle<u32> tmp_rect{0, width, height, 0};
 
                 OGLTexture tmp_tex = AllocateSurfaceTexture(tuple, height, width);
-                reinterpreter->Reinterpret(reinterpret_surface->texture, src_rect, tmp_tex,
+                reinterpreter->Reinterpret(reinterpret_surface->texture, src_rect,
+                                           reinterpret_surface->modification_tick, tmp_tex,
                                            tmp_rect);
 
                 if (!texture_filterer->Filter(tmp_tex, tmp_rect, surface->texture, dest_rect,
@@ -898,8 +981,9 @@ bool RasterizerCacheOpenGL::ValidateByReinterpretation(const Surface& surface,
                                          {aspect, dest_rect});
                 }
             } else {
-                reinterpreter->Reinterpret(reinterpret_surface->texture, src_rect, surface->texture,
-                                           dest_rect);
+                reinterpreter->Reinterpret(reinterpret_surface->texture, src_rect,
+                                           reinterpret_surface->modification_tick,
+                                           surface->texture, dest_rect);
             }
 
             return true;
@@ -916,6 +1000,37 @@ void RasterizerCacheOpenGL::ClearAll(bool flush) {
         FlushRegion(0x0, 0xFFFFFFFF);
     }
     // Unmark all of the marked pages
+    const auto clear_pages = [](std::vector<CachedPage>& pages, PAddr base) {
+        const u32 base_page = base >> Memory::CITRA_PAGE_BITS;
+        u32 run_start = 0;
+        u32 run_end = 0;
+        const auto mark_run = [&] {
+            if (run_end > run_start) {
+                VideoCore::g_memory->RasterizerMarkRegionCached(
+                    (base_page + run_start) << Memory::CITRA_PAGE_BITS,
+                    (run_end - run_start) << Memory::CITRA_PAGE_BITS, false);
+            }
+            run_start = run_end = 0;
+        };
+        for (u32 i = 0; i < pages.size(); i++) {
+            CachedPage& page = pages[i];
+            if (page.cached_count == 0) {
+                mark_run();
+                continue;
+            }
+            if (run_end != i) {
+                mark_run();
+                run_start = i;
+            }
+            run_end = i + 1;
+            page.cached_count = 0;
+            page.surfaces.clear();
+        }
+        mark_run();
+    };
+    clear_pages(vram_pages, Memory::VRAM_PADDR);
+    clear_pages(fcram_pages, Memory::FCRAM_PADDR);
+
     for (auto& pair : RangeFromInterval(cached_pages, flush_interval)) {
         const auto interval = pair.first & flush_interval;
 
@@ -958,6 +1073,7 @@ void RasterizerCacheOpenGL::FlushRegion(PAddr addr, u32 size, Surface flush_surf
         if (surface->type != SurfaceType::Fill) {
             SurfaceParams params = surface->FromInterval(interval);
             surface->DownloadGLTexture(surface->GetSubRect(params));
+            stats.readback_bytes += boost::icl::length(interval);
         }
 
         surface->FlushGLBuffer(boost::icl::first(interval), boost::icl::last_next(interval));
@@ -967,6 +1083,11 @@ void RasterizerCacheOpenGL::FlushRegion(PAddr addr, u32 size, Surface flush_surf
     dirty_regions -= flushed_intervals;
 }
 
+void RasterizerCacheOpenGL::EndFrame() {
+    std::lock_guard lock{mutex};
+    frame_arena.Reset();
+}
+
 void RasterizerCacheOpenGL::FlushAll() {
     FlushRegion(0, 0xFFFFFFFF);
 }
@@ -985,6 +1106,15 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
         // Surfaces can't have a gap
         ASSERT(region_owner->width == region_owner->stride);
         region_owner->invalid_regions.erase(invalid_interval);
+
+        // Stop downloading ahead of time when the surface is rendered to again before the guest
+        // reads the previous contents
+        if (region_owner->pending_download) {
+            region_owner->read_back = false;
+        }
+        region_owner->DiscardQueuedDownload();
+        region_owner->custom_tex_hash = 0;
+        region_owner->modification_tick = ++modification_counter;
     }
 
     for (const auto& pair : RangeFromInterval(surface_cache, invalid_interval)) {
@@ -1003,6 +1133,7 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
             const auto interval = cached_surface->GetInterval() & invalid_interval;
             cached_surface->invalid_regions.insert(interval);
             cached_surface->InvalidateAllWatcher();
+            cached_surface->DiscardQueuedDownload();
 
             // If the surface has no salvageable data it should be removed from the cache to avoid
             // clogging the data structure
@@ -1020,7 +1151,8 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
     for (const auto& remove_surface : remove_surfaces) {
         if (remove_surface == region_owner) {
             Surface expanded_surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(
-                surface_cache, *region_owner, ScaleMatch::Ignore);
+                surface_cache, GetPageSurfaces(region_owner->addr), *region_owner,
+                ScaleMatch::Ignore);
             ASSERT(expanded_surface);
 
             if ((region_owner->invalid_regions - expanded_surface->invalid_regions).empty()) {
@@ -1038,6 +1170,7 @@ void RasterizerCacheOpenGL::InvalidateRegion(PAddr addr, u32 size, const Surface
 Surface RasterizerCacheOpenGL::CreateSurface(const SurfaceParams& params) {
     Surface surface = std::make_shared<CachedSurface>(params, *this, runtime);
     surface->invalid_regions.insert(surface->GetInterval());
+    ++stats.misses;
 
     // Allocate surface texture
     const FormatTuple& tuple = GetFormatTuple(surface->pixel_format);
@@ -1055,6 +1188,7 @@ void RasterizerCacheOpenGL::RegisterSurface(const Surface& surface) {
     }
     surface->registered = true;
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
+    UpdatePageSurfaces(surface, true);
     UpdatePagesCachedCount(surface->addr, surface->size, 1);
 }
 
@@ -1066,15 +1200,97 @@ void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
     }
     surface->registered = false;
     UpdatePagesCachedCount(surface->addr, surface->size, -1);
+    UpdatePageSurfaces(surface, false);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
 }
 
+RasterizerCacheOpenGL::CachedPage* RasterizerCacheOpenGL::GetCachedPage(u32 page_index) {
+    constexpr u32 vram_page_start = Memory::VRAM_PADDR >> Memory::CITRA_PAGE_BITS;
+    constexpr u32 fcram_page_start = Memory::FCRAM_PADDR >> Memory::CITRA_PAGE_BITS;
+
+    if (page_index >= fcram_page_start && page_index - fcram_page_start < fcram_pages.size()) {
+        return &fcram_pages[page_index - fcram_page_start];
+    }
+    if (page_index >= vram_page_start && page_index - vram_page_start < vram_pages.size()) {
+        return &vram_pages[page_index - vram_page_start];
+    }
+    return nullptr;
+}
+
+const SurfacePageList* RasterizerCacheOpenGL::GetPageSurfaces(PAddr addr) {
+    const CachedPage* page = GetCachedPage(addr >> Memory::CITRA_PAGE_BITS);
+    return page ? &page->surfaces : nullptr;
+}
+
+void RasterizerCacheOpenGL::UpdatePageSurfaces(Surface surface, bool add) {
+    const u32 page_start = surface->addr >> Memory::CITRA_PAGE_BITS;
+    const u32 page_end = ((surface->end - 1) >> Memory::CITRA_PAGE_BITS) + 1;
+
+    for (u32 page_index = page_start; page_index < page_end; page_index++) {
+        CachedPage* page = GetCachedPage(page_index);
+        if (page == nullptr) {
+            continue;
+        }
+
+        auto& surfaces = page->surfaces;
+        if (add) {
+            surfaces.push_back(surface);
+            continue;
+        }
+
+        const auto it = std::find(surfaces.begin(), surfaces.end(), surface);
+        ASSERT(it != surfaces.end());
+        *it = std::move(surfaces.back());
+        surfaces.pop_back();
+    }
+}
+
 void RasterizerCacheOpenGL::UpdatePagesCachedCount(PAddr addr, u32 size, int delta) {
-    const u32 num_pages =
-        ((addr + size - 1) >> Memory::CITRA_PAGE_BITS) - (addr >> Memory::CITRA_PAGE_BITS) + 1;
     const u32 page_start = addr >> Memory::CITRA_PAGE_BITS;
-    const u32 page_end = page_start + num_pages;
+    const u32 page_end = ((addr + size - 1) >> Memory::CITRA_PAGE_BITS) + 1;
+    const bool cached = delta > 0;
+
+    // Pages that become (un)cached are marked in contiguous runs to keep the number of calls
+    // into the memory system low
+    u32 run_start = 0;
+    u32 run_end = 0;
+    const auto mark_run = [&] {
+        if (run_end > run_start) {
+            VideoCore::g_memory->RasterizerMarkRegionCached(
+                run_start << Memory::CITRA_PAGE_BITS,
+                (run_end - run_start) << Memory::CITRA_PAGE_BITS, cached);
+        }
+        run_start = run_end = 0;
+    };
+
+    for (u32 page_index = page_start; page_index < page_end; page_index++) {
+        CachedPage* page = GetCachedPage(page_index);
+        if (page == nullptr) {
+            mark_run();
+            UpdateFallbackPagesCachedCount(page_index, page_index + 1, delta);
+            continue;
+        }
+
+        const u32 old_count = page->cached_count;
+        ASSERT(cached || old_count >= static_cast<u32>(-delta));
+        page->cached_count = old_count + delta;
+
+        const bool changed = cached ? old_count == 0 : page->cached_count == 0;
+        if (!changed) {
+            mark_run();
+            continue;
+        }
+        if (run_end != page_index) {
+            mark_run();
+            run_start = page_index;
+        }
+        run_end = page_index + 1;
+    }
+    mark_run();
+}
 
+void RasterizerCacheOpenGL::UpdateFallbackPagesCachedCount(u32 page_start, u32 page_end,
+                                                           int delta) {
     // Interval maps will erase segments if count reaches 0, so if delta is negative we have to
     // subtract after iterating
     const auto pages_interval = PageMap::interval_type::right_open(page_start, page_end);
@@ -4,9 +4,11 @@
 
 #pragma once
 #include <unordered_map>
+#include "common/arena.h"
 #include "video_core/rasterizer_cache/cached_surface.h"
 #include "video_core/rasterizer_cache/rasterizer_cache_utils.h"
 #include "video_core/rasterizer_cache/surface_params.h"
+#include "video_core/rasterizer_cache/texture_recycler.h"
 #include "video_core/texture/texture_decode.h"
 
 namespace OpenGL {
@@ -17,9 +19,16 @@ enum class ScaleMatch {
     Ignore   // accept every scaled res
 };
 
+struct SurfaceCacheStats {
+    u64 hits = 0;           ///< Lookups served by a cached surface
+    u64 misses = 0;         ///< Surfaces created because no cached surface matched
+    u64 readback_bytes = 0; ///< Bytes downloaded from surface textures to write guest memory
+};
+
 class TextureDownloaderES;
 class TextureFilterer;
 class FormatReinterpreterOpenGL;
+class TextureDecoderOpenGL;
 
 class RasterizerCacheOpenGL : NonCopyable {
 public:
@@ -72,13 +81,26 @@ public:
     /// Clear all cached resources tracked by this cache manager
     void ClearAll(bool flush);
 
+    const SurfaceCacheStats& GetStats() const {
+        return stats;
+    }
+
+    /// Frees the transient data of the frame
+    void EndFrame();
+
     // Textures from destroyed surfaces are stored here to be recyled to reduce allocation overhead
     // in the driver
     // this must be placed above the surface_cache to ensure all cached surfaces are destroyed
     // before destroying the recycler
-    std::unordered_multimap<HostTextureTag, OGLTexture> host_texture_recycler;
+    TextureRecycler texture_recycler;
 
 private:
+    /// Video memory that may be held by the textures of destroyed surfaces
+    static constexpr std::size_t TEXTURE_RECYCLER_BUDGET = 512 * 1024 * 1024;
+    /// The frame arena starts with room for a 512x512 RGBA8 surface, it keeps up to 32 MiB
+    static constexpr std::size_t FRAME_ARENA_BLOCK_SIZE = 1024 * 1024;
+    static constexpr std::size_t FRAME_ARENA_RETAINED_SIZE = 32 * 1024 * 1024;
+
     void DuplicateSurface(const Surface& src_surface, const Surface& dest_surface);
 
     /// Update surface's texture for given region when necessary
@@ -108,13 +130,40 @@ private:
     /// Increase/decrease the number of surface in pages touching the specified region
     void UpdatePagesCachedCount(PAddr addr, u32 size, int delta);
 
+    /// Same as UpdatePagesCachedCount for pages not covered by the flat page table
+    void UpdateFallbackPagesCachedCount(u32 page_start, u32 page_end, int delta);
+
+    /// Adds or removes the surface from the candidate lists of the pages it overlaps. The surface
+    /// is taken by value since the caller may pass a reference into one of those lists
+    void UpdatePageSurfaces(Surface surface, bool add);
+
+    struct CachedPage {
+        u32 cached_count = 0;     ///< Number of surfaces overlapping the page
+        SurfacePageList surfaces; ///< Surfaces overlapping the page
+    };
+
+    /// Returns the flat page table entry for the page or nullptr if it's not covered by it
+    CachedPage* GetCachedPage(u32 page_index);
+
+    /// Returns the surfaces overlapping the page containing addr or nullptr if it's not tracked
+    const SurfacePageList* GetPageSurfaces(PAddr addr);
+
     TextureRuntime runtime;
     SurfaceCache surface_cache;
-    PageMap cached_pages;
+    PageMap cached_pages; ///< Cached counts of the pages outside of the flat page table
+    std::vector<CachedPage> vram_pages;
+    std::vector<CachedPage> fcram_pages;
+    /// The regions whose latest contents are only in the surface that wrote them, and not yet in
+    /// guest memory. Only these are downloaded, and only once the guest accesses them.
     SurfaceMap dirty_regions;
     SurfaceSet remove_surfaces;
+    SurfaceCacheStats stats;
+    /// Incremented by every write to the texture of a surface, see CachedSurface::modification_tick
+    u64 modification_counter = 0;
 
     u16 resolution_scale_factor;
+    /// The epoch of the settings the texture filter was last checked against
+    u32 settings_epoch;
 
     std::unordered_map<TextureCubeConfig, CachedTextureCube> texture_cube_cache;
 
@@ -123,9 +172,18 @@ private:
 public:
     OGLTexture AllocateSurfaceTexture(const FormatTuple& format_tuple, u32 width, u32 height);
 
+    /// Returns the texture of a destroyed surface to the pool used by AllocateSurfaceTexture
+    void RecycleSurfaceTexture(const FormatTuple& format_tuple, u32 width, u32 height,
+                               u32 bytes_per_pixel, OGLTexture&& texture);
+
     std::unique_ptr<TextureFilterer> texture_filterer;
     std::unique_ptr<FormatReinterpreterOpenGL> format_reinterpreter;
     std::unique_ptr<TextureDownloaderES> texture_downloader_es;
+    std::unique_ptr<TextureDecoderOpenGL> texture_decoder;
+
+    /// Transient data that only lives until the end of the frame, e.g. the staging buffers of
+    /// surface loads and flushes
+    Common::LinearArena frame_arena{FRAME_ARENA_BLOCK_SIZE, FRAME_ARENA_RETAINED_SIZE};
 };
 
 } // namespace OpenGL
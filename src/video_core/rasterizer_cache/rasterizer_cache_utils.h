@@ -21,13 +21,14 @@ struct HostTextureTag {
     FormatTuple format_tuple{};
     u32 width = 0;
     u32 height = 0;
+    u32 levels = 0;
 
     bool operator==(const HostTextureTag& rhs) const noexcept {
         return std::memcmp(this, &rhs, sizeof(HostTextureTag)) == 0;
     };
 
     const u64 Hash() const {
-        return Common::ComputeHash64(this, sizeof(HostTextureTag));
+        return Common::ComputeStructHash64(*this);
     }
 };
 
@@ -50,7 +51,7 @@ struct TextureCubeConfig {
     }
 
     const u64 Hash() const {
-        return Common::ComputeHash64(this, sizeof(TextureCubeConfig));
+        return Common::ComputeStructHash64(*this);
     }
 };
 
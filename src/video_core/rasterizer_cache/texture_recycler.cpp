@@ -0,0 +1,84 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/logging/log.h"
+#include "common/memory_usage.h"
+#include "video_core/rasterizer_cache/texture_recycler.h"
+
+namespace OpenGL {
+
+/// The pooled textures count as OpenGL textures too
+static Common::MemoryUsage::Counter RecycledTextureUsage{"Rasterizer cache", "Recycled textures"};
+
+TextureRecycler::TextureRecycler(std::size_t budget) : budget{budget} {}
+
+TextureRecycler::~TextureRecycler() {
+    RecycledTextureUsage.Set(0, 0);
+    LOG_INFO(Render_OpenGL,
+             "Texture recycler: {} hits, {} misses, {} evictions, {} textures pooled ({} KiB)",
+             stats.hits, stats.misses, stats.evictions, stats.pooled_textures,
+             stats.pooled_bytes / 1024);
+}
+
+OGLTexture TextureRecycler::Take(const HostTextureTag& tag) {
+    const auto it = lookup.find(tag);
+    if (it == lookup.end()) {
+        ++stats.misses;
+        return {};
+    }
+
+    ++stats.hits;
+    const auto entry = it->second;
+    OGLTexture texture = std::move(entry->texture);
+    lookup.erase(it);
+    stats.pooled_bytes -= entry->size;
+    --stats.pooled_textures;
+    entries.erase(entry);
+    RecycledTextureUsage.Set(stats.pooled_bytes, stats.pooled_textures);
+    return texture;
+}
+
+void TextureRecycler::Recycle(const HostTextureTag& tag, OGLTexture&& texture, std::size_t size) {
+    if (size > budget) {
+        // Keeping it would flush the whole pool, so release it right away
+        ++stats.evictions;
+        texture.Release();
+        return;
+    }
+
+    while (stats.pooled_bytes + size > budget) {
+        ++stats.evictions;
+        Erase(entries.begin());
+    }
+
+    const auto entry = entries.insert(entries.end(), Entry{tag, std::move(texture), size});
+    lookup.emplace(tag, entry);
+    stats.pooled_bytes += size;
+    ++stats.pooled_textures;
+    RecycledTextureUsage.Set(stats.pooled_bytes, stats.pooled_textures);
+}
+
+void TextureRecycler::Clear() {
+    lookup.clear();
+    entries.clear();
+    stats.pooled_bytes = 0;
+    stats.pooled_textures = 0;
+    RecycledTextureUsage.Set(0, 0);
+}
+
+void TextureRecycler::Erase(EntryList::iterator entry) {
+    auto [begin, end] = lookup.equal_range(entry->tag);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == entry) {
+            lookup.erase(it);
+            break;
+        }
+    }
+
+    stats.pooled_bytes -= entry->size;
+    --stats.pooled_textures;
+    entries.erase(entry);
+}
+
+} // namespace OpenGL
@@ -0,0 +1,60 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+#include <list>
+#include <unordered_map>
+#include "video_core/rasterizer_cache/rasterizer_cache_utils.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+struct TextureRecyclerStats {
+    u64 hits = 0;      ///< Allocations served by a recycled texture
+    u64 misses = 0;    ///< Allocations that had to create a new texture
+    u64 evictions = 0; ///< Recycled textures deleted to stay within the budget
+    std::size_t pooled_textures = 0;
+    std::size_t pooled_bytes = 0;
+};
+
+/**
+ * Keeps the textures of destroyed surfaces around so that new surfaces with the same format and
+ * dimensions can reuse them instead of allocating from the driver. At high resolution scales the
+ * pool is bounded by a memory budget, the textures that were recycled first are deleted first.
+ */
+class TextureRecycler {
+public:
+    explicit TextureRecycler(std::size_t budget);
+    ~TextureRecycler();
+
+    /// Returns a recycled texture matching the tag, or an empty texture if there is none
+    OGLTexture Take(const HostTextureTag& tag);
+
+    /// Adds the texture to the pool, size is the estimated video memory used by it
+    void Recycle(const HostTextureTag& tag, OGLTexture&& texture, std::size_t size);
+
+    /// Deletes all pooled textures
+    void Clear();
+
+    const TextureRecyclerStats& GetStats() const {
+        return stats;
+    }
+
+private:
+    struct Entry {
+        HostTextureTag tag;
+        OGLTexture texture;
+        std::size_t size;
+    };
+    using EntryList = std::list<Entry>;
+
+    void Erase(EntryList::iterator entry);
+
+    std::size_t budget;
+    EntryList entries; ///< Pooled textures, the oldest first
+    std::unordered_multimap<HostTextureTag, EntryList::iterator> lookup;
+    TextureRecyclerStats stats;
+};
+
+} // namespace OpenGL
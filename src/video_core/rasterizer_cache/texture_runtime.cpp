@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+#include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "video_core/rasterizer_cache/rasterizer_cache_utils.h"
 #include "video_core/rasterizer_cache/texture_runtime.h"
@@ -9,6 +11,8 @@
 
 namespace OpenGL {
 
+MICROPROFILE_DEFINE(OpenGL_StagingWait, "OpenGL", "Staging Buffer Wait", MP_RGB(128, 192, 64));
+
 GLbitfield ToBufferMask(Aspect aspect) {
     switch (aspect) {
     case Aspect::Color:
@@ -62,6 +66,91 @@ void TextureRuntime::ReadTexture(const OGLTexture& tex, Subresource subresource,
                  tuple.type, pixels);
 }
 
+StagingTicket TextureRuntime::QueueReadTexture(const OGLTexture& tex, Subresource subresource,
+                                               const FormatTuple& tuple, u32 bytes_per_pixel) {
+    const auto& rect = subresource.region;
+    const std::size_t index =
+        BeginStagingRead(rect.GetWidth() * rect.GetHeight() * bytes_per_pixel);
+    // With a pack buffer bound the pixels pointer is an offset into the buffer
+    ReadTexture(tex, subresource, tuple, nullptr);
+    return EndStagingRead(index);
+}
+
+StagingTicket TextureRuntime::QueueReadFramebuffer(GLuint framebuffer, Common::Rectangle<u32> rect,
+                                                   GLenum format, GLenum type,
+                                                   u32 bytes_per_pixel) {
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    OpenGLState state = prev_state;
+    state.draw.read_framebuffer = framebuffer;
+    state.Apply();
+
+    const std::size_t index =
+        BeginStagingRead(rect.GetWidth() * rect.GetHeight() * bytes_per_pixel);
+    glReadPixels(rect.left, rect.bottom, rect.GetWidth(), rect.GetHeight(), format, type, nullptr);
+    return EndStagingRead(index);
+}
+
+std::size_t TextureRuntime::BeginStagingRead(u32 size) {
+    // Staging buffers are used in a ring, the oldest download is dropped once all are in use
+    const std::size_t index = next_staging_buffer;
+    next_staging_buffer = (next_staging_buffer + 1) % NUM_STAGING_BUFFERS;
+
+    StagingBuffer& staging = staging_buffers[index];
+    staging.buffer.Create();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, staging.buffer.handle);
+    if (staging.capacity < size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        staging.capacity = size;
+    }
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    return index;
+}
+
+StagingTicket TextureRuntime::EndStagingRead(std::size_t index) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    StagingBuffer& staging = staging_buffers[index];
+    staging.fence.Release();
+    staging.fence.Create();
+    staging.id = next_staging_id++;
+
+    return StagingTicket{static_cast<u32>(index), staging.id};
+}
+
+bool TextureRuntime::FinishReadTexture(StagingTicket ticket, u8* pixels, u32 row_size,
+                                       u32 pixels_stride, u32 rows) {
+    StagingBuffer& staging = staging_buffers[ticket.index];
+    if (!ticket || staging.id != ticket.id) {
+        return false;
+    }
+
+    {
+        MICROPROFILE_SCOPE(OpenGL_StagingWait);
+        GLenum result;
+        do {
+            result = glClientWaitSync(staging.fence.handle, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      1'000'000'000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, staging.buffer.handle);
+    const u8* data = static_cast<const u8*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, row_size * rows, GL_MAP_READ_BIT));
+    if (data != nullptr) {
+        for (u32 row = 0; row < rows; ++row) {
+            std::memcpy(pixels + row * pixels_stride, data + row * row_size, row_size);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Each download is consumed at most once
+    staging.id = 0;
+    return data != nullptr;
+}
+
 bool TextureRuntime::ClearTexture(const OGLTexture& tex, Subresource subresource,
                                   ClearValue value) {
     OpenGLState prev_state = OpenGLState::GetCurState();
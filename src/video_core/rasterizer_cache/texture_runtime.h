@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <array>
 #include "common/math_util.h"
 #include "common/vector_math.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
@@ -33,6 +34,16 @@ struct Subresource {
 
 struct FormatTuple;
 
+// Identifies a texture download queued with TextureRuntime::QueueReadTexture
+struct StagingTicket {
+    u32 index = 0;
+    u64 id = 0;
+
+    explicit operator bool() const {
+        return id != 0;
+    }
+};
+
 /**
  * Provides texture manipulation functions to the rasterizer cache
  * Separating this into a class makes it easier to abstract graphics API code
@@ -46,6 +57,20 @@ public:
     void ReadTexture(const OGLTexture& tex, Subresource subresource, const FormatTuple& tuple,
                      u8* pixels);
 
+    // Queues a copy of the GPU pixel data to a staging buffer without waiting for it
+    StagingTicket QueueReadTexture(const OGLTexture& tex, Subresource subresource,
+                                   const FormatTuple& tuple, u32 bytes_per_pixel);
+
+    // Queues a copy of the color of the framebuffer to a staging buffer, e.g. of a conversion
+    // of depth to color by TextureDownloaderES, without waiting for it
+    StagingTicket QueueReadFramebuffer(GLuint framebuffer, Common::Rectangle<u32> rect,
+                                       GLenum format, GLenum type, u32 bytes_per_pixel);
+
+    // Waits for a queued download and copies it to the rows of the provided pixels buffer.
+    // Returns false if the staging buffer has been reused by a newer download meanwhile
+    bool FinishReadTexture(StagingTicket ticket, u8* pixels, u32 row_size, u32 pixels_stride,
+                           u32 rows);
+
     // Fills the rectangle of the texture with the clear value provided
     bool ClearTexture(const OGLTexture& texture, Subresource subresource, ClearValue value);
 
@@ -64,7 +89,25 @@ public:
     void GenerateMipmaps(const OGLTexture& tex, u32 max_level);
 
 private:
+    // Number of queued downloads that can be in flight at the same time
+    static constexpr std::size_t NUM_STAGING_BUFFERS = 8;
+
+    struct StagingBuffer {
+        OGLBuffer buffer;
+        OGLSync fence;
+        u32 capacity = 0;
+        u64 id = 0;
+    };
+
     OGLFramebuffer read_fbo, draw_fbo;
+    // Binds the next staging buffer of the ring, large enough for size bytes, as the pack buffer
+    std::size_t BeginStagingRead(u32 size);
+    // Unbinds the staging buffer and fences the read into it
+    StagingTicket EndStagingRead(std::size_t index);
+
+    std::array<StagingBuffer, NUM_STAGING_BUFFERS> staging_buffers;
+    std::size_t next_staging_buffer = 0;
+    u64 next_staging_id = 1;
 };
 
 } // namespace OpenGL
@@ -27,6 +27,19 @@ enum class LoadCallbackStage {
 };
 using DiskResourceLoadCallback = std::function<void(LoadCallbackStage, std::size_t, std::size_t)>;
 
+/// Counters of the work done by a rasterizer since it was created
+struct RasterizerStatistics {
+    u64 draws = 0;            ///< Pica draws rendered
+    u64 surface_hits = 0;     ///< Surface lookups served by a cached surface
+    u64 surface_misses = 0;   ///< Surfaces created because no cached surface matched
+    u64 readback_bytes = 0;   ///< Bytes of rendered surfaces written back to guest memory
+    u64 shaders = 0;          ///< Host shaders built
+    u64 state_changes = 0;    ///< Blocks of host state changed when applying a state
+    u64 state_unchanged = 0;  ///< Blocks of host state that were already set when applying one
+    u64 frame_bytes = 0;      ///< Bytes of transient data allocated for frames
+    u64 frame_peak_bytes = 0; ///< Most transient bytes allocated for a single frame
+};
+
 class RasterizerInterface {
 public:
     virtual ~RasterizerInterface() {}
@@ -39,9 +52,35 @@ public:
     /// Draw the current batch of triangles
     virtual void DrawTriangles() = 0;
 
+    /// Whether the rasterizer keeps the triangles of draws shaded on the CPU for reuse
+    virtual bool CachesShadedVertices() const {
+        return false;
+    }
+
+    /**
+     * Queues the triangles stored for the key by StoreShadedVertices instead of shading the draw.
+     * @param key Hash of everything the shading of the draw depends on
+     * @returns false if there are none, the triangles of the draw are then added as usual
+     */
+    virtual bool LoadShadedVertices(u64 key) {
+        return false;
+    }
+
+    /// Stores the triangles added since the failed LoadShadedVertices for the key
+    virtual void StoreShadedVertices(u64 key) {}
+
+    /// Notify rasterizer that the specified PICA register is about to be written
+    virtual void NotifyPicaRegisterChanging(u32 id) {}
+
     /// Notify rasterizer that the specified PICA register has been changed
     virtual void NotifyPicaRegisterChanged(u32 id) = 0;
 
+    /// Submit the draws deferred by the rasterizer, called once a command list has been processed
+    virtual void SubmitBatchedDraws() {}
+
+    /// Notify rasterizer that the frame was presented, which frees the transient data of the frame
+    virtual void EndFrame() {}
+
     /// Notify rasterizer that all caches should be flushed to 3DS memory
     virtual void FlushAll() = 0;
 
@@ -89,5 +128,9 @@ public:
                                    const DiskResourceLoadCallback& callback) {}
 
     virtual void SyncEntireState() {}
+
+    virtual RasterizerStatistics GetStatistics() const {
+        return {};
+    }
 };
 } // namespace VideoCore
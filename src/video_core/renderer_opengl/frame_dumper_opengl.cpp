@@ -2,14 +2,62 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <string>
 #include <glad/glad.h>
 #include "core/frontend/emu_window.h"
 #include "core/frontend/scope_acquire_context.h"
 #include "video_core/renderer_opengl/frame_dumper_opengl.h"
+#include "video_core/renderer_opengl/gl_shader_util.h"
+#include "video_core/renderer_opengl/gl_vars.h"
 #include "video_core/renderer_opengl/renderer_opengl.h"
 
 namespace OpenGL {
 
+// Draws a triangle covering the whole framebuffer
+static const char yuv_vertex_shader[] = R"(
+void main() {
+    vec2 position = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 4.0 - 1.0;
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+)";
+
+// Writes the luma plane, followed by the two chroma planes, of a frame_size.x wide framebuffer,
+// so that reading it back gives a YUV420P frame. The coefficients are those of swscale, which
+// converts the frames otherwise.
+static const char yuv_fragment_shader[] = R"(
+layout(location = 0) out float color;
+
+uniform sampler2D color_texture;
+uniform ivec2 frame_size;
+
+// Limited range BT.601
+const vec3 y_coefficients = vec3(0.299, 0.587, 0.114) * (219.0 / 255.0);
+const vec3 u_coefficients = vec3(-0.168736, -0.331264, 0.5) * (224.0 / 255.0);
+const vec3 v_coefficients = vec3(0.5, -0.418688, -0.081312) * (224.0 / 255.0);
+
+void main() {
+    ivec2 position = ivec2(gl_FragCoord.xy);
+    if (position.y < frame_size.y) {
+        vec3 rgb = texelFetch(color_texture, position, 0).rgb;
+        color = dot(rgb, y_coefficients) + 16.0 / 255.0;
+        return;
+    }
+
+    // Every row of the chroma planes holds two of their rows
+    int chroma_width = frame_size.x / 2;
+    int plane_size = chroma_width * (frame_size.y / 2);
+    int index = (position.y - frame_size.y) * frame_size.x + position.x;
+    int plane = index / plane_size;
+    index -= plane * plane_size;
+    ivec2 source = ivec2(index % chroma_width, index / chroma_width) * 2;
+    vec3 rgb = (texelFetch(color_texture, source, 0).rgb +
+                texelFetch(color_texture, source + ivec2(1, 0), 0).rgb +
+                texelFetch(color_texture, source + ivec2(0, 1), 0).rgb +
+                texelFetch(color_texture, source + ivec2(1, 1), 0).rgb) * 0.25;
+    color = dot(rgb, plane == 0 ? u_coefficients : v_coefficients) + 128.0 / 255.0;
+}
+)";
+
 FrameDumperOpenGL::FrameDumperOpenGL(VideoDumper::Backend& video_dumper_,
                                      Frontend::EmuWindow& emu_window)
     : video_dumper(video_dumper_), context(emu_window.CreateSharedContext()) {}
@@ -43,6 +91,7 @@ void FrameDumperOpenGL::PresentLoop() {
     InitializeOpenGLObjects();
 
     const auto& layout = GetLayout();
+    const bool convert = format == VideoDumper::VideoFrameFormat::YUV420P;
     while (!stop_requested.exchange(false)) {
         auto frame = mailbox->TryGetPresentFrame(200);
         if (!frame) {
@@ -55,9 +104,16 @@ void FrameDumperOpenGL::PresentLoop() {
         }
         glWaitSync(frame->render_fence, 0, GL_TIMEOUT_IGNORED);
 
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, frame->present.handle);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[current_pbo].handle);
-        glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+        if (convert) {
+            // Only read back the converted planes, which are less than half the size
+            ConvertFrame(*frame);
+            glReadPixels(0, 0, layout.width, layout.height * 3 / 2, GL_RED, GL_UNSIGNED_BYTE, 0);
+        } else {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, frame->present.handle);
+            glReadPixels(0, 0, layout.width, layout.height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                         0);
+        }
 
         // Insert fence for the main thread to block on
         frame->present_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
@@ -66,7 +122,7 @@ void FrameDumperOpenGL::PresentLoop() {
         // Bind the previous PBO and read the pixels
         glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[next_pbo].handle);
         GLubyte* pixels = static_cast<GLubyte*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
-        VideoDumper::VideoFrame frame_data{layout.width, layout.height, pixels};
+        VideoDumper::VideoFrame frame_data{layout.width, layout.height, pixels, format};
         video_dumper.AddVideoFrame(std::move(frame_data));
         glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
@@ -78,21 +134,88 @@ void FrameDumperOpenGL::PresentLoop() {
     CleanupOpenGLObjects();
 }
 
+void FrameDumperOpenGL::ConvertFrame(const Frontend::Frame& frame) {
+    const auto& layout = GetLayout();
+    const auto width = static_cast<GLint>(layout.width);
+    const auto height = static_cast<GLint>(layout.height);
+
+    // The shader can't sample the renderbuffer of the frame, so copy it to a texture first
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, frame.present.handle);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, color_framebuffer.handle);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, yuv_framebuffer.handle);
+    glViewport(0, 0, width, height * 3 / 2);
+    glUseProgram(yuv_program.handle);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, color_texture.handle);
+    glBindVertexArray(vertex_array.handle);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, yuv_framebuffer.handle);
+}
+
 void FrameDumperOpenGL::InitializeOpenGLObjects() {
     const auto& layout = GetLayout();
+    format = video_dumper.GetVideoFrameFormat();
     for (auto& buffer : pbos) {
         buffer.Create();
         glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
-        glBufferData(GL_PIXEL_PACK_BUFFER, layout.width * layout.height * 4, nullptr,
-                     GL_STREAM_READ);
+        glBufferData(GL_PIXEL_PACK_BUFFER,
+                     VideoDumper::VideoFrame::GetSize(layout.width, layout.height, format),
+                     nullptr, GL_STREAM_READ);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     }
+
+    if (format != VideoDumper::VideoFrameFormat::YUV420P) {
+        return;
+    }
+
+    const auto width = static_cast<GLsizei>(layout.width);
+    const auto height = static_cast<GLsizei>(layout.height);
+    color_texture.Create();
+    glBindTexture(GL_TEXTURE_2D, color_texture.handle);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    color_framebuffer.Create();
+    glBindFramebuffer(GL_FRAMEBUFFER, color_framebuffer.handle);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           color_texture.handle, 0);
+
+    yuv_texture.Create();
+    glBindTexture(GL_TEXTURE_2D, yuv_texture.handle);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, width, height * 3 / 2);
+    yuv_framebuffer.Create();
+    glBindFramebuffer(GL_FRAMEBUFFER, yuv_framebuffer.handle);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, yuv_texture.handle,
+                           0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    std::string fragment_shader;
+    if (GLES) {
+        fragment_shader += fragment_shader_precision_OES;
+    }
+    fragment_shader += yuv_fragment_shader;
+    yuv_program.Create(yuv_vertex_shader, fragment_shader.c_str());
+    glUseProgram(yuv_program.handle);
+    glUniform1i(glGetUniformLocation(yuv_program.handle, "color_texture"), 0);
+    glUniform2i(glGetUniformLocation(yuv_program.handle, "frame_size"), width, height);
+    vertex_array.Create();
+
+    // The rows of the planes are tightly packed
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
 }
 
 void FrameDumperOpenGL::CleanupOpenGLObjects() {
     for (auto& buffer : pbos) {
         buffer.Release();
     }
+    yuv_program.Release();
+    vertex_array.Release();
+    yuv_framebuffer.Release();
+    yuv_texture.Release();
+    color_framebuffer.Release();
+    color_texture.Release();
 }
 
 } // namespace OpenGL
@@ -43,6 +43,9 @@ private:
     void CleanupOpenGLObjects();
     void PresentLoop();
 
+    /// Converts the frame to YUV420P and leaves the result bound as the read framebuffer
+    void ConvertFrame(const Frontend::Frame& frame);
+
     VideoDumper::Backend& video_dumper;
     std::unique_ptr<Frontend::GraphicsContext> context;
     std::thread present_thread;
@@ -52,6 +55,15 @@ private:
     std::array<OGLBuffer, 2> pbos;
     GLuint current_pbo = 1;
     GLuint next_pbo = 0;
+
+    // Objects used to convert the frames on the GPU, when the backend requests YUV420P frames
+    VideoDumper::VideoFrameFormat format{};
+    OGLTexture color_texture;
+    OGLFramebuffer color_framebuffer;
+    OGLTexture yuv_texture;
+    OGLFramebuffer yuv_framebuffer;
+    OGLProgram yuv_program;
+    OGLVertexArray vertex_array;
 };
 
 } // namespace OpenGL
@@ -64,7 +64,7 @@ void main() {
         return PixelFormat::RGBA4;
     }
 
-    void Reinterpret(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect,
+    void Reinterpret(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect, u64 src_tick,
                      const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect) override {
         OpenGLState prev_state = OpenGLState::GetCurState();
         SCOPE_EXIT({ prev_state.Apply(); });
@@ -174,7 +174,7 @@ void main() {
         return PixelFormat::D24S8;
     }
 
-    void Reinterpret(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect,
+    void Reinterpret(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect, u64 src_tick,
                      const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect) override {
         OpenGLState prev_state = OpenGLState::GetCurState();
         SCOPE_EXIT({ prev_state.Apply(); });
@@ -182,13 +182,21 @@ void main() {
         OpenGLState state;
         state.texture_units[0].texture_2d = src_tex.handle;
 
+        // A surface is often reinterpreted several times between writes, e.g. an invalid
+        // interval at a time or into several surfaces, which can reuse the view or the copy.
+        // The tick changes when a recycled texture handle is written by another surface.
+        const bool same_source =
+            src_tick != 0 && src_tex.handle == temp_source && src_tick == temp_tick;
         if (use_texture_view) {
-            temp_tex.Create();
-            glActiveTexture(GL_TEXTURE1);
-            glTextureView(temp_tex.handle, GL_TEXTURE_2D, src_tex.handle, GL_DEPTH24_STENCIL8, 0, 1,
-                          0, 1);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            if (!same_source) {
+                temp_tex.Release();
+                temp_tex.Create();
+                glActiveTexture(GL_TEXTURE1);
+                glTextureView(temp_tex.handle, GL_TEXTURE_2D, src_tex.handle, GL_DEPTH24_STENCIL8,
+                              0, 1, 0, 1);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            }
         } else if (src_rect.top > temp_rect.top || src_rect.right > temp_rect.right) {
             temp_tex.Release();
             temp_tex.Create();
@@ -199,6 +207,7 @@ void main() {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
             temp_rect = src_rect;
+            copied_rect = {};
         }
 
         state.texture_units[1].texture_2d = temp_tex.handle;
@@ -211,11 +220,18 @@ void main() {
         state.Apply();
 
         glActiveTexture(GL_TEXTURE1);
-        if (!use_texture_view) {
+        const bool copied =
+            same_source && src_rect.left >= copied_rect.left &&
+            src_rect.right <= copied_rect.right && src_rect.bottom >= copied_rect.bottom &&
+            src_rect.top <= copied_rect.top;
+        if (!use_texture_view && !copied) {
             glCopyImageSubData(src_tex.handle, GL_TEXTURE_2D, 0, src_rect.left, src_rect.bottom, 0,
                                temp_tex.handle, GL_TEXTURE_2D, 0, src_rect.left, src_rect.bottom, 0,
                                src_rect.GetWidth(), src_rect.GetHeight(), 1);
+            copied_rect = src_rect;
         }
+        temp_source = src_tex.handle;
+        temp_tick = src_tick;
         glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_STENCIL_INDEX);
 
         glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
@@ -227,10 +243,6 @@ void main() {
         glUniform2i(src_size_loc, src_rect.GetWidth(), src_rect.GetHeight());
         glUniform2i(src_offset_loc, src_rect.left, src_rect.bottom);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-        if (use_texture_view) {
-            temp_tex.Release();
-        }
     }
 
 private:
@@ -240,6 +252,11 @@ private:
     OGLVertexArray vao{};
     OGLTexture temp_tex{};
     Common::Rectangle<u32> temp_rect{0, 0, 0, 0};
+    /// The source texture and tick the view or the copy in temp_tex was made of
+    GLuint temp_source{};
+    u64 temp_tick{};
+    /// The rect of the source that was copied to temp_tex last
+    Common::Rectangle<u32> copied_rect{0, 0, 0, 0};
 };
 
 FormatReinterpreterOpenGL::FormatReinterpreterOpenGL() {
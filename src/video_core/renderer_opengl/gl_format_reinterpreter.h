@@ -23,8 +23,15 @@ public:
     virtual ~FormatReinterpreterBase() = default;
 
     virtual PixelFormat GetSourceFormat() const = 0;
+
+    /**
+     * Converts the source rect to the format of the destination.
+     * @param src_tick the modification tick of the source surface. State derived from the source
+     *                 texture, e.g. a copy of it, can be reused while it's the same.
+     */
     virtual void Reinterpret(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect,
-                             const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect) = 0;
+                             u64 src_tick, const OGLTexture& dst_tex,
+                             Common::Rectangle<u32> dst_rect) = 0;
 
 protected:
     OGLFramebuffer read_fbo;
@@ -0,0 +1,77 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <utility>
+#include "common/trace.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
+
+namespace OpenGL {
+
+namespace {
+constexpr Common::Trace::Category GPUFrame{"GPU", "Frame"};
+} // Anonymous namespace
+
+GPUTimer::~GPUTimer() {
+    if (track != nullptr) {
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    }
+}
+
+void GPUTimer::Create() {
+    // GLES only has timestamps through an extension, which few drivers expose
+    if (!GLAD_GL_VERSION_3_3) {
+        return;
+    }
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    static Common::Trace::Track& gpu_track = Common::Trace::CreateTrack("GPU");
+    track = &gpu_track;
+    Calibrate();
+}
+
+void GPUTimer::EndFrame() {
+    if (track == nullptr) {
+        return;
+    }
+    ReadResults();
+    if (++frames_since_calibration >= CalibrationInterval) {
+        Calibrate();
+    }
+    if (issued - read == NumQueries) {
+        // The GPU is that far behind, the frame is dropped rather than waited for
+        dropped = true;
+        return;
+    }
+    glQueryCounter(queries[issued % NumQueries], GL_TIMESTAMP);
+    after_drop[issued % NumQueries] = std::exchange(dropped, false);
+    issued++;
+}
+
+void GPUTimer::Calibrate() {
+    GLint64 gpu_time = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+    clock_offset = static_cast<s64>(Common::Trace::Now()) - static_cast<s64>(gpu_time);
+    frames_since_calibration = 0;
+}
+
+void GPUTimer::ReadResults() {
+    while (read != issued) {
+        const std::size_t slot = read % NumQueries;
+        const GLuint query = queries[slot];
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            return;
+        }
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &timestamp);
+        read++;
+        if (!after_drop[slot] && timestamp > last_timestamp) {
+            track->Record(GPUFrame, static_cast<u64>(last_timestamp + clock_offset),
+                          static_cast<u64>(timestamp + clock_offset));
+        }
+        last_timestamp = timestamp;
+    }
+}
+
+} // namespace OpenGL
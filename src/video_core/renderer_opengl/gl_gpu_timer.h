@@ -0,0 +1,58 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+#include "common/common_types.h"
+
+namespace Common::Trace {
+class Track;
+}
+
+namespace OpenGL {
+
+/**
+ * Measures the time the host GPU spends per frame with timestamp queries, and records it on the
+ * "GPU" track of the trace. The results are only read once the GPU has them, it never stalls.
+ */
+class GPUTimer {
+public:
+    GPUTimer() = default;
+    ~GPUTimer();
+
+    GPUTimer(const GPUTimer&) = delete;
+    GPUTimer& operator=(const GPUTimer&) = delete;
+
+    /// Creates the queries, does nothing if the driver has no timestamp queries
+    void Create();
+
+    /// Marks the end of a frame in the command stream
+    void EndFrame();
+
+private:
+    static constexpr std::size_t NumQueries = 8;
+    /// Frames after which the offset to the trace clock is measured again, as the clocks drift
+    static constexpr u32 CalibrationInterval = 600;
+
+    void Calibrate();
+    void ReadResults();
+
+    Common::Trace::Track* track = nullptr;
+    std::array<GLuint, NumQueries> queries{};
+    /// Whether frames were dropped right before the timestamp
+    std::array<bool, NumQueries> after_drop{};
+    /// Number of timestamps queried and of those read back
+    u64 issued = 0;
+    u64 read = 0;
+    bool dropped = true;
+    /// The last timestamp read back, in GPU time
+    u64 last_timestamp = 0;
+    /// Difference of the trace clock to the GPU clock
+    s64 clock_offset = 0;
+    u32 frames_since_calibration = 0;
+};
+
+} // namespace OpenGL
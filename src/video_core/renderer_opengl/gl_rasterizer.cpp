@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <optional>
+#include <utility>
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/microprofile.h"
@@ -23,6 +27,7 @@ MICROPROFILE_DEFINE(OpenGL_VAO, "OpenGL", "Vertex Array Setup", MP_RGB(255, 128,
 MICROPROFILE_DEFINE(OpenGL_VS, "OpenGL", "Vertex Shader Setup", MP_RGB(192, 128, 128));
 MICROPROFILE_DEFINE(OpenGL_GS, "OpenGL", "Geometry Shader Setup", MP_RGB(128, 192, 128));
 MICROPROFILE_DEFINE(OpenGL_Drawing, "OpenGL", "Drawing", MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(OpenGL_DrawBatch, "OpenGL", "Draw Batch Submission", MP_RGB(128, 128, 224));
 MICROPROFILE_DEFINE(OpenGL_Blits, "OpenGL", "Blits", MP_RGB(100, 100, 255));
 MICROPROFILE_DEFINE(OpenGL_CacheManagement, "OpenGL", "Cache Mgmt", MP_RGB(100, 255, 100));
 
@@ -55,16 +60,6 @@ RasterizerOpenGL::RasterizerOpenGL(Frontend::EmuWindow& emu_window)
     u8 framebuffer_data[4] = {0, 0, 0, 1};
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer_data);
 
-    // Create sampler objects
-    for (std::size_t i = 0; i < texture_samplers.size(); ++i) {
-        texture_samplers[i].Create();
-        state.texture_units[i].sampler = texture_samplers[i].sampler.handle;
-    }
-
-    // Create cubemap texture and sampler objects
-    texture_cube_sampler.Create();
-    state.texture_cube_unit.sampler = texture_cube_sampler.sampler.handle;
-
     // Generate VAO
     sw_vao.Create();
     hw_vao.Create();
@@ -85,6 +80,8 @@ RasterizerOpenGL::RasterizerOpenGL(Frontend::EmuWindow& emu_window)
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_alignment);
     uniform_size_aligned_vs =
         Common::AlignUp<std::size_t>(sizeof(VSUniformData), uniform_buffer_alignment);
+    uniform_size_aligned_gs =
+        Common::AlignUp<std::size_t>(sizeof(GSUniformData), uniform_buffer_alignment);
     uniform_size_aligned_fs =
         Common::AlignUp<std::size_t>(sizeof(UniformData), uniform_buffer_alignment);
 
@@ -164,7 +161,10 @@ RasterizerOpenGL::RasterizerOpenGL(Frontend::EmuWindow& emu_window)
     RasterizerOpenGL::SyncEntireState();
 }
 
-RasterizerOpenGL::~RasterizerOpenGL() = default;
+RasterizerOpenGL::~RasterizerOpenGL() {
+    LOG_INFO(Render_OpenGL, "Merged {} of {} accelerated draws into draw batches", merged_draws,
+             accelerated_draws);
+}
 
 void RasterizerOpenGL::LoadDiskResources(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
@@ -172,6 +172,8 @@ void RasterizerOpenGL::LoadDiskResources(const std::atomic_bool& stop_loading,
 }
 
 void RasterizerOpenGL::SyncEntireState() {
+    SubmitBatchedDraws();
+
     // Sync fixed function OpenGL state
     SyncClipEnabled();
     SyncCullMode();
@@ -211,6 +213,27 @@ void RasterizerOpenGL::SyncEntireState() {
     SyncProcTexBias();
     SyncShadowBias();
     SyncShadowTextureBias();
+
+    dirty_flags = 0;
+    vs_uniforms_dirty = true;
+    gs_uniforms_dirty = true;
+}
+
+VideoCore::RasterizerStatistics RasterizerOpenGL::GetStatistics() const {
+    const SurfaceCacheStats& cache_stats = res_cache.GetStats();
+    VideoCore::RasterizerStatistics statistics;
+    statistics.draws = draws;
+    statistics.surface_hits = cache_stats.hits;
+    statistics.surface_misses = cache_stats.misses;
+    statistics.readback_bytes = cache_stats.readback_bytes;
+    statistics.shaders = shader_program_manager->GetShaderCount();
+    const OpenGLState::Statistics state_stats = OpenGLState::GetStatistics();
+    statistics.state_changes = state_stats.changed_blocks;
+    statistics.state_unchanged = state_stats.unchanged_blocks;
+    const auto& arena_stats = res_cache.frame_arena.GetStatistics();
+    statistics.frame_bytes = arena_stats.total_bytes;
+    statistics.frame_peak_bytes = std::max(arena_stats.peak_bytes, arena_stats.bytes);
+    return statistics;
 }
 
 /**
@@ -238,14 +261,66 @@ static bool AreQuaternionsOpposite(Common::Vec4<Pica::float24> qa, Common::Vec4<
     return (Common::Dot(a, b) < 0.f);
 }
 
+/**
+ * Returns whether the triangle can't cover any pixel, because two of its vertices are the same,
+ * as in the degenerate triangles that join strips, or because it's outside of one side of the
+ * view volume.
+ */
+static bool IsTriangleInvisible(const Pica::Shader::OutputVertex& v0,
+                                const Pica::Shader::OutputVertex& v1,
+                                const Pica::Shader::OutputVertex& v2) {
+    if (v0.pos == v1.pos || v1.pos == v2.pos || v0.pos == v2.pos) {
+        return true;
+    }
+    const auto IsOutside = [&](auto&& outside) {
+        return outside(v0.pos) && outside(v1.pos) && outside(v2.pos);
+    };
+    return IsOutside([](const auto& pos) { return pos.x > pos.w; }) ||
+           IsOutside([](const auto& pos) { return pos.x < -pos.w; }) ||
+           IsOutside([](const auto& pos) { return pos.y > pos.w; }) ||
+           IsOutside([](const auto& pos) { return pos.y < -pos.w; });
+}
+
 void RasterizerOpenGL::AddTriangle(const Pica::Shader::OutputVertex& v0,
                                    const Pica::Shader::OutputVertex& v1,
                                    const Pica::Shader::OutputVertex& v2) {
+    if (IsTriangleInvisible(v0, v1, v2)) {
+        return;
+    }
     vertex_batch.emplace_back(v0, false);
     vertex_batch.emplace_back(v1, AreQuaternionsOpposite(v0.quat, v1.quat));
     vertex_batch.emplace_back(v2, AreQuaternionsOpposite(v0.quat, v2.quat));
 }
 
+bool RasterizerOpenGL::LoadShadedVertices(u64 key) {
+    const auto it = shaded_vertices.find(key);
+    if (it == shaded_vertices.end()) {
+        shaded_vertices_start = vertex_batch.size();
+        return false;
+    }
+    vertex_batch.insert(vertex_batch.end(), it->second.begin(), it->second.end());
+    return true;
+}
+
+void RasterizerOpenGL::StoreShadedVertices(u64 key) {
+    // About 22 MiB of vertices, the cache starts over when it's full. Geometry that is still
+    // drawn every frame is stored again in the next frame.
+    constexpr std::size_t MaxShadedVertices = 256 * 1024;
+
+    const std::size_t count = vertex_batch.size() - shaded_vertices_start;
+    if (count > MaxShadedVertices) {
+        return;
+    }
+    if (num_shaded_vertices + count > MaxShadedVertices) {
+        shaded_vertices.clear();
+        num_shaded_vertices = 0;
+    }
+    shaded_vertices.emplace(key, std::vector<HardwareVertex>(
+                                     vertex_batch.begin() + shaded_vertices_start,
+                                     vertex_batch.end()));
+    num_shaded_vertices += count;
+}
+
 static constexpr std::array<GLenum, 4> vs_attrib_types{
     GL_BYTE,          // VertexAttributeFormat::BYTE
     GL_UNSIGNED_BYTE, // VertexAttributeFormat::UBYTE
@@ -297,12 +372,23 @@ RasterizerOpenGL::VertexArrayInfo RasterizerOpenGL::AnalyzeVertexArray(bool is_i
     return {vertex_min, vertex_max, vs_input_size};
 }
 
+RasterizerOpenGL::LoaderAddresses RasterizerOpenGL::GetLoaderAddresses() const {
+    const auto& vertex_attributes = Pica::g_state.regs.pipeline.vertex_attributes;
+    const PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
+
+    LoaderAddresses addresses;
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        addresses[i] = base_address + vertex_attributes.attribute_loaders[i].data_offset;
+    }
+    return addresses;
+}
+
 void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
-                                        GLuint vs_input_index_min, GLuint vs_input_index_max) {
+                                        GLuint vs_input_index_min, GLuint vs_input_index_max,
+                                        const LoaderAddresses& loader_addresses) {
     MICROPROFILE_SCOPE(OpenGL_VAO);
     const auto& regs = Pica::g_state.regs;
     const auto& vertex_attributes = regs.pipeline.vertex_attributes;
-    PAddr base_address = vertex_attributes.GetPhysicalBaseAddress();
 
     state.draw.vertex_array = hw_vao.handle;
     state.draw.vertex_buffer = vertex_buffer.GetHandle();
@@ -310,7 +396,8 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
 
     std::array<bool, 16> enable_attributes{};
 
-    for (const auto& loader : vertex_attributes.attribute_loaders) {
+    for (std::size_t loader_index = 0; loader_index < loader_addresses.size(); ++loader_index) {
+        const auto& loader = vertex_attributes.attribute_loaders[loader_index];
         if (loader.component_count == 0 || loader.byte_count == 0) {
             continue;
         }
@@ -342,8 +429,7 @@ void RasterizerOpenGL::SetupVertexArray(u8* array_ptr, GLintptr buffer_offset,
             }
         }
 
-        PAddr data_addr =
-            base_address + loader.data_offset + (vs_input_index_min * loader.byte_count);
+        PAddr data_addr = loader_addresses[loader_index] + (vs_input_index_min * loader.byte_count);
 
         u32 vertex_num = vs_input_index_max - vs_input_index_min + 1;
         u32 data_size = loader.byte_count * vertex_num;
@@ -387,8 +473,7 @@ bool RasterizerOpenGL::SetupGeometryShader() {
     const auto& regs = Pica::g_state.regs;
 
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
-        LOG_ERROR(Render_OpenGL, "Accelerate draw doesn't support geometry shader");
-        return false;
+        return shader_program_manager->UseProgrammableGeometryShader(regs, Pica::g_state.gs);
     }
 
     shader_program_manager->UseFixedGeometryShader(regs);
@@ -397,6 +482,17 @@ bool RasterizerOpenGL::SetupGeometryShader() {
 
 bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
     const auto& regs = Pica::g_state.regs;
+    ++accelerated_draws;
+
+    if (!draw_batch.counts.empty()) {
+        if (is_indexed && AppendToDrawBatch()) {
+            ++merged_draws;
+            ++draws;
+            return true;
+        }
+        SubmitBatchedDraws();
+    }
+
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
         if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
             return false;
@@ -412,11 +508,36 @@ bool RasterizerOpenGL::AccelerateDrawBatch(bool is_indexed) {
     if (!SetupGeometryShader())
         return false;
 
-    return Draw(true, is_indexed);
+    if (!Draw(true, is_indexed))
+        return false;
+
+    if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
+        // The draw sets the uniform b15, which the next draw has to observe
+        gs_uniforms_dirty = true;
+    }
+    ++draws;
+    return true;
 }
 
 static GLenum GetCurrentPrimitiveMode() {
     const auto& regs = Pica::g_state.regs;
+    if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
+        // Each geometry shader invocation reads the outputs of a fixed number of vertices
+        const u32 vs_outputs = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+        switch ((regs.gs.max_input_attribute_index + 1) / vs_outputs) {
+        case 1:
+            return GL_POINTS;
+        case 2:
+            return GL_LINES;
+        case 4:
+            return GL_LINES_ADJACENCY;
+        case 6:
+            return GL_TRIANGLES_ADJACENCY;
+        default:
+            return GL_TRIANGLES;
+        }
+    }
+
     switch (regs.pipeline.triangle_topology) {
     case Pica::PipelineRegs::TriangleTopology::Shader:
     case Pica::PipelineRegs::TriangleTopology::List:
@@ -432,7 +553,167 @@ static GLenum GetCurrentPrimitiveMode() {
     return GL_TRIANGLES;
 }
 
-bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
+/// Registers that only select the vertex and index data of a draw, they may change between the
+/// draws of a batch. The primitive topology is compared when a draw is appended.
+static bool IsDrawBatchRegister(u32 id) {
+    constexpr u32 loaders_begin =
+        PICA_REG_INDEX(pipeline.vertex_attributes.attribute_loaders[0].data_offset);
+    constexpr u32 loader_words =
+        PICA_REG_INDEX(pipeline.vertex_attributes.attribute_loaders[1].data_offset) -
+        loaders_begin;
+    constexpr u32 loaders_end = loaders_begin + 12 * loader_words;
+    if (id >= loaders_begin && id < loaders_end) {
+        return (id - loaders_begin) % loader_words == 0;
+    }
+
+    switch (id) {
+    case PICA_REG_INDEX(pipeline.vertex_attributes.base_address):
+    case PICA_REG_INDEX(pipeline.index_array):
+    case PICA_REG_INDEX(pipeline.num_vertices):
+    case PICA_REG_INDEX(pipeline.vertex_offset):
+    case PICA_REG_INDEX(pipeline.trigger_draw):
+    case PICA_REG_INDEX(pipeline.trigger_draw_indexed):
+    case PICA_REG_INDEX(pipeline.gpu_mode):
+    case PICA_REG_INDEX(pipeline.triangle_topology):
+    case PICA_REG_INDEX(pipeline.restart_primitive):
+        return true;
+    default:
+        return false;
+    }
+}
+
+void RasterizerOpenGL::NotifyPicaRegisterChanging(u32 id) {
+    if (!draw_batch.counts.empty() && !IsDrawBatchRegister(id)) {
+        SubmitBatchedDraws();
+    }
+}
+
+bool RasterizerOpenGL::AppendToDrawBatch() {
+    const auto& regs = Pica::g_state.regs;
+    const auto& vertex_attributes = regs.pipeline.vertex_attributes;
+    const bool index_u16 = regs.pipeline.index_array.format != 0;
+    if (GetCurrentPrimitiveMode() != draw_batch.primitive_mode ||
+        index_u16 != draw_batch.index_u16 || regs.pipeline.num_vertices == 0) {
+        return false;
+    }
+
+    // The vertex data of every loader must be reachable from the attribute pointers of the first
+    // draw by offsetting the indices with the same base vertex
+    const LoaderAddresses loader_addresses = GetLoaderAddresses();
+    std::optional<s64> base_vertex;
+    u32 vertex_size = 0;
+    for (std::size_t i = 0; i < loader_addresses.size(); ++i) {
+        const auto& loader = vertex_attributes.attribute_loaders[i];
+        if (loader.component_count == 0 || loader.byte_count == 0) {
+            continue;
+        }
+
+        const s64 delta = static_cast<s64>(loader_addresses[i]) -
+                          static_cast<s64>(draw_batch.loader_addresses[i]);
+        if (delta % loader.byte_count != 0 ||
+            (base_vertex && *base_vertex != delta / loader.byte_count)) {
+            return false;
+        }
+        base_vertex = delta / loader.byte_count;
+        vertex_size += loader.byte_count;
+    }
+
+    const std::size_t index_size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
+    const std::size_t index_offset = Common::AlignUp(draw_batch.indices.size(), 4);
+    if (index_offset + index_size > INDEX_BUFFER_SIZE) {
+        return false;
+    }
+
+    const auto [index_min, index_max, vs_input_size] = AnalyzeVertexArray(true);
+    const s64 vertex_min = static_cast<s64>(index_min) + base_vertex.value_or(0);
+    const s64 vertex_max = static_cast<s64>(index_max) + base_vertex.value_or(0);
+    if (vertex_min < 0) {
+        return false;
+    }
+
+    const u32 batch_min = std::min(draw_batch.vertex_min, static_cast<u32>(vertex_min));
+    const u32 batch_max = std::max(draw_batch.vertex_max, static_cast<u32>(vertex_max));
+    if (static_cast<u64>(batch_max - batch_min + 1) * vertex_size > VERTEX_BUFFER_SIZE) {
+        return false;
+    }
+
+    const u8* index_data = VideoCore::g_memory->GetPhysicalPointer(
+        vertex_attributes.GetPhysicalBaseAddress() + regs.pipeline.index_array.offset);
+    draw_batch.indices.resize(index_offset + index_size);
+    std::memcpy(draw_batch.indices.data() + index_offset, index_data, index_size);
+
+    draw_batch.vertex_min = batch_min;
+    draw_batch.vertex_max = batch_max;
+    draw_batch.counts.push_back(static_cast<GLsizei>(regs.pipeline.num_vertices));
+    draw_batch.index_offsets.push_back(static_cast<GLintptr>(index_offset));
+    draw_batch.base_vertices.push_back(static_cast<GLint>(base_vertex.value_or(0)));
+    return true;
+}
+
+void RasterizerOpenGL::SubmitBatchedDraws() {
+    if (draw_batch.counts.empty()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(OpenGL_DrawBatch);
+    const auto& vertex_attributes = Pica::g_state.regs.pipeline.vertex_attributes;
+
+    u32 vertex_size = 0;
+    for (const auto& loader : vertex_attributes.attribute_loaders) {
+        if (loader.component_count != 0) {
+            vertex_size += loader.byte_count;
+        }
+    }
+    const u32 vs_input_size = (draw_batch.vertex_max - draw_batch.vertex_min + 1) * vertex_size;
+
+    state.draw.vertex_buffer = vertex_buffer.GetHandle();
+    state.Apply();
+
+    // All the draws share one upload of the vertex range they reference
+    u8* buffer_ptr;
+    GLintptr buffer_offset;
+    std::tie(buffer_ptr, buffer_offset, std::ignore) = vertex_buffer.Map(vs_input_size, 4);
+    SetupVertexArray(buffer_ptr, buffer_offset, draw_batch.vertex_min, draw_batch.vertex_max,
+                     draw_batch.loader_addresses);
+    vertex_buffer.Unmap(vs_input_size);
+
+    const std::size_t index_size = draw_batch.indices.size();
+    std::tie(buffer_ptr, buffer_offset, std::ignore) = index_buffer.Map(index_size, 4);
+    std::memcpy(buffer_ptr, draw_batch.indices.data(), index_size);
+    index_buffer.Unmap(index_size);
+
+    const std::size_t num_draws = draw_batch.counts.size();
+    const auto index_pointers = res_cache.frame_arena.AllocateArray<const void*>(num_draws);
+    const auto base_vertices = res_cache.frame_arena.AllocateArray<GLint>(num_draws);
+    for (std::size_t i = 0; i < num_draws; ++i) {
+        index_pointers[i] =
+            reinterpret_cast<const void*>(buffer_offset + draw_batch.index_offsets[i]);
+        base_vertices[i] =
+            draw_batch.base_vertices[i] - static_cast<GLint>(draw_batch.vertex_min);
+    }
+
+    const GLenum index_type = draw_batch.index_u16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+    if (num_draws > 1 && glMultiDrawElementsBaseVertex) {
+        glMultiDrawElementsBaseVertex(draw_batch.primitive_mode, draw_batch.counts.data(),
+                                      index_type, index_pointers.data(),
+                                      static_cast<GLsizei>(num_draws), base_vertices.data());
+    } else {
+        // GLES has no multi-draw, the draws still share the vertex and index uploads
+        for (std::size_t i = 0; i < num_draws; ++i) {
+            glDrawElementsBaseVertex(draw_batch.primitive_mode, draw_batch.counts[i], index_type,
+                                     index_pointers[i], base_vertices[i]);
+        }
+    }
+
+    draw_batch.indices.clear();
+    draw_batch.counts.clear();
+    draw_batch.index_offsets.clear();
+    draw_batch.base_vertices.clear();
+
+    ResetTextureUnits();
+}
+
+bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed, bool allow_batching) {
     const auto& regs = Pica::g_state.regs;
     GLenum primitive_mode = GetCurrentPrimitiveMode();
 
@@ -443,22 +724,43 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
         return false;
     }
 
+    const bool index_u16 = regs.pipeline.index_array.format != 0;
+    const std::size_t index_buffer_size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
+    if (is_indexed && allow_batching && regs.pipeline.num_vertices != 0 &&
+        index_buffer_size <= INDEX_BUFFER_SIZE) {
+        // Defer the draw so that following draws with the same state can be merged into it
+        const u8* index_data = VideoCore::g_memory->GetPhysicalPointer(
+            regs.pipeline.vertex_attributes.GetPhysicalBaseAddress() +
+            regs.pipeline.index_array.offset);
+        draw_batch.loader_addresses = GetLoaderAddresses();
+        draw_batch.primitive_mode = primitive_mode;
+        draw_batch.index_u16 = index_u16;
+        draw_batch.vertex_min = vs_input_index_min;
+        draw_batch.vertex_max = vs_input_index_max;
+        draw_batch.indices.assign(index_data, index_data + index_buffer_size);
+        draw_batch.counts.push_back(static_cast<GLsizei>(regs.pipeline.num_vertices));
+        draw_batch.index_offsets.push_back(0);
+        draw_batch.base_vertices.push_back(0);
+
+        shader_program_manager->ApplyTo(state);
+        state.Apply();
+        return true;
+    }
+
     state.draw.vertex_buffer = vertex_buffer.GetHandle();
     state.Apply();
 
     u8* buffer_ptr;
     GLintptr buffer_offset;
     std::tie(buffer_ptr, buffer_offset, std::ignore) = vertex_buffer.Map(vs_input_size, 4);
-    SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max);
+    SetupVertexArray(buffer_ptr, buffer_offset, vs_input_index_min, vs_input_index_max,
+                     GetLoaderAddresses());
     vertex_buffer.Unmap(vs_input_size);
 
     shader_program_manager->ApplyTo(state);
     state.Apply();
 
     if (is_indexed) {
-        bool index_u16 = regs.pipeline.index_array.format != 0;
-        std::size_t index_buffer_size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
-
         if (index_buffer_size > INDEX_BUFFER_SIZE) {
             LOG_WARNING(Render_OpenGL, "Too large index input size {}", index_buffer_size);
             return false;
@@ -482,15 +784,19 @@ bool RasterizerOpenGL::AccelerateDrawBatchInternal(bool is_indexed) {
 }
 
 void RasterizerOpenGL::DrawTriangles() {
+    SubmitBatchedDraws();
     if (vertex_batch.empty())
         return;
     Draw(false, false);
+    ++draws;
 }
 
 bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     MICROPROFILE_SCOPE(OpenGL_Drawing);
     const auto& regs = Pica::g_state.regs;
 
+    SyncDirtyState();
+
     bool shadow_rendering = regs.framebuffer.output_merger.fragment_operation_mode ==
                             Pica::FramebufferRegs::FragmentOperationMode::Shadow;
 
@@ -690,7 +996,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
                     state.texture_cube_unit.texture_cube =
                         res_cache.GetTextureCube(config).texture.handle;
 
-                    texture_cube_sampler.SyncWithConfig(texture.config);
+                    state.texture_cube_unit.sampler = GetSampler(texture.config);
                     state.texture_units[texture_index].texture_2d = 0;
                     continue; // Texture unit 0 setup finished. Continue to next unit
                 default:
@@ -700,7 +1006,7 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
                 state.texture_cube_unit.texture_cube = 0;
             }
 
-            texture_samplers[texture_index].SyncWithConfig(texture.config);
+            state.texture_units[texture_index].sampler = GetSampler(texture.config);
             Surface surface = res_cache.GetTextureSurface(texture);
             if (surface != nullptr) {
                 CheckBarrier(state.texture_units[texture_index].texture_2d =
@@ -776,7 +1082,12 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     // Draw the vertex batch
     bool succeeded = true;
     if (accelerate) {
-        succeeded = AccelerateDrawBatchInternal(is_indexed);
+        // Shadow rendering needs a barrier after each draw and a sampled render target is copied
+        // before each draw, neither can be merged with the following draws. Geometry shader draws
+        // update the uniform b15, which is only uploaded once per draw.
+        const bool allow_batching = !shadow_rendering && !need_duplicate_texture &&
+                                    regs.pipeline.use_gs == Pica::PipelineRegs::UseGS::No;
+        succeeded = AccelerateDrawBatchInternal(is_indexed, allow_batching);
     } else {
         state.draw.vertex_array = sw_vao.handle;
         state.draw.vertex_buffer = vertex_buffer.GetHandle();
@@ -803,19 +1114,10 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
 
     vertex_batch.clear();
 
-    // Reset textures in rasterizer state context because the rasterizer cache might delete them
-    for (unsigned texture_index = 0; texture_index < pica_textures.size(); ++texture_index) {
-        state.texture_units[texture_index].texture_2d = 0;
+    // The textures stay bound until the draws batched with this one have been submitted
+    if (draw_batch.counts.empty()) {
+        ResetTextureUnits();
     }
-    state.texture_cube_unit.texture_cube = 0;
-    state.image_shadow_texture_px = 0;
-    state.image_shadow_texture_nx = 0;
-    state.image_shadow_texture_py = 0;
-    state.image_shadow_texture_ny = 0;
-    state.image_shadow_texture_pz = 0;
-    state.image_shadow_texture_nz = 0;
-    state.image_shadow_buffer = 0;
-    state.Apply();
 
     if (shadow_rendering) {
         glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
@@ -831,6 +1133,17 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
         auto interval = color_surface->GetSubRectInterval(draw_rect_unscaled);
         res_cache.InvalidateRegion(boost::icl::first(interval), boost::icl::length(interval),
                                    color_surface);
+
+        if (color_surface != render_pass_surface) {
+            EndRenderPass();
+            render_pass_surface = color_surface;
+            render_pass_rect = draw_rect_unscaled;
+        } else {
+            render_pass_rect.left = std::min(render_pass_rect.left, draw_rect_unscaled.left);
+            render_pass_rect.bottom = std::min(render_pass_rect.bottom, draw_rect_unscaled.bottom);
+            render_pass_rect.right = std::max(render_pass_rect.right, draw_rect_unscaled.right);
+            render_pass_rect.top = std::max(render_pass_rect.top, draw_rect_unscaled.top);
+        }
     }
     if (depth_surface != nullptr && write_depth_fb) {
         auto interval = depth_surface->GetSubRectInterval(draw_rect_unscaled);
@@ -841,64 +1154,202 @@ bool RasterizerOpenGL::Draw(bool accelerate, bool is_indexed) {
     return succeeded;
 }
 
-void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
-    const auto& regs = Pica::g_state.regs;
+void RasterizerOpenGL::ResetTextureUnits() {
+    // Reset textures in rasterizer state context because the rasterizer cache might delete them
+    for (auto& unit : state.texture_units) {
+        unit.texture_2d = 0;
+    }
+    state.texture_cube_unit.texture_cube = 0;
+    state.image_shadow_texture_px = 0;
+    state.image_shadow_texture_nx = 0;
+    state.image_shadow_texture_py = 0;
+    state.image_shadow_texture_ny = 0;
+    state.image_shadow_texture_pz = 0;
+    state.image_shadow_texture_nz = 0;
+    state.image_shadow_buffer = 0;
+    state.Apply();
+}
+
+void RasterizerOpenGL::EndRenderPass() {
+    if (render_pass_surface == nullptr) {
+        return;
+    }
+
+    // Surfaces that were flushed after the previous pass are likely to be read back again, so
+    // start copying them now instead of stalling when the guest reads the memory
+    if (render_pass_surface->registered && render_pass_surface->read_back) {
+        render_pass_surface->QueueDownload(render_pass_rect);
+    }
+    render_pass_surface.reset();
+}
+
+namespace {
+
+/// Groups of OpenGL state derived from the Pica registers. The registers of a group are synced
+/// lazily before the next draw, so a command list that rewrites a block of registers only pays
+/// for the sync once.
+enum DirtyFlags : u64 {
+    DirtyShader = 1ULL << 0,
+    DirtyCullMode = 1ULL << 1,
+    DirtyClipEnable = 1ULL << 2,
+    DirtyClipCoef = 1ULL << 3,
+    DirtyDepthScale = 1ULL << 4,
+    DirtyDepthOffset = 1ULL << 5,
+    DirtyBlendEnable = 1ULL << 6,
+    DirtyBlendFuncs = 1ULL << 7,
+    DirtyBlendColor = 1ULL << 8,
+    DirtyLogicOp = 1ULL << 9,
+    DirtyShadowTextureBias = 1ULL << 10,
+    DirtyFogColor = 1ULL << 11,
+    DirtyProcTexBias = 1ULL << 12,
+    DirtyProcTexNoise = 1ULL << 13,
+    DirtyAlphaTest = 1ULL << 14,
+    DirtyStencilTest = 1ULL << 15,
+    DirtyStencilWriteMask = 1ULL << 16,
+    DirtyDepthTest = 1ULL << 17,
+    DirtyDepthWriteMask = 1ULL << 18,
+    DirtyColorWriteMask = 1ULL << 19,
+    DirtyShadowBias = 1ULL << 20,
+    DirtyCombinerColor = 1ULL << 21,
+    DirtyGlobalAmbient = 1ULL << 22,
+    DirtyTevConstColor = 1ULL << 23, ///< One bit per TEV stage
+    DirtyLight = 1ULL << 29,         ///< One bit per light source
+};
+
+using DirtyFlagTable = std::array<u64, Pica::Regs::NUM_REGS>;
+
+/// Maps every Pica register to the state groups that have to be synced when it is written
+constexpr DirtyFlagTable BuildDirtyFlagTable() {
+    DirtyFlagTable table{};
 
-    switch (id) {
     // Culling
-    case PICA_REG_INDEX(rasterizer.cull_mode):
-        SyncCullMode();
-        break;
+    table[PICA_REG_INDEX(rasterizer.cull_mode)] = DirtyCullMode;
 
     // Clipping plane
-    case PICA_REG_INDEX(rasterizer.clip_enable):
-        SyncClipEnabled();
-        break;
-
-    case PICA_REG_INDEX(rasterizer.clip_coef[0]):
-    case PICA_REG_INDEX(rasterizer.clip_coef[1]):
-    case PICA_REG_INDEX(rasterizer.clip_coef[2]):
-    case PICA_REG_INDEX(rasterizer.clip_coef[3]):
-        SyncClipCoef();
-        break;
+    table[PICA_REG_INDEX(rasterizer.clip_enable)] = DirtyClipEnable;
+    for (u32 i = 0; i < 4; ++i) {
+        table[PICA_REG_INDEX(rasterizer.clip_coef[0]) + i] = DirtyClipCoef;
+    }
 
     // Depth modifiers
-    case PICA_REG_INDEX(rasterizer.viewport_depth_range):
-        SyncDepthScale();
-        break;
-    case PICA_REG_INDEX(rasterizer.viewport_depth_near_plane):
-        SyncDepthOffset();
-        break;
+    table[PICA_REG_INDEX(rasterizer.viewport_depth_range)] = DirtyDepthScale;
+    table[PICA_REG_INDEX(rasterizer.viewport_depth_near_plane)] = DirtyDepthOffset;
 
     // Depth buffering
-    case PICA_REG_INDEX(rasterizer.depthmap_enable):
-        shader_dirty = true;
-        break;
+    table[PICA_REG_INDEX(rasterizer.depthmap_enable)] = DirtyShader;
 
     // Blending
-    case PICA_REG_INDEX(framebuffer.output_merger.alphablend_enable):
-        if (GLES) {
-            // With GLES, we need this in the fragment shader to emulate logic operations
-            shader_dirty = true;
-        }
-        SyncBlendEnabled();
-        break;
-    case PICA_REG_INDEX(framebuffer.output_merger.alpha_blending):
-        SyncBlendFuncs();
-        break;
-    case PICA_REG_INDEX(framebuffer.output_merger.blend_const):
-        SyncBlendColor();
-        break;
+    table[PICA_REG_INDEX(framebuffer.output_merger.alphablend_enable)] = DirtyBlendEnable;
+    table[PICA_REG_INDEX(framebuffer.output_merger.alpha_blending)] = DirtyBlendFuncs;
+    table[PICA_REG_INDEX(framebuffer.output_merger.blend_const)] = DirtyBlendColor;
 
     // Shadow texture
-    case PICA_REG_INDEX(texturing.shadow):
-        SyncShadowTextureBias();
-        break;
+    table[PICA_REG_INDEX(texturing.shadow)] = DirtyShadowTextureBias;
 
     // Fog state
-    case PICA_REG_INDEX(texturing.fog_color):
-        SyncFogColor();
-        break;
+    table[PICA_REG_INDEX(texturing.fog_color)] = DirtyFogColor;
+
+    // ProcTex state
+    table[PICA_REG_INDEX(texturing.proctex)] = DirtyProcTexBias | DirtyShader;
+    table[PICA_REG_INDEX(texturing.proctex_lut)] = DirtyProcTexBias | DirtyShader;
+    table[PICA_REG_INDEX(texturing.proctex_lut_offset)] = DirtyProcTexBias | DirtyShader;
+    table[PICA_REG_INDEX(texturing.proctex_noise_u)] = DirtyProcTexNoise;
+    table[PICA_REG_INDEX(texturing.proctex_noise_v)] = DirtyProcTexNoise;
+    table[PICA_REG_INDEX(texturing.proctex_noise_frequency)] = DirtyProcTexNoise;
+
+    // Alpha test
+    table[PICA_REG_INDEX(framebuffer.output_merger.alpha_test)] = DirtyAlphaTest | DirtyShader;
+
+    // Stencil test + stencil write mask
+    // (Pica stencil test function register also contains a stencil write mask)
+    table[PICA_REG_INDEX(framebuffer.output_merger.stencil_test.raw_func)] =
+        DirtyStencilTest | DirtyStencilWriteMask;
+    table[PICA_REG_INDEX(framebuffer.output_merger.stencil_test.raw_op)] = DirtyStencilTest;
+    table[PICA_REG_INDEX(framebuffer.framebuffer.depth_format)] = DirtyStencilTest;
+
+    // Depth test + depth and color write mask
+    // (Pica depth test function register also contains a depth and color write mask)
+    table[PICA_REG_INDEX(framebuffer.output_merger.depth_test_enable)] =
+        DirtyDepthTest | DirtyDepthWriteMask | DirtyColorWriteMask;
+
+    // Depth and stencil write mask
+    // (This is a dedicated combined depth / stencil write-enable register)
+    table[PICA_REG_INDEX(framebuffer.framebuffer.allow_depth_stencil_write)] =
+        DirtyDepthWriteMask | DirtyStencilWriteMask;
+
+    // Color write mask
+    // (This is a dedicated color write-enable register)
+    table[PICA_REG_INDEX(framebuffer.framebuffer.allow_color_write)] = DirtyColorWriteMask;
+
+    table[PICA_REG_INDEX(framebuffer.shadow)] = DirtyShadowBias;
+
+    // Scissor test
+    table[PICA_REG_INDEX(rasterizer.scissor_test.mode)] = DirtyShader;
+
+    // Logic op
+    table[PICA_REG_INDEX(framebuffer.output_merger.logic_op)] = DirtyLogicOp;
+
+    table[PICA_REG_INDEX(texturing.main_config)] = DirtyShader;
+
+    // Texture 0 type
+    table[PICA_REG_INDEX(texturing.texture0.type)] = DirtyShader;
+
+    // TEV stages
+    // (This also syncs fog_mode and fog_flip which are part of tev_combiner_buffer_input)
+    constexpr std::array<u32, 6> tev_stages = {
+        PICA_REG_INDEX(texturing.tev_stage0), PICA_REG_INDEX(texturing.tev_stage1),
+        PICA_REG_INDEX(texturing.tev_stage2), PICA_REG_INDEX(texturing.tev_stage3),
+        PICA_REG_INDEX(texturing.tev_stage4), PICA_REG_INDEX(texturing.tev_stage5),
+    };
+    constexpr u32 color_source1 = PICA_REG_INDEX(texturing.tev_stage0.color_source1);
+    constexpr u32 color_modifier1 = PICA_REG_INDEX(texturing.tev_stage0.color_modifier1);
+    constexpr u32 color_op = PICA_REG_INDEX(texturing.tev_stage0.color_op);
+    constexpr u32 const_r = PICA_REG_INDEX(texturing.tev_stage0.const_r);
+    constexpr u32 color_scale = PICA_REG_INDEX(texturing.tev_stage0.color_scale);
+    for (u32 stage = 0; stage < tev_stages.size(); ++stage) {
+        const u32 base = tev_stages[stage] - tev_stages[0];
+        table[base + color_source1] = DirtyShader;
+        table[base + color_modifier1] = DirtyShader;
+        table[base + color_op] = DirtyShader;
+        table[base + color_scale] = DirtyShader;
+        table[base + const_r] = DirtyTevConstColor << stage;
+    }
+    table[PICA_REG_INDEX(texturing.tev_combiner_buffer_input)] = DirtyShader;
+
+    // TEV combiner buffer color
+    table[PICA_REG_INDEX(texturing.tev_combiner_buffer_color)] = DirtyCombinerColor;
+
+    // Fragment lighting light sources
+    constexpr u32 light_begin = PICA_REG_INDEX(lighting.light[0]);
+    constexpr u32 light_words = PICA_REG_INDEX(lighting.light[1]) - light_begin;
+    constexpr u32 light_config = PICA_REG_INDEX(lighting.light[0].config);
+    for (u32 light = 0; light < 8; ++light) {
+        const u32 base = light * light_words;
+        for (u32 word = 0; word < light_words; ++word) {
+            table[light_begin + base + word] = DirtyLight << light;
+        }
+        table[base + light_config] = DirtyShader;
+    }
+
+    // Fragment lighting global ambient color (emission + ambient * ambient)
+    table[PICA_REG_INDEX(lighting.global_ambient)] = DirtyGlobalAmbient;
+
+    return table;
+}
+
+constexpr DirtyFlagTable dirty_flag_table = BuildDirtyFlagTable();
+
+} // Anonymous namespace
+
+void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
+    const auto& regs = Pica::g_state.regs;
+
+    dirty_flags |= dirty_flag_table[id];
+
+    // The lookup table and uniform ports consume their data as it is written, so the target of
+    // each write has to be recorded immediately.
+    switch (id) {
+    // Fog state
     case PICA_REG_INDEX(texturing.fog_lut_data[0]):
     case PICA_REG_INDEX(texturing.fog_lut_data[1]):
     case PICA_REG_INDEX(texturing.fog_lut_data[2]):
@@ -911,19 +1362,6 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
         break;
 
     // ProcTex state
-    case PICA_REG_INDEX(texturing.proctex):
-    case PICA_REG_INDEX(texturing.proctex_lut):
-    case PICA_REG_INDEX(texturing.proctex_lut_offset):
-        SyncProcTexBias();
-        shader_dirty = true;
-        break;
-
-    case PICA_REG_INDEX(texturing.proctex_noise_u):
-    case PICA_REG_INDEX(texturing.proctex_noise_v):
-    case PICA_REG_INDEX(texturing.proctex_noise_frequency):
-        SyncProcTexNoise();
-        break;
-
     case PICA_REG_INDEX(texturing.proctex_lut_data[0]):
     case PICA_REG_INDEX(texturing.proctex_lut_data[1]):
     case PICA_REG_INDEX(texturing.proctex_lut_data[2]):
@@ -952,420 +1390,204 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
         }
         break;
 
-    // Alpha test
-    case PICA_REG_INDEX(framebuffer.output_merger.alpha_test):
-        SyncAlphaTest();
-        shader_dirty = true;
+    // Fragment lighting lookup tables
+    case PICA_REG_INDEX(lighting.lut_data[0]):
+    case PICA_REG_INDEX(lighting.lut_data[1]):
+    case PICA_REG_INDEX(lighting.lut_data[2]):
+    case PICA_REG_INDEX(lighting.lut_data[3]):
+    case PICA_REG_INDEX(lighting.lut_data[4]):
+    case PICA_REG_INDEX(lighting.lut_data[5]):
+    case PICA_REG_INDEX(lighting.lut_data[6]):
+    case PICA_REG_INDEX(lighting.lut_data[7]): {
+        const auto& lut_config = regs.lighting.lut_config;
+        uniform_block_data.lighting_lut_dirty[lut_config.type] = true;
+        uniform_block_data.lighting_lut_dirty_any = true;
         break;
+    }
 
-    // Sync GL stencil test + stencil write mask
-    // (Pica stencil test function register also contains a stencil write mask)
-    case PICA_REG_INDEX(framebuffer.output_merger.stencil_test.raw_func):
-        SyncStencilTest();
-        SyncStencilWriteMask();
-        break;
-    case PICA_REG_INDEX(framebuffer.output_merger.stencil_test.raw_op):
-    case PICA_REG_INDEX(framebuffer.framebuffer.depth_format):
-        SyncStencilTest();
+    // Vertex shader uniforms
+    case PICA_REG_INDEX(vs.bool_uniforms):
+    case PICA_REG_INDEX(vs.int_uniforms[0]):
+    case PICA_REG_INDEX(vs.int_uniforms[1]):
+    case PICA_REG_INDEX(vs.int_uniforms[2]):
+    case PICA_REG_INDEX(vs.int_uniforms[3]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[0]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[1]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[2]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[3]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[4]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[5]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[6]):
+    case PICA_REG_INDEX(vs.uniform_setup.set_value[7]):
+        vs_uniforms_dirty = true;
+        break;
+
+    // Geometry shader uniforms
+    case PICA_REG_INDEX(gs.bool_uniforms):
+    case PICA_REG_INDEX(gs.int_uniforms[0]):
+    case PICA_REG_INDEX(gs.int_uniforms[1]):
+    case PICA_REG_INDEX(gs.int_uniforms[2]):
+    case PICA_REG_INDEX(gs.int_uniforms[3]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[0]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[1]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[2]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[3]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[4]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[5]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[6]):
+    case PICA_REG_INDEX(gs.uniform_setup.set_value[7]):
+        gs_uniforms_dirty = true;
         break;
+    }
+}
 
-    // Sync GL depth test + depth and color write mask
-    // (Pica depth test function register also contains a depth and color write mask)
-    case PICA_REG_INDEX(framebuffer.output_merger.depth_test_enable):
-        SyncDepthTest();
-        SyncDepthWriteMask();
-        SyncColorWriteMask();
-        break;
-
-    // Sync GL depth and stencil write mask
-    // (This is a dedicated combined depth / stencil write-enable register)
-    case PICA_REG_INDEX(framebuffer.framebuffer.allow_depth_stencil_write):
-        SyncDepthWriteMask();
-        SyncStencilWriteMask();
-        break;
-
-    // Sync GL color write mask
-    // (This is a dedicated color write-enable register)
-    case PICA_REG_INDEX(framebuffer.framebuffer.allow_color_write):
-        SyncColorWriteMask();
-        break;
+void RasterizerOpenGL::SyncDirtyState() {
+    const u64 flags = std::exchange(dirty_flags, 0);
+    if (flags == 0) {
+        return;
+    }
 
-    case PICA_REG_INDEX(framebuffer.shadow):
-        SyncShadowBias();
-        break;
+    const auto& regs = Pica::g_state.regs;
 
-    // Scissor test
-    case PICA_REG_INDEX(rasterizer.scissor_test.mode):
+    if (flags & DirtyShader) {
         shader_dirty = true;
-        break;
-
-    // Logic op
-    case PICA_REG_INDEX(framebuffer.output_merger.logic_op):
+    }
+    if (flags & DirtyCullMode) {
+        SyncCullMode();
+    }
+    if (flags & DirtyClipEnable) {
+        SyncClipEnabled();
+    }
+    if (flags & DirtyClipCoef) {
+        SyncClipCoef();
+    }
+    if (flags & DirtyDepthScale) {
+        SyncDepthScale();
+    }
+    if (flags & DirtyDepthOffset) {
+        SyncDepthOffset();
+    }
+    if (flags & DirtyBlendEnable) {
+        if (GLES) {
+            // With GLES, we need this in the fragment shader to emulate logic operations
+            shader_dirty = true;
+        }
+        SyncBlendEnabled();
+    }
+    if (flags & DirtyBlendFuncs) {
+        SyncBlendFuncs();
+    }
+    if (flags & DirtyBlendColor) {
+        SyncBlendColor();
+    }
+    if (flags & DirtyLogicOp) {
         if (GLES) {
             // With GLES, we need this in the fragment shader to emulate logic operations
             shader_dirty = true;
         }
         SyncLogicOp();
-        break;
-
-    case PICA_REG_INDEX(texturing.main_config):
-        shader_dirty = true;
-        break;
-
-    // Texture 0 type
-    case PICA_REG_INDEX(texturing.texture0.type):
-        shader_dirty = true;
-        break;
-
-    // TEV stages
-    // (This also syncs fog_mode and fog_flip which are part of tev_combiner_buffer_input)
-    case PICA_REG_INDEX(texturing.tev_stage0.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage0.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage0.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage0.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage1.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage2.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage3.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage4.color_scale):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_source1):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_modifier1):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_op):
-    case PICA_REG_INDEX(texturing.tev_stage5.color_scale):
-    case PICA_REG_INDEX(texturing.tev_combiner_buffer_input):
-        shader_dirty = true;
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage0.const_r):
-        SyncTevConstColor(0, regs.texturing.tev_stage0);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage1.const_r):
-        SyncTevConstColor(1, regs.texturing.tev_stage1);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage2.const_r):
-        SyncTevConstColor(2, regs.texturing.tev_stage2);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage3.const_r):
-        SyncTevConstColor(3, regs.texturing.tev_stage3);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage4.const_r):
-        SyncTevConstColor(4, regs.texturing.tev_stage4);
-        break;
-    case PICA_REG_INDEX(texturing.tev_stage5.const_r):
-        SyncTevConstColor(5, regs.texturing.tev_stage5);
-        break;
-
-    // TEV combiner buffer color
-    case PICA_REG_INDEX(texturing.tev_combiner_buffer_color):
+    }
+    if (flags & DirtyShadowTextureBias) {
+        SyncShadowTextureBias();
+    }
+    if (flags & DirtyFogColor) {
+        SyncFogColor();
+    }
+    if (flags & DirtyProcTexBias) {
+        SyncProcTexBias();
+    }
+    if (flags & DirtyProcTexNoise) {
+        SyncProcTexNoise();
+    }
+    if (flags & DirtyAlphaTest) {
+        SyncAlphaTest();
+    }
+    if (flags & DirtyStencilTest) {
+        SyncStencilTest();
+    }
+    if (flags & DirtyStencilWriteMask) {
+        SyncStencilWriteMask();
+    }
+    if (flags & DirtyDepthTest) {
+        SyncDepthTest();
+    }
+    if (flags & DirtyDepthWriteMask) {
+        SyncDepthWriteMask();
+    }
+    if (flags & DirtyColorWriteMask) {
+        SyncColorWriteMask();
+    }
+    if (flags & DirtyShadowBias) {
+        SyncShadowBias();
+    }
+    if (flags & DirtyCombinerColor) {
         SyncCombinerColor();
-        break;
-
-    // Fragment lighting switches
-    case PICA_REG_INDEX(lighting.disable):
-    case PICA_REG_INDEX(lighting.max_light_index):
-    case PICA_REG_INDEX(lighting.config0):
-    case PICA_REG_INDEX(lighting.config1):
-    case PICA_REG_INDEX(lighting.abs_lut_input):
-    case PICA_REG_INDEX(lighting.lut_input):
-    case PICA_REG_INDEX(lighting.lut_scale):
-    case PICA_REG_INDEX(lighting.light_enable):
-        break;
-
-    // Fragment lighting specular 0 color
-    case PICA_REG_INDEX(lighting.light[0].specular_0):
-        SyncLightSpecular0(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].specular_0):
-        SyncLightSpecular0(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].specular_0):
-        SyncLightSpecular0(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].specular_0):
-        SyncLightSpecular0(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].specular_0):
-        SyncLightSpecular0(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].specular_0):
-        SyncLightSpecular0(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].specular_0):
-        SyncLightSpecular0(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].specular_0):
-        SyncLightSpecular0(7);
-        break;
-
-    // Fragment lighting specular 1 color
-    case PICA_REG_INDEX(lighting.light[0].specular_1):
-        SyncLightSpecular1(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].specular_1):
-        SyncLightSpecular1(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].specular_1):
-        SyncLightSpecular1(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].specular_1):
-        SyncLightSpecular1(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].specular_1):
-        SyncLightSpecular1(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].specular_1):
-        SyncLightSpecular1(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].specular_1):
-        SyncLightSpecular1(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].specular_1):
-        SyncLightSpecular1(7);
-        break;
-
-    // Fragment lighting diffuse color
-    case PICA_REG_INDEX(lighting.light[0].diffuse):
-        SyncLightDiffuse(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].diffuse):
-        SyncLightDiffuse(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].diffuse):
-        SyncLightDiffuse(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].diffuse):
-        SyncLightDiffuse(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].diffuse):
-        SyncLightDiffuse(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].diffuse):
-        SyncLightDiffuse(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].diffuse):
-        SyncLightDiffuse(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].diffuse):
-        SyncLightDiffuse(7);
-        break;
-
-    // Fragment lighting ambient color
-    case PICA_REG_INDEX(lighting.light[0].ambient):
-        SyncLightAmbient(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].ambient):
-        SyncLightAmbient(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].ambient):
-        SyncLightAmbient(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].ambient):
-        SyncLightAmbient(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].ambient):
-        SyncLightAmbient(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].ambient):
-        SyncLightAmbient(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].ambient):
-        SyncLightAmbient(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].ambient):
-        SyncLightAmbient(7);
-        break;
-
-    // Fragment lighting position
-    case PICA_REG_INDEX(lighting.light[0].x):
-    case PICA_REG_INDEX(lighting.light[0].z):
-        SyncLightPosition(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].x):
-    case PICA_REG_INDEX(lighting.light[1].z):
-        SyncLightPosition(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].x):
-    case PICA_REG_INDEX(lighting.light[2].z):
-        SyncLightPosition(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].x):
-    case PICA_REG_INDEX(lighting.light[3].z):
-        SyncLightPosition(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].x):
-    case PICA_REG_INDEX(lighting.light[4].z):
-        SyncLightPosition(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].x):
-    case PICA_REG_INDEX(lighting.light[5].z):
-        SyncLightPosition(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].x):
-    case PICA_REG_INDEX(lighting.light[6].z):
-        SyncLightPosition(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].x):
-    case PICA_REG_INDEX(lighting.light[7].z):
-        SyncLightPosition(7);
-        break;
-
-    // Fragment spot lighting direction
-    case PICA_REG_INDEX(lighting.light[0].spot_x):
-    case PICA_REG_INDEX(lighting.light[0].spot_z):
-        SyncLightSpotDirection(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].spot_x):
-    case PICA_REG_INDEX(lighting.light[1].spot_z):
-        SyncLightSpotDirection(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].spot_x):
-    case PICA_REG_INDEX(lighting.light[2].spot_z):
-        SyncLightSpotDirection(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].spot_x):
-    case PICA_REG_INDEX(lighting.light[3].spot_z):
-        SyncLightSpotDirection(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].spot_x):
-    case PICA_REG_INDEX(lighting.light[4].spot_z):
-        SyncLightSpotDirection(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].spot_x):
-    case PICA_REG_INDEX(lighting.light[5].spot_z):
-        SyncLightSpotDirection(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].spot_x):
-    case PICA_REG_INDEX(lighting.light[6].spot_z):
-        SyncLightSpotDirection(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].spot_x):
-    case PICA_REG_INDEX(lighting.light[7].spot_z):
-        SyncLightSpotDirection(7);
-        break;
-
-    // Fragment lighting light source config
-    case PICA_REG_INDEX(lighting.light[0].config):
-    case PICA_REG_INDEX(lighting.light[1].config):
-    case PICA_REG_INDEX(lighting.light[2].config):
-    case PICA_REG_INDEX(lighting.light[3].config):
-    case PICA_REG_INDEX(lighting.light[4].config):
-    case PICA_REG_INDEX(lighting.light[5].config):
-    case PICA_REG_INDEX(lighting.light[6].config):
-    case PICA_REG_INDEX(lighting.light[7].config):
-        shader_dirty = true;
-        break;
-
-    // Fragment lighting distance attenuation bias
-    case PICA_REG_INDEX(lighting.light[0].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].dist_atten_bias):
-        SyncLightDistanceAttenuationBias(7);
-        break;
-
-    // Fragment lighting distance attenuation scale
-    case PICA_REG_INDEX(lighting.light[0].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(0);
-        break;
-    case PICA_REG_INDEX(lighting.light[1].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(1);
-        break;
-    case PICA_REG_INDEX(lighting.light[2].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(2);
-        break;
-    case PICA_REG_INDEX(lighting.light[3].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(3);
-        break;
-    case PICA_REG_INDEX(lighting.light[4].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(4);
-        break;
-    case PICA_REG_INDEX(lighting.light[5].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(5);
-        break;
-    case PICA_REG_INDEX(lighting.light[6].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(6);
-        break;
-    case PICA_REG_INDEX(lighting.light[7].dist_atten_scale):
-        SyncLightDistanceAttenuationScale(7);
-        break;
-
-    // Fragment lighting global ambient color (emission + ambient * ambient)
-    case PICA_REG_INDEX(lighting.global_ambient):
+    }
+    if (flags & DirtyGlobalAmbient) {
         SyncGlobalAmbient();
-        break;
+    }
 
-    // Fragment lighting lookup tables
-    case PICA_REG_INDEX(lighting.lut_data[0]):
-    case PICA_REG_INDEX(lighting.lut_data[1]):
-    case PICA_REG_INDEX(lighting.lut_data[2]):
-    case PICA_REG_INDEX(lighting.lut_data[3]):
-    case PICA_REG_INDEX(lighting.lut_data[4]):
-    case PICA_REG_INDEX(lighting.lut_data[5]):
-    case PICA_REG_INDEX(lighting.lut_data[6]):
-    case PICA_REG_INDEX(lighting.lut_data[7]): {
-        const auto& lut_config = regs.lighting.lut_config;
-        uniform_block_data.lighting_lut_dirty[lut_config.type] = true;
-        uniform_block_data.lighting_lut_dirty_any = true;
-        break;
+    const auto& tev_stages = regs.texturing.GetTevStages();
+    for (std::size_t index = 0; index < tev_stages.size(); ++index) {
+        if (flags & (DirtyTevConstColor << index)) {
+            SyncTevConstColor(index, tev_stages[index]);
+        }
     }
+
+    for (int light_index = 0; light_index < 8; ++light_index) {
+        if (!(flags & (DirtyLight << light_index))) {
+            continue;
+        }
+        SyncLightSpecular0(light_index);
+        SyncLightSpecular1(light_index);
+        SyncLightDiffuse(light_index);
+        SyncLightAmbient(light_index);
+        SyncLightPosition(light_index);
+        SyncLightSpotDirection(light_index);
+        SyncLightDistanceAttenuationBias(light_index);
+        SyncLightDistanceAttenuationScale(light_index);
     }
 }
 
+void RasterizerOpenGL::EndFrame() {
+    res_cache.EndFrame();
+}
+
 void RasterizerOpenGL::FlushAll() {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    SubmitBatchedDraws();
     res_cache.FlushAll();
 }
 
 void RasterizerOpenGL::FlushRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    SubmitBatchedDraws();
     res_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    SubmitBatchedDraws();
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    SubmitBatchedDraws();
     res_cache.FlushRegion(addr, size);
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 void RasterizerOpenGL::ClearAll(bool flush) {
+    SubmitBatchedDraws();
     res_cache.ClearAll(flush);
+    shaded_vertices.clear();
+    num_shaded_vertices = 0;
 }
 
 bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransferConfig& config) {
     MICROPROFILE_SCOPE(OpenGL_Blits);
+    SubmitBatchedDraws();
 
     SurfaceParams src_params;
     src_params.addr = config.GetPhysicalInputAddress();
@@ -1408,14 +1630,21 @@ bool RasterizerOpenGL::AccelerateDisplayTransfer(const GPU::Regs::DisplayTransfe
     if (config.flip_vertically)
         std::swap(src_rect.top, src_rect.bottom);
 
+    // A display transfer ends the render pass that produced its source
+    EndRenderPass();
+
     if (!res_cache.BlitSurfaces(src_surface, src_rect, dst_surface, dst_rect))
         return false;
 
     res_cache.InvalidateRegion(dst_params.addr, dst_params.size, dst_surface);
+    if (dst_surface->read_back) {
+        dst_surface->QueueDownload(dst_surface->GetSubRect(dst_params));
+    }
     return true;
 }
 
 bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferConfig& config) {
+    SubmitBatchedDraws();
     u32 copy_size = Common::AlignDown(config.texture_copy.size, 16);
     if (copy_size == 0) {
         return false;
@@ -1459,7 +1688,8 @@ bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferCon
     Surface src_surface;
     std::tie(src_surface, src_rect) = res_cache.GetTexCopySurface(src_params);
     if (src_surface == nullptr) {
-        return false;
+        return AccelerateTextureUpload(config, src_params, input_width, input_gap, output_width,
+                                       output_gap);
     }
 
     if (output_gap != 0 &&
@@ -1500,7 +1730,61 @@ bool RasterizerOpenGL::AccelerateTextureCopy(const GPU::Regs::DisplayTransferCon
     return true;
 }
 
+bool RasterizerOpenGL::AccelerateTextureUpload(const GPU::Regs::DisplayTransferConfig& config,
+                                               const SurfaceParams& src_params, u32 input_width,
+                                               u32 input_gap, u32 output_width, u32 output_gap) {
+    // The source of the copy is not cached, so its format is unknown. When the copy targets a
+    // cached surface, the source can be uploaded with the layout of that surface instead.
+    SurfaceParams dst_params;
+    dst_params.addr = config.GetPhysicalOutputAddress();
+    dst_params.stride = output_width + output_gap;
+    dst_params.width = output_width;
+    dst_params.height = (src_params.height * input_width) / output_width;
+    dst_params.size = ((dst_params.height - 1) * dst_params.stride) + dst_params.width;
+    dst_params.end = dst_params.addr + dst_params.size;
+
+    Common::Rectangle<u32> dst_rect;
+    Surface dst_surface;
+    std::tie(dst_surface, dst_rect) = res_cache.GetTexCopySurface(dst_params);
+    if (dst_surface == nullptr || dst_surface->type == SurfaceType::Texture) {
+        return false;
+    }
+
+    const u32 tiled_size = dst_surface->is_tiled ? 8 : 1;
+    if (input_gap != 0 &&
+        (input_width != dst_surface->BytesInPixels(dst_rect.GetWidth() / dst_surface->res_scale) *
+                            tiled_size ||
+         input_gap % dst_surface->BytesInPixels(tiled_size * tiled_size) != 0)) {
+        return false;
+    }
+
+    SurfaceParams upload_params = *dst_surface;
+    upload_params.addr = src_params.addr;
+    upload_params.width = dst_rect.GetWidth() / dst_surface->res_scale;
+    upload_params.stride =
+        upload_params.width + dst_surface->PixelsInBytes(input_gap / tiled_size);
+    upload_params.height = dst_rect.GetHeight() / dst_surface->res_scale;
+    upload_params.res_scale = dst_surface->res_scale;
+    upload_params.UpdateParams();
+
+    Common::Rectangle<u32> src_rect;
+    Surface src_surface;
+    std::tie(src_surface, src_rect) =
+        res_cache.GetSurfaceSubRect(upload_params, ScaleMatch::Upscale, true);
+    if (src_surface == nullptr) {
+        return false;
+    }
+
+    if (!res_cache.BlitSurfaces(src_surface, src_rect, dst_surface, dst_rect)) {
+        return false;
+    }
+
+    res_cache.InvalidateRegion(dst_params.addr, dst_params.size, dst_surface);
+    return true;
+}
+
 bool RasterizerOpenGL::AccelerateFill(const GPU::Regs::MemoryFillConfig& config) {
+    SubmitBatchedDraws();
     Surface dst_surface = res_cache.GetFillSurface(config);
     if (dst_surface == nullptr)
         return false;
@@ -1512,6 +1796,7 @@ bool RasterizerOpenGL::AccelerateFill(const GPU::Regs::MemoryFillConfig& config)
 bool RasterizerOpenGL::AccelerateDisplay(const GPU::Regs::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
+    SubmitBatchedDraws();
     if (framebuffer_addr == 0) {
         return false;
     }
@@ -1543,83 +1828,68 @@ bool RasterizerOpenGL::AccelerateDisplay(const GPU::Regs::FramebufferConfig& con
         (float)src_rect.top / (float)scaled_height, (float)src_rect.right / (float)scaled_width);
 
     screen_info.display_texture = src_surface->texture.handle;
+    screen_info.display_tick = src_surface->modification_tick;
 
     return true;
 }
 
-void RasterizerOpenGL::SamplerInfo::Create() {
-    sampler.Create();
-    mag_filter = min_filter = mip_filter = TextureConfig::Linear;
-    wrap_s = wrap_t = TextureConfig::Repeat;
-    border_color = 0;
-    lod_min = lod_max = 0;
-    lod_bias = 0;
-
-    // default is 1000 and -1000
-    // Other attributes have correct defaults
-    glSamplerParameterf(sampler.handle, GL_TEXTURE_MAX_LOD, static_cast<float>(lod_max));
-    glSamplerParameterf(sampler.handle, GL_TEXTURE_MIN_LOD, static_cast<float>(lod_min));
-}
-
-void RasterizerOpenGL::SamplerInfo::SyncWithConfig(
-    const Pica::TexturingRegs::TextureConfig& config) {
-
-    GLuint s = sampler.handle;
-
-    if (mag_filter != config.mag_filter) {
-        mag_filter = config.mag_filter;
-        glSamplerParameteri(s, GL_TEXTURE_MAG_FILTER, PicaToGL::TextureMagFilterMode(mag_filter));
-    }
-
-    // TODO(wwylele): remove new_supress_mipmap_for_cube logic once mipmap for cube is implemented
-    bool new_supress_mipmap_for_cube =
-        config.type == Pica::TexturingRegs::TextureConfig::TextureCube;
-    if (min_filter != config.min_filter || mip_filter != config.mip_filter ||
-        supress_mipmap_for_cube != new_supress_mipmap_for_cube) {
-        min_filter = config.min_filter;
-        mip_filter = config.mip_filter;
-        supress_mipmap_for_cube = new_supress_mipmap_for_cube;
-        if (new_supress_mipmap_for_cube) {
-            // HACK: use mag filter converter for min filter because they are the same anyway
-            glSamplerParameteri(s, GL_TEXTURE_MIN_FILTER,
-                                PicaToGL::TextureMagFilterMode(min_filter));
-        } else {
-            glSamplerParameteri(s, GL_TEXTURE_MIN_FILTER,
-                                PicaToGL::TextureMinFilterMode(min_filter, mip_filter));
-        }
-    }
-
-    if (wrap_s != config.wrap_s) {
-        wrap_s = config.wrap_s;
-        glSamplerParameteri(s, GL_TEXTURE_WRAP_S, PicaToGL::WrapMode(wrap_s));
-    }
-    if (wrap_t != config.wrap_t) {
-        wrap_t = config.wrap_t;
-        glSamplerParameteri(s, GL_TEXTURE_WRAP_T, PicaToGL::WrapMode(wrap_t));
-    }
-
-    if (wrap_s == TextureConfig::ClampToBorder || wrap_t == TextureConfig::ClampToBorder) {
-        if (border_color != config.border_color.raw) {
-            border_color = config.border_color.raw;
-            auto gl_color = PicaToGL::ColorRGBA8(border_color);
-            glSamplerParameterfv(s, GL_TEXTURE_BORDER_COLOR, gl_color.AsArray());
-        }
-    }
+RasterizerOpenGL::SamplerParams RasterizerOpenGL::SamplerParams::FromConfig(
+    const TextureConfig& config) {
+    SamplerParams params{};
+    params.mag_filter = config.mag_filter;
+    params.min_filter = config.min_filter;
+    params.mip_filter = config.mip_filter;
+    params.wrap_s = config.wrap_s;
+    params.wrap_t = config.wrap_t;
+    if (params.wrap_s == TextureConfig::ClampToBorder ||
+        params.wrap_t == TextureConfig::ClampToBorder) {
+        params.border_color = config.border_color.raw;
+    }
+    params.lod_min = config.lod.min_level;
+    params.lod_max = config.lod.max_level;
+    if (!GLES) {
+        params.lod_bias = config.lod.bias;
+    }
+    // TODO(wwylele): remove supress_mipmap_for_cube logic once mipmap for cube is implemented
+    params.supress_mipmap_for_cube = config.type == TextureConfig::TextureCube;
+    return params;
+}
 
-    if (lod_min != config.lod.min_level) {
-        lod_min = config.lod.min_level;
-        glSamplerParameterf(s, GL_TEXTURE_MIN_LOD, static_cast<float>(lod_min));
-    }
+GLuint RasterizerOpenGL::GetSampler(const Pica::TexturingRegs::TextureConfig& config) {
+    using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
-    if (lod_max != config.lod.max_level) {
-        lod_max = config.lod.max_level;
-        glSamplerParameterf(s, GL_TEXTURE_MAX_LOD, static_cast<float>(lod_max));
+    const SamplerParams params = SamplerParams::FromConfig(config);
+    auto [it, is_new] = samplers.try_emplace(params);
+    OGLSampler& sampler = it->second;
+    if (!is_new) {
+        return sampler.handle;
     }
 
-    if (!GLES && lod_bias != config.lod.bias) {
-        lod_bias = config.lod.bias;
-        glSamplerParameterf(s, GL_TEXTURE_LOD_BIAS, lod_bias / 256.0f);
-    }
+    sampler.Create();
+    const GLuint s = sampler.handle;
+    glSamplerParameteri(s, GL_TEXTURE_MAG_FILTER,
+                        PicaToGL::TextureMagFilterMode(params.mag_filter));
+    if (params.supress_mipmap_for_cube) {
+        // HACK: use mag filter converter for min filter because they are the same anyway
+        glSamplerParameteri(s, GL_TEXTURE_MIN_FILTER,
+                            PicaToGL::TextureMagFilterMode(params.min_filter));
+    } else {
+        glSamplerParameteri(s, GL_TEXTURE_MIN_FILTER,
+                            PicaToGL::TextureMinFilterMode(params.min_filter, params.mip_filter));
+    }
+    glSamplerParameteri(s, GL_TEXTURE_WRAP_S, PicaToGL::WrapMode(params.wrap_s));
+    glSamplerParameteri(s, GL_TEXTURE_WRAP_T, PicaToGL::WrapMode(params.wrap_t));
+    if (params.wrap_s == TextureConfig::ClampToBorder ||
+        params.wrap_t == TextureConfig::ClampToBorder) {
+        auto gl_color = PicaToGL::ColorRGBA8(params.border_color);
+        glSamplerParameterfv(s, GL_TEXTURE_BORDER_COLOR, gl_color.AsArray());
+    }
+    glSamplerParameterf(s, GL_TEXTURE_MIN_LOD, static_cast<float>(params.lod_min));
+    glSamplerParameterf(s, GL_TEXTURE_MAX_LOD, static_cast<float>(params.lod_max));
+    if (!GLES) {
+        glSamplerParameterf(s, GL_TEXTURE_LOD_BIAS, params.lod_bias / 256.0f);
+    }
+    return s;
 }
 
 void RasterizerOpenGL::SetShader() {
@@ -1966,6 +2236,22 @@ void RasterizerOpenGL::SyncShadowTextureBias() {
     }
 }
 
+/**
+ * Copies a LUT to the mapped texture buffer, unless the same contents have been uploaded since the
+ * buffer was last invalidated. Returns the byte offset of the contents in the buffer.
+ */
+template <typename T, std::size_t N>
+static GLintptr UploadLUT(const std::array<T, N>& data, std::unordered_map<u64, GLintptr>& slots,
+                          u8* buffer, GLintptr offset, std::size_t& bytes_used) {
+    const u64 hash = Common::ComputeBulkHash64(data.data(), sizeof(data));
+    const auto [it, inserted] = slots.try_emplace(hash, offset + bytes_used);
+    if (inserted) {
+        std::memcpy(buffer + bytes_used, data.data(), sizeof(data));
+        bytes_used += sizeof(data);
+    }
+    return it->second;
+}
+
 void RasterizerOpenGL::SyncAndUploadLUTsLF() {
     constexpr std::size_t max_size =
         sizeof(Common::Vec2f) * 256 * Pica::LightingRegs::NumLightingSampler +
@@ -1981,6 +2267,9 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
     std::size_t bytes_used = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_lf_buffer.GetHandle());
     std::tie(buffer, offset, invalidate) = texture_lf_buffer.Map(max_size, sizeof(Common::Vec4f));
+    if (invalidate) {
+        lut_lf_slots.clear();
+    }
 
     // Sync the lighting luts
     if (uniform_block_data.lighting_lut_dirty_any || invalidate) {
@@ -1995,12 +2284,11 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
 
                 if (new_data != lighting_lut_data[index] || invalidate) {
                     lighting_lut_data[index] = new_data;
-                    std::memcpy(buffer + bytes_used, new_data.data(),
-                                new_data.size() * sizeof(Common::Vec2f));
+                    const GLintptr lut_offset =
+                        UploadLUT(new_data, lut_lf_slots, buffer, offset, bytes_used);
                     uniform_block_data.data.lighting_lut_offset[index / 4][index % 4] =
-                        static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
+                        static_cast<GLint>(lut_offset / sizeof(Common::Vec2f));
                     uniform_block_data.dirty = true;
-                    bytes_used += new_data.size() * sizeof(Common::Vec2f);
                 }
                 uniform_block_data.lighting_lut_dirty[index] = false;
             }
@@ -2019,12 +2307,11 @@ void RasterizerOpenGL::SyncAndUploadLUTsLF() {
 
         if (new_data != fog_lut_data || invalidate) {
             fog_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec2f));
+            const GLintptr lut_offset =
+                UploadLUT(new_data, lut_lf_slots, buffer, offset, bytes_used);
             uniform_block_data.data.fog_lut_offset =
-                static_cast<int>((offset + bytes_used) / sizeof(Common::Vec2f));
+                static_cast<int>(lut_offset / sizeof(Common::Vec2f));
             uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec2f);
         }
         uniform_block_data.fog_lut_dirty = false;
     }
@@ -2051,6 +2338,9 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
     std::size_t bytes_used = 0;
     glBindBuffer(GL_TEXTURE_BUFFER, texture_buffer.GetHandle());
     std::tie(buffer, offset, invalidate) = texture_buffer.Map(max_size, sizeof(Common::Vec4f));
+    if (invalidate) {
+        lut_slots.clear();
+    }
 
     // helper function for SyncProcTexNoiseLUT/ColorMap/AlphaMap
     auto SyncProcTexValueLUT = [this, buffer, offset, invalidate, &bytes_used](
@@ -2063,11 +2353,10 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
 
         if (new_data != lut_data || invalidate) {
             lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec2f));
-            lut_offset = static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec2f));
+            const GLintptr data_offset =
+                UploadLUT(new_data, lut_slots, buffer, offset, bytes_used);
+            lut_offset = static_cast<GLint>(data_offset / sizeof(Common::Vec2f));
             uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec2f);
         }
     };
 
@@ -2105,12 +2394,10 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
 
         if (new_data != proctex_lut_data || invalidate) {
             proctex_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
+            const GLintptr lut_offset = UploadLUT(new_data, lut_slots, buffer, offset, bytes_used);
             uniform_block_data.data.proctex_lut_offset =
-                static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec4f));
+                static_cast<GLint>(lut_offset / sizeof(Common::Vec4f));
             uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
         }
         uniform_block_data.proctex_lut_dirty = false;
     }
@@ -2128,12 +2415,10 @@ void RasterizerOpenGL::SyncAndUploadLUTs() {
 
         if (new_data != proctex_diff_lut_data || invalidate) {
             proctex_diff_lut_data = new_data;
-            std::memcpy(buffer + bytes_used, new_data.data(),
-                        new_data.size() * sizeof(Common::Vec4f));
+            const GLintptr lut_offset = UploadLUT(new_data, lut_slots, buffer, offset, bytes_used);
             uniform_block_data.data.proctex_diff_lut_offset =
-                static_cast<GLint>((offset + bytes_used) / sizeof(Common::Vec4f));
+                static_cast<GLint>(lut_offset / sizeof(Common::Vec4f));
             uniform_block_data.dirty = true;
-            bytes_used += new_data.size() * sizeof(Common::Vec4f);
         }
         uniform_block_data.proctex_diff_lut_dirty = false;
     }
@@ -2147,13 +2432,46 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
     state.draw.uniform_buffer = uniform_buffer.GetHandle();
     state.Apply();
 
-    bool sync_vs = accelerate_draw;
+    const bool use_gs = Pica::g_state.regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No;
+    bool sync_vs = accelerate_draw && vs_uniforms_dirty;
+    bool sync_gs = accelerate_draw && use_gs && gs_uniforms_dirty;
     bool sync_fs = uniform_block_data.dirty;
 
-    if (!sync_vs && !sync_fs)
+    // The padding is cleared so that the blocks can be compared byte by byte
+    VSUniformData vs_uniforms;
+    GSUniformData gs_uniforms;
+    const auto BuildVSUniforms = [&] {
+        std::memset(&vs_uniforms, 0, sizeof(vs_uniforms));
+        vs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
+    };
+    const auto BuildGSUniforms = [&] {
+        std::memset(&gs_uniforms, 0, sizeof(gs_uniforms));
+        gs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.gs, Pica::g_state.gs);
+    };
+    const auto IsBound = [](const auto& bound, const auto& block) {
+        return bound && std::memcmp(&*bound, &block, sizeof(block)) == 0;
+    };
+
+    if (sync_vs) {
+        BuildVSUniforms();
+        sync_vs = !IsBound(bound_vs_uniforms, vs_uniforms);
+        vs_uniforms_dirty = sync_vs;
+    }
+    if (sync_gs) {
+        BuildGSUniforms();
+        sync_gs = !IsBound(bound_gs_uniforms, gs_uniforms);
+        gs_uniforms_dirty = sync_gs;
+    }
+    if (sync_fs) {
+        sync_fs = !IsBound(bound_fs_uniforms, uniform_block_data.data);
+        uniform_block_data.dirty = sync_fs;
+    }
+
+    if (!sync_vs && !sync_gs && !sync_fs)
         return;
 
-    std::size_t uniform_size = uniform_size_aligned_vs + uniform_size_aligned_fs;
+    std::size_t uniform_size =
+        uniform_size_aligned_vs + uniform_size_aligned_gs + uniform_size_aligned_fs;
     std::size_t used_bytes = 0;
     u8* uniforms;
     GLintptr offset;
@@ -2161,19 +2479,46 @@ void RasterizerOpenGL::UploadUniforms(bool accelerate_draw) {
     std::tie(uniforms, offset, invalidate) =
         uniform_buffer.Map(uniform_size, uniform_buffer_alignment);
 
+    if (invalidate) {
+        // The previously uploaded shader uniforms are gone along with the old buffer
+        vs_uniforms_dirty = true;
+        gs_uniforms_dirty = true;
+        bound_vs_uniforms.reset();
+        bound_gs_uniforms.reset();
+        bound_fs_uniforms.reset();
+        if (accelerate_draw && !sync_vs) {
+            BuildVSUniforms();
+        }
+        if (accelerate_draw && use_gs && !sync_gs) {
+            BuildGSUniforms();
+        }
+        sync_vs = accelerate_draw;
+        sync_gs = accelerate_draw && use_gs;
+    }
+
     if (sync_vs) {
-        VSUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
         std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::VS),
                           uniform_buffer.GetHandle(), offset + used_bytes, sizeof(VSUniformData));
+        bound_vs_uniforms = vs_uniforms;
+        vs_uniforms_dirty = false;
         used_bytes += uniform_size_aligned_vs;
     }
 
+    if (sync_gs) {
+        std::memcpy(uniforms + used_bytes, &gs_uniforms, sizeof(gs_uniforms));
+        glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::GS),
+                          uniform_buffer.GetHandle(), offset + used_bytes, sizeof(GSUniformData));
+        bound_gs_uniforms = gs_uniforms;
+        gs_uniforms_dirty = false;
+        used_bytes += uniform_size_aligned_gs;
+    }
+
     if (sync_fs || invalidate) {
         std::memcpy(uniforms + used_bytes, &uniform_block_data.data, sizeof(UniformData));
         glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(UniformBindings::Common),
                           uniform_buffer.GetHandle(), offset + used_bytes, sizeof(UniformData));
+        bound_fs_uniforms = uniform_block_data.data;
         uniform_block_data.dirty = false;
         used_bytes += uniform_size_aligned_fs;
     }
@@ -3,6 +3,10 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include "common/hash.h"
 #include "common/vector_math.h"
 #include "core/hw/gpu.h"
 #include "video_core/pica_types.h"
@@ -33,7 +37,15 @@ public:
     void AddTriangle(const Pica::Shader::OutputVertex& v0, const Pica::Shader::OutputVertex& v1,
                      const Pica::Shader::OutputVertex& v2) override;
     void DrawTriangles() override;
+    bool CachesShadedVertices() const override {
+        return true;
+    }
+    bool LoadShadedVertices(u64 key) override;
+    void StoreShadedVertices(u64 key) override;
+    void NotifyPicaRegisterChanging(u32 id) override;
     void NotifyPicaRegisterChanged(u32 id) override;
+    void SubmitBatchedDraws() override;
+    void EndFrame() override;
     void FlushAll() override;
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
@@ -49,19 +61,13 @@ public:
     /// Syncs entire status to match PICA registers
     void SyncEntireState() override;
 
+    VideoCore::RasterizerStatistics GetStatistics() const override;
+
 private:
-    struct SamplerInfo {
+    /// The state of a sampler object, a sampler is created for each distinct state that's used
+    struct SamplerParams {
         using TextureConfig = Pica::TexturingRegs::TextureConfig;
 
-        OGLSampler sampler;
-
-        /// Creates the sampler object, initializing its state so that it's in sync with the
-        /// SamplerInfo struct.
-        void Create();
-        /// Syncs the sampler object with the config, updating any necessary state.
-        void SyncWithConfig(const TextureConfig& config);
-
-    private:
         TextureConfig::TextureFilter mag_filter;
         TextureConfig::TextureFilter min_filter;
         TextureConfig::TextureFilter mip_filter;
@@ -73,9 +79,26 @@ private:
         s32 lod_bias;
 
         // TODO(wwylele): remove this once mipmap for cube is implemented
-        bool supress_mipmap_for_cube = false;
+        u32 supress_mipmap_for_cube;
+
+        /// Takes the state from the config, leaving out the parts the sampler doesn't use so that
+        /// they don't tell apart samplers that behave the same
+        static SamplerParams FromConfig(const TextureConfig& config);
+
+        bool operator==(const SamplerParams& rhs) const {
+            return std::memcmp(this, &rhs, sizeof(SamplerParams)) == 0;
+        }
+
+        struct Hash {
+            std::size_t operator()(const SamplerParams& params) const noexcept {
+                return Common::ComputeStructHash64(params);
+            }
+        };
     };
 
+    /// Returns the sampler object with the state of the config, creating it on its first use
+    GLuint GetSampler(const Pica::TexturingRegs::TextureConfig& config);
+
     /// Structure that the hardware rendered vertices are composed of
     struct HardwareVertex {
         HardwareVertex() = default;
@@ -118,6 +141,14 @@ private:
         Common::Vec3f view;
     };
 
+    /// Performs a TextureCopy from an uncached source into a cached surface on the GPU
+    bool AccelerateTextureUpload(const GPU::Regs::DisplayTransferConfig& config,
+                                 const SurfaceParams& src_params, u32 input_width, u32 input_gap,
+                                 u32 output_width, u32 output_gap);
+
+    /// Syncs the OpenGL state of the register groups written since the last draw
+    void SyncDirtyState();
+
     /// Syncs the clip enabled status to match the PICA register
     void SyncClipEnabled();
 
@@ -226,7 +257,16 @@ private:
     bool Draw(bool accelerate, bool is_indexed);
 
     /// Internal implementation for AccelerateDrawBatch
-    bool AccelerateDrawBatchInternal(bool is_indexed);
+    bool AccelerateDrawBatchInternal(bool is_indexed, bool allow_batching);
+
+    /// Merges the current indexed draw into the pending draw batch if their state allows it
+    bool AppendToDrawBatch();
+
+    /// Unbinds the textures used by the last draw
+    void ResetTextureUnits();
+
+    /// Queues the download of the current render target if the guest tends to read it back
+    void EndRenderPass();
 
     struct VertexArrayInfo {
         u32 vs_input_index_min;
@@ -237,9 +277,15 @@ private:
     /// Retrieve the range and the size of the input vertex
     VertexArrayInfo AnalyzeVertexArray(bool is_indexed);
 
+    /// Physical addresses of the vertex data read by each attribute loader
+    using LoaderAddresses = std::array<PAddr, 12>;
+
+    /// Retrieve the vertex data addresses of the current draw
+    LoaderAddresses GetLoaderAddresses() const;
+
     /// Setup vertex array for AccelerateDrawBatch
     void SetupVertexArray(u8* array_ptr, GLintptr buffer_offset, GLuint vs_input_index_min,
-                          GLuint vs_input_index_max);
+                          GLuint vs_input_index_max, const LoaderAddresses& loader_addresses);
 
     /// Setup vertex shader for AccelerateDrawBatch
     bool SetupVertexShader();
@@ -254,9 +300,39 @@ private:
 
     RasterizerCacheOpenGL res_cache;
 
+    // Color surface drawn to by the current render pass and the region drawn so far
+    Surface render_pass_surface;
+    Common::Rectangle<u32> render_pass_rect;
+
     std::vector<HardwareVertex> vertex_batch;
 
+    /// The triangles of draws shaded on the CPU, by the hash of everything their shading used
+    std::unordered_map<u64, std::vector<HardwareVertex>> shaded_vertices;
+    std::size_t num_shaded_vertices = 0;   ///< The number of vertices in shaded_vertices
+    std::size_t shaded_vertices_start = 0; ///< Start in vertex_batch of the draw to store
+
+    /// Consecutive indexed draws that only differ in the vertex and index data they read. They
+    /// are submitted with a single multi-draw once the pipeline state changes.
+    struct DrawBatch {
+        LoaderAddresses loader_addresses{}; ///< Vertex data addresses of the first draw
+        GLenum primitive_mode{};
+        bool index_u16{};
+        u32 vertex_min{}; ///< Vertex range referenced by the draws, relative to the first draw
+        u32 vertex_max{};
+        std::vector<u8> indices;
+        std::vector<GLsizei> counts;
+        std::vector<GLintptr> index_offsets; ///< Offset of the indices of each draw
+        std::vector<GLint> base_vertices;    ///< Vertex offset of each draw to the first draw
+    } draw_batch;
+
+    u64 draws = 0;
+    u64 accelerated_draws = 0;
+    u64 merged_draws = 0;
+
     bool shader_dirty = true;
+    bool vs_uniforms_dirty = true;
+    bool gs_uniforms_dirty = true;
+    u64 dirty_flags = 0; ///< Register groups waiting to be synced by SyncDirtyState
 
     struct {
         UniformData data;
@@ -271,6 +347,12 @@ private:
         bool dirty;
     } uniform_block_data = {};
 
+    /// Copies of the uniform blocks that are bound, games often write the same uniforms again and
+    /// those aren't uploaded and bound again. Empty when the block has to be uploaded.
+    std::optional<VSUniformData> bound_vs_uniforms;
+    std::optional<GSUniformData> bound_gs_uniforms;
+    std::optional<UniformData> bound_fs_uniforms;
+
     std::unique_ptr<ShaderProgramManager> shader_program_manager;
 
     // They shall be big enough for about one frame.
@@ -283,7 +365,7 @@ private:
     OGLVertexArray hw_vao; // VAO for hardware shader / accelerate draw
     std::array<bool, 16> hw_vao_enabled_attributes{};
 
-    std::array<SamplerInfo, 3> texture_samplers;
+    std::unordered_map<SamplerParams, OGLSampler, SamplerParams::Hash> samplers;
     OGLStreamBuffer vertex_buffer;
     OGLStreamBuffer uniform_buffer;
     OGLStreamBuffer index_buffer;
@@ -292,10 +374,9 @@ private:
     OGLFramebuffer framebuffer;
     GLint uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs;
+    std::size_t uniform_size_aligned_gs;
     std::size_t uniform_size_aligned_fs;
 
-    SamplerInfo texture_cube_sampler;
-
     OGLTexture texture_buffer_lut_lf;
     OGLTexture texture_buffer_lut_rg;
     OGLTexture texture_buffer_lut_rgba;
@@ -308,6 +389,11 @@ private:
     std::array<Common::Vec2f, 128> proctex_alpha_map_data{};
     std::array<Common::Vec4f, 256> proctex_lut_data{};
     std::array<Common::Vec4f, 256> proctex_diff_lut_data{};
+
+    // Byte offsets of the LUT contents uploaded to each texture buffer since it was last
+    // invalidated, keyed by their hash. Games often switch between a few setups every frame.
+    std::unordered_map<u64, GLintptr> lut_lf_slots;
+    std::unordered_map<u64, GLintptr> lut_slots;
 };
 
 } // namespace OpenGL
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include "common/memory_usage.h"
 #include "common/microprofile.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_shader_util.h"
@@ -9,9 +11,39 @@
 
 MICROPROFILE_DEFINE(OpenGL_ResourceCreation, "OpenGL", "Resource Creation", MP_RGB(128, 128, 192));
 MICROPROFILE_DEFINE(OpenGL_ResourceDeletion, "OpenGL", "Resource Deletion", MP_RGB(128, 128, 192));
+MICROPROFILE_DEFINE(OpenGL_ShaderCompile, "OpenGL", "Shader Compile", MP_RGB(192, 64, 64));
+MICROPROFILE_DEFINE(OpenGL_ProgramLink, "OpenGL", "Program Link", MP_RGB(192, 96, 64));
 
 namespace OpenGL {
 
+namespace {
+
+Common::MemoryUsage::Counter TextureUsage{"OpenGL", "Textures"};
+/// Drivers don't tell the memory used by programs, so only their number is counted
+Common::MemoryUsage::Counter ProgramUsage{"OpenGL", "Programs"};
+
+/// Bytes per texel the driver likely stores the format with, the 24 bit formats are padded
+std::size_t GetTexelSize(GLenum internalformat) {
+    switch (internalformat) {
+    case GL_R8:
+        return 1;
+    case GL_RGB565:
+    case GL_RGB5_A1:
+    case GL_RGBA4:
+    case GL_DEPTH_COMPONENT16:
+        return 2;
+    case GL_RG32F:
+    case GL_RG32UI:
+        return 8;
+    case GL_RGBA32F:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+} // Anonymous namespace
+
 void OGLRenderbuffer::Create() {
     if (handle != 0) {
         return;
@@ -50,6 +82,9 @@ void OGLTexture::Release() {
     glDeleteTextures(1, &handle);
     OpenGLState::GetCurState().ResetTexture(handle).Apply();
     handle = 0;
+    if (allocated_size != 0) {
+        TextureUsage.Remove(std::exchange(allocated_size, 0));
+    }
 }
 
 void OGLTexture::Allocate(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width,
@@ -81,6 +116,22 @@ void OGLTexture::Allocate(GLenum target, GLsizei levels, GLenum internalformat,
     glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     glBindTexture(GL_TEXTURE_2D, old_tex);
+
+    // Storage is immutable, so a texture is only allocated once
+    const std::size_t layers =
+        target == GL_TEXTURE_CUBE_MAP || target == GL_TEXTURE_CUBE_MAP_ARRAY ? 6 : 1;
+    std::size_t size = 0;
+    for (GLsizei level = 0; level < levels; ++level) {
+        const GLsizei level_depth = target == GL_TEXTURE_3D ? std::max(depth >> level, 1) : depth;
+        size += static_cast<std::size_t>(std::max(width >> level, 1)) *
+                static_cast<std::size_t>(std::max(height >> level, 1)) *
+                static_cast<std::size_t>(level_depth);
+    }
+    size *= layers * GetTexelSize(internalformat);
+    if (allocated_size == 0 && size != 0) {
+        allocated_size = size;
+        TextureUsage.Add(size);
+    }
 }
 
 void OGLTexture::CopyFrom(const OGLTexture& other, GLenum target, GLsizei levels, GLsizei width,
@@ -123,7 +174,7 @@ void OGLShader::Create(const char* source, GLenum type) {
     if (source == nullptr)
         return;
 
-    MICROPROFILE_SCOPE(OpenGL_ResourceCreation);
+    MICROPROFILE_SCOPE(OpenGL_ShaderCompile);
     handle = LoadShader(source, type);
 }
 
@@ -140,8 +191,29 @@ void OGLProgram::Create(bool separable_program, const std::vector<GLuint>& shade
     if (handle != 0)
         return;
 
-    MICROPROFILE_SCOPE(OpenGL_ResourceCreation);
+    MICROPROFILE_SCOPE(OpenGL_ProgramLink);
     handle = LoadProgram(separable_program, shaders);
+    if (handle != 0) {
+        ProgramUsage.Add(0);
+    }
+}
+
+bool OGLProgram::CreateFromBinary(bool separable_program, GLenum binary_format,
+                                  std::span<const u8> binary) {
+    if (handle != 0)
+        return false;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceCreation);
+    handle = glCreateProgram();
+    ProgramUsage.Add(0);
+    if (separable_program) {
+        glProgramParameteri(handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    }
+    glProgramBinary(handle, binary_format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint link_status{};
+    glGetProgramiv(handle, GL_LINK_STATUS, &link_status);
+    return link_status != GL_FALSE;
 }
 
 void OGLProgram::Create(const char* vert_shader, const char* frag_shader) {
@@ -161,6 +233,7 @@ void OGLProgram::Release() {
     glDeleteProgram(handle);
     OpenGLState::GetCurState().ResetProgram(handle).Apply();
     handle = 0;
+    ProgramUsage.Remove(0);
 }
 
 void OGLPipeline::Create() {
@@ -199,6 +272,22 @@ void OGLBuffer::Release() {
     handle = 0;
 }
 
+void OGLSync::Create() {
+    if (handle != nullptr)
+        return;
+
+    handle = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void OGLSync::Release() {
+    if (handle == nullptr)
+        return;
+
+    MICROPROFILE_SCOPE(OpenGL_ResourceDeletion);
+    glDeleteSync(handle);
+    handle = nullptr;
+}
+
 void OGLVertexArray::Create() {
     if (handle != 0)
         return;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <span>
 #include <utility>
 #include <vector>
 #include <glad/glad.h>
@@ -40,7 +41,8 @@ class OGLTexture : private NonCopyable {
 public:
     OGLTexture() = default;
 
-    OGLTexture(OGLTexture&& o) noexcept : handle(std::exchange(o.handle, 0)) {}
+    OGLTexture(OGLTexture&& o) noexcept
+        : handle(std::exchange(o.handle, 0)), allocated_size(std::exchange(o.allocated_size, 0)) {}
 
     ~OGLTexture() {
         Release();
@@ -49,6 +51,7 @@ public:
     OGLTexture& operator=(OGLTexture&& o) noexcept {
         Release();
         handle = std::exchange(o.handle, 0);
+        allocated_size = std::exchange(o.allocated_size, 0);
         return *this;
     }
 
@@ -65,6 +68,8 @@ public:
                   GLsizei height);
 
     GLuint handle = 0;
+    /// Estimated video memory of the storage allocated with Allocate
+    std::size_t allocated_size = 0;
 };
 
 class OGLSampler : private NonCopyable {
@@ -137,6 +142,9 @@ public:
     /// Creates a new program from given shader soruce code
     void Create(const char* vert_shader, const char* frag_shader);
 
+    /// Creates a new program from a binary of the driver, returns false if the driver rejected it
+    bool CreateFromBinary(bool separable_program, GLenum binary_format, std::span<const u8> binary);
+
     /// Deletes the internal OpenGL resource
     void Release();
 
@@ -192,6 +200,31 @@ public:
     GLuint handle = 0;
 };
 
+class OGLSync : private NonCopyable {
+public:
+    OGLSync() = default;
+
+    OGLSync(OGLSync&& o) noexcept : handle(std::exchange(o.handle, nullptr)) {}
+
+    ~OGLSync() {
+        Release();
+    }
+
+    OGLSync& operator=(OGLSync&& o) noexcept {
+        Release();
+        handle = std::exchange(o.handle, nullptr);
+        return *this;
+    }
+
+    /// Inserts a new fence into the command stream and stores the handle
+    void Create();
+
+    /// Deletes the internal OpenGL resource
+    void Release();
+
+    GLsync handle = nullptr;
+};
+
 class OGLVertexArray : private NonCopyable {
 public:
     OGLVertexArray() = default;
@@ -0,0 +1,323 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <cryptopp/osrng.h>
+#include <cryptopp/pssr.h>
+#include <cryptopp/queue.h>
+#include <cryptopp/rsa.h>
+#include <cryptopp/sha.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "video_core/renderer_opengl/gl_shader_cache_package.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+
+namespace OpenGL {
+
+namespace {
+
+constexpr std::array<u8, 4> PackageMagic{'C', 'S', 'C', 'P'};
+constexpr u32 PackageVersion = 1;
+constexpr unsigned int KeySize = 3072;
+
+using Signer = CryptoPP::RSASS<CryptoPP::PSS, CryptoPP::SHA256>::Signer;
+using Verifier = CryptoPP::RSASS<CryptoPP::PSS, CryptoPP::SHA256>::Verifier;
+
+template <typename T>
+void Append(std::vector<u8>& data, const T& value) {
+    const auto bytes = reinterpret_cast<const u8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+/// Reads the values of a package in order, failing once one is out of bounds
+class Reader {
+public:
+    explicit Reader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    std::optional<std::span<const u8>> ReadBytes(u64 size) {
+        if (data.size() - offset < size) {
+            return std::nullopt;
+        }
+        const auto bytes = data.subspan(offset, static_cast<std::size_t>(size));
+        offset += static_cast<std::size_t>(size);
+        return bytes;
+    }
+
+    std::size_t Tell() const {
+        return offset;
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t offset = 0;
+};
+
+std::optional<std::vector<u8>> ReadFile(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        return std::nullopt;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+        return std::nullopt;
+    }
+    return data;
+}
+
+bool WriteFile(const std::string& path, std::span<const u8> data) {
+    // Written next to the destination first, so that an interrupted write leaves the old file
+    const std::string temp_path = path + ".tmp";
+    {
+        FileUtil::IOFile file(temp_path, "wb");
+        if (!file.IsOpen() || file.WriteBytes(data.data(), data.size()) != data.size()) {
+            return false;
+        }
+    }
+    return FileUtil::Rename(temp_path, path);
+}
+
+template <typename Key>
+std::vector<u8> EncodeKey(const Key& key) {
+    CryptoPP::ByteQueue queue;
+    key.Save(queue);
+    std::vector<u8> encoded(static_cast<std::size_t>(queue.MaxRetrievable()));
+    queue.Get(encoded.data(), encoded.size());
+    return encoded;
+}
+
+template <typename Key>
+Key DecodeKey(std::span<const u8> encoded) {
+    CryptoPP::ByteQueue queue;
+    queue.Put(encoded.data(), encoded.size());
+    queue.MessageEnd();
+    Key key;
+    key.Load(queue);
+    return key;
+}
+
+} // Anonymous namespace
+
+bool ShaderCachePackage::AddTitle(u64 program_id, const std::vector<u8>& transferable) {
+    const auto it = titles.find(program_id);
+    if (it == titles.end()) {
+        auto validated = ShaderDiskCache::MergeTransferable(std::span{&transferable, 1});
+        if (!validated) {
+            return false;
+        }
+        titles.emplace(program_id, std::move(*validated));
+        return true;
+    }
+    const std::array files{it->second, transferable};
+    auto merged = ShaderDiskCache::MergeTransferable(files);
+    if (!merged) {
+        return false;
+    }
+    it->second = std::move(*merged);
+    return true;
+}
+
+bool ShaderCachePackage::Merge(const ShaderCachePackage& other) {
+    bool merged_all = true;
+    for (const auto& [program_id, transferable] : other.titles) {
+        merged_all &= AddTitle(program_id, transferable);
+    }
+    return merged_all;
+}
+
+std::size_t ShaderCachePackage::AddInstalled(std::span<const u64> program_ids) {
+    std::vector<u64> installed(program_ids.begin(), program_ids.end());
+    if (installed.empty()) {
+        FileUtil::ForeachDirectoryEntry(
+            nullptr, ShaderDiskCache::GetTransferableDir(),
+            [&installed](u64*, const std::string&, const std::string& virtual_name) {
+                // The files are named after the program id, in hexadecimal
+                u64 program_id{};
+                const auto [end, error] = std::from_chars(
+                    virtual_name.data(), virtual_name.data() + virtual_name.size(), program_id, 16);
+                if (error == std::errc{} && std::string_view{end} == ".bin") {
+                    installed.push_back(program_id);
+                }
+                return true;
+            });
+    }
+
+    std::size_t added = 0;
+    for (const u64 program_id : installed) {
+        const std::string path = ShaderDiskCache::GetTransferablePath(program_id);
+        const auto transferable = ReadFile(path);
+        if (!transferable || !AddTitle(program_id, *transferable)) {
+            LOG_WARNING(Render_OpenGL, "Skipping invalid transferable shader cache {}", path);
+            continue;
+        }
+        ++added;
+    }
+    return added;
+}
+
+std::size_t ShaderCachePackage::Install() const {
+    std::size_t installed = 0;
+    for (const auto& [program_id, transferable] : titles) {
+        const std::string path = ShaderDiskCache::GetTransferablePath(program_id);
+        // The shaders the title already uses locally come first, caches of an older version of
+        // the emulator are replaced
+        std::vector<u8> contents = transferable;
+        if (const auto existing = ReadFile(path)) {
+            const std::array files{*existing, transferable};
+            if (auto merged = ShaderDiskCache::MergeTransferable(files)) {
+                contents = std::move(*merged);
+            }
+        }
+        if (!FileUtil::CreateFullPath(path) || !WriteFile(path, contents)) {
+            LOG_ERROR(Render_OpenGL, "Failed to install the shader cache to {}", path);
+            continue;
+        }
+        ++installed;
+    }
+    return installed;
+}
+
+bool ShaderCachePackage::Save(const std::string& path, std::span<const u8> private_key) const {
+    std::vector<u8> data;
+    Append(data, PackageMagic);
+    Append(data, PackageVersion);
+    Append(data, static_cast<u32>(titles.size()));
+    for (const auto& [program_id, transferable] : titles) {
+        Append(data, program_id);
+        Append(data, static_cast<u64>(transferable.size()));
+        data.insert(data.end(), transferable.begin(), transferable.end());
+    }
+
+    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> digest;
+    CryptoPP::SHA256().CalculateDigest(digest.data(), data.data(), data.size());
+    Append(data, digest);
+
+    std::vector<u8> signature;
+    if (!private_key.empty()) {
+        try {
+            const Signer signer{DecodeKey<CryptoPP::RSA::PrivateKey>(private_key)};
+            CryptoPP::AutoSeededRandomPool rng;
+            signature.resize(signer.MaxSignatureLength());
+            signature.resize(
+                signer.SignMessage(rng, data.data(), data.size(), signature.data()));
+        } catch (const CryptoPP::Exception& e) {
+            LOG_ERROR(Render_OpenGL, "Failed to sign the shader cache package: {}", e.what());
+            return false;
+        }
+    }
+    Append(data, static_cast<u32>(signature.size()));
+    data.insert(data.end(), signature.begin(), signature.end());
+
+    if (!FileUtil::CreateFullPath(path) || !WriteFile(path, data)) {
+        LOG_ERROR(Render_OpenGL, "Failed to write the shader cache package {}", path);
+        return false;
+    }
+    return true;
+}
+
+std::optional<ShaderCachePackage> ShaderCachePackage::Load(const std::string& path,
+                                                           std::span<const u8> public_key) {
+    const auto data = ReadFile(path);
+    if (!data) {
+        LOG_ERROR(Render_OpenGL, "Failed to read the shader cache package {}", path);
+        return std::nullopt;
+    }
+
+    Reader reader{*data};
+    std::array<u8, 4> magic{};
+    u32 version{};
+    u32 num_titles{};
+    if (!reader.Read(magic) || magic != PackageMagic || !reader.Read(version) ||
+        !reader.Read(num_titles)) {
+        LOG_ERROR(Render_OpenGL, "{} isn't a shader cache package", path);
+        return std::nullopt;
+    }
+    if (version != PackageVersion) {
+        LOG_ERROR(Render_OpenGL, "Shader cache package {} has the unsupported version {}", path,
+                  version);
+        return std::nullopt;
+    }
+
+    std::vector<std::pair<u64, std::span<const u8>>> contents;
+    for (u32 i = 0; i < num_titles; ++i) {
+        u64 program_id{};
+        u64 size{};
+        if (!reader.Read(program_id) || !reader.Read(size)) {
+            LOG_ERROR(Render_OpenGL, "Shader cache package {} is truncated", path);
+            return std::nullopt;
+        }
+        const auto transferable = reader.ReadBytes(size);
+        if (!transferable) {
+            LOG_ERROR(Render_OpenGL, "Shader cache package {} is truncated", path);
+            return std::nullopt;
+        }
+        contents.emplace_back(program_id, *transferable);
+    }
+
+    const std::size_t digest_offset = reader.Tell();
+    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> digest{};
+    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> expected_digest{};
+    u32 signature_size{};
+    if (!reader.Read(digest) || !reader.Read(signature_size)) {
+        LOG_ERROR(Render_OpenGL, "Shader cache package {} is truncated", path);
+        return std::nullopt;
+    }
+    const std::size_t signed_size = reader.Tell() - sizeof(signature_size);
+    const auto signature = reader.ReadBytes(signature_size);
+    CryptoPP::SHA256().CalculateDigest(expected_digest.data(), data->data(), digest_offset);
+    if (!signature || reader.Tell() != data->size() || digest != expected_digest) {
+        LOG_ERROR(Render_OpenGL, "Shader cache package {} is corrupted", path);
+        return std::nullopt;
+    }
+
+    if (!public_key.empty()) {
+        bool verified = false;
+        try {
+            const Verifier verifier{DecodeKey<CryptoPP::RSA::PublicKey>(public_key)};
+            verified = verifier.VerifyMessage(data->data(), signed_size, signature->data(),
+                                              signature->size());
+        } catch (const CryptoPP::Exception& e) {
+            LOG_ERROR(Render_OpenGL, "Failed to verify the shader cache package: {}", e.what());
+        }
+        if (!verified) {
+            LOG_ERROR(Render_OpenGL, "Shader cache package {} isn't signed with the given key",
+                      path);
+            return std::nullopt;
+        }
+    }
+
+    ShaderCachePackage package;
+    for (const auto& [program_id, transferable] : contents) {
+        if (!package.AddTitle(program_id, {transferable.begin(), transferable.end()})) {
+            LOG_ERROR(Render_OpenGL,
+                      "Shader cache package {} holds an invalid cache for title id={:016X}", path,
+                      program_id);
+            return std::nullopt;
+        }
+    }
+    return package;
+}
+
+std::pair<std::vector<u8>, std::vector<u8>> ShaderCachePackage::GenerateKeys() {
+    CryptoPP::AutoSeededRandomPool rng;
+    CryptoPP::RSA::PrivateKey private_key;
+    private_key.GenerateRandomWithKeySize(rng, KeySize);
+    const CryptoPP::RSA::PublicKey public_key{private_key};
+    return {EncodeKey(private_key), EncodeKey(public_key)};
+}
+
+} // namespace OpenGL
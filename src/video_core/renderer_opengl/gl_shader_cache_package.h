@@ -0,0 +1,79 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+
+namespace OpenGL {
+
+/**
+ * A bundle of the transferable shader caches of many titles, which can be generated ahead of time
+ * and shipped to new installs. Once installed, the shaders of a title are compiled on its next
+ * boot, before it starts running.
+ *
+ * Layout, little endian:
+ *  - magic "CSCP", format version and number of titles, as u32
+ *  - per title: program id and size as u64, followed by the contents of its transferable file
+ *  - SHA-256 of everything before it
+ *  - u32 size of the signature, and the RSA-PSS SHA-256 signature of everything before the size.
+ *    Unsigned packages have a signature of size 0.
+ */
+class ShaderCachePackage {
+public:
+    /**
+     * Adds the transferable cache of a title, merging it with the one the package already holds.
+     * @return false if the cache is invalid or from another version
+     */
+    bool AddTitle(u64 program_id, const std::vector<u8>& transferable);
+
+    /// Adds the titles of another package, merging the caches of titles both hold
+    bool Merge(const ShaderCachePackage& other);
+
+    /**
+     * Adds the transferable caches installed in the user directory.
+     * @param program_ids the titles to add, all installed titles if empty
+     * @return the number of titles added
+     */
+    std::size_t AddInstalled(std::span<const u64> program_ids = {});
+
+    /**
+     * Merges the caches into the transferable files of the user directory.
+     * @return the number of titles installed
+     */
+    std::size_t Install() const;
+
+    /**
+     * Writes the package.
+     * @param private_key DER encoded RSA private key to sign the package with, unsigned if empty
+     */
+    bool Save(const std::string& path, std::span<const u8> private_key = {}) const;
+
+    /**
+     * Reads a package and checks its digest.
+     * @param public_key DER encoded RSA public key the package must be signed with. The
+     * signature isn't checked if empty.
+     */
+    static std::optional<ShaderCachePackage> Load(const std::string& path,
+                                                  std::span<const u8> public_key = {});
+
+    /// Generates a private and a public key to sign packages with, DER encoded
+    static std::pair<std::vector<u8>, std::vector<u8>> GenerateKeys();
+
+    /// Returns the contents of the transferable file of every title, by program id
+    const std::map<u64, std::vector<u8>>& GetTitles() const {
+        return titles;
+    }
+
+private:
+    std::map<u64, std::vector<u8>> titles;
+};
+
+} // namespace OpenGL
@@ -268,10 +268,10 @@ public:
                   const Pica::Shader::ProgramCode& program_code,
                   const Pica::Shader::SwizzleData& swizzle_data, u32 main_offset,
                   const RegGetter& inputreg_getter, const RegGetter& outputreg_getter,
-                  bool sanitize_mul)
+                  bool sanitize_mul, bool is_gs)
         : subroutines(subroutines), program_code(program_code), swizzle_data(swizzle_data),
           main_offset(main_offset), inputreg_getter(inputreg_getter),
-          outputreg_getter(outputreg_getter), sanitize_mul(sanitize_mul) {
+          outputreg_getter(outputreg_getter), sanitize_mul(sanitize_mul), is_gs(is_gs) {
 
         Generate();
     }
@@ -360,6 +360,11 @@ private:
 
     /// Generates code representing a bool uniform
     std::string GetUniformBool(u32 index) const {
+        if (is_gs && index == 15) {
+            // The uniform b15 is set to true after every geometry shader invocation. Host
+            // invocations run independently, so derive it from the primitive index instead.
+            return "(uniforms.b[15] || gl_PrimitiveIDIn != 0)";
+        }
         return fmt::format("uniforms.b[{}]", index);
     }
 
@@ -781,10 +786,25 @@ private:
                 break;
             }
 
-            case OpCode::Id::EMIT:
-            case OpCode::Id::SETEMIT:
-                LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+            case OpCode::Id::EMIT: {
+                if (is_gs) {
+                    shader.AddLine("emit();");
+                } else {
+                    LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                }
                 break;
+            }
+
+            case OpCode::Id::SETEMIT: {
+                if (is_gs) {
+                    ASSERT(instr.setemit.vertex_id < 3);
+                    shader.AddLine("setemit({}u, {}, {});", instr.setemit.vertex_id.Value(),
+                                   instr.setemit.prim_emit != 0, instr.setemit.winding != 0);
+                } else {
+                    LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+                }
+                break;
+            }
 
             default: {
                 LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
@@ -916,6 +936,7 @@ private:
     const RegGetter& inputreg_getter;
     const RegGetter& outputreg_getter;
     const bool sanitize_mul;
+    const bool is_gs;
 
     ShaderWriter shader;
 };
@@ -937,12 +958,12 @@ std::optional<ProgramResult> DecompileProgram(const Pica::Shader::ProgramCode& p
                                               const Pica::Shader::SwizzleData& swizzle_data,
                                               u32 main_offset, const RegGetter& inputreg_getter,
                                               const RegGetter& outputreg_getter,
-                                              bool sanitize_mul) {
+                                              bool sanitize_mul, bool is_gs) {
 
     try {
         auto subroutines = ControlFlowAnalyzer(program_code, main_offset).MoveSubroutines();
         GLSLGenerator generator(subroutines, program_code, swizzle_data, main_offset,
-                                inputreg_getter, outputreg_getter, sanitize_mul);
+                                inputreg_getter, outputreg_getter, sanitize_mul, is_gs);
         return {ProgramResult{generator.MoveShaderCode()}};
     } catch (const DecompileFail& exception) {
         LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <fmt/format.h>
 
@@ -12,6 +13,7 @@
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
+#include "common/thread_pool.h"
 #include "common/zstd_compression.h"
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
@@ -33,6 +35,10 @@ enum class PrecompiledEntryKind : u32 {
 
 constexpr u32 NativeVersion = 1;
 
+// The compressed precompiled cache is written as a sequence of independent zstd frames of this
+// uncompressed size, so that it can be decompressed on multiple threads
+constexpr std::size_t PrecompiledChunkSize = 4 * 1024 * 1024;
+
 // The hash is based on relevant files. The list of files can be found at src/common/CMakeLists.txt
 // and CMakeModules/GenerateSCMRev.cmake
 ShaderCacheVersionHash GetShaderCacheVersionHash() {
@@ -202,9 +208,25 @@ ShaderDiskCache::LoadPrecompiledFile(FileUtil::IOFile& file, bool compressed) {
     std::vector<u8> precompiled_file(file.GetSize());
     file.ReadBytes(precompiled_file.data(), precompiled_file.size());
     if (compressed) {
-        const std::vector<u8> decompressed =
-            Common::Compression::DecompressDataZSTD(precompiled_file);
-        SaveArrayToPrecompiled(decompressed.data(), decompressed.size());
+        // Files from older versions hold a single frame, which simply loads on one thread
+        const auto frames = Common::Compression::SplitFramesZSTD(precompiled_file);
+        if (frames.empty()) {
+            return std::nullopt;
+        }
+
+        std::vector<std::vector<u8>> chunks(frames.size());
+        Common::TaskGroup group;
+        group.RunForEach(frames.size(), [&frames, &chunks](std::size_t i) {
+            chunks[i] = Common::Compression::DecompressFrameZSTD(frames[i]);
+        });
+        group.Wait();
+
+        for (const auto& chunk : chunks) {
+            if (chunk.empty()) {
+                return std::nullopt;
+            }
+            SaveArrayToPrecompiled(chunk.data(), chunk.size());
+        }
     } else {
         SaveArrayToPrecompiled(precompiled_file.data(), precompiled_file.size());
     }
@@ -369,6 +391,60 @@ void ShaderDiskCache::SaveRaw(const ShaderDiskCacheRaw& entry) {
     transferable.insert({id, entry});
 }
 
+std::optional<std::vector<u8>> ShaderDiskCache::MergeTransferable(
+    std::span<const std::vector<u8>> files) {
+    std::vector<u8> merged(sizeof(NativeVersion));
+    std::memcpy(merged.data(), &NativeVersion, sizeof(NativeVersion));
+    std::unordered_set<u64> identifiers;
+
+    for (const std::vector<u8>& file : files) {
+        std::size_t offset = 0;
+        // Reads a value at the offset, the entries are only copied once all their fields are read
+        const auto read = [&file, &offset]<typename T>(T& value) {
+            if (file.size() - offset < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, file.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        };
+        const auto skip_words = [&file, &offset](u64 count) {
+            if ((file.size() - offset) / sizeof(u32) < count) {
+                return false;
+            }
+            offset += static_cast<std::size_t>(count) * sizeof(u32);
+            return true;
+        };
+
+        u32 version{};
+        if (!read(version) || version != NativeVersion) {
+            return std::nullopt;
+        }
+        while (offset < file.size()) {
+            const std::size_t entry_begin = offset;
+            TransferableEntryKind kind{};
+            u64 unique_identifier{};
+            ProgramType program_type{};
+            u64 reg_array_len{};
+            if (!read(kind) || kind != TransferableEntryKind::Raw || !read(unique_identifier) ||
+                !read(program_type) || !read(reg_array_len) ||
+                reg_array_len > Pica::Regs::NUM_REGS || !skip_words(reg_array_len)) {
+                return std::nullopt;
+            }
+            if (program_type == ProgramType::VS) {
+                u64 code_len{};
+                if (!read(code_len) || !skip_words(code_len)) {
+                    return std::nullopt;
+                }
+            }
+            if (identifiers.insert(unique_identifier).second) {
+                merged.insert(merged.end(), file.begin() + entry_begin, file.begin() + offset);
+            }
+        }
+    }
+    return merged;
+}
+
 void ShaderDiskCache::SaveDecompiled(u64 unique_identifier,
                                      const ShaderDecompiler::ProgramResult& code,
                                      bool sanitize_mul) {
@@ -502,8 +578,6 @@ void ShaderDiskCache::SavePrecompiledHeaderToVirtualPrecompiledCache() {
 
 void ShaderDiskCache::SaveVirtualPrecompiledFile() {
     decompressed_precompiled_cache_offset = 0;
-    const std::vector<u8>& compressed = Common::Compression::CompressDataZSTDDefault(
-        decompressed_precompiled_cache.data(), decompressed_precompiled_cache.size());
 
     const auto precompiled_path{GetPrecompiledPath()};
     FileUtil::IOFile file(precompiled_path, "wb");
@@ -512,10 +586,18 @@ void ShaderDiskCache::SaveVirtualPrecompiledFile() {
         LOG_ERROR(Render_OpenGL, "Failed to open precompiled cache in path={}", precompiled_path);
         return;
     }
-    if (file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
-        LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache version in path={}",
-                  precompiled_path);
-        return;
+
+    const std::size_t size = decompressed_precompiled_cache.size();
+    for (std::size_t offset = 0; offset < size; offset += PrecompiledChunkSize) {
+        const std::vector<u8> compressed = Common::Compression::CompressDataZSTDDefault(
+            decompressed_precompiled_cache.data() + offset,
+            std::min(PrecompiledChunkSize, size - offset));
+        if (compressed.empty() ||
+            file.WriteBytes(compressed.data(), compressed.size()) != compressed.size()) {
+            LOG_ERROR(Render_OpenGL, "Failed to write precompiled cache in path={}",
+                      precompiled_path);
+            return;
+        }
     }
 }
 
@@ -537,11 +619,16 @@ std::string ShaderDiskCache::GetTransferablePath() {
     return FileUtil::SanitizePath(GetTransferableDir() + DIR_SEP_CHR + GetTitleID() + ".bin");
 }
 
+std::string ShaderDiskCache::GetTransferablePath(u64 program_id) {
+    return FileUtil::SanitizePath(fmt::format("{}{}{:016X}.bin", GetTransferableDir(), DIR_SEP_CHR,
+                                              program_id));
+}
+
 std::string ShaderDiskCache::GetPrecompiledPath() {
     return FileUtil::SanitizePath(GetPrecompiledShaderDir() + DIR_SEP_CHR + GetTitleID() + ".bin");
 }
 
-std::string ShaderDiskCache::GetTransferableDir() const {
+std::string ShaderDiskCache::GetTransferableDir() {
     return GetBaseDir() + DIR_SEP "transferable";
 }
 
@@ -556,7 +643,7 @@ std::string ShaderDiskCache::GetPrecompiledShaderDir() const {
     return GetPrecompiledDir() + DIR_SEP "conventional";
 }
 
-std::string ShaderDiskCache::GetBaseDir() const {
+std::string ShaderDiskCache::GetBaseDir() {
     return FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir) + DIR_SEP "opengl";
 }
 
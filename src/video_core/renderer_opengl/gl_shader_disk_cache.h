@@ -8,6 +8,7 @@
 #include <array>
 #include <bitset>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -121,6 +122,19 @@ public:
     /// Serializes virtual precompiled shader cache file to real file
     void SaveVirtualPrecompiledFile();
 
+    /// Get user's transferable directory path
+    static std::string GetTransferableDir();
+
+    /// Gets the path of the transferable file of a title
+    static std::string GetTransferablePath(u64 program_id);
+
+    /**
+     * Merges the contents of transferable files, keeping the first entry of every shader.
+     * @return empty if one of the files is invalid or from another version
+     */
+    static std::optional<std::vector<u8>> MergeTransferable(
+        std::span<const std::vector<u8>> files);
+
 private:
     /// Loads the transferable cache. Returns empty on failure.
     std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>> LoadPrecompiledFile(
@@ -156,16 +170,13 @@ private:
     /// Gets current game's precompiled file path
     std::string GetPrecompiledPath();
 
-    /// Get user's transferable directory path
-    std::string GetTransferableDir() const;
-
     /// Get user's precompiled directory path
     std::string GetPrecompiledDir() const;
 
     std::string GetPrecompiledShaderDir() const;
 
     /// Get user's shader directory path
-    std::string GetBaseDir() const;
+    static std::string GetBaseDir();
 
     /// Get current game's title id as u64
     u64 GetProgramID();
@@ -71,6 +71,33 @@ layout (std140) uniform shader_data {
 };
 )";
 
+constexpr std::string_view FragmentCommonFunctionsDef = R"(
+float byteround(float x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec2 byteround(vec2 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec3 byteround(vec3 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+vec4 byteround(vec4 x) {
+    return round(x * 255.0) * (1.0 / 255.0);
+}
+
+// PICA's LOD formula for 2D textures.
+// This LOD formula is the same as the LOD lower limit defined in OpenGL.
+// f(x, y) >= max{m_u, m_v, m_w}
+// (See OpenGL 4.6 spec, 8.14.1 - Scale Factor and Level-of-Detail)
+float getLod(vec2 coord) {
+    vec2 d = max(abs(dFdx(coord)), abs(dFdy(coord)));
+    return log2(max(d.x, d.y));
+}
+)";
+
 static std::string GetVertexInterfaceDeclaration(bool is_output, bool separable_shader) {
     std::string out;
 
@@ -289,6 +316,22 @@ void PicaGSConfigCommonRaw::Init(const Pica::Regs& regs) {
     }
 }
 
+void PicaGSConfigRaw::Init(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup) {
+    PicaShaderConfigCommon::Init(regs.gs, setup);
+    PicaGSConfigCommonRaw::Init(regs);
+
+    num_inputs = regs.gs.max_input_attribute_index + 1;
+    input_map.fill(16);
+
+    for (u32 attr = 0; attr < num_inputs; ++attr) {
+        input_map[regs.gs.GetRegisterForAttribute(attr)] = attr;
+    }
+
+    attributes_per_vertex = regs.pipeline.vs_outmap_total_minus_1_a + 1;
+
+    gs_output_attributes = num_outputs;
+}
+
 /// Detects if a TEV stage is configured to be skipped (to avoid generating unnecessary code)
 static bool IsPassThroughTevStage(const TevStageConfig& stage) {
     return (stage.color_op == TevStageConfig::Operation::Replace &&
@@ -1285,31 +1328,11 @@ float LookupLightingLUTSigned(int lut_index, float pos) {
     return LookupLightingLUT(lut_index, index, delta);
 }
 
-float byteround(float x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-vec2 byteround(vec2 x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-vec3 byteround(vec3 x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
+)";
 
-vec4 byteround(vec4 x) {
-    return round(x * 255.0) * (1.0 / 255.0);
-}
-
-// PICA's LOD formula for 2D textures.
-// This LOD formula is the same as the LOD lower limit defined in OpenGL.
-// f(x, y) >= max{m_u, m_v, m_w}
-// (See OpenGL 4.6 spec, 8.14.1 - Scale Factor and Level-of-Detail)
-float getLod(vec2 coord) {
-    vec2 d = max(abs(dFdx(coord)), abs(dFdy(coord)));
-    return log2(max(d.x, d.y));
-}
+    out += FragmentCommonFunctionsDef;
 
+    out += R"(
 uvec2 DecodeShadow(uint pixel) {
     return uvec2(pixel >> 8, pixel & 0xFFu);
 }
@@ -1583,6 +1606,280 @@ do {
     return {std::move(out)};
 }
 
+bool PicaFSConfig::IsUberShaderCompatible() const {
+    using TextureType = TexturingRegs::TextureConfig::TextureType;
+    // The uber shader only interprets the texture combiners and the per-fragment tests, the other
+    // features of the fragment pipeline always require a specialized shader.
+    return !GLES && !state.lighting.enable && !state.proctex.enable && !state.shadow_rendering &&
+           state.fog_mode != TexturingRegs::FogMode::Gas &&
+           state.texture0_type != TextureType::Shadow2D &&
+           state.texture0_type != TextureType::ShadowCube;
+}
+
+ShaderDecompiler::ProgramResult GenerateFragmentUberShader(bool separable_shader) {
+    std::string out;
+
+    if (separable_shader && !GLES) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    out += GetVertexInterfaceDeclaration(false, separable_shader);
+
+    out += R"(
+in vec4 gl_FragCoord;
+
+out vec4 color;
+
+uniform sampler2D tex0;
+uniform sampler2D tex1;
+uniform sampler2D tex2;
+uniform samplerCube tex_cube;
+uniform samplerBuffer texture_buffer_lut_lf;
+)";
+
+    out += UniformBlockDef;
+
+    out += R"(
+// The configuration of PicaFSConfig which is otherwise compiled into the shader
+uniform uvec4 tev_stage_config[NUM_TEV_STAGES]; // sources, modifiers, ops and scales
+uniform uint tev_combiner_buffer_input;
+uniform int alpha_test_func;
+uniform int scissor_test_mode;
+uniform int texture0_type;
+uniform bool texture2_use_coord1;
+uniform bool use_w_buffer;
+uniform int fog_mode;
+uniform bool fog_flip;
+)";
+
+    out += FragmentCommonFunctionsDef;
+
+    out += R"(
+vec4 rounded_primary_color;
+vec4 texture_color[3];
+vec4 combiner_buffer;
+vec4 next_combiner_buffer;
+vec4 last_tex_env_out;
+
+uint Field(uint value, uint offset, uint bits) {
+    return (value >> offset) & ((1u << bits) - 1u);
+}
+
+vec4 GetSource(uint source, int stage) {
+    switch (source) {
+    case 0u: return rounded_primary_color;
+    case 3u: return texture_color[0];
+    case 4u: return texture_color[1];
+    case 5u: return texture_color[2];
+    case 13u: return combiner_buffer;
+    case 14u: return const_color[stage];
+    case 15u: return last_tex_env_out;
+    }
+    // Fragment lighting and procedural textures are never handled by this shader
+    return vec4(0.0);
+}
+
+vec3 GetColorModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case 0u: return value.rgb;
+    case 1u: return vec3(1.0) - value.rgb;
+    case 2u: return value.aaa;
+    case 3u: return vec3(1.0) - value.aaa;
+    case 4u: return value.rrr;
+    case 5u: return vec3(1.0) - value.rrr;
+    case 8u: return value.ggg;
+    case 9u: return vec3(1.0) - value.ggg;
+    case 12u: return value.bbb;
+    case 13u: return vec3(1.0) - value.bbb;
+    }
+    return vec3(0.0);
+}
+
+float GetAlphaModifier(uint modifier, vec4 value) {
+    switch (modifier) {
+    case 0u: return value.a;
+    case 1u: return 1.0 - value.a;
+    case 2u: return value.r;
+    case 3u: return 1.0 - value.r;
+    case 4u: return value.g;
+    case 5u: return 1.0 - value.g;
+    case 6u: return value.b;
+    case 7u: return 1.0 - value.b;
+    }
+    return 0.0;
+}
+
+vec3 CombineColor(uint op, vec3 a, vec3 b, vec3 c) {
+    switch (op) {
+    case 0u: return clamp(a, vec3(0.0), vec3(1.0));
+    case 1u: return clamp(a * b, vec3(0.0), vec3(1.0));
+    case 2u: return clamp(a + b, vec3(0.0), vec3(1.0));
+    case 3u: return clamp(a + b - vec3(0.5), vec3(0.0), vec3(1.0));
+    case 4u: return clamp(a * c + b * (vec3(1.0) - c), vec3(0.0), vec3(1.0));
+    case 5u: return clamp(a - b, vec3(0.0), vec3(1.0));
+    case 6u:
+    case 7u: return clamp(vec3(dot(a - vec3(0.5), b - vec3(0.5)) * 4.0), vec3(0.0), vec3(1.0));
+    case 8u: return clamp(a * b + c, vec3(0.0), vec3(1.0));
+    case 9u: return clamp(min(a + b, vec3(1.0)) * c, vec3(0.0), vec3(1.0));
+    }
+    return vec3(0.0);
+}
+
+float CombineAlpha(uint op, float a, float b, float c) {
+    switch (op) {
+    case 0u: return clamp(a, 0.0, 1.0);
+    case 1u: return clamp(a * b, 0.0, 1.0);
+    case 2u: return clamp(a + b, 0.0, 1.0);
+    case 3u: return clamp(a + b - 0.5, 0.0, 1.0);
+    case 4u: return clamp(a * c + b * (1.0 - c), 0.0, 1.0);
+    case 5u: return clamp(a - b, 0.0, 1.0);
+    case 8u: return clamp(a * b + c, 0.0, 1.0);
+    case 9u: return clamp(min(a + b, 1.0) * c, 0.0, 1.0);
+    }
+    return 0.0;
+}
+
+float GetMultiplier(uint scale) {
+    return (scale < 3u) ? float(1u << scale) : 1.0;
+}
+
+void WriteTevStage(int index) {
+    uvec4 stage = tev_stage_config[index];
+    uint sources = stage.x;
+    uint modifiers = stage.y;
+    uint color_op = Field(stage.z, 0u, 4u);
+    uint alpha_op = Field(stage.z, 16u, 4u);
+    float color_multiplier = GetMultiplier(Field(stage.w, 0u, 2u));
+    float alpha_multiplier = GetMultiplier(Field(stage.w, 16u, 2u));
+
+    // Stages which pass the previous output through are skipped, as in the specialized shaders
+    bool pass_through = color_op == 0u && alpha_op == 0u && Field(sources, 0u, 4u) == 15u &&
+                        Field(sources, 16u, 4u) == 15u && Field(modifiers, 0u, 4u) == 0u &&
+                        Field(modifiers, 12u, 3u) == 0u && color_multiplier == 1.0 &&
+                        alpha_multiplier == 1.0;
+    if (!pass_through) {
+        vec3 color_results_1 = GetColorModifier(Field(modifiers, 0u, 4u),
+                                                GetSource(Field(sources, 0u, 4u), index));
+        vec3 color_results_2 = GetColorModifier(Field(modifiers, 4u, 4u),
+                                                GetSource(Field(sources, 4u, 4u), index));
+        vec3 color_results_3 = GetColorModifier(Field(modifiers, 8u, 4u),
+                                                GetSource(Field(sources, 8u, 4u), index));
+        vec3 color_output = byteround(CombineColor(color_op, color_results_1, color_results_2,
+                                                   color_results_3));
+
+        float alpha_output;
+        if (color_op == 7u) {
+            // result of Dot3_RGBA operation is also placed to the alpha component
+            alpha_output = color_output[0];
+        } else {
+            float alpha_results_1 = GetAlphaModifier(Field(modifiers, 12u, 3u),
+                                                     GetSource(Field(sources, 16u, 4u), index));
+            float alpha_results_2 = GetAlphaModifier(Field(modifiers, 16u, 3u),
+                                                     GetSource(Field(sources, 20u, 4u), index));
+            float alpha_results_3 = GetAlphaModifier(Field(modifiers, 20u, 3u),
+                                                     GetSource(Field(sources, 24u, 4u), index));
+            alpha_output = byteround(CombineAlpha(alpha_op, alpha_results_1, alpha_results_2,
+                                                  alpha_results_3));
+        }
+
+        last_tex_env_out = vec4(clamp(color_output * color_multiplier, vec3(0.0), vec3(1.0)),
+                                clamp(alpha_output * alpha_multiplier, 0.0, 1.0));
+    }
+
+    combiner_buffer = next_combiner_buffer;
+
+    if (index < 4) {
+        if (Field(tev_combiner_buffer_input, uint(index), 1u) != 0u)
+            next_combiner_buffer.rgb = last_tex_env_out.rgb;
+        if (Field(tev_combiner_buffer_input, uint(index) + 4u, 1u) != 0u)
+            next_combiner_buffer.a = last_tex_env_out.a;
+    }
+}
+
+bool AlphaTestFails(int alpha) {
+    switch (alpha_test_func) {
+    case 0: return true;
+    case 2: return alpha != alphatest_ref;
+    case 3: return alpha == alphatest_ref;
+    case 4: return alpha >= alphatest_ref;
+    case 5: return alpha > alphatest_ref;
+    case 6: return alpha <= alphatest_ref;
+    case 7: return alpha < alphatest_ref;
+    }
+    return false;
+}
+
+void main() {
+    rounded_primary_color = byteround(primary_color);
+
+    if (alpha_test_func == 0) {
+        discard;
+    }
+
+    if (scissor_test_mode != 0) {
+        bool inside = gl_FragCoord.x >= float(scissor_x1) && gl_FragCoord.y >= float(scissor_y1) &&
+                      gl_FragCoord.x < float(scissor_x2) && gl_FragCoord.y < float(scissor_y2);
+        // Include mode keeps the pixels inside of the box, exclude mode the ones outside of it
+        if (inside != (scissor_test_mode == 3)) {
+            discard;
+        }
+    }
+
+    float z_over_w = 2.0 * gl_FragCoord.z - 1.0;
+    float depth = z_over_w * depth_scale + depth_offset;
+    if (use_w_buffer) {
+        depth /= gl_FragCoord.w;
+    }
+
+    // Textures are sampled up front to keep the derivatives in uniform control flow
+    switch (texture0_type) {
+    case 0:
+        texture_color[0] = textureLod(tex0, texcoord0,
+                                      getLod(texcoord0 * vec2(textureSize(tex0, 0))));
+        break;
+    case 1:
+        texture_color[0] = texture(tex_cube, vec3(texcoord0, texcoord0_w));
+        break;
+    case 3:
+        texture_color[0] = textureProj(tex0, vec3(texcoord0, texcoord0_w));
+        break;
+    default:
+        texture_color[0] = vec4(0.0);
+        break;
+    }
+    texture_color[1] = textureLod(tex1, texcoord1, getLod(texcoord1 * vec2(textureSize(tex1, 0))));
+    vec2 coord2 = texture2_use_coord1 ? texcoord1 : texcoord2;
+    texture_color[2] = textureLod(tex2, coord2, getLod(coord2 * vec2(textureSize(tex2, 0))));
+
+    combiner_buffer = vec4(0.0);
+    next_combiner_buffer = tev_combiner_buffer_color;
+    last_tex_env_out = vec4(0.0);
+
+    for (int i = 0; i < NUM_TEV_STAGES; ++i) {
+        WriteTevStage(i);
+    }
+
+    if (AlphaTestFails(int(last_tex_env_out.a * 255.0))) {
+        discard;
+    }
+
+    if (fog_mode == 5) {
+        float fog_index = fog_flip ? (1.0 - depth) * 128.0 : depth * 128.0;
+        float fog_i = clamp(floor(fog_index), 0.0, 127.0);
+        float fog_f = fog_index - fog_i;
+        vec2 fog_lut_entry = texelFetch(texture_buffer_lut_lf, int(fog_i) + fog_lut_offset).rg;
+        float fog_factor = clamp(fog_lut_entry.r + fog_lut_entry.g * fog_f, 0.0, 1.0);
+        last_tex_env_out.rgb = mix(fog_color.rgb, last_tex_env_out.rgb, fog_factor);
+    }
+
+    gl_FragDepth = depth;
+    color = byteround(last_tex_env_out);
+}
+)";
+
+    return {std::move(out)};
+}
+
 ShaderDecompiler::ProgramResult GenerateTrivialVertexShader(bool separable_shader) {
     std::string out;
     if (separable_shader && !GLES) {
@@ -1652,7 +1949,7 @@ std::optional<ShaderDecompiler::ProgramResult> GenerateVertexShader(
 
     auto program_source_opt = ShaderDecompiler::DecompileProgram(
         setup.program_code, setup.swizzle_data, config.state.main_offset, get_input_reg,
-        get_output_reg, config.state.sanitize_mul);
+        get_output_reg, config.state.sanitize_mul, false);
 
     if (!program_source_opt)
         return std::nullopt;
@@ -1776,6 +2073,113 @@ void EmitPrim(Vertex vtx0, Vertex vtx1, Vertex vtx2) {
     return out;
 };
 
+std::optional<ShaderDecompiler::ProgramResult> GenerateGeometryShader(
+    const Pica::Shader::ShaderSetup& setup, const PicaGSConfig& config, bool separable_shader) {
+    std::string out;
+    if (separable_shader && !GLES) {
+        out += "#extension GL_ARB_separate_shader_objects : enable\n";
+    }
+
+    if (config.state.num_outputs == 0 ||
+        config.state.num_inputs % config.state.attributes_per_vertex != 0) {
+        return std::nullopt;
+    }
+
+    switch (config.state.num_inputs / config.state.attributes_per_vertex) {
+    case 1:
+        out += "layout(points) in;\n";
+        break;
+    case 2:
+        out += "layout(lines) in;\n";
+        break;
+    case 3:
+        out += "layout(triangles) in;\n";
+        break;
+    case 4:
+        out += "layout(lines_adjacency) in;\n";
+        break;
+    case 6:
+        out += "layout(triangles_adjacency) in;\n";
+        break;
+    default:
+        return std::nullopt;
+    }
+
+    // Primitives emitted past this limit are dropped by the host
+    out += "layout(triangle_strip, max_vertices = 30) out;\n\n";
+
+    out += GetGSCommonSource(config.state, separable_shader);
+
+    const auto get_input_reg = [&](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        const u32 attr = config.state.input_map[reg];
+        if (attr < config.state.num_inputs) {
+            return fmt::format("vs_out_attr{}[{}]", attr % config.state.attributes_per_vertex,
+                               attr / config.state.attributes_per_vertex);
+        }
+        return "vec4(0.0, 0.0, 0.0, 1.0)";
+    };
+
+    const auto get_output_reg = [&](u32 reg) -> std::string {
+        ASSERT(reg < 16);
+        const u32 attr = config.state.output_map[reg];
+        if (attr < config.state.num_outputs) {
+            return fmt::format("output_buffer.attributes[{}]", attr);
+        }
+        return "";
+    };
+
+    auto program_source_opt = ShaderDecompiler::DecompileProgram(
+        setup.program_code, setup.swizzle_data, config.state.main_offset, get_input_reg,
+        get_output_reg, config.state.sanitize_mul, true);
+
+    if (!program_source_opt)
+        return std::nullopt;
+
+    std::string& program_source = program_source_opt->code;
+
+    out += R"(
+Vertex output_buffer;
+Vertex prim_buffer[3];
+uint vertex_id = 0u;
+bool prim_emit = false;
+bool winding = false;
+
+void setemit(uint vertex_id_, bool prim_emit_, bool winding_) {
+    vertex_id = vertex_id_;
+    prim_emit = prim_emit_;
+    winding = winding_;
+}
+
+void emit() {
+    prim_buffer[vertex_id] = output_buffer;
+
+    if (prim_emit) {
+        if (winding) {
+            EmitPrim(prim_buffer[1], prim_buffer[0], prim_buffer[2]);
+        } else {
+            EmitPrim(prim_buffer[0], prim_buffer[1], prim_buffer[2]);
+        }
+    }
+}
+
+#define uniforms gs_uniforms
+layout (std140) uniform gs_config {
+    pica_uniforms uniforms;
+};
+
+void main() {
+)";
+    for (u32 i = 0; i < config.state.num_outputs; ++i) {
+        out += fmt::format("    output_buffer.attributes[{}] = vec4(0.0, 0.0, 0.0, 1.0);\n", i);
+    }
+    out += "\n    exec_shader();\n}\n\n";
+
+    out += program_source;
+
+    return {{std::move(out)}};
+}
+
 ShaderDecompiler::ProgramResult GenerateFixedGeometryShader(const PicaFixedGSConfig& config,
                                                             bool separable_shader) {
     std::string out;
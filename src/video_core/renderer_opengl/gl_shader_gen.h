@@ -139,6 +139,9 @@ struct PicaFSConfig : Common::HashableStruct<PicaFSConfigState> {
     bool TevStageUpdatesCombinerBufferAlpha(unsigned stage_index) const {
         return (stage_index < 4) && ((state.combiner_buffer_input >> 4) & (1 << stage_index));
     }
+
+    /// Returns true if the fragment uber shader can render with this configuration
+    bool IsUberShaderCompatible() const;
 };
 
 /**
@@ -197,6 +200,26 @@ struct PicaFixedGSConfig : Common::HashableStruct<PicaGSConfigCommonRaw> {
     }
 };
 
+struct PicaGSConfigRaw : PicaShaderConfigCommon, PicaGSConfigCommonRaw {
+    void Init(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup);
+
+    u32 num_inputs;
+    u32 attributes_per_vertex;
+
+    // input_map[input register index] -> input attribute index
+    std::array<u32, 16> input_map;
+};
+
+/**
+ * This struct contains information to identify a GL geometry shader generated from PICA geometry
+ * shader.
+ */
+struct PicaGSConfig : Common::HashableStruct<PicaGSConfigRaw> {
+    explicit PicaGSConfig(const Pica::Regs& regs, Pica::Shader::ShaderSetup& setup) {
+        state.Init(regs, setup);
+    }
+};
+
 /**
  * Generates the GLSL vertex shader program source code that accepts vertices from software shader
  * and directly passes them to the fragment shader.
@@ -212,6 +235,14 @@ ShaderDecompiler::ProgramResult GenerateTrivialVertexShader(bool separable_shade
 std::optional<ShaderDecompiler::ProgramResult> GenerateVertexShader(
     const Pica::Shader::ShaderSetup& setup, const PicaVSConfig& config, bool separable_shader);
 
+/**
+ * Generates the GLSL geometry shader program source code for the given GS program. Only the Point
+ * mode is supported, where each invocation reads the outputs of a fixed number of vertices.
+ * @returns String of the shader source code; std::nullopt on failure
+ */
+std::optional<ShaderDecompiler::ProgramResult> GenerateGeometryShader(
+    const Pica::Shader::ShaderSetup& setup, const PicaGSConfig& config, bool separable_shader);
+
 /*
  * Generates the GLSL fixed geometry shader program source code for non-GS PICA pipeline
  * @returns String of the shader source code
@@ -229,6 +260,15 @@ ShaderDecompiler::ProgramResult GenerateFixedGeometryShader(const PicaFixedGSCon
 ShaderDecompiler::ProgramResult GenerateFragmentShader(const PicaFSConfig& config,
                                                        bool separable_shader);
 
+/**
+ * Generates the GLSL source of a generic fragment shader, which reads the texture combiner and
+ * per-fragment test configuration from uniforms instead of compiling it in. It can stand in for
+ * any configuration that passes PicaFSConfig::IsUberShaderCompatible.
+ * @param separable_shader generates shader that can be used for separate shader object
+ * @returns String of the shader source code
+ */
+ShaderDecompiler::ProgramResult GenerateFragmentUberShader(bool separable_shader);
+
 } // namespace OpenGL
 
 namespace std {
@@ -246,6 +286,13 @@ struct hash<OpenGL::PicaVSConfig> {
     }
 };
 
+template <>
+struct hash<OpenGL::PicaGSConfig> {
+    std::size_t operator()(const OpenGL::PicaGSConfig& k) const noexcept {
+        return k.Hash();
+    }
+};
+
 template <>
 struct hash<OpenGL::PicaFixedGSConfig> {
     std::size_t operator()(const OpenGL::PicaFixedGSConfig& k) const noexcept {
@@ -3,10 +3,18 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <set>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <boost/variant.hpp>
+#include "common/settings.h"
+#include "common/thread.h"
+#include "common/thread_pool.h"
+#include "core/frontend/emu_window.h"
 #include "core/frontend/scope_acquire_context.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_shader_disk_cache.h"
@@ -40,16 +48,7 @@ static OGLProgram GeneratePrecompiledProgram(const ShaderDiskCacheDump& dump,
     }
 
     auto shader = OGLProgram();
-    shader.handle = glCreateProgram();
-    if (separable) {
-        glProgramParameteri(shader.handle, GL_PROGRAM_SEPARABLE, GL_TRUE);
-    }
-    glProgramBinary(shader.handle, dump.binary_format, dump.binary.data(),
-                    static_cast<GLsizei>(dump.binary.size()));
-
-    GLint link_status{};
-    glGetProgramiv(shader.handle, GL_LINK_STATUS, &link_status);
-    if (link_status == GL_FALSE) {
+    if (!shader.CreateFromBinary(separable, dump.binary_format, dump.binary)) {
         LOG_INFO(Render_OpenGL, "Precompiled cache rejected by the driver - removing");
         return {};
     }
@@ -103,6 +102,7 @@ static void SetShaderUniformBlockBindings(GLuint shader) {
     SetShaderUniformBlockBinding(shader, "shader_data", UniformBindings::Common,
                                  sizeof(UniformData));
     SetShaderUniformBlockBinding(shader, "vs_config", UniformBindings::VS, sizeof(VSUniformData));
+    SetShaderUniformBlockBinding(shader, "gs_config", UniformBindings::GS, sizeof(GSUniformData));
 }
 
 static void SetShaderSamplerBinding(GLuint shader, const char* name,
@@ -242,6 +242,12 @@ public:
         return {cached_shader.GetHandle(), std::move(result)};
     }
 
+    /// Returns the handle of the cached shader for the config, or 0 if it hasn't been built yet
+    GLuint Find(const KeyConfigType& config) const {
+        const auto iter = shaders.find(config);
+        return iter != shaders.end() ? iter->second.GetHandle() : 0;
+    }
+
     void Inject(const KeyConfigType& key, OGLProgram&& program) {
         OGLShaderStage stage{separable};
         stage.Inject(std::move(program));
@@ -252,6 +258,10 @@ public:
         shaders.emplace(key, std::move(stage));
     }
 
+    std::size_t Size() const {
+        return shaders.size();
+    }
+
 private:
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage> shaders;
@@ -313,6 +323,11 @@ public:
         shader_map.insert_or_assign(key, &cached_shader);
     }
 
+    /// Returns the number of distinct shaders, configs sharing the same code are counted once
+    std::size_t Size() const {
+        return shader_cache.size();
+    }
+
 private:
     bool separable;
     std::unordered_map<KeyConfigType, OGLShaderStage*> shader_map;
@@ -322,19 +337,200 @@ private:
 using ProgrammableVertexShaders =
     ShaderDoubleCache<PicaVSConfig, &GenerateVertexShader, GL_VERTEX_SHADER>;
 
+using ProgrammableGeometryShaders =
+    ShaderDoubleCache<PicaGSConfig, &GenerateGeometryShader, GL_GEOMETRY_SHADER>;
+
 using FixedGeometryShaders =
     ShaderCache<PicaFixedGSConfig, &GenerateFixedGeometryShader, GL_GEOMETRY_SHADER>;
 
 using FragmentShaders = ShaderCache<PicaFSConfig, &GenerateFragmentShader, GL_FRAGMENT_SHADER>;
 
+/**
+ * Builds separable fragment shader programs on a thread with its own shared context. The
+ * programs are only linked by the worker; the uniform and sampler bindings, which go through
+ * the global OpenGLState, are set up once they are handed back to the render thread.
+ */
+class AsyncFragmentCompiler {
+public:
+    struct Result {
+        PicaFSConfig config;
+        u64 unique_identifier;
+        ShaderDecompiler::ProgramResult code;
+        OGLProgram program;
+    };
+
+    explicit AsyncFragmentCompiler(std::unique_ptr<Frontend::GraphicsContext> context_)
+        : context{std::move(context_)} {
+        thread = std::thread{&AsyncFragmentCompiler::WorkerLoop, this};
+    }
+
+    ~AsyncFragmentCompiler() {
+        {
+            std::scoped_lock lock{mutex};
+            stop = true;
+        }
+        cv.notify_one();
+        thread.join();
+    }
+
+    AsyncFragmentCompiler(const AsyncFragmentCompiler&) = delete;
+    AsyncFragmentCompiler& operator=(const AsyncFragmentCompiler&) = delete;
+
+    /// Queues a fragment shader configuration to be built in the background
+    void Queue(const PicaFSConfig& config, u64 unique_identifier) {
+        {
+            std::scoped_lock lock{mutex};
+            jobs.push_back({config, unique_identifier});
+        }
+        cv.notify_one();
+    }
+
+    /// Returns the programs that finished building since the last call
+    std::vector<Result> Collect() {
+        std::scoped_lock lock{mutex};
+        return std::exchange(done, {});
+    }
+
+private:
+    struct Job {
+        PicaFSConfig config;
+        u64 unique_identifier;
+    };
+
+    void WorkerLoop() {
+        Common::SetCurrentThreadName("ShaderCompiler");
+        Frontend::ScopeAcquireContext scope{*context};
+
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock{mutex};
+                cv.wait(lock, [this] { return stop || !jobs.empty(); });
+                if (stop) {
+                    break;
+                }
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            Result result{job.config, job.unique_identifier,
+                          GenerateFragmentShader(job.config, true), {}};
+            OGLShader shader;
+            shader.Create(result.code.code.c_str(), GL_FRAGMENT_SHADER);
+            result.program.Create(true, {shader.handle});
+            // Make sure the program is complete before it is used from the other context
+            glFinish();
+
+            std::scoped_lock lock{mutex};
+            done.push_back(std::move(result));
+        }
+    }
+
+    std::unique_ptr<Frontend::GraphicsContext> context;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Job> jobs;
+    std::vector<Result> done;
+    bool stop = false;
+};
+
+/**
+ * The fragment uber shader, which is bound while the specialized shader of a configuration is
+ * built asynchronously. Its uniforms mirror the parts of PicaFSConfig it interprets.
+ */
+class FragmentUberShader {
+public:
+    FragmentUberShader() : stage(true) {
+        stage.Create(GenerateFragmentUberShader(true).code.c_str(), GL_FRAGMENT_SHADER);
+        const GLuint handle = stage.GetHandle();
+        uniform_tev_stage_config = glGetUniformLocation(handle, "tev_stage_config");
+        uniform_tev_combiner_buffer_input =
+            glGetUniformLocation(handle, "tev_combiner_buffer_input");
+        uniform_alpha_test_func = glGetUniformLocation(handle, "alpha_test_func");
+        uniform_scissor_test_mode = glGetUniformLocation(handle, "scissor_test_mode");
+        uniform_texture0_type = glGetUniformLocation(handle, "texture0_type");
+        uniform_texture2_use_coord1 = glGetUniformLocation(handle, "texture2_use_coord1");
+        uniform_use_w_buffer = glGetUniformLocation(handle, "use_w_buffer");
+        uniform_fog_mode = glGetUniformLocation(handle, "fog_mode");
+        uniform_fog_flip = glGetUniformLocation(handle, "fog_flip");
+    }
+
+    /// Uploads the configuration to the uber shader and returns its handle
+    GLuint Use(const PicaFSConfig& config) {
+        const GLuint handle = stage.GetHandle();
+        const u64 config_hash = config.Hash();
+        if (config_hash == current_config_hash) {
+            return handle;
+        }
+        current_config_hash = config_hash;
+
+        const auto& state = config.state;
+        std::array<GLuint, 4 * 6> tev_stage_config;
+        for (std::size_t i = 0; i < state.tev_stages.size(); ++i) {
+            const TevStageConfigRaw& tev_stage = state.tev_stages[i];
+            tev_stage_config[i * 4 + 0] = tev_stage.sources_raw;
+            tev_stage_config[i * 4 + 1] = tev_stage.modifiers_raw;
+            tev_stage_config[i * 4 + 2] = tev_stage.ops_raw;
+            tev_stage_config[i * 4 + 3] = tev_stage.scales_raw;
+        }
+        glProgramUniform4uiv(handle, uniform_tev_stage_config,
+                             static_cast<GLsizei>(state.tev_stages.size()),
+                             tev_stage_config.data());
+        glProgramUniform1ui(handle, uniform_tev_combiner_buffer_input,
+                            state.combiner_buffer_input);
+        glProgramUniform1i(handle, uniform_alpha_test_func,
+                           static_cast<GLint>(state.alpha_test_func));
+        glProgramUniform1i(handle, uniform_scissor_test_mode,
+                           static_cast<GLint>(state.scissor_test_mode));
+        glProgramUniform1i(handle, uniform_texture0_type, static_cast<GLint>(state.texture0_type));
+        glProgramUniform1i(handle, uniform_texture2_use_coord1, state.texture2_use_coord1);
+        glProgramUniform1i(handle, uniform_use_w_buffer,
+                           state.depthmap_enable ==
+                               Pica::RasterizerRegs::DepthBuffering::WBuffering);
+        glProgramUniform1i(handle, uniform_fog_mode, static_cast<GLint>(state.fog_mode));
+        glProgramUniform1i(handle, uniform_fog_flip, state.fog_flip);
+        return handle;
+    }
+
+private:
+    OGLShaderStage stage;
+    u64 current_config_hash = 0;
+
+    GLint uniform_tev_stage_config = -1;
+    GLint uniform_tev_combiner_buffer_input = -1;
+    GLint uniform_alpha_test_func = -1;
+    GLint uniform_scissor_test_mode = -1;
+    GLint uniform_texture0_type = -1;
+    GLint uniform_texture2_use_coord1 = -1;
+    GLint uniform_use_w_buffer = -1;
+    GLint uniform_fog_mode = -1;
+    GLint uniform_fog_flip = -1;
+};
+
 class ShaderProgramManager::Impl {
 public:
-    explicit Impl(bool separable, bool is_amd)
+    explicit Impl(Frontend::EmuWindow& emu_window, bool separable, bool is_amd)
         : is_amd(is_amd), separable(separable), programmable_vertex_shaders(separable),
-          trivial_vertex_shader(separable), fixed_geometry_shaders(separable),
-          fragment_shaders(separable), disk_cache(separable) {
+          trivial_vertex_shader(separable), programmable_geometry_shaders(separable),
+          fixed_geometry_shaders(separable), fragment_shaders(separable), disk_cache(separable) {
         if (separable)
             pipeline.Create();
+
+        // The uber shader relies on separable programs to be swapped in and out of the pipeline
+        if (separable && Settings::values.async_shader_compilation.GetValue()) {
+            emu_window.SaveContext();
+            auto context = emu_window.CreateSharedContext();
+            if (context) {
+                // Release the context, so it can be immediately used by the compiler thread
+                context->DoneCurrent();
+                fragment_compiler = std::make_unique<AsyncFragmentCompiler>(std::move(context));
+            }
+            emu_window.RestoreContext();
+            if (fragment_compiler) {
+                fragment_uber_shader.emplace();
+            }
+        }
     }
 
     struct ShaderTuple {
@@ -367,21 +563,27 @@ public:
     bool separable;
 
     ShaderTuple current;
+    ShaderTuple bound; ///< Stages currently attached to the separable pipeline
 
     ProgrammableVertexShaders programmable_vertex_shaders;
     TrivialVertexShader trivial_vertex_shader;
 
+    ProgrammableGeometryShaders programmable_geometry_shaders;
     FixedGeometryShaders fixed_geometry_shaders;
 
     FragmentShaders fragment_shaders;
     std::unordered_map<u64, OGLProgram> program_cache;
     OGLPipeline pipeline;
     ShaderDiskCache disk_cache;
+
+    std::optional<FragmentUberShader> fragment_uber_shader;
+    std::unordered_set<PicaFSConfig> pending_fragment_shaders;
+    std::unique_ptr<AsyncFragmentCompiler> fragment_compiler;
 };
 
 ShaderProgramManager::ShaderProgramManager(Frontend::EmuWindow& emu_window_, bool separable,
                                            bool is_amd)
-    : impl(std::make_unique<Impl>(separable, is_amd)), emu_window{emu_window_} {}
+    : impl(std::make_unique<Impl>(emu_window_, separable, is_amd)), emu_window{emu_window_} {}
 
 ShaderProgramManager::~ShaderProgramManager() = default;
 
@@ -414,6 +616,19 @@ void ShaderProgramManager::UseTrivialVertexShader() {
     impl->current.vs_hash = 0;
 }
 
+bool ShaderProgramManager::UseProgrammableGeometryShader(const Pica::Regs& regs,
+                                                         Pica::Shader::ShaderSetup& setup) {
+    // Geometry shaders are not saved to the disk cache, they are rare enough to be decompiled
+    // on first use
+    PicaGSConfig config{regs, setup};
+    auto [handle, _] = impl->programmable_geometry_shaders.Get(config, setup);
+    if (handle == 0)
+        return false;
+    impl->current.gs = handle;
+    impl->current.gs_hash = config.Hash();
+    return true;
+}
+
 void ShaderProgramManager::UseFixedGeometryShader(const Pica::Regs& regs) {
     PicaFixedGSConfig gs_config(regs);
     auto [handle, _] = impl->fixed_geometry_shaders.Get(gs_config);
@@ -428,6 +643,31 @@ void ShaderProgramManager::UseTrivialGeometryShader() {
 
 void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
     PicaFSConfig config = PicaFSConfig::BuildFromRegs(regs);
+
+    if (impl->fragment_compiler) {
+        for (auto& built : impl->fragment_compiler->Collect()) {
+            impl->pending_fragment_shaders.erase(built.config);
+            if (built.program.handle == 0) {
+                // Leave it to the synchronous path, which reports the failure on next use
+                continue;
+            }
+            impl->fragment_shaders.Inject(built.config, std::move(built.program));
+            impl->disk_cache.SaveDecompiled(built.unique_identifier, built.code, false);
+        }
+
+        if (impl->fragment_shaders.Find(config) == 0 && config.IsUberShaderCompatible()) {
+            if (impl->pending_fragment_shaders.insert(config).second) {
+                const u64 unique_identifier = GetUniqueIdentifier(regs, {});
+                impl->disk_cache.SaveRaw(ShaderDiskCacheRaw{unique_identifier, ProgramType::FS,
+                                                            regs, {}});
+                impl->fragment_compiler->Queue(config, unique_identifier);
+            }
+            impl->current.fs = impl->fragment_uber_shader->Use(config);
+            impl->current.fs_hash = config.Hash();
+            return;
+        }
+    }
+
     auto [handle, result] = impl->fragment_shaders.Get(config);
     impl->current.fs = handle;
     impl->current.fs_hash = config.Hash();
@@ -443,18 +683,31 @@ void ShaderProgramManager::UseFragmentShader(const Pica::Regs& regs) {
 
 void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     if (impl->separable) {
-        if (impl->is_amd) {
-            // Without this reseting, AMD sometimes freezes when one stage is changed but not
-            // for the others. On the other hand, including this reset seems to introduce memory
-            // leak in Intel Graphics.
-            glUseProgramStages(
-                impl->pipeline.handle,
-                GL_VERTEX_SHADER_BIT | GL_GEOMETRY_SHADER_BIT | GL_FRAGMENT_SHADER_BIT, 0);
-        }
+        // Only touch the pipeline when a stage changed, each call makes the driver revalidate it
+        const auto& current = impl->current;
+        auto& bound = impl->bound;
+        if (current != bound) {
+            if (impl->is_amd) {
+                // Without this reseting, AMD sometimes freezes when one stage is changed but not
+                // for the others. On the other hand, including this reset seems to introduce
+                // memory leak in Intel Graphics.
+                glUseProgramStages(
+                    impl->pipeline.handle,
+                    GL_VERTEX_SHADER_BIT | GL_GEOMETRY_SHADER_BIT | GL_FRAGMENT_SHADER_BIT, 0);
+                bound = {};
+            }
 
-        glUseProgramStages(impl->pipeline.handle, GL_VERTEX_SHADER_BIT, impl->current.vs);
-        glUseProgramStages(impl->pipeline.handle, GL_GEOMETRY_SHADER_BIT, impl->current.gs);
-        glUseProgramStages(impl->pipeline.handle, GL_FRAGMENT_SHADER_BIT, impl->current.fs);
+            if (current.vs != bound.vs) {
+                glUseProgramStages(impl->pipeline.handle, GL_VERTEX_SHADER_BIT, current.vs);
+            }
+            if (current.gs != bound.gs) {
+                glUseProgramStages(impl->pipeline.handle, GL_GEOMETRY_SHADER_BIT, current.gs);
+            }
+            if (current.fs != bound.fs) {
+                glUseProgramStages(impl->pipeline.handle, GL_FRAGMENT_SHADER_BIT, current.fs);
+            }
+            bound = current;
+        }
         state.draw.shader_program = 0;
         state.draw.program_pipeline = impl->pipeline.handle;
     } else {
@@ -473,6 +726,11 @@ void ShaderProgramManager::ApplyTo(OpenGLState& state) {
     }
 }
 
+std::size_t ShaderProgramManager::GetShaderCount() const {
+    return impl->programmable_vertex_shaders.Size() + impl->programmable_geometry_shaders.Size() +
+           impl->fixed_geometry_shaders.Size() + impl->fragment_shaders.Size();
+}
+
 void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     auto& disk_cache = impl->disk_cache;
@@ -502,11 +760,41 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         callback(VideoCore::LoadCallbackStage::Decompile, 0, raws.size());
     }
     std::vector<std::size_t> load_raws_index;
+
+    // Splits the range [0, count) across one task per worker of the shared pool, each with a
+    // shared context
+    const auto RunOnWorkers = [&](std::size_t count, const auto& func) {
+        const std::size_t num_workers{Common::ThreadPool::Shared().GetWorkerCount()};
+        const std::size_t bucket_size{count / num_workers};
+        std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_workers);
+        Common::TaskGroup group;
+
+        emu_window.SaveContext();
+        for (std::size_t i = 0; i < num_workers; ++i) {
+            const bool is_last_worker = i + 1 == num_workers;
+            const std::size_t start{bucket_size * i};
+            const std::size_t end{is_last_worker ? count : start + bucket_size};
+
+            // On some platforms the shared context has to be created from the GUI thread
+            contexts[i] = emu_window.CreateSharedContext();
+            // Release the context, so it can be immediately used by the worker
+            contexts[i]->DoneCurrent();
+            group.Run([&func, context = contexts[i].get(), start, end] {
+                func(context, start, end);
+            });
+        }
+        group.Wait();
+        emu_window.RestoreContext();
+    };
+
+    std::size_t loaded_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
     // Loads both decompiled and precompiled shaders from the cache. If either one is missing for
-    const auto LoadPrecompiledShader = [&](std::size_t begin, std::size_t end,
-                                           const std::vector<ShaderDiskCacheRaw>& raw_cache,
-                                           const ShaderDecompiledMap& decompiled_map,
-                                           const ShaderDumpsMap& dump_map) {
+    const auto LoadPrecompiledShader = [&](Frontend::GraphicsContext* context, std::size_t begin,
+                                           std::size_t end) {
+        Frontend::ScopeAcquireContext scope(*context);
+        const std::vector<ShaderDiskCacheRaw>& raw_cache = raws;
+        const ShaderDecompiledMap& decompiled_map = decompiled;
+        const ShaderDumpsMap& dump_map = dumps;
         for (std::size_t i = begin; i < end; ++i) {
             if (stop_loading || compilation_failed) {
                 return;
@@ -521,6 +809,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                           "Invalid hash in entry={:016x} (obtained hash={:016x}) - removing "
                           "shader cache",
                           raw.GetUniqueIdentifier(), calculated_hash);
+                std::scoped_lock lock(mutex);
                 disk_cache.InvalidateAll();
                 return;
             }
@@ -571,7 +860,9 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                 load_raws_index.push_back(i);
             }
             if (callback) {
-                callback(VideoCore::LoadCallbackStage::Decompile, i, raw_cache.size());
+                std::scoped_lock lock(mutex);
+                callback(VideoCore::LoadCallbackStage::Decompile, ++loaded_shaders,
+                         raw_cache.size());
             }
         }
     };
@@ -610,7 +901,8 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     };
 
     if (impl->separable) {
-        LoadPrecompiledShader(0, raws.size(), raws, decompiled, dumps);
+        // Each program binary is loaded on one of the worker contexts
+        RunOnWorkers(raws.size(), LoadPrecompiledShader);
     } else {
         LoadPrecompiledProgram(decompiled, dumps);
     }
@@ -700,27 +992,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
         }
     };
 
-    const std::size_t num_workers{std::max(1U, std::thread::hardware_concurrency())};
-    const std::size_t bucket_size{load_raws_size / num_workers};
-    std::vector<std::unique_ptr<Frontend::GraphicsContext>> contexts(num_workers);
-    std::vector<std::thread> threads(num_workers);
-
-    emu_window.SaveContext();
-    for (std::size_t i = 0; i < num_workers; ++i) {
-        const bool is_last_worker = i + 1 == num_workers;
-        const std::size_t start{bucket_size * i};
-        const std::size_t end{is_last_worker ? load_raws_size : start + bucket_size};
-
-        // On some platforms the shared context has to be created from the GUI thread
-        contexts[i] = emu_window.CreateSharedContext();
-        // Release the context, so it can be immediately used by the spawned thread
-        contexts[i]->DoneCurrent();
-        threads[i] = std::thread(LoadRawSepareble, contexts[i].get(), start, end);
-    }
-    for (auto& thread : threads) {
-        thread.join();
-    }
-    emu_window.RestoreContext();
+    RunOnWorkers(load_raws_size, LoadRawSepareble);
 
     if (compilation_failed) {
         disk_cache.InvalidateAll();
@@ -103,6 +103,14 @@ static_assert(sizeof(VSUniformData) == 1856,
 static_assert(sizeof(VSUniformData) < 16384,
               "VSUniformData structure must be less than 16kb as per the OpenGL spec");
 
+struct GSUniformData {
+    PicaUniformsData uniforms;
+};
+static_assert(sizeof(GSUniformData) == 1856,
+              "The size of the GSUniformData does not match the structure in the shader");
+static_assert(sizeof(GSUniformData) < 16384,
+              "GSUniformData structure must be less than 16kb as per the OpenGL spec");
+
 class OpenGLState;
 
 /// A class that manage different shader stages and configures them with given config data.
@@ -118,6 +126,8 @@ public:
 
     void UseTrivialVertexShader();
 
+    bool UseProgrammableGeometryShader(const Pica::Regs& config, Pica::Shader::ShaderSetup& setup);
+
     void UseFixedGeometryShader(const Pica::Regs& regs);
 
     void UseTrivialGeometryShader();
@@ -126,6 +136,9 @@ public:
 
     void ApplyTo(OpenGLState& state);
 
+    /// Returns the number of shaders built from Pica configurations, including the loaded ones
+    std::size_t GetShaderCount() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
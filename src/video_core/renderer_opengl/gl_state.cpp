@@ -11,6 +11,7 @@
 namespace OpenGL {
 
 OpenGLState OpenGLState::cur_state;
+OpenGLState::Statistics OpenGLState::statistics;
 
 OpenGLState::OpenGLState() {
     // These all match default OpenGL values
@@ -95,251 +96,277 @@ OpenGLState::OpenGLState() {
 }
 
 void OpenGLState::Apply() const {
+    // Counts the block and returns whether it needs to be applied
+    const auto IsChanged = [](bool changed) {
+        ++(changed ? statistics.changed_blocks : statistics.unchanged_blocks);
+        return changed;
+    };
+
     // Culling
-    if (cull.enabled != cur_state.cull.enabled) {
-        if (cull.enabled) {
-            glEnable(GL_CULL_FACE);
-        } else {
-            glDisable(GL_CULL_FACE);
+    if (IsChanged(cull != cur_state.cull)) {
+        if (cull.enabled != cur_state.cull.enabled) {
+            if (cull.enabled) {
+                glEnable(GL_CULL_FACE);
+            } else {
+                glDisable(GL_CULL_FACE);
+            }
         }
-    }
 
-    if (cull.mode != cur_state.cull.mode) {
-        glCullFace(cull.mode);
-    }
+        if (cull.mode != cur_state.cull.mode) {
+            glCullFace(cull.mode);
+        }
 
-    if (cull.front_face != cur_state.cull.front_face) {
-        glFrontFace(cull.front_face);
+        if (cull.front_face != cur_state.cull.front_face) {
+            glFrontFace(cull.front_face);
+        }
     }
 
     // Depth test
-    if (depth.test_enabled != cur_state.depth.test_enabled) {
-        if (depth.test_enabled) {
-            glEnable(GL_DEPTH_TEST);
-        } else {
-            glDisable(GL_DEPTH_TEST);
+    if (IsChanged(depth != cur_state.depth)) {
+        if (depth.test_enabled != cur_state.depth.test_enabled) {
+            if (depth.test_enabled) {
+                glEnable(GL_DEPTH_TEST);
+            } else {
+                glDisable(GL_DEPTH_TEST);
+            }
         }
-    }
 
-    if (depth.test_func != cur_state.depth.test_func) {
-        glDepthFunc(depth.test_func);
-    }
+        if (depth.test_func != cur_state.depth.test_func) {
+            glDepthFunc(depth.test_func);
+        }
 
-    // Depth mask
-    if (depth.write_mask != cur_state.depth.write_mask) {
-        glDepthMask(depth.write_mask);
+        // Depth mask
+        if (depth.write_mask != cur_state.depth.write_mask) {
+            glDepthMask(depth.write_mask);
+        }
     }
 
     // Color mask
-    if (color_mask.red_enabled != cur_state.color_mask.red_enabled ||
-        color_mask.green_enabled != cur_state.color_mask.green_enabled ||
-        color_mask.blue_enabled != cur_state.color_mask.blue_enabled ||
-        color_mask.alpha_enabled != cur_state.color_mask.alpha_enabled) {
+    if (IsChanged(color_mask != cur_state.color_mask)) {
         glColorMask(color_mask.red_enabled, color_mask.green_enabled, color_mask.blue_enabled,
                     color_mask.alpha_enabled);
     }
 
     // Stencil test
-    if (stencil.test_enabled != cur_state.stencil.test_enabled) {
-        if (stencil.test_enabled) {
-            glEnable(GL_STENCIL_TEST);
-        } else {
-            glDisable(GL_STENCIL_TEST);
+    if (IsChanged(stencil != cur_state.stencil)) {
+        if (stencil.test_enabled != cur_state.stencil.test_enabled) {
+            if (stencil.test_enabled) {
+                glEnable(GL_STENCIL_TEST);
+            } else {
+                glDisable(GL_STENCIL_TEST);
+            }
         }
-    }
 
-    if (stencil.test_func != cur_state.stencil.test_func ||
-        stencil.test_ref != cur_state.stencil.test_ref ||
-        stencil.test_mask != cur_state.stencil.test_mask) {
-        glStencilFunc(stencil.test_func, stencil.test_ref, stencil.test_mask);
-    }
+        if (stencil.test_func != cur_state.stencil.test_func ||
+            stencil.test_ref != cur_state.stencil.test_ref ||
+            stencil.test_mask != cur_state.stencil.test_mask) {
+            glStencilFunc(stencil.test_func, stencil.test_ref, stencil.test_mask);
+        }
 
-    if (stencil.action_depth_fail != cur_state.stencil.action_depth_fail ||
-        stencil.action_depth_pass != cur_state.stencil.action_depth_pass ||
-        stencil.action_stencil_fail != cur_state.stencil.action_stencil_fail) {
-        glStencilOp(stencil.action_stencil_fail, stencil.action_depth_fail,
-                    stencil.action_depth_pass);
-    }
+        if (stencil.action_depth_fail != cur_state.stencil.action_depth_fail ||
+            stencil.action_depth_pass != cur_state.stencil.action_depth_pass ||
+            stencil.action_stencil_fail != cur_state.stencil.action_stencil_fail) {
+            glStencilOp(stencil.action_stencil_fail, stencil.action_depth_fail,
+                        stencil.action_depth_pass);
+        }
 
-    // Stencil mask
-    if (stencil.write_mask != cur_state.stencil.write_mask) {
-        glStencilMask(stencil.write_mask);
+        // Stencil mask
+        if (stencil.write_mask != cur_state.stencil.write_mask) {
+            glStencilMask(stencil.write_mask);
+        }
     }
 
     // Blending
-    if (blend.enabled != cur_state.blend.enabled) {
-        if (blend.enabled) {
-            glEnable(GL_BLEND);
-        } else {
-            glDisable(GL_BLEND);
-        }
-
-        // GLES does not support glLogicOp
-        if (!GLES) {
+    if (IsChanged(blend != cur_state.blend)) {
+        if (blend.enabled != cur_state.blend.enabled) {
             if (blend.enabled) {
-                glDisable(GL_COLOR_LOGIC_OP);
+                glEnable(GL_BLEND);
             } else {
-                glEnable(GL_COLOR_LOGIC_OP);
+                glDisable(GL_BLEND);
+            }
+
+            // GLES does not support glLogicOp
+            if (!GLES) {
+                if (blend.enabled) {
+                    glDisable(GL_COLOR_LOGIC_OP);
+                } else {
+                    glEnable(GL_COLOR_LOGIC_OP);
+                }
             }
         }
-    }
 
-    if (blend.color.red != cur_state.blend.color.red ||
-        blend.color.green != cur_state.blend.color.green ||
-        blend.color.blue != cur_state.blend.color.blue ||
-        blend.color.alpha != cur_state.blend.color.alpha) {
-        glBlendColor(blend.color.red, blend.color.green, blend.color.blue, blend.color.alpha);
-    }
+        if (blend.color != cur_state.blend.color) {
+            glBlendColor(blend.color.red, blend.color.green, blend.color.blue,
+                         blend.color.alpha);
+        }
 
-    if (blend.src_rgb_func != cur_state.blend.src_rgb_func ||
-        blend.dst_rgb_func != cur_state.blend.dst_rgb_func ||
-        blend.src_a_func != cur_state.blend.src_a_func ||
-        blend.dst_a_func != cur_state.blend.dst_a_func) {
-        glBlendFuncSeparate(blend.src_rgb_func, blend.dst_rgb_func, blend.src_a_func,
-                            blend.dst_a_func);
-    }
+        if (blend.src_rgb_func != cur_state.blend.src_rgb_func ||
+            blend.dst_rgb_func != cur_state.blend.dst_rgb_func ||
+            blend.src_a_func != cur_state.blend.src_a_func ||
+            blend.dst_a_func != cur_state.blend.dst_a_func) {
+            glBlendFuncSeparate(blend.src_rgb_func, blend.dst_rgb_func, blend.src_a_func,
+                                blend.dst_a_func);
+        }
 
-    if (blend.rgb_equation != cur_state.blend.rgb_equation ||
-        blend.a_equation != cur_state.blend.a_equation) {
-        glBlendEquationSeparate(blend.rgb_equation, blend.a_equation);
+        if (blend.rgb_equation != cur_state.blend.rgb_equation ||
+            blend.a_equation != cur_state.blend.a_equation) {
+            glBlendEquationSeparate(blend.rgb_equation, blend.a_equation);
+        }
     }
 
     // GLES does not support glLogicOp
     if (!GLES) {
-        if (logic_op != cur_state.logic_op) {
+        if (IsChanged(logic_op != cur_state.logic_op)) {
             glLogicOp(logic_op);
         }
     }
 
     // Textures
-    for (u32 i = 0; i < texture_units.size(); ++i) {
-        if (texture_units[i].texture_2d != cur_state.texture_units[i].texture_2d) {
-            glActiveTexture(TextureUnits::PicaTexture(i).Enum());
-            glBindTexture(GL_TEXTURE_2D, texture_units[i].texture_2d);
-        }
-        if (texture_units[i].sampler != cur_state.texture_units[i].sampler) {
-            glBindSampler(i, texture_units[i].sampler);
+    if (IsChanged(texture_units != cur_state.texture_units)) {
+        for (u32 i = 0; i < texture_units.size(); ++i) {
+            if (texture_units[i].texture_2d != cur_state.texture_units[i].texture_2d) {
+                glActiveTexture(TextureUnits::PicaTexture(i).Enum());
+                glBindTexture(GL_TEXTURE_2D, texture_units[i].texture_2d);
+            }
+            if (texture_units[i].sampler != cur_state.texture_units[i].sampler) {
+                glBindSampler(i, texture_units[i].sampler);
+            }
         }
     }
 
-    if (texture_cube_unit.texture_cube != cur_state.texture_cube_unit.texture_cube) {
-        glActiveTexture(TextureUnits::TextureCube.Enum());
-        glBindTexture(GL_TEXTURE_CUBE_MAP, texture_cube_unit.texture_cube);
-    }
-    if (texture_cube_unit.sampler != cur_state.texture_cube_unit.sampler) {
-        glBindSampler(TextureUnits::TextureCube.id, texture_cube_unit.sampler);
+    if (IsChanged(texture_cube_unit != cur_state.texture_cube_unit)) {
+        if (texture_cube_unit.texture_cube != cur_state.texture_cube_unit.texture_cube) {
+            glActiveTexture(TextureUnits::TextureCube.Enum());
+            glBindTexture(GL_TEXTURE_CUBE_MAP, texture_cube_unit.texture_cube);
+        }
+        if (texture_cube_unit.sampler != cur_state.texture_cube_unit.sampler) {
+            glBindSampler(TextureUnits::TextureCube.id, texture_cube_unit.sampler);
+        }
     }
 
     // Texture buffer LUTs
-    if (texture_buffer_lut_lf.texture_buffer != cur_state.texture_buffer_lut_lf.texture_buffer) {
-        glActiveTexture(TextureUnits::TextureBufferLUT_LF.Enum());
-        glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_lf.texture_buffer);
-    }
+    if (IsChanged(texture_buffer_lut_lf != cur_state.texture_buffer_lut_lf ||
+                  texture_buffer_lut_rg != cur_state.texture_buffer_lut_rg ||
+                  texture_buffer_lut_rgba != cur_state.texture_buffer_lut_rgba)) {
+        if (texture_buffer_lut_lf != cur_state.texture_buffer_lut_lf) {
+            glActiveTexture(TextureUnits::TextureBufferLUT_LF.Enum());
+            glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_lf.texture_buffer);
+        }
 
-    // Texture buffer LUTs
-    if (texture_buffer_lut_rg.texture_buffer != cur_state.texture_buffer_lut_rg.texture_buffer) {
-        glActiveTexture(TextureUnits::TextureBufferLUT_RG.Enum());
-        glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_rg.texture_buffer);
-    }
+        if (texture_buffer_lut_rg != cur_state.texture_buffer_lut_rg) {
+            glActiveTexture(TextureUnits::TextureBufferLUT_RG.Enum());
+            glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_rg.texture_buffer);
+        }
 
-    // Texture buffer LUTs
-    if (texture_buffer_lut_rgba.texture_buffer !=
-        cur_state.texture_buffer_lut_rgba.texture_buffer) {
-        glActiveTexture(TextureUnits::TextureBufferLUT_RGBA.Enum());
-        glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_rgba.texture_buffer);
+        if (texture_buffer_lut_rgba != cur_state.texture_buffer_lut_rgba) {
+            glActiveTexture(TextureUnits::TextureBufferLUT_RGBA.Enum());
+            glBindTexture(GL_TEXTURE_BUFFER, texture_buffer_lut_rgba.texture_buffer);
+        }
     }
 
     // Shadow Images
-    if (image_shadow_buffer != cur_state.image_shadow_buffer) {
-        glBindImageTexture(ImageUnits::ShadowBuffer, image_shadow_buffer, 0, GL_FALSE, 0,
-                           GL_READ_WRITE, GL_R32UI);
-    }
+    if (IsChanged(image_shadow_buffer != cur_state.image_shadow_buffer ||
+                  image_shadow_texture_px != cur_state.image_shadow_texture_px ||
+                  image_shadow_texture_nx != cur_state.image_shadow_texture_nx ||
+                  image_shadow_texture_py != cur_state.image_shadow_texture_py ||
+                  image_shadow_texture_ny != cur_state.image_shadow_texture_ny ||
+                  image_shadow_texture_pz != cur_state.image_shadow_texture_pz ||
+                  image_shadow_texture_nz != cur_state.image_shadow_texture_nz)) {
+        if (image_shadow_buffer != cur_state.image_shadow_buffer) {
+            glBindImageTexture(ImageUnits::ShadowBuffer, image_shadow_buffer, 0, GL_FALSE, 0,
+                               GL_READ_WRITE, GL_R32UI);
+        }
 
-    if (image_shadow_texture_px != cur_state.image_shadow_texture_px) {
-        glBindImageTexture(ImageUnits::ShadowTexturePX, image_shadow_texture_px, 0, GL_FALSE, 0,
-                           GL_READ_ONLY, GL_R32UI);
-    }
+        if (image_shadow_texture_px != cur_state.image_shadow_texture_px) {
+            glBindImageTexture(ImageUnits::ShadowTexturePX, image_shadow_texture_px, 0, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_R32UI);
+        }
 
-    if (image_shadow_texture_nx != cur_state.image_shadow_texture_nx) {
-        glBindImageTexture(ImageUnits::ShadowTextureNX, image_shadow_texture_nx, 0, GL_FALSE, 0,
-                           GL_READ_ONLY, GL_R32UI);
-    }
+        if (image_shadow_texture_nx != cur_state.image_shadow_texture_nx) {
+            glBindImageTexture(ImageUnits::ShadowTextureNX, image_shadow_texture_nx, 0, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_R32UI);
+        }
 
-    if (image_shadow_texture_py != cur_state.image_shadow_texture_py) {
-        glBindImageTexture(ImageUnits::ShadowTexturePY, image_shadow_texture_py, 0, GL_FALSE, 0,
-                           GL_READ_ONLY, GL_R32UI);
-    }
+        if (image_shadow_texture_py != cur_state.image_shadow_texture_py) {
+            glBindImageTexture(ImageUnits::ShadowTexturePY, image_shadow_texture_py, 0, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_R32UI);
+        }
 
-    if (image_shadow_texture_ny != cur_state.image_shadow_texture_ny) {
-        glBindImageTexture(ImageUnits::ShadowTextureNY, image_shadow_texture_ny, 0, GL_FALSE, 0,
-                           GL_READ_ONLY, GL_R32UI);
-    }
+        if (image_shadow_texture_ny != cur_state.image_shadow_texture_ny) {
+            glBindImageTexture(ImageUnits::ShadowTextureNY, image_shadow_texture_ny, 0, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_R32UI);
+        }
 
-    if (image_shadow_texture_pz != cur_state.image_shadow_texture_pz) {
-        glBindImageTexture(ImageUnits::ShadowTexturePZ, image_shadow_texture_pz, 0, GL_FALSE, 0,
-                           GL_READ_ONLY, GL_R32UI);
-    }
+        if (image_shadow_texture_pz != cur_state.image_shadow_texture_pz) {
+            glBindImageTexture(ImageUnits::ShadowTexturePZ, image_shadow_texture_pz, 0, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_R32UI);
+        }
 
-    if (image_shadow_texture_nz != cur_state.image_shadow_texture_nz) {
-        glBindImageTexture(ImageUnits::ShadowTextureNZ, image_shadow_texture_nz, 0, GL_FALSE, 0,
-                           GL_READ_ONLY, GL_R32UI);
+        if (image_shadow_texture_nz != cur_state.image_shadow_texture_nz) {
+            glBindImageTexture(ImageUnits::ShadowTextureNZ, image_shadow_texture_nz, 0, GL_FALSE, 0,
+                               GL_READ_ONLY, GL_R32UI);
+        }
     }
 
-    // Framebuffer
-    if (draw.read_framebuffer != cur_state.draw.read_framebuffer) {
-        glBindFramebuffer(GL_READ_FRAMEBUFFER, draw.read_framebuffer);
-    }
-    if (draw.draw_framebuffer != cur_state.draw.draw_framebuffer) {
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw.draw_framebuffer);
-    }
+    if (IsChanged(draw != cur_state.draw)) {
+        // Framebuffer
+        if (draw.read_framebuffer != cur_state.draw.read_framebuffer) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, draw.read_framebuffer);
+        }
+        if (draw.draw_framebuffer != cur_state.draw.draw_framebuffer) {
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw.draw_framebuffer);
+        }
 
-    // Vertex array
-    if (draw.vertex_array != cur_state.draw.vertex_array) {
-        glBindVertexArray(draw.vertex_array);
-    }
+        // Vertex array
+        if (draw.vertex_array != cur_state.draw.vertex_array) {
+            glBindVertexArray(draw.vertex_array);
+        }
 
-    // Vertex buffer
-    if (draw.vertex_buffer != cur_state.draw.vertex_buffer) {
-        glBindBuffer(GL_ARRAY_BUFFER, draw.vertex_buffer);
-    }
+        // Vertex buffer
+        if (draw.vertex_buffer != cur_state.draw.vertex_buffer) {
+            glBindBuffer(GL_ARRAY_BUFFER, draw.vertex_buffer);
+        }
 
-    // Uniform buffer
-    if (draw.uniform_buffer != cur_state.draw.uniform_buffer) {
-        glBindBuffer(GL_UNIFORM_BUFFER, draw.uniform_buffer);
-    }
+        // Uniform buffer
+        if (draw.uniform_buffer != cur_state.draw.uniform_buffer) {
+            glBindBuffer(GL_UNIFORM_BUFFER, draw.uniform_buffer);
+        }
 
-    // Shader program
-    if (draw.shader_program != cur_state.draw.shader_program) {
-        glUseProgram(draw.shader_program);
-    }
+        // Shader program
+        if (draw.shader_program != cur_state.draw.shader_program) {
+            glUseProgram(draw.shader_program);
+        }
 
-    // Program pipeline
-    if (draw.program_pipeline != cur_state.draw.program_pipeline) {
-        glBindProgramPipeline(draw.program_pipeline);
+        // Program pipeline
+        if (draw.program_pipeline != cur_state.draw.program_pipeline) {
+            glBindProgramPipeline(draw.program_pipeline);
+        }
     }
 
     // Scissor test
-    if (scissor.enabled != cur_state.scissor.enabled) {
-        if (scissor.enabled) {
-            glEnable(GL_SCISSOR_TEST);
-        } else {
-            glDisable(GL_SCISSOR_TEST);
+    if (IsChanged(scissor != cur_state.scissor)) {
+        if (scissor.enabled != cur_state.scissor.enabled) {
+            if (scissor.enabled) {
+                glEnable(GL_SCISSOR_TEST);
+            } else {
+                glDisable(GL_SCISSOR_TEST);
+            }
         }
-    }
 
-    if (scissor.x != cur_state.scissor.x || scissor.y != cur_state.scissor.y ||
-        scissor.width != cur_state.scissor.width || scissor.height != cur_state.scissor.height) {
-        glScissor(scissor.x, scissor.y, scissor.width, scissor.height);
+        if (scissor.x != cur_state.scissor.x || scissor.y != cur_state.scissor.y ||
+            scissor.width != cur_state.scissor.width ||
+            scissor.height != cur_state.scissor.height) {
+            glScissor(scissor.x, scissor.y, scissor.width, scissor.height);
+        }
     }
 
-    if (viewport.x != cur_state.viewport.x || viewport.y != cur_state.viewport.y ||
-        viewport.width != cur_state.viewport.width ||
-        viewport.height != cur_state.viewport.height) {
+    if (IsChanged(viewport != cur_state.viewport)) {
         glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
     }
 
     // Clip distance
-    if (!GLES || GLAD_GL_EXT_clip_cull_distance) {
+    if ((!GLES || GLAD_GL_EXT_clip_cull_distance) &&
+        IsChanged(clip_distance != cur_state.clip_distance)) {
         for (size_t i = 0; i < clip_distance.size(); ++i) {
             if (clip_distance[i] != cur_state.clip_distance[i]) {
                 if (clip_distance[i]) {
@@ -351,7 +378,7 @@ void OpenGLState::Apply() const {
         }
     }
 
-    if (renderbuffer != cur_state.renderbuffer) {
+    if (IsChanged(renderbuffer != cur_state.renderbuffer)) {
         glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
     }
 
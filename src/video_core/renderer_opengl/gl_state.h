@@ -6,6 +6,7 @@
 
 #include <array>
 #include <glad/glad.h>
+#include "common/common_types.h"
 
 namespace OpenGL {
 
@@ -39,28 +40,44 @@ constexpr GLuint ShadowTexturePZ = 5;
 constexpr GLuint ShadowTextureNZ = 6;
 } // namespace ImageUnits
 
+/**
+ * The state is made of blocks that are compared as a whole, so applying a state that is mostly
+ * unchanged only compares a few blocks rather than every field.
+ */
 class OpenGLState {
 public:
-    struct {
+    /// How many blocks Apply changed and how many were already set, since the program started
+    struct Statistics {
+        u64 changed_blocks = 0;
+        u64 unchanged_blocks = 0;
+    };
+
+    struct CullState {
         bool enabled;      // GL_CULL_FACE
         GLenum mode;       // GL_CULL_FACE_MODE
         GLenum front_face; // GL_FRONT_FACE
+
+        bool operator==(const CullState&) const = default;
     } cull;
 
-    struct {
+    struct DepthState {
         bool test_enabled;    // GL_DEPTH_TEST
         GLenum test_func;     // GL_DEPTH_FUNC
         GLboolean write_mask; // GL_DEPTH_WRITEMASK
+
+        bool operator==(const DepthState&) const = default;
     } depth;
 
-    struct {
+    struct ColorMaskState {
         GLboolean red_enabled;
         GLboolean green_enabled;
         GLboolean blue_enabled;
         GLboolean alpha_enabled;
+
+        bool operator==(const ColorMaskState&) const = default;
     } color_mask; // GL_COLOR_WRITEMASK
 
-    struct {
+    struct StencilState {
         bool test_enabled;          // GL_STENCIL_TEST
         GLenum test_func;           // GL_STENCIL_FUNC
         GLint test_ref;             // GL_STENCIL_REF
@@ -69,9 +86,11 @@ public:
         GLenum action_stencil_fail; // GL_STENCIL_FAIL
         GLenum action_depth_fail;   // GL_STENCIL_PASS_DEPTH_FAIL
         GLenum action_depth_pass;   // GL_STENCIL_PASS_DEPTH_PASS
+
+        bool operator==(const StencilState&) const = default;
     } stencil;
 
-    struct {
+    struct BlendState {
         bool enabled;        // GL_BLEND
         GLenum rgb_equation; // GL_BLEND_EQUATION_RGB
         GLenum a_equation;   // GL_BLEND_EQUATION_ALPHA
@@ -80,12 +99,16 @@ public:
         GLenum src_a_func;   // GL_BLEND_SRC_ALPHA
         GLenum dst_a_func;   // GL_BLEND_DST_ALPHA
 
-        struct {
+        struct BlendColor {
             GLclampf red;
             GLclampf green;
             GLclampf blue;
             GLclampf alpha;
+
+            bool operator==(const BlendColor&) const = default;
         } color; // GL_BLEND_COLOR
+
+        bool operator==(const BlendState&) const = default;
     } blend;
 
     GLenum logic_op; // GL_LOGIC_OP_MODE
@@ -94,25 +117,26 @@ public:
     struct TextureUnit {
         GLuint texture_2d; // GL_TEXTURE_BINDING_2D
         GLuint sampler;    // GL_SAMPLER_BINDING
+
+        bool operator==(const TextureUnit&) const = default;
     };
     std::array<TextureUnit, 3> texture_units;
 
-    struct {
+    struct TextureCubeUnit {
         GLuint texture_cube; // GL_TEXTURE_BINDING_CUBE_MAP
         GLuint sampler;      // GL_SAMPLER_BINDING
-    } texture_cube_unit;
 
-    struct {
-        GLuint texture_buffer; // GL_TEXTURE_BINDING_BUFFER
-    } texture_buffer_lut_lf;
+        bool operator==(const TextureCubeUnit&) const = default;
+    } texture_cube_unit;
 
-    struct {
+    struct TextureBufferUnit {
         GLuint texture_buffer; // GL_TEXTURE_BINDING_BUFFER
-    } texture_buffer_lut_rg;
 
-    struct {
-        GLuint texture_buffer; // GL_TEXTURE_BINDING_BUFFER
-    } texture_buffer_lut_rgba;
+        bool operator==(const TextureBufferUnit&) const = default;
+    };
+    TextureBufferUnit texture_buffer_lut_lf;
+    TextureBufferUnit texture_buffer_lut_rg;
+    TextureBufferUnit texture_buffer_lut_rgba;
 
     // GL_IMAGE_BINDING_NAME
     GLuint image_shadow_buffer;
@@ -123,7 +147,7 @@ public:
     GLuint image_shadow_texture_pz;
     GLuint image_shadow_texture_nz;
 
-    struct {
+    struct DrawState {
         GLuint read_framebuffer; // GL_READ_FRAMEBUFFER_BINDING
         GLuint draw_framebuffer; // GL_DRAW_FRAMEBUFFER_BINDING
         GLuint vertex_array;     // GL_VERTEX_ARRAY_BINDING
@@ -131,21 +155,27 @@ public:
         GLuint uniform_buffer;   // GL_UNIFORM_BUFFER_BINDING
         GLuint shader_program;   // GL_CURRENT_PROGRAM
         GLuint program_pipeline; // GL_PROGRAM_PIPELINE_BINDING
+
+        bool operator==(const DrawState&) const = default;
     } draw;
 
-    struct {
+    struct ScissorState {
         bool enabled; // GL_SCISSOR_TEST
         GLint x;
         GLint y;
         GLsizei width;
         GLsizei height;
+
+        bool operator==(const ScissorState&) const = default;
     } scissor;
 
-    struct {
+    struct ViewportState {
         GLint x;
         GLint y;
         GLsizei width;
         GLsizei height;
+
+        bool operator==(const ViewportState&) const = default;
     } viewport;
 
     std::array<bool, 2> clip_distance; // GL_CLIP_DISTANCE
@@ -162,6 +192,10 @@ public:
     /// Apply this state as the current OpenGL state
     void Apply() const;
 
+    static Statistics GetStatistics() {
+        return statistics;
+    }
+
     /// Resets any references to the given resource
     OpenGLState& ResetTexture(GLuint handle);
     OpenGLState& ResetSampler(GLuint handle);
@@ -174,6 +208,7 @@ public:
 
 private:
     static OpenGLState cur_state;
+    static Statistics statistics;
 };
 
 } // namespace OpenGL
@@ -0,0 +1,168 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/scope_exit.h"
+#include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_texture_decoder.h"
+
+namespace OpenGL {
+
+constexpr std::string_view vs_source = R"(
+const vec2 vertices[4] =
+    vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main() {
+    gl_Position = vec4(vertices[gl_VertexID], 0.0, 1.0);
+}
+)";
+
+// Mirrors LookupTexelInTile and SampleETC1Subtile. Each 64-bit block of the guest data is fetched
+// as an (low, high) pair of words.
+constexpr std::string_view fs_source = R"(
+precision highp int;
+
+out lowp vec4 frag_color;
+
+uniform highp usamplerBuffer data;
+uniform mediump ivec2 src_offset;
+uniform mediump ivec2 dst_offset;
+uniform mediump ivec2 surface_size;
+uniform bool has_alpha;
+
+const int modifier_table[16] =
+    int[16](2, 8, 5, 17, 9, 29, 13, 42, 18, 60, 24, 80, 33, 106, 47, 183);
+
+uint Convert5To8(int value) {
+    uint v = uint(value) & 0xFFu;
+    return ((v << 3) | (v >> 2)) & 0xFFu;
+}
+
+int SignExtend3(uint value) {
+    return int(value) - ((value & 4u) != 0u ? 8 : 0);
+}
+
+void main() {
+    ivec2 coord = ivec2(gl_FragCoord.xy) - dst_offset + src_offset;
+    // Guest textures are stored upside down with respect to OpenGL
+    int x = coord.x;
+    int y = surface_size.y - 1 - coord.y;
+
+    int tile_words = has_alpha ? 8 : 4;
+    int tile = (y / 8) * (surface_size.x / 8) + x / 8;
+    int fine_x = x % 8;
+    int fine_y = y % 8;
+    int subtile = fine_x / 4 + 2 * (fine_y / 4);
+    int block = tile * tile_words + subtile * (has_alpha ? 2 : 1);
+
+    uint sx = uint(fine_x % 4);
+    uint sy = uint(fine_y % 4);
+    uint texel = 4u * sx + sy;
+
+    uint alpha = 255u;
+    if (has_alpha) {
+        uvec2 packed_alpha = texelFetch(data, block).xy;
+        uint shift = 4u * texel;
+        uint nibble = ((shift < 32u ? packed_alpha.x >> shift : packed_alpha.y >> (shift - 32u)) &
+                       0xFu);
+        alpha = nibble * 17u;
+        block += 1;
+    }
+
+    uvec2 value = texelFetch(data, block).xy;
+    uint lo = value.x;
+    uint hi = value.y;
+
+    bool flip = (hi & 1u) != 0u;
+    bool differential = (hi & 2u) != 0u;
+    bool second_half = (flip ? sy : sx) >= 2u;
+
+    ivec3 base;
+    if (differential) {
+        ivec3 color = ivec3((hi >> 27) & 0x1Fu, (hi >> 19) & 0x1Fu, (hi >> 11) & 0x1Fu);
+        if (second_half) {
+            color += ivec3(SignExtend3((hi >> 24) & 7u), SignExtend3((hi >> 16) & 7u),
+                           SignExtend3((hi >> 8) & 7u));
+        }
+        base = ivec3(Convert5To8(color.r), Convert5To8(color.g), Convert5To8(color.b));
+    } else if (!second_half) {
+        base = ivec3((hi >> 28) & 0xFu, (hi >> 20) & 0xFu, (hi >> 12) & 0xFu) * 17;
+    } else {
+        base = ivec3((hi >> 24) & 0xFu, (hi >> 16) & 0xFu, (hi >> 8) & 0xFu) * 17;
+    }
+
+    uint table_index = second_half ? ((hi >> 2) & 7u) : ((hi >> 5) & 7u);
+    uint subindex = (lo >> texel) & 1u;
+    int modifier = modifier_table[table_index * 2u + subindex];
+    if (((lo >> (16u + texel)) & 1u) != 0u) {
+        modifier = -modifier;
+    }
+
+    vec3 color = vec3(clamp(base + modifier, 0, 255));
+    frag_color = vec4(color, float(alpha)) / 255.0;
+}
+)";
+
+TextureDecoderOpenGL::TextureDecoderOpenGL() {
+    program.Create(vs_source.data(), fs_source.data());
+    src_offset_loc = glGetUniformLocation(program.handle, "src_offset");
+    dst_offset_loc = glGetUniformLocation(program.handle, "dst_offset");
+    surface_size_loc = glGetUniformLocation(program.handle, "surface_size");
+    has_alpha_loc = glGetUniformLocation(program.handle, "has_alpha");
+    vao.Create();
+    draw_fbo.Create();
+    data_buffer.Create();
+    data_texture.Create();
+
+    OpenGLState state = OpenGLState::GetCurState();
+    const GLuint old_program = std::exchange(state.draw.shader_program, program.handle);
+    const GLuint old_texture =
+        std::exchange(state.texture_buffer_lut_lf.texture_buffer, data_texture.handle);
+    state.Apply();
+
+    glUniform1i(glGetUniformLocation(program.handle, "data"), TextureUnits::TextureBufferLUT_LF.id);
+    glBindBuffer(GL_TEXTURE_BUFFER, data_buffer.handle);
+    glActiveTexture(TextureUnits::TextureBufferLUT_LF.Enum());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, data_buffer.handle);
+
+    state.draw.shader_program = old_program;
+    state.texture_buffer_lut_lf.texture_buffer = old_texture;
+    state.Apply();
+}
+
+bool TextureDecoderOpenGL::CanDecode(PixelFormat format) {
+    return format == PixelFormat::ETC1 || format == PixelFormat::ETC1A4;
+}
+
+void TextureDecoderOpenGL::Decode(std::span<const u8> data, PixelFormat format, u32 width,
+                                  u32 height, Common::Rectangle<u32> src_rect, GLuint dst_tex,
+                                  Common::Rectangle<u32> dst_rect) {
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    // Orphan the previous contents, the driver may still be reading them for the last decode
+    glBindBuffer(GL_TEXTURE_BUFFER, data_buffer.handle);
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(data.size()), data.data(),
+                 GL_STREAM_DRAW);
+
+    OpenGLState state;
+    state.texture_buffer_lut_lf.texture_buffer = data_texture.handle;
+    state.draw.draw_framebuffer = draw_fbo.handle;
+    state.draw.shader_program = program.handle;
+    state.draw.vertex_array = vao.handle;
+    state.viewport = {static_cast<GLint>(dst_rect.left), static_cast<GLint>(dst_rect.bottom),
+                      static_cast<GLsizei>(dst_rect.GetWidth()),
+                      static_cast<GLsizei>(dst_rect.GetHeight())};
+    state.Apply();
+
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dst_tex, 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+
+    glUniform2i(src_offset_loc, src_rect.left, src_rect.bottom);
+    glUniform2i(dst_offset_loc, dst_rect.left, dst_rect.bottom);
+    glUniform2i(surface_size_loc, width, height);
+    glUniform1i(has_alpha_loc, format == PixelFormat::ETC1A4);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+} // namespace OpenGL
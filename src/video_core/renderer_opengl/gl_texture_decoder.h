@@ -0,0 +1,48 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include "common/math_util.h"
+#include "video_core/rasterizer_cache/pixel_format.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+
+namespace OpenGL {
+
+/**
+ * Decodes tiled texture formats that OpenGL can't sample natively on the GPU. The raw guest data
+ * is uploaded to a buffer texture and a fragment shader untiles and decodes it into the RGBA8
+ * surface texture, in the same way FormatReinterpreterOpenGL converts between formats.
+ */
+class TextureDecoderOpenGL : NonCopyable {
+public:
+    TextureDecoderOpenGL();
+    ~TextureDecoderOpenGL() = default;
+
+    /// Returns true if surfaces of the format can be decoded by Decode
+    static bool CanDecode(PixelFormat format);
+
+    /**
+     * Decodes a rectangle of a tiled texture.
+     * @param data Tiled guest data of the whole surface
+     * @param format Format of the data, CanDecode must be true for it
+     * @param width,height Dimensions of the surface in texels
+     * @param src_rect Rectangle of the surface to decode, in OpenGL orientation
+     * @param dst_tex RGBA8 texture receiving the texels
+     * @param dst_rect Rectangle of dst_tex to write, of the same size as src_rect
+     */
+    void Decode(std::span<const u8> data, PixelFormat format, u32 width, u32 height,
+                Common::Rectangle<u32> src_rect, GLuint dst_tex, Common::Rectangle<u32> dst_rect);
+
+private:
+    OGLProgram program;
+    GLint src_offset_loc{-1}, dst_offset_loc{-1}, surface_size_loc{-1}, has_alpha_loc{-1};
+    OGLVertexArray vao;
+    OGLFramebuffer draw_fbo;
+    OGLBuffer data_buffer;
+    OGLTexture data_texture;
+};
+
+} // namespace OpenGL
@@ -0,0 +1,218 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include "common/logging/log.h"
+#include "video_core/renderer_opengl/gl_shader_util.h"
+#include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/gl_vars.h"
+#include "video_core/renderer_opengl/post_processing_chain_opengl.h"
+
+namespace OpenGL {
+
+namespace {
+
+/// Frames after which an unused intermediate texture is released, e.g. after resizing the window
+constexpr u64 TargetLifetime = 60;
+
+struct PassVertex {
+    GLfloat position[2];
+    GLfloat tex_coord[2];
+};
+
+/// The identity transform for the vertex shader, the quad is given in clip coordinates
+constexpr std::array<GLfloat, 3 * 2> IdentityMatrix{1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+
+void CreateSampler(OGLSampler& sampler, GLint filter) {
+    sampler.Create();
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_MIN_FILTER, filter);
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_MAG_FILTER, filter);
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glSamplerParameteri(sampler.handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+} // Anonymous namespace
+
+bool PostProcessingChain::Create(const PostProcessingPreset& preset, const char* vertex_shader) {
+    Release();
+    if (preset.passes.size() < 2) {
+        return true;
+    }
+
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    OpenGLState state = OpenGLState::GetCurState();
+
+    vertex_buffer.Create();
+    state.draw.vertex_buffer = vertex_buffer.handle;
+    state.Apply();
+    glBufferData(GL_ARRAY_BUFFER, sizeof(PassVertex) * 4, nullptr, GL_STREAM_DRAW);
+
+    passes.resize(preset.passes.size() - 1);
+    for (std::size_t i = 0; i < passes.size(); i++) {
+        Pass& pass = passes[i];
+        pass.config = preset.passes[i];
+
+        std::string shader_data;
+        if (GLES) {
+            shader_data += fragment_shader_precision_OES;
+        }
+        const std::string shader_text = GetPostProcessingShaderCode(false, pass.config.shader);
+        GLint linked = GL_FALSE;
+        if (!shader_text.empty()) {
+            shader_data += shader_text;
+            pass.program.Create(vertex_shader, shader_data.c_str());
+            glGetProgramiv(pass.program.handle, GL_LINK_STATUS, &linked);
+        }
+        if (linked != GL_TRUE) {
+            LOG_ERROR(Render_OpenGL, "Failed to load the shader {} of post-processing pass {}",
+                      pass.config.shader, i);
+            prev_state.Apply();
+            Release();
+            return false;
+        }
+
+        state.draw.shader_program = pass.program.handle;
+        state.Apply();
+        glUniformMatrix3x2fv(glGetUniformLocation(pass.program.handle, "modelview_matrix"), 1,
+                             GL_FALSE, IdentityMatrix.data());
+        glUniform1i(glGetUniformLocation(pass.program.handle, "color_texture"), 0);
+        glUniform1i(glGetUniformLocation(pass.program.handle, "layer"), 0);
+        pass.uniform_i_resolution = glGetUniformLocation(pass.program.handle, "i_resolution");
+        pass.uniform_o_resolution = glGetUniformLocation(pass.program.handle, "o_resolution");
+
+        // The passes may place the attributes differently, so each gets its own vertex array
+        pass.vertex_array.Create();
+        state.draw.vertex_array = pass.vertex_array.handle;
+        state.Apply();
+        const GLint attrib_position = glGetAttribLocation(pass.program.handle, "vert_position");
+        const GLint attrib_tex_coord = glGetAttribLocation(pass.program.handle, "vert_tex_coord");
+        glVertexAttribPointer(attrib_position, 2, GL_FLOAT, GL_FALSE, sizeof(PassVertex),
+                              (GLvoid*)offsetof(PassVertex, position));
+        glVertexAttribPointer(attrib_tex_coord, 2, GL_FLOAT, GL_FALSE, sizeof(PassVertex),
+                              (GLvoid*)offsetof(PassVertex, tex_coord));
+        glEnableVertexAttribArray(attrib_position);
+        glEnableVertexAttribArray(attrib_tex_coord);
+    }
+
+    CreateSampler(linear_sampler, GL_LINEAR);
+    CreateSampler(nearest_sampler, GL_NEAREST);
+
+    prev_state.Apply();
+    LOG_INFO(Render_OpenGL, "Loaded a post-processing chain of {} passes", preset.passes.size());
+    return true;
+}
+
+void PostProcessingChain::Release() {
+    passes.clear();
+    targets.clear();
+    vertex_buffer.Release();
+    linear_sampler.Release();
+    nearest_sampler.Release();
+}
+
+PostProcessingChain::Output PostProcessingChain::Run(GLuint texture,
+                                                     const Common::Rectangle<float>& texcoords,
+                                                     float input_width, float input_height,
+                                                     float viewport_width, float viewport_height) {
+    std::array<GLint, 4> viewport{};
+    glGetIntegerv(GL_VIEWPORT, viewport.data());
+
+    OpenGLState state = OpenGLState::GetCurState();
+    state.draw.vertex_buffer = vertex_buffer.handle;
+
+    Output output{texture, input_width, input_height};
+    const Target* input = nullptr;
+    // The first pass crops the region of the screen, the others sample all of their input
+    Common::Rectangle<float> region = texcoords;
+    for (const Pass& pass : passes) {
+        const bool from_source = pass.config.scale_type == PostProcessingPass::ScaleType::Source;
+        const float base_width = from_source ? output.width : viewport_width;
+        const float base_height = from_source ? output.height : viewport_height;
+        const GLsizei width =
+            std::max(1, static_cast<GLsizei>(std::lround(base_width * pass.config.scale)));
+        const GLsizei height =
+            std::max(1, static_cast<GLsizei>(std::lround(base_height * pass.config.scale)));
+        Target& target = GetTarget(width, height, pass.config.half_float, input);
+
+        const std::array<PassVertex, 4> vertices{{
+            {{-1.0f, -1.0f}, {region.top, region.left}},
+            {{1.0f, -1.0f}, {region.bottom, region.left}},
+            {{-1.0f, 1.0f}, {region.top, region.right}},
+            {{1.0f, 1.0f}, {region.bottom, region.right}},
+        }};
+
+        state.draw.draw_framebuffer = target.framebuffer.handle;
+        state.draw.shader_program = pass.program.handle;
+        state.draw.vertex_array = pass.vertex_array.handle;
+        state.texture_units[0].texture_2d = output.texture;
+        state.texture_units[0].sampler =
+            pass.config.linear_filter ? linear_sampler.handle : nearest_sampler.handle;
+        state.Apply();
+
+        glViewport(0, 0, width, height);
+        glUniform4f(pass.uniform_i_resolution, output.width, output.height, 1.0f / output.width,
+                    1.0f / output.height);
+        glUniform4f(pass.uniform_o_resolution, static_cast<float>(width),
+                    static_cast<float>(height), 1.0f / static_cast<float>(width),
+                    1.0f / static_cast<float>(height));
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices.data());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        output = {target.texture.handle, static_cast<float>(width), static_cast<float>(height)};
+        input = &target;
+        region = Common::Rectangle<float>(0.f, 0.f, 1.f, 1.f);
+    }
+
+    state.texture_units[0].texture_2d = 0;
+    state.texture_units[0].sampler = 0;
+    state.Apply();
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    return output;
+}
+
+void PostProcessingChain::EndFrame() {
+    frame++;
+    targets.remove_if(
+        [this](const Target& target) { return target.last_use + TargetLifetime < frame; });
+}
+
+PostProcessingChain::Target& PostProcessingChain::GetTarget(GLsizei width, GLsizei height,
+                                                            bool half_float,
+                                                            const Target* input) {
+    const auto it = std::find_if(targets.begin(), targets.end(), [&](const Target& target) {
+        return &target != input && target.width == width && target.height == height &&
+               target.half_float == half_float;
+    });
+    if (it != targets.end()) {
+        it->last_use = frame;
+        return *it;
+    }
+
+    Target& target = targets.emplace_back();
+    target.width = width;
+    target.height = height;
+    target.half_float = half_float;
+    target.last_use = frame;
+    target.texture.Create();
+    target.texture.Allocate(GL_TEXTURE_2D, 1, half_float ? GL_RGBA16F : GL_RGBA8, width, height);
+
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    OpenGLState state = OpenGLState::GetCurState();
+    target.framebuffer.Create();
+    state.draw.draw_framebuffer = target.framebuffer.handle;
+    state.Apply();
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           target.texture.handle, 0);
+    if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_CRITICAL(Render_OpenGL, "Failed to create a {}x{} post-processing target", width,
+                     height);
+    }
+    prev_state.Apply();
+    return target;
+}
+
+} // namespace OpenGL
@@ -0,0 +1,88 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include "common/common_types.h"
+#include "common/math_util.h"
+#include "video_core/renderer_opengl/gl_resource_manager.h"
+#include "video_core/renderer_opengl/post_processing_opengl.h"
+
+namespace OpenGL {
+
+/**
+ * Runs the passes of a post-processing preset before its last one, which the renderer draws to the
+ * window. The intermediate textures are kept between frames and only reallocated when their size
+ * or format changes. A pass reuses the texture of an earlier pass with the same size and format,
+ * so a chain of similar passes ping-pongs between two textures.
+ */
+class PostProcessingChain {
+public:
+    struct Output {
+        GLuint texture;
+        float width;
+        float height;
+    };
+
+    /**
+     * Compiles the passes of the preset before the last one.
+     * @param vertex_shader The vertex shader of the screen, drawing a quad with an identity matrix
+     * @return Whether all the passes were compiled, otherwise the chain is left empty
+     */
+    bool Create(const PostProcessingPreset& preset, const char* vertex_shader);
+
+    void Release();
+
+    bool IsEmpty() const {
+        return passes.empty();
+    }
+
+    /**
+     * Runs the passes on a region of the texture. The OpenGL state is changed, except for the
+     * viewport, and needs to be applied again afterwards.
+     * @param texcoords The region, as in ScreenInfo::display_texcoords
+     * @param input_width,input_height The size of the region in pixels
+     * @param viewport_width,viewport_height The size of the screen on the window, in the
+     *        orientation of the texture
+     * @return The output of the last pass, covering all of the texture
+     */
+    Output Run(GLuint texture, const Common::Rectangle<float>& texcoords, float input_width,
+               float input_height, float viewport_width, float viewport_height);
+
+    /// Releases the intermediate textures that haven't been used for a while
+    void EndFrame();
+
+private:
+    struct Pass {
+        PostProcessingPass config;
+        OGLProgram program;
+        OGLVertexArray vertex_array;
+        GLint uniform_i_resolution;
+        GLint uniform_o_resolution;
+    };
+
+    struct Target {
+        OGLTexture texture;
+        OGLFramebuffer framebuffer;
+        GLsizei width;
+        GLsizei height;
+        bool half_float;
+        u64 last_use;
+    };
+
+    /// Returns an intermediate texture of the size and format, other than the input of the pass
+    Target& GetTarget(GLsizei width, GLsizei height, bool half_float, const Target* input);
+
+    std::vector<Pass> passes;
+    /// A list, so that the targets don't move when more are created
+    std::list<Target> targets;
+    OGLBuffer vertex_buffer;
+    OGLSampler linear_sampler;
+    OGLSampler nearest_sampler;
+    u64 frame = 0;
+};
+
+} // namespace OpenGL
@@ -2,16 +2,22 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <charconv>
 #include <sstream>
 #include <string>
 #include <vector>
+#include <fmt/format.h>
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/logging/log.h"
 #include "common/string_util.h"
 #include "video_core/renderer_opengl/post_processing_opengl.h"
 
 namespace OpenGL {
 
+constexpr std::size_t MaxPresetPasses = 16;
+
 // The Dolphin shader header is added here for drop-in compatibility with most
 // of Dolphin's "glsl" shaders, which use hlsl types, hence the #define's below
 // It's fairly complete, but the features it's missing are:
@@ -138,14 +144,16 @@ std::vector<std::string> GetPostProcessingShaderList(bool anaglyph) {
     }
 
     // Would it make more sense to just add a directory list function to FileUtil?
-    const auto callback = [&shader_names](u64* num_entries_out, const std::string& directory,
-                                          const std::string& virtual_name) -> bool {
+    const auto callback = [&shader_names, anaglyph](u64* num_entries_out,
+                                                    const std::string& directory,
+                                                    const std::string& virtual_name) -> bool {
         const std::string physical_name = directory + DIR_SEP + virtual_name;
         if (!FileUtil::IsDirectory(physical_name)) {
             // The following is done to avoid coupling this to Qt
             std::size_t dot_pos = virtual_name.rfind(".");
             if (dot_pos != std::string::npos) {
-                if (Common::ToLower(virtual_name.substr(dot_pos + 1)) == "glsl") {
+                const std::string extension = Common::ToLower(virtual_name.substr(dot_pos + 1));
+                if (extension == "glsl" || (!anaglyph && extension == "preset")) {
                     shader_names.push_back(virtual_name.substr(0, dot_pos));
                 }
             }
@@ -156,6 +164,7 @@ std::vector<std::string> GetPostProcessingShaderList(bool anaglyph) {
     FileUtil::ForeachDirectoryEntry(nullptr, shader_dir, callback);
 
     std::sort(shader_names.begin(), shader_names.end());
+    shader_names.erase(std::unique(shader_names.begin(), shader_names.end()), shader_names.end());
 
     return shader_names;
 }
@@ -205,4 +214,75 @@ std::string GetPostProcessingShaderCode(bool anaglyph, std::string_view shader)
     return dolphin_shader_header + shader_text.str();
 }
 
+std::optional<PostProcessingPreset> GetPostProcessingPreset(std::string_view preset_name) {
+    const std::string path = fmt::format("{}{}.preset",
+                                         FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir),
+                                         preset_name);
+    if (!FileUtil::Exists(path)) {
+        return std::nullopt;
+    }
+    std::string contents;
+    FileUtil::ReadFileToString(true, path, contents);
+
+    PostProcessingPreset preset;
+    std::istringstream lines{contents};
+    std::string line;
+    while (std::getline(lines, line)) {
+        line = Common::StripSpaces(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        const auto separator = line.find('=');
+        if (separator == std::string::npos || !line.starts_with("pass")) {
+            LOG_ERROR(Render_OpenGL, "Invalid line in the preset {}: {}", preset_name, line);
+            return std::nullopt;
+        }
+        // The keys are "pass<index>" followed by the name of the property, if any
+        const std::string key = Common::StripSpaces(line.substr(0, separator));
+        const std::string value = Common::StripSpaces(line.substr(separator + 1));
+        std::size_t index{};
+        const auto [index_end, error] =
+            std::from_chars(key.data() + 4, key.data() + key.size(), index);
+        if (error != std::errc{} || index >= MaxPresetPasses) {
+            LOG_ERROR(Render_OpenGL, "Invalid pass in the preset {}: {}", preset_name, line);
+            return std::nullopt;
+        }
+        if (index >= preset.passes.size()) {
+            preset.passes.resize(index + 1);
+        }
+        PostProcessingPass& pass = preset.passes[index];
+        const std::string_view property{index_end, key.data() + key.size()};
+
+        if (property.empty()) {
+            pass.shader = value;
+        } else if (property == "_scale") {
+            pass.scale = std::strtof(value.c_str(), nullptr);
+        } else if (property == "_scale_type" && (value == "source" || value == "viewport")) {
+            pass.scale_type = value == "source" ? PostProcessingPass::ScaleType::Source
+                                                : PostProcessingPass::ScaleType::Viewport;
+        } else if (property == "_format" && (value == "rgba8" || value == "rgba16f")) {
+            pass.half_float = value == "rgba16f";
+        } else if (property == "_filter" && (value == "linear" || value == "nearest")) {
+            pass.linear_filter = value == "linear";
+        } else {
+            LOG_WARNING(Render_OpenGL, "Ignoring unknown line in the preset {}: {}", preset_name,
+                        line);
+        }
+    }
+
+    if (preset.passes.empty()) {
+        LOG_ERROR(Render_OpenGL, "The preset {} has no passes", preset_name);
+        return std::nullopt;
+    }
+    for (std::size_t i = 0; i < preset.passes.size(); i++) {
+        const PostProcessingPass& pass = preset.passes[i];
+        if (pass.shader.empty() || !(pass.scale > 0.0f && pass.scale <= 16.0f)) {
+            LOG_ERROR(Render_OpenGL, "Pass {} of the preset {} needs a shader and a valid scale",
+                      i, preset_name);
+            return std::nullopt;
+        }
+    }
+    return preset;
+}
+
 } // namespace OpenGL
@@ -4,14 +4,49 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace OpenGL {
 
+/// A pass of a post-processing preset
+struct PostProcessingPass {
+    enum class ScaleType {
+        Source,   ///< The size of the pass is scaled from the size of its input
+        Viewport, ///< The size of the pass is scaled from the size of the screen on the window
+    };
+
+    std::string shader;
+    float scale = 1.0f;
+    ScaleType scale_type = ScaleType::Source;
+    /// Whether the output is stored as half floats instead of 8 bit values
+    bool half_float = false;
+    /// Whether the input of the pass is sampled with linear filtering
+    bool linear_filter = true;
+};
+
+/**
+ * A chain of post-processing shaders, read from a "<name>.preset" file in the shaders directory:
+ *
+ *   pass0 = blur
+ *   pass0_scale = 0.5
+ *   pass0_scale_type = source  (or viewport)
+ *   pass0_format = rgba16f     (or rgba8)
+ *   pass0_filter = linear      (or nearest)
+ *   pass1 = sharpen
+ *
+ * Every pass but the last renders into an intermediate texture which the next pass samples. The
+ * last pass draws the screen to the window like a single post-processing shader would.
+ */
+struct PostProcessingPreset {
+    std::vector<PostProcessingPass> passes;
+};
+
 // Returns a vector of the names of the shaders available in the
 // "shaders" directory in citra's data directory
+// Unless anaglyph is true, it includes the names of the presets
 std::vector<std::string> GetPostProcessingShaderList(bool anaglyph);
 
 // Returns the shader code for the shader named "shader_name"
@@ -21,4 +56,7 @@ std::vector<std::string> GetPostProcessingShaderList(bool anaglyph);
 // If the shader cannot be loaded, an empty string is returned
 std::string GetPostProcessingShaderCode(bool anaglyph, std::string_view shader_name);
 
+// Returns the preset named "preset_name", or nothing if there is no such preset or it is invalid
+std::optional<PostProcessingPreset> GetPostProcessingPreset(std::string_view preset_name);
+
 } // namespace OpenGL
@@ -35,6 +35,11 @@ constexpr std::size_t SWAP_CHAIN_SIZE = 6;
 constexpr std::size_t SWAP_CHAIN_SIZE = 9;
 #endif
 
+// In FIFO presentation the renderer waits while this many frames are queued, which bounds the
+// added latency. It gives up waiting after the timeout, dropping the oldest queued frame.
+constexpr std::size_t FIFO_QUEUE_DEPTH = 2;
+constexpr int FIFO_TIMEOUT_MS = 100;
+
 class OGLTextureMailboxException : public std::runtime_error {
 public:
     using std::runtime_error::runtime_error;
@@ -112,6 +117,15 @@ public:
     Frontend::Frame* GetRenderFrame() override {
         std::unique_lock<std::mutex> lock(swap_chain_lock);
 
+        if (Settings::values.present_mode.GetValue() == Settings::PresentMode::Fifo) {
+            // Every frame is presented, so wait for the presentation thread to catch up instead of
+            // dropping queued frames. The timeout keeps rendering going while the window isn't
+            // presenting, e.g. when it is minimized.
+            free_cv.wait_for(lock, std::chrono::milliseconds(FIFO_TIMEOUT_MS), [&] {
+                return !free_queue.empty() && present_queue.size() < FIFO_QUEUE_DEPTH;
+            });
+        }
+
         // If theres no free frames, we will reuse the oldest render frame
         if (free_queue.empty()) {
             auto frame = present_queue.back();
@@ -138,6 +152,13 @@ public:
             free_cv.notify_one();
         }
 
+        if (Settings::values.present_mode.GetValue() == Settings::PresentMode::Fifo) {
+            // Present the frames in the order they were rendered
+            previous_frame = present_queue.back();
+            present_queue.pop_back();
+            return;
+        }
+
         // the newest entries are pushed to the front of the queue
         Frontend::Frame* frame = present_queue.front();
         present_queue.pop_front();
@@ -387,18 +408,32 @@ void RendererOpenGL::SwapBuffers() {
     OpenGLState prev_state = OpenGLState::GetCurState();
     state.Apply();
 
-    PrepareRendertarget();
+    // A skipped frame is neither loaded into the screen textures nor presented. Only the guest
+    // framebuffers are read for this, so the emulated state is the same as when presenting.
+    const bool skip = SkipPresentation();
+    if (!skip) {
+        PrepareRendertarget();
+    }
 
     RenderScreenshot();
 
-    const auto& main_layout = render_window.GetFramebufferLayout();
-    RenderToMailbox(main_layout, render_window.mailbox, false);
+    if (!skip) {
+        const auto& main_layout = render_window.GetFramebufferLayout();
+        if (HasFrameChanged(main_layout, render_window.mailbox.get(), main_frame)) {
+            RenderToMailbox(main_layout, render_window.mailbox, false);
+        }
+    }
 
 #ifndef ANDROID
     if (Settings::values.layout_option.GetValue() == Settings::LayoutOption::SeparateWindows) {
         ASSERT(secondary_window);
-        const auto& secondary_layout = secondary_window->GetFramebufferLayout();
-        RenderToMailbox(secondary_layout, secondary_window->mailbox, false);
+        if (!skip) {
+            const auto& secondary_layout = secondary_window->GetFramebufferLayout();
+            if (HasFrameChanged(secondary_layout, secondary_window->mailbox.get(),
+                                secondary_frame)) {
+                RenderToMailbox(secondary_layout, secondary_window->mailbox, false);
+            }
+        }
         secondary_window->PollEvents();
     }
 #endif
@@ -412,6 +447,8 @@ void RendererOpenGL::SwapBuffers() {
 
     RenderCTroll3D();
 
+    gpu_timer.EndFrame();
+    rasterizer->EndFrame();
     m_current_frame++;
 
     Core::System::GetInstance().perf_stats->EndSystemFrame();
@@ -430,6 +467,23 @@ void RendererOpenGL::SwapBuffers() {
     }
 }
 
+bool RendererOpenGL::SkipPresentation() {
+    const u16 frame_skip = Settings::values.frame_skip.GetValue();
+    // Screenshots, video dumps and the CTroll3D stream need every frame to be prepared
+    if (frame_skip == 0 || Settings::values.frame_limit.GetValue() != 0 ||
+        VideoCore::g_renderer_screenshot_requested || frame_dumper.IsDumping() ||
+        VideoCore::g_ctroll3d_addr) {
+        skipped_frames = 0;
+        return false;
+    }
+    if (skipped_frames < frame_skip) {
+        skipped_frames++;
+        return true;
+    }
+    skipped_frames = 0;
+    return false;
+}
+
 void RendererOpenGL::RenderScreenshot() {
     if (VideoCore::g_renderer_screenshot_requested) {
         // Draw this frame to the screenshot framebuffer
@@ -628,8 +682,28 @@ void RendererOpenGL::RenderCTroll3D() {
     }
 }
 
+/// Returns the address of the framebuffer currently displayed for the eye
+static PAddr GetFramebufferAddress(const GPU::Regs::FramebufferConfig& framebuffer,
+                                   bool right_eye) {
+    if (framebuffer.address_right1 == 0 || framebuffer.address_right2 == 0)
+        right_eye = false;
+
+    return framebuffer.active_fb == 0
+               ? (!right_eye ? framebuffer.address_left1 : framebuffer.address_right1)
+               : (!right_eye ? framebuffer.address_left2 : framebuffer.address_right2);
+}
+
 void RendererOpenGL::PrepareRendertarget() {
+    const bool stereo = Settings::values.render_3d.GetValue() != Settings::StereoRenderOption::Off;
+    const int mono_eye = static_cast<int>(Settings::values.mono_render_option.GetValue());
+    untracked_screens = false;
+
     for (int i : {0, 1, 2}) {
+        // Without 3D only one eye of the top screen is displayed
+        if (!stereo && i != 2 && i != mono_eye) {
+            continue;
+        }
+
         int fb_id = i == 2 ? 1 : 0;
         const auto& framebuffer = GPU::g_regs.framebuffer_config[fb_id];
 
@@ -643,6 +717,7 @@ void RendererOpenGL::PrepareRendertarget() {
         if (color_fill.is_enabled) {
             LoadColorToActiveGLTexture(color_fill.color_r, color_fill.color_g, color_fill.color_b,
                                        screen_infos[i].texture);
+            untracked_screens = true;
 
             // Resize the texture in case the framebuffer size has changed
             screen_infos[i].texture.width = 1;
@@ -656,7 +731,16 @@ void RendererOpenGL::PrepareRendertarget() {
                 // performance problem.
                 ConfigureFramebufferTexture(screen_infos[i].texture, framebuffer);
             }
-            LoadFBToScreenInfo(framebuffer, screen_infos[i], i == 1);
+            const PAddr left_addr = GetFramebufferAddress(framebuffer, false);
+            if (i == 1 && stereo && GetFramebufferAddress(framebuffer, true) == left_addr) {
+                // Both eyes display the same framebuffer (e.g. while the 3D slider is off), reuse
+                // the left eye instead of looking it up or uploading it a second time
+                screen_infos[1].display_texture = screen_infos[0].display_texture;
+                screen_infos[1].display_texcoords = screen_infos[0].display_texcoords;
+                screen_infos[1].display_tick = screen_infos[0].display_tick;
+            } else {
+                LoadFBToScreenInfo(framebuffer, screen_infos[i], i == 1);
+            }
 
             // Resize the texture in case the framebuffer size has changed
             screen_infos[i].texture.width = framebuffer.width;
@@ -717,19 +801,38 @@ void RendererOpenGL::RenderToMailbox(const Layout::FramebufferLayout& layout,
     }
 }
 
+bool RendererOpenGL::HasFrameChanged(const Layout::FramebufferLayout& layout,
+                                     const Frontend::TextureMailbox* mailbox,
+                                     ComposedFrame& last_frame) {
+    ComposedFrame frame{
+        .mailbox = mailbox,
+        .width = layout.width,
+        .height = layout.height,
+        .top_screen_enabled = layout.top_screen_enabled,
+        .bottom_screen_enabled = layout.bottom_screen_enabled,
+        .top_screen = layout.top_screen,
+        .bottom_screen = layout.bottom_screen,
+        .is_rotated = layout.is_rotated,
+        .settings_epoch = Settings::GetSnapshot().epoch,
+    };
+    for (std::size_t i = 0; i < screen_infos.size(); i++) {
+        frame.textures[i] = screen_infos[i].display_texture;
+        frame.texcoords[i] = screen_infos[i].display_texcoords;
+        frame.ticks[i] = screen_infos[i].display_tick;
+    }
+    // Frames of 30 fps titles and menus are often repeated, the mailbox keeps presenting the last
+    // frame composed
+    const bool changed = untracked_screens || frame != last_frame;
+    last_frame = frame;
+    return changed;
+}
+
 /**
  * Loads framebuffer from emulated memory into the active OpenGL texture.
  */
 void RendererOpenGL::LoadFBToScreenInfo(const GPU::Regs::FramebufferConfig& framebuffer,
                                         ScreenInfo& screen_info, bool right_eye) {
-
-    if (framebuffer.address_right1 == 0 || framebuffer.address_right2 == 0)
-        right_eye = false;
-
-    const PAddr framebuffer_addr =
-        framebuffer.active_fb == 0
-            ? (!right_eye ? framebuffer.address_left1 : framebuffer.address_right1)
-            : (!right_eye ? framebuffer.address_left2 : framebuffer.address_right2);
+    const PAddr framebuffer_addr = GetFramebufferAddress(framebuffer, right_eye);
 
     LOG_TRACE(Render_OpenGL, "0x{:08x} bytes from 0x{:08x}({}x{}), fmt {:x}",
               framebuffer.stride * framebuffer.height, framebuffer_addr, framebuffer.width.Value(),
@@ -750,6 +853,7 @@ void RendererOpenGL::LoadFBToScreenInfo(const GPU::Regs::FramebufferConfig& fram
         // Reset the screen info's display texture to its own permanent texture
         screen_info.display_texture = screen_info.texture.resource.handle;
         screen_info.display_texcoords = Common::Rectangle<float>(0.f, 0.f, 1.f, 1.f);
+        untracked_screens = true;
 
         Memory::RasterizerFlushRegion(framebuffer_addr, framebuffer.stride * framebuffer.height);
 
@@ -806,6 +910,8 @@ void RendererOpenGL::InitOpenGLObjects() {
     filter_sampler.Create();
     ReloadSampler();
 
+    gpu_timer.Create();
+
     ReloadShader();
 
     // Generate VBO handle for drawing
@@ -862,6 +968,8 @@ void RendererOpenGL::ReloadSampler() {
 }
 
 void RendererOpenGL::ReloadShader() {
+    post_processing.Release();
+
     // Link shaders and get variable locations
     std::string shader_data;
     if (GLES) {
@@ -897,11 +1005,17 @@ void RendererOpenGL::ReloadShader() {
             }
         }
     } else {
-        if (Settings::values.pp_shader_name.GetValue() == "none (builtin)") {
+        // The last pass of a preset draws the screens, the passes before it run offscreen
+        std::string shader_name = Settings::values.pp_shader_name.GetValue();
+        if (const auto preset = OpenGL::GetPostProcessingPreset(shader_name)) {
+            if (post_processing.Create(*preset, vertex_shader)) {
+                shader_name = preset->passes.back().shader;
+            }
+        }
+        if (shader_name == "none (builtin)") {
             shader_data += fragment_shader;
         } else {
-            std::string shader_text = OpenGL::GetPostProcessingShaderCode(
-                false, Settings::values.pp_shader_name.GetValue());
+            std::string shader_text = OpenGL::GetPostProcessingShaderCode(false, shader_name);
             if (shader_text.empty()) {
                 // Should probably provide some information that the shader couldn't load
                 shader_data += fragment_shader;
@@ -1004,7 +1118,8 @@ void RendererOpenGL::ConfigureFramebufferTexture(TextureInfo& texture,
  */
 void RendererOpenGL::DrawSingleScreenRotated(const ScreenInfo& screen_info, float x, float y,
                                              float w, float h) {
-    const auto& texcoords = screen_info.display_texcoords;
+    // The screen is rotated on the window, so the sides of the viewport swap in the texture
+    const auto [texture, texcoords, input_width, input_height] = PostProcess(screen_info, h, w);
 
     const std::array<ScreenRectVertex, 4> vertices = {{
         ScreenRectVertex(x, y, texcoords.bottom, texcoords.left),
@@ -1016,13 +1131,10 @@ void RendererOpenGL::DrawSingleScreenRotated(const ScreenInfo& screen_info, floa
     // As this is the "DrawSingleScreenRotated" function, the output resolution dimensions have been
     // swapped. If a non-rotated draw-screen function were to be added for book-mode games, those
     // should probably be set to the standard (w, h, 1.0 / w, 1.0 / h) ordering.
-    const u16 scale_factor = VideoCore::GetResolutionScaleFactor();
-    glUniform4f(uniform_i_resolution, static_cast<float>(screen_info.texture.width * scale_factor),
-                static_cast<float>(screen_info.texture.height * scale_factor),
-                1.0f / static_cast<float>(screen_info.texture.width * scale_factor),
-                1.0f / static_cast<float>(screen_info.texture.height * scale_factor));
+    glUniform4f(uniform_i_resolution, input_width, input_height, 1.0f / input_width,
+                1.0f / input_height);
     glUniform4f(uniform_o_resolution, h, w, 1.0f / h, 1.0f / w);
-    state.texture_units[0].texture_2d = screen_info.display_texture;
+    state.texture_units[0].texture_2d = texture;
     state.texture_units[0].sampler = filter_sampler.handle;
     state.Apply();
 
@@ -1034,9 +1146,27 @@ void RendererOpenGL::DrawSingleScreenRotated(const ScreenInfo& screen_info, floa
     state.Apply();
 }
 
+std::tuple<GLuint, Common::Rectangle<float>, float, float> RendererOpenGL::PostProcess(
+    const ScreenInfo& screen_info, float viewport_width, float viewport_height) {
+    const u16 scale_factor = VideoCore::GetResolutionScaleFactor();
+    const float width = static_cast<float>(screen_info.texture.width * scale_factor);
+    const float height = static_cast<float>(screen_info.texture.height * scale_factor);
+    if (post_processing.IsEmpty()) {
+        return {screen_info.display_texture, screen_info.display_texcoords, width, height};
+    }
+
+    const auto output =
+        post_processing.Run(screen_info.display_texture, screen_info.display_texcoords, width,
+                            height, viewport_width, viewport_height);
+    // Restore the state of the screen shader
+    state.Apply();
+    return {output.texture, Common::Rectangle<float>(0.f, 0.f, 1.f, 1.f), output.width,
+            output.height};
+}
+
 void RendererOpenGL::DrawSingleScreen(const ScreenInfo& screen_info, float x, float y, float w,
                                       float h) {
-    const auto& texcoords = screen_info.display_texcoords;
+    const auto [texture, texcoords, input_width, input_height] = PostProcess(screen_info, w, h);
 
     const std::array<ScreenRectVertex, 4> vertices = {{
         ScreenRectVertex(x, y, texcoords.bottom, texcoords.right),
@@ -1045,13 +1175,10 @@ void RendererOpenGL::DrawSingleScreen(const ScreenInfo& screen_info, float x, fl
         ScreenRectVertex(x + w, y + h, texcoords.top, texcoords.left),
     }};
 
-    const u16 scale_factor = VideoCore::GetResolutionScaleFactor();
-    glUniform4f(uniform_i_resolution, static_cast<float>(screen_info.texture.width * scale_factor),
-                static_cast<float>(screen_info.texture.height * scale_factor),
-                1.0f / static_cast<float>(screen_info.texture.width * scale_factor),
-                1.0f / static_cast<float>(screen_info.texture.height * scale_factor));
+    glUniform4f(uniform_i_resolution, input_width, input_height, 1.0f / input_width,
+                1.0f / input_height);
     glUniform4f(uniform_o_resolution, w, h, 1.0f / w, 1.0f / h);
-    state.texture_units[0].texture_2d = screen_info.display_texture;
+    state.texture_units[0].texture_2d = texture;
     state.texture_units[0].sampler = filter_sampler.handle;
     state.Apply();
 
@@ -1314,6 +1441,10 @@ void RendererOpenGL::DrawScreens(const Layout::FramebufferLayout& layout, bool f
             }
         }
     }
+
+    if (!post_processing.IsEmpty()) {
+        post_processing.EndFrame();
+    }
 }
 
 /**
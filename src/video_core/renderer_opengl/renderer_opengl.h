@@ -5,11 +5,14 @@
 #pragma once
 
 #include <array>
+#include <tuple>
 #include "core/hw/gpu.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_opengl/frame_dumper_opengl.h"
+#include "video_core/renderer_opengl/gl_gpu_timer.h"
 #include "video_core/renderer_opengl/gl_resource_manager.h"
 #include "video_core/renderer_opengl/gl_state.h"
+#include "video_core/renderer_opengl/post_processing_chain_opengl.h"
 
 namespace Layout {
 struct FramebufferLayout;
@@ -45,6 +48,8 @@ struct TextureInfo {
 struct ScreenInfo {
     GLuint display_texture;
     Common::Rectangle<float> display_texcoords;
+    /// The modification tick of the surface displayed from the rasterizer cache
+    u64 display_tick = 0;
     TextureInfo texture;
 };
 
@@ -83,14 +88,42 @@ private:
     void ReloadSampler();
     void ReloadShader();
     void PrepareRendertarget();
+    /// Returns whether the presentation of the current frame is skipped while fast-forwarding
+    bool SkipPresentation();
     void RenderScreenshot();
     void RenderCTroll3D();
     void RenderToMailbox(const Layout::FramebufferLayout& layout,
                          std::unique_ptr<Frontend::TextureMailbox>& mailbox, bool flipped);
+
+    /// Everything the composition of the screens into a window depends on
+    struct ComposedFrame {
+        const Frontend::TextureMailbox* mailbox = nullptr;
+        u32 width = 0;
+        u32 height = 0;
+        bool top_screen_enabled = false;
+        bool bottom_screen_enabled = false;
+        Common::Rectangle<u32> top_screen;
+        Common::Rectangle<u32> bottom_screen;
+        bool is_rotated = false;
+        std::array<GLuint, 3> textures{};
+        std::array<Common::Rectangle<float>, 3> texcoords{};
+        std::array<u64, 3> ticks{};
+        u32 settings_epoch = 0;
+
+        bool operator==(const ComposedFrame&) const = default;
+    };
+    /// Returns whether the window would show something else than the frame composed last time,
+    /// which is updated. An unchanged frame doesn't need to be composed and presented again.
+    bool HasFrameChanged(const Layout::FramebufferLayout& layout,
+                         const Frontend::TextureMailbox* mailbox, ComposedFrame& last_frame);
     void ConfigureFramebufferTexture(TextureInfo& texture,
                                      const GPU::Regs::FramebufferConfig& framebuffer);
     void DrawScreens(const Layout::FramebufferLayout& layout, bool flipped);
     void DrawCTroll3DBottomScreen(const Layout::FramebufferLayout& layout);
+    /// Runs the passes of the post-processing preset before the last one, if any, on the screen.
+    /// Returns the texture, texture coordinates and size the screen is drawn from.
+    std::tuple<GLuint, Common::Rectangle<float>, float, float> PostProcess(
+        const ScreenInfo& screen_info, float viewport_width, float viewport_height);
     void DrawSingleScreenRotated(const ScreenInfo& screen_info, float x, float y, float w, float h);
     void DrawSingleScreen(const ScreenInfo& screen_info, float x, float y, float w, float h);
     void DrawSingleScreenStereoRotated(const ScreenInfo& screen_info_l,
@@ -115,6 +148,7 @@ private:
     OGLFramebuffer screenshot_framebuffer;
     OGLFramebuffer screen_framebuffer;
     OGLSampler filter_sampler;
+    PostProcessingChain post_processing;
 
     /// Display information for top and bottom screens respectively
     std::array<ScreenInfo, 3> screen_infos;
@@ -134,6 +168,16 @@ private:
     GLuint attrib_tex_coord;
 
     FrameDumperOpenGL frame_dumper;
+    GPUTimer gpu_timer;
+
+    /// Number of frames skipped since the last presented one
+    u16 skipped_frames = 0;
+
+    /// Whether a screen of the current frame was loaded from emulated memory or filled with a
+    /// color, changes to which aren't tracked
+    bool untracked_screens = true;
+    ComposedFrame main_frame;
+    ComposedFrame secondary_frame;
 };
 
 } // namespace OpenGL
@@ -150,12 +150,11 @@ void main(){
  * OpenGL ES does not support glReadBuffer for depth/stencil formats
  * This gets around it by converting to a Red surface before downloading
  */
-GLuint TextureDownloaderES::ConvertDepthToColor(GLuint level, GLenum& format, GLenum& type,
-                                                GLint height, GLint width) {
+GLuint TextureDownloaderES::ConvertDepthToColor(GLuint texture, GLuint level, GLenum& format,
+                                                GLenum& type, GLint height, GLint width) {
     ASSERT(width <= max_size && height <= max_size);
-    const OpenGLState cur_state = OpenGLState::GetCurState();
     OpenGLState state;
-    state.texture_units[0] = {cur_state.texture_units[0].texture_2d, sampler.handle};
+    state.texture_units[0] = {texture, sampler.handle};
     state.draw.vertex_array = vao.handle;
 
     OGLTexture texture_view;
@@ -198,6 +197,16 @@ GLuint TextureDownloaderES::ConvertDepthToColor(GLuint level, GLenum& format, GL
     return state.draw.draw_framebuffer;
 }
 
+GLuint TextureDownloaderES::ConvertDepth(GLuint texture, GLuint level, GLenum& format,
+                                         GLenum& type, GLint height, GLint width) {
+    // The depth stencil conversion is only available with the extension it needs
+    if (width > max_size || height > max_size ||
+        (type == GL_UNSIGNED_INT_24_8 && d24s8_r32ui_conversion_shader.program.handle == 0)) {
+        return 0;
+    }
+    return ConvertDepthToColor(texture, level, format, type, height, width);
+}
+
 /**
  * OpenGL ES does not support glGetTexImage. Obtain the pixels by attaching the
  * texture to a framebuffer.
@@ -231,7 +240,8 @@ void TextureDownloaderES::GetTexImage(GLenum target, GLuint level, GLenum format
     case GL_DEPTH_STENCIL:
         // unfortunately, the accurate way is too slow for release
         return;
-        state.draw.read_framebuffer = ConvertDepthToColor(level, format, type, height, width);
+        state.draw.read_framebuffer =
+            ConvertDepthToColor(texture, level, format, type, height, width);
         state.Apply();
         break;
     default:
@@ -24,12 +24,21 @@ class TextureDownloaderES {
     OGLSampler sampler;
 
     void Test();
-    GLuint ConvertDepthToColor(GLuint level, GLenum& format, GLenum& type, GLint height,
-                               GLint width);
+    GLuint ConvertDepthToColor(GLuint texture, GLuint level, GLenum& format, GLenum& type,
+                               GLint height, GLint width);
 
 public:
     TextureDownloaderES(bool enable_depth_stencil);
 
+    /**
+     * Converts the depth of the texture to a color renderbuffer, which unlike depth can be read
+     * with glReadPixels on GLES, e.g. into a staging buffer. The format and type are changed to
+     * those of the color. The OpenGL state is not restored.
+     * @return the framebuffer to read the color from, or 0 if the format can't be converted
+     */
+    GLuint ConvertDepth(GLuint texture, GLuint level, GLenum& format, GLenum& type, GLint height,
+                        GLint width);
+
     void GetTexImage(GLenum target, GLuint level, GLenum format, const GLenum type, GLint height,
                      GLint width, void* pixels);
 };
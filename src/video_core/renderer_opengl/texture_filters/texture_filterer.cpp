@@ -5,7 +5,10 @@
 #include <algorithm>
 #include <functional>
 #include <unordered_map>
+#include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/scope_exit.h"
+#include "video_core/renderer_opengl/gl_state.h"
 #include "video_core/renderer_opengl/texture_filters/anime4k/anime4k_ultrafast.h"
 #include "video_core/renderer_opengl/texture_filters/bicubic/bicubic.h"
 #include "video_core/renderer_opengl/texture_filters/nearest_neighbor/nearest_neighbor.h"
@@ -37,6 +40,8 @@ static const std::unordered_map<std::string_view, TextureFilterContructor> filte
 } // namespace
 
 TextureFilterer::TextureFilterer(std::string_view filter_name, u16 scale_factor) {
+    read_fbo.Create();
+    draw_fbo.Create();
     Reset(filter_name, scale_factor);
 }
 
@@ -53,6 +58,8 @@ bool TextureFilterer::Reset(std::string_view new_filter_name, u16 new_scale_fact
 
     filter_name = iter->first;
     filter = iter->second(new_scale_factor);
+    cache.clear();
+    cache_size = 0;
     return true;
 }
 
@@ -62,17 +69,79 @@ bool TextureFilterer::IsNull() const {
 
 bool TextureFilterer::Filter(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect,
                              const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect,
-                             SurfaceType type) {
+                             SurfaceType type, u64 content_hash) {
 
     // Depth/Stencil texture filtering is not supported for now
     if (IsNull() || (type != SurfaceType::Color && type != SurfaceType::Texture)) {
         return false;
     }
 
+    if (content_hash == 0) {
+        filter->Filter(src_tex, src_rect, dst_tex, dst_rect);
+        return true;
+    }
+
+    std::size_t key = content_hash;
+    Common::HashCombine(key, (u64{dst_rect.GetWidth()} << 32) | dst_rect.GetHeight());
+    Common::HashCombine(key, (u64{src_rect.GetWidth()} << 32) | src_rect.GetHeight());
+
+    if (auto iter = cache.find(key); iter != cache.end()) {
+        CachedResult& result = iter->second;
+        result.last_use = ++use_counter;
+        BlitColor(result.texture.handle, {0, result.height, result.width, 0}, dst_tex.handle,
+                  dst_rect);
+        return true;
+    }
+
     filter->Filter(src_tex, src_rect, dst_tex, dst_rect);
+    CacheResult(key, dst_tex, dst_rect);
     return true;
 }
 
+void TextureFilterer::BlitColor(GLuint src_tex, Common::Rectangle<u32> src_rect, GLuint dst_tex,
+                                Common::Rectangle<u32> dst_rect) {
+    OpenGLState prev_state = OpenGLState::GetCurState();
+    SCOPE_EXIT({ prev_state.Apply(); });
+
+    OpenGLState state;
+    state.draw.read_framebuffer = read_fbo.handle;
+    state.draw.draw_framebuffer = draw_fbo.handle;
+    state.Apply();
+
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, src_tex, 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dst_tex, 0);
+
+    glBlitFramebuffer(src_rect.left, src_rect.bottom, src_rect.right, src_rect.top, dst_rect.left,
+                      dst_rect.bottom, dst_rect.right, dst_rect.top, GL_COLOR_BUFFER_BIT,
+                      GL_NEAREST);
+}
+
+void TextureFilterer::CacheResult(u64 key, const OGLTexture& dst_tex,
+                                  Common::Rectangle<u32> dst_rect) {
+    const u32 width = dst_rect.GetWidth();
+    const u32 height = dst_rect.GetHeight();
+    const std::size_t size = std::size_t{width} * height * 4;
+    if (size > MAX_CACHE_SIZE / 4) {
+        return;
+    }
+
+    while (cache_size + size > MAX_CACHE_SIZE) {
+        const auto oldest = std::min_element(cache.begin(), cache.end(), [](auto& a, auto& b) {
+            return a.second.last_use < b.second.last_use;
+        });
+        cache_size -= std::size_t{oldest->second.width} * oldest->second.height * 4;
+        cache.erase(oldest);
+    }
+
+    CachedResult result{.width = width, .height = height, .last_use = ++use_counter};
+    result.texture.Create();
+    result.texture.Allocate(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+    BlitColor(dst_tex.handle, dst_rect, result.texture.handle, {0, height, width, 0});
+
+    cache_size += size;
+    cache.emplace(key, std::move(result));
+}
+
 std::vector<std::string_view> TextureFilterer::GetFilterNames() {
     std::vector<std::string_view> ret;
     std::transform(filter_map.begin(), filter_map.end(), std::back_inserter(ret),
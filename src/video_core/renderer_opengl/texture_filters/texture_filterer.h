@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 #include "video_core/rasterizer_cache/pixel_format.h"
 #include "video_core/renderer_opengl/texture_filters/texture_filter_base.h"
@@ -25,15 +26,40 @@ public:
     // Returns true if there is no active filter
     bool IsNull() const;
 
-    // Returns true if the texture was able to be filtered
+    // Returns true if the texture was able to be filtered. A non-zero content hash identifies the
+    // source pixels, so that the result can be reused when the same data is uploaded again.
     bool Filter(const OGLTexture& src_tex, Common::Rectangle<u32> src_rect,
-                const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect, SurfaceType type);
+                const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect, SurfaceType type,
+                u64 content_hash = 0);
 
     static std::vector<std::string_view> GetFilterNames();
 
 private:
+    /// Maximum memory used by the cached filter results
+    static constexpr std::size_t MAX_CACHE_SIZE = 64 * 1024 * 1024;
+
+    struct CachedResult {
+        OGLTexture texture;
+        u32 width;
+        u32 height;
+        u64 last_use;
+    };
+
+    /// Copies a region between two color textures, converting the format if needed
+    void BlitColor(GLuint src_tex, Common::Rectangle<u32> src_rect, GLuint dst_tex,
+                   Common::Rectangle<u32> dst_rect);
+
+    /// Stores the filtered region of the texture, evicting the least recently used results
+    void CacheResult(u64 key, const OGLTexture& dst_tex, Common::Rectangle<u32> dst_rect);
+
     std::string_view filter_name = NONE;
     std::unique_ptr<TextureFilterBase> filter;
+
+    std::unordered_map<u64, CachedResult> cache;
+    std::size_t cache_size = 0;
+    u64 use_counter = 0;
+    OGLFramebuffer read_fbo;
+    OGLFramebuffer draw_fbo;
 };
 
 } // namespace OpenGL
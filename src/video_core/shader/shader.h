@@ -290,7 +290,7 @@ struct ShaderSetup {
 
     u64 GetProgramCodeHash() {
         if (program_code_hash_dirty) {
-            program_code_hash = Common::ComputeHash64(&program_code, sizeof(program_code));
+            program_code_hash = Common::ComputeBulkHash64(&program_code, sizeof(program_code));
             program_code_hash_dirty = false;
         }
         return program_code_hash;
@@ -298,7 +298,7 @@ struct ShaderSetup {
 
     u64 GetSwizzleDataHash() {
         if (swizzle_data_hash_dirty) {
-            swizzle_data_hash = Common::ComputeHash64(&swizzle_data, sizeof(swizzle_data));
+            swizzle_data_hash = Common::ComputeBulkHash64(&swizzle_data, sizeof(swizzle_data));
             swizzle_data_hash_dirty = false;
         }
         return swizzle_data_hash;
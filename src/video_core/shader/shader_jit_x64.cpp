@@ -12,6 +12,8 @@
 
 namespace Pica::Shader {
 
+MICROPROFILE_DEFINE(GPU_ShaderJit, "GPU", "Shader JIT Compile", MP_RGB(50, 100, 240));
+
 JitX64Engine::JitX64Engine() = default;
 JitX64Engine::~JitX64Engine() = default;
 
@@ -25,13 +27,24 @@ void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     u64 cache_key = code_hash ^ swizzle_hash;
     auto iter = cache.find(cache_key);
     if (iter != cache.end()) {
-        setup.engine_data.cached_shader = iter->second.get();
-    } else {
-        auto shader = std::make_unique<JitShader>();
-        shader->Compile(&setup.program_code, &setup.swizzle_data);
-        setup.engine_data.cached_shader = shader.get();
-        cache.emplace_hint(iter, cache_key, std::move(shader));
+        lru_list.splice(lru_list.begin(), lru_list, iter->second.lru_entry);
+        setup.engine_data.cached_shader = iter->second.shader.get();
+        return;
+    }
+
+    // Only setups that have not called SetupBatch since can still refer to the evicted program,
+    // and those always do so again before running it.
+    if (cache.size() >= MAX_CACHED_SHADERS) {
+        cache.erase(lru_list.back());
+        lru_list.pop_back();
     }
+
+    MICROPROFILE_SCOPE(GPU_ShaderJit);
+    auto shader = std::make_unique<JitShader>();
+    shader->Compile(&setup.program_code, &setup.swizzle_data);
+    setup.engine_data.cached_shader = shader.get();
+    lru_list.push_front(cache_key);
+    cache.emplace(cache_key, CachedShader{std::move(shader), lru_list.begin()});
 }
 
 MICROPROFILE_DECLARE(GPU_Shader);
@@ -7,6 +7,7 @@
 #include "common/arch.h"
 #if CITRA_ARCH(x86_64)
 
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include "common/common_types.h"
@@ -25,7 +26,16 @@ public:
     void Run(const ShaderSetup& setup, UnitState& state) const override;
 
 private:
-    std::unordered_map<u64, std::unique_ptr<JitShader>> cache;
+    /// Maximum number of compiled programs kept, each one reserves MAX_SHADER_SIZE bytes of code
+    static constexpr std::size_t MAX_CACHED_SHADERS = 256;
+
+    struct CachedShader {
+        std::unique_ptr<JitShader> shader;
+        std::list<u64>::iterator lru_entry;
+    };
+
+    std::unordered_map<u64, CachedShader> cache;
+    std::list<u64> lru_list; ///< Keys of the cached programs, most recently used first
 };
 
 } // namespace Pica::Shader
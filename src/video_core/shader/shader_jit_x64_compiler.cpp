@@ -379,15 +379,23 @@ void JitShader::Compile_DP3(Instruction instr) {
 
     Compile_SanitizedMul(SRC1, SRC2, SCRATCH);
 
-    movaps(SRC2, SRC1);
-    shufps(SRC2, SRC2, _MM_SHUFFLE(1, 1, 1, 1));
+    if (Common::GetCPUCaps().sse4_1) {
+        // Replace the 4th component with -0.0, which leaves any z + w sum unchanged. The two
+        // horizontal adds then compute (x + y) + z in every component, as the sequence below.
+        blendps(SRC1, NEGBIT, 0b1000);
+        haddps(SRC1, SRC1);
+        haddps(SRC1, SRC1);
+    } else {
+        movaps(SRC2, SRC1);
+        shufps(SRC2, SRC2, _MM_SHUFFLE(1, 1, 1, 1));
 
-    movaps(SRC3, SRC1);
-    shufps(SRC3, SRC3, _MM_SHUFFLE(2, 2, 2, 2));
+        movaps(SRC3, SRC1);
+        shufps(SRC3, SRC3, _MM_SHUFFLE(2, 2, 2, 2));
 
-    shufps(SRC1, SRC1, _MM_SHUFFLE(0, 0, 0, 0));
-    addps(SRC1, SRC2);
-    addps(SRC1, SRC3);
+        shufps(SRC1, SRC1, _MM_SHUFFLE(0, 0, 0, 0));
+        addps(SRC1, SRC2);
+        addps(SRC1, SRC3);
+    }
 
     Compile_DestEnable(instr, SRC1);
 }
@@ -15,6 +15,7 @@
 #include "video_core/shader/shader.h"
 #include "video_core/swrasterizer/clipper.h"
 #include "video_core/swrasterizer/rasterizer.h"
+#include "video_core/swrasterizer/tile_rasterizer.h"
 
 using Pica::Rasterizer::Vertex;
 
@@ -84,9 +85,71 @@ static void InitScreenCoordinates(Vertex& vtx) {
     vtx.screenpos[2] = vtx.pos.z * inv_w;
 }
 
-void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const OutputVertex& v2) {
+/// Sends a triangle of the clipped polygon to the rasterizer
+static void SubmitTriangle(Vertex& vtx0, Vertex& vtx1, Vertex& vtx2, std::size_t index,
+                           std::size_t count, Rasterizer::TileRasterizer* tile_rasterizer) {
+    LOG_TRACE(
+        Render_Software,
+        "Triangle {}/{} at position ({:.3}, {:.3}, {:.3}, {:.3f}), "
+        "({:.3}, {:.3}, {:.3}, {:.3}), ({:.3}, {:.3}, {:.3}, {:.3}) and "
+        "screen position ({:.2}, {:.2}, {:.2}), ({:.2}, {:.2}, {:.2}), ({:.2}, {:.2}, {:.2})",
+        index + 1, count, vtx0.pos.x.ToFloat32(), vtx0.pos.y.ToFloat32(), vtx0.pos.z.ToFloat32(),
+        vtx0.pos.w.ToFloat32(), vtx1.pos.x.ToFloat32(), vtx1.pos.y.ToFloat32(),
+        vtx1.pos.z.ToFloat32(), vtx1.pos.w.ToFloat32(), vtx2.pos.x.ToFloat32(),
+        vtx2.pos.y.ToFloat32(), vtx2.pos.z.ToFloat32(), vtx2.pos.w.ToFloat32(),
+        vtx0.screenpos.x.ToFloat32(), vtx0.screenpos.y.ToFloat32(), vtx0.screenpos.z.ToFloat32(),
+        vtx1.screenpos.x.ToFloat32(), vtx1.screenpos.y.ToFloat32(), vtx1.screenpos.z.ToFloat32(),
+        vtx2.screenpos.x.ToFloat32(), vtx2.screenpos.y.ToFloat32(), vtx2.screenpos.z.ToFloat32());
+
+    // Culled triangles aren't worth queueing for the rasterizer threads
+    if (Rasterizer::IsCulled(vtx0, vtx1, vtx2)) {
+        return;
+    }
+
+    if (tile_rasterizer) {
+        tile_rasterizer->AddTriangle(vtx0, vtx1, vtx2);
+    } else {
+        Rasterizer::ProcessTriangle(vtx0, vtx1, vtx2);
+    }
+}
+
+void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const OutputVertex& v2,
+                     Rasterizer::TileRasterizer* tile_rasterizer) {
     using boost::container::static_vector;
 
+    // NOTE: We clip against a w=epsilon plane to guarantee that the output has a positive w value.
+    // TODO: Not sure if this is a valid approach. Also should probably instead use the smallest
+    //       epsilon possible within float24 accuracy.
+    static const float24 EPSILON = float24::FromFloat32(0.00001f);
+    static const float24 f0 = float24::FromFloat32(0.0);
+    static const float24 f1 = float24::FromFloat32(1.0);
+    static const std::array<ClippingEdge, 7> clipping_edges = {{
+        {Common::MakeVec(-f1, f0, f0, f1)}, // x = +w
+        {Common::MakeVec(f1, f0, f0, f1)},  // x = -w
+        {Common::MakeVec(f0, -f1, f0, f1)}, // y = +w
+        {Common::MakeVec(f0, f1, f0, f1)},  // y = -w
+        {Common::MakeVec(f0, f0, -f1, f0)}, // z =  0
+        {Common::MakeVec(f0, f0, f1, f1)},  // z = -w
+        {Common::MakeVec(f0, f0, f0, f1),
+         Common::Vec4<float24>(f0, f0, f0, EPSILON)}, // w = EPSILON
+    }};
+
+    const bool clip_enable = g_state.regs.rasterizer.clip_enable;
+    const ClippingEdge custom_edge{clip_enable ? g_state.regs.rasterizer.GetClipCoef()
+                                               : Common::Vec4<float24>{f0, f0, f0, f1}};
+
+    // The planes each vertex is outside of, one bit per plane
+    const auto GetOutCode = [&](const Vertex& vertex) {
+        u32 out_code = 0;
+        for (std::size_t i = 0; i < clipping_edges.size(); i++) {
+            out_code |= clipping_edges[i].IsOutSide(vertex) ? 1U << i : 0;
+        }
+        if (clip_enable && custom_edge.IsOutSide(vertex)) {
+            out_code |= 1U << clipping_edges.size();
+        }
+        return out_code;
+    };
+
     // Clipping a planar n-gon against a plane will remove at least 1 vertex and introduces 2 at
     // the new edge (or less in degenerate cases). As such, we can say that each clipping plane
     // introduces at most 1 new vertex to the polygon. Since we start with a triangle and have a
@@ -95,6 +158,15 @@ void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const Outpu
     static_vector<Vertex, MAX_VERTICES> buffer_a = {v0, v1, v2};
     static_vector<Vertex, MAX_VERTICES> buffer_b;
 
+    const u32 out_code0 = GetOutCode(buffer_a[0]);
+    const u32 out_code1 = GetOutCode(buffer_a[1]);
+    const u32 out_code2 = GetOutCode(buffer_a[2]);
+
+    // Nothing is left of a triangle whose vertices are all outside of the same plane
+    if ((out_code0 & out_code1 & out_code2) != 0) {
+        return;
+    }
+
     auto FlipQuaternionIfOpposite = [](auto& a, const auto& b) {
         if (Common::Dot(a, b) < float24::Zero())
             a = a * float24::FromFloat32(-1.0f);
@@ -105,28 +177,19 @@ void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const Outpu
     FlipQuaternionIfOpposite(buffer_a[1].quat, buffer_a[0].quat);
     FlipQuaternionIfOpposite(buffer_a[2].quat, buffer_a[0].quat);
 
+    // Most triangles are inside of all planes, and clipping would leave them unchanged
+    if ((out_code0 | out_code1 | out_code2) == 0) {
+        InitScreenCoordinates(buffer_a[0]);
+        InitScreenCoordinates(buffer_a[1]);
+        InitScreenCoordinates(buffer_a[2]);
+        SubmitTriangle(buffer_a[0], buffer_a[1], buffer_a[2], 0, 1, tile_rasterizer);
+        return;
+    }
+
     auto* output_list = &buffer_a;
     auto* input_list = &buffer_b;
 
-    // NOTE: We clip against a w=epsilon plane to guarantee that the output has a positive w value.
-    // TODO: Not sure if this is a valid approach. Also should probably instead use the smallest
-    //       epsilon possible within float24 accuracy.
-    static const float24 EPSILON = float24::FromFloat32(0.00001f);
-    static const float24 f0 = float24::FromFloat32(0.0);
-    static const float24 f1 = float24::FromFloat32(1.0);
-    static const std::array<ClippingEdge, 7> clipping_edges = {{
-        {Common::MakeVec(-f1, f0, f0, f1)}, // x = +w
-        {Common::MakeVec(f1, f0, f0, f1)},  // x = -w
-        {Common::MakeVec(f0, -f1, f0, f1)}, // y = +w
-        {Common::MakeVec(f0, f1, f0, f1)},  // y = -w
-        {Common::MakeVec(f0, f0, -f1, f0)}, // z =  0
-        {Common::MakeVec(f0, f0, f1, f1)},  // z = -w
-        {Common::MakeVec(f0, f0, f0, f1),
-         Common::Vec4<float24>(f0, f0, f0, EPSILON)}, // w = EPSILON
-    }};
-
     // Simple implementation of the Sutherland-Hodgman clipping algorithm.
-    // TODO: Make this less inefficient (currently lots of useless buffering overhead happens here)
     auto Clip = [&](const ClippingEdge& edge) {
         std::swap(input_list, output_list);
         output_list->clear();
@@ -148,16 +211,20 @@ void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const Outpu
         }
     };
 
-    for (auto edge : clipping_edges) {
-        Clip(edge);
+    // Only the planes that a vertex is outside of can change the polygon
+    const u32 crossed_planes = out_code0 | out_code1 | out_code2;
+    for (std::size_t i = 0; i < clipping_edges.size(); i++) {
+        if ((crossed_planes & (1U << i)) == 0) {
+            continue;
+        }
+        Clip(clipping_edges[i]);
 
         // Need to have at least a full triangle to continue...
         if (output_list->size() < 3)
             return;
     }
 
-    if (g_state.regs.rasterizer.clip_enable) {
-        ClippingEdge custom_edge{g_state.regs.rasterizer.GetClipCoef()};
+    if ((crossed_planes & (1U << clipping_edges.size())) != 0) {
         Clip(custom_edge);
 
         if (output_list->size() < 3)
@@ -168,28 +235,9 @@ void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const Outpu
     InitScreenCoordinates((*output_list)[1]);
 
     for (std::size_t i = 0; i < output_list->size() - 2; i++) {
-        Vertex& vtx0 = (*output_list)[0];
-        Vertex& vtx1 = (*output_list)[i + 1];
-        Vertex& vtx2 = (*output_list)[i + 2];
-
-        InitScreenCoordinates(vtx2);
-
-        LOG_TRACE(
-            Render_Software,
-            "Triangle {}/{} at position ({:.3}, {:.3}, {:.3}, {:.3f}), "
-            "({:.3}, {:.3}, {:.3}, {:.3}), ({:.3}, {:.3}, {:.3}, {:.3}) and "
-            "screen position ({:.2}, {:.2}, {:.2}), ({:.2}, {:.2}, {:.2}), ({:.2}, {:.2}, {:.2})",
-            i + 1, output_list->size() - 2, vtx0.pos.x.ToFloat32(), vtx0.pos.y.ToFloat32(),
-            vtx0.pos.z.ToFloat32(), vtx0.pos.w.ToFloat32(), vtx1.pos.x.ToFloat32(),
-            vtx1.pos.y.ToFloat32(), vtx1.pos.z.ToFloat32(), vtx1.pos.w.ToFloat32(),
-            vtx2.pos.x.ToFloat32(), vtx2.pos.y.ToFloat32(), vtx2.pos.z.ToFloat32(),
-            vtx2.pos.w.ToFloat32(), vtx0.screenpos.x.ToFloat32(), vtx0.screenpos.y.ToFloat32(),
-            vtx0.screenpos.z.ToFloat32(), vtx1.screenpos.x.ToFloat32(),
-            vtx1.screenpos.y.ToFloat32(), vtx1.screenpos.z.ToFloat32(),
-            vtx2.screenpos.x.ToFloat32(), vtx2.screenpos.y.ToFloat32(),
-            vtx2.screenpos.z.ToFloat32());
-
-        Rasterizer::ProcessTriangle(vtx0, vtx1, vtx2);
+        InitScreenCoordinates((*output_list)[i + 2]);
+        SubmitTriangle((*output_list)[0], (*output_list)[i + 1], (*output_list)[i + 2], i,
+                       output_list->size() - 2, tile_rasterizer);
     }
 }
 
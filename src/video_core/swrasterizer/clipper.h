@@ -9,11 +9,17 @@ namespace Shader {
 struct OutputVertex;
 }
 
+namespace Rasterizer {
+class TileRasterizer;
+}
+
 namespace Clipper {
 
 using Shader::OutputVertex;
 
-void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const OutputVertex& v2);
+/// Clips the triangle and rasterizes the resulting triangles, or bins them into tile_rasterizer
+void ProcessTriangle(const OutputVertex& v0, const OutputVertex& v1, const OutputVertex& v2,
+                     Rasterizer::TileRasterizer* tile_rasterizer = nullptr);
 
 } // namespace Clipper
 } // namespace Pica
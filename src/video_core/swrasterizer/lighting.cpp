@@ -7,21 +7,30 @@
 
 namespace Pica {
 
-static float LookupLightingLut(const Pica::State::Lighting& lighting, std::size_t lut_index,
-                               u8 index, float delta) {
+void LightingTables::Decode(const State::Lighting& state) {
+    for (std::size_t lut_index = 0; lut_index < luts.size(); ++lut_index) {
+        for (std::size_t i = 0; i < luts[lut_index].size(); ++i) {
+            const auto& lut = state.luts[lut_index][i];
+            luts[lut_index][i] = {lut.ToFloat(), lut.DiffToFloat()};
+        }
+    }
+}
+
+static float LookupLightingLut(const LightingTables& lighting, std::size_t lut_index, u8 index,
+                               float delta) {
     ASSERT_MSG(lut_index < lighting.luts.size(), "Out of range lut");
     ASSERT_MSG(index < lighting.luts[lut_index].size(), "Out of range index");
 
     const auto& lut = lighting.luts[lut_index][index];
 
-    float lut_value = lut.ToFloat();
-    float lut_diff = lut.DiffToFloat();
+    float lut_value = lut.x;
+    float lut_diff = lut.y;
 
     return lut_value + lut_diff * delta;
 }
 
 std::tuple<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::State::Lighting& lighting_state,
+    const Pica::LightingRegs& lighting, const LightingTables& lighting_tables,
     const Common::Quaternion<float>& normquat, const Common::Vec3<float>& view,
     const Common::Vec4<u8> (&texture_color)[4]) {
 
@@ -101,7 +110,7 @@ std::tuple<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             u8 lutindex =
                 static_cast<u8>(std::clamp(std::floor(sample_loc * 256.0f), 0.0f, 255.0f));
             float delta = sample_loc * 256 - lutindex;
-            dist_atten = LookupLightingLut(lighting_state, lut, lutindex, delta);
+            dist_atten = LookupLightingLut(lighting_tables, lut, lutindex, delta);
         }
 
         auto GetLutValue = [&](LightingRegs::LightingLutInput input, bool abs,
@@ -168,7 +177,7 @@ std::tuple<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
             }
 
             float scale = lighting.lut_scale.GetScale(scale_enum);
-            return scale * LookupLightingLut(lighting_state, static_cast<std::size_t>(sampler),
+            return scale * LookupLightingLut(lighting_tables, static_cast<std::size_t>(sampler),
                                              index, delta);
         };
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <array>
 #include <tuple>
 #include "common/quaternion.h"
 #include "common/vector_math.h"
@@ -11,8 +12,16 @@
 
 namespace Pica {
 
+/// The lighting LUTs decoded to floats, so that fragments don't convert the entries
+struct LightingTables {
+    /// The values and the differences of the entries of each LUT
+    std::array<std::array<Common::Vec2<float>, 256>, 24> luts;
+
+    void Decode(const State::Lighting& state);
+};
+
 std::tuple<Common::Vec4<u8>, Common::Vec4<u8>> ComputeFragmentsColors(
-    const Pica::LightingRegs& lighting, const Pica::State::Lighting& lighting_state,
+    const Pica::LightingRegs& lighting, const LightingTables& lighting_tables,
     const Common::Quaternion<float>& normquat, const Common::Vec3<float>& view,
     const Common::Vec4<u8> (&texture_color)[4]);
 
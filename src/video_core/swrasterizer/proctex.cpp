@@ -14,14 +14,31 @@ using ProcTexShift = TexturingRegs::ProcTexShift;
 using ProcTexCombiner = TexturingRegs::ProcTexCombiner;
 using ProcTexFilter = TexturingRegs::ProcTexFilter;
 
-static float LookupLUT(const std::array<State::ProcTex::ValueEntry, 128>& lut, float coord) {
+static void DecodeValueTable(const std::array<State::ProcTex::ValueEntry, 128>& lut,
+                             ProcTexTables::ValueTable& table) {
+    for (std::size_t i = 0; i < lut.size(); ++i) {
+        table[i] = {lut[i].ToFloat(), lut[i].DiffToFloat()};
+    }
+}
+
+void ProcTexTables::Decode(const State::ProcTex& state) {
+    DecodeValueTable(state.noise_table, noise);
+    DecodeValueTable(state.color_map_table, color_map);
+    DecodeValueTable(state.alpha_map_table, alpha_map);
+    for (std::size_t i = 0; i < color.size(); ++i) {
+        color[i] = state.color_table[i].ToVector().Cast<float>();
+        color_diff[i] = state.color_diff_table[i].ToVector().Cast<float>();
+    }
+}
+
+static float LookupLUT(const ProcTexTables::ValueTable& lut, float coord) {
     // For NoiseLUT/ColorMap/AlphaMap, coord=0.0 is lut[0], coord=127.0/128.0 is lut[127] and
     // coord=1.0 is lut[127]+lut_diff[127]. For other indices, the result is interpolated using
     // value entries and difference entries.
     coord *= 128;
     const int index_int = std::min(static_cast<int>(coord), 127);
     const float frac = coord - index_int;
-    return lut[index_int].ToFloat() + frac * lut[index_int].DiffToFloat();
+    return lut[index_int].x + frac * lut[index_int].y;
 }
 
 // These function are used to generate random noise for procedural texture. Their results are
@@ -45,7 +62,7 @@ static float NoiseRand2D(unsigned int x, unsigned int y) {
     return -1.0f + v2 * 2.0f / 15.0f;
 }
 
-static float NoiseCoef(float u, float v, const TexturingRegs& regs, const State::ProcTex& state) {
+static float NoiseCoef(float u, float v, const TexturingRegs& regs, const ProcTexTables& tables) {
     const float freq_u = float16::FromRaw(regs.proctex_noise_frequency.u).ToFloat32();
     const float freq_v = float16::FromRaw(regs.proctex_noise_frequency.v).ToFloat32();
     const float phase_u = float16::FromRaw(regs.proctex_noise_u.phase).ToFloat32();
@@ -61,8 +78,8 @@ static float NoiseCoef(float u, float v, const TexturingRegs& regs, const State:
     const float g1 = NoiseRand2D(x_int + 1, y_int) * (x_frac + y_frac - 1);
     const float g2 = NoiseRand2D(x_int, y_int + 1) * (x_frac + y_frac - 1);
     const float g3 = NoiseRand2D(x_int + 1, y_int + 1) * (x_frac + y_frac - 2);
-    const float x_noise = LookupLUT(state.noise_table, x_frac);
-    const float y_noise = LookupLUT(state.noise_table, y_frac);
+    const float x_noise = LookupLUT(tables.noise, x_frac);
+    const float y_noise = LookupLUT(tables.noise, y_frac);
     return Common::BilinearInterp(g0, g1, g2, g3, x_noise, y_noise);
 }
 
@@ -113,7 +130,7 @@ static void ClampCoord(float& coord, ProcTexClamp mode) {
 }
 
 static float CombineAndMap(float u, float v, ProcTexCombiner combiner,
-                           const std::array<State::ProcTex::ValueEntry, 128>& map_table) {
+                           const ProcTexTables::ValueTable& map_table) {
     float f;
     switch (combiner) {
     case ProcTexCombiner::U:
@@ -154,7 +171,8 @@ static float CombineAndMap(float u, float v, ProcTexCombiner combiner,
     return LookupLUT(map_table, f);
 }
 
-Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const State::ProcTex& state) {
+Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const State::ProcTex& state,
+                         const ProcTexTables& tables) {
     u = std::abs(u);
     v = std::abs(v);
 
@@ -164,7 +182,7 @@ Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const Stat
 
     // Generate noise
     if (regs.proctex.noise_enable) {
-        float noise = NoiseCoef(u, v, regs, state);
+        float noise = NoiseCoef(u, v, regs, tables);
         u += noise * regs.proctex_noise_u.amplitude / 4095.0f;
         v += noise * regs.proctex_noise_v.amplitude / 4095.0f;
         u = std::abs(u);
@@ -180,7 +198,7 @@ Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const Stat
     ClampCoord(v, regs.proctex.v_clamp);
 
     // Combine and map
-    const float lut_coord = CombineAndMap(u, v, regs.proctex.color_combiner, state.color_map_table);
+    const float lut_coord = CombineAndMap(u, v, regs.proctex.color_combiner, tables.color_map);
 
     // Look up the color
     // For the color lut, coord=0.0 is lut[offset] and coord=1.0 is lut[offset+width-1]
@@ -195,9 +213,7 @@ Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const Stat
     case ProcTexFilter::LinearMipmapNearest: {
         const int index_int = static_cast<int>(index);
         const float frac = index - index_int;
-        const auto color_value = state.color_table[index_int].ToVector().Cast<float>();
-        const auto color_diff = state.color_diff_table[index_int].ToVector().Cast<float>();
-        final_color = (color_value + frac * color_diff).Cast<u8>();
+        final_color = (tables.color[index_int] + frac * tables.color_diff[index_int]).Cast<u8>();
         break;
     }
     case ProcTexFilter::Nearest:
@@ -211,7 +227,7 @@ Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const Stat
         // Note: in separate alpha mode, the alpha channel skips the color LUT look up stage. It
         // uses the output of CombineAndMap directly instead.
         const float final_alpha =
-            CombineAndMap(u, v, regs.proctex.alpha_combiner, state.alpha_map_table);
+            CombineAndMap(u, v, regs.proctex.alpha_combiner, tables.alpha_map);
         return Common::MakeVec<u8>(final_color.rgb(), static_cast<u8>(final_alpha * 255));
     } else {
         return final_color;
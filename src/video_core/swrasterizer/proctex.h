@@ -4,13 +4,28 @@
 
 #pragma once
 
+#include <array>
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica_state.h"
 
 namespace Pica::Rasterizer {
 
+/// The procedural texture tables decoded to floats, so that fragments don't convert the entries
+struct ProcTexTables {
+    using ValueTable = std::array<Common::Vec2<float>, 128>; ///< Values and differences
+
+    ValueTable noise;
+    ValueTable color_map;
+    ValueTable alpha_map;
+    std::array<Common::Vec4<float>, 256> color;
+    std::array<Common::Vec4<float>, 256> color_diff;
+
+    void Decode(const State::ProcTex& state);
+};
+
 /// Generates procedural texture color for the given coordinates
-Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const State::ProcTex& state);
+Common::Vec4<u8> ProcTex(float u, float v, const TexturingRegs& regs, const State::ProcTex& state,
+                         const ProcTexTables& tables);
 
 } // namespace Pica::Rasterizer
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <tuple>
 #include "common/assert.h"
+#include "common/arch.h"
 #include "common/bit_field.h"
 #include "common/color.h"
 #include "common/common_types.h"
@@ -32,6 +33,12 @@
 #include "video_core/utils.h"
 #include "video_core/video_core.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace Pica::Rasterizer {
 
 // NOTE: Assuming that rasterizer coordinates are 12.4 fixed-point values
@@ -72,6 +79,46 @@ static int SignedArea(const Common::Vec2<Fix12P4>& vtx1, const Common::Vec2<Fix1
     return Common::Cross(vec1, vec2).z;
 };
 
+/// Number of horizontally adjacent pixels whose coverage is tested at once
+constexpr u32 CoverageGroupSize = 4;
+
+/**
+ * Tests which pixels of a group of horizontally adjacent pixels are covered by a triangle.
+ * @param w The barycentric coordinates of the first pixel, including the fill rule biases
+ * @param step The increments of the barycentric coordinates from one pixel to the next
+ * @return A bit per pixel, set if the pixel is covered
+ */
+static u32 GetCoverageMask(const std::array<int, 3>& w, const std::array<int, 3>& step) {
+    // A pixel is outside of the triangle when any of its coordinates is negative, so the sign bit
+    // of the coordinates ORed together is the result
+#if CITRA_ARCH(x86_64)
+    const auto coordinate = [&](std::size_t i) {
+        return _mm_add_epi32(_mm_set1_epi32(w[i]),
+                             _mm_setr_epi32(0, step[i], 2 * step[i], 3 * step[i]));
+    };
+    const __m128i outside = _mm_or_si128(_mm_or_si128(coordinate(0), coordinate(1)), coordinate(2));
+    return ~static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(outside))) & 0xF;
+#elif CITRA_ARCH(arm64)
+    static constexpr std::array<s32, CoverageGroupSize> lanes{0, 1, 2, 3};
+    static constexpr std::array<u32, CoverageGroupSize> bits{1, 2, 4, 8};
+    const int32x4_t lane = vld1q_s32(lanes.data());
+    const auto coordinate = [&](std::size_t i) {
+        return vmlaq_n_s32(vdupq_n_s32(w[i]), lane, step[i]);
+    };
+    const int32x4_t outside = vorrq_s32(vorrq_s32(coordinate(0), coordinate(1)), coordinate(2));
+    return vaddvq_u32(vandq_u32(vcgezq_s32(outside), vld1q_u32(bits.data())));
+#else
+    u32 mask = 0;
+    for (u32 pixel = 0; pixel < CoverageGroupSize; ++pixel) {
+        const int i = static_cast<int>(pixel);
+        if (((w[0] + step[0] * i) | (w[1] + step[1] * i) | (w[2] + step[2] * i)) >= 0) {
+            mask |= 1u << pixel;
+        }
+    }
+    return mask;
+#endif
+}
+
 /// Convert a 3D vector for cube map coordinates to 2D texture coordinates along with the face name
 static std::tuple<float24, float24, float24, PAddr> ConvertCubeCoord(float24 u, float24 v,
                                                                      float24 w,
@@ -119,25 +166,49 @@ static std::tuple<float24, float24, float24, PAddr> ConvertCubeCoord(float24 u,
 
 MICROPROFILE_DEFINE(GPU_Rasterization, "GPU", "Rasterization", MP_RGB(50, 50, 240));
 
+static ProcTexTables proctex_tables;
+static LightingTables lighting_tables;
+
+void UpdateProcTexTables() {
+    proctex_tables.Decode(g_state.proctex);
+}
+
+void UpdateLightingTables() {
+    lighting_tables.Decode(g_state.lighting);
+}
+
+// vertex positions in rasterizer coordinates
+static Fix12P4 FloatToFix(float24 flt) {
+    // TODO: Rounding here is necessary to prevent garbage pixels at
+    //       triangle borders. Is it that the correct solution, though?
+    return Fix12P4(static_cast<unsigned short>(round(flt.ToFloat32() * 16.0f)));
+}
+
+static Common::Vec3<Fix12P4> ScreenToRasterizerCoordinates(const Common::Vec3<float24>& vec) {
+    return Common::Vec3<Fix12P4>{FloatToFix(vec.x), FloatToFix(vec.y), FloatToFix(vec.z)};
+}
+
+bool IsCulled(const Vertex& v0, const Vertex& v1, const Vertex& v2) {
+    const auto cull_mode = g_state.regs.rasterizer.cull_mode;
+    if (cull_mode == RasterizerRegs::CullMode::KeepAll) {
+        return false;
+    }
+    // The same test as ProcessTriangle, which reverses clockwise triangles when they're kept
+    const int area = SignedArea(ScreenToRasterizerCoordinates(v0.screenpos).xy(),
+                                ScreenToRasterizerCoordinates(v1.screenpos).xy(),
+                                ScreenToRasterizerCoordinates(v2.screenpos).xy());
+    return cull_mode == RasterizerRegs::CullMode::KeepClockWise ? area >= 0 : area <= 0;
+}
+
 /**
  * Helper function for ProcessTriangle with the "reversed" flag to allow for implementing
  * culling via recursion.
  */
 static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Vertex& v2,
-                                    bool reversed = false) {
+                                    u32 first_row, u32 end_row, bool reversed = false) {
     const auto& regs = g_state.regs;
     MICROPROFILE_SCOPE(GPU_Rasterization);
 
-    // vertex positions in rasterizer coordinates
-    static auto FloatToFix = [](float24 flt) {
-        // TODO: Rounding here is necessary to prevent garbage pixels at
-        //       triangle borders. Is it that the correct solution, though?
-        return Fix12P4(static_cast<unsigned short>(round(flt.ToFloat32() * 16.0f)));
-    };
-    static auto ScreenToRasterizerCoordinates = [](const Common::Vec3<float24>& vec) {
-        return Common::Vec3<Fix12P4>{FloatToFix(vec.x), FloatToFix(vec.y), FloatToFix(vec.z)};
-    };
-
     Common::Vec3<Fix12P4> vtxpos[3]{ScreenToRasterizerCoordinates(v0.screenpos),
                                     ScreenToRasterizerCoordinates(v1.screenpos),
                                     ScreenToRasterizerCoordinates(v2.screenpos)};
@@ -145,13 +216,13 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
     if (regs.rasterizer.cull_mode == RasterizerRegs::CullMode::KeepAll) {
         // Make sure we always end up with a triangle wound counter-clockwise
         if (!reversed && SignedArea(vtxpos[0].xy(), vtxpos[1].xy(), vtxpos[2].xy()) <= 0) {
-            ProcessTriangleInternal(v0, v2, v1, true);
+            ProcessTriangleInternal(v0, v2, v1, first_row, end_row, true);
             return;
         }
     } else {
         if (!reversed && regs.rasterizer.cull_mode == RasterizerRegs::CullMode::KeepClockWise) {
             // Reverse vertex order and use the CCW code path.
-            ProcessTriangleInternal(v0, v2, v1, true);
+            ProcessTriangleInternal(v0, v2, v1, first_row, end_row, true);
             return;
         }
 
@@ -185,6 +256,10 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
     max_x = ((max_x + Fix12P4::FracMask()) & Fix12P4::IntMask());
     max_y = ((max_y + Fix12P4::FracMask()) & Fix12P4::IntMask());
 
+    // Only cover the requested rows of the framebuffer
+    min_y = static_cast<u16>(std::max<u32>(min_y, first_row << 4));
+    max_y = static_cast<u16>(std::min<u32>(max_y, end_row << 4));
+
     // Triangle filling rules: Pixels on the right-sided edge or on flat bottom edges are not
     // drawn. Pixels on any other triangle border are drawn. This is implemented with three bias
     // values which are added to the barycentric coordinates w0, w1 and w2, respectively.
@@ -210,6 +285,14 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
     int bias2 =
         IsRightSideOrFlatBottomEdge(vtxpos[2].xy(), vtxpos[0].xy(), vtxpos[1].xy()) ? -1 : 0;
 
+    // The barycentric coordinates are linear in x, these are their increments from one pixel to
+    // the one on its right
+    const std::array<int, 3> w_step{
+        -(vtxpos[2].y - vtxpos[1].y) * 0x10,
+        -(vtxpos[0].y - vtxpos[2].y) * 0x10,
+        -(vtxpos[1].y - vtxpos[0].y) * 0x10,
+    };
+
     auto w_inverse = Common::MakeVec(v0.pos.w, v1.pos.w, v2.pos.w);
 
     auto textures = regs.texturing.GetTextures();
@@ -220,10 +303,35 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
         g_state.regs.framebuffer.framebuffer.depth_format == FramebufferRegs::DepthFormat::D24S8;
     const auto stencil_test = g_state.regs.framebuffer.output_merger.stencil_test;
 
+    const float depth_scale = float24::FromRaw(regs.rasterizer.viewport_depth_range).ToFloat32();
+    const float depth_offset =
+        float24::FromRaw(regs.rasterizer.viewport_depth_near_plane).ToFloat32();
+
     // Enter rasterization loop, starting at the center of the topleft bounding box corner.
     // TODO: Not sure if looping through x first might be faster
+    const u16 first_x = min_x + 8;
     for (u16 y = min_y + 8; y < max_y; y += 0x10) {
-        for (u16 x = min_x + 8; x < max_x; x += 0x10) {
+        std::array<int, 3> group_w{};
+        u32 coverage = 0;
+        for (u16 x = first_x; x < max_x; x += 0x10) {
+            // The coverage is tested for groups of pixels, which are skipped when none is covered
+            const u32 pixel = ((x - first_x) >> 4) % CoverageGroupSize;
+            if (pixel == 0) {
+                group_w = {
+                    bias0 + SignedArea(vtxpos[1].xy(), vtxpos[2].xy(), {x, y}),
+                    bias1 + SignedArea(vtxpos[2].xy(), vtxpos[0].xy(), {x, y}),
+                    bias2 + SignedArea(vtxpos[0].xy(), vtxpos[1].xy(), {x, y}),
+                };
+                coverage = GetCoverageMask(group_w, w_step);
+                if (coverage == 0) {
+                    x += 0x10 * (CoverageGroupSize - 1);
+                    continue;
+                }
+            }
+
+            // If current pixel is not covered by the current primitive
+            if ((coverage & (1u << pixel)) == 0)
+                continue;
 
             // Do not process the pixel if it's inside the scissor box and the scissor mode is set
             // to Exclude
@@ -232,16 +340,12 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
                     continue;
             }
 
-            // Calculate the barycentric coordinates w0, w1 and w2
-            int w0 = bias0 + SignedArea(vtxpos[1].xy(), vtxpos[2].xy(), {x, y});
-            int w1 = bias1 + SignedArea(vtxpos[2].xy(), vtxpos[0].xy(), {x, y});
-            int w2 = bias2 + SignedArea(vtxpos[0].xy(), vtxpos[1].xy(), {x, y});
+            // The barycentric coordinates w0, w1 and w2 of the pixel
+            int w0 = group_w[0] + w_step[0] * static_cast<int>(pixel);
+            int w1 = group_w[1] + w_step[1] * static_cast<int>(pixel);
+            int w2 = group_w[2] + w_step[2] * static_cast<int>(pixel);
             int wsum = w0 + w1 + w2;
 
-            // If current pixel is not covered by the current primitive
-            if (w0 < 0 || w1 < 0 || w2 < 0)
-                continue;
-
             auto baricentric_coordinates =
                 Common::MakeVec(float24::FromFloat32(static_cast<float>(w0)),
                                 float24::FromFloat32(static_cast<float>(w1)),
@@ -257,9 +361,6 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
 
             // Not fully accurate. About 3 bits in precision are missing.
             // Z-Buffer (z / w * scale + offset)
-            float depth_scale = float24::FromRaw(regs.rasterizer.viewport_depth_range).ToFloat32();
-            float depth_offset =
-                float24::FromRaw(regs.rasterizer.viewport_depth_near_plane).ToFloat32();
             float depth = interpolated_z_over_w * depth_scale + depth_offset;
 
             // Potentially switch to W-Buffer
@@ -437,7 +538,8 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
             if (regs.texturing.main_config.texture3_enable) {
                 const auto& proctex_uv = uv[regs.texturing.main_config.texture3_coordinates];
                 texture_color[3] = ProcTex(proctex_uv.u().ToFloat32(), proctex_uv.v().ToFloat32(),
-                                           g_state.regs.texturing, g_state.proctex);
+                                           g_state.regs.texturing, g_state.proctex,
+                                           proctex_tables);
             }
 
             // Texture environment - consists of 6 stages of color and alpha combining.
@@ -475,7 +577,7 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
                     GetInterpolatedAttribute(v0.view.z, v1.view.z, v2.view.z).ToFloat32(),
                 };
                 std::tie(primary_fragment_color, secondary_fragment_color) = ComputeFragmentsColors(
-                    g_state.regs.lighting, g_state.lighting, normquat, view, texture_color);
+                    g_state.regs.lighting, lighting_tables, normquat, view, texture_color);
             }
 
             for (unsigned tev_stage_index = 0; tev_stage_index < tev_stages.size();
@@ -894,8 +996,9 @@ static void ProcessTriangleInternal(const Vertex& v0, const Vertex& v1, const Ve
     }
 }
 
-void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2) {
-    ProcessTriangleInternal(v0, v1, v2);
+void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2, u32 first_row,
+                     u32 end_row) {
+    ProcessTriangleInternal(v0, v1, v2, first_row, end_row);
 }
 
 } // namespace Pica::Rasterizer
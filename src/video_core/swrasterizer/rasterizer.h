@@ -39,6 +39,26 @@ struct Vertex : Shader::OutputVertex {
     }
 };
 
-void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+/// Number of rows addressable by the 12.4 fixed point rasterizer coordinates
+constexpr u32 MAX_FRAMEBUFFER_ROWS = 4096;
+
+/// Returns whether the face culling removes the triangle, which needs its screen coordinates
+bool IsCulled(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+
+/**
+ * Rasterizes the triangle and shades its fragments.
+ * @param first_row First framebuffer row to cover
+ * @param end_row Framebuffer row past the last one to cover
+ */
+void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2, u32 first_row = 0,
+                     u32 end_row = MAX_FRAMEBUFFER_ROWS);
+
+/// Decodes the procedural texture tables of g_state, which have to be decoded after they changed
+/// and before triangles are rasterized
+void UpdateProcTexTables();
+
+/// Decodes the lighting LUTs of g_state, which have to be decoded after they changed and before
+/// triangles are rasterized
+void UpdateLightingTables();
 
 } // namespace Pica::Rasterizer
@@ -2,15 +2,87 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <thread>
+#include "common/settings.h"
+#include "video_core/pica_state.h"
+#include "video_core/regs.h"
 #include "video_core/swrasterizer/clipper.h"
+#include "video_core/swrasterizer/rasterizer.h"
 #include "video_core/swrasterizer/swrasterizer.h"
+#include "video_core/swrasterizer/tile_rasterizer.h"
 
 namespace VideoCore {
 
+SWRasterizer::SWRasterizer() {
+    u32 num_threads = Settings::values.sw_rasterizer_threads.GetValue();
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (num_threads > 1) {
+        tile_rasterizer = std::make_unique<Pica::Rasterizer::TileRasterizer>(num_threads);
+    }
+}
+
+SWRasterizer::~SWRasterizer() = default;
+
 void SWRasterizer::AddTriangle(const Pica::Shader::OutputVertex& v0,
                                const Pica::Shader::OutputVertex& v1,
                                const Pica::Shader::OutputVertex& v2) {
-    Pica::Clipper::ProcessTriangle(v0, v1, v2);
+    // The tables are only written between draws, while no triangle is being rasterized
+    if (proctex_tables_dirty && Pica::g_state.regs.texturing.main_config.texture3_enable) {
+        Pica::Rasterizer::UpdateProcTexTables();
+        proctex_tables_dirty = false;
+    }
+    if (lighting_tables_dirty && !Pica::g_state.regs.lighting.disable) {
+        Pica::Rasterizer::UpdateLightingTables();
+        lighting_tables_dirty = false;
+    }
+    Pica::Clipper::ProcessTriangle(v0, v1, v2, tile_rasterizer.get());
+}
+
+void SWRasterizer::DrawTriangles() {
+    if (tile_rasterizer) {
+        tile_rasterizer->Flush();
+    }
+    ++draws;
+}
+
+void SWRasterizer::NotifyPicaRegisterChanged(u32 id) {
+    switch (id) {
+    case PICA_REG_INDEX(texturing.proctex_lut_data[0]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[1]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[2]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[3]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[4]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[5]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[6]):
+    case PICA_REG_INDEX(texturing.proctex_lut_data[7]):
+        proctex_tables_dirty = true;
+        break;
+
+    case PICA_REG_INDEX(lighting.lut_data[0]):
+    case PICA_REG_INDEX(lighting.lut_data[1]):
+    case PICA_REG_INDEX(lighting.lut_data[2]):
+    case PICA_REG_INDEX(lighting.lut_data[3]):
+    case PICA_REG_INDEX(lighting.lut_data[4]):
+    case PICA_REG_INDEX(lighting.lut_data[5]):
+    case PICA_REG_INDEX(lighting.lut_data[6]):
+    case PICA_REG_INDEX(lighting.lut_data[7]):
+        lighting_tables_dirty = true;
+        break;
+    }
+}
+
+void SWRasterizer::SyncEntireState() {
+    proctex_tables_dirty = true;
+    lighting_tables_dirty = true;
+}
+
+RasterizerStatistics SWRasterizer::GetStatistics() const {
+    RasterizerStatistics statistics;
+    statistics.draws = draws;
+    return statistics;
 }
 
 } // namespace VideoCore
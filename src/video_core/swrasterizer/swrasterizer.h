@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include "common/common_types.h"
 #include "video_core/rasterizer_interface.h"
 
@@ -11,18 +12,38 @@ namespace Pica::Shader {
 struct OutputVertex;
 } // namespace Pica::Shader
 
+namespace Pica::Rasterizer {
+class TileRasterizer;
+} // namespace Pica::Rasterizer
+
 namespace VideoCore {
 
 class SWRasterizer : public RasterizerInterface {
+public:
+    SWRasterizer();
+    ~SWRasterizer() override;
+
+private:
     void AddTriangle(const Pica::Shader::OutputVertex& v0, const Pica::Shader::OutputVertex& v1,
                      const Pica::Shader::OutputVertex& v2) override;
-    void DrawTriangles() override {}
-    void NotifyPicaRegisterChanged(u32 id) override {}
+    void DrawTriangles() override;
+    void NotifyPicaRegisterChanged(u32 id) override;
     void FlushAll() override {}
     void FlushRegion(PAddr addr, u32 size) override {}
     void InvalidateRegion(PAddr addr, u32 size) override {}
     void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
     void ClearAll(bool flush) override {}
+    void SyncEntireState() override;
+    RasterizerStatistics GetStatistics() const override;
+
+    /// Rasterizes the triangles of each draw on multiple threads, null when single threaded
+    std::unique_ptr<Pica::Rasterizer::TileRasterizer> tile_rasterizer;
+
+    u64 draws = 0;
+
+    /// Whether the lookup tables changed since the rasterizer decoded them
+    bool proctex_tables_dirty = true;
+    bool lighting_tables_dirty = true;
 };
 
 } // namespace VideoCore
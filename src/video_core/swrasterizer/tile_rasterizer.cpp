@@ -0,0 +1,126 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "video_core/swrasterizer/tile_rasterizer.h"
+
+namespace Pica::Rasterizer {
+
+MICROPROFILE_DEFINE(GPU_TileRasterization, "GPU", "Tile Rasterization", MP_RGB(80, 80, 240));
+
+TileRasterizer::TileRasterizer(u32 num_threads) : bins(NUM_TILES) {
+    for (u32 i = 1; i < num_threads; ++i) {
+        workers.emplace_back(&TileRasterizer::WorkerLoop, this);
+    }
+}
+
+TileRasterizer::~TileRasterizer() {
+    {
+        std::scoped_lock lock{mutex};
+        stop = true;
+    }
+    start_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void TileRasterizer::AddTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2) {
+    const float min_y = std::min({v0.screenpos.y.ToFloat32(), v1.screenpos.y.ToFloat32(),
+                                  v2.screenpos.y.ToFloat32()});
+    const float max_y = std::max({v0.screenpos.y.ToFloat32(), v1.screenpos.y.ToFloat32(),
+                                  v2.screenpos.y.ToFloat32()});
+    if (!(max_y >= 0.0f) || min_y >= static_cast<float>(MAX_FRAMEBUFFER_ROWS)) {
+        return;
+    }
+
+    // Conservative row range, the rasterizer applies the exact coverage rules
+    const u32 first_row = static_cast<u32>(std::max(std::floor(min_y), 0.0f));
+    const u32 last_row = std::min(static_cast<u32>(std::ceil(max_y)), MAX_FRAMEBUFFER_ROWS - 1);
+
+    const u32 index = static_cast<u32>(triangles.size());
+    triangles.push_back({v0, v1, v2});
+    for (u32 tile = first_row / TILE_ROWS; tile <= last_row / TILE_ROWS; ++tile) {
+        if (bins[tile].empty()) {
+            active_tiles.push_back(tile);
+        }
+        bins[tile].push_back(index);
+    }
+}
+
+void TileRasterizer::Flush() {
+    if (triangles.empty()) {
+        return;
+    }
+
+    MICROPROFILE_SCOPE(GPU_TileRasterization);
+    next_tile = 0;
+    if (workers.empty() || active_tiles.size() == 1) {
+        ProcessTiles();
+    } else {
+        {
+            std::scoped_lock lock{mutex};
+            ++generation;
+            busy_workers = static_cast<u32>(workers.size());
+        }
+        start_cv.notify_all();
+
+        ProcessTiles();
+
+        std::unique_lock lock{mutex};
+        done_cv.wait(lock, [this] { return busy_workers == 0; });
+    }
+
+    for (const u32 tile : active_tiles) {
+        bins[tile].clear();
+    }
+    active_tiles.clear();
+    triangles.clear();
+}
+
+void TileRasterizer::ProcessTiles() {
+    u32 index;
+    while ((index = next_tile.fetch_add(1)) < active_tiles.size()) {
+        const u32 tile = active_tiles[index];
+        const u32 first_row = tile * TILE_ROWS;
+        for (const u32 triangle_index : bins[tile]) {
+            const Triangle& triangle = triangles[triangle_index];
+            ProcessTriangle(triangle.v0, triangle.v1, triangle.v2, first_row,
+                            first_row + TILE_ROWS);
+        }
+    }
+}
+
+void TileRasterizer::WorkerLoop() {
+    Common::SetCurrentThreadName("SWRasterizer");
+    MicroProfileOnThreadCreate("SWRasterizer");
+
+    u64 seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock{mutex};
+            start_cv.wait(lock, [&] { return stop || generation != seen_generation; });
+            if (stop) {
+                break;
+            }
+            seen_generation = generation;
+        }
+
+        ProcessTiles();
+
+        std::scoped_lock lock{mutex};
+        if (--busy_workers == 0) {
+            done_cv.notify_one();
+        }
+    }
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+} // namespace Pica::Rasterizer
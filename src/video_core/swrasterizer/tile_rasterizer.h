@@ -0,0 +1,68 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "video_core/swrasterizer/rasterizer.h"
+
+namespace Pica::Rasterizer {
+
+/**
+ * Rasterizes the triangles of a draw in parallel. Triangles are binned into horizontal tiles of
+ * the framebuffer and each tile is processed by a single thread, which rasterizes its triangles
+ * in submission order. Since no two tiles share a pixel, the depth, stencil and blending results
+ * are identical to rasterizing the triangles one after another.
+ */
+class TileRasterizer {
+public:
+    /// @param num_threads Number of threads rasterizing tiles, including the calling thread
+    explicit TileRasterizer(u32 num_threads);
+    ~TileRasterizer();
+
+    TileRasterizer(const TileRasterizer&) = delete;
+    TileRasterizer& operator=(const TileRasterizer&) = delete;
+
+    /// Bins a triangle in screen space, it is rasterized by the next Flush
+    void AddTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+
+    /// Rasterizes all the binned triangles and waits for them to complete
+    void Flush();
+
+private:
+    /// Framebuffer rows per tile, a multiple of the 8x8 blocks of tiled framebuffers
+    static constexpr u32 TILE_ROWS = 16;
+    static constexpr u32 NUM_TILES = MAX_FRAMEBUFFER_ROWS / TILE_ROWS;
+
+    struct Triangle {
+        Vertex v0;
+        Vertex v1;
+        Vertex v2;
+    };
+
+    /// Processes tiles until none are left in the current flush
+    void ProcessTiles();
+
+    void WorkerLoop();
+
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<u32>> bins; ///< Indices of the triangles covering each tile
+    std::vector<u32> active_tiles;      ///< Tiles covered by at least one triangle
+    std::atomic<u32> next_tile{};
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    u64 generation = 0;
+    u32 busy_workers = 0;
+    bool stop = false;
+};
+
+} // namespace Pica::Rasterizer
@@ -4,12 +4,19 @@
 
 #include <algorithm>
 #include <array>
+#include "common/arch.h"
 #include "common/bit_field.h"
 #include "common/color.h"
 #include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/texture/etc1.h"
 
+#if CITRA_ARCH(x86_64)
+#include <emmintrin.h>
+#elif CITRA_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
 namespace Pica::Texture {
 
 namespace {
@@ -69,6 +76,31 @@ union ETC1Tile {
         BitField<60, 4, u64> r1;
     } separate;
 
+    /// Returns the base color of one half of the subtile, of which there are two
+    const Common::Vec3<u8> GetBaseColor(bool second_half) const {
+        if (differential_mode) {
+            Common::Vec3<int> ret;
+            ret.r() = static_cast<int>(differential.r);
+            ret.g() = static_cast<int>(differential.g);
+            ret.b() = static_cast<int>(differential.b);
+            if (second_half) {
+                ret.r() += static_cast<int>(differential.dr);
+                ret.g() += static_cast<int>(differential.dg);
+                ret.b() += static_cast<int>(differential.db);
+            }
+            return {Common::Color::Convert5To8(ret.r()), Common::Color::Convert5To8(ret.g()),
+                    Common::Color::Convert5To8(ret.b())};
+        }
+        if (!second_half) {
+            return {Common::Color::Convert4To8(static_cast<u8>(separate.r1)),
+                    Common::Color::Convert4To8(static_cast<u8>(separate.g1)),
+                    Common::Color::Convert4To8(static_cast<u8>(separate.b1))};
+        }
+        return {Common::Color::Convert4To8(static_cast<u8>(separate.r2)),
+                Common::Color::Convert4To8(static_cast<u8>(separate.g2)),
+                Common::Color::Convert4To8(static_cast<u8>(separate.b2))};
+    }
+
     const Common::Vec3<u8> GetRGB(unsigned int x, unsigned int y) const {
         int texel = 4 * x + y;
 
@@ -124,4 +156,68 @@ Common::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y) {
     return tile.GetRGB(x, y);
 }
 
+void DecodeETC1Subtile(u64 value, Common::Vec4<u8>* texels, std::size_t stride) {
+    const ETC1Tile tile{value};
+    const std::array base_colors{tile.GetBaseColor(false), tile.GetBaseColor(true)};
+    const std::array table_indices{static_cast<unsigned>(tile.table_index_1.Value()),
+                                   static_cast<unsigned>(tile.table_index_2.Value())};
+
+    // Gather the operands of every texel, indexed like the flags (4 * x + y), so that the
+    // saturating additions can be done for the whole subtile at once. Since the base colors are
+    // 8-bit and the modifiers are at most 183, saturation gives the same result as clamping.
+    alignas(16) std::array<std::array<u8, 16>, 3> base;
+    alignas(16) std::array<u8, 16> modifier;
+    alignas(16) std::array<u8, 16> negate;
+    for (unsigned texel = 0; texel < 16; ++texel) {
+        const unsigned x = texel / 4;
+        const unsigned y = texel % 4;
+        const bool second_half = (tile.flip ? y : x) >= 2;
+        const auto& color = base_colors[second_half];
+        base[0][texel] = color.r();
+        base[1][texel] = color.g();
+        base[2][texel] = color.b();
+        modifier[texel] =
+            etc1_modifier_table[table_indices[second_half]][tile.GetTableSubIndex(texel)];
+        negate[texel] = tile.GetNegationFlag(texel) ? 0xFF : 0;
+    }
+
+    alignas(16) std::array<std::array<u8, 16>, 3> result;
+#if CITRA_ARCH(x86_64)
+    const __m128i modifiers = _mm_load_si128(reinterpret_cast<const __m128i*>(modifier.data()));
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(negate.data()));
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        const __m128i values =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(base[channel].data()));
+        const __m128i added = _mm_adds_epu8(values, modifiers);
+        const __m128i subtracted = _mm_subs_epu8(values, modifiers);
+        _mm_store_si128(reinterpret_cast<__m128i*>(result[channel].data()),
+                        _mm_or_si128(_mm_and_si128(mask, subtracted),
+                                     _mm_andnot_si128(mask, added)));
+    }
+#elif CITRA_ARCH(arm64)
+    const uint8x16_t modifiers = vld1q_u8(modifier.data());
+    const uint8x16_t mask = vld1q_u8(negate.data());
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        const uint8x16_t values = vld1q_u8(base[channel].data());
+        vst1q_u8(result[channel].data(), vbslq_u8(mask, vqsubq_u8(values, modifiers),
+                                                  vqaddq_u8(values, modifiers)));
+    }
+#else
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        for (std::size_t texel = 0; texel < 16; ++texel) {
+            const int value = base[channel][texel];
+            const int delta = negate[texel] ? -modifier[texel] : modifier[texel];
+            result[channel][texel] = static_cast<u8>(std::clamp(value + delta, 0, 255));
+        }
+    }
+#endif
+
+    for (unsigned texel = 0; texel < 16; ++texel) {
+        Common::Vec4<u8>& out = texels[(texel % 4) * stride + texel / 4];
+        out.r() = result[0][texel];
+        out.g() = result[1][texel];
+        out.b() = result[2][texel];
+    }
+}
+
 } // namespace Pica::Texture
@@ -11,4 +11,13 @@ namespace Pica::Texture {
 
 Common::Vec3<u8> SampleETC1Subtile(u64 value, unsigned int x, unsigned int y);
 
+/**
+ * Decodes the color of all the texels of a 4x4 ETC1 subtile at once.
+ * @param value The packed subtile
+ * @param texels Receives the colors, texels[y * stride + x] for the texel at (x, y).
+ *               The alpha component is left untouched.
+ * @param stride Distance between two rows of texels in the output
+ */
+void DecodeETC1Subtile(u64 value, Common::Vec4<u8>* texels, std::size_t stride);
+
 } // namespace Pica::Texture
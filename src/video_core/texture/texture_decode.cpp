@@ -212,6 +212,76 @@ Common::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned in
     }
 }
 
+void DecodeTile(const u8* source, const TextureInfo& info, Common::Vec4<u8>* texels,
+                bool disable_alpha) {
+    switch (info.format) {
+    case TextureFormat::ETC1:
+    case TextureFormat::ETC1A4: {
+        const bool has_alpha = (info.format == TextureFormat::ETC1A4);
+        const std::size_t subtile_size = has_alpha ? 16 : 8;
+
+        for (unsigned int subtile_index = 0; subtile_index < ETC1_SUBTILES; ++subtile_index) {
+            const u8* subtile_ptr = source + subtile_index * subtile_size;
+            Common::Vec4<u8>* subtile_texels =
+                texels + (subtile_index / 2) * 4 * 8 + (subtile_index % 2) * 4;
+
+            u64_le packed_alpha = ~u64{0};
+            if (has_alpha) {
+                if (!disable_alpha) {
+                    memcpy(&packed_alpha, subtile_ptr, sizeof(u64));
+                }
+                subtile_ptr += sizeof(u64);
+            }
+
+            u64_le subtile_data;
+            memcpy(&subtile_data, subtile_ptr, sizeof(u64));
+            DecodeETC1Subtile(subtile_data, subtile_texels, 8);
+
+            for (unsigned int y = 0; y < 4; ++y) {
+                for (unsigned int x = 0; x < 4; ++x) {
+                    subtile_texels[y * 8 + x].a() =
+                        Common::Color::Convert4To8((packed_alpha >> (4 * (x * 4 + y))) & 0xF);
+                }
+            }
+        }
+        break;
+    }
+
+    case TextureFormat::I4:
+    case TextureFormat::A4: {
+        // Two texels per byte, consecutive in Morton order
+        const bool is_alpha = (info.format == TextureFormat::A4);
+        for (unsigned int y = 0; y < 8; ++y) {
+            for (unsigned int x = 0; x < 8; x += 2) {
+                const u32 morton_offset = VideoCore::MortonInterleave(x, y);
+                const u8 packed = source[morton_offset / 2];
+                const u8 first = Common::Color::Convert4To8(packed & 0xF);
+                const u8 second = Common::Color::Convert4To8((packed & 0xF0) >> 4);
+                if (is_alpha && disable_alpha) {
+                    texels[y * 8 + x] = {first, first, first, 255};
+                    texels[y * 8 + x + 1] = {second, second, second, 255};
+                } else if (is_alpha) {
+                    texels[y * 8 + x] = {0, 0, 0, first};
+                    texels[y * 8 + x + 1] = {0, 0, 0, second};
+                } else {
+                    texels[y * 8 + x] = {first, first, first, 255};
+                    texels[y * 8 + x + 1] = {second, second, second, 255};
+                }
+            }
+        }
+        break;
+    }
+
+    default:
+        for (unsigned int y = 0; y < 8; ++y) {
+            for (unsigned int x = 0; x < 8; ++x) {
+                texels[y * 8 + x] = LookupTexelInTile(source, x, y, info, disable_alpha);
+            }
+        }
+        break;
+    }
+}
+
 TextureInfo TextureInfo::FromPicaRegister(const TexturingRegs::TextureConfig& config,
                                           const TexturingRegs::TextureFormat& format) {
     TextureInfo info;
@@ -55,4 +55,16 @@ Common::Vec4<u8> LookupTexture(const u8* source, unsigned int x, unsigned int y,
 Common::Vec4<u8> LookupTexelInTile(const u8* source, unsigned int x, unsigned int y,
                                    const TextureInfo& info, bool disable_alpha);
 
+/**
+ * Decodes all the texels of a single 8x8 texture tile. This is considerably faster than looking
+ * up each texel for the compressed formats, which share per-block state between texels.
+ *
+ * @param source Pointer to the beginning of the tile.
+ * @param info TextureInfo describing the texture format.
+ * @param texels Receives the 64 texels, texels[8 * y + x] being the texel at (x, y).
+ * @param disable_alpha Used for debugging, see LookupTexture.
+ */
+void DecodeTile(const u8* source, const TextureInfo& info, Common::Vec4<u8>* texels,
+                bool disable_alpha = false);
+
 } // namespace Pica::Texture
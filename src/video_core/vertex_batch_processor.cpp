@@ -0,0 +1,153 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include "common/microprofile.h"
+#include "common/thread.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/vertex_batch_processor.h"
+#include "video_core/vertex_loader.h"
+
+namespace Pica {
+
+MICROPROFILE_DEFINE(GPU_VertexBatch, "GPU", "Vertex Batch", MP_RGB(50, 150, 240));
+
+VertexBatchProcessor::VertexBatchProcessor(u32 num_threads) {
+    for (u32 i = 1; i < num_threads; ++i) {
+        workers.emplace_back(&VertexBatchProcessor::WorkerLoop, this);
+    }
+}
+
+VertexBatchProcessor::~VertexBatchProcessor() {
+    {
+        std::scoped_lock lock{mutex};
+        stop = true;
+    }
+    start_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+const std::vector<Shader::AttributeBuffer>& VertexBatchProcessor::Process(
+    const ShaderRegs& config_, const Shader::ShaderSetup& setup_, const VertexLoader& loader_,
+    Shader::ShaderEngine* engine_, const VertexBatch& batch_) {
+    MICROPROFILE_SCOPE(GPU_VertexBatch);
+
+    config = &config_;
+    setup = &setup_;
+    loader = &loader_;
+    engine = engine_;
+    batch = batch_;
+    outputs.resize(batch.num_vertices);
+    next_chunk = 0;
+
+    const u32 num_chunks = (batch.num_vertices + CHUNK_VERTICES - 1) / CHUNK_VERTICES;
+    if (workers.empty() || num_chunks == 1) {
+        ProcessChunks();
+        return outputs;
+    }
+
+    {
+        std::scoped_lock lock{mutex};
+        ++generation;
+        busy_workers = static_cast<u32>(workers.size());
+    }
+    start_cv.notify_all();
+
+    ProcessChunks();
+
+    std::unique_lock lock{mutex};
+    done_cv.wait(lock, [this] { return busy_workers == 0; });
+    return outputs;
+}
+
+void VertexBatchProcessor::ProcessChunks() {
+    // Same circular-replacement vertex cache as the serial path, local to each chunk
+    constexpr std::size_t VERTEX_CACHE_SIZE = 32;
+    std::array<bool, VERTEX_CACHE_SIZE> vertex_cache_valid;
+    std::array<u32, VERTEX_CACHE_SIZE> vertex_cache_ids;
+    std::array<u32, VERTEX_CACHE_SIZE> vertex_cache_slots;
+
+    // Only used by the debugger, which disables batching
+    DebugUtils::MemoryAccessTracker memory_accesses;
+    Shader::UnitState shader_unit;
+    Shader::AttributeBuffer input;
+
+    const u8* index_data_8 = batch.index_data;
+    const u16* index_data_16 = reinterpret_cast<const u16*>(batch.index_data);
+
+    u32 chunk;
+    while ((chunk = next_chunk.fetch_add(1)) * CHUNK_VERTICES < batch.num_vertices) {
+        const u32 first = chunk * CHUNK_VERTICES;
+        const u32 last = std::min(first + CHUNK_VERTICES, batch.num_vertices);
+
+        vertex_cache_valid.fill(false);
+        std::size_t vertex_cache_pos = 0;
+
+        for (u32 index = first; index < last; ++index) {
+            // Indexed rendering doesn't use the start offset
+            const u32 vertex =
+                batch.is_indexed ? (batch.index_u16 ? index_data_16[index] : index_data_8[index])
+                                 : (index + batch.vertex_offset);
+
+            bool vertex_cache_hit = false;
+            if (batch.is_indexed) {
+                for (std::size_t i = 0; i < VERTEX_CACHE_SIZE; ++i) {
+                    if (vertex_cache_valid[i] && vertex == vertex_cache_ids[i]) {
+                        outputs[index] = outputs[vertex_cache_slots[i]];
+                        vertex_cache_hit = true;
+                        break;
+                    }
+                }
+            }
+            if (vertex_cache_hit) {
+                continue;
+            }
+
+            loader->LoadVertex(batch.base_address, index, vertex, input, memory_accesses);
+            shader_unit.LoadInput(*config, input);
+            engine->Run(*setup, shader_unit);
+            shader_unit.WriteOutput(*config, outputs[index]);
+
+            if (batch.is_indexed) {
+                vertex_cache_valid[vertex_cache_pos] = true;
+                vertex_cache_ids[vertex_cache_pos] = vertex;
+                vertex_cache_slots[vertex_cache_pos] = index;
+                vertex_cache_pos = (vertex_cache_pos + 1) % VERTEX_CACHE_SIZE;
+            }
+        }
+    }
+}
+
+void VertexBatchProcessor::WorkerLoop() {
+    Common::SetCurrentThreadName("VertexShader");
+    MicroProfileOnThreadCreate("VertexShader");
+
+    u64 seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock{mutex};
+            start_cv.wait(lock, [&] { return stop || generation != seen_generation; });
+            if (stop) {
+                break;
+            }
+            seen_generation = generation;
+        }
+
+        ProcessChunks();
+
+        std::scoped_lock lock{mutex};
+        if (--busy_workers == 0) {
+            done_cv.notify_one();
+        }
+    }
+
+#if MICROPROFILE_ENABLED
+    MicroProfileOnThreadExit();
+#endif
+}
+
+} // namespace Pica
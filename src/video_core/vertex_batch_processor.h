@@ -0,0 +1,88 @@
+// Copyright 2023 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "video_core/shader/shader.h"
+
+namespace Pica {
+
+class VertexLoader;
+
+/// Describes the vertices fetched by a draw call
+struct VertexBatch {
+    u32 base_address;
+    u32 num_vertices;
+    u32 vertex_offset; ///< Offset added to the index of non-indexed draws
+    bool is_indexed;
+    bool index_u16;
+    const u8* index_data;
+};
+
+/**
+ * Runs the vertex shader over the vertices of a draw call on multiple threads. The index range
+ * is split in fixed-size chunks which are claimed by the workers and the calling thread, each
+ * with its own shader unit and vertex cache. Outputs are stored by index, so the caller can
+ * submit them to the geometry pipeline in the original order.
+ */
+class VertexBatchProcessor {
+public:
+    /// Minimum number of vertices for which distributing the work is worthwhile
+    static constexpr u32 MIN_BATCH_VERTICES = 512;
+
+    /// @param num_threads Number of threads shading vertices, including the calling thread
+    explicit VertexBatchProcessor(u32 num_threads);
+    ~VertexBatchProcessor();
+
+    VertexBatchProcessor(const VertexBatchProcessor&) = delete;
+    VertexBatchProcessor& operator=(const VertexBatchProcessor&) = delete;
+
+    [[nodiscard]] u32 GetNumThreads() const {
+        return static_cast<u32>(workers.size()) + 1;
+    }
+
+    /**
+     * Loads and shades all the vertices of a batch and waits for them to complete.
+     * The shader engine must have been setup for the current vertex shader.
+     * @returns The vertex shader output of each index of the batch
+     */
+    const std::vector<Shader::AttributeBuffer>& Process(const ShaderRegs& config,
+                                                       const Shader::ShaderSetup& setup,
+                                                       const VertexLoader& loader,
+                                                       Shader::ShaderEngine* engine,
+                                                       const VertexBatch& batch);
+
+private:
+    /// Vertices processed by a thread at a time, small enough to balance the load
+    static constexpr u32 CHUNK_VERTICES = 128;
+
+    /// Processes chunks until none are left in the current batch
+    void ProcessChunks();
+
+    void WorkerLoop();
+
+    const ShaderRegs* config = nullptr;
+    const Shader::ShaderSetup* setup = nullptr;
+    const VertexLoader* loader = nullptr;
+    Shader::ShaderEngine* engine = nullptr;
+    VertexBatch batch{};
+    std::vector<Shader::AttributeBuffer> outputs;
+    std::atomic<u32> next_chunk{};
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    u64 generation = 0;
+    u32 busy_workers = 0;
+    bool stop = false;
+};
+
+} // namespace Pica
@@ -17,6 +17,41 @@
 
 namespace Pica {
 
+namespace {
+
+using AttributeLoader = void (*)(const u8* source, Common::Vec4<float24>& attribute);
+
+template <typename T, u32 NumElements>
+void LoadAttribute(const u8* source, Common::Vec4<float24>& attribute) {
+    const T* srcdata = reinterpret_cast<const T*>(source);
+    for (u32 comp = 0; comp < NumElements; ++comp) {
+        attribute[comp] = float24::FromFloat32(srcdata[comp]);
+    }
+
+    // Default attribute values set if array elements have < 4 components. This
+    // is *not* carried over from the default attribute settings even if they're
+    // enabled for this attribute.
+    for (u32 comp = NumElements; comp < 4; ++comp) {
+        attribute[comp] = comp == 3 ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
+    }
+}
+
+template <typename T>
+constexpr std::array<AttributeLoader, 4> MakeAttributeLoaders() {
+    return {&LoadAttribute<T, 1>, &LoadAttribute<T, 2>, &LoadAttribute<T, 3>,
+            &LoadAttribute<T, 4>};
+}
+
+/// The attribute loaders, indexed by the format and the number of elements minus one
+constexpr std::array<std::array<AttributeLoader, 4>, 4> attribute_loaders{{
+    MakeAttributeLoaders<s8>(),
+    MakeAttributeLoaders<u8>(),
+    MakeAttributeLoaders<s16>(),
+    MakeAttributeLoaders<float>(),
+}};
+
+} // Anonymous namespace
+
 void VertexLoader::Setup(const PipelineRegs& regs) {
     ASSERT_MSG(!is_setup, "VertexLoader is not intended to be setup more than once.");
 
@@ -55,6 +90,15 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
                     attribute_config.GetFormat(attribute_index);
                 vertex_attribute_elements[attribute_index] =
                     attribute_config.GetNumElements(attribute_index);
+                vertex_attribute_sizes[attribute_index] =
+                    attribute_config.GetStride(attribute_index);
+                // The decoding of the attribute is chosen once per draw rather than per vertex
+                const u32 elements = vertex_attribute_elements[attribute_index];
+                vertex_attribute_loaders[attribute_index] =
+                    elements == 0
+                        ? nullptr
+                        : attribute_loaders[static_cast<u32>(
+                              vertex_attribute_formats[attribute_index])][elements - 1];
                 offset += attribute_config.GetStride(attribute_index);
             } else if (attribute_index < 16) {
                 // Attribute ids 12, 13, 14 and 15 signify 4, 8, 12 and 16-byte paddings,
@@ -73,69 +117,22 @@ void VertexLoader::Setup(const PipelineRegs& regs) {
 
 void VertexLoader::LoadVertex(u32 base_address, int index, int vertex,
                               Shader::AttributeBuffer& input,
-                              DebugUtils::MemoryAccessTracker& memory_accesses) {
+                              DebugUtils::MemoryAccessTracker& memory_accesses) const {
     ASSERT_MSG(is_setup, "A VertexLoader needs to be setup before loading vertices.");
 
+    const bool track_accesses = g_debug_context && g_debug_context->recorder;
     for (int i = 0; i < num_total_attributes; ++i) {
         if (vertex_attribute_elements[i] != 0) {
             // Load per-vertex data from the loader arrays
             u32 source_addr =
                 base_address + vertex_attribute_sources[i] + vertex_attribute_strides[i] * vertex;
 
-            if (g_debug_context && Pica::g_debug_context->recorder) {
-                memory_accesses.AddAccess(
-                    source_addr,
-                    vertex_attribute_elements[i] *
-                        ((vertex_attribute_formats[i] == PipelineRegs::VertexAttributeFormat::FLOAT)
-                             ? 4
-                         : (vertex_attribute_formats[i] ==
-                            PipelineRegs::VertexAttributeFormat::SHORT)
-                             ? 2
-                             : 1));
+            if (track_accesses) {
+                memory_accesses.AddAccess(source_addr, vertex_attribute_sizes[i]);
             }
 
-            switch (vertex_attribute_formats[i]) {
-            case PipelineRegs::VertexAttributeFormat::BYTE: {
-                const s8* srcdata = reinterpret_cast<const s8*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::UBYTE: {
-                const u8* srcdata = reinterpret_cast<const u8*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::SHORT: {
-                const s16* srcdata = reinterpret_cast<const s16*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            case PipelineRegs::VertexAttributeFormat::FLOAT: {
-                const float* srcdata = reinterpret_cast<const float*>(
-                    VideoCore::g_memory->GetPhysicalPointer(source_addr));
-                for (unsigned int comp = 0; comp < vertex_attribute_elements[i]; ++comp) {
-                    input.attr[i][comp] = float24::FromFloat32(srcdata[comp]);
-                }
-                break;
-            }
-            }
-
-            // Default attribute values set if array elements have < 4 components. This
-            // is *not* carried over from the default attribute settings even if they're
-            // enabled for this attribute.
-            for (unsigned int comp = vertex_attribute_elements[i]; comp < 4; ++comp) {
-                input.attr[i][comp] =
-                    comp == 3 ? float24::FromFloat32(1.0f) : float24::FromFloat32(0.0f);
-            }
+            vertex_attribute_loaders[i](VideoCore::g_memory->GetPhysicalPointer(source_addr),
+                                        input.attr[i]);
 
             LOG_TRACE(HW_GPU,
                       "Loaded {} components of attribute {:x} for vertex {:x} (index {:x}) from "
@@ -2,6 +2,8 @@
 
 #include <array>
 #include "common/common_types.h"
+#include "common/vector_math.h"
+#include "video_core/pica_types.h"
 #include "video_core/regs_pipeline.h"
 
 namespace Pica {
@@ -23,17 +25,24 @@ public:
 
     void Setup(const PipelineRegs& regs);
     void LoadVertex(u32 base_address, int index, int vertex, Shader::AttributeBuffer& input,
-                    DebugUtils::MemoryAccessTracker& memory_accesses);
+                    DebugUtils::MemoryAccessTracker& memory_accesses) const;
 
     int GetNumTotalAttributes() const {
         return num_total_attributes;
     }
 
 private:
+    /// Converts the elements of an attribute and fills in the missing ones
+    using AttributeLoader = void (*)(const u8* source, Common::Vec4<float24>& attribute);
+
     std::array<u32, 16> vertex_attribute_sources;
     std::array<u32, 16> vertex_attribute_strides{};
     std::array<PipelineRegs::VertexAttributeFormat, 16> vertex_attribute_formats;
     std::array<u32, 16> vertex_attribute_elements{};
+    /// The size of the loaded data in bytes, for the memory access tracker
+    std::array<u32, 16> vertex_attribute_sizes{};
+    /// The loader specialized for the format and the number of elements of each attribute
+    std::array<AttributeLoader, 16> vertex_attribute_loaders{};
     std::array<bool, 16> vertex_attribute_is_default;
     int num_total_attributes = 0;
     bool is_setup = false;
@@ -6,6 +6,7 @@
 #include "common/archives.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/pica.h"
 #include "video_core/pica_state.h"
 #include "video_core/renderer_base.h"
@@ -19,6 +20,7 @@
 namespace VideoCore {
 
 std::unique_ptr<RendererBase> g_renderer; ///< Renderer plugin
+std::unique_ptr<GPUThread> g_gpu_thread;
 
 std::atomic<bool> g_hw_renderer_enabled;
 std::atomic<bool> g_shader_jit_enabled;
@@ -29,7 +31,6 @@ std::atomic<bool> g_use_disk_shader_cache;
 std::atomic<bool> g_renderer_bg_color_update_requested;
 std::atomic<bool> g_renderer_sampler_update_requested;
 std::atomic<bool> g_renderer_shader_update_requested;
-std::atomic<bool> g_texture_filter_update_requested;
 // Screenshot
 std::atomic<bool> g_renderer_screenshot_requested;
 void* g_screenshot_bits;
@@ -43,6 +44,9 @@ char *g_ctroll3d_addr;
 
 Memory::MemorySystem* g_memory;
 
+/// Keeps the framebuffer layout up to date with the settings
+static std::size_t apply_callback_id;
+
 /// Initialize the video core
 ResultStatus Init(Frontend::EmuWindow& emu_window, Frontend::EmuWindow* secondary_window,
                   Memory::MemorySystem& memory) {
@@ -56,15 +60,32 @@ ResultStatus Init(Frontend::EmuWindow& emu_window, Frontend::EmuWindow* secondar
 
     if (result != ResultStatus::Success) {
         LOG_ERROR(Render, "initialization failed !");
-    } else {
-        LOG_DEBUG(Render, "initialized OK");
+        return result;
     }
 
+    if (Settings::values.use_async_gpu_emulation) {
+        g_gpu_thread = std::make_unique<GPUThread>(emu_window);
+    }
+
+    apply_callback_id = Settings::AddApplyCallback([](const Settings::Snapshot&) {
+#ifndef ANDROID
+        g_renderer->UpdateCurrentFramebufferLayout();
+#endif
+    });
+
+    LOG_DEBUG(Render, "initialized OK");
     return result;
 }
 
 /// Shutdown the video core
 void Shutdown() {
+    Settings::RemoveApplyCallback(apply_callback_id);
+
+    if (g_gpu_thread) {
+        g_gpu_thread.reset();
+        g_renderer->GetRenderWindow().MakeCurrent();
+    }
+
     Pica::Shutdown();
 
     g_renderer->ShutDown();
@@ -99,8 +120,9 @@ void RequestCTroll3D(void* data, std::function<uint8_t(char *)> callback,  const
 
 u16 GetResolutionScaleFactor() {
     if (g_hw_renderer_enabled) {
-        return Settings::values.resolution_factor.GetValue()
-                   ? Settings::values.resolution_factor.GetValue()
+        const u16 resolution_factor = Settings::GetSnapshot().resolution_factor;
+        return resolution_factor
+                   ? resolution_factor
                    : g_renderer->GetRenderWindow().GetFramebufferLayout().GetScalingRatio();
     } else {
         // Software renderer always render at native resolution
@@ -110,6 +132,9 @@ u16 GetResolutionScaleFactor() {
 
 template <class Archive>
 void serialize(Archive& ar, const unsigned int) {
+    if (g_gpu_thread) {
+        g_gpu_thread->WaitIdle();
+    }
     ar& Pica::g_state;
 }
 
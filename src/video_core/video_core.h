@@ -16,6 +16,10 @@ class EmuWindow;
 
 class RendererBase;
 
+namespace VideoCore {
+class GPUThread;
+}
+
 namespace Memory {
 class MemorySystem;
 }
@@ -26,6 +30,7 @@ class MemorySystem;
 namespace VideoCore {
 
 extern std::unique_ptr<RendererBase> g_renderer; ///< Renderer plugin
+extern std::unique_ptr<GPUThread> g_gpu_thread;  ///< GPU thread, null when running synchronously
 
 // TODO: Wrap these in a user settings struct along with any other graphics settings (often set from
 // qt ui)
@@ -38,7 +43,6 @@ extern std::atomic<bool> g_use_disk_shader_cache;
 extern std::atomic<bool> g_renderer_bg_color_update_requested;
 extern std::atomic<bool> g_renderer_sampler_update_requested;
 extern std::atomic<bool> g_renderer_shader_update_requested;
-extern std::atomic<bool> g_texture_filter_update_requested;
 // Screenshot
 extern std::atomic<bool> g_renderer_screenshot_requested;
 extern void* g_screenshot_bits;
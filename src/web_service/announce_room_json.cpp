@@ -4,7 +4,6 @@
 
 #include <future>
 #include <json.hpp>
-#include "common/detached_tasks.h"
 #include "common/logging/log.h"
 #include "web_service/announce_room_json.h"
 #include "web_service/web_backend.h"
@@ -134,11 +133,19 @@ void RoomJson::ClearPlayers() {
 }
 
 AnnounceMultiplayerRoom::RoomList RoomJson::GetRoomList() {
-    auto reply = client.GetJson("/lobby", true).returned_data;
-    if (reply.empty()) {
+    auto result = client.GetJson("/lobby", true, room_list_etag);
+    if (result.result_code == Common::WebResult::Code::NotModified) {
+        return room_list;
+    }
+    if (result.returned_data.empty()) {
+        room_list_etag.clear();
+        room_list.clear();
         return {};
     }
-    return nlohmann::json::parse(reply).at("rooms").get<AnnounceMultiplayerRoom::RoomList>();
+    room_list = nlohmann::json::parse(result.returned_data)
+                    .at("rooms")
+                    .get<AnnounceMultiplayerRoom::RoomList>();
+    return room_list;
 }
 
 void RoomJson::Delete() {
@@ -146,10 +153,11 @@ void RoomJson::Delete() {
         LOG_ERROR(WebService, "Room must be registered to be deleted");
         return;
     }
-    Common::DetachedTasks::AddTask(
+    QueueRequest(
         [host{this->host}, username{this->username}, token{this->token}, room_id{this->room_id}]() {
             // create a new client here because the this->client might be destroyed.
-            Client{host, username, token}.DeleteJson(fmt::format("/lobby/{}", room_id), "", false);
+            return Client{host, username, token}.DeleteJson(fmt::format("/lobby/{}", room_id), "",
+                                                            false);
         });
 }
 
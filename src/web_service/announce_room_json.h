@@ -41,6 +41,10 @@ private:
     std::string username;
     std::string token;
     std::string room_id;
+
+    /// Last room list received, returned again while the web service reports it as unchanged
+    AnnounceMultiplayerRoom::RoomList room_list;
+    std::string room_list_etag;
 };
 
 } // namespace WebService
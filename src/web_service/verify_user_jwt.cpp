@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <system_error>
 #include <jwt/jwt.hpp>
 #include "common/logging/log.h"
@@ -11,30 +14,55 @@
 
 namespace WebService {
 
+/// The longest a verification waits for the public key that is still being fetched
+constexpr std::chrono::seconds PUBLIC_KEY_TIMEOUT{5};
+
+static std::mutex public_key_mutex;
 static std::string public_key;
-std::string GetPublicKey(const std::string& host) {
-    if (public_key.empty()) {
-        Client client(host, "", ""); // no need for credentials here
-        public_key = client.GetPlain("/jwt/external/key.pem", true).returned_data;
-        if (public_key.empty()) {
-            LOG_ERROR(WebService, "Could not fetch external JWT public key, verification may fail");
-        } else {
-            LOG_INFO(WebService, "Fetched external JWT public key (size={})", public_key.size());
+std::shared_future<std::string> GetPublicKey(const std::string& host) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::shared_future<std::string> future = promise->get_future().share();
+    {
+        std::lock_guard lock{public_key_mutex};
+        if (!public_key.empty()) {
+            promise->set_value(public_key);
+            return future;
         }
     }
-    return public_key;
+    QueueRequest(
+        [host] {
+            Client client(host, "", ""); // no need for credentials here
+            return client.GetPlain("/jwt/external/key.pem", true);
+        },
+        [promise](const Common::WebResult& result) {
+            if (result.returned_data.empty()) {
+                LOG_ERROR(WebService,
+                          "Could not fetch external JWT public key, verification may fail");
+            } else {
+                LOG_INFO(WebService, "Fetched external JWT public key (size={})",
+                         result.returned_data.size());
+                std::lock_guard lock{public_key_mutex};
+                public_key = result.returned_data;
+            }
+            promise->set_value(result.returned_data);
+        });
+    return future;
 }
 
 VerifyUserJWT::VerifyUserJWT(const std::string& host) : pub_key(GetPublicKey(host)) {}
 
 Network::VerifyUser::UserData VerifyUserJWT::LoadUserData(const std::string& verify_UID,
                                                           const std::string& token) {
+    if (pub_key.wait_for(PUBLIC_KEY_TIMEOUT) != std::future_status::ready) {
+        LOG_ERROR(WebService, "The external JWT public key wasn't fetched in time");
+        return {};
+    }
     const std::string audience = fmt::format("external-{}", verify_UID);
     using namespace jwt::params;
     std::error_code error;
     auto decoded =
-        jwt::decode(token, algorithms({"rs256"}), error, secret(pub_key), issuer("citra-core"),
-                    aud(audience), validate_iat(true), validate_jti(true));
+        jwt::decode(token, algorithms({"rs256"}), error, secret(pub_key.get()),
+                    issuer("citra-core"), aud(audience), validate_iat(true), validate_jti(true));
     if (error) {
         LOG_INFO(WebService, "Verification failed: category={}, code={}, message={}",
                  error.category().name(), error.value(), error.message());
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <future>
+#include <string>
 #include <fmt/format.h>
 #include "network/verify_user.h"
 #include "web_service/web_backend.h"
@@ -19,7 +21,8 @@ public:
                                                const std::string& token) override;
 
 private:
-    std::string pub_key;
+    /// Fetched in the background, so that creating a room doesn't wait for the network
+    std::shared_future<std::string> pub_key;
 };
 
 } // namespace WebService
@@ -3,9 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <fmt/format.h>
 #if defined(__ANDROID__)
 #include <ifaddrs.h>
@@ -13,6 +16,7 @@
 #include <httplib.h>
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "common/web_result.h"
 #include "web_service/web_backend.h"
 
@@ -22,6 +26,161 @@ constexpr std::array<const char, 1> API_VERSION{'1'};
 
 constexpr std::size_t TIMEOUT_SECONDS = 30;
 
+/// How often a queued request that couldn't reach the server is tried
+constexpr u32 MAX_ATTEMPTS = 3;
+
+/// The wait before trying a request again, doubled after each attempt
+constexpr std::chrono::seconds RETRY_DELAY{2};
+
+namespace {
+
+/// Whether the request failed in a way that trying again later could fix
+bool IsTransientError(const Common::WebResult& result) {
+    return result.result_code == Common::WebResult::Code::LibError ||
+           (result.result_code == Common::WebResult::Code::HttpError &&
+            result.result_string.starts_with('5'));
+}
+
+/// The thread running the queued requests
+class RequestWorker {
+public:
+    static RequestWorker& Instance() {
+        static RequestWorker worker;
+        return worker;
+    }
+
+    ~RequestWorker() {
+        Stop();
+    }
+
+    void Queue(std::function<Common::WebResult()> request,
+               std::function<void(const Common::WebResult&)> on_done) {
+        {
+            std::lock_guard lock{mutex};
+            if (!stopping) {
+                requests.push_back({std::move(request), std::move(on_done)});
+                if (!thread.joinable()) {
+                    thread = std::thread{[this] { Run(); }};
+                }
+                cv.notify_all();
+                return;
+            }
+        }
+        LOG_WARNING(WebService, "Dropping a web service request made after shutting down");
+        if (on_done) {
+            on_done(Cancelled());
+        }
+    }
+
+    void Shutdown(std::chrono::milliseconds timeout) {
+        {
+            std::unique_lock lock{mutex};
+            if (!cv.wait_for(lock, timeout, [this] { return requests.empty() && !busy; })) {
+                LOG_WARNING(WebService,
+                            "Dropping {} web service requests that didn't finish in time",
+                            requests.size() + (busy ? 1 : 0));
+            }
+        }
+        Stop();
+    }
+
+    /**
+     * Registers the client that sends a request on the worker thread, so that shutting down can
+     * abort the request. Clients on other threads are ignored.
+     * @return false if the request shouldn't be sent as the worker is shutting down
+     */
+    bool SetActiveClient(httplib::Client* client) {
+        if (!is_worker_thread) {
+            return true;
+        }
+        std::lock_guard lock{mutex};
+        active_client = client;
+        return !stopping;
+    }
+
+private:
+    struct Request {
+        std::function<Common::WebResult()> request;
+        std::function<void(const Common::WebResult&)> on_done;
+    };
+
+    static Common::WebResult Cancelled() {
+        return Common::WebResult{Common::WebResult::Code::LibError, "Cancelled"};
+    }
+
+    void Run() {
+        Common::SetCurrentThreadName("WebService");
+        is_worker_thread = true;
+
+        std::unique_lock lock{mutex};
+        while (true) {
+            cv.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) {
+                return;
+            }
+            Request request = std::move(requests.front());
+            requests.pop_front();
+            busy = true;
+
+            Common::WebResult result;
+            for (u32 attempt = 1;; ++attempt) {
+                lock.unlock();
+                result = request.request();
+                lock.lock();
+                if (stopping || attempt == MAX_ATTEMPTS || !IsTransientError(result)) {
+                    break;
+                }
+                if (cv.wait_for(lock, RETRY_DELAY * (1 << (attempt - 1)),
+                                [this] { return stopping; })) {
+                    break;
+                }
+            }
+
+            lock.unlock();
+            if (request.on_done) {
+                request.on_done(result);
+            }
+            lock.lock();
+            busy = false;
+            cv.notify_all();
+        }
+    }
+
+    void Stop() {
+        std::deque<Request> dropped;
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+            if (active_client) {
+                active_client->stop();
+            }
+            dropped = std::move(requests);
+            cv.notify_all();
+        }
+        if (thread.joinable()) {
+            thread.join();
+        }
+        for (const Request& request : dropped) {
+            if (request.on_done) {
+                request.on_done(Cancelled());
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> requests;
+    bool busy = false;
+    bool stopping = false;
+    /// The client sending the request of the worker thread, if any
+    httplib::Client* active_client = nullptr;
+    std::thread thread;
+
+    static inline thread_local bool is_worker_thread = false;
+};
+
+} // Anonymous namespace
+
 struct Client::Impl {
     Impl(std::string host, std::string username, std::string token)
         : host{std::move(host)}, username{std::move(username)}, token{std::move(token)} {
@@ -38,7 +197,7 @@ struct Client::Impl {
     /// A generic function handles POST, GET and DELETE request together
     Common::WebResult GenericRequest(const std::string& method, const std::string& path,
                                      const std::string& data, bool allow_anonymous,
-                                     const std::string& accept) {
+                                     const std::string& accept, std::string* etag = nullptr) {
         if (jwt.empty()) {
             UpdateJWT();
         }
@@ -49,11 +208,11 @@ struct Client::Impl {
                                      "Credentials needed"};
         }
 
-        auto result = GenericRequest(method, path, data, accept, jwt);
+        auto result = GenericRequest(method, path, data, accept, jwt, "", "", etag);
         if (result.result_string == "401") {
             // Try again with new JWT
             UpdateJWT();
-            result = GenericRequest(method, path, data, accept, jwt);
+            result = GenericRequest(method, path, data, accept, jwt, "", "", etag);
         }
 
         return result;
@@ -64,11 +223,12 @@ struct Client::Impl {
      * JWT is used if the jwt parameter is not empty
      * username + token is used if jwt is empty but username and token are
      * not empty anonymous if all of jwt, username and token are empty
+     * If etag is given, the data is only returned when its ETag is different
      */
     Common::WebResult GenericRequest(const std::string& method, const std::string& path,
                                      const std::string& data, const std::string& accept,
                                      const std::string& jwt = "", const std::string& username = "",
-                                     const std::string& token = "") {
+                                     const std::string& token = "", std::string* etag = nullptr) {
         if (cli == nullptr) {
             cli = std::make_unique<httplib::Client>(host.c_str());
             cli->set_connection_timeout(TIMEOUT_SECONDS);
@@ -97,6 +257,9 @@ struct Client::Impl {
         if (method != "GET") {
             params.emplace(std::string("Content-Type"), std::string("application/json"));
         };
+        if (etag && !etag->empty()) {
+            params.emplace(std::string("If-None-Match"), *etag);
+        }
 
         httplib::Request request;
         request.method = method;
@@ -104,7 +267,11 @@ struct Client::Impl {
         request.headers = params;
         request.body = data;
 
+        if (!RequestWorker::Instance().SetActiveClient(cli.get())) {
+            return Common::WebResult{Common::WebResult::Code::LibError, "Cancelled"};
+        }
         httplib::Result result = cli->send(request);
+        RequestWorker::Instance().SetActiveClient(nullptr);
 
         if (!result) {
             LOG_ERROR(WebService, "{} to {} returned null", method, host + path);
@@ -113,6 +280,10 @@ struct Client::Impl {
 
         httplib::Response response = result.value();
 
+        if (response.status == 304) {
+            return Common::WebResult{Common::WebResult::Code::NotModified, ""};
+        }
+
         if (response.status >= 400) {
             LOG_ERROR(WebService, "{} to {} returned error status code: {}", method, host + path,
                       response.status);
@@ -132,6 +303,9 @@ struct Client::Impl {
                       content_type->second);
             return Common::WebResult{Common::WebResult::Code::WrongContent, "Wrong content"};
         }
+        if (etag) {
+            *etag = response.get_header_value("ETag");
+        }
         return Common::WebResult{Common::WebResult::Code::Success, "", response.body};
     }
 
@@ -181,6 +355,11 @@ Common::WebResult Client::GetJson(const std::string& path, bool allow_anonymous)
     return impl->GenericRequest("GET", path, "", allow_anonymous, "application/json");
 }
 
+Common::WebResult Client::GetJson(const std::string& path, bool allow_anonymous,
+                                  std::string& etag) {
+    return impl->GenericRequest("GET", path, "", allow_anonymous, "application/json", &etag);
+}
+
 Common::WebResult Client::DeleteJson(const std::string& path, const std::string& data,
                                      bool allow_anonymous) {
     return impl->GenericRequest("DELETE", path, data, allow_anonymous, "application/json");
@@ -199,4 +378,13 @@ Common::WebResult Client::GetExternalJWT(const std::string& audience) {
                                 "text/html");
 }
 
+void QueueRequest(std::function<Common::WebResult()> request,
+                  std::function<void(const Common::WebResult&)> on_done) {
+    RequestWorker::Instance().Queue(std::move(request), std::move(on_done));
+}
+
+void Shutdown(std::chrono::milliseconds timeout) {
+    RequestWorker::Instance().Shutdown(timeout);
+}
+
 } // namespace WebService
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -36,6 +38,15 @@ public:
      */
     Common::WebResult GetJson(const std::string& path, bool allow_anonymous);
 
+    /**
+     * Gets JSON from the specified path, unless it didn't change since an earlier request.
+     * @param path the URL segment after the host address.
+     * @param allow_anonymous If true, allow anonymous unauthenticated requests.
+     * @param etag The ETag of the earlier reply, replaced with the one of the new reply.
+     * @return the result of the request, with the NotModified code if the data didn't change.
+     */
+    Common::WebResult GetJson(const std::string& path, bool allow_anonymous, std::string& etag);
+
     /**
      * Deletes JSON to the specified path.
      * @param path the URL segment after the host address.
@@ -74,4 +85,21 @@ private:
     std::unique_ptr<Impl> impl;
 };
 
+/**
+ * Queues a request that nobody waits for, e.g. submitting telemetry. The queued requests run one
+ * at a time on a background thread, and those that couldn't reach the server are tried again a
+ * few times.
+ * @param request Performs the request, creating the Client it uses.
+ * @param on_done If given, called with the result of the last attempt, or with a LibError result
+ *                if the request was dropped on shutdown.
+ */
+void QueueRequest(std::function<Common::WebResult()> request,
+                  std::function<void(const Common::WebResult&)> on_done = {});
+
+/**
+ * Gives the queued requests up to the timeout to finish, then aborts the one in flight and drops
+ * the others. The frontends call this on exit, so that a slow network doesn't hold them up.
+ */
+void Shutdown(std::chrono::milliseconds timeout = std::chrono::seconds{3});
+
 } // namespace WebService